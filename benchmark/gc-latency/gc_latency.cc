@@ -0,0 +1,49 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <sstream>
+
+#include "jni.h"
+
+#include "gc/heap.h"
+#include "runtime.h"
+
+namespace art {
+namespace {
+
+extern "C" JNIEXPORT jstring JNICALL Java_GcLatencyBenchmark_getCollectorType(
+    JNIEnv* env, jclass) {
+  std::ostringstream oss;
+  oss << Runtime::Current()->GetHeap()->CurrentCollectorType();
+  return env->NewStringUTF(oss.str().c_str());
+}
+
+extern "C" JNIEXPORT void JNICALL Java_GcLatencyBenchmark_resetGcPerformanceInfo(
+    JNIEnv*, jclass) {
+  Runtime::Current()->GetHeap()->ResetGcPerformanceInfo();
+}
+
+// Returns the per-collector timings and pause time confidence intervals, as
+// printed on SIGQUIT, which come from the GarbageCollector pause histograms.
+extern "C" JNIEXPORT jstring JNICALL Java_GcLatencyBenchmark_getGcPerformanceInfo(
+    JNIEnv* env, jclass) {
+  std::ostringstream oss;
+  Runtime::Current()->GetHeap()->DumpGcPerformanceInfo(oss);
+  return env->NewStringUTF(oss.str().c_str());
+}
+
+}  // namespace
+}  // namespace art
@@ -0,0 +1,271 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import java.lang.ref.WeakReference;
+import java.util.Arrays;
+
+/**
+ * GC latency harness. Keeps a live set of a given size and shape, replaces parts of it
+ * at a controlled allocation rate, and reports the pauses seen by the mutator together
+ * with the runtime's own GC pause histograms.
+ *
+ * Run under each collector with -Xgc:<type> (e.g. CC, CMS, SS, GSS, MS), for example
+ *   dalvikvm -Xgc:CMS -cp gc-latency.jar GcLatencyBenchmark --live-mb 64 --rate-mb 200
+ */
+public class GcLatencyBenchmark {
+  // Workload parameters, see parseArgs().
+  private int liveMb = 32;
+  private int rateMb = 100;       // Allocation rate in MB/s, 0 for as fast as possible.
+  private int durationS = 10;
+  private String shape = "tree";  // "array", "list" or "tree".
+  private int weakPercent = 0;    // Percentage of live nodes also held by a WeakReference.
+  private int finalizerPercent = 0;
+
+  // Size of each live node, including its payload.
+  private static final int NODE_BYTES = 64;
+  private static final int PAYLOAD_BYTES = NODE_BYTES - 32;
+  // Number of nodes replaced per step. A step is the unit of mutator progress.
+  private static final int NODES_PER_STEP = 256;
+  // Gaps longer than this are counted as pauses.
+  private static final long PAUSE_THRESHOLD_NS = 500_000;
+  private static final long[] MMU_WINDOWS_MS = { 1, 2, 5, 10, 20, 50, 100, 200, 500, 1000 };
+
+  private static class Node {
+    Node left;
+    Node right;
+    byte[] payload = new byte[PAYLOAD_BYTES];
+  }
+
+  private static class FinalizableNode extends Node {
+    static volatile int finalized;
+
+    @Override
+    protected void finalize() {
+      finalized++;
+    }
+  }
+
+  private Node[] live;
+  private WeakReference<?>[] weakRefs;
+  private long allocated;
+
+  // Start and end times of the observed pauses.
+  private long[] pauseStarts = new long[1024];
+  private long[] pauseEnds = new long[1024];
+  private int numPauses;
+
+  public static void main(String[] args) {
+    System.loadLibrary("artbenchmark");
+    GcLatencyBenchmark benchmark = new GcLatencyBenchmark();
+    benchmark.parseArgs(args);
+    benchmark.run();
+  }
+
+  // Caliper entry point, measuring steady state allocation with the default parameters.
+  public void timeReplaceLiveSet(int reps) {
+    if (live == null) {
+      setUp();
+    }
+    for (int i = 0; i < reps; ++i) {
+      step(i);
+    }
+  }
+
+  private void parseArgs(String[] args) {
+    for (int i = 0; i < args.length; i += 2) {
+      String value = args[i + 1];
+      switch (args[i]) {
+        case "--live-mb": liveMb = Integer.parseInt(value); break;
+        case "--rate-mb": rateMb = Integer.parseInt(value); break;
+        case "--duration-s": durationS = Integer.parseInt(value); break;
+        case "--shape": shape = value; break;
+        case "--weak-percent": weakPercent = Integer.parseInt(value); break;
+        case "--finalizer-percent": finalizerPercent = Integer.parseInt(value); break;
+        default: throw new IllegalArgumentException("Unknown option " + args[i]);
+      }
+    }
+  }
+
+  private void setUp() {
+    int numNodes = (int) ((long) liveMb * 1024 * 1024 / NODE_BYTES);
+    live = new Node[Math.max(numNodes, NODES_PER_STEP)];
+    weakRefs = new WeakReference<?>[live.length];
+    for (int i = 0; i < live.length; ++i) {
+      replace(i);
+    }
+  }
+
+  private Node newNode(int index) {
+    Node node = (finalizerPercent != 0 && index % 100 < finalizerPercent)
+        ? new FinalizableNode()
+        : new Node();
+    if (weakPercent != 0 && index % 100 < weakPercent) {
+      weakRefs[index] = new WeakReference<>(node);
+    }
+    allocated += NODE_BYTES;
+    return node;
+  }
+
+  // Replaces the node at the given index, keeping the shape of the live set.
+  private void replace(int index) {
+    Node node = newNode(index);
+    switch (shape) {
+      case "array":
+        break;
+      case "list":
+        // Each node points to its neighbor, forming long chains for the marker.
+        node.left = live[(index + 1) % live.length];
+        break;
+      case "tree":
+        // Implicit binary tree, as in a heap: children of i are 2i+1 and 2i+2.
+        node.left = (2 * index + 1 < live.length) ? live[2 * index + 1] : null;
+        node.right = (2 * index + 2 < live.length) ? live[2 * index + 2] : null;
+        if (index != 0) {
+          Node parent = live[(index - 1) / 2];
+          if (parent != null) {
+            if ((index & 1) != 0) {
+              parent.left = node;
+            } else {
+              parent.right = node;
+            }
+          }
+        }
+        break;
+      default:
+        throw new IllegalArgumentException("Unknown shape " + shape);
+    }
+    live[index] = node;
+  }
+
+  private void step(int step) {
+    int start = (int) (((long) step * NODES_PER_STEP) % live.length);
+    for (int i = 0; i < NODES_PER_STEP; ++i) {
+      replace((start + i) % live.length);
+    }
+  }
+
+  private void recordPause(long start, long end) {
+    if (numPauses == pauseStarts.length) {
+      pauseStarts = Arrays.copyOf(pauseStarts, numPauses * 2);
+      pauseEnds = Arrays.copyOf(pauseEnds, numPauses * 2);
+    }
+    pauseStarts[numPauses] = start;
+    pauseEnds[numPauses] = end;
+    ++numPauses;
+  }
+
+  private void run() {
+    setUp();
+    Runtime.getRuntime().gc();
+    resetGcPerformanceInfo();
+    allocated = 0;
+
+    long bytesPerStep = (long) NODES_PER_STEP * NODE_BYTES;
+    long nsPerStep = (rateMb == 0) ? 0 : bytesPerStep * 1_000_000_000L / (rateMb * 1024L * 1024L);
+    long begin = System.nanoTime();
+    long end = begin + durationS * 1_000_000_000L;
+    long last = begin;
+    long nextStep = begin;
+    for (int step = 0; last < end; ++step) {
+      step(step);
+      long now = System.nanoTime();
+      // Pacing keeps the allocation rate, and the busy wait keeps the mutator observing.
+      nextStep += nsPerStep;
+      while (now < nextStep) {
+        if (now - last > PAUSE_THRESHOLD_NS) {
+          recordPause(last, now);
+        }
+        last = now;
+        now = System.nanoTime();
+      }
+      if (now - last > PAUSE_THRESHOLD_NS) {
+        recordPause(last, now);
+      }
+      last = now;
+    }
+    report(last - begin);
+  }
+
+  private void report(long totalNs) {
+    System.out.println("Collector: " + getCollectorType());
+    System.out.println("Live set: " + liveMb + " MB, shape " + shape
+        + ", weak " + weakPercent + "%, finalizable " + finalizerPercent + "%");
+    System.out.println("Allocated: " + (allocated / (1024 * 1024)) + " MB in "
+        + (totalNs / 1_000_000) + " ms (target " + rateMb + " MB/s)");
+
+    long[] durations = new long[numPauses];
+    long pausedNs = 0;
+    for (int i = 0; i < numPauses; ++i) {
+      durations[i] = pauseEnds[i] - pauseStarts[i];
+      pausedNs += durations[i];
+    }
+    Arrays.sort(durations);
+    System.out.println("Mutator pauses > " + (PAUSE_THRESHOLD_NS / 1000) + " us: " + numPauses
+        + ", total " + (pausedNs / 1000) + " us"
+        + ", p50 " + percentileUs(durations, 50)
+        + " us, p90 " + percentileUs(durations, 90)
+        + " us, p99 " + percentileUs(durations, 99)
+        + " us, p99.9 " + percentileUs(durations, 99.9)
+        + " us, max " + percentileUs(durations, 100) + " us");
+
+    StringBuilder mmu = new StringBuilder("MMU:");
+    for (long windowMs : MMU_WINDOWS_MS) {
+      long windowNs = windowMs * 1_000_000;
+      if (windowNs <= totalNs) {
+        mmu.append(' ').append(windowMs).append("ms=")
+            .append(String.format("%.3f", minimumMutatorUtilization(windowNs)));
+      }
+    }
+    System.out.println(mmu);
+    System.out.println(getGcPerformanceInfo());
+  }
+
+  private static long percentileUs(long[] sorted, double percentile) {
+    if (sorted.length == 0) {
+      return 0;
+    }
+    int index = (int) Math.ceil(percentile / 100.0 * sorted.length) - 1;
+    return sorted[Math.max(0, Math.min(index, sorted.length - 1))] / 1000;
+  }
+
+  // Paused time within [start, start + window).
+  private long pausedInWindow(long start, long window) {
+    long end = start + window;
+    long paused = 0;
+    for (int i = 0; i < numPauses; ++i) {
+      long s = Math.max(pauseStarts[i], start);
+      long e = Math.min(pauseEnds[i], end);
+      if (s < e) {
+        paused += e - s;
+      }
+    }
+    return paused;
+  }
+
+  // The worst window either starts at a pause start or ends at a pause end.
+  private double minimumMutatorUtilization(long window) {
+    long maxPaused = 0;
+    for (int i = 0; i < numPauses; ++i) {
+      maxPaused = Math.max(maxPaused, pausedInWindow(pauseStarts[i], window));
+      maxPaused = Math.max(maxPaused, pausedInWindow(pauseEnds[i] - window, window));
+    }
+    return 1.0 - Math.min(1.0, (double) maxPaused / window);
+  }
+
+  private static native String getCollectorType();
+  private static native void resetGcPerformanceInfo();
+  private static native String getGcPerformanceInfo();
+}
@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdint.h>
+
+#include <array>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "base/arena_allocator.h"
+#include "base/bit_memory_region.h"
+#include "base/bit_table.h"
+#include "base/malloc_arena_pool.h"
+#include "base/scoped_arena_allocator.h"
+
+namespace art {
+
+// These cover the primitives that CodeInfo decoding is built from: the interleaved
+// varint header and the bit-packed tables (stack maps, register masks, etc).
+
+static constexpr uint32_t kNumColumns = 4;
+
+static void BM_ReadInterleavedVarints(benchmark::State& state) {
+  // Mix of small values, stored inline, and large values, stored in extra bytes.
+  static constexpr std::array<uint32_t, 8> kValues = {1, 3, 7, 12, 100, 1000, 70000, 0};
+  std::vector<uint8_t> buffer;
+  BitMemoryWriter<std::vector<uint8_t>> writer(&buffer);
+  writer.WriteInterleavedVarints(kValues);
+  for (auto _ : state) {
+    BitMemoryReader reader(buffer.data());
+    benchmark::DoNotOptimize(reader.ReadInterleavedVarints<kValues.size()>());
+  }
+  state.SetItemsProcessed(state.iterations() * kValues.size());
+}
+BENCHMARK(BM_ReadInterleavedVarints);
+
+static void EncodeTable(size_t num_rows, std::vector<uint8_t>* buffer) {
+  MallocArenaPool pool;
+  ArenaStack arena_stack(&pool);
+  ScopedArenaAllocator allocator(&arena_stack);
+  BitMemoryWriter<std::vector<uint8_t>> writer(buffer);
+  BitTableBuilderBase<kNumColumns> builder(&allocator);
+  for (uint32_t row = 0; row != num_rows; ++row) {
+    // Resembles a stack map: native pc, dex pc, register mask index, no inline info.
+    builder.Add({row * 4u, row * 3u, row % 16u, BitTableBase<kNumColumns>::kNoValue});
+  }
+  builder.Encode(writer);
+}
+
+static void BM_BitTableDecodeHeader(benchmark::State& state) {
+  std::vector<uint8_t> buffer;
+  EncodeTable(static_cast<size_t>(state.range(0)), &buffer);
+  for (auto _ : state) {
+    BitMemoryReader reader(buffer.data());
+    BitTableBase<kNumColumns> table(reader);
+    benchmark::DoNotOptimize(table.NumRows());
+  }
+}
+BENCHMARK(BM_BitTableDecodeHeader)->Range(8, 8 << 10);
+
+static void BM_BitTableGet(benchmark::State& state) {
+  std::vector<uint8_t> buffer;
+  EncodeTable(static_cast<size_t>(state.range(0)), &buffer);
+  BitMemoryReader reader(buffer.data());
+  BitTableBase<kNumColumns> table(reader);
+  for (auto _ : state) {
+    for (uint32_t row = 0; row != table.NumRows(); ++row) {
+      benchmark::DoNotOptimize(table.Get(row, 0));
+      benchmark::DoNotOptimize(table.Get(row, 1));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * table.NumRows());
+}
+BENCHMARK(BM_BitTableGet)->Range(8, 8 << 10);
+
+// Linear search by the first column, as done for lookups by native pc.
+static void BM_BitTableLinearSearch(benchmark::State& state) {
+  std::vector<uint8_t> buffer;
+  EncodeTable(static_cast<size_t>(state.range(0)), &buffer);
+  BitMemoryReader reader(buffer.data());
+  BitTableBase<kNumColumns> table(reader);
+  const uint32_t target = (table.NumRows() - 1u) * 4u;
+  for (auto _ : state) {
+    uint32_t row = 0;
+    while (row != table.NumRows() && table.Get(row, 0) != target) {
+      ++row;
+    }
+    benchmark::DoNotOptimize(row);
+  }
+}
+BENCHMARK(BM_BitTableLinearSearch)->Range(8, 8 << 10);
+
+}  // namespace art
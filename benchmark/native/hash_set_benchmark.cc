@@ -0,0 +1,121 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "base/hash_set.h"
+#include "base/swiss_hash_set.h"
+
+namespace art {
+
+// Deterministic keys, so that runs are comparable across builds.
+static std::vector<std::string> MakeStringKeys(size_t count) {
+  std::vector<std::string> keys;
+  keys.reserve(count);
+  uint32_t seed = 97421u;
+  for (size_t i = 0; i != count; ++i) {
+    seed = seed * 1103515245u + 12345u;
+    keys.push_back("Ljava/lang/Class" + std::to_string(seed) + ";");
+  }
+  return keys;
+}
+
+template <typename Set>
+static void BM_StringSetInsert(benchmark::State& state) {
+  std::vector<std::string> keys = MakeStringKeys(static_cast<size_t>(state.range(0)));
+  for (auto _ : state) {
+    Set set;
+    for (const std::string& key : keys) {
+      set.insert(key);
+    }
+    benchmark::DoNotOptimize(set.size());
+  }
+  state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+template <typename Set>
+static void BM_StringSetFindHit(benchmark::State& state) {
+  std::vector<std::string> keys = MakeStringKeys(static_cast<size_t>(state.range(0)));
+  Set set;
+  for (const std::string& key : keys) {
+    set.insert(key);
+  }
+  for (auto _ : state) {
+    for (const std::string& key : keys) {
+      benchmark::DoNotOptimize(set.find(key));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+template <typename Set>
+static void BM_StringSetFindMiss(benchmark::State& state) {
+  std::vector<std::string> keys = MakeStringKeys(static_cast<size_t>(state.range(0)));
+  Set set;
+  for (const std::string& key : keys) {
+    set.insert(key + "x");
+  }
+  for (auto _ : state) {
+    for (const std::string& key : keys) {
+      benchmark::DoNotOptimize(set.find(key));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+template <typename Set>
+static void BM_IntSetInsertErase(benchmark::State& state) {
+  const size_t count = static_cast<size_t>(state.range(0));
+  Set set;
+  for (size_t i = 0; i != count; ++i) {
+    set.insert(static_cast<int64_t>(i));
+  }
+  int64_t next = static_cast<int64_t>(count);
+  for (auto _ : state) {
+    // Keep the size stable, so that the set never needs to grow or shrink.
+    set.insert(next);
+    set.erase(set.find(next - static_cast<int64_t>(count)));
+    ++next;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+// HashSet<int64_t> needs an empty value which keys never take.
+struct EmptyFnInt64 {
+  void MakeEmpty(int64_t& item) const { item = -1; }
+  bool IsEmpty(const int64_t& item) const { return item == -1; }
+};
+
+using StringHashSet = HashSet<std::string>;
+using StringSwissHashSet = SwissHashSet<std::string>;
+using IntHashSet = HashSet<int64_t, EmptyFnInt64>;
+using IntSwissHashSet = SwissHashSet<int64_t>;
+
+BENCHMARK_TEMPLATE(BM_StringSetInsert, StringHashSet)->Range(64, 64 << 10);
+BENCHMARK_TEMPLATE(BM_StringSetInsert, StringSwissHashSet)->Range(64, 64 << 10);
+BENCHMARK_TEMPLATE(BM_StringSetFindHit, StringHashSet)->Range(64, 64 << 10);
+BENCHMARK_TEMPLATE(BM_StringSetFindHit, StringSwissHashSet)->Range(64, 64 << 10);
+BENCHMARK_TEMPLATE(BM_StringSetFindMiss, StringHashSet)->Range(64, 64 << 10);
+BENCHMARK_TEMPLATE(BM_StringSetFindMiss, StringSwissHashSet)->Range(64, 64 << 10);
+BENCHMARK_TEMPLATE(BM_IntSetInsertErase, IntHashSet)->Range(64, 64 << 10);
+BENCHMARK_TEMPLATE(BM_IntSetInsertErase, IntSwissHashSet)->Range(64, 64 << 10);
+
+}  // namespace art
@@ -746,6 +746,12 @@ struct CmdlineType<ProfileSaverOptions> : CmdlineTypeParser<ProfileSaverOptions>
              &ProfileSaverOptions::max_notification_before_wake_,
              type_parser.Parse(suffix));
     }
+    if (android::base::StartsWith(option, "max-delta-log-bytes:")) {
+      CmdlineType<unsigned int> type_parser;
+      return ParseInto(existing,
+             &ProfileSaverOptions::max_delta_log_bytes_,
+             type_parser.Parse(suffix));
+    }
     if (android::base::StartsWith(option, "profile-path:")) {
       existing.profile_path_ = suffix;
       return Result::SuccessNoValue();
@@ -161,6 +161,12 @@ CompiledMethodStorage::~CompiledMethodStorage() {
   // All done by member destructors.
 }
 
+void CompiledMethodStorage::SetSwapMemoryBudget(size_t memory_budget) {
+  if (swap_space_ != nullptr) {
+    swap_space_->SetMemoryBudget(memory_budget);
+  }
+}
+
 void CompiledMethodStorage::DumpMemoryUsage(std::ostream& os, bool extended) const {
   if (swap_space_.get() != nullptr) {
     const size_t swap_size = swap_space_->GetSize();
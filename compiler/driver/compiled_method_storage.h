@@ -47,6 +47,10 @@ class CompiledMethodStorage {
     return dedupe_enabled_;
   }
 
+  // Keep the compiled output in the heap until the process reaches `memory_budget` bytes of
+  // resident memory, and only spill it to the swap file past that. No effect without swap.
+  void SetSwapMemoryBudget(size_t memory_budget);
+
   SwapAllocator<void> GetSwapSpaceAllocator() {
     return SwapAllocator<void>(swap_space_.get());
   }
@@ -66,6 +66,7 @@ CompilerOptions::CompilerOptions()
       dump_timings_(false),
       dump_pass_timings_(false),
       dump_stats_(false),
+      compile_time_budget_ms_(0u),
       top_k_profile_threshold_(kDefaultTopKProfileThreshold),
       profile_compilation_info_(nullptr),
       verbose_methods_(),
@@ -78,6 +79,7 @@ CompilerOptions::CompilerOptions()
       deduplicate_code_(true),
       count_hotness_in_compiled_code_(false),
       resolve_startup_const_strings_(false),
+      initialize_startup_classes_(false),
       check_profiled_methods_(ProfileMethodsCheck::kNone),
       max_image_block_size_(std::numeric_limits<uint32_t>::max()),
       register_allocation_strategy_(RegisterAllocator::kRegisterAllocatorDefault),
@@ -340,6 +340,11 @@ class CompilerOptions final {
     return dump_pass_timings_;
   }
 
+  // Time after which the optimizing compiler skips optional passes for a method, 0 for no budget.
+  uint32_t GetCompileTimeBudgetMs() const {
+    return compile_time_budget_ms_;
+  }
+
   bool GetDumpStats() const {
     return dump_stats_;
   }
@@ -352,6 +357,10 @@ class CompilerOptions final {
     return resolve_startup_const_strings_;
   }
 
+  bool InitializeStartupClasses() const {
+    return initialize_startup_classes_;
+  }
+
   ProfileMethodsCheck CheckProfiledMethodsCompiled() const {
     return check_profiled_methods_;
   }
@@ -412,6 +421,7 @@ class CompilerOptions final {
   bool dump_timings_;
   bool dump_pass_timings_;
   bool dump_stats_;
+  uint32_t compile_time_budget_ms_;
 
   // When using a profile file only the top K% of the profiled samples will be compiled.
   double top_k_profile_threshold_;
@@ -449,6 +459,10 @@ class CompilerOptions final {
   // profile.
   bool resolve_startup_const_strings_;
 
+  // Whether we run the class initializers of profile classes when compiling an app image, so that
+  // they are stored initialized in the image.
+  bool initialize_startup_classes_;
+
   // When running profile-guided compilation, check that methods intended to be compiled end
   // up compiled and are not punted.
   ProfileMethodsCheck check_profiled_methods_;
@@ -81,6 +81,7 @@ inline bool ReadCompilerOptions(Base& map, CompilerOptions* options, std::string
     options->count_hotness_in_compiled_code_ = true;
   }
   map.AssignIfExists(Base::ResolveStartupConstStrings, &options->resolve_startup_const_strings_);
+  map.AssignIfExists(Base::InitializeStartupClasses, &options->initialize_startup_classes_);
   if (map.Exists(Base::CheckProfiledMethods)) {
     options->check_profiled_methods_ = *map.Get(Base::CheckProfiledMethods);
   }
@@ -94,6 +95,8 @@ inline bool ReadCompilerOptions(Base& map, CompilerOptions* options, std::string
     options->dump_pass_timings_ = true;
   }
 
+  map.AssignIfExists(Base::CompileTimeBudgetMs, &options->compile_time_budget_ms_);
+
   if (map.Exists(Base::DumpStats)) {
     options->dump_stats_ = true;
   }
@@ -161,6 +164,10 @@ inline void AddCompilerOptionsArgumentParserOptions(Builder& b) {
       .Define({"--dump-pass-timings"})
           .IntoKey(Map::DumpPassTimings)
 
+      .Define("--compile-time-budget-ms=_")
+          .template WithType<unsigned int>()
+          .IntoKey(Map::CompileTimeBudgetMs)
+
       .Define({"--dump-stats"})
           .IntoKey(Map::DumpStats)
 
@@ -200,6 +207,11 @@ inline void AddCompilerOptionsArgumentParserOptions(Builder& b) {
           .WithValueMap({{"false", false}, {"true", true}})
           .IntoKey(Map::ResolveStartupConstStrings)
 
+      .Define("--initialize-startup-classes=_")
+          .template WithType<bool>()
+          .WithValueMap({{"false", false}, {"true", true}})
+          .IntoKey(Map::InitializeStartupClasses)
+
       .Define("--verbose-methods=_")
           .template WithType<ParseStringList<','>>()
           .IntoKey(Map::VerboseMethods)
@@ -109,7 +109,7 @@ void JitCompiler::ParseCompilerOptions() {
   compiler_options_->compiling_with_core_image_ =
       CompilerOptions::IsCoreImageFilename(runtime->GetImageLocation());
 
-  if (compiler_options_->GetGenerateDebugInfo()) {
+  if (compiler_options_->GetGenerateDebugInfo() || runtime->GetJITOptions()->GetPerfProfiling()) {
     jit_logger_.reset(new JitLogger());
     jit_logger_->OpenLog();
   }
@@ -156,6 +156,22 @@ extern "C" void jit_types_loaded(void* handle, mirror::Class** types, size_t cou
   }
 }
 
+extern "C" void jit_code_deoptimized(void* handle, const void* code_ptr, uint32_t kind) {
+  JitCompiler* jit_compiler = reinterpret_cast<JitCompiler*>(handle);
+  DCHECK(jit_compiler != nullptr);
+  if (jit_compiler->GetJitLogger() != nullptr) {
+    jit_compiler->GetJitLogger()->WriteDeoptimizationLog(code_ptr, kind);
+  }
+}
+
+extern "C" void jit_code_unloaded(void* handle, const void* code_ptr) {
+  JitCompiler* jit_compiler = reinterpret_cast<JitCompiler*>(handle);
+  DCHECK(jit_compiler != nullptr);
+  if (jit_compiler->GetJitLogger() != nullptr) {
+    jit_compiler->GetJitLogger()->WriteUnloadLog(code_ptr);
+  }
+}
+
 extern "C" void jit_update_options(void* handle) {
   JitCompiler* jit_compiler = reinterpret_cast<JitCompiler*>(handle);
   DCHECK(jit_compiler != nullptr);
@@ -176,7 +192,7 @@ JitCompiler::JitCompiler() {
 }
 
 JitCompiler::~JitCompiler() {
-  if (compiler_options_->GetGenerateDebugInfo()) {
+  if (jit_logger_ != nullptr) {
     jit_logger_->CloseLog();
   }
 }
@@ -46,6 +46,11 @@ class JitCompiler {
 
   void ParseCompilerOptions();
 
+  // Null unless perf profiling of the jitted code is enabled.
+  JitLogger* GetJitLogger() const {
+    return jit_logger_.get();
+  }
+
  private:
   std::unique_ptr<CompilerOptions> compiler_options_;
   std::unique_ptr<Compiler> compiler_;
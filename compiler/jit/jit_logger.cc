@@ -16,6 +16,8 @@
 
 #include "jit_logger.h"
 
+#include <chrono>
+
 #include "arch/instruction_set.h"
 #include "art_method-inl.h"
 #include "base/time_utils.h"
@@ -49,32 +51,11 @@ void JitLogger::OpenPerfMapLog() {
   }
 }
 
-void JitLogger::WritePerfMapLog(const void* ptr, size_t code_size, ArtMethod* method) {
-  if (perf_file_ != nullptr) {
-    std::string method_name = method->PrettyMethod();
-
-    std::ostringstream stream;
-    stream << std::hex
-           << reinterpret_cast<uintptr_t>(ptr)
-           << " "
-           << code_size
-           << " "
-           << method_name
-           << std::endl;
-    std::string str = stream.str();
-    bool res = perf_file_->WriteFully(str.c_str(), str.size());
-    if (!res) {
-      LOG(WARNING) << "Failed to write jitted method info in log: write failure.";
-    }
-  } else {
-    LOG(WARNING) << "Failed to write jitted method info in log: log file doesn't exist.";
-  }
-}
-
 void JitLogger::ClosePerfMapLog() {
   if (perf_file_ != nullptr) {
     UNUSED(perf_file_->Flush());
     UNUSED(perf_file_->Close());
+    perf_file_.reset();
   }
 }
 
@@ -147,7 +128,17 @@ struct PerfJitBase {
     kDebugInfo = 2,
 
     // Logs JIT VM end of life event.
-    kClose = 3
+    kClose = 3,
+
+    // ART specific events, in a range perf does not use. 'perf inject' skips the records it
+    // does not know, other tools can use them to tell which code was live at a given time.
+
+    // The jitted code at an address was deoptimized. Logged with PerfJitCodeEvent.
+    kArtDeoptimization = 0x10000,
+
+    // The jitted code at an address was freed by the code cache collection. Its address may be
+    // reused by a later kLoad event. Logged with PerfJitCodeEvent.
+    kArtUnload = 0x10001,
   };
   uint32_t event_;       // Must be one of the events defined in PerfJitEvent.
   uint32_t size_;        // Total size of this event record.
@@ -170,6 +161,14 @@ struct PerfJitCodeLoad : PerfJitBase {
   uint64_t code_id_;       // Unique ID for each jitted code.
 };
 
+// Logs an ART specific event about previously loaded code (kArtDeoptimization, kArtUnload).
+struct PerfJitCodeEvent : PerfJitBase {
+  uint32_t process_id_;    // Process ID of the runtime.
+  uint32_t thread_id_;     // Thread ID which triggered the event.
+  uint64_t code_address_;  // Address of the jitted code, as logged in its kLoad event.
+  uint64_t arg_;           // For kArtDeoptimization, the DeoptimizationKind. Otherwise 0.
+};
+
 // This structure is for source line/column mapping.
 // Currently this feature is not implemented in ART JIT yet.
 struct PerfJitDebugEntry {
@@ -219,9 +218,10 @@ void JitLogger::OpenMarkerFile() {
 }
 
 void JitLogger::CloseMarkerFile() {
-  if (marker_address_ != nullptr) {
+  if (marker_address_ != nullptr && marker_address_ != MAP_FAILED) {
     munmap(marker_address_, kPageSize);
   }
+  marker_address_ = nullptr;
 }
 
 void JitLogger::WriteJitDumpDebugInfo() {
@@ -266,42 +266,160 @@ void JitLogger::OpenJitDumpLog() {
   WriteJitDumpHeader();
 }
 
-void JitLogger::WriteJitDumpLog(const void* ptr, size_t code_size, ArtMethod* method) {
-  if (jit_dump_file_ != nullptr) {
-    std::string method_name = method->PrettyMethod();
-
-    PerfJitCodeLoad jit_code;
-    std::memset(&jit_code, 0, sizeof(jit_code));
-    jit_code.event_ = PerfJitCodeLoad::kLoad;
-    jit_code.size_ = sizeof(jit_code) + method_name.size() + 1 + code_size;
-    jit_code.time_stamp_ = art::NanoTime();    // CLOCK_MONOTONIC clock is required.
-    jit_code.process_id_ = static_cast<uint32_t>(getpid());
-    jit_code.thread_id_ = static_cast<uint32_t>(art::GetTid());
-    jit_code.vma_ = 0x0;
-    jit_code.code_address_ = reinterpret_cast<uint64_t>(ptr);
-    jit_code.code_size_ = code_size;
-    jit_code.code_id_ = code_index_++;
-
-    // Write one complete jitted method info, including:
-    // - PerfJitCodeLoad structure
-    // - Method name
-    // - Complete generated code of this method
-    //
-    // Use UNUSED() here to avoid compiler warnings.
-    UNUSED(jit_dump_file_->WriteFully(reinterpret_cast<const char*>(&jit_code), sizeof(jit_code)));
-    UNUSED(jit_dump_file_->WriteFully(method_name.c_str(), method_name.size() + 1));
-    UNUSED(jit_dump_file_->WriteFully(ptr, code_size));
-
-    WriteJitDumpDebugInfo();
+static void AppendBytes(std::vector<uint8_t>* buffer, const void* data, size_t size) {
+  const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data);
+  buffer->insert(buffer->end(), bytes, bytes + size);
+}
+
+void JitLogger::WriteLog(const void* ptr, size_t code_size, ArtMethod* method) {
+  if (perf_file_ == nullptr && jit_dump_file_ == nullptr) {
+    return;
+  }
+  std::string method_name = method->PrettyMethod();
+  // Taken here rather than by the writer, the timestamp must precede the samples in the new code.
+  uint64_t time_stamp = art::NanoTime();  // CLOCK_MONOTONIC clock is required.
+
+  std::ostringstream stream;
+  stream << std::hex
+         << reinterpret_cast<uintptr_t>(ptr)
+         << " "
+         << code_size
+         << " "
+         << method_name
+         << "\n";
+  std::string perf_map_line = stream.str();
+
+  bool wake_writer;
+  {
+    std::lock_guard<std::mutex> lock(buffer_lock_);
+    if (perf_file_ != nullptr) {
+      perf_map_buffer_ += perf_map_line;
+    }
+    if (jit_dump_file_ != nullptr) {
+      PerfJitCodeLoad jit_code;
+      std::memset(&jit_code, 0, sizeof(jit_code));
+      jit_code.event_ = PerfJitCodeLoad::kLoad;
+      jit_code.size_ = sizeof(jit_code) + method_name.size() + 1 + code_size;
+      jit_code.time_stamp_ = time_stamp;
+      jit_code.process_id_ = static_cast<uint32_t>(getpid());
+      jit_code.thread_id_ = static_cast<uint32_t>(art::GetTid());
+      jit_code.vma_ = 0x0;
+      jit_code.code_address_ = reinterpret_cast<uint64_t>(ptr);
+      jit_code.code_size_ = code_size;
+      jit_code.code_id_ = code_index_++;
+
+      // One complete jitted method info, including:
+      // - PerfJitCodeLoad structure
+      // - Method name
+      // - Complete generated code of this method, copied now as it may be freed before the
+      //   writer gets to it.
+      AppendBytes(&jit_dump_buffer_, &jit_code, sizeof(jit_code));
+      AppendBytes(&jit_dump_buffer_, method_name.c_str(), method_name.size() + 1);
+      AppendBytes(&jit_dump_buffer_, ptr, code_size);
+
+      WriteJitDumpDebugInfo();
+    }
+    wake_writer = perf_map_buffer_.size() + jit_dump_buffer_.size() >= kWriteThreshold;
+  }
+  if (wake_writer) {
+    buffer_cond_.notify_one();
   }
 }
 
+void JitLogger::AppendJitDumpRecord(uint32_t event, const void* ptr, uint64_t arg) {
+  if (jit_dump_file_ == nullptr) {
+    return;
+  }
+  PerfJitCodeEvent record;
+  std::memset(&record, 0, sizeof(record));
+  record.event_ = event;
+  record.size_ = sizeof(record);
+  record.time_stamp_ = art::NanoTime();  // CLOCK_MONOTONIC clock is required.
+  record.process_id_ = static_cast<uint32_t>(getpid());
+  record.thread_id_ = static_cast<uint32_t>(art::GetTid());
+  record.code_address_ = reinterpret_cast<uint64_t>(ptr);
+  record.arg_ = arg;
+  std::lock_guard<std::mutex> lock(buffer_lock_);
+  AppendBytes(&jit_dump_buffer_, &record, sizeof(record));
+}
+
+void JitLogger::WriteDeoptimizationLog(const void* ptr, uint32_t kind) {
+  AppendJitDumpRecord(PerfJitBase::kArtDeoptimization, ptr, kind);
+}
+
+void JitLogger::WriteUnloadLog(const void* ptr) {
+  AppendJitDumpRecord(PerfJitBase::kArtUnload, ptr, /* arg= */ 0u);
+}
+
 void JitLogger::CloseJitDumpLog() {
   if (jit_dump_file_ != nullptr) {
     CloseMarkerFile();
     UNUSED(jit_dump_file_->Flush());
     UNUSED(jit_dump_file_->Close());
+    jit_dump_file_.reset();
+  }
+}
+
+void JitLogger::StartWriter() {
+  if (perf_file_ == nullptr && jit_dump_file_ == nullptr) {
+    return;
   }
+  writer_ = std::thread([this]() { WriterLoop(); });
+}
+
+void JitLogger::StopWriter() {
+  if (writer_.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(buffer_lock_);
+      stop_writer_ = true;
+    }
+    buffer_cond_.notify_one();
+    writer_.join();
+  }
+  // Anything logged after the writer stopped.
+  WritePending();
+}
+
+void JitLogger::WriterLoop() {
+  // Records are written at least this often, so that a profile taken while the process is still
+  // running sees the recently compiled code.
+  static constexpr std::chrono::milliseconds kWriteInterval(500);
+  bool stop = false;
+  while (!stop) {
+    {
+      std::unique_lock<std::mutex> lock(buffer_lock_);
+      buffer_cond_.wait_for(lock, kWriteInterval, [this]() {
+        return stop_writer_ || perf_map_buffer_.size() + jit_dump_buffer_.size() >= kWriteThreshold;
+      });
+      stop = stop_writer_;
+    }
+    WritePending();
+  }
+}
+
+void JitLogger::WritePending() {
+  std::lock_guard<std::mutex> write_lock(write_lock_);
+  std::string perf_map_batch;
+  std::vector<uint8_t> jit_dump_batch;
+  {
+    std::lock_guard<std::mutex> lock(buffer_lock_);
+    perf_map_batch.swap(perf_map_buffer_);
+    jit_dump_batch.swap(jit_dump_buffer_);
+  }
+  if (perf_file_ != nullptr && !perf_map_batch.empty()) {
+    if (!perf_file_->WriteFully(perf_map_batch.data(), perf_map_batch.size())) {
+      LOG(WARNING) << "Failed to write jitted method info in log: write failure.";
+    }
+  }
+  if (jit_dump_file_ != nullptr && !jit_dump_batch.empty()) {
+    if (!jit_dump_file_->WriteFully(jit_dump_batch.data(), jit_dump_batch.size())) {
+      LOG(WARNING) << "Failed to write jitted method info in jit dump: write failure.";
+    }
+  }
+}
+
+JitLogger::~JitLogger() {
+  CloseLog();
 }
 
 }  // namespace jit
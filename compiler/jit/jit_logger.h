@@ -17,7 +17,12 @@
 #ifndef ART_COMPILER_JIT_JIT_LOGGER_H_
 #define ART_COMPILER_JIT_JIT_LOGGER_H_
 
+#include <condition_variable>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
 
 #include "base/mutex.h"
 #include "base/os.h"
@@ -86,49 +91,77 @@ namespace jit {
 //       - Make sure above small ELF files are available for 'perf annotate' tool to access,
 //         so that jitted code can be displayed in assembly view.
 //
+// Both logs are written with -Xcompiler-option --generate-debug-info, or with -Xjitperfprofiling
+// which does not need a debuggable runtime and keeps the code cache collection enabled. The
+// compiling threads only append the records to an in-memory buffer, a background thread writes
+// them out in batches.
+//
 class JitLogger {
  public:
-    JitLogger() : code_index_(0), marker_address_(nullptr) {}
+    JitLogger() : code_index_(0), marker_address_(nullptr), stop_writer_(false) {}
+    ~JitLogger();
 
     void OpenLog() {
       OpenPerfMapLog();
       OpenJitDumpLog();
+      StartWriter();
     }
 
     void WriteLog(const void* ptr, size_t code_size, ArtMethod* method)
-        REQUIRES_SHARED(Locks::mutator_lock_) {
-      WritePerfMapLog(ptr, code_size, method);
-      WriteJitDumpLog(ptr, code_size, method);
-    }
+        REQUIRES_SHARED(Locks::mutator_lock_);
+
+    // Records that the code at `ptr` was deoptimized, with the DeoptimizationKind `kind`.
+    void WriteDeoptimizationLog(const void* ptr, uint32_t kind);
+
+    // Records that the code at `ptr` was freed from the code cache.
+    void WriteUnloadLog(const void* ptr);
 
+    // Writes the buffered records and closes the logs. Does nothing if already closed.
     void CloseLog() {
+      StopWriter();
       ClosePerfMapLog();
       CloseJitDumpLog();
     }
 
  private:
+    // The writer wakes up early once this much is buffered.
+    static constexpr size_t kWriteThreshold = 64 * KB;
+
     // For perf-map profiling
     void OpenPerfMapLog();
-    void WritePerfMapLog(const void* ptr, size_t code_size, ArtMethod* method)
-        REQUIRES_SHARED(Locks::mutator_lock_);
     void ClosePerfMapLog();
 
     // For perf-inject profiling
     void OpenJitDumpLog();
-    void WriteJitDumpLog(const void* ptr, size_t code_size, ArtMethod* method)
-        REQUIRES_SHARED(Locks::mutator_lock_);
     void CloseJitDumpLog();
 
     void OpenMarkerFile();
     void CloseMarkerFile();
     void WriteJitDumpHeader();
     void WriteJitDumpDebugInfo();
+    void AppendJitDumpRecord(uint32_t event, const void* ptr, uint64_t arg);
+
+    void StartWriter();
+    void StopWriter();
+    void WriterLoop();
+    // Writes out the buffered records. Only one thread writes at a time.
+    void WritePending();
 
     std::unique_ptr<File> perf_file_;
     std::unique_ptr<File> jit_dump_file_;
-    uint64_t code_index_;
+    uint64_t code_index_;  // Guarded by buffer_lock_.
     void* marker_address_;
 
+    // The records not written yet. These are plain std locks since the writer thread is not
+    // attached to the runtime.
+    std::mutex buffer_lock_;
+    std::condition_variable buffer_cond_;
+    std::string perf_map_buffer_;  // Guarded by buffer_lock_.
+    std::vector<uint8_t> jit_dump_buffer_;  // Guarded by buffer_lock_.
+    bool stop_writer_;  // Guarded by buffer_lock_.
+    std::mutex write_lock_;  // Held while writing, keeps batches in order.
+    std::thread writer_;
+
     DISALLOW_COPY_AND_ASSIGN(JitLogger);
 };
 
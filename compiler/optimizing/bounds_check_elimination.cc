@@ -550,7 +550,8 @@ class BCEVisitor : public HGraphVisitor {
     }
     // We should never deoptimize from an osr method, otherwise we might wrongly optimize
     // code dominated by the deoptimization.
-    if (!GetGraph()->IsCompilingOsr()) {
+    if (!GetGraph()->IsCompilingOsr() &&
+        GetGraph()->CanSpeculate(DeoptimizationKind::kBlockBCE)) {
       AddComparesWithDeoptimization(block);
     }
   }
@@ -1663,6 +1664,12 @@ class BCEVisitor : public HGraphVisitor {
       if (GetGraph()->IsCompilingOsr()) {
         return false;
       }
+      // Do not speculate again if the previous compiled code of the method deoptimized too
+      // often in its loop preheaders.
+      if (!GetGraph()->CanSpeculate(DeoptimizationKind::kLoopBoundsBCE) ||
+          !GetGraph()->CanSpeculate(DeoptimizationKind::kLoopNullBCE)) {
+        return false;
+      }
       // A try boundary preheader is hard to handle.
       // TODO: remove this restriction.
       if (loop->GetPreHeader()->GetLastInstruction()->IsTryBoundary()) {
@@ -1731,7 +1738,7 @@ class BCEVisitor : public HGraphVisitor {
       return true;
     } else if (check->IsNullCheck() && check->GetBlock()->GetLoopInformation() == loop) {
       HInstruction* array = check->InputAt(0);
-      if (loop->IsDefinedOutOfTheLoop(array)) {
+      if (CanHandleInvariantLoad(loop, array, needs_taken_test)) {
         // Generate: if (array == null) deoptimize;
         TransformLoopForDeoptimizationIfNeeded(loop, needs_taken_test);
         HBasicBlock* block = GetPreHeader(loop, check);
@@ -1745,6 +1752,31 @@ class BCEVisitor : public HGraphVisitor {
     return false;
   }
 
+  /**
+   * Returns true if the reference is already loop invariant, or can be made so by
+   * hoisting a load from a non-volatile instance field that is not written in the loop,
+   * as in array = this.field or array = obj.field. The null check on the holder
+   * object is handled the same way as for the array itself.
+   */
+  bool CanHandleInvariantLoad(HLoopInformation* loop, HInstruction* ref, bool needs_taken_test) {
+    if (loop->IsDefinedOutOfTheLoop(ref)) {
+      return true;
+    } else if (ref->IsInstanceFieldGet() &&
+               ref->GetBlock()->GetLoopInformation() == loop &&
+               !ref->AsInstanceFieldGet()->IsVolatile()) {
+      SideEffects loop_effects = side_effects_.GetLoopEffects(loop->GetHeader());
+      if (!ref->GetSideEffects().MayDependOn(loop_effects) &&
+          CanHandleNullCheck(loop, ref->InputAt(0), needs_taken_test)) {
+        // The holder is known to be non-null up front now, so the load cannot throw
+        // and can execute speculatively before the loop.
+        TransformLoopForDeoptimizationIfNeeded(loop, needs_taken_test);
+        HoistToPreHeaderOrDeoptBlock(loop, ref);
+        return true;
+      }
+    }
+    return false;
+  }
+
   /**
    * Returns true if compiler can apply dynamic bce to loops that may be infinite
    * (e.g. for (int i = 0; i <= U; i++) with U = MAX_INT), which would invalidate
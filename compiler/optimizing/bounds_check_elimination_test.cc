@@ -469,6 +469,84 @@ TEST_F(BoundsCheckEliminationTest, LoopArrayBoundsElimination1f) {
   ASSERT_TRUE(IsRemoved(bounds_check));
 }
 
+// for (int i = 0; i < n; i++) { obj.array[i] = 10; }
+// Can eliminate with deoptimization, after hoisting the field load out of the loop.
+TEST_F(BoundsCheckEliminationTest, LoopFieldArrayBoundsElimination) {
+  HBasicBlock* entry = new (GetAllocator()) HBasicBlock(graph_);
+  graph_->AddBlock(entry);
+  graph_->SetEntryBlock(entry);
+  HInstruction* object = new (GetAllocator()) HParameterValue(
+      graph_->GetDexFile(), dex::TypeIndex(0), 0, DataType::Type::kReference);
+  HInstruction* n = new (GetAllocator()) HParameterValue(
+      graph_->GetDexFile(), dex::TypeIndex(1), 1, DataType::Type::kInt32);
+  entry->AddInstruction(object);
+  entry->AddInstruction(n);
+
+  HInstruction* constant_0 = graph_->GetIntConstant(0);
+  HInstruction* constant_1 = graph_->GetIntConstant(1);
+  HInstruction* constant_10 = graph_->GetIntConstant(10);
+
+  HBasicBlock* block = new (GetAllocator()) HBasicBlock(graph_);
+  graph_->AddBlock(block);
+  entry->AddSuccessor(block);
+  block->AddInstruction(new (GetAllocator()) HGoto());
+
+  HBasicBlock* loop_header = new (GetAllocator()) HBasicBlock(graph_);
+  HBasicBlock* loop_body = new (GetAllocator()) HBasicBlock(graph_);
+  HBasicBlock* exit = new (GetAllocator()) HBasicBlock(graph_);
+
+  graph_->AddBlock(loop_header);
+  graph_->AddBlock(loop_body);
+  graph_->AddBlock(exit);
+  block->AddSuccessor(loop_header);
+  loop_header->AddSuccessor(exit);       // true successor
+  loop_header->AddSuccessor(loop_body);  // false successor
+  loop_body->AddSuccessor(loop_header);
+
+  HPhi* phi = new (GetAllocator()) HPhi(GetAllocator(), 0, 0, DataType::Type::kInt32);
+  HInstruction* cmp = new (GetAllocator()) HGreaterThanOrEqual(phi, n);
+  loop_header->AddPhi(phi);
+  loop_header->AddInstruction(new (GetAllocator()) HSuspendCheck());
+  loop_header->AddInstruction(cmp);
+  loop_header->AddInstruction(new (GetAllocator()) HIf(cmp));
+  phi->AddInput(constant_0);
+
+  HInstruction* object_null_check = new (GetAllocator()) HNullCheck(object, 0);
+  HInstruction* field_get = new (GetAllocator()) HInstanceFieldGet(object_null_check,
+                                                                   nullptr,
+                                                                   DataType::Type::kReference,
+                                                                   MemberOffset(12),
+                                                                   false,
+                                                                   kUnknownFieldIndex,
+                                                                   kUnknownClassDefIndex,
+                                                                   graph_->GetDexFile(),
+                                                                   0);
+  HInstruction* array_null_check = new (GetAllocator()) HNullCheck(field_get, 0);
+  HInstruction* array_length = new (GetAllocator()) HArrayLength(array_null_check, 0);
+  HInstruction* bounds_check = new (GetAllocator()) HBoundsCheck(phi, array_length, 0);
+  HInstruction* array_set = new (GetAllocator()) HArraySet(
+      array_null_check, bounds_check, constant_10, DataType::Type::kInt32, 0);
+  HInstruction* add = new (GetAllocator()) HAdd(DataType::Type::kInt32, phi, constant_1);
+  loop_body->AddInstruction(object_null_check);
+  loop_body->AddInstruction(field_get);
+  loop_body->AddInstruction(array_null_check);
+  loop_body->AddInstruction(array_length);
+  loop_body->AddInstruction(bounds_check);
+  loop_body->AddInstruction(array_set);
+  loop_body->AddInstruction(add);
+  loop_body->AddInstruction(new (GetAllocator()) HGoto());
+  phi->AddInput(add);
+
+  exit->AddInstruction(new (GetAllocator()) HExit());
+
+  RunBCE();
+
+  ASSERT_TRUE(IsRemoved(bounds_check));
+  ASSERT_TRUE(IsRemoved(object_null_check));
+  ASSERT_TRUE(IsRemoved(array_null_check));
+  ASSERT_FALSE(field_get->GetBlock()->IsInLoop());
+}
+
 // for (int i=array.length; i>0; i+=increment) { array[i-1] = 10; }
 static HInstruction* BuildSSAGraph2(HGraph *graph,
                                     ArenaAllocator* allocator,
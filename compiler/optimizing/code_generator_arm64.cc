@@ -1065,7 +1065,7 @@ void CodeGeneratorARM64::GenerateFrameEntry() {
   MacroAssembler* masm = GetVIXLAssembler();
   __ Bind(&frame_entry_label_);
 
-  if (GetCompilerOptions().CountHotnessInCompiledCode()) {
+  if (CountHotnessInCompiledCode()) {
     UseScratchRegisterScope temps(masm);
     Register temp = temps.AcquireX();
     __ Ldrh(temp, MemOperand(kArtMethodRegister, ArtMethod::HotnessCountOffset().Int32Value()));
@@ -3319,8 +3319,11 @@ void InstructionCodeGeneratorARM64::HandleGoto(HInstruction* got, HBasicBlock* s
   HInstruction* previous = got->GetPrevious();
   HLoopInformation* info = block->GetLoopInformation();
 
-  if (info != nullptr && info->IsBackEdge(*block) && info->HasSuspendCheck()) {
-    if (codegen_->GetCompilerOptions().CountHotnessInCompiledCode()) {
+  if (info != nullptr &&
+      info->IsBackEdge(*block) &&
+      info->HasSuspendCheck() &&
+      !info->GetSuspendCheck()->IsNoOp()) {
+    if (codegen_->CountHotnessInCompiledCode()) {
       UseScratchRegisterScope temps(GetVIXLAssembler());
       Register temp1 = temps.AcquireX();
       Register temp2 = temps.AcquireX();
@@ -3631,6 +3634,10 @@ void InstructionCodeGeneratorARM64::VisitInstanceFieldSet(HInstanceFieldSet* ins
 
 // Temp is used for read barrier.
 static size_t NumberOfInstanceOfTemps(TypeCheckKind type_check_kind) {
+  if (type_check_kind == TypeCheckKind::kInterfaceCheck) {
+    // The number of interfaces left and the current interface, `out` walks the iftable.
+    return 2;
+  }
   if (kEmitCompilerReadBarrier &&
       (kUseBakerReadBarrier ||
           type_check_kind == TypeCheckKind::kAbstractClassCheck ||
@@ -3705,12 +3712,16 @@ void InstructionCodeGeneratorARM64::VisitInstanceOf(HInstanceOf* instruction) {
   Location out_loc = locations->Out();
   Register out = OutputRegister(instruction);
   const size_t num_temps = NumberOfInstanceOfTemps(type_check_kind);
-  DCHECK_LE(num_temps, 1u);
+  DCHECK_LE(num_temps, (type_check_kind == TypeCheckKind::kInterfaceCheck) ? 2u : 1u);
   Location maybe_temp_loc = (num_temps >= 1) ? locations->GetTemp(0) : Location::NoLocation();
   uint32_t class_offset = mirror::Object::ClassOffset().Int32Value();
   uint32_t super_offset = mirror::Class::SuperClassOffset().Int32Value();
   uint32_t component_offset = mirror::Class::ComponentTypeOffset().Int32Value();
   uint32_t primitive_offset = mirror::Class::PrimitiveTypeOffset().Int32Value();
+  const uint32_t iftable_offset = mirror::Class::IfTableOffset().Uint32Value();
+  const uint32_t array_length_offset = mirror::Array::LengthOffset().Uint32Value();
+  const uint32_t object_array_data_offset =
+      mirror::Array::DataOffset(kHeapReferenceSize).Uint32Value();
 
   vixl::aarch64::Label done, zero;
   SlowPathCodeARM64* slow_path = nullptr;
@@ -3857,11 +3868,53 @@ void InstructionCodeGeneratorARM64::VisitInstanceOf(HInstanceOf* instruction) {
       break;
     }
 
-    case TypeCheckKind::kUnresolvedCheck:
     case TypeCheckKind::kInterfaceCheck: {
+      // Look for the interface in the iftable, as VisitCheckCast does. Without read barriers the
+      // loaded classes may be from-space references and not match, so the slow path does the
+      // full check whenever the interface is not found.
+      Register count = WRegisterFrom(locations->GetTemp(0));
+      Register iface = WRegisterFrom(locations->GetTemp(1));
+      // /* HeapReference<Class> */ out = obj->klass_
+      GenerateReferenceLoadTwoRegisters(instruction,
+                                        out_loc,
+                                        obj_loc,
+                                        class_offset,
+                                        maybe_temp_loc,
+                                        kWithoutReadBarrier);
+      // /* HeapReference<Class> */ out = out->iftable_
+      GenerateReferenceLoadTwoRegisters(instruction,
+                                        out_loc,
+                                        out_loc,
+                                        iftable_offset,
+                                        maybe_temp_loc,
+                                        kWithoutReadBarrier);
+      DCHECK(locations->OnlyCallsOnSlowPath());
+      slow_path = new (codegen_->GetScopedAllocator()) TypeCheckSlowPathARM64(
+          instruction, /* is_fatal= */ false);
+      codegen_->AddSlowPath(slow_path);
+      // Iftable is never null.
+      __ Ldr(count, HeapOperand(out, array_length_offset));
+      vixl::aarch64::Label start_loop;
+      __ Bind(&start_loop);
+      __ Cbz(count, slow_path->GetEntryLabel());
+      __ Ldr(iface, HeapOperand(out, object_array_data_offset));
+      GetAssembler()->MaybeUnpoisonHeapReference(iface);
+      // Go to next interface.
+      __ Add(out, out, 2 * kHeapReferenceSize);
+      __ Sub(count, count, 2);
+      // Compare the classes and continue the loop if they do not match.
+      __ Cmp(cls, iface);
+      __ B(ne, &start_loop);
+      __ Mov(out, 1);
+      if (zero.IsLinked()) {
+        __ B(&done);
+      }
+      break;
+    }
+
+    case TypeCheckKind::kUnresolvedCheck: {
       // Note that we indeed only call on slow path, but we always go
-      // into the slow path for the unresolved and interface check
-      // cases.
+      // into the slow path for the unresolved check case.
       //
       // We cannot directly call the InstanceofNonTrivial runtime
       // entry point without resorting to a type checking slow path
@@ -4416,10 +4469,20 @@ void CodeGeneratorARM64::GenerateVirtualCall(
 }
 
 void LocationsBuilderARM64::VisitInvokePolymorphic(HInvokePolymorphic* invoke) {
+  IntrinsicLocationsBuilderARM64 intrinsic(GetGraph()->GetAllocator(), codegen_);
+  if (intrinsic.TryDispatch(invoke)) {
+    return;
+  }
+
   HandleInvoke(invoke);
 }
 
 void InstructionCodeGeneratorARM64::VisitInvokePolymorphic(HInvokePolymorphic* invoke) {
+  if (TryGenerateIntrinsicCode(invoke, codegen_)) {
+    codegen_->MaybeGenerateMarkingRegisterCheck(/* code= */ __LINE__);
+    return;
+  }
+
   codegen_->GenerateInvokePolymorphicCall(invoke);
   codegen_->MaybeGenerateMarkingRegisterCheck(/* code= */ __LINE__);
 }
@@ -4600,6 +4663,25 @@ void CodeGeneratorARM64::LoadBootImageAddress(vixl::aarch64::Register reg,
   }
 }
 
+void CodeGeneratorARM64::LoadIntrinsicDeclaringClass(vixl::aarch64::Register reg,
+                                                     HInvoke* invoke) {
+  DCHECK_NE(invoke->GetIntrinsic(), Intrinsics::kNone);
+  if (GetCompilerOptions().IsBootImage()) {
+    // Load the class the same way as for HLoadClass::LoadKind::kBootImageLinkTimePcRelative.
+    MethodReference target_method = invoke->AsInvokeStaticOrDirect()->GetTargetMethod();
+    dex::TypeIndex type_idx = target_method.dex_file->GetMethodId(target_method.index).class_idx_;
+    // Add ADRP with its PC-relative type patch.
+    vixl::aarch64::Label* adrp_label = NewBootImageTypePatch(*target_method.dex_file, type_idx);
+    EmitAdrpPlaceholder(adrp_label, reg.X());
+    // Add ADD with its PC-relative type patch.
+    vixl::aarch64::Label* add_label =
+        NewBootImageTypePatch(*target_method.dex_file, type_idx, adrp_label);
+    EmitAddPlaceholder(add_label, reg.X(), reg.X());
+  } else {
+    LoadBootImageAddress(reg, GetBootImageOffsetOfIntrinsicDeclaringClass(invoke));
+  }
+}
+
 void CodeGeneratorARM64::AllocateInstanceForIntrinsic(HInvokeStaticOrDirect* invoke,
                                                       uint32_t boot_image_offset) {
   DCHECK(invoke->IsStatic());
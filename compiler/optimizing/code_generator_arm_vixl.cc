@@ -1832,7 +1832,8 @@ vixl32::Label* CodeGeneratorARMVIXL::GetFinalLabel(HInstruction* instruction,
   // Avoid a branch to a branch.
   if (next->IsGoto() && (info == nullptr ||
                          !info->IsBackEdge(*block) ||
-                         !info->HasSuspendCheck())) {
+                         !info->HasSuspendCheck() ||
+                         info->GetSuspendCheck()->IsNoOp())) {
     final_label = GetLabelOf(next->AsGoto()->GetSuccessor());
   }
 
@@ -2085,7 +2086,7 @@ void CodeGeneratorARMVIXL::GenerateFrameEntry() {
   DCHECK(GetCompilerOptions().GetImplicitStackOverflowChecks());
   __ Bind(&frame_entry_label_);
 
-  if (GetCompilerOptions().CountHotnessInCompiledCode()) {
+  if (CountHotnessInCompiledCode()) {
     UseScratchRegisterScope temps(GetVIXLAssembler());
     vixl32::Register temp = temps.Acquire();
     static_assert(ArtMethod::MaxCounter() == 0xFFFF, "asm is probably wrong");
@@ -2496,8 +2497,11 @@ void InstructionCodeGeneratorARMVIXL::HandleGoto(HInstruction* got, HBasicBlock*
   HInstruction* previous = got->GetPrevious();
   HLoopInformation* info = block->GetLoopInformation();
 
-  if (info != nullptr && info->IsBackEdge(*block) && info->HasSuspendCheck()) {
-    if (codegen_->GetCompilerOptions().CountHotnessInCompiledCode()) {
+  if (info != nullptr &&
+      info->IsBackEdge(*block) &&
+      info->HasSuspendCheck() &&
+      !info->GetSuspendCheck()->IsNoOp()) {
+    if (codegen_->CountHotnessInCompiledCode()) {
       UseScratchRegisterScope temps(GetVIXLAssembler());
       vixl32::Register temp = temps.Acquire();
       __ Push(vixl32::Register(kMethodRegister));
@@ -1288,7 +1288,7 @@ static dwarf::Reg DWARFReg(Register reg) {
 void CodeGeneratorMIPS::GenerateFrameEntry() {
   __ Bind(&frame_entry_label_);
 
-  if (GetCompilerOptions().CountHotnessInCompiledCode()) {
+  if (CountHotnessInCompiledCode()) {
     __ Lhu(TMP, kMethodRegisterArgument, ArtMethod::HotnessCountOffset().Int32Value());
     __ Addiu(TMP, TMP, 1);
     __ Sh(TMP, kMethodRegisterArgument, ArtMethod::HotnessCountOffset().Int32Value());
@@ -4368,8 +4368,11 @@ void InstructionCodeGeneratorMIPS::HandleGoto(HInstruction* got, HBasicBlock* su
   HInstruction* previous = got->GetPrevious();
   HLoopInformation* info = block->GetLoopInformation();
 
-  if (info != nullptr && info->IsBackEdge(*block) && info->HasSuspendCheck()) {
-    if (codegen_->GetCompilerOptions().CountHotnessInCompiledCode()) {
+  if (info != nullptr &&
+      info->IsBackEdge(*block) &&
+      info->HasSuspendCheck() &&
+      !info->GetSuspendCheck()->IsNoOp()) {
+    if (codegen_->CountHotnessInCompiledCode()) {
       __ Lw(AT, SP, kCurrentMethodStackOffset);
       __ Lhu(TMP, AT, ArtMethod::HotnessCountOffset().Int32Value());
       __ Addiu(TMP, TMP, 1);
@@ -1089,7 +1089,7 @@ static dwarf::Reg DWARFReg(FpuRegister reg) {
 void CodeGeneratorMIPS64::GenerateFrameEntry() {
   __ Bind(&frame_entry_label_);
 
-  if (GetCompilerOptions().CountHotnessInCompiledCode()) {
+  if (CountHotnessInCompiledCode()) {
     __ Lhu(TMP, kMethodRegisterArgument, ArtMethod::HotnessCountOffset().Int32Value());
     __ Addiu(TMP, TMP, 1);
     __ Sh(TMP, kMethodRegisterArgument, ArtMethod::HotnessCountOffset().Int32Value());
@@ -3695,8 +3695,11 @@ void InstructionCodeGeneratorMIPS64::HandleGoto(HInstruction* got, HBasicBlock*
   HInstruction* previous = got->GetPrevious();
   HLoopInformation* info = block->GetLoopInformation();
 
-  if (info != nullptr && info->IsBackEdge(*block) && info->HasSuspendCheck()) {
-    if (codegen_->GetCompilerOptions().CountHotnessInCompiledCode()) {
+  if (info != nullptr &&
+      info->IsBackEdge(*block) &&
+      info->HasSuspendCheck() &&
+      !info->GetSuspendCheck()->IsNoOp()) {
+    if (codegen_->CountHotnessInCompiledCode()) {
       __ Ld(AT, SP, kCurrentMethodStackOffset);
       __ Lhu(TMP, AT, ArtMethod::HotnessCountOffset().Int32Value());
       __ Addiu(TMP, TMP, 1);
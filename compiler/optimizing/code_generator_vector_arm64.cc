@@ -959,6 +959,92 @@ void InstructionCodeGeneratorARM64::VisitVecUShr(HVecUShr* instruction) {
   }
 }
 
+void LocationsBuilderARM64::VisitVecCondition(HVecCondition* instruction) {
+  CreateVecBinOpLocations(GetGraph()->GetAllocator(), instruction);
+}
+
+void InstructionCodeGeneratorARM64::VisitVecCondition(HVecCondition* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  VRegister lhs = VRegisterFrom(locations->InAt(0));
+  VRegister rhs = VRegisterFrom(locations->InAt(1));
+  VRegister dst = VRegisterFrom(locations->Out());
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kBool:
+    case DataType::Type::kUint8:
+    case DataType::Type::kInt8:
+      DCHECK_EQ(16u, instruction->GetVectorLength());
+      lhs = lhs.V16B();
+      rhs = rhs.V16B();
+      dst = dst.V16B();
+      break;
+    case DataType::Type::kUint16:
+    case DataType::Type::kInt16:
+      DCHECK_EQ(8u, instruction->GetVectorLength());
+      lhs = lhs.V8H();
+      rhs = rhs.V8H();
+      dst = dst.V8H();
+      break;
+    case DataType::Type::kInt32:
+      DCHECK_EQ(4u, instruction->GetVectorLength());
+      lhs = lhs.V4S();
+      rhs = rhs.V4S();
+      dst = dst.V4S();
+      break;
+    case DataType::Type::kInt64:
+      DCHECK_EQ(2u, instruction->GetVectorLength());
+      lhs = lhs.V2D();
+      rhs = rhs.V2D();
+      dst = dst.V2D();
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+  switch (instruction->GetCondition()) {
+    case kCondEQ:
+      __ Cmeq(dst, lhs, rhs);
+      break;
+    case kCondNE:
+      __ Cmeq(dst, lhs, rhs);
+      __ Mvn(dst.V16B(), dst.V16B());  // lanes do not matter
+      break;
+    case kCondLT:
+      __ Cmgt(dst, rhs, lhs);
+      break;
+    case kCondLE:
+      __ Cmge(dst, rhs, lhs);
+      break;
+    case kCondGT:
+      __ Cmgt(dst, lhs, rhs);
+      break;
+    case kCondGE:
+      __ Cmge(dst, lhs, rhs);
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD condition: " << instruction->GetCondition();
+      UNREACHABLE();
+  }
+}
+
+void LocationsBuilderARM64::VisitVecSelect(HVecSelect* instruction) {
+  LocationSummary* locations = new (GetGraph()->GetAllocator()) LocationSummary(instruction);
+  locations->SetInAt(0, Location::RequiresFpuRegister());
+  locations->SetInAt(1, Location::RequiresFpuRegister());
+  locations->SetInAt(2, Location::RequiresFpuRegister());
+  locations->SetOut(Location::SameAsFirstInput());
+}
+
+void InstructionCodeGeneratorARM64::VisitVecSelect(HVecSelect* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  DCHECK(locations->InAt(0).Equals(locations->Out()));
+  VRegister true_value = VRegisterFrom(locations->InAt(1));
+  VRegister mask = VRegisterFrom(locations->InAt(2));
+  VRegister dst = VRegisterFrom(locations->Out());
+  DCHECK_EQ(16u, instruction->GetVectorNumberOfBytes());
+  // Insert the true value into the false value wherever the mask is set.
+  __ Bit(dst.V16B(), true_value.V16B(), mask.V16B());  // lanes do not matter
+}
+
 void LocationsBuilderARM64::VisitVecSetScalars(HVecSetScalars* instruction) {
   LocationSummary* locations = new (GetGraph()->GetAllocator()) LocationSummary(instruction);
 
@@ -985,6 +985,129 @@ void InstructionCodeGeneratorX86_64::VisitVecUShr(HVecUShr* instruction) {
   }
 }
 
+// Helper to emit a packed equality comparison of the given type.
+static void EmitVecCompareEqual(X86_64Assembler* assembler,
+                                XmmRegister dst,
+                                XmmRegister src,
+                                DataType::Type packed_type) {
+  switch (packed_type) {
+    case DataType::Type::kBool:
+    case DataType::Type::kUint8:
+    case DataType::Type::kInt8:
+      assembler->pcmpeqb(dst, src);
+      break;
+    case DataType::Type::kUint16:
+    case DataType::Type::kInt16:
+      assembler->pcmpeqw(dst, src);
+      break;
+    case DataType::Type::kInt32:
+      assembler->pcmpeqd(dst, src);
+      break;
+    case DataType::Type::kInt64:
+      assembler->pcmpeqq(dst, src);
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << packed_type;
+      UNREACHABLE();
+  }
+}
+
+// Helper to emit a packed signed greater-than comparison of the given type.
+static void EmitVecCompareGreaterThan(X86_64Assembler* assembler,
+                                      XmmRegister dst,
+                                      XmmRegister src,
+                                      DataType::Type packed_type) {
+  switch (packed_type) {
+    case DataType::Type::kInt8:
+      assembler->pcmpgtb(dst, src);
+      break;
+    case DataType::Type::kInt16:
+      assembler->pcmpgtw(dst, src);
+      break;
+    case DataType::Type::kInt32:
+      assembler->pcmpgtd(dst, src);
+      break;
+    case DataType::Type::kInt64:
+      assembler->pcmpgtq(dst, src);  // SSE4.2
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << packed_type;
+      UNREACHABLE();
+  }
+}
+
+void LocationsBuilderX86_64::VisitVecCondition(HVecCondition* instruction) {
+  CreateVecBinOpLocations(GetGraph()->GetAllocator(), instruction);
+  // Needed for swapped operands and for the all ones mask of negated conditions.
+  instruction->GetLocations()->AddTemp(Location::RequiresFpuRegister());
+}
+
+void InstructionCodeGeneratorX86_64::VisitVecCondition(HVecCondition* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  DCHECK(locations->InAt(0).Equals(locations->Out()));
+  XmmRegister src = locations->InAt(1).AsFpuRegister<XmmRegister>();
+  XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  XmmRegister tmp = locations->GetTemp(0).AsFpuRegister<XmmRegister>();
+  DataType::Type packed_type = instruction->GetPackedType();
+  DCHECK_EQ(16u, instruction->GetVectorNumberOfBytes());
+  // SSE only compares for equality and signed greater-than, so the other
+  // conditions swap operands and/or negate the resulting mask.
+  bool negate = false;
+  switch (instruction->GetCondition()) {
+    case kCondNE:
+      negate = true;
+      FALLTHROUGH_INTENDED;
+    case kCondEQ:
+      EmitVecCompareEqual(GetAssembler(), dst, src, packed_type);
+      break;
+    case kCondLE:
+      negate = true;
+      FALLTHROUGH_INTENDED;
+    case kCondGT:
+      EmitVecCompareGreaterThan(GetAssembler(), dst, src, packed_type);
+      break;
+    case kCondGE:
+      negate = true;
+      FALLTHROUGH_INTENDED;
+    case kCondLT:
+      __ movaps(tmp, src);
+      EmitVecCompareGreaterThan(GetAssembler(), tmp, dst, packed_type);
+      __ movaps(dst, tmp);
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD condition: " << instruction->GetCondition();
+      UNREACHABLE();
+  }
+  if (negate) {
+    __ pcmpeqb(tmp, tmp);
+    __ pxor(dst, tmp);
+  }
+}
+
+void LocationsBuilderX86_64::VisitVecSelect(HVecSelect* instruction) {
+  LocationSummary* locations = new (GetGraph()->GetAllocator()) LocationSummary(instruction);
+  locations->SetInAt(0, Location::RequiresFpuRegister());
+  locations->SetInAt(1, Location::RequiresFpuRegister());
+  locations->SetInAt(2, Location::RequiresFpuRegister());
+  locations->SetOut(Location::SameAsFirstInput());
+  locations->AddTemp(Location::RequiresFpuRegister());
+}
+
+void InstructionCodeGeneratorX86_64::VisitVecSelect(HVecSelect* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  DCHECK(locations->InAt(0).Equals(locations->Out()));
+  XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  XmmRegister true_value = locations->InAt(1).AsFpuRegister<XmmRegister>();
+  XmmRegister mask = locations->InAt(2).AsFpuRegister<XmmRegister>();
+  XmmRegister tmp = locations->GetTemp(0).AsFpuRegister<XmmRegister>();
+  DCHECK_EQ(16u, instruction->GetVectorNumberOfBytes());
+  // dst = false ^ ((false ^ true) & mask), lanes do not matter.
+  __ movaps(tmp, true_value);
+  __ pxor(tmp, dst);
+  __ pand(tmp, mask);
+  __ pxor(dst, tmp);
+}
+
 void LocationsBuilderX86_64::VisitVecSetScalars(HVecSetScalars* instruction) {
   LocationSummary* locations = new (GetGraph()->GetAllocator()) LocationSummary(instruction);
 
@@ -1102,11 +1225,38 @@ void InstructionCodeGeneratorX86_64::VisitVecSADAccumulate(HVecSADAccumulate* in
 }
 
 void LocationsBuilderX86_64::VisitVecDotProd(HVecDotProd* instruction) {
-  LOG(FATAL) << "No SIMD for " << instruction->GetId();
+  LocationSummary* locations = new (GetGraph()->GetAllocator()) LocationSummary(instruction);
+  DCHECK(instruction->GetPackedType() == DataType::Type::kInt32);
+  locations->SetInAt(0, Location::RequiresFpuRegister());
+  locations->SetInAt(1, Location::RequiresFpuRegister());
+  locations->SetInAt(2, Location::RequiresFpuRegister());
+  locations->SetOut(Location::SameAsFirstInput());
+  // PMADDWD overwrites its first operand.
+  locations->AddTemp(Location::RequiresFpuRegister());
 }
 
 void InstructionCodeGeneratorX86_64::VisitVecDotProd(HVecDotProd* instruction) {
-  LOG(FATAL) << "No SIMD for " << instruction->GetId();
+  LocationSummary* locations = instruction->GetLocations();
+  DCHECK(locations->InAt(0).Equals(locations->Out()));
+  XmmRegister acc = locations->InAt(0).AsFpuRegister<XmmRegister>();
+  XmmRegister left = locations->InAt(1).AsFpuRegister<XmmRegister>();
+  XmmRegister right = locations->InAt(2).AsFpuRegister<XmmRegister>();
+  XmmRegister tmp = locations->GetTemp(0).AsFpuRegister<XmmRegister>();
+  HVecOperation* a = instruction->InputAt(1)->AsVecOperation();
+  HVecOperation* b = instruction->InputAt(2)->AsVecOperation();
+  DCHECK_EQ(HVecOperation::ToSignedType(a->GetPackedType()),
+            HVecOperation::ToSignedType(b->GetPackedType()));
+  DCHECK_EQ(instruction->GetPackedType(), DataType::Type::kInt32);
+  DCHECK_EQ(4u, instruction->GetVectorLength());
+
+  // Only the signed 16-bit dot product is supported, see HLoopOptimization::TrySetVectorType().
+  DCHECK_EQ(a->GetPackedType(), DataType::Type::kInt16);
+  DCHECK_EQ(8u, a->GetVectorLength());
+  DCHECK(!instruction->IsZeroExtending());
+  // Multiply the eight pairs of 16-bit values and add adjacent 32-bit products.
+  __ movaps(tmp, left);
+  __ pmaddwd(tmp, right);
+  __ paddd(acc, tmp);
 }
 
 // Helper to set up locations for vector memory operations.
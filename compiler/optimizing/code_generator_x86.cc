@@ -1077,7 +1077,7 @@ void CodeGeneratorX86::GenerateFrameEntry() {
       IsLeafMethod() && !FrameNeedsStackCheck(GetFrameSize(), InstructionSet::kX86);
   DCHECK(GetCompilerOptions().GetImplicitStackOverflowChecks());
 
-  if (GetCompilerOptions().CountHotnessInCompiledCode()) {
+  if (CountHotnessInCompiledCode()) {
     NearLabel overflow;
     __ cmpw(Address(kMethodRegisterArgument,
                     ArtMethod::HotnessCountOffset().Int32Value()),
@@ -1388,8 +1388,11 @@ void InstructionCodeGeneratorX86::HandleGoto(HInstruction* got, HBasicBlock* suc
   HInstruction* previous = got->GetPrevious();
 
   HLoopInformation* info = block->GetLoopInformation();
-  if (info != nullptr && info->IsBackEdge(*block) && info->HasSuspendCheck()) {
-    if (codegen_->GetCompilerOptions().CountHotnessInCompiledCode()) {
+  if (info != nullptr &&
+      info->IsBackEdge(*block) &&
+      info->HasSuspendCheck() &&
+      !info->GetSuspendCheck()->IsNoOp()) {
+    if (codegen_->CountHotnessInCompiledCode()) {
       __ pushl(EAX);
       __ movl(EAX, Address(ESP, kX86WordSize));
           NearLabel overflow;
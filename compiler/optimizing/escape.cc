@@ -20,66 +20,44 @@
 
 namespace art {
 
-void CalculateEscape(HInstruction* reference,
-                     bool (*no_escape)(HInstruction*, HInstruction*),
-                     /*out*/ bool* is_singleton,
-                     /*out*/ bool* is_singleton_and_not_returned,
-                     /*out*/ bool* is_singleton_and_not_deopt_visible) {
-  // For references not allocated in the method, don't assume anything.
-  if (!reference->IsNewInstance() && !reference->IsNewArray()) {
-    *is_singleton = false;
-    *is_singleton_and_not_returned = false;
-    *is_singleton_and_not_deopt_visible = false;
-    return;
-  }
-  // Assume the best until proven otherwise.
-  *is_singleton = true;
-  *is_singleton_and_not_returned = true;
-  *is_singleton_and_not_deopt_visible = true;
-
-  if (reference->IsNewInstance() && reference->AsNewInstance()->IsFinalizable()) {
-    // Finalizable reference is treated as being returned in the end.
-    *is_singleton_and_not_returned = false;
-  }
-
-  // Visit all uses to determine if this reference can escape into the heap,
-  // a method call, an alias, etc.
-  for (const HUseListNode<HInstruction*>& use : reference->GetUses()) {
+// Visits the uses of `alias`, the allocation itself or an instruction that refers to the
+// same object. Returns false as soon as the object has been found to escape.
+static bool VisitUsesOfAlias(HInstruction* alias,
+                             bool (*no_escape)(HInstruction*, HInstruction*),
+                             /*inout*/ bool* is_singleton_and_not_returned,
+                             /*inout*/ bool* is_singleton_and_not_deopt_visible) {
+  for (const HUseListNode<HInstruction*>& use : alias->GetUses()) {
     HInstruction* user = use.GetUser();
-    if (no_escape != nullptr && (*no_escape)(reference, user)) {
+    if (no_escape != nullptr && (*no_escape)(alias, user)) {
       // Client supplied analysis says there is no escape.
       continue;
     } else if (user->IsBoundType() || user->IsNullCheck()) {
-      // BoundType shouldn't normally be necessary for an allocation. Just be conservative
-      // for the uncommon cases. Similarly, null checks are eventually eliminated for explicit
-      // allocations, but if we see one before it is simplified, assume an alias.
-      *is_singleton = false;
-      *is_singleton_and_not_returned = false;
-      *is_singleton_and_not_deopt_visible = false;
-      return;
+      // BoundType shouldn't normally be necessary for an allocation, and null checks
+      // are eventually eliminated for explicit allocations. If we see one before it
+      // is simplified, it is just another name for the same object, so look through it.
+      if (!VisitUsesOfAlias(user,
+                            no_escape,
+                            is_singleton_and_not_returned,
+                            is_singleton_and_not_deopt_visible)) {
+        return false;
+      }
     } else if (user->IsPhi() ||
                user->IsSelect() ||
                (user->IsInvoke() && user->GetSideEffects().DoesAnyWrite()) ||
-               (user->IsInstanceFieldSet() && (reference == user->InputAt(1))) ||
-               (user->IsUnresolvedInstanceFieldSet() && (reference == user->InputAt(1))) ||
-               (user->IsStaticFieldSet() && (reference == user->InputAt(1))) ||
-               (user->IsUnresolvedStaticFieldSet() && (reference == user->InputAt(0))) ||
-               (user->IsArraySet() && (reference == user->InputAt(2)))) {
+               (user->IsInstanceFieldSet() && (alias == user->InputAt(1))) ||
+               (user->IsUnresolvedInstanceFieldSet() && (alias == user->InputAt(1))) ||
+               (user->IsStaticFieldSet() && (alias == user->InputAt(1))) ||
+               (user->IsUnresolvedStaticFieldSet() && (alias == user->InputAt(0))) ||
+               (user->IsArraySet() && (alias == user->InputAt(2)))) {
       // The reference is merged to HPhi/HSelect, passed to a callee, or stored to heap.
       // Hence, the reference is no longer the only name that can refer to its value.
-      *is_singleton = false;
-      *is_singleton_and_not_returned = false;
-      *is_singleton_and_not_deopt_visible = false;
-      return;
-    } else if ((user->IsUnresolvedInstanceFieldGet() && (reference == user->InputAt(0))) ||
-               (user->IsUnresolvedInstanceFieldSet() && (reference == user->InputAt(0)))) {
+      return false;
+    } else if ((user->IsUnresolvedInstanceFieldGet() && (alias == user->InputAt(0))) ||
+               (user->IsUnresolvedInstanceFieldSet() && (alias == user->InputAt(0)))) {
       // The field is accessed in an unresolved way. We mark the object as a non-singleton.
       // Note that we could optimize this case and still perform some optimizations until
       // we hit the unresolved access, but the conservative assumption is the simplest.
-      *is_singleton = false;
-      *is_singleton_and_not_returned = false;
-      *is_singleton_and_not_deopt_visible = false;
-      return;
+      return false;
     } else if (user->IsReturn()) {
       *is_singleton_and_not_returned = false;
     }
@@ -87,13 +65,48 @@ void CalculateEscape(HInstruction* reference,
 
   // Look at the environment uses if it's for HDeoptimize. Other environment uses are fine,
   // as long as client optimizations that rely on this information are disabled for debuggable.
-  for (const HUseListNode<HEnvironment*>& use : reference->GetEnvUses()) {
+  for (const HUseListNode<HEnvironment*>& use : alias->GetEnvUses()) {
     HEnvironment* user = use.GetUser();
     if (user->GetHolder()->IsDeoptimize()) {
       *is_singleton_and_not_deopt_visible = false;
       break;
     }
   }
+  return true;
+}
+
+void CalculateEscape(HInstruction* reference,
+                     bool (*no_escape)(HInstruction*, HInstruction*),
+                     /*out*/ bool* is_singleton,
+                     /*out*/ bool* is_singleton_and_not_returned,
+                     /*out*/ bool* is_singleton_and_not_deopt_visible) {
+  // For references not allocated in the method, don't assume anything.
+  if (!reference->IsNewInstance() && !reference->IsNewArray()) {
+    *is_singleton = false;
+    *is_singleton_and_not_returned = false;
+    *is_singleton_and_not_deopt_visible = false;
+    return;
+  }
+  // Assume the best until proven otherwise.
+  *is_singleton = true;
+  *is_singleton_and_not_returned = true;
+  *is_singleton_and_not_deopt_visible = true;
+
+  if (reference->IsNewInstance() && reference->AsNewInstance()->IsFinalizable()) {
+    // Finalizable reference is treated as being returned in the end.
+    *is_singleton_and_not_returned = false;
+  }
+
+  // Visit all uses, including those of aliases, to determine if this reference
+  // can escape into the heap, a method call, etc.
+  if (!VisitUsesOfAlias(reference,
+                        no_escape,
+                        is_singleton_and_not_returned,
+                        is_singleton_and_not_deopt_visible)) {
+    *is_singleton = false;
+    *is_singleton_and_not_returned = false;
+    *is_singleton_and_not_deopt_visible = false;
+  }
 }
 
 bool DoesNotEscape(HInstruction* reference, bool (*no_escape)(HInstruction*, HInstruction*)) {
@@ -49,7 +49,9 @@ class HInstruction;
  * analysis in certain case-specific circumstances. If 'no_escape(reference, user)'
  * returns true, the user is assumed *not* to cause any escape right away. The return
  * value false means the client cannot provide a definite answer and built-in escape
- * analysis is applied to the user instead.
+ * analysis is applied to the user instead. Null checks and bound types of the
+ * allocation are looked through as aliases of the same object, so the 'reference'
+ * passed to no_escape is the instruction actually used by 'user'.
  */
 void CalculateEscape(HInstruction* reference,
                      bool (*no_escape)(HInstruction*, HInstruction*),
@@ -68,6 +68,10 @@ static constexpr size_t kMaximumNumberOfRecursiveCalls = 4;
 // Controls the use of inline caches in AOT mode.
 static constexpr bool kUseAOTInlineCaches = true;
 
+// A polymorphic call target seen for less than 1/N of the receivers is not worth
+// the type guard and the inlining budget; leave it to the original invoke.
+static constexpr size_t kRarePolymorphicTargetRatio = 16;
+
 // We check for line numbers to make sure the DepthString implementation
 // aligns the output nicely.
 #define LOG_INTERNAL(msg) \
@@ -391,6 +395,9 @@ ArtMethod* HInliner::TryCHADevirtualization(ArtMethod* resolved_method) {
     // We do not support HDeoptimize in OSR methods.
     return nullptr;
   }
+  if (!outermost_graph_->CanSpeculate(DeoptimizationKind::kCHA)) {
+    return nullptr;
+  }
   PointerSize pointer_size = caller_compilation_unit_.GetClassLinker()->GetImagePointerSize();
   ArtMethod* single_impl = resolved_method->GetSingleImplementation(pointer_size);
   if (single_impl == nullptr) {
@@ -582,7 +589,12 @@ bool HInliner::UseOnlyPolymorphicInliningWithNoDeopt() {
   //
   // For OSR:
   //     We may come from the interpreter and it may have seen different receiver types.
-  return Runtime::Current()->IsAotCompiler() || outermost_graph_->IsCompilingOsr();
+  //
+  // For JIT code replacing code that deoptimized too often on inline cache guards:
+  //     The inline caches keep missing types, deoptimizing again would not help.
+  return Runtime::Current()->IsAotCompiler() ||
+      outermost_graph_->IsCompilingOsr() ||
+      !outermost_graph_->CanSpeculate(DeoptimizationKind::kJitInlineCache);
 }
 bool HInliner::TryInlineFromInlineCache(const DexFile& caller_dex_file,
                                         HInvoke* invoke_instruction,
@@ -594,12 +606,14 @@ bool HInliner::TryInlineFromInlineCache(const DexFile& caller_dex_file,
 
   StackHandleScope<1> hs(Thread::Current());
   Handle<mirror::ObjectArray<mirror::Class>> inline_cache;
+  // Receiver frequencies are only known for runtime inline caches.
+  uint16_t receiver_counts[InlineCache::kIndividualCacheSize] = {};
   // The Zygote JIT compiles based on a profile, so we shouldn't use runtime inline caches
   // for it.
   InlineCacheType inline_cache_type =
       (Runtime::Current()->IsAotCompiler() || Runtime::Current()->IsZygote())
           ? GetInlineCacheAOT(caller_dex_file, invoke_instruction, &hs, &inline_cache)
-          : GetInlineCacheJIT(invoke_instruction, &hs, &inline_cache);
+          : GetInlineCacheJIT(invoke_instruction, &hs, &inline_cache, receiver_counts);
 
   switch (inline_cache_type) {
     case kInlineCacheNoData: {
@@ -620,7 +634,8 @@ bool HInliner::TryInlineFromInlineCache(const DexFile& caller_dex_file,
     case kInlineCacheMonomorphic: {
       MaybeRecordStat(stats_, MethodCompilationStat::kMonomorphicCall);
       if (UseOnlyPolymorphicInliningWithNoDeopt()) {
-        return TryInlinePolymorphicCall(invoke_instruction, resolved_method, inline_cache);
+        return TryInlinePolymorphicCall(
+            invoke_instruction, resolved_method, inline_cache, receiver_counts);
       } else {
         return TryInlineMonomorphicCall(invoke_instruction, resolved_method, inline_cache);
       }
@@ -628,7 +643,8 @@ bool HInliner::TryInlineFromInlineCache(const DexFile& caller_dex_file,
 
     case kInlineCachePolymorphic: {
       MaybeRecordStat(stats_, MethodCompilationStat::kPolymorphicCall);
-      return TryInlinePolymorphicCall(invoke_instruction, resolved_method, inline_cache);
+      return TryInlinePolymorphicCall(
+          invoke_instruction, resolved_method, inline_cache, receiver_counts);
     }
 
     case kInlineCacheMegamorphic: {
@@ -654,7 +670,8 @@ bool HInliner::TryInlineFromInlineCache(const DexFile& caller_dex_file,
 HInliner::InlineCacheType HInliner::GetInlineCacheJIT(
     HInvoke* invoke_instruction,
     StackHandleScope<1>* hs,
-    /*out*/Handle<mirror::ObjectArray<mirror::Class>>* inline_cache)
+    /*out*/Handle<mirror::ObjectArray<mirror::Class>>* inline_cache,
+    /*out*/uint16_t* receiver_counts)
     REQUIRES_SHARED(Locks::mutator_lock_) {
   DCHECK(Runtime::Current()->UseJitCompilation());
 
@@ -675,7 +692,8 @@ HInliner::InlineCacheType HInliner::GetInlineCacheJIT(
   } else {
     Runtime::Current()->GetJit()->GetCodeCache()->CopyInlineCacheInto(
         *profiling_info->GetInlineCache(invoke_instruction->GetDexPc()),
-        *inline_cache);
+        *inline_cache,
+        receiver_counts);
     return GetInlineCacheType(*inline_cache);
   }
 }
@@ -993,7 +1011,8 @@ HInstruction* HInliner::AddTypeGuard(HInstruction* receiver,
 
 bool HInliner::TryInlinePolymorphicCall(HInvoke* invoke_instruction,
                                         ArtMethod* resolved_method,
-                                        Handle<mirror::ObjectArray<mirror::Class>> classes) {
+                                        Handle<mirror::ObjectArray<mirror::Class>> classes,
+                                        const uint16_t* receiver_counts) {
   DCHECK(invoke_instruction->IsInvokeVirtual() || invoke_instruction->IsInvokeInterface())
       << invoke_instruction->DebugName();
 
@@ -1004,12 +1023,25 @@ bool HInliner::TryInlinePolymorphicCall(HInvoke* invoke_instruction,
   ClassLinker* class_linker = caller_compilation_unit_.GetClassLinker();
   PointerSize pointer_size = class_linker->GetImagePointerSize();
 
+  size_t total_receiver_count = 0u;
+  for (size_t i = 0; i < InlineCache::kIndividualCacheSize; ++i) {
+    total_receiver_count += receiver_counts[i];
+  }
+
   bool all_targets_inlined = true;
   bool one_target_inlined = false;
   for (size_t i = 0; i < InlineCache::kIndividualCacheSize; ++i) {
     if (classes->Get(i) == nullptr) {
       break;
     }
+    if (receiver_counts[i] * kRarePolymorphicTargetRatio < total_receiver_count) {
+      // Classes are sorted by frequency, so the remaining targets are rare too.
+      LOG_FAIL_NO_STAT() << "Polymorphic call to " << ArtMethod::PrettyMethod(resolved_method)
+                         << " has rare receiver " << classes->Get(i)->PrettyClass()
+                         << " and is not inlined for it";
+      all_targets_inlined = false;
+      break;
+    }
     ArtMethod* method = nullptr;
 
     Handle<mirror::Class> handle = handles_->NewHandle(classes->Get(i));
@@ -1257,7 +1289,8 @@ bool HInliner::TryInlinePolymorphicCallToSameTarget(
   bb_cursor->InsertInstructionAfter(class_table_get, receiver_class);
   bb_cursor->InsertInstructionAfter(compare, class_table_get);
 
-  if (outermost_graph_->IsCompilingOsr()) {
+  if (outermost_graph_->IsCompilingOsr() ||
+      !outermost_graph_->CanSpeculate(DeoptimizationKind::kJitSameTarget)) {
     CreateDiamondPatternForPolymorphicInline(compare, return_replacement, invoke_instruction);
   } else {
     HDeoptimize* deoptimize = new (graph_->GetAllocator()) HDeoptimize(
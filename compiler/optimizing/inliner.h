@@ -129,10 +129,13 @@ class HInliner : public HOptimization {
   // Try getting the inline cache from JIT code cache.
   // Return true if the inline cache was successfully allocated and the
   // invoke info was found in the profile info.
+  // The classes are sorted by decreasing frequency, and their approximate receiver
+  // counts are stored in `receiver_counts`.
   InlineCacheType GetInlineCacheJIT(
       HInvoke* invoke_instruction,
       StackHandleScope<1>* hs,
-      /*out*/Handle<mirror::ObjectArray<mirror::Class>>* inline_cache)
+      /*out*/Handle<mirror::ObjectArray<mirror::Class>>* inline_cache,
+      /*out*/uint16_t* receiver_counts)
     REQUIRES_SHARED(Locks::mutator_lock_);
 
   // Try getting the inline cache from AOT offline profile.
@@ -167,10 +170,13 @@ class HInliner : public HOptimization {
                                 Handle<mirror::ObjectArray<mirror::Class>> classes)
     REQUIRES_SHARED(Locks::mutator_lock_);
 
-  // Try to inline targets of a polymorphic call.
+  // Try to inline targets of a polymorphic call. Type guards are emitted in the
+  // order of `classes`. If `receiver_counts` holds any non-zero count, targets that
+  // are rarely seen are left to the original invoke.
   bool TryInlinePolymorphicCall(HInvoke* invoke_instruction,
                                 ArtMethod* resolved_method,
-                                Handle<mirror::ObjectArray<mirror::Class>> classes)
+                                Handle<mirror::ObjectArray<mirror::Class>> classes,
+                                const uint16_t* receiver_counts)
     REQUIRES_SHARED(Locks::mutator_lock_);
 
   bool TryInlinePolymorphicCallToSameTarget(HInvoke* invoke_instruction,
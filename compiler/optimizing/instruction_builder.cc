@@ -1050,19 +1050,126 @@ bool HInstructionBuilder::BuildInvoke(const Instruction& instruction,
   return HandleInvoke(invoke, operands, shorty, /* is_unresolved= */ false, clinit_check);
 }
 
+void HInstructionBuilder::MaybeSetVarHandleIntrinsic(HInvokePolymorphic* invoke,
+                                                     uint32_t method_idx) {
+  // Signature polymorphic methods do not go through HInvoke::SetResolvedMethod(), as the
+  // resolved method does not describe the call site. VarHandle accessors are still
+  // recognized, so that code generators can emit a fast path for the common cases and fall
+  // back to the runtime call otherwise.
+  ScopedObjectAccess soa(Thread::Current());
+  ArtMethod* resolved_method =
+      dex_compilation_unit_->GetClassLinker()->ResolveMethod<ClassLinker::ResolveMode::kNoChecks>(
+          method_idx,
+          dex_compilation_unit_->GetDexCache(),
+          dex_compilation_unit_->GetClassLoader(),
+          graph_->GetArtMethod(),
+          kVirtual);
+  if (resolved_method == nullptr) {
+    // Clean up any exception left by method resolution.
+    soa.Self()->ClearException();
+    return;
+  }
+  invoke->SetIntrinsicFromAccessor(resolved_method);
+}
+
+bool HInstructionBuilder::TryBuildInvokeOfConstantMethodHandle(
+    uint32_t dex_pc,
+    uint32_t method_idx,
+    dex::ProtoIndex proto_idx,
+    const InstructionOperands& operands) {
+  const dex::MethodId& accessor_id = dex_file_->GetMethodId(method_idx);
+  if (strcmp(dex_file_->GetMethodDeclaringClassDescriptor(accessor_id),
+             "Ljava/lang/invoke/MethodHandle;") != 0) {
+    return false;
+  }
+  const char* accessor_name = dex_file_->GetMethodName(accessor_id);
+  if (strcmp(accessor_name, "invokeExact") != 0 && strcmp(accessor_name, "invoke") != 0) {
+    return false;
+  }
+
+  HInstruction* handle = LoadLocal(operands.GetOperand(0), DataType::Type::kReference);
+  if (!handle->IsLoadMethodHandle() ||
+      !IsSameDexFile(handle->AsLoadMethodHandle()->GetDexFile(), *dex_file_)) {
+    return false;
+  }
+  const dex::MethodHandleItem& handle_item =
+      dex_file_->GetMethodHandle(handle->AsLoadMethodHandle()->GetMethodHandleIndex());
+  if (static_cast<DexFile::MethodHandleType>(handle_item.method_handle_type_) !=
+          DexFile::MethodHandleType::kInvokeStatic) {
+    return false;
+  }
+  // Protos are unique in a dex file, so this checks that the call site type is exactly the
+  // type of the handle. Then neither invoke() nor invokeExact() adapts the arguments or throws
+  // WrongMethodTypeException, and the call is equivalent to an invoke-static of the target.
+  uint16_t target_method_idx = handle_item.field_or_method_idx_;
+  if (dex_file_->GetMethodId(target_method_idx).proto_idx_ != proto_idx) {
+    return false;
+  }
+
+  InvokeType invoke_type = kStatic;
+  MethodReference target_method(nullptr, 0u);
+  bool is_string_constructor = false;
+  ArtMethod* resolved_method = ResolveMethod(target_method_idx,
+                                             graph_->GetArtMethod(),
+                                             *dex_compilation_unit_,
+                                             &invoke_type,
+                                             &target_method,
+                                             &is_string_constructor);
+  if (resolved_method == nullptr) {
+    // Let the runtime resolve the handle and report any error.
+    return false;
+  }
+  DCHECK_EQ(invoke_type, kStatic);
+
+  HInvokeStaticOrDirect::ClinitCheckRequirement clinit_check_requirement =
+      HInvokeStaticOrDirect::ClinitCheckRequirement::kNone;
+  HClinitCheck* clinit_check =
+      ProcessClinitCheckForInvoke(dex_pc, resolved_method, &clinit_check_requirement);
+
+  // The instruction at `dex_pc` is not an invoke-static, so the call must not go through
+  // the resolution trampoline, which decodes it to find the callee. The call is still a
+  // candidate for inlining, which is what makes this worthwhile.
+  HInvokeStaticOrDirect::DispatchInfo dispatch_info = {
+      HInvokeStaticOrDirect::MethodLoadKind::kRuntimeCall,
+      HInvokeStaticOrDirect::CodePtrLocation::kCallArtMethod,
+      /* method_load_data= */ 0u
+  };
+  const char* shorty = dex_file_->GetShorty(proto_idx);
+  HInvoke* invoke = new (allocator_) HInvokeStaticOrDirect(allocator_,
+                                                           strlen(shorty) - 1u,
+                                                           DataType::FromShorty(shorty[0]),
+                                                           dex_pc,
+                                                           target_method_idx,
+                                                           resolved_method,
+                                                           dispatch_info,
+                                                           kStatic,
+                                                           target_method,
+                                                           clinit_check_requirement);
+  MaybeRecordStat(compilation_stats_, MethodCompilationStat::kReplacedConstantMethodHandleInvoke);
+  // The handle itself stays in the graph; loading it can still throw.
+  NoReceiverInstructionOperands target_operands(&operands);
+  return HandleInvoke(invoke, target_operands, shorty, /* is_unresolved= */ false, clinit_check);
+}
+
 bool HInstructionBuilder::BuildInvokePolymorphic(uint32_t dex_pc,
                                                  uint32_t method_idx,
                                                  dex::ProtoIndex proto_idx,
                                                  const InstructionOperands& operands) {
   const char* shorty = dex_file_->GetShorty(proto_idx);
   DCHECK_EQ(1 + ArtMethod::NumArgRegisters(shorty), operands.GetNumberOfOperands());
+  if (TryBuildInvokeOfConstantMethodHandle(dex_pc, method_idx, proto_idx, operands)) {
+    return true;
+  }
   DataType::Type return_type = DataType::FromShorty(shorty[0]);
   size_t number_of_arguments = strlen(shorty);
-  HInvoke* invoke = new (allocator_) HInvokePolymorphic(allocator_,
-                                                        number_of_arguments,
-                                                        return_type,
-                                                        dex_pc,
-                                                        method_idx);
+  HInvokePolymorphic* invoke = new (allocator_) HInvokePolymorphic(allocator_,
+                                                                   number_of_arguments,
+                                                                   return_type,
+                                                                   dex_pc,
+                                                                   method_idx,
+                                                                   *dex_file_,
+                                                                   proto_idx);
+  MaybeSetVarHandleIntrinsic(invoke, method_idx);
   return HandleInvoke(invoke, operands, shorty, /* is_unresolved= */ false);
 }
 
@@ -164,6 +164,16 @@ class HInstructionBuilder : public ValueObject {
                    uint32_t method_idx,
                    const InstructionOperands& operands);
 
+  // Try to build a direct call for MethodHandle.invoke() or invokeExact() on a handle to
+  // a static method loaded by const-method-handle, when the call site type matches exactly.
+  bool TryBuildInvokeOfConstantMethodHandle(uint32_t dex_pc,
+                                            uint32_t method_idx,
+                                            dex::ProtoIndex proto_idx,
+                                            const InstructionOperands& operands);
+
+  // Recognize calls to VarHandle accessors, which are signature polymorphic.
+  void MaybeSetVarHandleIntrinsic(HInvokePolymorphic* invoke, uint32_t method_idx);
+
   // Builds an invocation node for invoke-polymorphic and returns whether the
   // instruction is supported.
   bool BuildInvokePolymorphic(uint32_t dex_pc,
@@ -2644,9 +2644,11 @@ static bool TryReplaceStringBuilderAppend(HInvoke* invoke) {
           break;
         }
         case Intrinsics::kStringBuilderAppendFloat:
+          arg = StringBuilderAppend::Argument::kFloat;
+          break;
         case Intrinsics::kStringBuilderAppendDouble:
-          // TODO: Unimplemented, needs to call FloatingDecimal.getBinaryToASCIIConverter().
-          return false;
+          arg = StringBuilderAppend::Argument::kDouble;
+          break;
         default: {
           return false;
         }
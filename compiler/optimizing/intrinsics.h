@@ -139,6 +139,14 @@ class IntrinsicVisitor : public ValueObject {
   static IntegerValueOfInfo ComputeIntegerValueOfInfo(
       HInvoke* invoke, const CompilerOptions& compiler_options);
 
+  // Create the locations for Reference.getReferent() if the intrinsic can be used, i.e. if the
+  // compiled code can reference the java.lang.ref.Reference class in the boot image.
+  static void CreateReferenceGetReferentLocations(HInvoke* invoke, CodeGenerator* codegen);
+
+  // Offsets of the static fields java.lang.ref.Reference.{disableIntrinsic,slowPathEnabled}.
+  static MemberOffset GetReferenceDisableIntrinsicOffset();
+  static MemberOffset GetReferenceSlowPathEnabledOffset();
+
  protected:
   IntrinsicVisitor() {}
 
@@ -292,38 +300,7 @@ UNREACHABLE_INTRINSIC(Arch, VarHandleReleaseFence)              \
 UNREACHABLE_INTRINSIC(Arch, VarHandleLoadLoadFence)             \
 UNREACHABLE_INTRINSIC(Arch, VarHandleStoreStoreFence)           \
 UNREACHABLE_INTRINSIC(Arch, MethodHandleInvokeExact)            \
-UNREACHABLE_INTRINSIC(Arch, MethodHandleInvoke)                 \
-UNREACHABLE_INTRINSIC(Arch, VarHandleCompareAndExchange)        \
-UNREACHABLE_INTRINSIC(Arch, VarHandleCompareAndExchangeAcquire) \
-UNREACHABLE_INTRINSIC(Arch, VarHandleCompareAndExchangeRelease) \
-UNREACHABLE_INTRINSIC(Arch, VarHandleCompareAndSet)             \
-UNREACHABLE_INTRINSIC(Arch, VarHandleGet)                       \
-UNREACHABLE_INTRINSIC(Arch, VarHandleGetAcquire)                \
-UNREACHABLE_INTRINSIC(Arch, VarHandleGetAndAdd)                 \
-UNREACHABLE_INTRINSIC(Arch, VarHandleGetAndAddAcquire)          \
-UNREACHABLE_INTRINSIC(Arch, VarHandleGetAndAddRelease)          \
-UNREACHABLE_INTRINSIC(Arch, VarHandleGetAndBitwiseAnd)          \
-UNREACHABLE_INTRINSIC(Arch, VarHandleGetAndBitwiseAndAcquire)   \
-UNREACHABLE_INTRINSIC(Arch, VarHandleGetAndBitwiseAndRelease)   \
-UNREACHABLE_INTRINSIC(Arch, VarHandleGetAndBitwiseOr)           \
-UNREACHABLE_INTRINSIC(Arch, VarHandleGetAndBitwiseOrAcquire)    \
-UNREACHABLE_INTRINSIC(Arch, VarHandleGetAndBitwiseOrRelease)    \
-UNREACHABLE_INTRINSIC(Arch, VarHandleGetAndBitwiseXor)          \
-UNREACHABLE_INTRINSIC(Arch, VarHandleGetAndBitwiseXorAcquire)   \
-UNREACHABLE_INTRINSIC(Arch, VarHandleGetAndBitwiseXorRelease)   \
-UNREACHABLE_INTRINSIC(Arch, VarHandleGetAndSet)                 \
-UNREACHABLE_INTRINSIC(Arch, VarHandleGetAndSetAcquire)          \
-UNREACHABLE_INTRINSIC(Arch, VarHandleGetAndSetRelease)          \
-UNREACHABLE_INTRINSIC(Arch, VarHandleGetOpaque)                 \
-UNREACHABLE_INTRINSIC(Arch, VarHandleGetVolatile)               \
-UNREACHABLE_INTRINSIC(Arch, VarHandleSet)                       \
-UNREACHABLE_INTRINSIC(Arch, VarHandleSetOpaque)                 \
-UNREACHABLE_INTRINSIC(Arch, VarHandleSetRelease)                \
-UNREACHABLE_INTRINSIC(Arch, VarHandleSetVolatile)               \
-UNREACHABLE_INTRINSIC(Arch, VarHandleWeakCompareAndSet)         \
-UNREACHABLE_INTRINSIC(Arch, VarHandleWeakCompareAndSetAcquire)  \
-UNREACHABLE_INTRINSIC(Arch, VarHandleWeakCompareAndSetPlain)    \
-UNREACHABLE_INTRINSIC(Arch, VarHandleWeakCompareAndSetRelease)
+UNREACHABLE_INTRINSIC(Arch, MethodHandleInvoke)
 
 template <typename IntrinsicLocationsBuilder, typename Codegenerator>
 bool IsCallFreeIntrinsic(HInvoke* invoke, Codegenerator* codegen) {
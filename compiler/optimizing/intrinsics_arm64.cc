@@ -17,17 +17,20 @@
 #include "intrinsics_arm64.h"
 
 #include "arch/arm64/instruction_set_features_arm64.h"
+#include "art_field.h"
 #include "art_method.h"
 #include "code_generator_arm64.h"
 #include "common_arm64.h"
 #include "entrypoints/quick/quick_entrypoints.h"
 #include "heap_poisoning.h"
 #include "intrinsics.h"
+#include "intrinsics_utils.h"
 #include "lock_word.h"
 #include "mirror/array-inl.h"
 #include "mirror/object_array-inl.h"
 #include "mirror/reference.h"
 #include "mirror/string-inl.h"
+#include "mirror/var_handle.h"
 #include "scoped_thread_state_change-inl.h"
 #include "thread-current-inl.h"
 #include "utils/arm64/assembler_arm64.h"
@@ -128,6 +131,8 @@ class IntrinsicSlowPathARM64 : public SlowPathCodeARM64 {
       if (invoke_->IsInvokeStaticOrDirect()) {
         codegen->GenerateStaticOrDirectCall(
             invoke_->AsInvokeStaticOrDirect(), LocationFrom(kArtMethodRegister), this);
+      } else if (invoke_->IsInvokePolymorphic()) {
+        codegen->GenerateInvokePolymorphicCall(invoke_->AsInvokePolymorphic(), this);
       } else {
         codegen->GenerateVirtualCall(
             invoke_->AsInvokeVirtual(), LocationFrom(kArtMethodRegister), this);
@@ -1174,6 +1179,132 @@ void IntrinsicCodeGeneratorARM64::VisitUnsafeCASObject(HInvoke* invoke) {
   GenCas(invoke, DataType::Type::kReference, codegen_);
 }
 
+enum class UnsafeUpdateOp {
+  kAdd,
+  kSet,
+};
+
+static void CreateUnsafeGetAndUpdateLocations(ArenaAllocator* allocator,
+                                              HInvoke* invoke,
+                                              UnsafeUpdateOp op,
+                                              bool use_lse) {
+  LocationSummary* locations =
+      new (allocator) LocationSummary(invoke, LocationSummary::kNoCall, kIntrinsified);
+  locations->SetInAt(0, Location::NoLocation());        // Unused receiver.
+  locations->SetInAt(1, Location::RequiresRegister());
+  locations->SetInAt(2, Location::RequiresRegister());
+  locations->SetInAt(3, Location::RequiresRegister());
+  // The old value is loaded while the inputs are still needed.
+  locations->SetOut(Location::RequiresRegister(), Location::kOutputOverlap);
+  if (op == UnsafeUpdateOp::kAdd && !use_lse) {
+    // The new value for the store-exclusive, as both scratch registers are taken.
+    locations->AddTemp(Location::RequiresRegister());
+  }
+}
+
+static void GenUnsafeGetAndUpdate(HInvoke* invoke,
+                                  DataType::Type type,
+                                  UnsafeUpdateOp op,
+                                  CodeGeneratorARM64* codegen) {
+  Arm64Assembler* assembler = codegen->GetAssembler();
+  MacroAssembler* masm = assembler->GetVIXLAssembler();
+  LocationSummary* locations = invoke->GetLocations();
+
+  Register out = RegisterFrom(locations->Out(), type);            // Old value.
+  Register base = WRegisterFrom(locations->InAt(1));              // Object pointer.
+  Register offset = XRegisterFrom(locations->InAt(2));            // Long offset.
+  Register value = RegisterFrom(locations->InAt(3), type);        // Delta or new value.
+
+  // This needs to be before the temp registers, as MarkGCCard also uses VIXL temps.
+  if (type == DataType::Type::kReference) {
+    DCHECK(op == UnsafeUpdateOp::kSet);
+    bool value_can_be_null = true;  // TODO: Worth finding out this information?
+    codegen->MarkGCCard(base, value, value_can_be_null);
+  }
+
+  UseScratchRegisterScope temps(masm);
+  Register tmp_ptr = temps.AcquireX();                             // Pointer to actual memory.
+  __ Add(tmp_ptr, base.X(), Operand(offset));
+  if (type == DataType::Type::kReference) {
+    // Poison after computing `tmp_ptr`, as `value` may be the same register as `base`.
+    assembler->MaybePoisonHeapReference(value);
+  }
+
+  if (codegen->GetInstructionSetFeatures().HasLSE()) {
+    // The acquire-release forms give the same ordering as the LDAXR/STLXR loop below.
+    if (op == UnsafeUpdateOp::kAdd) {
+      __ Ldaddal(value, out, MemOperand(tmp_ptr));
+    } else {
+      __ Swpal(value, out, MemOperand(tmp_ptr));
+    }
+  } else {
+    // do {
+    //   out = [tmp_ptr];
+    // } while (failure([tmp_ptr] <- op(out, value)));
+    Register status = temps.AcquireW();
+    Register new_value = value;
+    if (op == UnsafeUpdateOp::kAdd) {
+      new_value = RegisterFrom(locations->GetTemp(0), type);
+    }
+    vixl::aarch64::Label loop_head;
+    __ Bind(&loop_head);
+    __ Ldaxr(out, MemOperand(tmp_ptr));
+    if (op == UnsafeUpdateOp::kAdd) {
+      __ Add(new_value, out, value);
+    }
+    __ Stlxr(status, new_value, MemOperand(tmp_ptr));
+    __ Cbnz(status, &loop_head);
+  }
+
+  if (type == DataType::Type::kReference) {
+    assembler->MaybeUnpoisonHeapReference(value);
+    assembler->MaybeUnpoisonHeapReference(out);
+  }
+}
+
+void IntrinsicLocationsBuilderARM64::VisitUnsafeGetAndAddInt(HInvoke* invoke) {
+  CreateUnsafeGetAndUpdateLocations(
+      allocator_, invoke, UnsafeUpdateOp::kAdd, codegen_->GetInstructionSetFeatures().HasLSE());
+}
+void IntrinsicLocationsBuilderARM64::VisitUnsafeGetAndAddLong(HInvoke* invoke) {
+  CreateUnsafeGetAndUpdateLocations(
+      allocator_, invoke, UnsafeUpdateOp::kAdd, codegen_->GetInstructionSetFeatures().HasLSE());
+}
+void IntrinsicLocationsBuilderARM64::VisitUnsafeGetAndSetInt(HInvoke* invoke) {
+  CreateUnsafeGetAndUpdateLocations(
+      allocator_, invoke, UnsafeUpdateOp::kSet, codegen_->GetInstructionSetFeatures().HasLSE());
+}
+void IntrinsicLocationsBuilderARM64::VisitUnsafeGetAndSetLong(HInvoke* invoke) {
+  CreateUnsafeGetAndUpdateLocations(
+      allocator_, invoke, UnsafeUpdateOp::kSet, codegen_->GetInstructionSetFeatures().HasLSE());
+}
+void IntrinsicLocationsBuilderARM64::VisitUnsafeGetAndSetObject(HInvoke* invoke) {
+  // The old reference would need a read barrier, which is not implemented here.
+  if (kEmitCompilerReadBarrier) {
+    return;
+  }
+
+  CreateUnsafeGetAndUpdateLocations(
+      allocator_, invoke, UnsafeUpdateOp::kSet, codegen_->GetInstructionSetFeatures().HasLSE());
+}
+
+void IntrinsicCodeGeneratorARM64::VisitUnsafeGetAndAddInt(HInvoke* invoke) {
+  GenUnsafeGetAndUpdate(invoke, DataType::Type::kInt32, UnsafeUpdateOp::kAdd, codegen_);
+}
+void IntrinsicCodeGeneratorARM64::VisitUnsafeGetAndAddLong(HInvoke* invoke) {
+  GenUnsafeGetAndUpdate(invoke, DataType::Type::kInt64, UnsafeUpdateOp::kAdd, codegen_);
+}
+void IntrinsicCodeGeneratorARM64::VisitUnsafeGetAndSetInt(HInvoke* invoke) {
+  GenUnsafeGetAndUpdate(invoke, DataType::Type::kInt32, UnsafeUpdateOp::kSet, codegen_);
+}
+void IntrinsicCodeGeneratorARM64::VisitUnsafeGetAndSetLong(HInvoke* invoke) {
+  GenUnsafeGetAndUpdate(invoke, DataType::Type::kInt64, UnsafeUpdateOp::kSet, codegen_);
+}
+void IntrinsicCodeGeneratorARM64::VisitUnsafeGetAndSetObject(HInvoke* invoke) {
+  DCHECK(!kEmitCompilerReadBarrier);
+  GenUnsafeGetAndUpdate(invoke, DataType::Type::kReference, UnsafeUpdateOp::kSet, codegen_);
+}
+
 void IntrinsicLocationsBuilderARM64::VisitStringCompareTo(HInvoke* invoke) {
   LocationSummary* locations =
       new (allocator_) LocationSummary(invoke,
@@ -1190,6 +1321,10 @@ void IntrinsicLocationsBuilderARM64::VisitStringCompareTo(HInvoke* invoke) {
   if (mirror::kUseStringCompression) {
     locations->AddTemp(Location::RequiresRegister());
   }
+  // Temporaries for the loop comparing 16 bytes at a time.
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
   locations->SetOut(Location::RequiresRegister(), Location::kOutputOverlap);
 }
 
@@ -1210,8 +1345,14 @@ void IntrinsicCodeGeneratorARM64::VisitStringCompareTo(HInvoke* invoke) {
   if (mirror::kUseStringCompression) {
     temp3 = WRegisterFrom(locations->GetTemp(3));
   }
+  const size_t loop_temps_start = mirror::kUseStringCompression ? 4u : 3u;
+  Register arg_data = XRegisterFrom(locations->GetTemp(loop_temps_start));
+  Register temp5 = XRegisterFrom(locations->GetTemp(loop_temps_start + 1u));
+  Register temp6 = XRegisterFrom(locations->GetTemp(loop_temps_start + 2u));
 
   vixl::aarch64::Label loop;
+  vixl::aarch64::Label last_word;
+  vixl::aarch64::Label second_word_diff;
   vixl::aarch64::Label find_char_diff;
   vixl::aarch64::Label end;
   vixl::aarch64::Label different_compression;
@@ -1263,8 +1404,9 @@ void IntrinsicCodeGeneratorARM64::VisitStringCompareTo(HInvoke* invoke) {
     __ Ands(temp3.W(), temp3.W(), Operand(1));
     __ Tbnz(temp2, 0, &different_compression);  // Does not use flags.
   }
-  // Store offset of string value in preparation for comparison loop.
-  __ Mov(temp1, value_offset);
+  // Point to the string values in preparation for comparison loop.
+  __ Add(temp1.X(), str.X(), value_offset);
+  __ Add(arg_data, arg.X(), value_offset);
   if (mirror::kUseStringCompression) {
     // For string compression, calculate the number of bytes to compare (not chars).
     // This could in theory exceed INT32_MAX, so treat temp0 as unsigned.
@@ -1281,23 +1423,41 @@ void IntrinsicCodeGeneratorARM64::VisitStringCompareTo(HInvoke* invoke) {
   const size_t char_size = DataType::Size(DataType::Type::kUint16);
   DCHECK_EQ(char_size, 2u);
 
-  // Promote temp2 to an X reg, ready for LDR.
+  // Promote temp1 and temp2 to X regs, ready for LDR and EOR.
+  temp1 = temp1.X();
   temp2 = temp2.X();
 
-  // Loop to compare 4x16-bit characters at a time (ok because of string data alignment).
+  // With string compression, `temp0` counts bytes, otherwise chars.
+  const uint32_t units_per_word = mirror::kUseStringCompression ? 8u : 4u;
+
+  // Loop to compare 2x8 bytes at a time (ok because of string data alignment). The last
+  // 8 bytes, if any, are compared separately as the data is only padded to 8 bytes.
+  __ Cmp(temp0, units_per_word);
+  __ B(ls, &last_word);
   __ Bind(&loop);
-  __ Ldr(temp4, MemOperand(str.X(), temp1.X()));
-  __ Ldr(temp2, MemOperand(arg.X(), temp1.X()));
+  __ Ldp(temp4, temp5, MemOperand(temp1, 2u * sizeof(uint64_t), PostIndex));
+  __ Ldp(temp2, temp6, MemOperand(arg_data, 2u * sizeof(uint64_t), PostIndex));
+  __ Cmp(temp4, temp2);
+  __ B(ne, &find_char_diff);
+  __ Cmp(temp5, temp6);
+  __ B(ne, &second_word_diff);
+  __ Subs(temp0, temp0, 2u * units_per_word);
+  __ B(ls, &end);
+  __ Cmp(temp0, units_per_word);
+  __ B(hi, &loop);
+
+  __ Bind(&last_word);
+  __ Ldr(temp4, MemOperand(temp1));
+  __ Ldr(temp2, MemOperand(arg_data));
   __ Cmp(temp4, temp2);
   __ B(ne, &find_char_diff);
-  __ Add(temp1, temp1, char_size * 4);
-  // With string compression, we have compared 8 bytes, otherwise 4 chars.
-  __ Subs(temp0, temp0, (mirror::kUseStringCompression) ? 8 : 4);
-  __ B(&loop, hi);
   __ B(&end);
 
-  // Promote temp1 to an X reg, ready for EOR.
-  temp1 = temp1.X();
+  // The difference is in the second word loaded by the loop.
+  __ Bind(&second_word_diff);
+  __ Mov(temp4, temp5);
+  __ Mov(temp2, temp6);
+  __ Sub(temp0, temp0, units_per_word);
 
   // Find the single character difference.
   __ Bind(&find_char_diff);
@@ -1426,6 +1586,14 @@ void IntrinsicLocationsBuilderARM64::VisitStringEquals(HInvoke* invoke) {
   if (const_string == nullptr || const_string_length > (is_compressed ? 8u : 4u)) {
     locations->AddTemp(Location::RequiresRegister());
   }
+  // The generic loop compares 16 bytes at a time and needs three more temporaries.
+  if (const_string == nullptr ||
+      const_string_length > (is_compressed ? kShortConstStringEqualsCutoffInBytes
+                                           : kShortConstStringEqualsCutoffInBytes / 2u)) {
+    locations->AddTemp(Location::RequiresRegister());
+    locations->AddTemp(Location::RequiresRegister());
+    locations->AddTemp(Location::RequiresRegister());
+  }
 
   // TODO: If the String.equals() is used only for an immediately following HIf, we can
   // mark it as emitted-at-use-site and emit branches directly to the appropriate blocks.
@@ -1566,21 +1734,39 @@ void IntrinsicCodeGeneratorARM64::VisitStringEquals(HInvoke* invoke) {
       __ Lsl(temp, temp, temp1);          // Calculate number of bytes to compare.
     }
 
-    // Store offset of string value in preparation for comparison loop
-    __ Mov(temp1, value_offset);
-
     temp1 = temp1.X();
     Register temp2 = XRegisterFrom(locations->GetTemp(0));
-    // Loop to compare strings 8 bytes at a time starting at the front of the string.
+    Register arg_data = XRegisterFrom(locations->GetTemp(1));
+    Register temp3 = XRegisterFrom(locations->GetTemp(2));
+    Register temp4 = XRegisterFrom(locations->GetTemp(3));
+
+    // Point to the string values in preparation for comparison loop.
+    __ Add(temp1, str.X(), value_offset);
+    __ Add(arg_data, arg.X(), value_offset);
+
+    // With string compression, `temp` counts bytes, otherwise chars.
+    const uint32_t units_per_word = mirror::kUseStringCompression ? 8u : 4u;
+    vixl::aarch64::Label last_word;
+    // Loop to compare strings 16 bytes at a time starting at the front of the string.
+    // The last 8 bytes, if any, are compared separately as the data is only padded to 8 bytes.
+    __ Cmp(temp, units_per_word);
+    __ B(&last_word, ls);
     __ Bind(&loop);
-    __ Ldr(out, MemOperand(str.X(), temp1));
-    __ Ldr(temp2, MemOperand(arg.X(), temp1));
-    __ Add(temp1, temp1, Operand(sizeof(uint64_t)));
+    __ Ldp(out, temp3, MemOperand(temp1, 2u * sizeof(uint64_t), PostIndex));
+    __ Ldp(temp2, temp4, MemOperand(arg_data, 2u * sizeof(uint64_t), PostIndex));
     __ Cmp(out, temp2);
+    __ Ccmp(temp3, temp4, NoFlag, eq);
     __ B(&return_false, ne);
-    // With string compression, we have compared 8 bytes, otherwise 4 chars.
-    __ Sub(temp, temp, Operand(mirror::kUseStringCompression ? 8 : 4), SetFlags);
+    __ Sub(temp, temp, Operand(2u * units_per_word), SetFlags);
+    __ B(&return_true, ls);
+    __ Cmp(temp, units_per_word);
     __ B(&loop, hi);
+
+    __ Bind(&last_word);
+    __ Ldr(out, MemOperand(temp1));
+    __ Ldr(temp2, MemOperand(arg_data));
+    __ Cmp(out, temp2);
+    __ B(&return_false, ne);
   }
 
   // Return true and exit the function.
@@ -1595,6 +1781,110 @@ void IntrinsicCodeGeneratorARM64::VisitStringEquals(HInvoke* invoke) {
   __ Bind(&end);
 }
 
+static void CreateArraysEqualsLocations(ArenaAllocator* allocator, HInvoke* invoke) {
+  LocationSummary* locations =
+      new (allocator) LocationSummary(invoke, LocationSummary::kNoCall, kIntrinsified);
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetInAt(1, Location::RequiresRegister());
+  // Temporary registers for the data pointers.
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  // The output is also used for loading the data, so it must not overlap the inputs.
+  locations->SetOut(Location::RequiresRegister(), Location::kOutputOverlap);
+}
+
+static void GenArraysEquals(HInvoke* invoke, MacroAssembler* masm, DataType::Type type) {
+  LocationSummary* locations = invoke->GetLocations();
+
+  Register array = WRegisterFrom(locations->InAt(0));
+  Register arg = WRegisterFrom(locations->InAt(1));
+  Register array_data = XRegisterFrom(locations->GetTemp(0));
+  Register arg_data = XRegisterFrom(locations->GetTemp(1));
+  Register out = XRegisterFrom(locations->Out());
+
+  UseScratchRegisterScope scratch_scope(masm);
+  Register temp = scratch_scope.AcquireX();
+  Register temp1 = scratch_scope.AcquireX();
+
+  vixl::aarch64::Label loop;
+  vixl::aarch64::Label end;
+  vixl::aarch64::Label return_true;
+  vixl::aarch64::Label return_false;
+
+  const size_t component_size_shift = DataType::SizeShift(type);
+  const int32_t length_offset = mirror::Array::LengthOffset().Int32Value();
+  const int32_t data_offset = mirror::Array::DataOffset(DataType::Size(type)).Int32Value();
+
+  // Reference equality check, return true if same reference (including both null).
+  __ Cmp(array, arg);
+  __ B(&return_true, eq);
+
+  // Return false if either input is null.
+  __ Cbz(array, &return_false);
+  __ Cbz(arg, &return_false);
+
+  // Check if lengths are equal, return false if they're not.
+  __ Ldr(temp.W(), MemOperand(array.X(), length_offset));
+  __ Ldr(temp1.W(), MemOperand(arg.X(), length_offset));
+  __ Cmp(temp.W(), temp1.W());
+  __ B(&return_false, ne);
+  // Return true if both arrays are empty.
+  __ Cbz(temp.W(), &return_true);
+
+  // Calculate the number of bytes to compare. This can exceed 32 bits for long arrays.
+  if (component_size_shift != 0u) {
+    __ Lsl(temp, temp, component_size_shift);
+  }
+
+  // Point to the array data in preparation for comparison loop.
+  __ Add(array_data, array.X(), data_offset);
+  __ Add(arg_data, arg.X(), data_offset);
+
+  // The data is zero-padded to kObjectAlignment, so we can compare 8 bytes at a time from
+  // an 8-byte aligned offset. For data at a 4-byte aligned offset, compare 4 bytes first.
+  static_assert(IsAligned<8>(kObjectAlignment), "Array data is not zero padded");
+  if (!IsAligned<8>(data_offset)) {
+    DCHECK_ALIGNED(data_offset, 4);
+    __ Ldr(out.W(), MemOperand(array_data, sizeof(uint32_t), PostIndex));
+    __ Ldr(temp1.W(), MemOperand(arg_data, sizeof(uint32_t), PostIndex));
+    __ Cmp(out.W(), temp1.W());
+    __ B(&return_false, ne);
+    __ Subs(temp, temp, sizeof(uint32_t));
+    __ B(&return_true, ls);
+  }
+
+  // Loop to compare the arrays 8 bytes at a time.
+  __ Bind(&loop);
+  __ Ldr(out, MemOperand(array_data, sizeof(uint64_t), PostIndex));
+  __ Ldr(temp1, MemOperand(arg_data, sizeof(uint64_t), PostIndex));
+  __ Cmp(out, temp1);
+  __ B(&return_false, ne);
+  __ Subs(temp, temp, sizeof(uint64_t));
+  __ B(&loop, hi);
+
+  __ Bind(&return_true);
+  __ Mov(out, 1);
+  __ B(&end);
+
+  __ Bind(&return_false);
+  __ Mov(out, 0);
+  __ Bind(&end);
+}
+
+#define ARRAYS_EQUALS_INTRINSIC(Name, Type)                                      \
+  void IntrinsicLocationsBuilderARM64::VisitArraysEquals##Name(HInvoke* invoke) { \
+    CreateArraysEqualsLocations(allocator_, invoke);                             \
+  }                                                                              \
+  void IntrinsicCodeGeneratorARM64::VisitArraysEquals##Name(HInvoke* invoke) {   \
+    GenArraysEquals(invoke, GetVIXLAssembler(), DataType::Type::k##Type);        \
+  }
+ARRAYS_EQUALS_INTRINSIC(Byte, Int8)
+ARRAYS_EQUALS_INTRINSIC(Char, Uint16)
+ARRAYS_EQUALS_INTRINSIC(Short, Int16)
+ARRAYS_EQUALS_INTRINSIC(Int, Int32)
+ARRAYS_EQUALS_INTRINSIC(Long, Int64)
+#undef ARRAYS_EQUALS_INTRINSIC
+
 static void GenerateVisitStringIndexOf(HInvoke* invoke,
                                        MacroAssembler* masm,
                                        CodeGeneratorARM64* codegen,
@@ -2960,6 +3250,69 @@ void IntrinsicLocationsBuilderARM64::VisitReachabilityFence(HInvoke* invoke) {
 
 void IntrinsicCodeGeneratorARM64::VisitReachabilityFence(HInvoke* invoke ATTRIBUTE_UNUSED) { }
 
+void IntrinsicLocationsBuilderARM64::VisitReferenceGetReferent(HInvoke* invoke) {
+  IntrinsicVisitor::CreateReferenceGetReferentLocations(invoke, codegen_);
+
+  if (kEmitCompilerReadBarrier && kUseBakerReadBarrier && invoke->GetLocations() != nullptr) {
+    // The load-acquire with Baker read barrier needs a temporary for the field address.
+    invoke->GetLocations()->AddTemp(Location::RequiresRegister());
+  }
+}
+
+void IntrinsicCodeGeneratorARM64::VisitReferenceGetReferent(HInvoke* invoke) {
+  MacroAssembler* masm = GetVIXLAssembler();
+  LocationSummary* locations = invoke->GetLocations();
+
+  Location obj = locations->InAt(0);
+  Location out = locations->Out();
+
+  SlowPathCodeARM64* slow_path =
+      new (codegen_->GetScopedAllocator()) IntrinsicSlowPathARM64(invoke);
+  codegen_->AddSlowPath(slow_path);
+
+  if (kEmitCompilerReadBarrier) {
+    // Check self->GetWeakRefAccessEnabled(), see ReferenceProcessor::GetReferent().
+    UseScratchRegisterScope temps(masm);
+    Register temp = temps.AcquireW();
+    __ Ldr(temp,
+           MemOperand(tr, Thread::WeakRefAccessEnabledOffset<kArm64PointerSize>().Int32Value()));
+    __ Cbz(temp, slow_path->GetEntryLabel());
+  }
+
+  {
+    // Load the java.lang.ref.Reference class. It is in the boot image and non-movable.
+    UseScratchRegisterScope temps(masm);
+    Register temp = temps.AcquireW();
+    codegen_->LoadIntrinsicDeclaringClass(temp, invoke);
+
+    // Check the static fields java.lang.ref.Reference.{disableIntrinsic,slowPathEnabled}
+    // together with a single 16-bit load.
+    MemberOffset disable_intrinsic_offset = IntrinsicVisitor::GetReferenceDisableIntrinsicOffset();
+    DCHECK_ALIGNED(disable_intrinsic_offset.Uint32Value(), 2u);
+    DCHECK_EQ(disable_intrinsic_offset.Uint32Value() + 1u,
+              IntrinsicVisitor::GetReferenceSlowPathEnabledOffset().Uint32Value());
+    __ Ldrh(temp, HeapOperand(temp, disable_intrinsic_offset.Uint32Value()));
+    __ Cbnz(temp, slow_path->GetEntryLabel());
+  }
+
+  // Load the `referent` field which is volatile.
+  uint32_t referent_offset = mirror::Reference::ReferentOffset().Uint32Value();
+  if (kEmitCompilerReadBarrier && kUseBakerReadBarrier) {
+    codegen_->GenerateFieldLoadWithBakerReadBarrier(invoke,
+                                                    out,
+                                                    WRegisterFrom(obj),
+                                                    referent_offset,
+                                                    /* maybe_temp= */ locations->GetTemp(0),
+                                                    /* needs_null_check= */ false,
+                                                    /* use_load_acquire= */ true);
+  } else {
+    MemOperand field = HeapOperand(WRegisterFrom(obj), referent_offset);
+    codegen_->LoadAcquire(invoke, WRegisterFrom(out), field, /* needs_null_check= */ false);
+    codegen_->MaybeGenerateReadBarrierSlow(invoke, out, out, obj, referent_offset);
+  }
+  __ Bind(slow_path->GetExitLabel());
+}
+
 void IntrinsicLocationsBuilderARM64::VisitCRC32Update(HInvoke* invoke) {
   if (!codegen_->GetInstructionSetFeatures().HasCRC()) {
     return;
@@ -3205,6 +3558,219 @@ void IntrinsicCodeGeneratorARM64::VisitCRC32UpdateByteBuffer(HInvoke* invoke) {
   GenerateCodeForCalculationCRC32ValueOfBytes(masm, crc, ptr, length, out);
 }
 
+// The modulus and the maximum number of bytes which can be processed before reducing
+// the Adler-32 sums without overflowing 32 bits, as defined by zlib.
+static constexpr uint32_t kAdler32Base = 65521u;
+static constexpr uint32_t kAdler32NMax = 5552u;
+
+void IntrinsicLocationsBuilderARM64::VisitAdler32Update(HInvoke* invoke) {
+  LocationSummary* locations = new (allocator_) LocationSummary(invoke,
+                                                                LocationSummary::kNoCall,
+                                                                kIntrinsified);
+
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetInAt(1, Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->SetOut(Location::RequiresRegister(), Location::kOutputOverlap);
+}
+
+// Lower the invoke of Adler32.update(int adler, int b).
+void IntrinsicCodeGeneratorARM64::VisitAdler32Update(HInvoke* invoke) {
+  MacroAssembler* masm = GetVIXLAssembler();
+
+  Register adler = InputRegisterAt(invoke, 0);
+  Register val = InputRegisterAt(invoke, 1);
+  Register out = OutputRegister(invoke);
+
+  // The algorithm of Adler-32 of a byte is:
+  //   a = (adler & 0xffff) + (b & 0xff), reduced modulo kAdler32Base
+  //   b = (adler >>> 16) + a, reduced modulo kAdler32Base
+  //   result = (b << 16) | a
+  // Both sums are below 2 * kAdler32Base, so a conditional subtraction reduces them.
+
+  // The modulus is not encodable as an immediate, keep it in a register.
+  Register base = WRegisterFrom(invoke->GetLocations()->GetTemp(0));
+  UseScratchRegisterScope temps(masm);
+  Register a = temps.AcquireW();
+  Register tmp = temps.AcquireW();
+
+  __ Mov(base, kAdler32Base);
+  __ And(a, adler, 0xffff);
+  __ Uxtb(tmp, val);
+  __ Add(a, a, tmp);
+  __ Sub(tmp, a, base);
+  __ Cmp(a, base);
+  __ Csel(a, tmp, a, hs);
+
+  __ Add(out, a, Operand(adler, LSR, 16));
+  __ Sub(tmp, out, base);
+  __ Cmp(out, base);
+  __ Csel(out, tmp, out, hs);
+
+  __ Orr(out, a, Operand(out, LSL, 16));
+}
+
+// Generate code which calculates an Adler-32 value of bytes.
+//
+// Parameters:
+//   masm      - VIXL macro assembler
+//   adler     - a register holding an initial Adler-32 value
+//   ptr       - a register holding a memory address of bytes, clobbered
+//   length    - a register holding a number of bytes to process
+//   remaining - a temporary register
+//   chunk     - a temporary register
+//   out       - a register to put a result of calculation, must not overlap the inputs
+static void GenerateCodeForCalculationAdler32ValueOfBytes(MacroAssembler* masm,
+                                                          const Register& adler,
+                                                          const Register& ptr,
+                                                          const Register& length,
+                                                          const Register& remaining,
+                                                          const Register& chunk,
+                                                          const Register& out) {
+  // The algorithm of Adler-32 of bytes is:
+  //   a = adler & 0xffff
+  //   b = adler >>> 16
+  //   while array has bytes do:
+  //     for up to kAdler32NMax bytes do:
+  //       a += byte
+  //       b += a
+  //     a %= kAdler32Base
+  //     b %= kAdler32Base
+  //   result = (b << 16) | a
+  // The `b` sum is accumulated in `out`.
+
+  vixl::aarch64::Label outer_loop, inner_loop, done;
+
+  // Use VIXL scratch registers as the VIXL macro assembler won't use them in
+  // instructions below.
+  UseScratchRegisterScope temps(masm);
+  Register a = temps.AcquireW();
+  Register array_elem = temps.AcquireW();
+
+  __ And(a, adler, 0xffff);
+  __ Lsr(out, adler, 16);
+  __ Mov(remaining, length);
+  __ Cbz(remaining, &done);
+
+  __ Bind(&outer_loop);
+  __ Mov(chunk, kAdler32NMax);
+  __ Cmp(remaining, chunk);
+  __ Csel(chunk, remaining, chunk, lo);
+  __ Sub(remaining, remaining, chunk);
+
+  __ Bind(&inner_loop);
+  __ Ldrb(array_elem, MemOperand(ptr, 1, PostIndex));
+  __ Subs(chunk, chunk, 1);
+  __ Add(a, a, array_elem);
+  __ Add(out, out, a);
+  __ B(&inner_loop, ne);
+
+  // Reduce both sums modulo kAdler32Base, reusing `chunk` which is now zero.
+  __ Mov(chunk, kAdler32Base);
+  __ Udiv(array_elem, a, chunk);
+  __ Msub(a, array_elem, chunk, a);
+  __ Udiv(array_elem, out, chunk);
+  __ Msub(out, array_elem, chunk, out);
+  __ Cbnz(remaining, &outer_loop);
+
+  __ Bind(&done);
+  __ Orr(out, a, Operand(out, LSL, 16));
+}
+
+// The threshold for sizes of arrays to use the library provided implementation
+// of Adler32.updateBytes instead of the intrinsic.
+static constexpr int32_t kAdler32UpdateBytesThreshold = 64 * 1024;
+
+void IntrinsicLocationsBuilderARM64::VisitAdler32UpdateBytes(HInvoke* invoke) {
+  LocationSummary* locations =
+      new (allocator_) LocationSummary(invoke,
+                                       LocationSummary::kCallOnSlowPath,
+                                       kIntrinsified);
+
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetInAt(1, Location::RequiresRegister());
+  locations->SetInAt(2, Location::RegisterOrConstant(invoke->InputAt(2)));
+  locations->SetInAt(3, Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->SetOut(Location::RequiresRegister(), Location::kOutputOverlap);
+}
+
+// Lower the invoke of Adler32.updateBytes(int adler, byte[] b, int off, int len)
+//
+// Note: The intrinsic is not used if len exceeds a threshold.
+void IntrinsicCodeGeneratorARM64::VisitAdler32UpdateBytes(HInvoke* invoke) {
+  MacroAssembler* masm = GetVIXLAssembler();
+  LocationSummary* locations = invoke->GetLocations();
+
+  SlowPathCodeARM64* slow_path =
+    new (codegen_->GetScopedAllocator()) IntrinsicSlowPathARM64(invoke);
+  codegen_->AddSlowPath(slow_path);
+
+  Register length = WRegisterFrom(locations->InAt(3));
+  __ Cmp(length, kAdler32UpdateBytesThreshold);
+  __ B(slow_path->GetEntryLabel(), hi);
+
+  const uint32_t array_data_offset =
+      mirror::Array::DataOffset(Primitive::kPrimByte).Uint32Value();
+  Register ptr = XRegisterFrom(locations->GetTemp(0));
+  Register array = XRegisterFrom(locations->InAt(1));
+  Location offset = locations->InAt(2);
+  if (offset.IsConstant()) {
+    int32_t offset_value = offset.GetConstant()->AsIntConstant()->GetValue();
+    __ Add(ptr, array, array_data_offset + offset_value);
+  } else {
+    __ Add(ptr, array, array_data_offset);
+    __ Add(ptr, ptr, XRegisterFrom(offset));
+  }
+
+  Register adler = WRegisterFrom(locations->InAt(0));
+  Register remaining = WRegisterFrom(locations->GetTemp(1));
+  Register chunk = WRegisterFrom(locations->GetTemp(2));
+  Register out = WRegisterFrom(locations->Out());
+
+  GenerateCodeForCalculationAdler32ValueOfBytes(masm, adler, ptr, length, remaining, chunk, out);
+
+  __ Bind(slow_path->GetExitLabel());
+}
+
+void IntrinsicLocationsBuilderARM64::VisitAdler32UpdateByteBuffer(HInvoke* invoke) {
+  LocationSummary* locations =
+      new (allocator_) LocationSummary(invoke,
+                                       LocationSummary::kNoCall,
+                                       kIntrinsified);
+
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetInAt(1, Location::RequiresRegister());
+  locations->SetInAt(2, Location::RequiresRegister());
+  locations->SetInAt(3, Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->SetOut(Location::RequiresRegister(), Location::kOutputOverlap);
+}
+
+// Lower the invoke of Adler32.updateByteBuffer(int adler, long addr, int off, int len)
+//
+// As with CRC32.updateByteBuffer, this is a private method only called with the address
+// of a DirectBuffer, so there is no need to check the address.
+void IntrinsicCodeGeneratorARM64::VisitAdler32UpdateByteBuffer(HInvoke* invoke) {
+  MacroAssembler* masm = GetVIXLAssembler();
+  LocationSummary* locations = invoke->GetLocations();
+
+  Register addr = XRegisterFrom(locations->InAt(1));
+  Register ptr = XRegisterFrom(locations->GetTemp(0));
+  __ Add(ptr, addr, XRegisterFrom(locations->InAt(2)));
+
+  Register adler = WRegisterFrom(locations->InAt(0));
+  Register length = WRegisterFrom(locations->InAt(3));
+  Register remaining = WRegisterFrom(locations->GetTemp(1));
+  Register chunk = WRegisterFrom(locations->GetTemp(2));
+  Register out = WRegisterFrom(locations->Out());
+  GenerateCodeForCalculationAdler32ValueOfBytes(masm, adler, ptr, length, remaining, chunk, out);
+}
+
 void IntrinsicLocationsBuilderARM64::VisitFP16ToFloat(HInvoke* invoke) {
   if (!codegen_->GetInstructionSetFeatures().HasFP16()) {
     return;
@@ -3402,7 +3968,234 @@ void IntrinsicCodeGeneratorARM64::VisitFP16LessEquals(HInvoke* invoke) {
   GenerateFP16Compare(invoke, codegen_, masm, ls);
 }
 
-UNIMPLEMENTED_INTRINSIC(ARM64, ReferenceGetReferent)
+// VarHandle accessors. The fast paths below handle int and long instance fields and array
+// elements where the VarHandle, the receiver and the call site agree exactly; anything else,
+// including a receiver of a subclass of the field's declaring class, goes to the runtime
+// through the slow path, which also throws any exceptions.
+
+// Emit the checks shared by all VarHandle accessors and leave the address of the variable
+// in the first temp.
+static void GenerateVarHandleChecks(HInvoke* invoke,
+                                    CodeGeneratorARM64* codegen,
+                                    SlowPathCodeARM64* slow_path,
+                                    DataType::Type type,
+                                    VarHandleAccessKind kind) {
+  MacroAssembler* masm = codegen->GetVIXLAssembler();
+  LocationSummary* locations = invoke->GetLocations();
+  Register varhandle = WRegisterFrom(locations->InAt(0));
+  Register object = WRegisterFrom(locations->InAt(1));
+  Register address = XRegisterFrom(locations->GetTemp(0));
+
+  UseScratchRegisterScope temps(masm);
+  Register temp = temps.AcquireW();
+
+  // The access mode must be supported by this VarHandle.
+  mirror::VarHandle::AccessMode access_mode =
+      mirror::VarHandle::GetAccessModeByIntrinsic(invoke->GetIntrinsic());
+  __ Ldr(temp, HeapOperand(varhandle, mirror::VarHandle::AccessModesBitMaskOffset()));
+  __ Tst(temp, 1u << static_cast<uint32_t>(access_mode));
+  __ B(eq, slow_path->GetEntryLabel());
+
+  // The variable type must match the call site exactly.
+  Primitive::Type primitive_type =
+      (type == DataType::Type::kInt32) ? Primitive::kPrimInt : Primitive::kPrimLong;
+  __ Ldr(temp, HeapOperand(varhandle, mirror::VarHandle::VarTypeOffset()));
+  codegen->GetAssembler()->MaybeUnpoisonHeapReference(temp);
+  __ Ldrh(temp, HeapOperand(temp, mirror::Class::PrimitiveTypeOffset()));
+  __ Cmp(temp, primitive_type);
+  __ B(ne, slow_path->GetEntryLabel());
+
+  __ Cbz(object, slow_path->GetEntryLabel());
+
+  const MemberOffset class_offset = mirror::Object::ClassOffset();
+  if (GetNumberOfVarHandleCoordinates(invoke, kind) == 1u) {
+    // An instance field: the receiver class must be the declaring class and there must be
+    // no second coordinate. Both references are compared without unpoisoning.
+    __ Ldr(temp, HeapOperand(varhandle, mirror::VarHandle::CoordinateType0Offset()));
+    __ Ldr(address.W(), HeapOperand(object, class_offset));
+    __ Cmp(temp, address.W());
+    __ B(ne, slow_path->GetEntryLabel());
+    __ Ldr(temp, HeapOperand(varhandle, mirror::VarHandle::CoordinateType1Offset()));
+    __ Cbnz(temp, slow_path->GetEntryLabel());
+
+    __ Ldr(address,
+           MemOperand(varhandle.X(), mirror::FieldVarHandle::ArtFieldOffset().Int32Value()));
+    __ Ldr(address.W(), MemOperand(address, ArtField::OffsetOffset().Int32Value()));
+    __ Add(address, object.X(), address);
+    return;
+  }
+
+  // An array element: the array class must be the first coordinate type and its component
+  // type must be the variable type, which rules out views of byte arrays.
+  Register index = WRegisterFrom(locations->InAt(2));
+  __ Ldr(address.W(), HeapOperand(object, class_offset));
+  __ Ldr(temp, HeapOperand(varhandle, mirror::VarHandle::CoordinateType0Offset()));
+  __ Cmp(address.W(), temp);
+  __ B(ne, slow_path->GetEntryLabel());
+  codegen->GetAssembler()->MaybeUnpoisonHeapReference(address.W());
+  __ Ldr(address.W(), HeapOperand(address.W(), mirror::Class::ComponentTypeOffset()));
+  __ Ldr(temp, HeapOperand(varhandle, mirror::VarHandle::VarTypeOffset()));
+  __ Cmp(address.W(), temp);
+  __ B(ne, slow_path->GetEntryLabel());
+
+  // Unsigned comparison also sends negative indexes to the slow path.
+  __ Ldr(temp, HeapOperand(object, mirror::Array::LengthOffset()));
+  __ Cmp(index, temp);
+  __ B(hs, slow_path->GetEntryLabel());
+  size_t size = DataType::Size(type);
+  __ Add(address, object.X(), mirror::Array::DataOffset(size).Int32Value());
+  __ Add(address, address, Operand(index, UXTW, DataType::SizeShift(type)));
+}
+
+static void CreateVarHandleLocations(HInvoke* invoke,
+                                     ArenaAllocator* allocator,
+                                     VarHandleAccessKind kind) {
+  if (GetVarHandleInlineType(invoke, kind) == DataType::Type::kVoid) {
+    return;
+  }
+
+  LocationSummary* locations =
+      new (allocator) LocationSummary(invoke, LocationSummary::kCallOnSlowPath, kIntrinsified);
+  for (size_t i = 0, e = invoke->GetNumberOfArguments(); i != e; ++i) {
+    locations->SetInAt(i, Location::RequiresRegister());
+  }
+  if (kind == VarHandleAccessKind::kGetAndUpdate) {
+    // The output is written before the last use of the inputs.
+    locations->SetOut(Location::RequiresRegister(), Location::kOutputOverlap);
+  } else if (kind != VarHandleAccessKind::kSet) {
+    locations->SetOut(Location::RequiresRegister());
+  }
+  locations->AddTemp(Location::RequiresRegister());
+}
+
+static void GenerateVarHandleGet(HInvoke* invoke, CodeGeneratorARM64* codegen) {
+  MacroAssembler* masm = codegen->GetVIXLAssembler();
+  DataType::Type type = GetVarHandleInlineType(invoke, VarHandleAccessKind::kGet);
+  LocationSummary* locations = invoke->GetLocations();
+  Register out = RegisterFrom(locations->Out(), type);
+  Register address = XRegisterFrom(locations->GetTemp(0));
+
+  SlowPathCodeARM64* slow_path =
+      new (codegen->GetScopedAllocator()) IntrinsicSlowPathARM64(invoke);
+  codegen->AddSlowPath(slow_path);
+  GenerateVarHandleChecks(invoke, codegen, slow_path, type, VarHandleAccessKind::kGet);
+
+  Intrinsics intrinsic = invoke->GetIntrinsic();
+  if (intrinsic == Intrinsics::kVarHandleGet || intrinsic == Intrinsics::kVarHandleGetOpaque) {
+    __ Ldr(out, MemOperand(address));
+  } else {
+    __ Ldar(out, MemOperand(address));
+  }
+  __ Bind(slow_path->GetExitLabel());
+}
+
+static void GenerateVarHandleSet(HInvoke* invoke, CodeGeneratorARM64* codegen) {
+  MacroAssembler* masm = codegen->GetVIXLAssembler();
+  DataType::Type type = GetVarHandleInlineType(invoke, VarHandleAccessKind::kSet);
+  LocationSummary* locations = invoke->GetLocations();
+  Register value = RegisterFrom(locations->InAt(invoke->GetNumberOfArguments() - 1u), type);
+  Register address = XRegisterFrom(locations->GetTemp(0));
+
+  SlowPathCodeARM64* slow_path =
+      new (codegen->GetScopedAllocator()) IntrinsicSlowPathARM64(invoke);
+  codegen->AddSlowPath(slow_path);
+  GenerateVarHandleChecks(invoke, codegen, slow_path, type, VarHandleAccessKind::kSet);
+
+  // STLR is sequentially consistent with LDAR, so it also implements the volatile store.
+  Intrinsics intrinsic = invoke->GetIntrinsic();
+  if (intrinsic == Intrinsics::kVarHandleSet || intrinsic == Intrinsics::kVarHandleSetOpaque) {
+    __ Str(value, MemOperand(address));
+  } else {
+    __ Stlr(value, MemOperand(address));
+  }
+  __ Bind(slow_path->GetExitLabel());
+}
+
+static void GenerateVarHandleCompareAndSet(HInvoke* invoke, CodeGeneratorARM64* codegen) {
+  MacroAssembler* masm = codegen->GetVIXLAssembler();
+  DataType::Type type = GetVarHandleInlineType(invoke, VarHandleAccessKind::kCompareAndSet);
+  LocationSummary* locations = invoke->GetLocations();
+  size_t value_index = invoke->GetNumberOfArguments() - 1u;
+  Register expected = RegisterFrom(locations->InAt(value_index - 1u), type);
+  Register value = RegisterFrom(locations->InAt(value_index), type);
+  Register out = WRegisterFrom(locations->Out());
+  Register address = XRegisterFrom(locations->GetTemp(0));
+
+  SlowPathCodeARM64* slow_path =
+      new (codegen->GetScopedAllocator()) IntrinsicSlowPathARM64(invoke);
+  codegen->AddSlowPath(slow_path);
+  GenerateVarHandleChecks(invoke, codegen, slow_path, type, VarHandleAccessKind::kCompareAndSet);
+
+  // A strong, sequentially consistent CAS implements the weak variants and all the memory
+  // orders, as in GenCas().
+  UseScratchRegisterScope temps(masm);
+  Register old_value = temps.AcquireSameSizeAs(value);
+  vixl::aarch64::Label loop_head;
+  vixl::aarch64::Label exit_loop;
+  __ Bind(&loop_head);
+  __ Ldaxr(old_value, MemOperand(address));
+  __ Cmp(old_value, expected);
+  __ B(&exit_loop, ne);
+  __ Stlxr(old_value.W(), value, MemOperand(address));  // Reuse `old_value` for STLXR result.
+  __ Cbnz(old_value.W(), &loop_head);
+  __ Bind(&exit_loop);
+  __ Cset(out, eq);
+  __ Bind(slow_path->GetExitLabel());
+}
+
+static void GenerateVarHandleGetAndAdd(HInvoke* invoke, CodeGeneratorARM64* codegen) {
+  MacroAssembler* masm = codegen->GetVIXLAssembler();
+  DataType::Type type = GetVarHandleInlineType(invoke, VarHandleAccessKind::kGetAndUpdate);
+  LocationSummary* locations = invoke->GetLocations();
+  Register value = RegisterFrom(locations->InAt(invoke->GetNumberOfArguments() - 1u), type);
+  Register out = RegisterFrom(locations->Out(), type);
+  Register address = XRegisterFrom(locations->GetTemp(0));
+
+  SlowPathCodeARM64* slow_path =
+      new (codegen->GetScopedAllocator()) IntrinsicSlowPathARM64(invoke);
+  codegen->AddSlowPath(slow_path);
+  GenerateVarHandleChecks(invoke, codegen, slow_path, type, VarHandleAccessKind::kGetAndUpdate);
+
+  UseScratchRegisterScope temps(masm);
+  Register new_value = temps.AcquireSameSizeAs(out);
+  Register status = temps.AcquireW();
+  vixl::aarch64::Label loop_head;
+  __ Bind(&loop_head);
+  __ Ldaxr(out, MemOperand(address));
+  __ Add(new_value, out, value);
+  __ Stlxr(status, new_value, MemOperand(address));
+  __ Cbnz(status, &loop_head);
+  __ Bind(slow_path->GetExitLabel());
+}
+
+#define VAR_HANDLE_INTRINSICS(V)                                                       \
+  V(VarHandleGet, kGet, GenerateVarHandleGet)                                          \
+  V(VarHandleGetOpaque, kGet, GenerateVarHandleGet)                                    \
+  V(VarHandleGetAcquire, kGet, GenerateVarHandleGet)                                   \
+  V(VarHandleGetVolatile, kGet, GenerateVarHandleGet)                                  \
+  V(VarHandleSet, kSet, GenerateVarHandleSet)                                          \
+  V(VarHandleSetOpaque, kSet, GenerateVarHandleSet)                                    \
+  V(VarHandleSetRelease, kSet, GenerateVarHandleSet)                                   \
+  V(VarHandleSetVolatile, kSet, GenerateVarHandleSet)                                  \
+  V(VarHandleCompareAndSet, kCompareAndSet, GenerateVarHandleCompareAndSet)            \
+  V(VarHandleWeakCompareAndSet, kCompareAndSet, GenerateVarHandleCompareAndSet)        \
+  V(VarHandleWeakCompareAndSetPlain, kCompareAndSet, GenerateVarHandleCompareAndSet)   \
+  V(VarHandleWeakCompareAndSetAcquire, kCompareAndSet, GenerateVarHandleCompareAndSet) \
+  V(VarHandleWeakCompareAndSetRelease, kCompareAndSet, GenerateVarHandleCompareAndSet) \
+  V(VarHandleGetAndAdd, kGetAndUpdate, GenerateVarHandleGetAndAdd)                     \
+  V(VarHandleGetAndAddAcquire, kGetAndUpdate, GenerateVarHandleGetAndAdd)              \
+  V(VarHandleGetAndAddRelease, kGetAndUpdate, GenerateVarHandleGetAndAdd)
+
+#define DEFINE_VAR_HANDLE_INTRINSIC(Name, Kind, Generator)                \
+void IntrinsicLocationsBuilderARM64::Visit ## Name(HInvoke* invoke) {     \
+  CreateVarHandleLocations(invoke, allocator_, VarHandleAccessKind::Kind); \
+}                                                                         \
+void IntrinsicCodeGeneratorARM64::Visit ## Name(HInvoke* invoke) {        \
+  Generator(invoke, codegen_);                                            \
+}
+VAR_HANDLE_INTRINSICS(DEFINE_VAR_HANDLE_INTRINSIC)
+#undef DEFINE_VAR_HANDLE_INTRINSIC
+#undef VAR_HANDLE_INTRINSICS
 
 UNIMPLEMENTED_INTRINSIC(ARM64, StringStringIndexOf);
 UNIMPLEMENTED_INTRINSIC(ARM64, StringStringIndexOfAfter);
@@ -3422,12 +4215,21 @@ UNIMPLEMENTED_INTRINSIC(ARM64, StringBuilderAppendDouble);
 UNIMPLEMENTED_INTRINSIC(ARM64, StringBuilderLength);
 UNIMPLEMENTED_INTRINSIC(ARM64, StringBuilderToString);
 
-// 1.8.
-UNIMPLEMENTED_INTRINSIC(ARM64, UnsafeGetAndAddInt)
-UNIMPLEMENTED_INTRINSIC(ARM64, UnsafeGetAndAddLong)
-UNIMPLEMENTED_INTRINSIC(ARM64, UnsafeGetAndSetInt)
-UNIMPLEMENTED_INTRINSIC(ARM64, UnsafeGetAndSetLong)
-UNIMPLEMENTED_INTRINSIC(ARM64, UnsafeGetAndSetObject)
+UNIMPLEMENTED_INTRINSIC(ARM64, VarHandleCompareAndExchange)
+UNIMPLEMENTED_INTRINSIC(ARM64, VarHandleCompareAndExchangeAcquire)
+UNIMPLEMENTED_INTRINSIC(ARM64, VarHandleCompareAndExchangeRelease)
+UNIMPLEMENTED_INTRINSIC(ARM64, VarHandleGetAndBitwiseAnd)
+UNIMPLEMENTED_INTRINSIC(ARM64, VarHandleGetAndBitwiseAndAcquire)
+UNIMPLEMENTED_INTRINSIC(ARM64, VarHandleGetAndBitwiseAndRelease)
+UNIMPLEMENTED_INTRINSIC(ARM64, VarHandleGetAndBitwiseOr)
+UNIMPLEMENTED_INTRINSIC(ARM64, VarHandleGetAndBitwiseOrAcquire)
+UNIMPLEMENTED_INTRINSIC(ARM64, VarHandleGetAndBitwiseOrRelease)
+UNIMPLEMENTED_INTRINSIC(ARM64, VarHandleGetAndBitwiseXor)
+UNIMPLEMENTED_INTRINSIC(ARM64, VarHandleGetAndBitwiseXorAcquire)
+UNIMPLEMENTED_INTRINSIC(ARM64, VarHandleGetAndBitwiseXorRelease)
+UNIMPLEMENTED_INTRINSIC(ARM64, VarHandleGetAndSet)
+UNIMPLEMENTED_INTRINSIC(ARM64, VarHandleGetAndSetAcquire)
+UNIMPLEMENTED_INTRINSIC(ARM64, VarHandleGetAndSetRelease)
 
 UNREACHABLE_INTRINSICS(ARM64)
 
@@ -3070,6 +3070,9 @@ UNIMPLEMENTED_INTRINSIC(ARMVIXL, ReferenceGetReferent)
 UNIMPLEMENTED_INTRINSIC(ARMVIXL, CRC32Update)
 UNIMPLEMENTED_INTRINSIC(ARMVIXL, CRC32UpdateBytes)
 UNIMPLEMENTED_INTRINSIC(ARMVIXL, CRC32UpdateByteBuffer)
+UNIMPLEMENTED_INTRINSIC(ARMVIXL, Adler32Update)
+UNIMPLEMENTED_INTRINSIC(ARMVIXL, Adler32UpdateBytes)
+UNIMPLEMENTED_INTRINSIC(ARMVIXL, Adler32UpdateByteBuffer)
 UNIMPLEMENTED_INTRINSIC(ARMVIXL, FP16ToFloat)
 UNIMPLEMENTED_INTRINSIC(ARMVIXL, FP16ToHalf)
 UNIMPLEMENTED_INTRINSIC(ARMVIXL, FP16Floor)
@@ -3105,6 +3108,44 @@ UNIMPLEMENTED_INTRINSIC(ARMVIXL, UnsafeGetAndSetInt)
 UNIMPLEMENTED_INTRINSIC(ARMVIXL, UnsafeGetAndSetLong)
 UNIMPLEMENTED_INTRINSIC(ARMVIXL, UnsafeGetAndSetObject)
 
+UNIMPLEMENTED_INTRINSIC(ARMVIXL, VarHandleCompareAndExchange)
+UNIMPLEMENTED_INTRINSIC(ARMVIXL, VarHandleCompareAndExchangeAcquire)
+UNIMPLEMENTED_INTRINSIC(ARMVIXL, VarHandleCompareAndExchangeRelease)
+UNIMPLEMENTED_INTRINSIC(ARMVIXL, VarHandleCompareAndSet)
+UNIMPLEMENTED_INTRINSIC(ARMVIXL, VarHandleGet)
+UNIMPLEMENTED_INTRINSIC(ARMVIXL, VarHandleGetAcquire)
+UNIMPLEMENTED_INTRINSIC(ARMVIXL, VarHandleGetAndAdd)
+UNIMPLEMENTED_INTRINSIC(ARMVIXL, VarHandleGetAndAddAcquire)
+UNIMPLEMENTED_INTRINSIC(ARMVIXL, VarHandleGetAndAddRelease)
+UNIMPLEMENTED_INTRINSIC(ARMVIXL, VarHandleGetAndBitwiseAnd)
+UNIMPLEMENTED_INTRINSIC(ARMVIXL, VarHandleGetAndBitwiseAndAcquire)
+UNIMPLEMENTED_INTRINSIC(ARMVIXL, VarHandleGetAndBitwiseAndRelease)
+UNIMPLEMENTED_INTRINSIC(ARMVIXL, VarHandleGetAndBitwiseOr)
+UNIMPLEMENTED_INTRINSIC(ARMVIXL, VarHandleGetAndBitwiseOrAcquire)
+UNIMPLEMENTED_INTRINSIC(ARMVIXL, VarHandleGetAndBitwiseOrRelease)
+UNIMPLEMENTED_INTRINSIC(ARMVIXL, VarHandleGetAndBitwiseXor)
+UNIMPLEMENTED_INTRINSIC(ARMVIXL, VarHandleGetAndBitwiseXorAcquire)
+UNIMPLEMENTED_INTRINSIC(ARMVIXL, VarHandleGetAndBitwiseXorRelease)
+UNIMPLEMENTED_INTRINSIC(ARMVIXL, VarHandleGetAndSet)
+UNIMPLEMENTED_INTRINSIC(ARMVIXL, VarHandleGetAndSetAcquire)
+UNIMPLEMENTED_INTRINSIC(ARMVIXL, VarHandleGetAndSetRelease)
+UNIMPLEMENTED_INTRINSIC(ARMVIXL, VarHandleGetOpaque)
+UNIMPLEMENTED_INTRINSIC(ARMVIXL, VarHandleGetVolatile)
+UNIMPLEMENTED_INTRINSIC(ARMVIXL, VarHandleSet)
+UNIMPLEMENTED_INTRINSIC(ARMVIXL, VarHandleSetOpaque)
+UNIMPLEMENTED_INTRINSIC(ARMVIXL, VarHandleSetRelease)
+UNIMPLEMENTED_INTRINSIC(ARMVIXL, VarHandleSetVolatile)
+UNIMPLEMENTED_INTRINSIC(ARMVIXL, VarHandleWeakCompareAndSet)
+UNIMPLEMENTED_INTRINSIC(ARMVIXL, VarHandleWeakCompareAndSetAcquire)
+UNIMPLEMENTED_INTRINSIC(ARMVIXL, VarHandleWeakCompareAndSetPlain)
+UNIMPLEMENTED_INTRINSIC(ARMVIXL, VarHandleWeakCompareAndSetRelease)
+
+UNIMPLEMENTED_INTRINSIC(ARMVIXL, ArraysEqualsByte)
+UNIMPLEMENTED_INTRINSIC(ARMVIXL, ArraysEqualsChar)
+UNIMPLEMENTED_INTRINSIC(ARMVIXL, ArraysEqualsShort)
+UNIMPLEMENTED_INTRINSIC(ARMVIXL, ArraysEqualsInt)
+UNIMPLEMENTED_INTRINSIC(ARMVIXL, ArraysEqualsLong)
+
 UNREACHABLE_INTRINSICS(ARMVIXL)
 
 #undef __
@@ -2707,6 +2707,9 @@ UNIMPLEMENTED_INTRINSIC(MIPS, SystemArrayCopy)
 UNIMPLEMENTED_INTRINSIC(MIPS, CRC32Update)
 UNIMPLEMENTED_INTRINSIC(MIPS, CRC32UpdateBytes)
 UNIMPLEMENTED_INTRINSIC(MIPS, CRC32UpdateByteBuffer)
+UNIMPLEMENTED_INTRINSIC(MIPS, Adler32Update)
+UNIMPLEMENTED_INTRINSIC(MIPS, Adler32UpdateBytes)
+UNIMPLEMENTED_INTRINSIC(MIPS, Adler32UpdateByteBuffer)
 UNIMPLEMENTED_INTRINSIC(MIPS, FP16ToFloat)
 UNIMPLEMENTED_INTRINSIC(MIPS, FP16ToHalf)
 UNIMPLEMENTED_INTRINSIC(MIPS, FP16Floor)
@@ -2742,6 +2745,44 @@ UNIMPLEMENTED_INTRINSIC(MIPS, UnsafeGetAndSetInt)
 UNIMPLEMENTED_INTRINSIC(MIPS, UnsafeGetAndSetLong)
 UNIMPLEMENTED_INTRINSIC(MIPS, UnsafeGetAndSetObject)
 
+UNIMPLEMENTED_INTRINSIC(MIPS, VarHandleCompareAndExchange)
+UNIMPLEMENTED_INTRINSIC(MIPS, VarHandleCompareAndExchangeAcquire)
+UNIMPLEMENTED_INTRINSIC(MIPS, VarHandleCompareAndExchangeRelease)
+UNIMPLEMENTED_INTRINSIC(MIPS, VarHandleCompareAndSet)
+UNIMPLEMENTED_INTRINSIC(MIPS, VarHandleGet)
+UNIMPLEMENTED_INTRINSIC(MIPS, VarHandleGetAcquire)
+UNIMPLEMENTED_INTRINSIC(MIPS, VarHandleGetAndAdd)
+UNIMPLEMENTED_INTRINSIC(MIPS, VarHandleGetAndAddAcquire)
+UNIMPLEMENTED_INTRINSIC(MIPS, VarHandleGetAndAddRelease)
+UNIMPLEMENTED_INTRINSIC(MIPS, VarHandleGetAndBitwiseAnd)
+UNIMPLEMENTED_INTRINSIC(MIPS, VarHandleGetAndBitwiseAndAcquire)
+UNIMPLEMENTED_INTRINSIC(MIPS, VarHandleGetAndBitwiseAndRelease)
+UNIMPLEMENTED_INTRINSIC(MIPS, VarHandleGetAndBitwiseOr)
+UNIMPLEMENTED_INTRINSIC(MIPS, VarHandleGetAndBitwiseOrAcquire)
+UNIMPLEMENTED_INTRINSIC(MIPS, VarHandleGetAndBitwiseOrRelease)
+UNIMPLEMENTED_INTRINSIC(MIPS, VarHandleGetAndBitwiseXor)
+UNIMPLEMENTED_INTRINSIC(MIPS, VarHandleGetAndBitwiseXorAcquire)
+UNIMPLEMENTED_INTRINSIC(MIPS, VarHandleGetAndBitwiseXorRelease)
+UNIMPLEMENTED_INTRINSIC(MIPS, VarHandleGetAndSet)
+UNIMPLEMENTED_INTRINSIC(MIPS, VarHandleGetAndSetAcquire)
+UNIMPLEMENTED_INTRINSIC(MIPS, VarHandleGetAndSetRelease)
+UNIMPLEMENTED_INTRINSIC(MIPS, VarHandleGetOpaque)
+UNIMPLEMENTED_INTRINSIC(MIPS, VarHandleGetVolatile)
+UNIMPLEMENTED_INTRINSIC(MIPS, VarHandleSet)
+UNIMPLEMENTED_INTRINSIC(MIPS, VarHandleSetOpaque)
+UNIMPLEMENTED_INTRINSIC(MIPS, VarHandleSetRelease)
+UNIMPLEMENTED_INTRINSIC(MIPS, VarHandleSetVolatile)
+UNIMPLEMENTED_INTRINSIC(MIPS, VarHandleWeakCompareAndSet)
+UNIMPLEMENTED_INTRINSIC(MIPS, VarHandleWeakCompareAndSetAcquire)
+UNIMPLEMENTED_INTRINSIC(MIPS, VarHandleWeakCompareAndSetPlain)
+UNIMPLEMENTED_INTRINSIC(MIPS, VarHandleWeakCompareAndSetRelease)
+
+UNIMPLEMENTED_INTRINSIC(MIPS, ArraysEqualsByte)
+UNIMPLEMENTED_INTRINSIC(MIPS, ArraysEqualsChar)
+UNIMPLEMENTED_INTRINSIC(MIPS, ArraysEqualsShort)
+UNIMPLEMENTED_INTRINSIC(MIPS, ArraysEqualsInt)
+UNIMPLEMENTED_INTRINSIC(MIPS, ArraysEqualsLong)
+
 UNREACHABLE_INTRINSICS(MIPS)
 
 #undef __
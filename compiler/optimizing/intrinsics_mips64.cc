@@ -2357,6 +2357,9 @@ UNIMPLEMENTED_INTRINSIC(MIPS64, SystemArrayCopy)
 UNIMPLEMENTED_INTRINSIC(MIPS64, CRC32Update)
 UNIMPLEMENTED_INTRINSIC(MIPS64, CRC32UpdateBytes)
 UNIMPLEMENTED_INTRINSIC(MIPS64, CRC32UpdateByteBuffer)
+UNIMPLEMENTED_INTRINSIC(MIPS64, Adler32Update)
+UNIMPLEMENTED_INTRINSIC(MIPS64, Adler32UpdateBytes)
+UNIMPLEMENTED_INTRINSIC(MIPS64, Adler32UpdateByteBuffer)
 UNIMPLEMENTED_INTRINSIC(MIPS64, FP16ToFloat)
 UNIMPLEMENTED_INTRINSIC(MIPS64, FP16ToHalf)
 UNIMPLEMENTED_INTRINSIC(MIPS64, FP16Floor)
@@ -2392,6 +2395,44 @@ UNIMPLEMENTED_INTRINSIC(MIPS64, UnsafeGetAndSetInt)
 UNIMPLEMENTED_INTRINSIC(MIPS64, UnsafeGetAndSetLong)
 UNIMPLEMENTED_INTRINSIC(MIPS64, UnsafeGetAndSetObject)
 
+UNIMPLEMENTED_INTRINSIC(MIPS64, VarHandleCompareAndExchange)
+UNIMPLEMENTED_INTRINSIC(MIPS64, VarHandleCompareAndExchangeAcquire)
+UNIMPLEMENTED_INTRINSIC(MIPS64, VarHandleCompareAndExchangeRelease)
+UNIMPLEMENTED_INTRINSIC(MIPS64, VarHandleCompareAndSet)
+UNIMPLEMENTED_INTRINSIC(MIPS64, VarHandleGet)
+UNIMPLEMENTED_INTRINSIC(MIPS64, VarHandleGetAcquire)
+UNIMPLEMENTED_INTRINSIC(MIPS64, VarHandleGetAndAdd)
+UNIMPLEMENTED_INTRINSIC(MIPS64, VarHandleGetAndAddAcquire)
+UNIMPLEMENTED_INTRINSIC(MIPS64, VarHandleGetAndAddRelease)
+UNIMPLEMENTED_INTRINSIC(MIPS64, VarHandleGetAndBitwiseAnd)
+UNIMPLEMENTED_INTRINSIC(MIPS64, VarHandleGetAndBitwiseAndAcquire)
+UNIMPLEMENTED_INTRINSIC(MIPS64, VarHandleGetAndBitwiseAndRelease)
+UNIMPLEMENTED_INTRINSIC(MIPS64, VarHandleGetAndBitwiseOr)
+UNIMPLEMENTED_INTRINSIC(MIPS64, VarHandleGetAndBitwiseOrAcquire)
+UNIMPLEMENTED_INTRINSIC(MIPS64, VarHandleGetAndBitwiseOrRelease)
+UNIMPLEMENTED_INTRINSIC(MIPS64, VarHandleGetAndBitwiseXor)
+UNIMPLEMENTED_INTRINSIC(MIPS64, VarHandleGetAndBitwiseXorAcquire)
+UNIMPLEMENTED_INTRINSIC(MIPS64, VarHandleGetAndBitwiseXorRelease)
+UNIMPLEMENTED_INTRINSIC(MIPS64, VarHandleGetAndSet)
+UNIMPLEMENTED_INTRINSIC(MIPS64, VarHandleGetAndSetAcquire)
+UNIMPLEMENTED_INTRINSIC(MIPS64, VarHandleGetAndSetRelease)
+UNIMPLEMENTED_INTRINSIC(MIPS64, VarHandleGetOpaque)
+UNIMPLEMENTED_INTRINSIC(MIPS64, VarHandleGetVolatile)
+UNIMPLEMENTED_INTRINSIC(MIPS64, VarHandleSet)
+UNIMPLEMENTED_INTRINSIC(MIPS64, VarHandleSetOpaque)
+UNIMPLEMENTED_INTRINSIC(MIPS64, VarHandleSetRelease)
+UNIMPLEMENTED_INTRINSIC(MIPS64, VarHandleSetVolatile)
+UNIMPLEMENTED_INTRINSIC(MIPS64, VarHandleWeakCompareAndSet)
+UNIMPLEMENTED_INTRINSIC(MIPS64, VarHandleWeakCompareAndSetAcquire)
+UNIMPLEMENTED_INTRINSIC(MIPS64, VarHandleWeakCompareAndSetPlain)
+UNIMPLEMENTED_INTRINSIC(MIPS64, VarHandleWeakCompareAndSetRelease)
+
+UNIMPLEMENTED_INTRINSIC(MIPS64, ArraysEqualsByte)
+UNIMPLEMENTED_INTRINSIC(MIPS64, ArraysEqualsChar)
+UNIMPLEMENTED_INTRINSIC(MIPS64, ArraysEqualsShort)
+UNIMPLEMENTED_INTRINSIC(MIPS64, ArraysEqualsInt)
+UNIMPLEMENTED_INTRINSIC(MIPS64, ArraysEqualsLong)
+
 UNREACHABLE_INTRINSICS(MIPS64)
 
 #undef __
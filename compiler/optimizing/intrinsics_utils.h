@@ -17,8 +17,11 @@
 #ifndef ART_COMPILER_OPTIMIZING_INTRINSICS_UTILS_H_
 #define ART_COMPILER_OPTIMIZING_INTRINSICS_UTILS_H_
 
+#include <string.h>
+
 #include "base/macros.h"
 #include "code_generator.h"
+#include "data_type.h"
 #include "locations.h"
 #include "nodes.h"
 #include "utils/assembler.h"
@@ -57,6 +60,8 @@ class IntrinsicSlowPath : public SlowPathCode {
 
     if (invoke_->IsInvokeStaticOrDirect()) {
       codegen->GenerateStaticOrDirectCall(invoke_->AsInvokeStaticOrDirect(), method_loc, this);
+    } else if (invoke_->IsInvokePolymorphic()) {
+      codegen->GenerateInvokePolymorphicCall(invoke_->AsInvokePolymorphic(), this);
     } else {
       codegen->GenerateVirtualCall(invoke_->AsInvokeVirtual(), method_loc, this);
     }
@@ -82,6 +87,70 @@ class IntrinsicSlowPath : public SlowPathCode {
   DISALLOW_COPY_AND_ASSIGN(IntrinsicSlowPath);
 };
 
+// Shapes of VarHandle accessors with a compiled fast path.
+enum class VarHandleAccessKind {
+  kGet,             // T get*(coordinates)
+  kSet,             // void set*(coordinates, T value)
+  kCompareAndSet,   // boolean [weak]compareAndSet*(coordinates, T expected, T new_value)
+  kGetAndUpdate,    // T getAndAdd*(coordinates, T value)
+};
+
+inline size_t GetNumberOfVarHandleValues(VarHandleAccessKind kind) {
+  switch (kind) {
+    case VarHandleAccessKind::kGet: return 0u;
+    case VarHandleAccessKind::kSet: return 1u;
+    case VarHandleAccessKind::kCompareAndSet: return 2u;
+    case VarHandleAccessKind::kGetAndUpdate: return 1u;
+  }
+}
+
+// Return the number of coordinates of a VarHandle accessor call site, i.e. the arguments
+// between the VarHandle and the values: one for an instance field, two for an array element.
+inline size_t GetNumberOfVarHandleCoordinates(HInvoke* invoke, VarHandleAccessKind kind) {
+  DCHECK(invoke->IsInvokePolymorphic());
+  size_t num_args = strlen(invoke->AsInvokePolymorphic()->GetShorty()) - 1u;
+  size_t num_values = GetNumberOfVarHandleValues(kind);
+  return (num_args >= num_values) ? num_args - num_values : 0u;
+}
+
+// Return the variable type of a VarHandle accessor call site if it has one of the shapes the
+// code generators handle inline: an instance field (one reference coordinate) or an array
+// element (reference and int coordinates) of type int or long, with the values and the return
+// type matching `kind`. Return DataType::Type::kVoid otherwise. The call site is only a claim
+// about the VarHandle, the generated code still checks it at run time.
+inline DataType::Type GetVarHandleInlineType(HInvoke* invoke, VarHandleAccessKind kind) {
+  const char* shorty = invoke->AsInvokePolymorphic()->GetShorty();
+  size_t num_args = strlen(shorty) - 1u;
+  size_t num_coordinates = GetNumberOfVarHandleCoordinates(invoke, kind);
+  if (num_coordinates != 1u && num_coordinates != 2u) {
+    return DataType::Type::kVoid;
+  }
+  const char* args = shorty + 1;
+  if (args[0] != 'L' || (num_coordinates == 2u && args[1] != 'I')) {
+    return DataType::Type::kVoid;
+  }
+  // The variable type comes from the return type for gets, from the values otherwise.
+  char var_type = (kind == VarHandleAccessKind::kGet) ? shorty[0] : args[num_coordinates];
+  if (var_type != 'I' && var_type != 'J') {
+    return DataType::Type::kVoid;
+  }
+  for (size_t i = num_coordinates; i != num_args; ++i) {
+    if (args[i] != var_type) {
+      return DataType::Type::kVoid;
+    }
+  }
+  char expected_return = var_type;
+  if (kind == VarHandleAccessKind::kSet) {
+    expected_return = 'V';
+  } else if (kind == VarHandleAccessKind::kCompareAndSet) {
+    expected_return = 'Z';
+  }
+  if (shorty[0] != expected_return) {
+    return DataType::Type::kVoid;
+  }
+  return DataType::FromShorty(var_type);
+}
+
 }  // namespace art
 
 #endif  // ART_COMPILER_OPTIMIZING_INTRINSICS_UTILS_H_
@@ -3081,6 +3081,9 @@ UNIMPLEMENTED_INTRINSIC(X86, LongHighestOneBit)
 UNIMPLEMENTED_INTRINSIC(X86, CRC32Update)
 UNIMPLEMENTED_INTRINSIC(X86, CRC32UpdateBytes)
 UNIMPLEMENTED_INTRINSIC(X86, CRC32UpdateByteBuffer)
+UNIMPLEMENTED_INTRINSIC(X86, Adler32Update)
+UNIMPLEMENTED_INTRINSIC(X86, Adler32UpdateBytes)
+UNIMPLEMENTED_INTRINSIC(X86, Adler32UpdateByteBuffer)
 UNIMPLEMENTED_INTRINSIC(X86, FP16ToFloat)
 UNIMPLEMENTED_INTRINSIC(X86, FP16ToHalf)
 UNIMPLEMENTED_INTRINSIC(X86, FP16Floor)
@@ -3116,6 +3119,44 @@ UNIMPLEMENTED_INTRINSIC(X86, UnsafeGetAndSetInt)
 UNIMPLEMENTED_INTRINSIC(X86, UnsafeGetAndSetLong)
 UNIMPLEMENTED_INTRINSIC(X86, UnsafeGetAndSetObject)
 
+UNIMPLEMENTED_INTRINSIC(X86, VarHandleCompareAndExchange)
+UNIMPLEMENTED_INTRINSIC(X86, VarHandleCompareAndExchangeAcquire)
+UNIMPLEMENTED_INTRINSIC(X86, VarHandleCompareAndExchangeRelease)
+UNIMPLEMENTED_INTRINSIC(X86, VarHandleCompareAndSet)
+UNIMPLEMENTED_INTRINSIC(X86, VarHandleGet)
+UNIMPLEMENTED_INTRINSIC(X86, VarHandleGetAcquire)
+UNIMPLEMENTED_INTRINSIC(X86, VarHandleGetAndAdd)
+UNIMPLEMENTED_INTRINSIC(X86, VarHandleGetAndAddAcquire)
+UNIMPLEMENTED_INTRINSIC(X86, VarHandleGetAndAddRelease)
+UNIMPLEMENTED_INTRINSIC(X86, VarHandleGetAndBitwiseAnd)
+UNIMPLEMENTED_INTRINSIC(X86, VarHandleGetAndBitwiseAndAcquire)
+UNIMPLEMENTED_INTRINSIC(X86, VarHandleGetAndBitwiseAndRelease)
+UNIMPLEMENTED_INTRINSIC(X86, VarHandleGetAndBitwiseOr)
+UNIMPLEMENTED_INTRINSIC(X86, VarHandleGetAndBitwiseOrAcquire)
+UNIMPLEMENTED_INTRINSIC(X86, VarHandleGetAndBitwiseOrRelease)
+UNIMPLEMENTED_INTRINSIC(X86, VarHandleGetAndBitwiseXor)
+UNIMPLEMENTED_INTRINSIC(X86, VarHandleGetAndBitwiseXorAcquire)
+UNIMPLEMENTED_INTRINSIC(X86, VarHandleGetAndBitwiseXorRelease)
+UNIMPLEMENTED_INTRINSIC(X86, VarHandleGetAndSet)
+UNIMPLEMENTED_INTRINSIC(X86, VarHandleGetAndSetAcquire)
+UNIMPLEMENTED_INTRINSIC(X86, VarHandleGetAndSetRelease)
+UNIMPLEMENTED_INTRINSIC(X86, VarHandleGetOpaque)
+UNIMPLEMENTED_INTRINSIC(X86, VarHandleGetVolatile)
+UNIMPLEMENTED_INTRINSIC(X86, VarHandleSet)
+UNIMPLEMENTED_INTRINSIC(X86, VarHandleSetOpaque)
+UNIMPLEMENTED_INTRINSIC(X86, VarHandleSetRelease)
+UNIMPLEMENTED_INTRINSIC(X86, VarHandleSetVolatile)
+UNIMPLEMENTED_INTRINSIC(X86, VarHandleWeakCompareAndSet)
+UNIMPLEMENTED_INTRINSIC(X86, VarHandleWeakCompareAndSetAcquire)
+UNIMPLEMENTED_INTRINSIC(X86, VarHandleWeakCompareAndSetPlain)
+UNIMPLEMENTED_INTRINSIC(X86, VarHandleWeakCompareAndSetRelease)
+
+UNIMPLEMENTED_INTRINSIC(X86, ArraysEqualsByte)
+UNIMPLEMENTED_INTRINSIC(X86, ArraysEqualsChar)
+UNIMPLEMENTED_INTRINSIC(X86, ArraysEqualsShort)
+UNIMPLEMENTED_INTRINSIC(X86, ArraysEqualsInt)
+UNIMPLEMENTED_INTRINSIC(X86, ArraysEqualsLong)
+
 UNREACHABLE_INTRINSICS(X86)
 
 #undef __
@@ -19,6 +19,7 @@
 #include <limits>
 
 #include "arch/x86_64/instruction_set_features_x86_64.h"
+#include "art_field.h"
 #include "art_method.h"
 #include "base/bit_utils.h"
 #include "code_generator_x86_64.h"
@@ -31,6 +32,7 @@
 #include "mirror/object_array-inl.h"
 #include "mirror/reference.h"
 #include "mirror/string.h"
+#include "mirror/var_handle.h"
 #include "scoped_thread_state_change-inl.h"
 #include "thread-current-inl.h"
 #include "utils/x86_64/assembler_x86_64.h"
@@ -1346,6 +1348,96 @@ void IntrinsicCodeGeneratorX86_64::VisitStringEquals(HInvoke* invoke) {
   __ Bind(&end);
 }
 
+static void CreateArraysEqualsLocations(ArenaAllocator* allocator, HInvoke* invoke) {
+  LocationSummary* locations =
+      new (allocator) LocationSummary(invoke, LocationSummary::kNoCall, kIntrinsified);
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetInAt(1, Location::RequiresRegister());
+
+  // Request temporary registers, RCX and RDI needed for repe_cmpsl instruction.
+  locations->AddTemp(Location::RegisterLocation(RCX));
+  locations->AddTemp(Location::RegisterLocation(RDI));
+
+  // Set output, RSI needed for repe_cmpsl instruction anyways.
+  locations->SetOut(Location::RegisterLocation(RSI), Location::kOutputOverlap);
+}
+
+static void GenArraysEquals(HInvoke* invoke, X86_64Assembler* assembler, DataType::Type type) {
+  LocationSummary* locations = invoke->GetLocations();
+
+  CpuRegister array = locations->InAt(0).AsRegister<CpuRegister>();
+  CpuRegister arg = locations->InAt(1).AsRegister<CpuRegister>();
+  CpuRegister rcx = locations->GetTemp(0).AsRegister<CpuRegister>();
+  CpuRegister rdi = locations->GetTemp(1).AsRegister<CpuRegister>();
+  CpuRegister rsi = locations->Out().AsRegister<CpuRegister>();
+
+  NearLabel end, return_true, return_false;
+
+  const size_t component_size_shift = DataType::SizeShift(type);
+  const uint32_t length_offset = mirror::Array::LengthOffset().Uint32Value();
+  const uint32_t data_offset = mirror::Array::DataOffset(DataType::Size(type)).Uint32Value();
+
+  // Reference equality check, return true if same reference (including both null).
+  __ cmpl(array, arg);
+  __ j(kEqual, &return_true);
+
+  // Return false if either input is null.
+  __ testl(array, array);
+  __ j(kEqual, &return_false);
+  __ testl(arg, arg);
+  __ j(kEqual, &return_false);
+
+  // Check if lengths are equal, return false if they're not.
+  __ movl(rcx, Address(array, length_offset));
+  __ cmpl(rcx, Address(arg, length_offset));
+  __ j(kNotEqual, &return_false);
+  // Return true if both arrays are empty.
+  __ jrcxz(&return_true);
+
+  // Calculate the number of 4-byte words to compare, rounding up. The data of arrays with
+  // components smaller than 8 bytes starts at a 4-byte aligned offset, so comparing 4 bytes
+  // at a time never reads beyond the zero padding to kObjectAlignment.
+  static_assert(IsAligned<8>(kObjectAlignment), "Array data is not zero padded");
+  DCHECK_ALIGNED(data_offset, 4);
+  if (component_size_shift > 2u) {
+    __ shlq(rcx, Immediate(component_size_shift - 2u));
+  } else if (component_size_shift < 2u) {
+    __ addq(rcx, Immediate((1 << (2u - component_size_shift)) - 1));
+    __ shrq(rcx, Immediate(2u - component_size_shift));
+  }
+
+  // Load starting addresses of array data into RSI/RDI as required for repe_cmpsl instruction.
+  __ leal(rsi, Address(array, data_offset));
+  __ leal(rdi, Address(arg, data_offset));
+
+  // Loop to compare the arrays four bytes at a time.
+  __ repe_cmpsl();
+  // If arrays are not equal, zero flag will be cleared.
+  __ j(kNotEqual, &return_false);
+
+  __ Bind(&return_true);
+  __ movl(rsi, Immediate(1));
+  __ jmp(&end);
+
+  __ Bind(&return_false);
+  __ xorl(rsi, rsi);
+  __ Bind(&end);
+}
+
+#define ARRAYS_EQUALS_INTRINSIC(Name, Type)                                      \
+  void IntrinsicLocationsBuilderX86_64::VisitArraysEquals##Name(HInvoke* invoke) { \
+    CreateArraysEqualsLocations(allocator_, invoke);                             \
+  }                                                                              \
+  void IntrinsicCodeGeneratorX86_64::VisitArraysEquals##Name(HInvoke* invoke) {  \
+    GenArraysEquals(invoke, GetAssembler(), DataType::Type::k##Type);            \
+  }
+ARRAYS_EQUALS_INTRINSIC(Byte, Int8)
+ARRAYS_EQUALS_INTRINSIC(Char, Uint16)
+ARRAYS_EQUALS_INTRINSIC(Short, Int16)
+ARRAYS_EQUALS_INTRINSIC(Int, Int32)
+ARRAYS_EQUALS_INTRINSIC(Long, Int64)
+#undef ARRAYS_EQUALS_INTRINSIC
+
 static void CreateStringIndexOfLocations(HInvoke* invoke,
                                          ArenaAllocator* allocator,
                                          bool start_at_zero) {
@@ -2742,12 +2834,234 @@ void IntrinsicLocationsBuilderX86_64::VisitReachabilityFence(HInvoke* invoke) {
 
 void IntrinsicCodeGeneratorX86_64::VisitReachabilityFence(HInvoke* invoke ATTRIBUTE_UNUSED) { }
 
+// VarHandle accessors. The fast paths below handle int and long instance fields and array
+// elements where the VarHandle, the receiver and the call site agree exactly; anything else,
+// including a receiver of a subclass of the field's declaring class, goes to the runtime
+// through the slow path, which also throws any exceptions.
+
+// Emit the checks shared by all VarHandle accessors and return the address of the variable.
+// Uses the first temp for the field offset, so the temp must not be reused while the returned
+// address is live.
+static Address GenerateVarHandleChecks(HInvoke* invoke,
+                                       CodeGeneratorX86_64* codegen,
+                                       SlowPathCode* slow_path,
+                                       DataType::Type type,
+                                       VarHandleAccessKind kind) {
+  LocationSummary* locations = invoke->GetLocations();
+  CpuRegister varhandle = locations->InAt(0).AsRegister<CpuRegister>();
+  CpuRegister object = locations->InAt(1).AsRegister<CpuRegister>();
+  CpuRegister temp = locations->GetTemp(0).AsRegister<CpuRegister>();
+
+  // The access mode must be supported by this VarHandle.
+  mirror::VarHandle::AccessMode access_mode =
+      mirror::VarHandle::GetAccessModeByIntrinsic(invoke->GetIntrinsic());
+  __ testl(Address(varhandle, mirror::VarHandle::AccessModesBitMaskOffset().Int32Value()),
+           Immediate(1u << static_cast<uint32_t>(access_mode)));
+  __ j(kZero, slow_path->GetEntryLabel());
+
+  // The variable type must match the call site exactly.
+  Primitive::Type primitive_type =
+      (type == DataType::Type::kInt32) ? Primitive::kPrimInt : Primitive::kPrimLong;
+  __ movl(temp, Address(varhandle, mirror::VarHandle::VarTypeOffset().Int32Value()));
+  __ MaybeUnpoisonHeapReference(temp);
+  __ cmpw(Address(temp, mirror::Class::PrimitiveTypeOffset().Int32Value()),
+          Immediate(primitive_type));
+  __ j(kNotEqual, slow_path->GetEntryLabel());
+
+  __ testl(object, object);
+  __ j(kZero, slow_path->GetEntryLabel());
+
+  const uint32_t class_offset = mirror::Object::ClassOffset().Uint32Value();
+  if (GetNumberOfVarHandleCoordinates(invoke, kind) == 1u) {
+    // An instance field: the receiver class must be the declaring class and there must be
+    // no second coordinate. Both references are compared without unpoisoning.
+    __ movl(temp, Address(varhandle, mirror::VarHandle::CoordinateType0Offset().Int32Value()));
+    __ cmpl(temp, Address(object, class_offset));
+    __ j(kNotEqual, slow_path->GetEntryLabel());
+    __ cmpl(Address(varhandle, mirror::VarHandle::CoordinateType1Offset().Int32Value()),
+            Immediate(0));
+    __ j(kNotEqual, slow_path->GetEntryLabel());
+
+    __ movq(temp, Address(varhandle, mirror::FieldVarHandle::ArtFieldOffset().Int32Value()));
+    __ movl(temp, Address(temp, ArtField::OffsetOffset().Int32Value()));
+    return Address(object, temp, TIMES_1, 0);
+  }
+
+  // An array element: the array class must be the first coordinate type and its component
+  // type must be the variable type, which rules out views of byte arrays.
+  CpuRegister index = locations->InAt(2).AsRegister<CpuRegister>();
+  __ movl(temp, Address(object, class_offset));
+  __ cmpl(temp, Address(varhandle, mirror::VarHandle::CoordinateType0Offset().Int32Value()));
+  __ j(kNotEqual, slow_path->GetEntryLabel());
+  __ MaybeUnpoisonHeapReference(temp);
+  __ movl(temp, Address(temp, mirror::Class::ComponentTypeOffset().Int32Value()));
+  __ cmpl(temp, Address(varhandle, mirror::VarHandle::VarTypeOffset().Int32Value()));
+  __ j(kNotEqual, slow_path->GetEntryLabel());
+
+  // Unsigned comparison also sends negative indexes to the slow path.
+  __ cmpl(index, Address(object, mirror::Array::LengthOffset().Int32Value()));
+  __ j(kAboveEqual, slow_path->GetEntryLabel());
+  size_t size = DataType::Size(type);
+  return Address(object,
+                 index,
+                 static_cast<ScaleFactor>(DataType::SizeShift(type)),
+                 mirror::Array::DataOffset(size).Int32Value());
+}
+
+static void CreateVarHandleLocations(HInvoke* invoke,
+                                     ArenaAllocator* allocator,
+                                     VarHandleAccessKind kind) {
+  if (GetVarHandleInlineType(invoke, kind) == DataType::Type::kVoid) {
+    return;
+  }
+
+  LocationSummary* locations =
+      new (allocator) LocationSummary(invoke, LocationSummary::kCallOnSlowPath, kIntrinsified);
+  for (size_t i = 0, e = invoke->GetNumberOfArguments(); i != e; ++i) {
+    locations->SetInAt(i, Location::RequiresRegister());
+  }
+  if (kind == VarHandleAccessKind::kCompareAndSet) {
+    // The expected value must be in EAX/RAX, as required by CMPXCHG.
+    size_t expected_index = 1u + GetNumberOfVarHandleCoordinates(invoke, kind);
+    locations->SetInAt(expected_index, Location::RegisterLocation(RAX));
+  }
+  if (kind == VarHandleAccessKind::kGetAndUpdate) {
+    // The output is written before the last use of the inputs.
+    locations->SetOut(Location::RequiresRegister(), Location::kOutputOverlap);
+  } else if (kind != VarHandleAccessKind::kSet) {
+    locations->SetOut(Location::RequiresRegister());
+  }
+  locations->AddTemp(Location::RequiresRegister());
+}
+
+static void GenerateVarHandleGet(HInvoke* invoke, CodeGeneratorX86_64* codegen) {
+  DataType::Type type = GetVarHandleInlineType(invoke, VarHandleAccessKind::kGet);
+  CpuRegister out = invoke->GetLocations()->Out().AsRegister<CpuRegister>();
+
+  SlowPathCode* slow_path = new (codegen->GetScopedAllocator()) IntrinsicSlowPathX86_64(invoke);
+  codegen->AddSlowPath(slow_path);
+  Address address =
+      GenerateVarHandleChecks(invoke, codegen, slow_path, type, VarHandleAccessKind::kGet);
+
+  // Aligned loads are atomic and, on x86-64, have acquire semantics for all the get modes.
+  if (type == DataType::Type::kInt32) {
+    __ movl(out, address);
+  } else {
+    __ movq(out, address);
+  }
+  __ Bind(slow_path->GetExitLabel());
+}
+
+static void GenerateVarHandleSet(HInvoke* invoke, CodeGeneratorX86_64* codegen) {
+  DataType::Type type = GetVarHandleInlineType(invoke, VarHandleAccessKind::kSet);
+  LocationSummary* locations = invoke->GetLocations();
+  size_t value_index = invoke->GetNumberOfArguments() - 1u;
+  CpuRegister value = locations->InAt(value_index).AsRegister<CpuRegister>();
+
+  SlowPathCode* slow_path = new (codegen->GetScopedAllocator()) IntrinsicSlowPathX86_64(invoke);
+  codegen->AddSlowPath(slow_path);
+  Address address =
+      GenerateVarHandleChecks(invoke, codegen, slow_path, type, VarHandleAccessKind::kSet);
+
+  // Aligned stores are atomic and have release semantics; only the volatile store needs
+  // a fence to order it with later loads.
+  if (type == DataType::Type::kInt32) {
+    __ movl(address, value);
+  } else {
+    __ movq(address, value);
+  }
+  if (invoke->GetIntrinsic() == Intrinsics::kVarHandleSetVolatile) {
+    codegen->MemoryFence();
+  }
+  __ Bind(slow_path->GetExitLabel());
+}
+
+static void GenerateVarHandleCompareAndSet(HInvoke* invoke, CodeGeneratorX86_64* codegen) {
+  DataType::Type type = GetVarHandleInlineType(invoke, VarHandleAccessKind::kCompareAndSet);
+  LocationSummary* locations = invoke->GetLocations();
+  size_t value_index = invoke->GetNumberOfArguments() - 1u;
+  DCHECK_EQ(locations->InAt(value_index - 1u).AsRegister<CpuRegister>().AsRegister(), RAX);
+  CpuRegister value = locations->InAt(value_index).AsRegister<CpuRegister>();
+  CpuRegister out = locations->Out().AsRegister<CpuRegister>();
+
+  SlowPathCode* slow_path = new (codegen->GetScopedAllocator()) IntrinsicSlowPathX86_64(invoke);
+  codegen->AddSlowPath(slow_path);
+  Address address = GenerateVarHandleChecks(
+      invoke, codegen, slow_path, type, VarHandleAccessKind::kCompareAndSet);
+
+  // LOCK CMPXCHG has full barrier semantics and never fails spuriously, so it implements
+  // the weak variants and all the memory orders.
+  if (type == DataType::Type::kInt32) {
+    __ LockCmpxchgl(address, value);
+  } else {
+    __ LockCmpxchgq(address, value);
+  }
+  __ setcc(kZero, out);
+  __ movzxb(out, out);
+  __ Bind(slow_path->GetExitLabel());
+}
+
+static void GenerateVarHandleGetAndAdd(HInvoke* invoke, CodeGeneratorX86_64* codegen) {
+  DataType::Type type = GetVarHandleInlineType(invoke, VarHandleAccessKind::kGetAndUpdate);
+  LocationSummary* locations = invoke->GetLocations();
+  size_t value_index = invoke->GetNumberOfArguments() - 1u;
+  CpuRegister value = locations->InAt(value_index).AsRegister<CpuRegister>();
+  CpuRegister out = locations->Out().AsRegister<CpuRegister>();
+
+  SlowPathCode* slow_path = new (codegen->GetScopedAllocator()) IntrinsicSlowPathX86_64(invoke);
+  codegen->AddSlowPath(slow_path);
+  Address address = GenerateVarHandleChecks(
+      invoke, codegen, slow_path, type, VarHandleAccessKind::kGetAndUpdate);
+
+  // LOCK XADD leaves the old value in `out` and has full barrier semantics.
+  if (type == DataType::Type::kInt32) {
+    __ movl(out, value);
+    __ LockXaddl(address, out);
+  } else {
+    __ movq(out, value);
+    __ LockXaddq(address, out);
+  }
+  __ Bind(slow_path->GetExitLabel());
+}
+
+#define VAR_HANDLE_INTRINSICS(V)                                                      \
+  V(VarHandleGet, kGet, GenerateVarHandleGet)                                         \
+  V(VarHandleGetOpaque, kGet, GenerateVarHandleGet)                                   \
+  V(VarHandleGetAcquire, kGet, GenerateVarHandleGet)                                  \
+  V(VarHandleGetVolatile, kGet, GenerateVarHandleGet)                                 \
+  V(VarHandleSet, kSet, GenerateVarHandleSet)                                         \
+  V(VarHandleSetOpaque, kSet, GenerateVarHandleSet)                                   \
+  V(VarHandleSetRelease, kSet, GenerateVarHandleSet)                                  \
+  V(VarHandleSetVolatile, kSet, GenerateVarHandleSet)                                 \
+  V(VarHandleCompareAndSet, kCompareAndSet, GenerateVarHandleCompareAndSet)           \
+  V(VarHandleWeakCompareAndSet, kCompareAndSet, GenerateVarHandleCompareAndSet)       \
+  V(VarHandleWeakCompareAndSetPlain, kCompareAndSet, GenerateVarHandleCompareAndSet)  \
+  V(VarHandleWeakCompareAndSetAcquire, kCompareAndSet, GenerateVarHandleCompareAndSet) \
+  V(VarHandleWeakCompareAndSetRelease, kCompareAndSet, GenerateVarHandleCompareAndSet) \
+  V(VarHandleGetAndAdd, kGetAndUpdate, GenerateVarHandleGetAndAdd)                    \
+  V(VarHandleGetAndAddAcquire, kGetAndUpdate, GenerateVarHandleGetAndAdd)             \
+  V(VarHandleGetAndAddRelease, kGetAndUpdate, GenerateVarHandleGetAndAdd)
+
+#define DEFINE_VAR_HANDLE_INTRINSIC(Name, Kind, Generator)                \
+void IntrinsicLocationsBuilderX86_64::Visit ## Name(HInvoke* invoke) {    \
+  CreateVarHandleLocations(invoke, allocator_, VarHandleAccessKind::Kind); \
+}                                                                         \
+void IntrinsicCodeGeneratorX86_64::Visit ## Name(HInvoke* invoke) {       \
+  Generator(invoke, codegen_);                                            \
+}
+VAR_HANDLE_INTRINSICS(DEFINE_VAR_HANDLE_INTRINSIC)
+#undef DEFINE_VAR_HANDLE_INTRINSIC
+#undef VAR_HANDLE_INTRINSICS
+
 UNIMPLEMENTED_INTRINSIC(X86_64, ReferenceGetReferent)
 UNIMPLEMENTED_INTRINSIC(X86_64, FloatIsInfinite)
 UNIMPLEMENTED_INTRINSIC(X86_64, DoubleIsInfinite)
 UNIMPLEMENTED_INTRINSIC(X86_64, CRC32Update)
 UNIMPLEMENTED_INTRINSIC(X86_64, CRC32UpdateBytes)
 UNIMPLEMENTED_INTRINSIC(X86_64, CRC32UpdateByteBuffer)
+UNIMPLEMENTED_INTRINSIC(X86_64, Adler32Update)
+UNIMPLEMENTED_INTRINSIC(X86_64, Adler32UpdateBytes)
+UNIMPLEMENTED_INTRINSIC(X86_64, Adler32UpdateByteBuffer)
 UNIMPLEMENTED_INTRINSIC(X86_64, FP16ToFloat)
 UNIMPLEMENTED_INTRINSIC(X86_64, FP16ToHalf)
 UNIMPLEMENTED_INTRINSIC(X86_64, FP16Floor)
@@ -2783,6 +3097,22 @@ UNIMPLEMENTED_INTRINSIC(X86_64, UnsafeGetAndSetInt)
 UNIMPLEMENTED_INTRINSIC(X86_64, UnsafeGetAndSetLong)
 UNIMPLEMENTED_INTRINSIC(X86_64, UnsafeGetAndSetObject)
 
+UNIMPLEMENTED_INTRINSIC(X86_64, VarHandleCompareAndExchange)
+UNIMPLEMENTED_INTRINSIC(X86_64, VarHandleCompareAndExchangeAcquire)
+UNIMPLEMENTED_INTRINSIC(X86_64, VarHandleCompareAndExchangeRelease)
+UNIMPLEMENTED_INTRINSIC(X86_64, VarHandleGetAndBitwiseAnd)
+UNIMPLEMENTED_INTRINSIC(X86_64, VarHandleGetAndBitwiseAndAcquire)
+UNIMPLEMENTED_INTRINSIC(X86_64, VarHandleGetAndBitwiseAndRelease)
+UNIMPLEMENTED_INTRINSIC(X86_64, VarHandleGetAndBitwiseOr)
+UNIMPLEMENTED_INTRINSIC(X86_64, VarHandleGetAndBitwiseOrAcquire)
+UNIMPLEMENTED_INTRINSIC(X86_64, VarHandleGetAndBitwiseOrRelease)
+UNIMPLEMENTED_INTRINSIC(X86_64, VarHandleGetAndBitwiseXor)
+UNIMPLEMENTED_INTRINSIC(X86_64, VarHandleGetAndBitwiseXorAcquire)
+UNIMPLEMENTED_INTRINSIC(X86_64, VarHandleGetAndBitwiseXorRelease)
+UNIMPLEMENTED_INTRINSIC(X86_64, VarHandleGetAndSet)
+UNIMPLEMENTED_INTRINSIC(X86_64, VarHandleGetAndSetAcquire)
+UNIMPLEMENTED_INTRINSIC(X86_64, VarHandleGetAndSetRelease)
+
 UNREACHABLE_INTRINSICS(X86_64)
 
 #undef __
@@ -78,6 +78,55 @@ static void UpdateLoopPhisIn(HEnvironment* environment, HLoopInformation* info)
   }
 }
 
+/**
+ * Returns the field information of `instruction` if it is a non-volatile field
+ * access, nullptr otherwise.
+ */
+static const FieldInfo* GetNonVolatileFieldInfo(HInstruction* instruction) {
+  const FieldInfo* field_info = nullptr;
+  if (instruction->IsInstanceFieldGet()) {
+    field_info = &instruction->AsInstanceFieldGet()->GetFieldInfo();
+  } else if (instruction->IsInstanceFieldSet()) {
+    field_info = &instruction->AsInstanceFieldSet()->GetFieldInfo();
+  } else if (instruction->IsStaticFieldGet()) {
+    field_info = &instruction->AsStaticFieldGet()->GetFieldInfo();
+  } else if (instruction->IsStaticFieldSet()) {
+    field_info = &instruction->AsStaticFieldSet()->GetFieldInfo();
+  }
+  return (field_info != nullptr && !field_info->IsVolatile()) ? field_info : nullptr;
+}
+
+/**
+ * Returns whether the field load `instruction` reads memory that is not written in
+ * the loop described by `info`, although the side effects summarized for the whole
+ * loop may say otherwise. Fields of the same type at different offsets never overlap,
+ * so stores to them are ignored; any other write that the load depends on is assumed
+ * to clobber it.
+ */
+static bool IsFieldLoadInvariantInLoop(HInstruction* instruction, HLoopInformation* info) {
+  const FieldInfo* load_info = GetNonVolatileFieldInfo(instruction);
+  if (load_info == nullptr || instruction->DoesAnyWrite()) {
+    return false;
+  }
+  SideEffects load_effects = instruction->GetSideEffects();
+  for (HBlocksInLoopIterator it_loop(*info); !it_loop.Done(); it_loop.Advance()) {
+    for (HInstructionIterator inst_it(it_loop.Current()->GetInstructions());
+         !inst_it.Done();
+         inst_it.Advance()) {
+      HInstruction* write = inst_it.Current();
+      if (!load_effects.MayDependOn(write->GetSideEffects())) {
+        continue;
+      }
+      const FieldInfo* store_info = GetNonVolatileFieldInfo(write);
+      if (store_info == nullptr ||
+          store_info->GetFieldOffset().SizeValue() == load_info->GetFieldOffset().SizeValue()) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
 bool LICM::Run() {
   bool didLICM = false;
   DCHECK(side_effects_.HasRun());
@@ -144,7 +193,8 @@ bool LICM::Run() {
                 can_move = true;
               }
             }
-          } else if (!instruction->GetSideEffects().MayDependOn(loop_effects)) {
+          } else if (!instruction->GetSideEffects().MayDependOn(loop_effects) ||
+                     IsFieldLoadInvariantInLoop(instruction, loop_info)) {
             can_move = true;
           }
         }
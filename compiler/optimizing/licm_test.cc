@@ -175,6 +175,33 @@ TEST_F(LICMTest, NoFieldHoisting) {
   EXPECT_EQ(set_field->GetBlock(), loop_body_);
 }
 
+TEST_F(LICMTest, FieldHoistingSameTypeDifferentOffset) {
+  BuildLoop();
+
+  // Populate the loop with instructions: set/get field with same types but different
+  // offsets, so the store cannot modify the loaded value.
+  HInstruction* get_field = new (GetAllocator()) HInstanceFieldGet(parameter_,
+                                                                   nullptr,
+                                                                   DataType::Type::kInt32,
+                                                                   MemberOffset(12),
+                                                                   false,
+                                                                   kUnknownFieldIndex,
+                                                                   kUnknownClassDefIndex,
+                                                                   graph_->GetDexFile(),
+                                                                   0);
+  loop_body_->InsertInstructionBefore(get_field, loop_body_->GetLastInstruction());
+  HInstruction* set_field = new (GetAllocator()) HInstanceFieldSet(
+      parameter_, int_constant_, nullptr, DataType::Type::kInt32, MemberOffset(20),
+      false, kUnknownFieldIndex, kUnknownClassDefIndex, graph_->GetDexFile(), 0);
+  loop_body_->InsertInstructionBefore(set_field, loop_body_->GetLastInstruction());
+
+  EXPECT_EQ(get_field->GetBlock(), loop_body_);
+  EXPECT_EQ(set_field->GetBlock(), loop_body_);
+  PerformLICM();
+  EXPECT_EQ(get_field->GetBlock(), loop_preheader_);
+  EXPECT_EQ(set_field->GetBlock(), loop_body_);
+}
+
 TEST_F(LICMTest, ArrayHoisting) {
   BuildLoop();
 
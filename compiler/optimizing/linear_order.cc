@@ -16,6 +16,7 @@
 
 #include "linear_order.h"
 
+#include "base/arena_bit_vector.h"
 #include "base/scoped_arena_allocator.h"
 #include "base/scoped_arena_containers.h"
 
@@ -36,6 +37,35 @@ static bool IsInnerLoop(HLoopInformation* outer, HLoopInformation* inner) {
       && inner->IsIn(*outer);
 }
 
+// Returns whether the block is unlikely to be executed: exception handlers and blocks that
+// end by throwing. The code generator emits blocks in linear order, so visiting these last
+// keeps the likely path together and moves them further away from it.
+static bool IsColdBlock(const HBasicBlock* block) {
+  return block->IsCatchBlock() || block->GetLastInstruction()->IsThrow();
+}
+
+// Marks the blocks that are unlikely to be executed, i.e. cold blocks (see IsColdBlock)
+// and blocks from which control flow can only reach cold blocks. Visiting the blocks
+// in post order sees the successors first, except for back edges, which conservatively
+// leave loop blocks hot.
+static void FindColdBlocks(const HGraph* graph, /*out*/ ArenaBitVector* cold_blocks) {
+  for (HBasicBlock* block : graph->GetPostOrder()) {
+    bool is_cold = IsColdBlock(block);
+    if (!is_cold && !block->GetSuccessors().empty() && !block->IsEntryBlock()) {
+      is_cold = true;
+      for (HBasicBlock* successor : block->GetSuccessors()) {
+        if (!cold_blocks->IsBitSet(successor->GetBlockId())) {
+          is_cold = false;
+          break;
+        }
+      }
+    }
+    if (is_cold) {
+      cold_blocks->SetBit(block->GetBlockId());
+    }
+  }
+}
+
 // Helper method to update work list for linear order.
 static void AddToListForLinearization(ScopedArenaVector<HBasicBlock*>* worklist,
                                       HBasicBlock* block) {
@@ -87,7 +117,8 @@ void LinearizeGraphInternal(const HGraph* graph, ArrayRef<HBasicBlock*> linear_o
   DCHECK_EQ(linear_order.size(), graph->GetReversePostOrder().size());
   // Create a reverse post ordering with the following properties:
   // - Blocks in a loop are consecutive,
-  // - Back-edge is the last block before loop exits.
+  // - Back-edge is the last block before loop exits,
+  // - Cold blocks (see FindColdBlocks) come after their sibling successors.
   //
   // (1): Record the number of forward predecessors for each block. This is to
   //      ensure the resulting order is reverse post order. We could use the
@@ -104,6 +135,9 @@ void LinearizeGraphInternal(const HGraph* graph, ArrayRef<HBasicBlock*> linear_o
     }
     forward_predecessors[block->GetBlockId()] = number_of_forward_predecessors;
   }
+  ArenaBitVector cold_blocks(
+      &allocator, graph->GetBlocks().size(), /* expandable= */ false, kArenaAllocLinearOrder);
+  FindColdBlocks(graph, &cold_blocks);
   // (2): Following a worklist approach, first start with the entry block, and
   //      iterate over the successors. When all non-back edge predecessors of a
   //      successor block are visited, the successor block is added in the worklist
@@ -116,13 +150,20 @@ void LinearizeGraphInternal(const HGraph* graph, ArrayRef<HBasicBlock*> linear_o
     worklist.pop_back();
     linear_order[num_added] = current;
     ++num_added;
-    for (HBasicBlock* successor : current->GetSuccessors()) {
-      int block_id = successor->GetBlockId();
-      size_t number_of_remaining_predecessors = forward_predecessors[block_id];
-      if (number_of_remaining_predecessors == 1) {
-        AddToListForLinearization(&worklist, successor);
+    // The worklist is processed from the back, so add the cold successors first to visit
+    // them after the other ones.
+    for (bool cold : {true, false}) {
+      for (HBasicBlock* successor : current->GetSuccessors()) {
+        if (cold_blocks.IsBitSet(successor->GetBlockId()) != cold) {
+          continue;
+        }
+        int block_id = successor->GetBlockId();
+        size_t number_of_remaining_predecessors = forward_predecessors[block_id];
+        if (number_of_remaining_predecessors == 1) {
+          AddToListForLinearization(&worklist, successor);
+        }
+        forward_predecessors[block_id] = number_of_remaining_predecessors - 1;
       }
-      forward_predecessors[block_id] = number_of_remaining_predecessors - 1;
     }
   } while (!worklist.empty());
   DCHECK_EQ(num_added, linear_order.size());
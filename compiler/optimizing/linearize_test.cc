@@ -242,4 +242,65 @@ TEST_F(LinearizeTest, CFG7) {
   TestCode(data, blocks);
 }
 
+TEST_F(LinearizeTest, ThrowingBlockLast) {
+  // Structure of this graph
+  //            Block0
+  //              |
+  //            Block1
+  //            /    \
+  //      (throw)    (return)
+  //            \    /
+  //             Exit
+  //
+  // The throwing block is the fall-through successor and would be visited first, but it is
+  // cold and must come after the returning block.
+  const std::vector<uint16_t> data = ONE_REGISTER_CODE_ITEM(
+    Instruction::CONST_4 | 0 | 0,
+    Instruction::IF_EQ, 3,
+    Instruction::THROW,
+    Instruction::RETURN_VOID);
+
+  HGraph* graph = CreateCFG(data);
+  std::unique_ptr<CodeGenerator> codegen = CodeGenerator::Create(graph, *compiler_options_);
+  SsaLivenessAnalysis liveness(graph, codegen.get(), GetScopedAllocator());
+  liveness.Analyze();
+
+  const ArenaVector<HBasicBlock*>& linear_order = graph->GetLinearOrder();
+  ASSERT_EQ(5u, linear_order.size());
+  EXPECT_TRUE(linear_order[2]->GetLastInstruction()->IsReturnVoid());
+  EXPECT_TRUE(linear_order[3]->GetLastInstruction()->IsThrow());
+  EXPECT_TRUE(linear_order[4]->IsExitBlock());
+}
+
+TEST_F(LinearizeTest, BlockLeadingToThrowLast) {
+  // Structure of this graph
+  //            Block0
+  //              |
+  //            Block1
+  //            /    \
+  //       (goto)    (return)
+  //          |        |
+  //       (throw)     |
+  //            \    /
+  //             Exit
+  //
+  // The block jumping to the throwing block can only reach cold code, so it is cold as
+  // well and must come after the returning block.
+  const std::vector<uint16_t> data = ONE_REGISTER_CODE_ITEM(
+    Instruction::CONST_4 | 0 | 0,
+    Instruction::IF_EQ, 4,
+    Instruction::GOTO | 0x100,
+    Instruction::THROW,
+    Instruction::RETURN_VOID);
+
+  HGraph* graph = CreateCFG(data);
+  std::unique_ptr<CodeGenerator> codegen = CodeGenerator::Create(graph, *compiler_options_);
+  SsaLivenessAnalysis liveness(graph, codegen.get(), GetScopedAllocator());
+  liveness.Analyze();
+
+  const ArenaVector<HBasicBlock*>& linear_order = graph->GetLinearOrder();
+  EXPECT_TRUE(linear_order[2]->GetLastInstruction()->IsReturnVoid());
+  EXPECT_TRUE(linear_order.back()->IsExitBlock());
+}
+
 }  // namespace art
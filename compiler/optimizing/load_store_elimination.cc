@@ -248,6 +248,7 @@ class LSEVisitor : public HGraphDelegateVisitor {
                       MethodCompilationStat::kConstructorFenceRemovedLSE,
                       removed);
 
+      RemoveUnusedAliases(new_instance);
       if (!new_instance->HasNonEnvironmentUses()) {
         new_instance->RemoveEnvironmentUsers();
         new_instance->GetBlock()->RemoveInstruction(new_instance);
@@ -256,6 +257,47 @@ class LSEVisitor : public HGraphDelegateVisitor {
   }
 
  private:
+  // Returns whether `reference` or one of its null check or bound type aliases
+  // is an environment local of `deoptimize`.
+  static bool IsVisibleAtDeoptimization(HInstruction* reference, HInstruction* deoptimize) {
+    for (const HUseListNode<HEnvironment*>& use : reference->GetEnvUses()) {
+      if (use.GetUser()->GetHolder() == deoptimize) {
+        return true;
+      }
+    }
+    for (const HUseListNode<HInstruction*>& use : reference->GetUses()) {
+      HInstruction* user = use.GetUser();
+      if ((user->IsNullCheck() || user->IsBoundType()) &&
+          IsVisibleAtDeoptimization(user, deoptimize)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Removes null checks and bound types of a singleton `reference` that are left
+  // without non-environment uses once its loads and stores have been eliminated.
+  // A null check of an allocation never throws, so it can be dropped as well.
+  static void RemoveUnusedAliases(HInstruction* reference) {
+    bool removed_alias;
+    do {
+      removed_alias = false;
+      for (const HUseListNode<HInstruction*>& use : reference->GetUses()) {
+        HInstruction* user = use.GetUser();
+        if (user->IsNullCheck() || user->IsBoundType()) {
+          RemoveUnusedAliases(user);
+          if (!user->HasNonEnvironmentUses()) {
+            user->RemoveEnvironmentUsers();
+            user->GetBlock()->RemoveInstruction(user);
+            // The use list has changed, start over.
+            removed_alias = true;
+            break;
+          }
+        }
+      }
+    } while (removed_alias);
+  }
+
   static bool IsLoad(const HInstruction* instruction) {
     if (instruction == kUnknownHeapValue || instruction == kDefaultHeapValue) {
       return false;
@@ -748,7 +790,8 @@ class LSEVisitor : public HGraphDelegateVisitor {
           KeepIfIsStore(heap_value);
           continue;
         }
-        HInstruction* reference = heap_value->InputAt(0);
+        HInstruction* reference =
+            heap_location_collector_.HuntForOriginalReference(heap_value->InputAt(0));
         if (heap_location_collector_.FindReferenceInfoOf(reference)->IsSingleton()) {
           if (reference->IsNewInstance() && reference->AsNewInstance()->IsFinalizable()) {
             // Finalizable objects alway escape.
@@ -758,14 +801,11 @@ class LSEVisitor : public HGraphDelegateVisitor {
           // Check whether the reference for a store is used by an environment local of
           // HDeoptimize. If not, the singleton is not observed after
           // deoptimizion.
-          for (const HUseListNode<HEnvironment*>& use : reference->GetEnvUses()) {
-            HEnvironment* user = use.GetUser();
-            if (user->GetHolder() == instruction) {
-              // The singleton for the store is visible at this deoptimization
-              // point. Need to keep the store so that the heap value is
-              // seen by the interpreter.
-              KeepIfIsStore(heap_value);
-            }
+          if (IsVisibleAtDeoptimization(reference, instruction)) {
+            // The singleton for the store is visible at this deoptimization
+            // point. Need to keep the store so that the heap value is
+            // seen by the interpreter.
+            KeepIfIsStore(heap_value);
           }
         } else {
           KeepIfIsStore(heap_value);
@@ -890,4 +890,38 @@ TEST_F(LoadStoreEliminationTest, VLoadDefaultValueAndVLoad) {
   ASSERT_FALSE(IsRemoved(vstore2));
 }
 
+// Check that a null check of a new array is looked through as an alias, so the array
+// is still a removable singleton and both the null check and the allocation go away.
+TEST_F(LoadStoreEliminationTest, ArrayGetSetThroughNullCheck) {
+  InitGraph();
+  CreateTestControlFlowGraph();
+
+  HInstruction* c0 = graph_->GetIntConstant(0);
+  HInstruction* c2 = graph_->GetIntConstant(2);
+  HInstruction* c128 = graph_->GetIntConstant(128);
+
+  HInstruction* array_a = new (GetAllocator()) HNewArray(c0, c128, 0, 0);
+  pre_header_->InsertInstructionBefore(array_a, pre_header_->GetLastInstruction());
+  array_a->CopyEnvironmentFrom(suspend_check_->GetEnvironment());
+  HInstruction* null_check = new (GetAllocator()) HNullCheck(array_a, 0);
+  pre_header_->InsertInstructionBefore(null_check, pre_header_->GetLastInstruction());
+  null_check->CopyEnvironmentFrom(suspend_check_->GetEnvironment());
+
+  // a[0] = 2     <--- Remove.
+  // v = a[0]     <--- Remove, replaced with 2.
+  // array[0] = v
+  HInstruction* store1 = AddArraySet(pre_header_, null_check, c0, c2);
+  HInstruction* load = AddArrayGet(pre_header_, null_check, c0);
+  HInstruction* store2 = AddArraySet(return_block_, array_, c0, load);
+
+  PerformLSE();
+
+  ASSERT_TRUE(IsRemoved(store1));
+  ASSERT_TRUE(IsRemoved(load));
+  ASSERT_FALSE(IsRemoved(store2));
+  ASSERT_EQ(store2->InputAt(2), c2);
+  ASSERT_TRUE(IsRemoved(null_check));
+  ASSERT_TRUE(IsRemoved(array_a));
+}
+
 }  // namespace art
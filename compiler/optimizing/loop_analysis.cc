@@ -101,7 +101,11 @@ class ArchDefaultLoopHelper : public ArchNoOptsLoopHelper {
       return LoopAnalysisInfo::kNoUnrollingFactor;
     }
     uint32_t desired_unrolling_factor = kScalarMaxUnrollFactor;
-    if (trip_count < desired_unrolling_factor || trip_count % desired_unrolling_factor != 0) {
+    if (trip_count < desired_unrolling_factor) {
+      return LoopAnalysisInfo::kNoUnrollingFactor;
+    }
+    // Remaining iterations are peeled off in front of the unrolled loop.
+    if (trip_count % desired_unrolling_factor != 0 && !IsLoopPeelingEnabled()) {
       return LoopAnalysisInfo::kNoUnrollingFactor;
     }
 
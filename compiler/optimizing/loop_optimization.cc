@@ -33,6 +33,10 @@ namespace art {
 // Enables vectorization (SIMDization) in the loop optimizer.
 static constexpr bool kEnableVectorization = true;
 
+// Maximum number of instructions, summed over all iterations, that an inner loop may
+// execute without a suspend check on its back edge. Bounds the suspension latency.
+static constexpr int64_t kMaxInstructionsWithoutSuspendCheck = 1024;
+
 //
 // Static helpers.
 //
@@ -362,6 +366,41 @@ static HVecReduce::ReductionKind GetReductionKind(HVecOperation* reduction) {
   UNREACHABLE();
 }
 
+// Detect a condition that can be evaluated exactly on packed data of the given
+// type, i.e. a signed (or equality) comparison of operands of exactly that type,
+// or of constants that fit that type.
+static bool IsVectorizableCondition(HInstruction* condition, DataType::Type type) {
+  if (!condition->IsCondition() || !DataType::IsIntegralType(type)) {
+    return false;
+  }
+  switch (condition->AsCondition()->GetCondition()) {
+    case kCondEQ:
+    case kCondNE:
+      break;
+    case kCondLT:
+    case kCondLE:
+    case kCondGT:
+    case kCondGE:
+      if (DataType::IsUnsignedType(type)) {
+        return false;  // no unsigned packed comparisons
+      }
+      break;
+    default:
+      return false;  // unsigned conditions
+  }
+  for (HInstruction* operand : condition->GetInputs()) {
+    int64_t value = 0;
+    if (IsInt64AndGet(operand, &value)) {
+      if (type != DataType::Type::kInt64 && !DataType::IsTypeConversionImplicit(value, type)) {
+        return false;
+      }
+    } else if (operand->GetType() != type) {
+      return false;
+    }
+  }
+  return true;
+}
+
 // Test vector restrictions.
 static bool HasVectorRestrictions(uint64_t restrictions, uint64_t tested) {
   return (restrictions & tested) != 0;
@@ -477,8 +516,9 @@ HLoopOptimization::HLoopOptimization(HGraph* graph,
       vector_refs_(nullptr),
       vector_static_peeling_factor_(0),
       vector_dynamic_peeling_candidate_(nullptr),
-      vector_runtime_test_a_(nullptr),
-      vector_runtime_test_b_(nullptr),
+      vector_runtime_test_a_(),
+      vector_runtime_test_b_(),
+      vector_runtime_test_count_(0),
       vector_map_(nullptr),
       vector_permanent_map_(nullptr),
       vector_mode_(kSequential),
@@ -781,9 +821,37 @@ bool HLoopOptimization::TryOptimizeInnerLoopFinite(LoopNode* node) {
 }
 
 bool HLoopOptimization::OptimizeInnerLoop(LoopNode* node) {
+  TryToOmitSuspendCheck(node);
   return TryOptimizeInnerLoopFinite(node) || TryPeelingAndUnrolling(node);
 }
 
+void HLoopOptimization::TryToOmitSuspendCheck(LoopNode* node) {
+  HLoopInformation* loop_info = node->loop_info;
+  // OSR entries are recorded at the loop suspend checks.
+  if (graph_->IsCompilingOsr() || !loop_info->HasSuspendCheck()) {
+    return;
+  }
+  int64_t trip_count = 0;
+  if (!induction_range_.HasKnownTripCount(loop_info, &trip_count) ||
+      trip_count > kMaxInstructionsWithoutSuspendCheck) {
+    return;
+  }
+  // Only omit the check if the total work of the loop is small, and does
+  // not include calls, whose duration we cannot bound.
+  int64_t instruction_count = 0;
+  for (HBlocksInLoopIterator it(*loop_info); !it.Done(); it.Advance()) {
+    for (HInstructionIterator it2(it.Current()->GetInstructions()); !it2.Done(); it2.Advance()) {
+      if (it2.Current()->IsInvoke()) {
+        return;
+      }
+      ++instruction_count;
+    }
+  }
+  if (trip_count * instruction_count <= kMaxInstructionsWithoutSuspendCheck) {
+    loop_info->GetSuspendCheck()->SetIsNoOp(true);
+  }
+}
+
 
 
 //
@@ -805,8 +873,18 @@ bool HLoopOptimization::TryUnrollingForBranchPenaltyReduction(LoopAnalysisInfo*
     // TODO: support other unrolling factors.
     DCHECK_EQ(unrolling_factor, 2u);
 
-    // Perform unrolling.
     HLoopInformation* loop_info = analysis_info->GetLoopInfo();
+
+    // Peel off the iterations which don't fit the unrolled loop, so that the trip count
+    // of the remaining loop is a multiple of the unrolling factor. The loop information
+    // is preserved by peeling.
+    int64_t remainder = analysis_info->GetTripCount() % unrolling_factor;
+    for (int64_t i = 0; i < remainder; ++i) {
+      PeelUnrollSimpleHelper peeling_helper(loop_info, &induction_range_);
+      peeling_helper.DoPeeling();
+    }
+
+    // Perform unrolling.
     PeelUnrollSimpleHelper helper(loop_info, &induction_range_);
     helper.DoUnrolling();
 
@@ -932,8 +1010,7 @@ bool HLoopOptimization::ShouldVectorize(LoopNode* node, HBasicBlock* block, int6
   vector_refs_->clear();
   vector_static_peeling_factor_ = 0;
   vector_dynamic_peeling_candidate_ = nullptr;
-  vector_runtime_test_a_ =
-  vector_runtime_test_b_ = nullptr;
+  vector_runtime_test_count_ = 0;
 
   // Phis in the loop-body prevent vectorization.
   if (!block->GetPhis().IsEmpty()) {
@@ -991,16 +1068,14 @@ bool HLoopOptimization::ShouldVectorize(LoopNode* node, HBasicBlock* block, int6
           // Found a[i+x] vs. b[i+y]. Accept if x == y (at worst loop-independent data dependence).
           // Conservatively assume a potential loop-carried data dependence otherwise, avoided by
           // generating an explicit a != b disambiguation runtime test on the two references.
-          if (x != y) {
-            // To avoid excessive overhead, we only accept one a != b test.
-            if (vector_runtime_test_a_ == nullptr) {
-              // First test found.
-              vector_runtime_test_a_ = a;
-              vector_runtime_test_b_ = b;
-            } else if ((vector_runtime_test_a_ != a || vector_runtime_test_b_ != b) &&
-                       (vector_runtime_test_a_ != b || vector_runtime_test_b_ != a)) {
-              return false;  // second test would be needed
+          if (x != y && !HasRuntimeTest(a, b)) {
+            // To avoid excessive overhead, we only accept a few a != b tests.
+            if (vector_runtime_test_count_ == kMaxVectorRuntimeTests) {
+              return false;  // another test would be needed
             }
+            vector_runtime_test_a_[vector_runtime_test_count_] = a;
+            vector_runtime_test_b_[vector_runtime_test_count_] = b;
+            vector_runtime_test_count_++;
           }
         }
       }
@@ -1129,12 +1204,12 @@ void HLoopOptimization::Vectorize(LoopNode* node,
   }
   vector_index_ = graph_->GetConstant(induc_type, 0);
 
-  // Generate runtime disambiguation test:
+  // Generate runtime disambiguation tests, one for each pair of references:
   // vtc = a != b ? vtc : 0;
-  if (vector_runtime_test_a_ != nullptr) {
+  for (uint32_t i = 0; i < vector_runtime_test_count_; ++i) {
     HInstruction* rt = Insert(
         preheader,
-        new (global_allocator_) HNotEqual(vector_runtime_test_a_, vector_runtime_test_b_));
+        new (global_allocator_) HNotEqual(vector_runtime_test_a_[i], vector_runtime_test_b_[i]));
     vtc = Insert(preheader,
                  new (global_allocator_)
                  HSelect(rt, vtc, graph_->GetConstant(induc_type, 0), kNoDexPc));
@@ -1540,6 +1615,36 @@ bool HLoopOptimization::VectorizeUse(LoopNode* node,
       }
       return true;
     }
+  } else if (instruction->IsSelect()) {
+    // Deal with vector restrictions.
+    HSelect* select = instruction->AsSelect();
+    HInstruction* condition = select->GetCondition();
+    if (HasVectorRestrictions(restrictions, kNoSelect) ||
+        node->loop_info->IsDefinedOutOfTheLoop(condition) ||
+        !IsVectorizableCondition(condition, type)) {
+      return false;
+    }
+    // Accept if-converted select for vectorizable condition operands and values.
+    HInstruction* opa = condition->InputAt(0);
+    HInstruction* opb = condition->InputAt(1);
+    HInstruction* false_value = select->GetFalseValue();
+    HInstruction* true_value = select->GetTrueValue();
+    if (VectorizeUse(node, opa, generate_code, type, restrictions) &&
+        VectorizeUse(node, opb, generate_code, type, restrictions) &&
+        VectorizeUse(node, false_value, generate_code, type, restrictions) &&
+        VectorizeUse(node, true_value, generate_code, type, restrictions)) {
+      if (generate_code) {
+        if (vector_map_->find(condition) == vector_map_->end()) {
+          GenerateVecOp(condition, vector_map_->Get(opa), vector_map_->Get(opb), type);
+        }
+        GenerateVecSelect(select,
+                          vector_map_->Get(false_value),
+                          vector_map_->Get(true_value),
+                          vector_map_->Get(condition),
+                          type);
+      }
+      return true;
+    }
   }
   return false;
 }
@@ -1549,6 +1654,10 @@ uint32_t HLoopOptimization::GetVectorSizeInBytes() {
     case InstructionSet::kArm:
     case InstructionSet::kThumb2:
       return 8;  // 64-bit SIMD
+    case InstructionSet::kArm64:
+      // The arm64 code generator emits NEON, even on SVE-capable cores
+      // whose vectors may be wider.
+      return 16;  // 128-bit SIMD
     default:
       return 16;  // 128-bit SIMD
   }
@@ -1565,14 +1674,14 @@ bool HLoopOptimization::TrySetVectorType(DataType::Type type, uint64_t* restrict
         case DataType::Type::kBool:
         case DataType::Type::kUint8:
         case DataType::Type::kInt8:
-          *restrictions |= kNoDiv | kNoReduction | kNoDotProd;
+          *restrictions |= kNoDiv | kNoReduction | kNoDotProd | kNoSelect;
           return TrySetVectorLength(8);
         case DataType::Type::kUint16:
         case DataType::Type::kInt16:
-          *restrictions |= kNoDiv | kNoStringCharAt | kNoReduction | kNoDotProd;
+          *restrictions |= kNoDiv | kNoStringCharAt | kNoReduction | kNoDotProd | kNoSelect;
           return TrySetVectorLength(4);
         case DataType::Type::kInt32:
-          *restrictions |= kNoDiv | kNoWideSAD;
+          *restrictions |= kNoDiv | kNoWideSAD | kNoSelect;
           return TrySetVectorLength(2);
         default:
           break;
@@ -1580,29 +1689,31 @@ bool HLoopOptimization::TrySetVectorType(DataType::Type type, uint64_t* restrict
       return false;
     case InstructionSet::kArm64:
       // Allow vectorization for all ARM devices, because Android assumes that
-      // ARMv8 AArch64 always supports advanced SIMD (128-bit SIMD).
+      // ARMv8 AArch64 always supports advanced SIMD (128-bit SIMD). The number of lanes
+      // is derived from the vector size, so that only GetVectorSizeInBytes() needs to know
+      // about the register width used by the code generator.
       switch (type) {
         case DataType::Type::kBool:
         case DataType::Type::kUint8:
         case DataType::Type::kInt8:
           *restrictions |= kNoDiv;
-          return TrySetVectorLength(16);
+          return TrySetVectorLength(GetVectorSizeInBytes() / DataType::Size(type));
         case DataType::Type::kUint16:
         case DataType::Type::kInt16:
           *restrictions |= kNoDiv;
-          return TrySetVectorLength(8);
+          return TrySetVectorLength(GetVectorSizeInBytes() / DataType::Size(type));
         case DataType::Type::kInt32:
           *restrictions |= kNoDiv;
-          return TrySetVectorLength(4);
+          return TrySetVectorLength(GetVectorSizeInBytes() / DataType::Size(type));
         case DataType::Type::kInt64:
           *restrictions |= kNoDiv | kNoMul;
-          return TrySetVectorLength(2);
+          return TrySetVectorLength(GetVectorSizeInBytes() / DataType::Size(type));
         case DataType::Type::kFloat32:
           *restrictions |= kNoReduction;
-          return TrySetVectorLength(4);
+          return TrySetVectorLength(GetVectorSizeInBytes() / DataType::Size(type));
         case DataType::Type::kFloat64:
           *restrictions |= kNoReduction;
-          return TrySetVectorLength(2);
+          return TrySetVectorLength(GetVectorSizeInBytes() / DataType::Size(type));
         default:
           return false;
       }
@@ -1624,19 +1735,27 @@ bool HLoopOptimization::TrySetVectorType(DataType::Type type, uint64_t* restrict
                              kNoDotProd;
             return TrySetVectorLength(16);
           case DataType::Type::kUint16:
-          case DataType::Type::kInt16:
             *restrictions |= kNoDiv |
                              kNoAbs |
                              kNoSignedHAdd |
                              kNoUnroundedHAdd |
-                             kNoSAD|
+                             kNoSAD |
                              kNoDotProd;
             return TrySetVectorLength(8);
+          case DataType::Type::kInt16:
+            // PMADDWD supports only the signed dot product.
+            *restrictions |= kNoDiv |
+                             kNoAbs |
+                             kNoSignedHAdd |
+                             kNoUnroundedHAdd |
+                             kNoSAD;
+            return TrySetVectorLength(8);
           case DataType::Type::kInt32:
             *restrictions |= kNoDiv | kNoSAD;
             return TrySetVectorLength(4);
           case DataType::Type::kInt64:
-            *restrictions |= kNoMul | kNoDiv | kNoShr | kNoAbs | kNoSAD;
+            // PCMPGTQ requires SSE4.2.
+            *restrictions |= kNoMul | kNoDiv | kNoShr | kNoAbs | kNoSAD | kNoSelect;
             return TrySetVectorLength(2);
           case DataType::Type::kFloat32:
             *restrictions |= kNoReduction;
@@ -1655,17 +1774,17 @@ bool HLoopOptimization::TrySetVectorType(DataType::Type type, uint64_t* restrict
           case DataType::Type::kBool:
           case DataType::Type::kUint8:
           case DataType::Type::kInt8:
-            *restrictions |= kNoDiv | kNoDotProd;
+            *restrictions |= kNoDiv | kNoDotProd | kNoSelect;
             return TrySetVectorLength(16);
           case DataType::Type::kUint16:
           case DataType::Type::kInt16:
-            *restrictions |= kNoDiv | kNoStringCharAt | kNoDotProd;
+            *restrictions |= kNoDiv | kNoStringCharAt | kNoDotProd | kNoSelect;
             return TrySetVectorLength(8);
           case DataType::Type::kInt32:
-            *restrictions |= kNoDiv;
+            *restrictions |= kNoDiv | kNoSelect;
             return TrySetVectorLength(4);
           case DataType::Type::kInt64:
-            *restrictions |= kNoDiv;
+            *restrictions |= kNoDiv | kNoSelect;
             return TrySetVectorLength(2);
           case DataType::Type::kFloat32:
             *restrictions |= kNoReduction;
@@ -1684,17 +1803,17 @@ bool HLoopOptimization::TrySetVectorType(DataType::Type type, uint64_t* restrict
           case DataType::Type::kBool:
           case DataType::Type::kUint8:
           case DataType::Type::kInt8:
-            *restrictions |= kNoDiv | kNoDotProd;
+            *restrictions |= kNoDiv | kNoDotProd | kNoSelect;
             return TrySetVectorLength(16);
           case DataType::Type::kUint16:
           case DataType::Type::kInt16:
-            *restrictions |= kNoDiv | kNoStringCharAt | kNoDotProd;
+            *restrictions |= kNoDiv | kNoStringCharAt | kNoDotProd | kNoSelect;
             return TrySetVectorLength(8);
           case DataType::Type::kInt32:
-            *restrictions |= kNoDiv;
+            *restrictions |= kNoDiv | kNoSelect;
             return TrySetVectorLength(4);
           case DataType::Type::kInt64:
-            *restrictions |= kNoDiv;
+            *restrictions |= kNoDiv | kNoSelect;
             return TrySetVectorLength(2);
           case DataType::Type::kFloat32:
             *restrictions |= kNoReduction;
@@ -1995,6 +2114,36 @@ void HLoopOptimization::GenerateVecOp(HInstruction* org,
       GENERATE_VEC(
         new (global_allocator_) HVecAbs(global_allocator_, opa, type, vector_length_, dex_pc),
         new (global_allocator_) HAbs(org_type, opa, dex_pc));
+    case HInstruction::kEqual:
+      GENERATE_VEC(
+        new (global_allocator_) HVecCondition(
+            global_allocator_, opa, opb, kCondEQ, type, vector_length_, dex_pc),
+        new (global_allocator_) HEqual(opa, opb, dex_pc));
+    case HInstruction::kNotEqual:
+      GENERATE_VEC(
+        new (global_allocator_) HVecCondition(
+            global_allocator_, opa, opb, kCondNE, type, vector_length_, dex_pc),
+        new (global_allocator_) HNotEqual(opa, opb, dex_pc));
+    case HInstruction::kLessThan:
+      GENERATE_VEC(
+        new (global_allocator_) HVecCondition(
+            global_allocator_, opa, opb, kCondLT, type, vector_length_, dex_pc),
+        new (global_allocator_) HLessThan(opa, opb, dex_pc));
+    case HInstruction::kLessThanOrEqual:
+      GENERATE_VEC(
+        new (global_allocator_) HVecCondition(
+            global_allocator_, opa, opb, kCondLE, type, vector_length_, dex_pc),
+        new (global_allocator_) HLessThanOrEqual(opa, opb, dex_pc));
+    case HInstruction::kGreaterThan:
+      GENERATE_VEC(
+        new (global_allocator_) HVecCondition(
+            global_allocator_, opa, opb, kCondGT, type, vector_length_, dex_pc),
+        new (global_allocator_) HGreaterThan(opa, opb, dex_pc));
+    case HInstruction::kGreaterThanOrEqual:
+      GENERATE_VEC(
+        new (global_allocator_) HVecCondition(
+            global_allocator_, opa, opb, kCondGE, type, vector_length_, dex_pc),
+        new (global_allocator_) HGreaterThanOrEqual(opa, opb, dex_pc));
     default:
       break;
   }  // switch
@@ -2002,6 +2151,23 @@ void HLoopOptimization::GenerateVecOp(HInstruction* org,
   vector_map_->Put(org, vector);
 }
 
+void HLoopOptimization::GenerateVecSelect(HSelect* org,
+                                          HInstruction* opa,
+                                          HInstruction* opb,
+                                          HInstruction* opc,
+                                          DataType::Type type) {
+  uint32_t dex_pc = org->GetDexPc();
+  HInstruction* vector = nullptr;
+  if (vector_mode_ == kVector) {
+    vector = new (global_allocator_) HVecSelect(
+        global_allocator_, opa, opb, opc, type, vector_length_, dex_pc);
+  } else {
+    DCHECK(vector_mode_ == kSequential);
+    vector = new (global_allocator_) HSelect(opc, opb, opa, dex_pc);
+  }
+  vector_map_->Put(org, vector);
+}
+
 #undef GENERATE_VEC
 
 //
@@ -2269,6 +2435,16 @@ uint32_t HLoopOptimization::MaxNumberPeeled() {
   return vector_static_peeling_factor_;  // known exactly
 }
 
+bool HLoopOptimization::HasRuntimeTest(HInstruction* a, HInstruction* b) const {
+  for (uint32_t i = 0; i < vector_runtime_test_count_; ++i) {
+    if ((vector_runtime_test_a_[i] == a && vector_runtime_test_b_[i] == b) ||
+        (vector_runtime_test_a_[i] == b && vector_runtime_test_b_[i] == a)) {
+      return true;
+    }
+  }
+  return false;
+}
+
 bool HLoopOptimization::IsVectorizationProfitable(int64_t trip_count) {
   // Current heuristic: non-empty body with sufficient number of iterations (if known).
   // TODO: refine by looking at e.g. operation count, alignment, etc.
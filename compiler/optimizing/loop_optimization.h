@@ -48,6 +48,9 @@ class HLoopOptimization : public HOptimization {
   static constexpr const char* kLoopOptimizationPassName = "loop_optimization";
 
  private:
+  // Maximum number of a != b disambiguation tests guarding a vector loop.
+  static constexpr uint32_t kMaxVectorRuntimeTests = 4;
+
   /**
    * A single loop inside the loop hierarchy representation.
    */
@@ -83,6 +86,7 @@ class HLoopOptimization : public HOptimization {
     kNoSAD           = 1 << 10,  // no sum of absolute differences (SAD)
     kNoWideSAD       = 1 << 11,  // no sum of absolute differences (SAD) with operand widening
     kNoDotProd       = 1 << 12,  // no dot product
+    kNoSelect        = 1 << 13,  // no if-converted select
   };
 
   /*
@@ -144,6 +148,10 @@ class HLoopOptimization : public HOptimization {
   // Performs optimizations specific to inner loop. Returns true if anything changed.
   bool OptimizeInnerLoop(LoopNode* node);
 
+  // Omits the back edge suspend check of an inner loop with a small known trip count
+  // and a small body without calls, so that the suspension latency remains bounded.
+  void TryToOmitSuspendCheck(LoopNode* node);
+
   // Tries to apply loop unrolling for branch penalty reduction and better instruction scheduling
   // opportunities. Returns whether transformation happened. 'generate_code' determines whether the
   // optimization should be actually applied.
@@ -201,6 +209,11 @@ class HLoopOptimization : public HOptimization {
                      HInstruction* opa,
                      HInstruction* opb,
                      DataType::Type type);
+  void GenerateVecSelect(HSelect* org,
+                         HInstruction* opa,
+                         HInstruction* opb,
+                         HInstruction* opc,
+                         DataType::Type type);
 
   // Vectorization idioms.
   bool VectorizeSaturationIdiom(LoopNode* node,
@@ -233,6 +246,7 @@ class HLoopOptimization : public HOptimization {
                             const ArrayReference* peeling_candidate);
   uint32_t MaxNumberPeeled();
   bool IsVectorizationProfitable(int64_t trip_count);
+  bool HasRuntimeTest(HInstruction* a, HInstruction* b) const;
 
   //
   // Helpers.
@@ -305,9 +319,10 @@ class HLoopOptimization : public HOptimization {
   uint32_t vector_static_peeling_factor_;
   const ArrayReference* vector_dynamic_peeling_candidate_;
 
-  // Dynamic data dependence test of the form a != b.
-  HInstruction* vector_runtime_test_a_;
-  HInstruction* vector_runtime_test_b_;
+  // Dynamic data dependence tests of the form a != b.
+  HInstruction* vector_runtime_test_a_[kMaxVectorRuntimeTests];
+  HInstruction* vector_runtime_test_b_[kMaxVectorRuntimeTests];
+  uint32_t vector_runtime_test_count_;
 
   // Mapping used during vectorization synthesis for both the scalar peeling/cleanup
   // loop (mode is kSequential) and the actual vector loop (mode is kVector). The data
@@ -3256,6 +3256,21 @@ void HInvoke::SetResolvedMethod(ArtMethod* method) {
   resolved_method_ = method;
 }
 
+void HInvokePolymorphic::SetIntrinsicFromAccessor(ArtMethod* accessor) {
+  if (!accessor->IsPolymorphicSignature() || !accessor->IsIntrinsic()) {
+    return;
+  }
+  Intrinsics intrinsic = static_cast<Intrinsics>(accessor->GetIntrinsic());
+  if (intrinsic == Intrinsics::kMethodHandleInvoke ||
+      intrinsic == Intrinsics::kMethodHandleInvokeExact) {
+    return;
+  }
+  SetIntrinsic(intrinsic,
+               NeedsEnvironmentOrCacheIntrinsic(intrinsic),
+               GetSideEffectsIntrinsic(intrinsic),
+               GetExceptionsIntrinsic(intrinsic));
+}
+
 bool IsGEZero(HInstruction* instruction) {
   DCHECK(instruction != nullptr);
   if (instruction->IsArrayLength()) {
@@ -357,6 +357,8 @@ class HGraph : public ArenaObject<kArenaAllocGraph> {
         art_method_(nullptr),
         inexact_object_rti_(ReferenceTypeInfo::CreateInvalid()),
         osr_(osr),
+        compiling_baseline_(false),
+        disabled_speculations_(0u),
         cha_single_implementation_list_(allocator->Adapter(kArenaAllocCHA)) {
     blocks_.reserve(kDefaultNumberOfBlocks);
   }
@@ -587,6 +589,17 @@ class HGraph : public ArenaObject<kArenaAllocGraph> {
 
   bool IsCompilingOsr() const { return osr_; }
 
+  bool IsCompilingBaseline() const { return compiling_baseline_; }
+  void SetCompilingBaseline(bool value) { compiling_baseline_ = value; }
+
+  // Whether the compiled code may speculate and deoptimize with `kind`.
+  bool CanSpeculate(DeoptimizationKind kind) const {
+    return (disabled_speculations_ & (1u << static_cast<uint32_t>(kind))) == 0u;
+  }
+  void DisableSpeculation(DeoptimizationKind kind) {
+    disabled_speculations_ |= 1u << static_cast<uint32_t>(kind);
+  }
+
   ArenaSet<ArtMethod*>& GetCHASingleImplementationList() {
     return cha_single_implementation_list_;
   }
@@ -780,6 +793,16 @@ class HGraph : public ArenaObject<kArenaAllocGraph> {
   // compiled code entries which the interpreter can directly jump to.
   const bool osr_;
 
+  // Whether we are compiling this graph with the baseline compiler: this runs a minimal set of
+  // optimizations and makes the generated code count the hotness of the method.
+  bool compiling_baseline_;
+
+  // Bit mask of the DeoptimizationKinds the compiled code must not speculate with, because
+  // the previous compiled code of the method deoptimized too often with them.
+  uint32_t disabled_speculations_;
+  static_assert(static_cast<size_t>(DeoptimizationKind::kLast) < 32u,
+                "Too many deoptimization kinds for the speculation mask");
+
   // List of methods that are assumed to have single implementation.
   ArenaSet<ArtMethod*> cha_single_implementation_list_;
 
@@ -1483,6 +1506,8 @@ class HLoopInformationOutwardIterator : public ValueObject {
   M(VecShl, VecBinaryOperation)                                         \
   M(VecShr, VecBinaryOperation)                                         \
   M(VecUShr, VecBinaryOperation)                                        \
+  M(VecCondition, VecBinaryOperation)                                   \
+  M(VecSelect, VecOperation)                                            \
   M(VecSetScalars, VecOperation)                                        \
   M(VecMultiplyAccumulate, VecOperation)                                \
   M(VecSADAccumulate, VecOperation)                                     \
@@ -4447,7 +4472,9 @@ class HInvokePolymorphic final : public HInvoke {
                      uint32_t number_of_arguments,
                      DataType::Type return_type,
                      uint32_t dex_pc,
-                     uint32_t dex_method_index)
+                     uint32_t dex_method_index,
+                     const DexFile& dex_file,
+                     dex::ProtoIndex proto_idx)
       : HInvoke(kInvokePolymorphic,
                 allocator,
                 number_of_arguments,
@@ -4456,15 +4483,29 @@ class HInvokePolymorphic final : public HInvoke {
                 dex_pc,
                 dex_method_index,
                 nullptr,
-                kVirtual) {
+                kVirtual),
+        dex_file_(dex_file),
+        proto_idx_(proto_idx) {
   }
 
   bool IsClonable() const override { return true; }
 
+  // The shorty of the call site, without the receiver.
+  const char* GetShorty() const { return dex_file_.GetShorty(proto_idx_); }
+
+  // Record the intrinsic of `accessor`, the resolved signature polymorphic method, if it is
+  // a VarHandle accessor. The resolved method itself is not recorded, as it does not describe
+  // the call site.
+  void SetIntrinsicFromAccessor(ArtMethod* accessor) REQUIRES_SHARED(Locks::mutator_lock_);
+
   DECLARE_INSTRUCTION(InvokePolymorphic);
 
  protected:
   DEFAULT_COPY_CONSTRUCTOR(InvokePolymorphic);
+
+ private:
+  const DexFile& dex_file_;
+  const dex::ProtoIndex proto_idx_;
 };
 
 class HInvokeCustom final : public HInvoke {
@@ -6213,6 +6254,7 @@ class HSuspendCheck final : public HExpression<0> {
   explicit HSuspendCheck(uint32_t dex_pc = kNoDexPc)
       : HExpression(kSuspendCheck, SideEffects::CanTriggerGC(), dex_pc),
         slow_path_(nullptr) {
+    SetPackedFlag<kFlagIsNoOp>(false);
   }
 
   bool IsClonable() const override { return true; }
@@ -6224,12 +6266,22 @@ class HSuspendCheck final : public HExpression<0> {
   void SetSlowPath(SlowPathCode* slow_path) { slow_path_ = slow_path; }
   SlowPathCode* GetSlowPath() const { return slow_path_; }
 
+  // A no-op suspend check stays in the loop header, as required for a loop in HIR,
+  // but no code is emitted for it on the back edges.
+  bool IsNoOp() const { return GetPackedFlag<kFlagIsNoOp>(); }
+  void SetIsNoOp(bool is_no_op) { SetPackedFlag<kFlagIsNoOp>(is_no_op); }
+
   DECLARE_INSTRUCTION(SuspendCheck);
 
  protected:
   DEFAULT_COPY_CONSTRUCTOR(SuspendCheck);
 
  private:
+  static constexpr size_t kFlagIsNoOp = kNumberOfGenericPackedBits;
+  static constexpr size_t kNumberOfSuspendCheckPackedBits = kFlagIsNoOp + 1;
+  static_assert(kNumberOfSuspendCheckPackedBits <= kMaxNumberOfPackedBits,
+                "Too many packed fields.");
+
   // Only used for code generation, in order to share the same slow path between back edges
   // of a same loop.
   SlowPathCode* slow_path_;
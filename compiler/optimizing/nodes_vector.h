@@ -891,6 +891,91 @@ class HVecUShr final : public HVecBinaryOperation {
   DEFAULT_COPY_CONSTRUCTOR(VecUShr);
 };
 
+// Compares every component in the two vectors, yielding a mask of all ones
+// for true and all zeros for false in the corresponding component,
+// viz. [ x1, .. , xn ] cond [ y1, .. , yn ] = [ x1 cond y1 ? -1 : 0, .. , xn cond yn ? -1 : 0 ].
+// Only signed conditions are supported; EQ and NE also apply to unsigned operands.
+class HVecCondition final : public HVecBinaryOperation {
+ public:
+  HVecCondition(ArenaAllocator* allocator,
+                HInstruction* left,
+                HInstruction* right,
+                IfCondition condition,
+                DataType::Type packed_type,
+                size_t vector_length,
+                uint32_t dex_pc)
+      : HVecBinaryOperation(kVecCondition,
+                            allocator,
+                            left,
+                            right,
+                            packed_type,
+                            vector_length,
+                            dex_pc),
+        condition_(condition) {
+    DCHECK(HasConsistentPackedTypes(left, packed_type));
+    DCHECK(HasConsistentPackedTypes(right, packed_type));
+    DCHECK(DataType::IsIntegralType(packed_type));
+    DCHECK(condition == kCondEQ || condition == kCondNE || !DataType::IsUnsignedType(packed_type));
+  }
+
+  IfCondition GetCondition() const { return condition_; }
+
+  bool CanBeMoved() const override { return true; }
+
+  bool InstructionDataEquals(const HInstruction* other) const override {
+    DCHECK(other->IsVecCondition());
+    const HVecCondition* o = other->AsVecCondition();
+    return HVecOperation::InstructionDataEquals(o) && GetCondition() == o->GetCondition();
+  }
+
+  DECLARE_INSTRUCTION(VecCondition);
+
+ protected:
+  DEFAULT_COPY_CONSTRUCTOR(VecCondition);
+
+ private:
+  const IfCondition condition_;
+};
+
+// Selects every component from one of the two vectors under the given mask,
+// viz. select([ x1, .. , xn ], [ y1, .. , yn ], [ m1, .. , mn ]) = [ m1 ? y1 : x1, .. , mn ? yn : xn ]
+// where the mask is produced by HVecCondition. As for HSelect, the false value comes first.
+class HVecSelect final : public HVecOperation {
+ public:
+  HVecSelect(ArenaAllocator* allocator,
+             HInstruction* false_value,
+             HInstruction* true_value,
+             HInstruction* mask,
+             DataType::Type packed_type,
+             size_t vector_length,
+             uint32_t dex_pc)
+      : HVecOperation(kVecSelect,
+                      allocator,
+                      packed_type,
+                      SideEffects::None(),
+                      /* number_of_inputs= */ 3,
+                      vector_length,
+                      dex_pc) {
+    DCHECK(HasConsistentPackedTypes(false_value, packed_type));
+    DCHECK(HasConsistentPackedTypes(true_value, packed_type));
+    DCHECK(mask->IsVecCondition());
+    SetRawInputAt(0, false_value);
+    SetRawInputAt(1, true_value);
+    SetRawInputAt(2, mask);
+  }
+
+  HInstruction* GetFalseValue() const { return InputAt(0); }
+  HInstruction* GetTrueValue() const { return InputAt(1); }
+  HInstruction* GetMask() const { return InputAt(2); }
+
+  bool CanBeMoved() const override { return true; }
+
+  DECLARE_INSTRUCTION(VecSelect);
+
+ protected:
+  DEFAULT_COPY_CONSTRUCTOR(VecSelect);
+};
+
 //
 // Definitions of concrete miscellaneous vector operations in HIR.
 //
@@ -51,6 +51,7 @@
 #include "jit/jit.h"
 #include "jit/jit_code_cache.h"
 #include "jit/jit_logger.h"
+#include "jit/profiling_info.h"
 #include "jni/quick/jni_compiler.h"
 #include "linker/linker_patch.h"
 #include "nodes.h"
@@ -72,6 +73,31 @@ static constexpr size_t kArenaAllocatorMemoryReportThreshold = 8 * MB;
 
 static constexpr const char* kPassNameSeparator = "$";
 
+// Number of deoptimizations of a kind after which the JIT stops speculating with that kind when
+// recompiling the method.
+static constexpr uint8_t kMaxSpeculationFailures = 3;
+
+// Returns whether `pass` is an optional optimization that may be skipped once
+// the compilation of a method exceeds its --compile-time-budget-ms. Passes that
+// others rely on to produce correct code (for example the simplifier merging
+// HClinitCheck or the architecture specific fixups) are never skipped.
+static bool IsExpensivePass(OptimizationPass pass) {
+  switch (pass) {
+    case OptimizationPass::kBoundsCheckElimination:
+    case OptimizationPass::kCodeSinking:
+    case OptimizationPass::kGlobalValueNumbering:
+    case OptimizationPass::kInductionVarAnalysis:
+    case OptimizationPass::kInliner:
+    case OptimizationPass::kInvariantCodeMotion:
+    case OptimizationPass::kLoadStoreAnalysis:
+    case OptimizationPass::kLoadStoreElimination:
+    case OptimizationPass::kLoopOptimization:
+      return true;
+    default:
+      return false;
+  }
+}
+
 /**
  * Used by the code generator, to allocate the code in a vector.
  */
@@ -108,12 +134,16 @@ class PassObserver : public ValueObject {
                CodeGenerator* codegen,
                std::ostream* visualizer_output,
                const CompilerOptions& compiler_options,
-               Mutex& dump_mutex)
+               Mutex& dump_mutex,
+               CumulativeLogger* cumulative_timings)
       : graph_(graph),
         last_seen_graph_size_(0),
         cached_method_name_(),
+        start_time_ns_(NanoTime()),
+        compile_time_budget_ns_(MsToNs(compiler_options.GetCompileTimeBudgetMs())),
         timing_logger_enabled_(compiler_options.GetDumpPassTimings()),
         timing_logger_(timing_logger_enabled_ ? GetMethodName() : "", true, true),
+        cumulative_timings_(cumulative_timings),
         disasm_info_(graph->GetAllocator()),
         visualizer_oss_(),
         visualizer_output_(visualizer_output),
@@ -136,6 +166,14 @@ class PassObserver : public ValueObject {
     if (timing_logger_enabled_) {
       LOG(INFO) << "TIMINGS " << GetMethodName();
       LOG(INFO) << Dumpable<TimingLogger>(timing_logger_);
+      // Also accumulate the pass timings over all compiled methods. The JIT reports
+      // them with its own timings in Jit::DumpInfo().
+      Runtime* runtime = Runtime::Current();
+      if (runtime != nullptr && runtime->GetJit() != nullptr) {
+        runtime->GetJit()->AddTimingLogger(timing_logger_);
+      } else if (cumulative_timings_ != nullptr) {
+        cumulative_timings_->AddLogger(timing_logger_);
+      }
     }
     DCHECK(visualizer_oss_.str().empty());
   }
@@ -149,6 +187,12 @@ class PassObserver : public ValueObject {
 
   void SetGraphInBadState() { graph_in_bad_state_ = true; }
 
+  // Returns whether the compilation of this method has been running for longer
+  // than the --compile-time-budget-ms, if any.
+  bool IsOverCompileTimeBudget() const {
+    return compile_time_budget_ns_ != 0u && NanoTime() - start_time_ns_ > compile_time_budget_ns_;
+  }
+
   const char* GetMethodName() {
     // PrettyMethod() is expensive, so we delay calling it until we actually have to.
     if (cached_method_name_.empty()) {
@@ -222,8 +266,12 @@ class PassObserver : public ValueObject {
 
   std::string cached_method_name_;
 
+  const uint64_t start_time_ns_;
+  const uint64_t compile_time_budget_ns_;
+
   bool timing_logger_enabled_;
   TimingLogger timing_logger_;
+  CumulativeLogger* const cumulative_timings_;
 
   DisassemblyInformation disasm_info_;
 
@@ -327,7 +375,12 @@ class OptimizingCompiler final : public Compiler {
     pass_changes[static_cast<size_t>(OptimizationPass::kNone)] = true;
     bool change = false;
     for (size_t i = 0; i < length; ++i) {
-      if (pass_changes[static_cast<size_t>(definitions[i].depends_on)]) {
+      if (IsExpensivePass(definitions[i].pass) && pass_observer->IsOverCompileTimeBudget()) {
+        // Keep the remaining compile time bounded, the pass is not needed for correctness.
+        MaybeRecordStat(compilation_stats_.get(),
+                        MethodCompilationStat::kPassSkippedOverCompileTimeBudget);
+        pass_changes[static_cast<size_t>(definitions[i].pass)] = false;
+      } else if (pass_changes[static_cast<size_t>(definitions[i].depends_on)]) {
         // Execute the pass and record whether it changed anything.
         PassScope scope(optimizations[i]->GetPassName(), pass_observer);
         bool pass_change = optimizations[i]->Run();
@@ -410,6 +463,9 @@ class OptimizingCompiler final : public Compiler {
 
   std::unique_ptr<OptimizingCompilerStats> compilation_stats_;
 
+  // Pass timings accumulated over all methods compiled by dex2oat for --dump-pass-timings.
+  std::unique_ptr<CumulativeLogger> pass_timings_;
+
   std::unique_ptr<std::ostream> visualizer_output_;
 
   mutable Mutex dump_mutex_;  // To synchronize visualizer writing.
@@ -433,12 +489,18 @@ OptimizingCompiler::OptimizingCompiler(const CompilerOptions& compiler_options,
   if (compiler_options.GetDumpStats()) {
     compilation_stats_.reset(new OptimizingCompilerStats());
   }
+  if (compiler_options.GetDumpPassTimings()) {
+    pass_timings_.reset(new CumulativeLogger("Optimizing pass timings"));
+  }
 }
 
 OptimizingCompiler::~OptimizingCompiler() {
   if (compilation_stats_.get() != nullptr) {
     compilation_stats_->Log();
   }
+  if (pass_timings_ != nullptr && pass_timings_->GetIterations() != 0u) {
+    LOG(INFO) << Dumpable<CumulativeLogger>(*pass_timings_);
+  }
 }
 
 bool OptimizingCompiler::CanCompileMethod(uint32_t method_idx ATTRIBUTE_UNUSED,
@@ -850,11 +912,26 @@ CodeGenerator* OptimizingCompiler::TryCompile(ArenaAllocator* allocator,
       dead_reference_safe,
       compiler_options.GetDebuggable(),
       /* osr= */ osr);
+  graph->SetCompilingBaseline(baseline);
 
   if (method != nullptr) {
     graph->SetArtMethod(method);
   }
 
+  if (method != nullptr && !Runtime::Current()->IsAotCompiler()) {
+    // The profiling info cannot go away while the method is being compiled.
+    ScopedObjectAccess soa(Thread::Current());
+    ProfilingInfo* info = method->GetProfilingInfo(kRuntimePointerSize);
+    if (info != nullptr) {
+      for (size_t i = 0; i <= static_cast<size_t>(DeoptimizationKind::kLast); ++i) {
+        DeoptimizationKind kind = static_cast<DeoptimizationKind>(i);
+        if (info->GetDeoptimizationCount(kind) >= kMaxSpeculationFailures) {
+          graph->DisableSpeculation(kind);
+        }
+      }
+    }
+  }
+
   std::unique_ptr<CodeGenerator> codegen(
       CodeGenerator::Create(graph,
                             compiler_options,
@@ -869,7 +946,8 @@ CodeGenerator* OptimizingCompiler::TryCompile(ArenaAllocator* allocator,
                              codegen.get(),
                              visualizer_output_.get(),
                              compiler_options,
-                             dump_mutex_);
+                             dump_mutex_,
+                             pass_timings_.get());
 
   {
     VLOG(compiler) << "Building " << pass_observer.GetMethodName();
@@ -929,8 +1007,10 @@ CodeGenerator* OptimizingCompiler::TryCompile(ArenaAllocator* allocator,
     RunOptimizations(graph, codegen.get(), dex_compilation_unit, &pass_observer, handles);
   }
 
-  RegisterAllocator::Strategy regalloc_strategy =
-    compiler_options.GetRegisterAllocationStrategy();
+  // The baseline compiler favors compilation speed, use the linear scan register allocator.
+  RegisterAllocator::Strategy regalloc_strategy = baseline
+      ? RegisterAllocator::kRegisterAllocatorLinearScan
+      : compiler_options.GetRegisterAllocationStrategy();
   AllocateRegisters(graph,
                     codegen.get(),
                     &pass_observer,
@@ -994,7 +1074,8 @@ CodeGenerator* OptimizingCompiler::TryCompileIntrinsic(
                              codegen.get(),
                              visualizer_output_.get(),
                              compiler_options,
-                             dump_mutex_);
+                             dump_mutex_,
+                             pass_timings_.get());
 
   {
     VLOG(compiler) << "Building intrinsic graph " << pass_observer.GetMethodName();
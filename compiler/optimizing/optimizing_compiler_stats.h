@@ -38,6 +38,7 @@ enum class MethodCompilationStat {
   kCHAInline,
   kInlinedInvoke,
   kReplacedInvokeWithSimplePattern,
+  kReplacedConstantMethodHandleInvoke,
   kInstructionSimplifications,
   kInstructionSimplificationsArch,
   kUnresolvedMethod,
@@ -104,6 +105,7 @@ enum class MethodCompilationStat {
   kConstructorFenceRemovedCFRE,
   kBitstringTypeCheck,
   kJitOutOfMemoryForCommit,
+  kPassSkippedOverCompileTimeBudget,
   kLastStat
 };
 std::ostream& operator<<(std::ostream& os, const MethodCompilationStat& rhs);
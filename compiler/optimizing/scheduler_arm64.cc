@@ -307,6 +307,14 @@ void SchedulingLatencyVisitorARM64::VisitVecUShr(HVecUShr* instr) {
   HandleSimpleArithmeticSIMD(instr);
 }
 
+void SchedulingLatencyVisitorARM64::VisitVecCondition(HVecCondition* instr ATTRIBUTE_UNUSED) {
+  last_visited_latency_ = kArm64SIMDIntegerOpLatency;
+}
+
+void SchedulingLatencyVisitorARM64::VisitVecSelect(HVecSelect* instr ATTRIBUTE_UNUSED) {
+  last_visited_latency_ = kArm64SIMDIntegerOpLatency;
+}
+
 void SchedulingLatencyVisitorARM64::VisitVecSetScalars(HVecSetScalars* instr) {
   HandleSimpleArithmeticSIMD(instr);
 }
@@ -16,6 +16,7 @@
 
 #include "ssa_liveness_analysis.h"
 
+#include "base/arena_bit_vector.h"
 #include "base/bit_vector-inl.h"
 #include "code_generator.h"
 #include "linear_order.h"
@@ -270,22 +271,38 @@ void SsaLivenessAnalysis::ComputeLiveRanges() {
 }
 
 void SsaLivenessAnalysis::ComputeLiveInAndLiveOutSets() {
-  bool changed;
-  do {
-    changed = false;
-
-    for (const HBasicBlock* block : graph_->GetPostOrder()) {
-      // The live_in set depends on the kill set (which does not
-      // change in this loop), and the live_out set.  If the live_out
-      // set does not change, there is no need to update the live_in set.
-      if (UpdateLiveOut(*block) && UpdateLiveIn(*block)) {
-        if (kIsDebugBuild) {
-          CheckNoLiveInIrreducibleLoop(*block);
+  // Iterate to a fixed point with a worklist, so that only blocks whose successors
+  // had their live_in set changed are visited again, rather than the whole graph.
+  ScopedArenaAllocator allocator(graph_->GetArenaStack());
+  ScopedArenaVector<const HBasicBlock*> worklist(allocator.Adapter(kArenaAllocSsaLiveness));
+  ArenaBitVector in_worklist(
+      &allocator, graph_->GetBlocks().size(), /* expandable= */ false, kArenaAllocSsaLiveness);
+  // Seed the worklist so that blocks are first popped in post order.
+  worklist.reserve(graph_->GetReversePostOrder().size());
+  for (const HBasicBlock* block : graph_->GetReversePostOrder()) {
+    worklist.push_back(block);
+    in_worklist.SetBit(block->GetBlockId());
+  }
+
+  while (!worklist.empty()) {
+    const HBasicBlock* block = worklist.back();
+    worklist.pop_back();
+    in_worklist.ClearBit(block->GetBlockId());
+    // The live_in set depends on the kill set (which does not
+    // change in this loop), and the live_out set.  If the live_out
+    // set does not change, there is no need to update the live_in set.
+    if (UpdateLiveOut(*block) && UpdateLiveIn(*block)) {
+      if (kIsDebugBuild) {
+        CheckNoLiveInIrreducibleLoop(*block);
+      }
+      for (const HBasicBlock* predecessor : block->GetPredecessors()) {
+        if (!in_worklist.IsBitSet(predecessor->GetBlockId())) {
+          worklist.push_back(predecessor);
+          in_worklist.SetBit(predecessor->GetBlockId());
         }
-        changed = true;
       }
     }
-  } while (changed);
+  }
 }
 
 bool SsaLivenessAnalysis::UpdateLiveOut(const HBasicBlock& block) {
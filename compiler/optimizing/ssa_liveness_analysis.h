@@ -1167,8 +1167,10 @@ class LiveInterval : public ArenaObject<kArenaAllocSsaLiveness> {
  * (d) When compiling in OSR mode, all loops in the compiled method may be entered
  *     from the interpreter via SuspendCheck; such use in SuspendCheck makes the instruction
  *     live.
+ * (e) When compiling baseline code, all loops may be left for the interpreter via the
+ *     SuspendCheck of their header; such use in that SuspendCheck makes the instruction live.
  *
- * (b), (c) and (d) are implemented through SsaLivenessAnalysis::ShouldBeLiveForEnvironment.
+ * (b), (c), (d) and (e) are implemented through SsaLivenessAnalysis::ShouldBeLiveForEnvironment.
  */
 class SsaLivenessAnalysis : public ValueObject {
  public:
@@ -1288,6 +1290,13 @@ class SsaLivenessAnalysis : public ValueObject {
     // When compiling in OSR mode, all loops in the compiled method may be entered
     // from the interpreter via SuspendCheck; thus we need to preserve the environment.
     if (env_holder->IsSuspendCheck() && graph->IsCompilingOsr()) return true;
+    // Baseline compiled code may leave a loop for the interpreter at its SuspendCheck, to
+    // then enter the OSR compiled code of the method.
+    if (env_holder->IsSuspendCheck() &&
+        graph->IsCompilingBaseline() &&
+        env_holder->GetBlock()->IsLoopHeader()) {
+      return true;
+    }
     if (graph -> IsDeadReferenceSafe()) return false;
     return instruction->GetType() == DataType::Type::kReference;
   }
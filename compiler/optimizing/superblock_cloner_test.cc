@@ -400,6 +400,39 @@ TEST_F(SuperblockClonerTest, LoopUnrolling) {
   EXPECT_EQ(loop_info->GetBackEdges()[0], bb_map.Get(loop_body));
 }
 
+// Tests that a loop can be peeled and then unrolled, as done for loops whose trip count
+// is not a multiple of the unrolling factor.
+TEST_F(SuperblockClonerTest, LoopPeelingThenUnrolling) {
+  HBasicBlock* header = nullptr;
+  HBasicBlock* loop_body = nullptr;
+
+  InitGraph();
+  CreateBasicLoopControlFlow(entry_block_, return_block_, &header, &loop_body);
+  CreateBasicLoopDataFlow(header, loop_body);
+  graph_->BuildDominatorTree();
+  EXPECT_TRUE(CheckGraph());
+
+  HLoopInformation* loop_info = header->GetLoopInformation();
+  PeelUnrollSimpleHelper peeling_helper(loop_info, /* induction_range= */ nullptr);
+  EXPECT_TRUE(peeling_helper.IsLoopClonable());
+  peeling_helper.DoPeeling();
+  EXPECT_TRUE(CheckGraph());
+  EXPECT_EQ(loop_info, header->GetLoopInformation());
+
+  PeelUnrollSimpleHelper unrolling_helper(loop_info, /* induction_range= */ nullptr);
+  EXPECT_TRUE(unrolling_helper.IsLoopClonable());
+  HBasicBlock* new_header = unrolling_helper.DoUnrolling();
+  EXPECT_TRUE(CheckGraph());
+
+  // Check loop structure.
+  const SuperblockCloner::HBasicBlockMap* bb_map = unrolling_helper.GetBasicBlockMap();
+  EXPECT_EQ(header, new_header);
+  EXPECT_EQ(loop_info, new_header->GetLoopInformation());
+  EXPECT_EQ(loop_body->GetSingleSuccessor(), bb_map->Get(header));
+  EXPECT_EQ(loop_info->GetBackEdges().size(), 1u);
+  EXPECT_EQ(loop_info->GetBackEdges()[0], bb_map->Get(loop_body));
+}
+
 // Checks that loop unrolling works fine for a loop with multiple back edges. Tests that after
 // the transformation the loop has a single preheader.
 TEST_F(SuperblockClonerTest, LoopPeelingMultipleBackEdges) {
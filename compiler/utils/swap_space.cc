@@ -16,12 +16,15 @@
 
 #include "swap_space.h"
 
+#include <stdio.h>
 #include <sys/mman.h>
 
 #include <algorithm>
 #include <numeric>
 
 #include "base/bit_utils.h"
+#include "base/globals.h"
+#include "base/logging.h"  // For VLOG.
 #include "base/macros.h"
 #include "base/mutex.h"
 #include "thread-current-inl.h"
@@ -33,6 +36,25 @@ static constexpr size_t kMininumMapSize = 16 * MB;
 
 static constexpr bool kCheckFreeMaps = false;
 
+// How many bytes to allocate between two checks of the resident size against the budget.
+static constexpr size_t kMemoryBudgetCheckInterval = 1 * MB;
+
+static size_t GetResidentSetSize() {
+#if defined(__linux__)
+  FILE* statm = fopen("/proc/self/statm", "re");
+  if (statm == nullptr) {
+    return 0u;
+  }
+  size_t total_pages = 0u;
+  size_t resident_pages = 0u;
+  int matched = fscanf(statm, "%zu %zu", &total_pages, &resident_pages);
+  fclose(statm);
+  return (matched == 2) ? resident_pages * kPageSize : 0u;
+#else
+  return 0u;
+#endif
+}
+
 template <typename FreeBySizeSet>
 static void DumpFreeMap(const FreeBySizeSet& free_by_size) {
   size_t last_size = static_cast<size_t>(-1);
@@ -62,6 +84,9 @@ inline void SwapSpace::InsertChunk(const SpaceChunk& chunk) {
 SwapSpace::SwapSpace(int fd, size_t initial_size)
     : fd_(fd),
       size_(0),
+      memory_budget_(0u),
+      allocated_since_budget_check_(0u),
+      over_memory_budget_(true),
       lock_("SwapSpace lock", static_cast<LockLevel>(LockLevel::kDefaultMutexLevel - 1)) {
   // Assume that the file is unlinked.
 
@@ -105,10 +130,49 @@ static size_t CollectFree(const FreeByStartSet& free_by_start, const FreeBySizeS
   return sum1;
 }
 
+void SwapSpace::SetMemoryBudget(size_t memory_budget) {
+  MutexLock lock(Thread::Current(), lock_);
+  memory_budget_ = memory_budget;
+  allocated_since_budget_check_ = 0u;
+  over_memory_budget_ = (memory_budget == 0u) || GetResidentSetSize() >= memory_budget;
+}
+
+bool SwapSpace::IsOverMemoryBudget(size_t size) {
+  if (memory_budget_ == 0u) {
+    return true;
+  }
+  allocated_since_budget_check_ += size;
+  if (allocated_since_budget_check_ >= kMemoryBudgetCheckInterval) {
+    allocated_since_budget_check_ = 0u;
+    bool over_memory_budget = GetResidentSetSize() >= memory_budget_;
+    if (over_memory_budget != over_memory_budget_) {
+      VLOG(compiler) << (over_memory_budget ? "Spilling" : "Stopped spilling")
+                     << " compiler output to the swap file";
+    }
+    over_memory_budget_ = over_memory_budget;
+  }
+  return over_memory_budget_;
+}
+
+bool SwapSpace::IsInSwapFile(const void* ptr) const {
+  uintptr_t address = reinterpret_cast<uintptr_t>(ptr);
+  return std::any_of(file_chunks_.begin(),
+                     file_chunks_.end(),
+                     [address](const SpaceChunk& chunk) {
+                       return chunk.Start() <= address && address < chunk.End();
+                     });
+}
+
 void* SwapSpace::Alloc(size_t size) {
   MutexLock lock(Thread::Current(), lock_);
   size = RoundUp(size, 8U);
 
+  if (!IsOverMemoryBudget(size)) {
+    void* ptr = malloc(size);
+    CHECK(ptr != nullptr) << "Unable to allocate " << size << " bytes";
+    return ptr;
+  }
+
   // Check the free list for something that fits.
   // TODO: Smarter implementation. Global biggest chunk, ...
   auto it = free_by_start_.empty()
@@ -163,6 +227,7 @@ SwapSpace::SpaceChunk SwapSpace::NewFileChunk(size_t min_size) {
   }
   size_ += next_part;
   SpaceChunk new_chunk = {ptr, next_part};
+  file_chunks_.push_back(new_chunk);
   return new_chunk;
 #else
   UNUSED(min_size, kMininumMapSize);
@@ -176,6 +241,11 @@ void SwapSpace::Free(void* ptr, size_t size) {
   MutexLock lock(Thread::Current(), lock_);
   size = RoundUp(size, 8U);
 
+  if (memory_budget_ != 0u && !IsInSwapFile(ptr)) {
+    free(ptr);
+    return;
+  }
+
   size_t free_before = 0;
   if (kCheckFreeMaps) {
     free_before = CollectFree(free_by_start_, free_by_size_);
@@ -39,6 +39,11 @@ class SwapSpace {
   void* Alloc(size_t size) REQUIRES(!lock_);
   void Free(void* ptr, size_t size) REQUIRES(!lock_);
 
+  // Serve allocations from the heap while the resident size of the process stays below
+  // `memory_budget` bytes, and spill them to the swap file past it. Zero, the default, always
+  // uses the swap file.
+  void SetMemoryBudget(size_t memory_budget) REQUIRES(!lock_);
+
   size_t GetSize() {
     return size_;
   }
@@ -94,9 +99,20 @@ class SwapSpace {
   void RemoveChunk(FreeBySizeSet::const_iterator free_by_size_pos) REQUIRES(lock_);
   void InsertChunk(const SpaceChunk& chunk) REQUIRES(lock_);
 
+  bool IsOverMemoryBudget(size_t size) REQUIRES(lock_);
+  bool IsInSwapFile(const void* ptr) const REQUIRES(lock_);
+
   int fd_;
   size_t size_;
 
+  // The mappings of the swap file, to tell them apart from heap allocations.
+  std::vector<SpaceChunk> file_chunks_ GUARDED_BY(lock_);
+
+  size_t memory_budget_ GUARDED_BY(lock_);
+  // Bytes allocated since the resident size was last compared to the budget.
+  size_t allocated_since_budget_check_ GUARDED_BY(lock_);
+  bool over_memory_budget_ GUARDED_BY(lock_);
+
   // NOTE: Boost.Bimap would be useful for the two following members.
 
   // Map start of a free chunk to its size.
@@ -782,6 +782,8 @@ class X86_64Assembler final : public Assembler {
   X86_64Assembler* lock();
   void cmpxchgl(const Address& address, CpuRegister reg);
   void cmpxchgq(const Address& address, CpuRegister reg);
+  void xaddl(const Address& address, CpuRegister reg);
+  void xaddq(const Address& address, CpuRegister reg);
 
   void mfence();
 
@@ -844,6 +846,14 @@ class X86_64Assembler final : public Assembler {
     lock()->cmpxchgq(address, reg);
   }
 
+  void LockXaddl(const Address& address, CpuRegister reg) {
+    lock()->xaddl(address, reg);
+  }
+
+  void LockXaddq(const Address& address, CpuRegister reg) {
+    lock()->xaddq(address, reg);
+  }
+
   //
   // Misc. functionality
   //
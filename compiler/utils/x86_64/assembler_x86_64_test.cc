@@ -943,6 +943,16 @@ TEST_F(AssemblerX86_64Test, LockCmpxchgq) {
                      "lock cmpxchg %{reg}, {mem}"), "lock_cmpxchg");
 }
 
+TEST_F(AssemblerX86_64Test, LockXaddl) {
+  DriverStr(RepeatAr(&x86_64::X86_64Assembler::LockXaddl,
+                     "lock xaddl %{reg}, {mem}"), "lock_xaddl");
+}
+
+TEST_F(AssemblerX86_64Test, LockXaddq) {
+  DriverStr(RepeatAR(&x86_64::X86_64Assembler::LockXaddq,
+                     "lock xaddq %{reg}, {mem}"), "lock_xaddq");
+}
+
 TEST_F(AssemblerX86_64Test, MovqStore) {
   DriverStr(RepeatAR(&x86_64::X86_64Assembler::movq, "movq %{reg}, {mem}"), "movq_s");
 }
@@ -17,6 +17,7 @@
 #include <inttypes.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <sys/resource.h>
 #include <sys/stat.h>
 #include "base/memory_tool.h"
 
@@ -365,7 +366,12 @@ NO_RETURN static void Usage(const char* fmt, ...) {
   UsageError("  --dump-timings: display a breakdown of where time was spent");
   UsageError("");
   UsageError("  --dump-pass-timings: display a breakdown of time spent in optimization");
-  UsageError("      passes for each compiled method.");
+  UsageError("      passes for each compiled method, and the total over all methods.");
+  UsageError("");
+  UsageError("  --compile-time-budget-ms=<n>: skip optional optimization passes, such as the");
+  UsageError("      inliner and loop optimizations, once compiling a method took longer than");
+  UsageError("      <n> milliseconds. The default of 0 means no budget.");
+  UsageError("      Example: --compile-time-budget-ms=500");
   UsageError("");
   UsageError("  -g");
   UsageError("  --generate-debug-info: Generate debug information for native debugging,");
@@ -419,6 +425,11 @@ NO_RETURN static void Usage(const char* fmt, ...) {
   UsageError("      Example: --swap-dex-count-threshold=10");
   UsageError("      Default: %zu", kDefaultMinDexFilesForSwap);
   UsageError("");
+  UsageError("  --swap-memory-budget=<size>: specifies the resident memory in bytes that dex2oat");
+  UsageError("      may use before it spills compiled code to the swap file. When set, swap is");
+  UsageError("      used regardless of the dex size and count thresholds, also for images.");
+  UsageError("      Example: --swap-memory-budget=1500000000");
+  UsageError("");
   UsageError("  --very-large-app-threshold=<size>: specifies the minimum total dex file size in");
   UsageError("      bytes to consider the input \"very large\" and reduce compilation done.");
   UsageError("      Example: --very-large-app-threshold=100000000");
@@ -499,6 +510,10 @@ NO_RETURN static void Usage(const char* fmt, ...) {
   UsageError("  --resolve-startup-const-strings=true|false: If true, the compiler eagerly");
   UsageError("      resolves strings referenced from const-string of startup methods.");
   UsageError("");
+  UsageError("  --initialize-startup-classes=true|false: If true and compiling an app image,");
+  UsageError("      the compiler runs the class initializers of classes in the profile in a");
+  UsageError("      transaction and stores the classes initialized in the image.");
+  UsageError("");
   UsageError("  --max-image-block-size=<size>: Maximum solid block size for compressed images.");
   UsageError("");
   std::cerr << "See log for usage error information\n";
@@ -1163,6 +1178,7 @@ class Dex2Oat final {
     AssignIfExists(args, M::SwapFileFd, &swap_fd_);
     AssignIfExists(args, M::SwapDexSizeThreshold, &min_dex_file_cumulative_size_for_swap_);
     AssignIfExists(args, M::SwapDexCountThreshold, &min_dex_files_for_swap_);
+    AssignIfExists(args, M::SwapMemoryBudget, &swap_memory_budget_);
     AssignIfExists(args, M::VeryLargeAppThreshold, &very_large_threshold_);
     AssignIfExists(args, M::AppImageFile, &app_image_file_name_);
     AssignIfExists(args, M::AppImageFileFd, &app_image_fd_);
@@ -1831,6 +1847,9 @@ class Dex2Oat final {
                                      compiler_kind_,
                                      thread_count_,
                                      swap_fd_));
+    if (swap_memory_budget_ != 0u) {
+      driver_->GetCompiledMethodStorage()->SetSwapMemoryBudget(swap_memory_budget_);
+    }
 
     driver_->PrepareDexFilesForOatFile(timings_);
 
@@ -2010,7 +2029,8 @@ class Dex2Oat final {
                                                   oat_filenames_,
                                                   dex_file_oat_index_map_,
                                                   class_loader,
-                                                  dirty_image_objects_.get()));
+                                                  dirty_image_objects_.get(),
+                                                  thread_count_));
 
       // We need to prepare method offsets in the image address space for direct method patching.
       TimingLogger::ScopedTiming t2("dex2oat Prepare image address space", timings_);
@@ -2250,6 +2270,21 @@ class Dex2Oat final {
     if (compiler_options_->GetDumpTimings() ||
         (kIsDebugBuild && timings_->GetTotalNs() > MsToNs(1000))) {
       LOG(INFO) << Dumpable<TimingLogger>(*timings_);
+#if defined(__linux__)
+      struct rusage usage;
+      if (getrusage(RUSAGE_SELF, &usage) == 0) {
+        // Linux reports the maximum resident set size in kilobytes.
+        LOG(INFO) << "Peak RSS: " << PrettySize(static_cast<size_t>(usage.ru_maxrss) * KB);
+        // Together with the total time and thread count, gives the thread utilization.
+        uint64_t user_ns = static_cast<uint64_t>(usage.ru_utime.tv_sec) * UINT64_C(1000000000) +
+            static_cast<uint64_t>(usage.ru_utime.tv_usec) * UINT64_C(1000);
+        uint64_t system_ns = static_cast<uint64_t>(usage.ru_stime.tv_sec) * UINT64_C(1000000000) +
+            static_cast<uint64_t>(usage.ru_stime.tv_usec) * UINT64_C(1000);
+        LOG(INFO) << "CPU time: user " << PrettyDuration(user_ns)
+                  << ", system " << PrettyDuration(system_ns)
+                  << ", threads " << thread_count_;
+      }
+#endif
     }
   }
 
@@ -2331,6 +2366,10 @@ class Dex2Oat final {
 
  private:
   bool UseSwap(bool is_image, const std::vector<const DexFile*>& dex_files) {
+    if (swap_memory_budget_ != 0u) {
+      // The swap file only takes what does not fit in the budget.
+      return true;
+    }
     if (is_image) {
       // Don't use swap, we know generation should succeed, and we don't want to slow it down.
       return false;
@@ -2775,6 +2814,7 @@ class Dex2Oat final {
   int swap_fd_;
   size_t min_dex_files_for_swap_ = kDefaultMinDexFilesForSwap;
   size_t min_dex_file_cumulative_size_for_swap_ = kDefaultMinDexFileCumulativeSizeForSwap;
+  size_t swap_memory_budget_ = 0u;
   size_t very_large_threshold_ = std::numeric_limits<size_t>::max();
   std::string app_image_file_name_;
   int app_image_fd_;
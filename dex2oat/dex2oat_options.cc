@@ -148,7 +148,10 @@ static void AddSwapMappings(Builder& builder) {
           .IntoKey(M::SwapDexSizeThreshold)
       .Define("--swap-dex-count-threshold=_")
           .WithType<unsigned int>()
-          .IntoKey(M::SwapDexCountThreshold);
+          .IntoKey(M::SwapDexCountThreshold)
+      .Define("--swap-memory-budget=_")
+          .WithType<unsigned int>()
+          .IntoKey(M::SwapMemoryBudget);
 }
 
 static void AddCompilerMappings(Builder& builder) {
@@ -22,6 +22,8 @@
 #include <malloc.h>  // For mallinfo
 #endif
 
+#include <algorithm>
+#include <sstream>
 #include <string_view>
 #include <unordered_set>
 #include <vector>
@@ -34,6 +36,7 @@
 #include "base/arena_allocator.h"
 #include "base/array_ref.h"
 #include "base/bit_vector.h"
+#include "base/casts.h"
 #include "base/enums.h"
 #include "base/logging.h"  // For VLOG
 #include "base/stl_util.h"
@@ -1764,7 +1767,8 @@ static void LoadAndUpdateStatus(const ClassAccessor& accessor,
 bool CompilerDriver::FastVerify(jobject jclass_loader,
                                 const std::vector<const DexFile*>& dex_files,
                                 TimingLogger* timings,
-                                /*out*/ VerificationResults* verification_results) {
+                                /*out*/ VerificationResults* verification_results,
+                                /*out*/ std::vector<const DexFile*>* dex_files_to_verify) {
   verifier::VerifierDeps* verifier_deps =
       Runtime::Current()->GetCompilerCallbacks()->GetVerifierDeps();
   // If there exist VerifierDeps that aren't the ones we just created to output, use them to verify.
@@ -1777,27 +1781,30 @@ bool CompilerDriver::FastVerify(jobject jclass_loader,
   StackHandleScope<2> hs(soa.Self());
   Handle<mirror::ClassLoader> class_loader(
       hs.NewHandle(soa.Decode<mirror::ClassLoader>(jclass_loader)));
-  std::string error_msg;
-
-  if (!verifier_deps->ValidateDependencies(
-      soa.Self(),
-      class_loader,
-      // This returns classpath dex files in no particular order but VerifierDeps
-      // does not care about the order.
-      classpath_classes_.GetDexFiles(),
-      &error_msg)) {
-    LOG(WARNING) << "Fast verification failed: " << error_msg;
-    return false;
-  }
-
+  // This returns classpath dex files in no particular order but VerifierDeps
+  // does not care about the order.
+  const std::vector<const DexFile*>& classpath = classpath_classes_.GetDexFiles();
   bool compiler_only_verifies = !GetCompilerOptions().IsAnyCompilationEnabled();
 
-  // We successfully validated the dependencies, now update class status
-  // of verified classes. Note that the dependencies also record which classes
-  // could not be fully verified; we could try again, but that would hurt verification
-  // time. So instead we assume these classes still need to be verified at
-  // runtime.
   for (const DexFile* dex_file : dex_files) {
+    // Dependencies are recorded per dex file, so only the dex files whose dependencies
+    // changed need to be verified again.
+    std::string error_msg;
+    if (!verifier_deps->ValidateDependencies(
+        soa.Self(), class_loader, classpath, *dex_file, &error_msg)) {
+      LOG(WARNING) << "Fast verification failed for " << dex_file->GetLocation() << ": "
+                   << error_msg;
+      // The stale dependencies must not end up in the output vdex.
+      verifier_deps->ClearDependencies(*dex_file);
+      dex_files_to_verify->push_back(dex_file);
+      continue;
+    }
+
+    // We successfully validated the dependencies, now update class status
+    // of verified classes. Note that the dependencies also record which classes
+    // could not be fully verified; we could try again, but that would hurt verification
+    // time. So instead we assume these classes still need to be verified at
+    // runtime.
     // Fetch the list of verified classes.
     const std::vector<bool>& verified_classes = verifier_deps->GetVerifiedClasses(*dex_file);
     DCHECK_EQ(verified_classes.size(), dex_file->NumClassDefs());
@@ -1842,7 +1849,11 @@ void CompilerDriver::Verify(jobject jclass_loader,
                             const std::vector<const DexFile*>& dex_files,
                             TimingLogger* timings,
                             /*out*/ VerificationResults* verification_results) {
-  if (FastVerify(jclass_loader, dex_files, timings, verification_results)) {
+  std::vector<const DexFile*> dex_files_to_verify;
+  if (!FastVerify(jclass_loader, dex_files, timings, verification_results, &dex_files_to_verify)) {
+    dex_files_to_verify = dex_files;
+  }
+  if (dex_files_to_verify.empty()) {
     return;
   }
 
@@ -1870,7 +1881,7 @@ void CompilerDriver::Verify(jobject jclass_loader,
   ThreadPool* verify_thread_pool =
       force_determinism ? single_thread_pool_.get() : parallel_thread_pool_.get();
   size_t verify_thread_count = force_determinism ? 1U : parallel_thread_count_;
-  for (const DexFile* dex_file : dex_files) {
+  for (const DexFile* dex_file : dex_files_to_verify) {
     CHECK(dex_file != nullptr);
     VerifyDexFile(jclass_loader,
                   *dex_file,
@@ -2210,11 +2221,15 @@ class InitializeClassVisitor : public CompilationVisitor {
             CHECK(is_app_image);
             // The boot image case doesn't need to recursively initialize the dependencies with
             // special logic since the class linker already does this.
+            // For app images, the image classes are the classes of the profile. If requested,
+            // run their class initializers; the strict transaction aborts on any access to the
+            // static fields of other classes, and the dependencies are initialized above.
             can_init_static_fields =
                 ClassLinker::kAppImageMayContainStrings &&
                 !soa.Self()->IsExceptionPending() &&
                 is_superclass_initialized &&
-                NoClinitInDependency(klass, soa.Self(), &class_loader);
+                (manager_->GetCompiler()->GetCompilerOptions().InitializeStartupClasses() ||
+                 NoClinitInDependency(klass, soa.Self(), &class_loader));
             // TODO The checking for clinit can be removed since it's already
             // checked when init superclass. Currently keep it because it contains
             // processing of intern strings. Will be removed later when intern strings
@@ -2266,15 +2281,13 @@ class InitializeClassVisitor : public CompilationVisitor {
               }
             }
 
-            if (!success) {
+            if (!success && is_boot_image) {
               // On failure, still intern strings of static fields and seen in <clinit>, as these
               // will be created in the zygote. This is separated from the transaction code just
               // above as we will allocate strings, so must be allowed to suspend.
-              if (&klass->GetDexFile() == manager_->GetDexFile()) {
-                InternStrings(klass, class_loader);
-              } else {
-                DCHECK(!is_boot_image) << "Boot image must have equal dex files";
-              }
+              DCHECK(&klass->GetDexFile() == manager_->GetDexFile())
+                  << "Boot image must have equal dex files";
+              InternStrings(klass, class_loader);
             }
           }
         }
@@ -2590,26 +2603,44 @@ void CompilerDriver::InitializeClasses(jobject class_loader,
   }
 }
 
+// Compile the classes of all the dex files in a single parallel pass. Classes of different dex
+// files are independent at this point, and a pass per dex file would leave the workers idle
+// while the last classes of each dex file finish.
 template <typename CompileFn>
-static void CompileDexFile(CompilerDriver* driver,
-                           jobject class_loader,
-                           const DexFile& dex_file,
-                           const std::vector<const DexFile*>& dex_files,
-                           ThreadPool* thread_pool,
-                           size_t thread_count,
-                           TimingLogger* timings,
-                           const char* timing_name,
-                           CompileFn compile_fn) {
+static void CompileDexFiles(CompilerDriver* driver,
+                            jobject class_loader,
+                            const std::vector<const DexFile*>& dex_files,
+                            ThreadPool* thread_pool,
+                            size_t thread_count,
+                            TimingLogger* timings,
+                            const char* timing_name,
+                            CompileFn compile_fn) {
   TimingLogger::ScopedTiming t(timing_name, timings);
   ParallelCompilationManager context(Runtime::Current()->GetClassLinker(),
                                      class_loader,
                                      driver,
-                                     &dex_file,
+                                     /* dex_file= */ nullptr,
                                      dex_files,
                                      thread_pool);
 
-  auto compile = [&context, &compile_fn](size_t class_def_index) {
-    const DexFile& dex_file = *context.GetDexFile();
+  // The work index runs over the class defs of all the dex files, in order.
+  std::vector<size_t> class_def_starts;
+  class_def_starts.reserve(dex_files.size());
+  size_t num_class_defs = 0u;
+  for (const DexFile* dex_file : dex_files) {
+    CHECK(dex_file != nullptr);
+    class_def_starts.push_back(num_class_defs);
+    num_class_defs += dex_file->NumClassDefs();
+  }
+
+  auto compile = [&context, &compile_fn, &class_def_starts](size_t index) {
+    // Find the last dex file starting at or before `index`, which skips empty dex files.
+    auto it = std::upper_bound(class_def_starts.begin(), class_def_starts.end(), index);
+    DCHECK(it != class_def_starts.begin());
+    size_t dex_file_index = std::distance(class_def_starts.begin(), it) - 1u;
+    const DexFile& dex_file = *context.GetDexFiles()[dex_file_index];
+    const uint16_t class_def_index =
+        dchecked_integral_cast<uint16_t>(index - class_def_starts[dex_file_index]);
     SCOPED_TRACE << "compile " << dex_file.GetLocation() << "@" << class_def_index;
     ClassLinker* class_linker = context.GetClassLinker();
     jobject jclass_loader = context.GetClassLoader();
@@ -2677,7 +2708,7 @@ static void CompileDexFile(CompilerDriver* driver,
                  dex_cache);
     }
   };
-  context.ForAllLambda(0, dex_file.NumClassDefs(), compile, thread_count);
+  context.ForAllLambda(0, num_class_defs, compile, thread_count);
 }
 
 void CompilerDriver::Compile(jobject class_loader,
@@ -2693,37 +2724,33 @@ void CompilerDriver::Compile(jobject class_loader,
   }
 
   dex_to_dex_compiler_.ClearState();
-  for (const DexFile* dex_file : dex_files) {
-    CHECK(dex_file != nullptr);
-    CompileDexFile(this,
-                   class_loader,
-                   *dex_file,
-                   dex_files,
-                   parallel_thread_pool_.get(),
-                   parallel_thread_count_,
-                   timings,
-                   "Compile Dex File Quick",
-                   CompileMethodQuick);
-    const ArenaPool* const arena_pool = Runtime::Current()->GetArenaPool();
-    const size_t arena_alloc = arena_pool->GetBytesAllocated();
-    max_arena_alloc_ = std::max(arena_alloc, max_arena_alloc_);
-    Runtime::Current()->ReclaimArenaPoolMemory();
-  }
+  CompileDexFiles(this,
+                  class_loader,
+                  dex_files,
+                  parallel_thread_pool_.get(),
+                  parallel_thread_count_,
+                  timings,
+                  "Compile Dex File Quick",
+                  CompileMethodQuick);
+  const ArenaPool* const arena_pool = Runtime::Current()->GetArenaPool();
+  const size_t arena_alloc = arena_pool->GetBytesAllocated();
+  max_arena_alloc_ = std::max(arena_alloc, max_arena_alloc_);
+  if (VLOG_IS_ON(compiler)) {
+    std::ostringstream oss;
+    arena_pool->DumpStats(oss);
+    VLOG(compiler) << oss.str();
+  }
+  Runtime::Current()->ReclaimArenaPoolMemory();
 
   if (dex_to_dex_compiler_.NumCodeItemsToQuicken(Thread::Current()) > 0u) {
-    // TODO: Not visit all of the dex files, its probably rare that only one would have quickened
-    // methods though.
-    for (const DexFile* dex_file : dex_files) {
-      CompileDexFile(this,
-                     class_loader,
-                     *dex_file,
-                     dex_files,
-                     parallel_thread_pool_.get(),
-                     parallel_thread_count_,
-                     timings,
-                     "Compile Dex File Dex2Dex",
-                     CompileMethodDex2Dex);
-    }
+    CompileDexFiles(this,
+                    class_loader,
+                    dex_files,
+                    parallel_thread_pool_.get(),
+                    parallel_thread_count_,
+                    timings,
+                    "Compile Dex File Dex2Dex",
+                    CompileMethodDex2Dex);
     dex_to_dex_compiler_.ClearState();
   }
 
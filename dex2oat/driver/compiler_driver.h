@@ -248,11 +248,13 @@ class CompilerDriver {
       REQUIRES(!Locks::mutator_lock_);
 
   // Do fast verification through VerifierDeps if possible. Return whether
-  // verification was successful.
+  // VerifierDeps could be used. If so, `dex_files_to_verify` receives the dex files whose
+  // dependencies are no longer valid and need to be verified again.
   bool FastVerify(jobject class_loader,
                   const std::vector<const DexFile*>& dex_files,
                   TimingLogger* timings,
-                  /*out*/ VerificationResults* verification_results);
+                  /*out*/ VerificationResults* verification_results,
+                  /*out*/ std::vector<const DexFile*>* dex_files_to_verify);
 
   void Verify(jobject class_loader,
               const std::vector<const DexFile*>& dex_files,
@@ -347,6 +347,7 @@ uint32_t ArmBaseRelativePatcher::CalculateMethodCallDisplacement(uint32_t patch_
   uint32_t max_negative_displacement = MaxNegativeDisplacement(GetMethodCallKey());
   // NOTE: With unsigned arithmetic we do mean to use && rather than || below.
   if (displacement > max_positive_displacement && displacement < -max_negative_displacement) {
+    RecordCallViaThunk();
     // Unwritten thunks have higher offsets, check if it's within range.
     DCHECK(!method_call_thunk_->HasPendingOffset() ||
            method_call_thunk_->GetPendingOffset() > patch_offset);
@@ -21,6 +21,7 @@
 #include <sys/stat.h>
 #include <zlib.h>
 
+#include <atomic>
 #include <memory>
 #include <numeric>
 #include <unordered_set>
@@ -79,6 +80,7 @@
 #include "runtime.h"
 #include "scoped_thread_state_change-inl.h"
 #include "subtype_check.h"
+#include "thread_pool.h"
 #include "utils/dex_cache_arrays_layout-inl.h"
 #include "well_known_classes.h"
 
@@ -2980,7 +2982,8 @@ void ImageWriter::CopyAndFixupObject(Object* obj) {
   DCHECK_LT(offset, image_info.image_end_);
   const auto* src = reinterpret_cast<const uint8_t*>(obj);
 
-  image_info.image_bitmap_->Set(dst);  // Mark the obj as live.
+  // Objects may be copied in parallel, and neighbours share bitmap words.
+  image_info.image_bitmap_->AtomicTestAndSet(dst);  // Mark the obj as live.
 
   const size_t n = obj->SizeOf();
 
@@ -3044,12 +3047,74 @@ class ImageWriter::FixupVisitor {
   mirror::Object* const copy_;
 };
 
+// Copies and fixes up ranges of objects claimed from a shared index.
+class ImageWriter::CopyAndFixupObjectsTask final : public Task {
+ public:
+  CopyAndFixupObjectsTask(ImageWriter* image_writer,
+                          const std::vector<Object*>* objects,
+                          std::atomic<size_t>* next_index)
+      : image_writer_(image_writer),
+        objects_(objects),
+        next_index_(next_index) {}
+
+  void Run(Thread* self) override {
+    ScopedObjectAccess soa(self);
+    const size_t num_objects = objects_->size();
+    while (true) {
+      size_t begin = next_index_->fetch_add(kObjectsPerClaim, std::memory_order_relaxed);
+      if (begin >= num_objects) {
+        break;
+      }
+      size_t end = std::min(begin + kObjectsPerClaim, num_objects);
+      for (size_t i = begin; i != end; ++i) {
+        image_writer_->CopyAndFixupObject((*objects_)[i]);
+      }
+    }
+  }
+
+  void Finalize() override {
+    delete this;
+  }
+
+ private:
+  static constexpr size_t kObjectsPerClaim = 256u;
+
+  ImageWriter* const image_writer_;
+  const std::vector<Object*>* const objects_;
+  std::atomic<size_t>* const next_index_;
+};
+
 void ImageWriter::CopyAndFixupObjects() {
+  // Below this number of image objects, objects are copied on the current thread only.
+  static constexpr size_t kMinObjectsForParallelCopy = 16 * KB;
+
+  // Each object is copied to its own, already assigned, location in the image and only
+  // touches its own bit in the live bitmap. Objects can therefore be copied in any order,
+  // and on several threads, without changing the image.
+  std::vector<Object*> objects;
   auto visitor = [&](Object* obj) REQUIRES_SHARED(Locks::mutator_lock_) {
     DCHECK(obj != nullptr);
-    CopyAndFixupObject(obj);
+    if (IsImageObject(obj)) {
+      objects.push_back(obj);
+    }
   };
   Runtime::Current()->GetHeap()->VisitObjects(visitor);
+  if (thread_count_ > 1u && objects.size() >= kMinObjectsForParallelCopy) {
+    Thread* self = Thread::Current();
+    // The current thread takes part in the work.
+    ThreadPool thread_pool("Image object copying", thread_count_ - 1u);
+    std::atomic<size_t> next_index(0u);
+    for (size_t i = 0; i != thread_count_; ++i) {
+      thread_pool.AddTask(self, new CopyAndFixupObjectsTask(this, &objects, &next_index));
+    }
+    thread_pool.StartWorkers(self);
+    thread_pool.Wait(self, /*do_work=*/ true, /*may_hold_locks=*/ true);
+    thread_pool.StopWorkers(self);
+  } else {
+    for (Object* obj : objects) {
+      CopyAndFixupObject(obj);
+    }
+  }
   // Copy the padding objects since they are required for in order traversal of the image space.
   for (const ImageInfo& image_info : image_infos_) {
     for (const size_t offset : image_info.padding_object_offsets_) {
@@ -3061,6 +3126,8 @@ void ImageWriter::CopyAndFixupObjects() {
   }
   // We no longer need the hashcode map, values have already been copied to target objects.
   saved_hashcode_map_.clear();
+  // All the pointer arrays have been fixed up.
+  pointer_arrays_.clear();
 }
 
 class ImageWriter::FixupClassVisitor final : public FixupVisitor {
@@ -3179,9 +3246,9 @@ void ImageWriter::FixupObject(Object* orig, Object* copy) {
     // Is this a native pointer array?
     auto it = pointer_arrays_.find(down_cast<mirror::PointerArray*>(orig));
     if (it != pointer_arrays_.end()) {
-      // Should only need to fixup every pointer array exactly once.
+      // Every pointer array is fixed up exactly once since every object is copied once.
+      // Do not erase the entry, other threads may be looking up the map.
       FixupPointerArray(copy, down_cast<mirror::PointerArray*>(orig), it->second);
-      pointer_arrays_.erase(it);
       return;
     }
   }
@@ -3613,7 +3680,8 @@ ImageWriter::ImageWriter(
     const std::vector<std::string>& oat_filenames,
     const std::unordered_map<const DexFile*, size_t>& dex_file_oat_index_map,
     jobject class_loader,
-    const HashSet<std::string>* dirty_image_objects)
+    const HashSet<std::string>* dirty_image_objects,
+    size_t thread_count)
     : compiler_options_(compiler_options),
       global_image_begin_(reinterpret_cast<uint8_t*>(image_begin)),
       image_objects_offset_begin_(0),
@@ -3626,7 +3694,8 @@ ImageWriter::ImageWriter(
       image_storage_mode_(image_storage_mode),
       oat_filenames_(oat_filenames),
       dex_file_oat_index_map_(dex_file_oat_index_map),
-      dirty_image_objects_(dirty_image_objects) {
+      dirty_image_objects_(dirty_image_objects),
+      thread_count_(thread_count) {
   DCHECK(compiler_options.IsBootImage() || compiler_options.IsAppImage());
   CHECK_NE(image_begin, 0U);
   std::fill_n(image_methods_, arraysize(image_methods_), nullptr);
@@ -17,6 +17,7 @@
 #include "oat_writer.h"
 
 #include <algorithm>
+#include <atomic>
 #include <unistd.h>
 #include <zlib.h>
 
@@ -69,6 +70,7 @@
 #include "stream/buffered_output_stream.h"
 #include "stream/file_output_stream.h"
 #include "stream/output_stream.h"
+#include "thread_pool.h"
 #include "utils/dex_cache_arrays_layout-inl.h"
 #include "vdex_file.h"
 #include "verifier/verifier_deps.h"
@@ -93,6 +95,9 @@ static constexpr bool kOatWriterForceOatCodeLayout = false;
 
 static constexpr bool kOatWriterDebugOatCodeLayout = false;
 
+// Below this number of compiled methods, patch targets are not resolved in parallel.
+static constexpr size_t kMinMethodsForParallelPatchResolution = 1024;
+
 using UnalignedDexFileHeader __attribute__((__aligned__(1))) = DexFile::Header;
 
 const UnalignedDexFileHeader* AsUnalignedDexFileHeader(const uint8_t* raw_data) {
@@ -424,10 +429,13 @@ OatWriter::OatWriter(const CompilerOptions& compiler_options,
     size_method_header_(0),
     size_code_(0),
     size_code_alignment_(0),
+    size_deduped_code_(0),
+    num_deduped_methods_(0),
     size_data_bimg_rel_ro_(0),
     size_data_bimg_rel_ro_alignment_(0),
     size_relative_call_thunks_(0),
     size_misc_thunks_(0),
+    num_calls_via_thunks_(0),
     size_vmap_table_(0),
     size_method_info_(0),
     size_oat_dex_file_location_size_(0),
@@ -1028,7 +1036,6 @@ struct OatWriter::OrderedMethodData {
   // Bin each method according to the profile flags.
   //
   // Groups by e.g.
-  //  -- not hot at all
   //  -- hot
   //  -- hot and startup
   //  -- hot and post-startup
@@ -1036,8 +1043,12 @@ struct OatWriter::OrderedMethodData {
   //  -- startup
   //  -- startup and post-startup
   //  -- post-startup
+  //  -- not in the profile at all
   //
   // (See MethodHotness enum definition for up-to-date binning order.)
+  //
+  // Methods that are not in the profile go last, in a cold tail of the code, so that the
+  // profiled code is dense in the i-cache, the iTLB and in the pages read at startup.
   bool operator<(const OrderedMethodData& other) const {
     if (kOatWriterForceOatCodeLayout) {
       // Development flag: Override default behavior by sorting by name.
@@ -1047,6 +1058,11 @@ struct OatWriter::OrderedMethodData {
       return name < other_name;
     }
 
+    // Keep the methods that are not in the profile after all the others.
+    if (method_hotness.IsInProfile() != other.method_hotness.IsInProfile()) {
+      return method_hotness.IsInProfile();
+    }
+
     // Use the profile's method hotness to determine sort order.
     if (GetMethodHotnessOrder() < other.GetMethodHotnessOrder()) {
       return true;
@@ -1339,6 +1355,9 @@ class OatWriter::LayoutReserveOffsetCodeMethodVisitor : public OrderedMethodVisi
       // Update offsets. (Checksum is updated when writing.)
       offset_ += sizeof(*method_header);  // Method header is prepended before code.
       offset_ += code_size;
+    } else if (code_size != 0u) {
+      writer_->size_deduped_code_ += code_size;
+      writer_->num_deduped_methods_ += 1u;
     }
 
     // Exclude quickened dex methods (code_size == 0) since they have no native code.
@@ -1621,23 +1640,254 @@ class OatWriter::InitImageMethodVisitor : public OatDexMethodVisitor {
   std::vector<std::pair<ArtMethod*, ArtMethod*>> methods_to_process_;
 };
 
+// Computes the targets of linker patches. The targets depend only on the final layout and
+// not on the order in which the code is written, so they can be computed in parallel.
+class OatWriter::PatchTargetResolver {
+ public:
+  explicit PatchTargetResolver(OatWriter* writer)
+      : writer_(writer),
+        pointer_size_(GetInstructionSetPointerSize(writer_->compiler_options_.GetInstructionSet())),
+        class_loader_(writer->HasImage() ? writer->image_writer_->GetAppClassLoader() : nullptr),
+        class_linker_(Runtime::Current()->GetClassLinker()),
+        dex_file_(nullptr),
+        dex_cache_(nullptr) {}
+
+  // Set the dex file of the method whose patches are resolved next.
+  void SetDexFile(const DexFile* dex_file) REQUIRES_SHARED(Locks::mutator_lock_) {
+    dex_file_ = dex_file;
+
+    // Ordered method visiting is only for compiled methods.
+    DCHECK(writer_->MayHaveCompiledMethods());
+
+    if (writer_->GetCompilerOptions().IsAotCompilationEnabled()) {
+      // Only need to set the dex cache if we have compilation. Other modes might have unloaded it.
+      if (dex_cache_ == nullptr || dex_cache_->GetDexFile() != dex_file) {
+        dex_cache_ = class_linker_->FindDexCache(Thread::Current(), *dex_file);
+        DCHECK(dex_cache_ != nullptr);
+      }
+    }
+  }
+
+  // Returns true if the patch refers to a target offset computed by GetTargetOffset().
+  // The other patches are resolved by the relative patcher alone.
+  static bool HasTargetOffset(const LinkerPatch& patch) {
+    return patch.GetType() != LinkerPatch::Type::kCallEntrypoint &&
+           patch.GetType() != LinkerPatch::Type::kBakerReadBarrierBranch;
+  }
+
+  uint32_t GetTargetOffset(const LinkerPatch& patch) REQUIRES_SHARED(Locks::mutator_lock_) {
+    DCHECK(HasTargetOffset(patch));
+    switch (patch.GetType()) {
+      case LinkerPatch::Type::kIntrinsicReference:
+        return GetTargetIntrinsicReferenceOffset(patch);
+      case LinkerPatch::Type::kDataBimgRelRo:
+        return writer_->data_bimg_rel_ro_start_ +
+               writer_->data_bimg_rel_ro_entries_.Get(patch.BootImageOffset());
+      case LinkerPatch::Type::kMethodBssEntry:
+        return writer_->bss_start_ + writer_->bss_method_entries_.Get(patch.TargetMethod());
+      case LinkerPatch::Type::kCallRelative:
+        // NOTE: Relative calls across oat files are not supported.
+        return GetTargetCallOffset(patch);
+      case LinkerPatch::Type::kStringRelative:
+        return GetTargetObjectOffset(GetTargetString(patch));
+      case LinkerPatch::Type::kStringBssEntry: {
+        StringReference ref(patch.TargetStringDexFile(), patch.TargetStringIndex());
+        return writer_->bss_start_ + writer_->bss_string_entries_.Get(ref);
+      }
+      case LinkerPatch::Type::kTypeRelative:
+        return GetTargetObjectOffset(GetTargetType(patch));
+      case LinkerPatch::Type::kTypeBssEntry: {
+        TypeReference ref(patch.TargetTypeDexFile(), patch.TargetTypeIndex());
+        return writer_->bss_start_ + writer_->bss_type_entries_.Get(ref);
+      }
+      case LinkerPatch::Type::kMethodRelative:
+        return GetTargetMethodOffset(GetTargetMethod(patch));
+      default:
+        DCHECK(false) << "Unexpected linker patch type: " << patch.GetType();
+        return 0u;
+    }
+  }
+
+ private:
+  OatWriter* const writer_;
+  // Pointer size we are compiling to.
+  const PointerSize pointer_size_;
+  // The image writer's classloader, if there is one, else null.
+  ObjPtr<mirror::ClassLoader> class_loader_;
+  ClassLinker* const class_linker_;
+
+  // The dex file of the method being patched and its dex cache.
+  const DexFile* dex_file_;
+  ObjPtr<mirror::DexCache> dex_cache_;
+
+  ArtMethod* GetTargetMethod(const LinkerPatch& patch)
+      REQUIRES_SHARED(Locks::mutator_lock_) {
+    MethodReference ref = patch.TargetMethod();
+    ObjPtr<mirror::DexCache> dex_cache =
+        (dex_file_ == ref.dex_file) ? dex_cache_ : class_linker_->FindDexCache(
+            Thread::Current(), *ref.dex_file);
+    ArtMethod* method =
+        class_linker_->LookupResolvedMethod(ref.index, dex_cache, class_loader_);
+    CHECK(method != nullptr);
+    return method;
+  }
+
+  uint32_t GetTargetCallOffset(const LinkerPatch& patch) REQUIRES_SHARED(Locks::mutator_lock_) {
+    uint32_t target_offset = writer_->relative_patcher_->GetOffset(patch.TargetMethod());
+    // If there's no new compiled code, either we're compiling an app and the target method
+    // is in the boot image, or we need to point to the correct trampoline.
+    if (UNLIKELY(target_offset == 0)) {
+      ArtMethod* target = GetTargetMethod(patch);
+      DCHECK(target != nullptr);
+      const void* oat_code_offset =
+          target->GetEntryPointFromQuickCompiledCodePtrSize(pointer_size_);
+      if (oat_code_offset != nullptr) {
+        DCHECK(!writer_->GetCompilerOptions().IsBootImage());
+        DCHECK(!Runtime::Current()->GetClassLinker()->IsQuickResolutionStub(oat_code_offset));
+        DCHECK(!Runtime::Current()->GetClassLinker()->IsQuickToInterpreterBridge(oat_code_offset));
+        DCHECK(!Runtime::Current()->GetClassLinker()->IsQuickGenericJniStub(oat_code_offset));
+        target_offset = PointerToLowMemUInt32(oat_code_offset);
+      } else {
+        target_offset = target->IsNative()
+            ? writer_->oat_header_->GetQuickGenericJniTrampolineOffset()
+            : writer_->oat_header_->GetQuickToInterpreterBridgeOffset();
+      }
+    }
+    return target_offset;
+  }
+
+  ObjPtr<mirror::DexCache> GetDexCache(const DexFile* target_dex_file)
+      REQUIRES_SHARED(Locks::mutator_lock_) {
+    return (target_dex_file == dex_file_)
+        ? dex_cache_
+        : class_linker_->FindDexCache(Thread::Current(), *target_dex_file);
+  }
+
+  ObjPtr<mirror::Class> GetTargetType(const LinkerPatch& patch)
+      REQUIRES_SHARED(Locks::mutator_lock_) {
+    DCHECK(writer_->HasImage());
+    ObjPtr<mirror::DexCache> dex_cache = GetDexCache(patch.TargetTypeDexFile());
+    ObjPtr<mirror::Class> type =
+        class_linker_->LookupResolvedType(patch.TargetTypeIndex(), dex_cache, class_loader_);
+    CHECK(type != nullptr);
+    return type;
+  }
+
+  ObjPtr<mirror::String> GetTargetString(const LinkerPatch& patch)
+      REQUIRES_SHARED(Locks::mutator_lock_) {
+    ClassLinker* linker = Runtime::Current()->GetClassLinker();
+    ObjPtr<mirror::String> string =
+        linker->LookupString(patch.TargetStringIndex(), GetDexCache(patch.TargetStringDexFile()));
+    DCHECK(string != nullptr);
+    DCHECK(writer_->GetCompilerOptions().IsBootImage() ||
+           Runtime::Current()->GetHeap()->ObjectIsInBootImageSpace(string));
+    return string;
+  }
+
+  uint32_t GetTargetIntrinsicReferenceOffset(const LinkerPatch& patch)
+      REQUIRES_SHARED(Locks::mutator_lock_) {
+    DCHECK(writer_->GetCompilerOptions().IsBootImage());
+    const void* address =
+        writer_->image_writer_->GetIntrinsicReferenceAddress(patch.IntrinsicData());
+    size_t oat_index = writer_->image_writer_->GetOatIndexForDexFile(dex_file_);
+    uintptr_t oat_data_begin = writer_->image_writer_->GetOatDataBegin(oat_index);
+    // TODO: Clean up offset types. The target offset must be treated as signed.
+    return static_cast<uint32_t>(reinterpret_cast<uintptr_t>(address) - oat_data_begin);
+  }
+
+  uint32_t GetTargetMethodOffset(ArtMethod* method) REQUIRES_SHARED(Locks::mutator_lock_) {
+    DCHECK(writer_->GetCompilerOptions().IsBootImage());
+    method = writer_->image_writer_->GetImageMethodAddress(method);
+    size_t oat_index = writer_->image_writer_->GetOatIndexForDexFile(dex_file_);
+    uintptr_t oat_data_begin = writer_->image_writer_->GetOatDataBegin(oat_index);
+    // TODO: Clean up offset types. The target offset must be treated as signed.
+    return static_cast<uint32_t>(reinterpret_cast<uintptr_t>(method) - oat_data_begin);
+  }
+
+  uint32_t GetTargetObjectOffset(ObjPtr<mirror::Object> object)
+      REQUIRES_SHARED(Locks::mutator_lock_) {
+    DCHECK(writer_->GetCompilerOptions().IsBootImage());
+    object = writer_->image_writer_->GetImageAddress(object.Ptr());
+    size_t oat_index = writer_->image_writer_->GetOatIndexForDexFile(dex_file_);
+    uintptr_t oat_data_begin = writer_->image_writer_->GetOatDataBegin(oat_index);
+    // TODO: Clean up offset types. The target offset must be treated as signed.
+    return static_cast<uint32_t>(reinterpret_cast<uintptr_t>(object.Ptr()) - oat_data_begin);
+  }
+};
+
+// Resolves the patch targets of a range of ordered methods. The ranges are claimed from a
+// shared index, and each method's targets go to its own slot, so the result does not depend
+// on the number of threads or on scheduling.
+class OatWriter::ResolvePatchTargetsTask final : public Task {
+ public:
+  ResolvePatchTargetsTask(OatWriter* writer,
+                          const OrderedMethodList* ordered_methods,
+                          std::atomic<size_t>* next_index,
+                          std::vector<std::vector<uint32_t>>* target_offsets)
+      : writer_(writer),
+        ordered_methods_(ordered_methods),
+        next_index_(next_index),
+        target_offsets_(target_offsets) {}
+
+  void Run(Thread* self) override {
+    ScopedObjectAccess soa(self);
+    ScopedAssertNoThreadSuspension sants("Resolving patch targets", self);
+    PatchTargetResolver resolver(writer_);
+    const size_t num_methods = ordered_methods_->size();
+    while (true) {
+      size_t begin = next_index_->fetch_add(kMethodsPerClaim, std::memory_order_relaxed);
+      if (begin >= num_methods) {
+        break;
+      }
+      size_t end = std::min(begin + kMethodsPerClaim, num_methods);
+      for (size_t i = begin; i != end; ++i) {
+        const OrderedMethodData& method_data = (*ordered_methods_)[i];
+        ArrayRef<const LinkerPatch> patches = method_data.compiled_method->GetPatches();
+        if (patches.empty()) {
+          continue;
+        }
+        resolver.SetDexFile(method_data.method_reference.dex_file);
+        std::vector<uint32_t>& offsets = (*target_offsets_)[i];
+        offsets.reserve(patches.size());
+        for (const LinkerPatch& patch : patches) {
+          offsets.push_back(PatchTargetResolver::HasTargetOffset(patch)
+                                ? resolver.GetTargetOffset(patch)
+                                : 0u);
+        }
+      }
+    }
+  }
+
+  void Finalize() override {
+    delete this;
+  }
+
+ private:
+  static constexpr size_t kMethodsPerClaim = 64u;
+
+  OatWriter* const writer_;
+  const OrderedMethodList* const ordered_methods_;
+  std::atomic<size_t>* const next_index_;
+  std::vector<std::vector<uint32_t>>* const target_offsets_;
+};
+
 class OatWriter::WriteCodeMethodVisitor : public OrderedMethodVisitor {
  public:
   WriteCodeMethodVisitor(OatWriter* writer,
                          OutputStream* out,
                          const size_t file_offset,
                          size_t relative_offset,
-                         OrderedMethodList ordered_methods)
+                         OrderedMethodList ordered_methods,
+                         std::vector<std::vector<uint32_t>> target_offsets)
       : OrderedMethodVisitor(std::move(ordered_methods)),
         writer_(writer),
         offset_(relative_offset),
         dex_file_(nullptr),
-        pointer_size_(GetInstructionSetPointerSize(writer_->compiler_options_.GetInstructionSet())),
-        class_loader_(writer->HasImage() ? writer->image_writer_->GetAppClassLoader() : nullptr),
         out_(out),
         file_offset_(file_offset),
-        class_linker_(Runtime::Current()->GetClassLinker()),
-        dex_cache_(nullptr),
+        resolver_(writer),
+        target_offsets_(std::move(target_offsets)),
+        method_index_(0u),
         no_thread_suspension_("OatWriter patching") {
     patched_code_.reserve(16 * KB);
     if (writer_->GetCompilerOptions().IsBootImage()) {
@@ -1650,22 +1900,6 @@ class OatWriter::WriteCodeMethodVisitor : public OrderedMethodVisitor {
     return true;
   }
 
-  void UpdateDexFileAndDexCache(const DexFile* dex_file)
-      REQUIRES_SHARED(Locks::mutator_lock_) {
-    dex_file_ = dex_file;
-
-    // Ordered method visiting is only for compiled methods.
-    DCHECK(writer_->MayHaveCompiledMethods());
-
-    if (writer_->GetCompilerOptions().IsAotCompilationEnabled()) {
-      // Only need to set the dex cache if we have compilation. Other modes might have unloaded it.
-      if (dex_cache_ == nullptr || dex_cache_->GetDexFile() != dex_file) {
-        dex_cache_ = class_linker_->FindDexCache(Thread::Current(), *dex_file);
-        DCHECK(dex_cache_ != nullptr);
-      }
-    }
-  }
-
   bool VisitComplete() override {
     offset_ = writer_->relative_patcher_->WriteThunks(out_, offset_);
     if (UNLIKELY(offset_ == 0u)) {
@@ -1678,7 +1912,11 @@ class OatWriter::WriteCodeMethodVisitor : public OrderedMethodVisitor {
   bool VisitMethod(const OrderedMethodData& method_data) override
       REQUIRES_SHARED(Locks::mutator_lock_) {
     const MethodReference& method_ref = method_data.method_reference;
-    UpdateDexFileAndDexCache(method_ref.dex_file);
+    dex_file_ = method_ref.dex_file;
+    // Targets resolved ahead of time, if any, for the patches of this method.
+    const std::vector<uint32_t>* target_offsets =
+        (method_index_ < target_offsets_.size()) ? &target_offsets_[method_index_] : nullptr;
+    ++method_index_;
 
     OatClass* oat_class = method_data.oat_class;
     CompiledMethod* compiled_method = method_data.compiled_method;
@@ -1727,91 +1965,28 @@ class OatWriter::WriteCodeMethodVisitor : public OrderedMethodVisitor {
       offset_ += sizeof(method_header);
       DCHECK_OFFSET_();
 
-      if (!compiled_method->GetPatches().empty()) {
+      ArrayRef<const LinkerPatch> patches = compiled_method->GetPatches();
+      if (!patches.empty()) {
         patched_code_.assign(quick_code.begin(), quick_code.end());
         quick_code = ArrayRef<const uint8_t>(patched_code_);
-        for (const LinkerPatch& patch : compiled_method->GetPatches()) {
+        bool targets_resolved = (target_offsets != nullptr && !target_offsets->empty());
+        DCHECK(!targets_resolved || target_offsets->size() == patches.size());
+        if (!targets_resolved) {
+          resolver_.SetDexFile(dex_file_);
+        }
+        for (size_t i = 0; i != patches.size(); ++i) {
+          const LinkerPatch& patch = patches[i];
           uint32_t literal_offset = patch.LiteralOffset();
           switch (patch.GetType()) {
-            case LinkerPatch::Type::kIntrinsicReference: {
-              uint32_t target_offset = GetTargetIntrinsicReferenceOffset(patch);
-              writer_->relative_patcher_->PatchPcRelativeReference(&patched_code_,
-                                                                   patch,
-                                                                   offset_ + literal_offset,
-                                                                   target_offset);
-              break;
-            }
-            case LinkerPatch::Type::kDataBimgRelRo: {
-              uint32_t target_offset =
-                  writer_->data_bimg_rel_ro_start_ +
-                  writer_->data_bimg_rel_ro_entries_.Get(patch.BootImageOffset());
-              writer_->relative_patcher_->PatchPcRelativeReference(&patched_code_,
-                                                                   patch,
-                                                                   offset_ + literal_offset,
-                                                                   target_offset);
-              break;
-            }
-            case LinkerPatch::Type::kMethodBssEntry: {
-              uint32_t target_offset =
-                  writer_->bss_start_ + writer_->bss_method_entries_.Get(patch.TargetMethod());
-              writer_->relative_patcher_->PatchPcRelativeReference(&patched_code_,
-                                                                   patch,
-                                                                   offset_ + literal_offset,
-                                                                   target_offset);
-              break;
-            }
             case LinkerPatch::Type::kCallRelative: {
-              // NOTE: Relative calls across oat files are not supported.
-              uint32_t target_offset = GetTargetOffset(patch);
+              uint32_t target_offset =
+                  targets_resolved ? (*target_offsets)[i] : resolver_.GetTargetOffset(patch);
               writer_->relative_patcher_->PatchCall(&patched_code_,
                                                     literal_offset,
                                                     offset_ + literal_offset,
                                                     target_offset);
               break;
             }
-            case LinkerPatch::Type::kStringRelative: {
-              uint32_t target_offset = GetTargetObjectOffset(GetTargetString(patch));
-              writer_->relative_patcher_->PatchPcRelativeReference(&patched_code_,
-                                                                   patch,
-                                                                   offset_ + literal_offset,
-                                                                   target_offset);
-              break;
-            }
-            case LinkerPatch::Type::kStringBssEntry: {
-              StringReference ref(patch.TargetStringDexFile(), patch.TargetStringIndex());
-              uint32_t target_offset =
-                  writer_->bss_start_ + writer_->bss_string_entries_.Get(ref);
-              writer_->relative_patcher_->PatchPcRelativeReference(&patched_code_,
-                                                                   patch,
-                                                                   offset_ + literal_offset,
-                                                                   target_offset);
-              break;
-            }
-            case LinkerPatch::Type::kTypeRelative: {
-              uint32_t target_offset = GetTargetObjectOffset(GetTargetType(patch));
-              writer_->relative_patcher_->PatchPcRelativeReference(&patched_code_,
-                                                                   patch,
-                                                                   offset_ + literal_offset,
-                                                                   target_offset);
-              break;
-            }
-            case LinkerPatch::Type::kTypeBssEntry: {
-              TypeReference ref(patch.TargetTypeDexFile(), patch.TargetTypeIndex());
-              uint32_t target_offset = writer_->bss_start_ + writer_->bss_type_entries_.Get(ref);
-              writer_->relative_patcher_->PatchPcRelativeReference(&patched_code_,
-                                                                   patch,
-                                                                   offset_ + literal_offset,
-                                                                   target_offset);
-              break;
-            }
-            case LinkerPatch::Type::kMethodRelative: {
-              uint32_t target_offset = GetTargetMethodOffset(GetTargetMethod(patch));
-              writer_->relative_patcher_->PatchPcRelativeReference(&patched_code_,
-                                                                   patch,
-                                                                   offset_ + literal_offset,
-                                                                   target_offset);
-              break;
-            }
             case LinkerPatch::Type::kCallEntrypoint: {
               writer_->relative_patcher_->PatchEntrypointCall(&patched_code_,
                                                               patch,
@@ -1825,7 +2000,12 @@ class OatWriter::WriteCodeMethodVisitor : public OrderedMethodVisitor {
               break;
             }
             default: {
-              DCHECK(false) << "Unexpected linker patch type: " << patch.GetType();
+              uint32_t target_offset =
+                  targets_resolved ? (*target_offsets)[i] : resolver_.GetTargetOffset(patch);
+              writer_->relative_patcher_->PatchPcRelativeReference(&patched_code_,
+                                                                   patch,
+                                                                   offset_ + literal_offset,
+                                                                   target_offset);
               break;
             }
           }
@@ -1855,18 +2035,17 @@ class OatWriter::WriteCodeMethodVisitor : public OrderedMethodVisitor {
   size_t offset_;
 
   // Potentially varies with every different VisitMethod.
-  // Used to determine which DexCache to use when finding ArtMethods.
   const DexFile* dex_file_;
 
-  // Pointer size we are compiling to.
-  const PointerSize pointer_size_;
-  // The image writer's classloader, if there is one, else null.
-  ObjPtr<mirror::ClassLoader> class_loader_;
   // Stream to output file, where the OAT code will be written to.
   OutputStream* const out_;
   const size_t file_offset_;
-  ClassLinker* const class_linker_;
-  ObjPtr<mirror::DexCache> dex_cache_;
+  // Resolves the patch targets that were not resolved ahead of time.
+  PatchTargetResolver resolver_;
+  // Patch targets resolved ahead of time, indexed like the ordered methods. May be empty.
+  const std::vector<std::vector<uint32_t>> target_offsets_;
+  // Index of the method being visited in the ordered methods.
+  size_t method_index_;
   std::vector<uint8_t> patched_code_;
   const ScopedAssertNoThreadSuspension no_thread_suspension_;
 
@@ -1875,100 +2054,6 @@ class OatWriter::WriteCodeMethodVisitor : public OrderedMethodVisitor {
         << method_ref.PrettyMethod() << " to " << out_->GetLocation();
   }
 
-  ArtMethod* GetTargetMethod(const LinkerPatch& patch)
-      REQUIRES_SHARED(Locks::mutator_lock_) {
-    MethodReference ref = patch.TargetMethod();
-    ObjPtr<mirror::DexCache> dex_cache =
-        (dex_file_ == ref.dex_file) ? dex_cache_ : class_linker_->FindDexCache(
-            Thread::Current(), *ref.dex_file);
-    ArtMethod* method =
-        class_linker_->LookupResolvedMethod(ref.index, dex_cache, class_loader_);
-    CHECK(method != nullptr);
-    return method;
-  }
-
-  uint32_t GetTargetOffset(const LinkerPatch& patch) REQUIRES_SHARED(Locks::mutator_lock_) {
-    uint32_t target_offset = writer_->relative_patcher_->GetOffset(patch.TargetMethod());
-    // If there's no new compiled code, either we're compiling an app and the target method
-    // is in the boot image, or we need to point to the correct trampoline.
-    if (UNLIKELY(target_offset == 0)) {
-      ArtMethod* target = GetTargetMethod(patch);
-      DCHECK(target != nullptr);
-      const void* oat_code_offset =
-          target->GetEntryPointFromQuickCompiledCodePtrSize(pointer_size_);
-      if (oat_code_offset != nullptr) {
-        DCHECK(!writer_->GetCompilerOptions().IsBootImage());
-        DCHECK(!Runtime::Current()->GetClassLinker()->IsQuickResolutionStub(oat_code_offset));
-        DCHECK(!Runtime::Current()->GetClassLinker()->IsQuickToInterpreterBridge(oat_code_offset));
-        DCHECK(!Runtime::Current()->GetClassLinker()->IsQuickGenericJniStub(oat_code_offset));
-        target_offset = PointerToLowMemUInt32(oat_code_offset);
-      } else {
-        target_offset = target->IsNative()
-            ? writer_->oat_header_->GetQuickGenericJniTrampolineOffset()
-            : writer_->oat_header_->GetQuickToInterpreterBridgeOffset();
-      }
-    }
-    return target_offset;
-  }
-
-  ObjPtr<mirror::DexCache> GetDexCache(const DexFile* target_dex_file)
-      REQUIRES_SHARED(Locks::mutator_lock_) {
-    return (target_dex_file == dex_file_)
-        ? dex_cache_
-        : class_linker_->FindDexCache(Thread::Current(), *target_dex_file);
-  }
-
-  ObjPtr<mirror::Class> GetTargetType(const LinkerPatch& patch)
-      REQUIRES_SHARED(Locks::mutator_lock_) {
-    DCHECK(writer_->HasImage());
-    ObjPtr<mirror::DexCache> dex_cache = GetDexCache(patch.TargetTypeDexFile());
-    ObjPtr<mirror::Class> type =
-        class_linker_->LookupResolvedType(patch.TargetTypeIndex(), dex_cache, class_loader_);
-    CHECK(type != nullptr);
-    return type;
-  }
-
-  ObjPtr<mirror::String> GetTargetString(const LinkerPatch& patch)
-      REQUIRES_SHARED(Locks::mutator_lock_) {
-    ClassLinker* linker = Runtime::Current()->GetClassLinker();
-    ObjPtr<mirror::String> string =
-        linker->LookupString(patch.TargetStringIndex(), GetDexCache(patch.TargetStringDexFile()));
-    DCHECK(string != nullptr);
-    DCHECK(writer_->GetCompilerOptions().IsBootImage() ||
-           Runtime::Current()->GetHeap()->ObjectIsInBootImageSpace(string));
-    return string;
-  }
-
-  uint32_t GetTargetIntrinsicReferenceOffset(const LinkerPatch& patch)
-      REQUIRES_SHARED(Locks::mutator_lock_) {
-    DCHECK(writer_->GetCompilerOptions().IsBootImage());
-    const void* address =
-        writer_->image_writer_->GetIntrinsicReferenceAddress(patch.IntrinsicData());
-    size_t oat_index = writer_->image_writer_->GetOatIndexForDexFile(dex_file_);
-    uintptr_t oat_data_begin = writer_->image_writer_->GetOatDataBegin(oat_index);
-    // TODO: Clean up offset types. The target offset must be treated as signed.
-    return static_cast<uint32_t>(reinterpret_cast<uintptr_t>(address) - oat_data_begin);
-  }
-
-  uint32_t GetTargetMethodOffset(ArtMethod* method) REQUIRES_SHARED(Locks::mutator_lock_) {
-    DCHECK(writer_->GetCompilerOptions().IsBootImage());
-    method = writer_->image_writer_->GetImageMethodAddress(method);
-    size_t oat_index = writer_->image_writer_->GetOatIndexForDexFile(dex_file_);
-    uintptr_t oat_data_begin = writer_->image_writer_->GetOatDataBegin(oat_index);
-    // TODO: Clean up offset types. The target offset must be treated as signed.
-    return static_cast<uint32_t>(reinterpret_cast<uintptr_t>(method) - oat_data_begin);
-  }
-
-  uint32_t GetTargetObjectOffset(ObjPtr<mirror::Object> object)
-      REQUIRES_SHARED(Locks::mutator_lock_) {
-    DCHECK(writer_->GetCompilerOptions().IsBootImage());
-    object = writer_->image_writer_->GetImageAddress(object.Ptr());
-    size_t oat_index = writer_->image_writer_->GetOatIndexForDexFile(dex_file_);
-    uintptr_t oat_data_begin = writer_->image_writer_->GetOatDataBegin(oat_index);
-    // TODO: Clean up offset types. The target offset must be treated as signed.
-    return static_cast<uint32_t>(reinterpret_cast<uintptr_t>(object.Ptr()) - oat_data_begin);
-  }
-
   void PatchObjectAddress(std::vector<uint8_t>* code, uint32_t offset, mirror::Object* object)
       REQUIRES_SHARED(Locks::mutator_lock_) {
     if (writer_->GetCompilerOptions().IsBootImage()) {
@@ -2803,6 +2888,9 @@ bool OatWriter::CheckOatSize(OutputStream* out, size_t file_offset, size_t relat
     #undef DO_STAT
 
     VLOG(compiler) << "size_total=" << PrettySize(size_total) << " (" << size_total << "B)";
+    VLOG(compiler) << "size_deduped_code_=" << PrettySize(size_deduped_code_)
+                   << " (" << size_deduped_code_ << "B) in " << num_deduped_methods_ << " methods";
+    VLOG(compiler) << "num_calls_via_thunks_=" << num_calls_via_thunks_;
 
     CHECK_EQ(vdex_size_ + oat_size_, size_total);
     CHECK_EQ(file_offset + size_total - vdex_size_, static_cast<size_t>(oat_end_file_offset));
@@ -3099,6 +3187,30 @@ size_t OatWriter::WriteCode(OutputStream* out, size_t file_offset, size_t relati
   return relative_offset;
 }
 
+std::vector<std::vector<uint32_t>> OatWriter::ResolvePatchTargets(
+    const OrderedMethodList& ordered_methods) {
+  std::vector<std::vector<uint32_t>> target_offsets;
+  size_t thread_count = (compiler_driver_ != nullptr) ? compiler_driver_->GetThreadCount() : 1u;
+  if (thread_count <= 1u || ordered_methods.size() < kMinMethodsForParallelPatchResolution) {
+    // Not worth starting threads; the targets are resolved while writing the code.
+    return target_offsets;
+  }
+  TimingLogger::ScopedTiming split("ResolvePatchTargets", timings_);
+  target_offsets.resize(ordered_methods.size());
+  Thread* self = Thread::Current();
+  // The current thread takes part in the work.
+  ThreadPool thread_pool("OatWriter patch target resolution", thread_count - 1u);
+  std::atomic<size_t> next_index(0u);
+  for (size_t i = 0; i != thread_count; ++i) {
+    thread_pool.AddTask(
+        self, new ResolvePatchTargetsTask(this, &ordered_methods, &next_index, &target_offsets));
+  }
+  thread_pool.StartWorkers(self);
+  thread_pool.Wait(self, /*do_work=*/ true, /*may_hold_locks=*/ false);
+  thread_pool.StopWorkers(self);
+  return target_offsets;
+}
+
 size_t OatWriter::WriteCodeDexFiles(OutputStream* out,
                                     size_t file_offset,
                                     size_t relative_offset) {
@@ -3113,15 +3225,19 @@ size_t OatWriter::WriteCodeDexFiles(OutputStream* out,
 
     return relative_offset;
   }
-  ScopedObjectAccess soa(Thread::Current());
   DCHECK(ordered_methods_ != nullptr);
   std::unique_ptr<OrderedMethodList> ordered_methods_ptr =
       std::move(ordered_methods_);
+  // The code must be written out in order, but most of the patching work is looking up
+  // targets, which is independent for each method. Do that on all threads first.
+  std::vector<std::vector<uint32_t>> target_offsets = ResolvePatchTargets(*ordered_methods_ptr);
+  ScopedObjectAccess soa(Thread::Current());
   WriteCodeMethodVisitor visitor(this,
                                  out,
                                  file_offset,
                                  relative_offset,
-                                 std::move(*ordered_methods_ptr));
+                                 std::move(*ordered_methods_ptr),
+                                 std::move(target_offsets));
   if (UNLIKELY(!visitor.Visit())) {
     return 0;
   }
@@ -3130,6 +3246,7 @@ size_t OatWriter::WriteCodeDexFiles(OutputStream* out,
   size_code_alignment_ += relative_patcher_->CodeAlignmentSize();
   size_relative_call_thunks_ += relative_patcher_->RelativeCallThunksSize();
   size_misc_thunks_ += relative_patcher_->MiscThunksSize();
+  num_calls_via_thunks_ += relative_patcher_->CallsViaThunks();
 
   return relative_offset;
 }
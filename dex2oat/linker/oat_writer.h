@@ -279,6 +279,8 @@ class OatWriter {
   class InitCodeMethodVisitor;
   class InitMapMethodVisitor;
   class InitImageMethodVisitor;
+  class PatchTargetResolver;
+  class ResolvePatchTargetsTask;
   class WriteCodeMethodVisitor;
   class WriteMapMethodVisitor;
   class WriteQuickeningInfoMethodVisitor;
@@ -500,10 +502,15 @@ class OatWriter {
   uint32_t size_method_header_;
   uint32_t size_code_;
   uint32_t size_code_alignment_;
+  // Code shared with an identical method instead of being written again. Not part of the file.
+  uint32_t size_deduped_code_;
+  uint32_t num_deduped_methods_;
   uint32_t size_data_bimg_rel_ro_;
   uint32_t size_data_bimg_rel_ro_alignment_;
   uint32_t size_relative_call_thunks_;
   uint32_t size_misc_thunks_;
+  // Method calls going through a relative call thunk. Not a size.
+  uint32_t num_calls_via_thunks_;
   uint32_t size_vmap_table_;
   uint32_t size_method_info_;
   uint32_t size_oat_dex_file_location_size_;
@@ -546,6 +553,11 @@ class OatWriter {
   // This pointer is only non-null after InitOatCodeDexFiles succeeds.
   std::unique_ptr<OrderedMethodList> ordered_methods_;
 
+  // Resolve the patch targets of `ordered_methods` on the compiler driver's threads, indexed
+  // like `ordered_methods`. Returns an empty list when the targets are better resolved while
+  // writing the code.
+  std::vector<std::vector<uint32_t>> ResolvePatchTargets(const OrderedMethodList& ordered_methods);
+
   // Container of shared dex data.
   std::unique_ptr<DexContainer> dex_container_;
 
@@ -110,6 +110,11 @@ class RelativePatcher {
     return size_misc_thunks_;
   }
 
+  // Number of method calls which are out of direct branch range and go through a thunk.
+  uint32_t CallsViaThunks() const {
+    return num_calls_via_thunks_;
+  }
+
   // Reserve space for thunks if needed before a method, return adjusted offset.
   virtual uint32_t ReserveSpace(uint32_t offset,
                                 const CompiledMethod* compiled_method,
@@ -154,7 +159,12 @@ class RelativePatcher {
   RelativePatcher()
       : size_code_alignment_(0u),
         size_relative_call_thunks_(0u),
-        size_misc_thunks_(0u) {
+        size_misc_thunks_(0u),
+        num_calls_via_thunks_(0u) {
+  }
+
+  void RecordCallViaThunk() {
+    ++num_calls_via_thunks_;
   }
 
   bool WriteCodeAlignment(OutputStream* out, uint32_t aligned_code_delta);
@@ -165,6 +175,7 @@ class RelativePatcher {
   uint32_t size_code_alignment_;
   uint32_t size_relative_call_thunks_;
   uint32_t size_misc_thunks_;
+  uint32_t num_calls_via_thunks_;
 
   DISALLOW_COPY_AND_ASSIGN(RelativePatcher);
 };
@@ -1478,6 +1478,49 @@ TEST_F(VerifierDepsTest, MultiDexVerification) {
   ASSERT_FALSE(buffer.empty());
 }
 
+TEST_F(VerifierDepsTest, MultiDexValidationPerDexFile) {
+  VerifyDexFile("VerifierDepsMulti");
+  ASSERT_EQ(NumberOfCompiledDexFiles(), 2u);
+
+  std::vector<uint8_t> buffer;
+  verifier_deps_->Encode(dex_files_, &buffer);
+  ASSERT_FALSE(buffer.empty());
+
+  ScopedObjectAccess soa(Thread::Current());
+  jobject second_loader = LoadDex("VerifierDepsMulti");
+  const auto& second_dex_files = GetDexFiles(second_loader);
+  ASSERT_EQ(second_dex_files.size(), 2u);
+
+  VerifierDeps decoded_deps(second_dex_files, /*output_only=*/ false);
+  ASSERT_TRUE(decoded_deps.ParseStoredData(second_dex_files, ArrayRef<const uint8_t>(buffer)));
+
+  StackHandleScope<1> hs(soa.Self());
+  Handle<mirror::ClassLoader> new_class_loader =
+      hs.NewHandle<mirror::ClassLoader>(soa.Decode<mirror::ClassLoader>(second_loader));
+
+  std::string error_msg;
+  for (const DexFile* dex_file : second_dex_files) {
+    ASSERT_TRUE(decoded_deps.ValidateDependencies(soa.Self(),
+                                                  new_class_loader,
+                                                  std::vector<const DexFile*>(),
+                                                  *dex_file,
+                                                  &error_msg)) << error_msg;
+  }
+
+  // Clearing the dependencies of one dex file leaves the other one untouched.
+  const std::vector<bool> verified_classes = decoded_deps.GetVerifiedClasses(*second_dex_files[1]);
+  decoded_deps.ClearDependencies(*second_dex_files[0]);
+  for (bool verified : decoded_deps.GetVerifiedClasses(*second_dex_files[0])) {
+    ASSERT_FALSE(verified);
+  }
+  ASSERT_EQ(verified_classes, decoded_deps.GetVerifiedClasses(*second_dex_files[1]));
+  ASSERT_TRUE(decoded_deps.ValidateDependencies(soa.Self(),
+                                                new_class_loader,
+                                                std::vector<const DexFile*>(),
+                                                *second_dex_files[1],
+                                                &error_msg)) << error_msg;
+}
+
 TEST_F(VerifierDepsTest, NotAssignable_InterfaceWithClassInBoot) {
   ASSERT_TRUE(TestAssignabilityRecording(/* dst= */ "Ljava/lang/Exception;",
                                          /* src= */ "LIface;",
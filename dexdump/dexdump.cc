@@ -34,16 +34,23 @@
 
 #include "dexdump.h"
 
+#include <fcntl.h>
 #include <inttypes.h>
 #include <stdio.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
+#include <algorithm>
+#include <atomic>
 #include <memory>
 #include <sstream>
+#include <thread>
 #include <vector>
 
-#include "android-base/file.h"
 #include "android-base/logging.h"
+#include "android-base/mapped_file.h"
 #include "android-base/stringprintf.h"
+#include "android-base/unique_fd.h"
 
 #include "dex/class_accessor-inl.h"
 #include "dex/code_item_accessors-inl.h"
@@ -62,9 +69,10 @@ namespace art {
 struct Options gOptions;
 
 /*
- * Output file. Defaults to stdout.
+ * Output file. Defaults to stdout. Thread-local so that classes dumped in
+ * parallel each go to their own buffer.
  */
-FILE* gOutFile = stdout;
+thread_local FILE* gOutFile = stdout;
 
 /*
  * Data types that match the definitions in the VM specification.
@@ -1796,6 +1804,50 @@ static void dumpCallSite(const DexFile* pDexFile, u4 idx) {
   }
 }
 
+/*
+ * Dumps all classes on gOptions.numThreads threads. Each class is printed to its
+ * own memory stream and the streams are written out in class order, so the output
+ * is the same as the serial one. Only used for the plain layout, since the XML
+ * layout groups consecutive classes into packages. Classes are dumped in batches
+ * to bound the memory held by the streams.
+ */
+static void dumpClassesInParallel(const DexFile* pDexFile, u4 classDefsSize) {
+  static constexpr u4 kClassesPerBatch = 1024;
+  FILE* const outFile = gOutFile;
+  std::vector<std::string> outputs(std::min(classDefsSize, kClassesPerBatch));
+  for (u4 begin = 0; begin < classDefsSize; begin += kClassesPerBatch) {
+    const u4 end = std::min(classDefsSize, begin + kClassesPerBatch);
+    std::atomic<u4> nextClass(begin);
+    auto dumpClasses = [&]() {
+      for (u4 j = nextClass++; j < end; j = nextClass++) {
+        char* buffer = nullptr;
+        size_t size = 0;
+        gOutFile = open_memstream(&buffer, &size);
+        CHECK(gOutFile != nullptr) << "open_memstream failed";
+        char* package = nullptr;  // Only used by the XML layout.
+        dumpClass(pDexFile, j, &package);
+        fclose(gOutFile);
+        outputs[j - begin].assign(buffer, size);
+        free(buffer);
+      }
+    };
+    const u4 numThreads = std::min(static_cast<u4>(gOptions.numThreads), end - begin);
+    std::vector<std::thread> threads;
+    for (u4 t = 1; t < numThreads; t++) {
+      threads.emplace_back(dumpClasses);
+    }
+    dumpClasses();
+    for (std::thread& thread : threads) {
+      thread.join();
+    }
+    gOutFile = outFile;
+    for (u4 j = begin; j < end; j++) {
+      fwrite(outputs[j - begin].data(), 1, outputs[j - begin].size(), gOutFile);
+      outputs[j - begin].clear();
+    }
+  }
+}
+
 /*
  * Dumps the requested sections of the file.
  */
@@ -1823,9 +1875,13 @@ static void processDexFile(const char* fileName,
   // Iterate over all classes.
   char* package = nullptr;
   const u4 classDefsSize = pDexFile->GetHeader().class_defs_size_;
-  for (u4 j = 0; j < classDefsSize; j++) {
-    dumpClass(pDexFile, j, &package);
-  }  // for
+  if (gOptions.numThreads > 1 && gOptions.outputFormat == OUTPUT_PLAIN) {
+    dumpClassesInParallel(pDexFile, classDefsSize);
+  } else {
+    for (u4 j = 0; j < classDefsSize; j++) {
+      dumpClass(pDexFile, j, &package);
+    }  // for
+  }
 
   // Iterate over all method handles.
   for (u4 j = 0; j < pDexFile->NumMethodHandles(); ++j) {
@@ -1849,6 +1905,33 @@ static void processDexFile(const char* fileName,
   }
 }
 
+/*
+ * Maps a whole file read-only. Plain dex files are then used in place rather than
+ * copied, and only compressed zip entries need to be extracted.
+ */
+static std::unique_ptr<android::base::MappedFile> mapFile(const char* fileName) {
+  android::base::unique_fd fd(TEMP_FAILURE_RETRY(open(fileName, O_RDONLY | O_CLOEXEC)));
+  if (fd == -1) {
+    PLOG(ERROR) << "Can't open " << fileName;
+    return nullptr;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    PLOG(ERROR) << "Can't stat " << fileName;
+    return nullptr;
+  }
+  if (st.st_size == 0) {
+    LOG(ERROR) << "Empty file " << fileName;
+    return nullptr;
+  }
+  std::unique_ptr<android::base::MappedFile> map =
+      android::base::MappedFile::FromFd(fd, 0, st.st_size, PROT_READ);
+  if (map == nullptr) {
+    PLOG(ERROR) << "Can't map " << fileName;
+  }
+  return map;
+}
+
 /*
  * Processes a single file (either direct .dex or indirect .zip/.jar/.apk).
  */
@@ -1859,20 +1942,18 @@ int processFile(const char* fileName) {
 
   const bool kVerifyChecksum = !gOptions.ignoreBadChecksum;
   const bool kVerify = !gOptions.disableVerifier;
-  std::string content;
   // If the file is not a .dex file, the function tries .zip/.jar/.apk files,
   // all of which are Zip archives with "classes.dex" inside.
-  // TODO: add an api to android::base to read a std::vector<uint8_t>.
-  if (!android::base::ReadFileToString(fileName, &content)) {
-    LOG(ERROR) << "ReadFileToString failed";
+  std::unique_ptr<android::base::MappedFile> content = mapFile(fileName);
+  if (content == nullptr) {
     return -1;
   }
   const DexFileLoader dex_file_loader;
   DexFileLoaderErrorCode error_code;
   std::string error_msg;
   std::vector<std::unique_ptr<const DexFile>> dex_files;
-  if (!dex_file_loader.OpenAll(reinterpret_cast<const uint8_t*>(content.data()),
-                               content.size(),
+  if (!dex_file_loader.OpenAll(reinterpret_cast<const uint8_t*>(content->data()),
+                               content->size(),
                                fileName,
                                kVerify,
                                kVerifyChecksum,
@@ -50,11 +50,12 @@ struct Options {
   bool verbose;
   OutputFormat outputFormat;
   const char* outputFileName;
+  int numThreads;
 };
 
 /* Prototypes. */
 extern struct Options gOptions;
-extern FILE* gOutFile;
+extern thread_local FILE* gOutFile;
 int processFile(const char* fileName);
 
 }  // namespace art
@@ -25,6 +25,7 @@
 #include "dexdump.h"
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
 
@@ -40,7 +41,7 @@ static const char* gProgName = "dexdump";
 static void usage() {
   LOG(ERROR) << "Copyright (C) 2007 The Android Open Source Project\n";
   LOG(ERROR) << gProgName << ": [-a] [-c] [-d] [-e] [-f] [-h] [-i] [-j] [-l layout] [-o outfile]"
-                  " dexfile...\n";
+                  " [-t threads] dexfile...\n";
   LOG(ERROR) << " -a : display annotations";
   LOG(ERROR) << " -c : verify checksum and exit";
   LOG(ERROR) << " -d : disassemble code sections";
@@ -52,6 +53,7 @@ static void usage() {
   LOG(ERROR) << " -j : disable dex file verification";
   LOG(ERROR) << " -l : output layout, either 'plain' or 'xml'";
   LOG(ERROR) << " -o : output file name (defaults to stdout)";
+  LOG(ERROR) << " -t : number of threads dumping classes, for the plain layout (defaults to 1)";
 }
 
 /*
@@ -62,10 +64,11 @@ int dexdumpDriver(int argc, char** argv) {
   bool wantUsage = false;
   memset(&gOptions, 0, sizeof(gOptions));
   gOptions.verbose = true;
+  gOptions.numThreads = 1;
 
   // Parse all arguments.
   while (true) {
-    const int ic = getopt(argc, argv, "acdefghijl:o:");
+    const int ic = getopt(argc, argv, "acdefghijl:o:t:");
     if (ic < 0) {
       break;  // done
     }
@@ -110,6 +113,12 @@ int dexdumpDriver(int argc, char** argv) {
       case 'o':  // output file
         gOptions.outputFileName = optarg;
         break;
+      case 't':  // number of threads
+        gOptions.numThreads = atoi(optarg);
+        if (gOptions.numThreads <= 0) {
+          wantUsage = true;
+        }
+        break;
       default:
         wantUsage = true;
         break;
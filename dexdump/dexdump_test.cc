@@ -21,6 +21,7 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include "android-base/file.h"
 #include "arch/instruction_set.h"
 #include "base/os.h"
 #include "base/utils.h"
@@ -72,6 +73,21 @@ TEST_F(DexDumpTest, FullPlainOutput) {
     dex_file_}, &error_msg)) << error_msg;
 }
 
+TEST_F(DexDumpTest, ParallelPlainOutput) {
+  ScratchFile serial_output;
+  ScratchFile parallel_output;
+  std::string error_msg;
+  ASSERT_TRUE(Exec({"-d", "-h", "-l", "plain", "-o", serial_output.GetFilename(),
+    dex_file_}, &error_msg)) << error_msg;
+  ASSERT_TRUE(Exec({"-d", "-h", "-l", "plain", "-t", "4", "-o", parallel_output.GetFilename(),
+    dex_file_}, &error_msg)) << error_msg;
+  std::string serial;
+  std::string parallel;
+  ASSERT_TRUE(android::base::ReadFileToString(serial_output.GetFilename(), &serial));
+  ASSERT_TRUE(android::base::ReadFileToString(parallel_output.GetFilename(), &parallel));
+  EXPECT_EQ(serial, parallel);
+}
+
 TEST_F(DexDumpTest, XMLOutput) {
   std::string error_msg;
   ASSERT_TRUE(Exec({"-l", "xml", "-o", "/dev/null",
@@ -208,6 +208,58 @@ void CompactDexWriter::WriteDebugInfoItem(Stream* stream, dex_ir::DebugInfoItem*
   stream->Write(debug_info->GetDebugInfo(), debug_info->GetDebugInfoSize());
 }
 
+void CompactDexWriter::WriteTypeList(Stream* stream, dex_ir::TypeList* type_list) {
+  ScopedDataSectionItem data_item(stream,
+                                  type_list,
+                                  SectionAlignment(DexFile::kDexTypeTypeList),
+                                  data_item_dedupe_);
+  DexWriter::WriteTypeList(stream, type_list);
+}
+
+void CompactDexWriter::WriteEncodedArrayItem(Stream* stream,
+                                             dex_ir::EncodedArrayItem* encoded_array) {
+  ScopedDataSectionItem data_item(stream,
+                                  encoded_array,
+                                  SectionAlignment(DexFile::kDexTypeEncodedArrayItem),
+                                  data_item_dedupe_);
+  DexWriter::WriteEncodedArrayItem(stream, encoded_array);
+}
+
+void CompactDexWriter::WriteAnnotation(Stream* stream, dex_ir::AnnotationItem* annotation) {
+  ScopedDataSectionItem data_item(stream,
+                                  annotation,
+                                  SectionAlignment(DexFile::kDexTypeAnnotationItem),
+                                  data_item_dedupe_);
+  DexWriter::WriteAnnotation(stream, annotation);
+}
+
+void CompactDexWriter::WriteAnnotationSet(Stream* stream,
+                                          dex_ir::AnnotationSetItem* annotation_set) {
+  ScopedDataSectionItem data_item(stream,
+                                  annotation_set,
+                                  SectionAlignment(DexFile::kDexTypeAnnotationSetItem),
+                                  data_item_dedupe_);
+  DexWriter::WriteAnnotationSet(stream, annotation_set);
+}
+
+void CompactDexWriter::WriteAnnotationSetRef(Stream* stream,
+                                             dex_ir::AnnotationSetRefList* annotation_set_ref) {
+  ScopedDataSectionItem data_item(stream,
+                                  annotation_set_ref,
+                                  SectionAlignment(DexFile::kDexTypeAnnotationSetRefList),
+                                  data_item_dedupe_);
+  DexWriter::WriteAnnotationSetRef(stream, annotation_set_ref);
+}
+
+void CompactDexWriter::WriteAnnotationsDirectory(
+    Stream* stream, dex_ir::AnnotationsDirectoryItem* annotations_directory) {
+  ScopedDataSectionItem data_item(stream,
+                                  annotations_directory,
+                                  SectionAlignment(DexFile::kDexTypeAnnotationsDirectoryItem),
+                                  data_item_dedupe_);
+  DexWriter::WriteAnnotationsDirectory(stream, annotations_directory);
+}
+
 
 CompactDexWriter::Deduper::Deduper(bool enabled, DexContainer::Section* section)
     : enabled_(enabled),
@@ -257,8 +309,7 @@ void CompactDexWriter::SortDebugInfosByMethodIndex() {
   }
   std::sort(header_->DebugInfoItems().begin(),
             header_->DebugInfoItems().end(),
-            [&](const std::unique_ptr<dex_ir::DebugInfoItem>& a,
-                const std::unique_ptr<dex_ir::DebugInfoItem>& b) {
+            [&](const auto& a, const auto& b) {
     auto it_a = method_idx_map.find(a.get());
     auto it_b = method_idx_map.find(b.get());
     uint32_t idx_a = it_a != method_idx_map.end() ? it_a->second : 0u;
@@ -155,6 +155,23 @@ class CompactDexWriter : public DexWriter {
 
   void WriteDebugInfoItem(Stream* stream, dex_ir::DebugInfoItem* debug_info) override;
 
+  // Data items that only contain indices and offsets into the shared data section are
+  // interpreted relative to the referencing dex file, so identical items can be shared between
+  // all the dex files of the container.
+  void WriteTypeList(Stream* stream, dex_ir::TypeList* type_list) override;
+
+  void WriteEncodedArrayItem(Stream* stream, dex_ir::EncodedArrayItem* encoded_array) override;
+
+  void WriteAnnotation(Stream* stream, dex_ir::AnnotationItem* annotation) override;
+
+  void WriteAnnotationSet(Stream* stream, dex_ir::AnnotationSetItem* annotation_set) override;
+
+  void WriteAnnotationSetRef(Stream* stream,
+                             dex_ir::AnnotationSetRefList* annotation_set_ref) override;
+
+  void WriteAnnotationsDirectory(Stream* stream,
+                                 dex_ir::AnnotationsDirectoryItem* annotations_directory) override;
+
   void SortDebugInfosByMethodIndex();
 
   CompactDexLevel GetCompactDexLevel() const;
@@ -23,9 +23,13 @@
 
 #include <vector>
 
+#include "base/arena_allocator.h"
 #include "base/iteration_range.h"
 #include "base/leb128.h"
+#include "base/malloc_arena_pool.h"
 #include "base/safe_map.h"
+#include "base/scoped_arena_allocator.h"
+#include "base/scoped_arena_containers.h"
 #include "base/stl_util.h"
 #include "dex/dex_file-inl.h"
 #include "dex/dex_file_types.h"
@@ -209,7 +213,8 @@ template<class T> class Iterator : public std::iterator<std::random_access_itera
   friend bool operator<(const Iterator<U>& lhs, const Iterator<U>& rhs);
 };
 
-// Collections become owners of the objects added by moving them into unique pointers.
+// Collections become owners of the objects added by moving them into unique pointers. The objects
+// are allocated from the arena of the header, which releases the memory all at once.
 class CollectionBase {
  public:
   CollectionBase() = default;
@@ -229,10 +234,10 @@ class CollectionBase {
 
 template<class T> class CollectionVector : public CollectionBase {
  public:
-  using ElementType = std::unique_ptr<T>;
+  using ElementType = ArenaUniquePtr<T>;
 
-  CollectionVector() { }
-  explicit CollectionVector(size_t size) {
+  explicit CollectionVector(ScopedArenaAllocator* allocator) : allocator_(allocator) { }
+  CollectionVector(ScopedArenaAllocator* allocator, size_t size) : allocator_(allocator) {
     // Preallocate so that assignment does not invalidate pointers into the vector.
     collection_.reserve(size);
   }
@@ -240,8 +245,9 @@ template<class T> class CollectionVector : public CollectionBase {
 
   template<class... Args>
   T* CreateAndAddItem(Args&&... args) {
-    T* object = new T(std::forward<Args>(args)...);
-    collection_.push_back(std::unique_ptr<T>(object));
+    void* storage = allocator_->Alloc(sizeof(T), kArenaAllocMisc);
+    T* object = new (storage) T(std::forward<Args>(args)...);
+    collection_.push_back(ElementType(object));
     return object;
   }
 
@@ -277,14 +283,18 @@ template<class T> class CollectionVector : public CollectionBase {
   std::vector<ElementType> collection_;
 
  private:
+  ScopedArenaAllocator* const allocator_;
+
   DISALLOW_COPY_AND_ASSIGN(CollectionVector);
 };
 
 template<class T> class IndexedCollectionVector : public CollectionVector<T> {
  public:
-  using Vector = std::vector<std::unique_ptr<T>>;
-  IndexedCollectionVector() = default;
-  explicit IndexedCollectionVector(size_t size) : CollectionVector<T>(size) { }
+  using Vector = std::vector<ArenaUniquePtr<T>>;
+  explicit IndexedCollectionVector(ScopedArenaAllocator* allocator)
+      : CollectionVector<T>(allocator) { }
+  IndexedCollectionVector(ScopedArenaAllocator* allocator, size_t size)
+      : CollectionVector<T>(allocator, size) { }
 
   template <class... Args>
   T* CreateAndAddIndexedItem(uint32_t index, Args&&... args) {
@@ -360,18 +370,23 @@ class Header : public Item {
          uint32_t data_size,
          uint32_t data_offset,
          bool support_default_methods)
-      : Item(0, kHeaderItemSize), support_default_methods_(support_default_methods) {
-    ConstructorHelper(magic,
-                      checksum,
-                      signature,
-                      endian_tag,
-                      file_size,
-                      header_size,
-                      link_size,
-                      link_offset,
-                      data_size,
-                      data_offset);
-  }
+      : Header(magic,
+               checksum,
+               signature,
+               endian_tag,
+               file_size,
+               header_size,
+               link_size,
+               link_offset,
+               data_size,
+               data_offset,
+               support_default_methods,
+               /*num_string_ids=*/ 0u,
+               /*num_type_ids=*/ 0u,
+               /*num_proto_ids=*/ 0u,
+               /*num_field_ids=*/ 0u,
+               /*num_method_ids=*/ 0u,
+               /*num_class_defs=*/ 0u) { }
 
   Header(const uint8_t* magic,
          uint32_t checksum,
@@ -392,12 +407,27 @@ class Header : public Item {
          uint32_t num_class_defs)
       : Item(0, kHeaderItemSize),
         support_default_methods_(support_default_methods),
-        string_ids_(num_string_ids),
-        type_ids_(num_type_ids),
-        proto_ids_(num_proto_ids),
-        field_ids_(num_field_ids),
-        method_ids_(num_method_ids),
-        class_defs_(num_class_defs) {
+        arena_stack_(&arena_pool_),
+        allocator_(&arena_stack_),
+        string_ids_(&allocator_, num_string_ids),
+        type_ids_(&allocator_, num_type_ids),
+        proto_ids_(&allocator_, num_proto_ids),
+        field_ids_(&allocator_, num_field_ids),
+        method_ids_(&allocator_, num_method_ids),
+        class_defs_(&allocator_, num_class_defs),
+        call_site_ids_(&allocator_),
+        method_handle_items_(&allocator_),
+        string_datas_(&allocator_),
+        type_lists_(&allocator_),
+        encoded_array_items_(&allocator_),
+        annotation_items_(&allocator_),
+        annotation_set_items_(&allocator_),
+        annotation_set_ref_lists_(&allocator_),
+        annotations_directory_items_(&allocator_),
+        hiddenapi_class_datas_(&allocator_),
+        debug_info_items_(&allocator_),
+        code_items_(&allocator_),
+        class_datas_(&allocator_) {
     ConstructorHelper(magic,
                       checksum,
                       signature,
@@ -546,6 +576,11 @@ class Header : public Item {
     memcpy(signature_, signature, sizeof(signature_));
   }
 
+  // Backing memory for the IR data, declared before the collections that use it.
+  MallocArenaPool arena_pool_;
+  ArenaStack arena_stack_;
+  ScopedArenaAllocator allocator_;
+
   // Collection vectors own the IR data.
   IndexedCollectionVector<StringId> string_ids_;
   IndexedCollectionVector<TypeId> type_ids_;
@@ -278,19 +278,23 @@ void DexWriter::WriteTypeIds(Stream* stream) {
   }
 }
 
-void DexWriter::WriteTypeLists(Stream* stream) {
+void DexWriter::WriteTypeList(Stream* stream, dex_ir::TypeList* type_list) {
   uint32_t size[1];
   uint16_t list[1];
+  stream->AlignTo(SectionAlignment(DexFile::kDexTypeTypeList));
+  size[0] = type_list->GetTypeList()->size();
+  ProcessOffset(stream, type_list);
+  stream->Write(size, sizeof(uint32_t));
+  for (const dex_ir::TypeId* type_id : *type_list->GetTypeList()) {
+    list[0] = type_id->GetIndex();
+    stream->Write(list, sizeof(uint16_t));
+  }
+}
+
+void DexWriter::WriteTypeLists(Stream* stream) {
   const uint32_t start = stream->Tell();
   for (auto& type_list : header_->TypeLists()) {
-    stream->AlignTo(SectionAlignment(DexFile::kDexTypeTypeList));
-    size[0] = type_list->GetTypeList()->size();
-    ProcessOffset(stream, type_list.get());
-    stream->Write(size, sizeof(uint32_t));
-    for (const dex_ir::TypeId* type_id : *type_list->GetTypeList()) {
-      list[0] = type_id->GetIndex();
-      stream->Write(list, sizeof(uint16_t));
-    }
+    WriteTypeList(stream, type_list.get());
   }
   if (compute_offsets_ && start != stream->Tell()) {
     header_->TypeLists().SetOffset(start);
@@ -351,112 +355,134 @@ void DexWriter::WriteMethodIds(Stream* stream) {
   }
 }
 
+void DexWriter::WriteEncodedArrayItem(Stream* stream, dex_ir::EncodedArrayItem* encoded_array) {
+  stream->AlignTo(SectionAlignment(DexFile::kDexTypeEncodedArrayItem));
+  ProcessOffset(stream, encoded_array);
+  WriteEncodedArray(stream, encoded_array->GetEncodedValues());
+}
+
 void DexWriter::WriteEncodedArrays(Stream* stream) {
   const uint32_t start = stream->Tell();
   for (auto& encoded_array : header_->EncodedArrayItems()) {
-    stream->AlignTo(SectionAlignment(DexFile::kDexTypeEncodedArrayItem));
-    ProcessOffset(stream, encoded_array.get());
-    WriteEncodedArray(stream, encoded_array->GetEncodedValues());
+    WriteEncodedArrayItem(stream, encoded_array.get());
   }
   if (compute_offsets_ && start != stream->Tell()) {
     header_->EncodedArrayItems().SetOffset(start);
   }
 }
 
-void DexWriter::WriteAnnotations(Stream* stream) {
+void DexWriter::WriteAnnotation(Stream* stream, dex_ir::AnnotationItem* annotation) {
   uint8_t visibility[1];
+  stream->AlignTo(SectionAlignment(DexFile::kDexTypeAnnotationItem));
+  visibility[0] = annotation->GetVisibility();
+  ProcessOffset(stream, annotation);
+  stream->Write(visibility, sizeof(uint8_t));
+  WriteEncodedAnnotation(stream, annotation->GetAnnotation());
+}
+
+void DexWriter::WriteAnnotations(Stream* stream) {
   const uint32_t start = stream->Tell();
   for (auto& annotation : header_->AnnotationItems()) {
-    stream->AlignTo(SectionAlignment(DexFile::kDexTypeAnnotationItem));
-    visibility[0] = annotation->GetVisibility();
-    ProcessOffset(stream, annotation.get());
-    stream->Write(visibility, sizeof(uint8_t));
-    WriteEncodedAnnotation(stream, annotation->GetAnnotation());
+    WriteAnnotation(stream, annotation.get());
   }
   if (compute_offsets_ && start != stream->Tell()) {
     header_->AnnotationItems().SetOffset(start);
   }
 }
 
-void DexWriter::WriteAnnotationSets(Stream* stream) {
+void DexWriter::WriteAnnotationSet(Stream* stream, dex_ir::AnnotationSetItem* annotation_set) {
   uint32_t size[1];
   uint32_t annotation_off[1];
+  stream->AlignTo(SectionAlignment(DexFile::kDexTypeAnnotationSetItem));
+  size[0] = annotation_set->GetItems()->size();
+  ProcessOffset(stream, annotation_set);
+  stream->Write(size, sizeof(uint32_t));
+  for (dex_ir::AnnotationItem* annotation : *annotation_set->GetItems()) {
+    annotation_off[0] = annotation->GetOffset();
+    stream->Write(annotation_off, sizeof(uint32_t));
+  }
+}
+
+void DexWriter::WriteAnnotationSets(Stream* stream) {
   const uint32_t start = stream->Tell();
   for (auto& annotation_set : header_->AnnotationSetItems()) {
-    stream->AlignTo(SectionAlignment(DexFile::kDexTypeAnnotationSetItem));
-    size[0] = annotation_set->GetItems()->size();
-    ProcessOffset(stream, annotation_set.get());
-    stream->Write(size, sizeof(uint32_t));
-    for (dex_ir::AnnotationItem* annotation : *annotation_set->GetItems()) {
-      annotation_off[0] = annotation->GetOffset();
-      stream->Write(annotation_off, sizeof(uint32_t));
-    }
+    WriteAnnotationSet(stream, annotation_set.get());
   }
   if (compute_offsets_ && start != stream->Tell()) {
     header_->AnnotationSetItems().SetOffset(start);
   }
 }
 
-void DexWriter::WriteAnnotationSetRefs(Stream* stream) {
+void DexWriter::WriteAnnotationSetRef(Stream* stream,
+                                      dex_ir::AnnotationSetRefList* annotation_set_ref) {
   uint32_t size[1];
   uint32_t annotations_off[1];
+  stream->AlignTo(SectionAlignment(DexFile::kDexTypeAnnotationSetRefList));
+  size[0] = annotation_set_ref->GetItems()->size();
+  ProcessOffset(stream, annotation_set_ref);
+  stream->Write(size, sizeof(uint32_t));
+  for (dex_ir::AnnotationSetItem* annotation_set : *annotation_set_ref->GetItems()) {
+    annotations_off[0] = annotation_set == nullptr ? 0 : annotation_set->GetOffset();
+    stream->Write(annotations_off, sizeof(uint32_t));
+  }
+}
+
+void DexWriter::WriteAnnotationSetRefs(Stream* stream) {
   const uint32_t start = stream->Tell();
   for (auto& annotation_set_ref : header_->AnnotationSetRefLists()) {
-    stream->AlignTo(SectionAlignment(DexFile::kDexTypeAnnotationSetRefList));
-    size[0] = annotation_set_ref->GetItems()->size();
-    ProcessOffset(stream, annotation_set_ref.get());
-    stream->Write(size, sizeof(uint32_t));
-    for (dex_ir::AnnotationSetItem* annotation_set : *annotation_set_ref->GetItems()) {
-      annotations_off[0] = annotation_set == nullptr ? 0 : annotation_set->GetOffset();
-      stream->Write(annotations_off, sizeof(uint32_t));
-    }
+    WriteAnnotationSetRef(stream, annotation_set_ref.get());
   }
   if (compute_offsets_ && start != stream->Tell()) {
     header_->AnnotationSetRefLists().SetOffset(start);
   }
 }
 
-void DexWriter::WriteAnnotationsDirectories(Stream* stream) {
+void DexWriter::WriteAnnotationsDirectory(
+    Stream* stream, dex_ir::AnnotationsDirectoryItem* annotations_directory) {
   uint32_t directory_buffer[4];
   uint32_t annotation_buffer[2];
-  const uint32_t start = stream->Tell();
-  for (auto& annotations_directory : header_->AnnotationsDirectoryItems()) {
-    stream->AlignTo(SectionAlignment(DexFile::kDexTypeAnnotationsDirectoryItem));
-    ProcessOffset(stream, annotations_directory.get());
-    directory_buffer[0] = annotations_directory->GetClassAnnotation() == nullptr ? 0 :
-        annotations_directory->GetClassAnnotation()->GetOffset();
-    directory_buffer[1] = annotations_directory->GetFieldAnnotations() == nullptr ? 0 :
-        annotations_directory->GetFieldAnnotations()->size();
-    directory_buffer[2] = annotations_directory->GetMethodAnnotations() == nullptr ? 0 :
-        annotations_directory->GetMethodAnnotations()->size();
-    directory_buffer[3] = annotations_directory->GetParameterAnnotations() == nullptr ? 0 :
-        annotations_directory->GetParameterAnnotations()->size();
-    stream->Write(directory_buffer, 4 * sizeof(uint32_t));
-    if (annotations_directory->GetFieldAnnotations() != nullptr) {
-      for (std::unique_ptr<dex_ir::FieldAnnotation>& field :
-          *annotations_directory->GetFieldAnnotations()) {
-        annotation_buffer[0] = field->GetFieldId()->GetIndex();
-        annotation_buffer[1] = field->GetAnnotationSetItem()->GetOffset();
-        stream->Write(annotation_buffer, 2 * sizeof(uint32_t));
-      }
+  stream->AlignTo(SectionAlignment(DexFile::kDexTypeAnnotationsDirectoryItem));
+  ProcessOffset(stream, annotations_directory);
+  directory_buffer[0] = annotations_directory->GetClassAnnotation() == nullptr ? 0 :
+      annotations_directory->GetClassAnnotation()->GetOffset();
+  directory_buffer[1] = annotations_directory->GetFieldAnnotations() == nullptr ? 0 :
+      annotations_directory->GetFieldAnnotations()->size();
+  directory_buffer[2] = annotations_directory->GetMethodAnnotations() == nullptr ? 0 :
+      annotations_directory->GetMethodAnnotations()->size();
+  directory_buffer[3] = annotations_directory->GetParameterAnnotations() == nullptr ? 0 :
+      annotations_directory->GetParameterAnnotations()->size();
+  stream->Write(directory_buffer, 4 * sizeof(uint32_t));
+  if (annotations_directory->GetFieldAnnotations() != nullptr) {
+    for (std::unique_ptr<dex_ir::FieldAnnotation>& field :
+        *annotations_directory->GetFieldAnnotations()) {
+      annotation_buffer[0] = field->GetFieldId()->GetIndex();
+      annotation_buffer[1] = field->GetAnnotationSetItem()->GetOffset();
+      stream->Write(annotation_buffer, 2 * sizeof(uint32_t));
     }
-    if (annotations_directory->GetMethodAnnotations() != nullptr) {
-      for (std::unique_ptr<dex_ir::MethodAnnotation>& method :
-          *annotations_directory->GetMethodAnnotations()) {
-        annotation_buffer[0] = method->GetMethodId()->GetIndex();
-        annotation_buffer[1] = method->GetAnnotationSetItem()->GetOffset();
-        stream->Write(annotation_buffer, 2 * sizeof(uint32_t));
-      }
+  }
+  if (annotations_directory->GetMethodAnnotations() != nullptr) {
+    for (std::unique_ptr<dex_ir::MethodAnnotation>& method :
+        *annotations_directory->GetMethodAnnotations()) {
+      annotation_buffer[0] = method->GetMethodId()->GetIndex();
+      annotation_buffer[1] = method->GetAnnotationSetItem()->GetOffset();
+      stream->Write(annotation_buffer, 2 * sizeof(uint32_t));
     }
-    if (annotations_directory->GetParameterAnnotations() != nullptr) {
-      for (std::unique_ptr<dex_ir::ParameterAnnotation>& parameter :
-          *annotations_directory->GetParameterAnnotations()) {
-        annotation_buffer[0] = parameter->GetMethodId()->GetIndex();
-        annotation_buffer[1] = parameter->GetAnnotations()->GetOffset();
-        stream->Write(annotation_buffer, 2 * sizeof(uint32_t));
-      }
+  }
+  if (annotations_directory->GetParameterAnnotations() != nullptr) {
+    for (std::unique_ptr<dex_ir::ParameterAnnotation>& parameter :
+        *annotations_directory->GetParameterAnnotations()) {
+      annotation_buffer[0] = parameter->GetMethodId()->GetIndex();
+      annotation_buffer[1] = parameter->GetAnnotations()->GetOffset();
+      stream->Write(annotation_buffer, 2 * sizeof(uint32_t));
     }
   }
+}
+
+void DexWriter::WriteAnnotationsDirectories(Stream* stream) {
+  const uint32_t start = stream->Tell();
+  for (auto& annotations_directory : header_->AnnotationsDirectoryItems()) {
+    WriteAnnotationsDirectory(stream, annotations_directory.get());
+  }
   if (compute_offsets_ && start != stream->Tell()) {
     header_->AnnotationsDirectoryItems().SetOffset(start);
   }
@@ -656,8 +682,7 @@ void DexWriter::WriteClassDefs(Stream* stream, bool reserve_only) {
 
 void DexWriter::WriteClassDatas(Stream* stream) {
   const uint32_t start = stream->Tell();
-  for (const std::unique_ptr<dex_ir::ClassData>& class_data :
-      header_->ClassDatas()) {
+  for (const auto& class_data : header_->ClassDatas()) {
     stream->AlignTo(SectionAlignment(DexFile::kDexTypeClassDataItem));
     ProcessOffset(stream, class_data.get());
     stream->WriteUleb128(class_data->StaticFields()->size());
@@ -267,6 +267,14 @@ class DexWriter {
   virtual void WriteCodeItem(Stream* stream, dex_ir::CodeItem* item, bool reserve_only);
   virtual void WriteDebugInfoItem(Stream* stream, dex_ir::DebugInfoItem* debug_info);
   virtual void WriteStringData(Stream* stream, dex_ir::StringData* string_data);
+  virtual void WriteTypeList(Stream* stream, dex_ir::TypeList* type_list);
+  virtual void WriteEncodedArrayItem(Stream* stream, dex_ir::EncodedArrayItem* encoded_array);
+  virtual void WriteAnnotation(Stream* stream, dex_ir::AnnotationItem* annotation);
+  virtual void WriteAnnotationSet(Stream* stream, dex_ir::AnnotationSetItem* annotation_set);
+  virtual void WriteAnnotationSetRef(Stream* stream,
+                                     dex_ir::AnnotationSetRefList* annotation_set_ref);
+  virtual void WriteAnnotationsDirectory(Stream* stream,
+                                         dex_ir::AnnotationsDirectoryItem* annotations_directory);
 
   // Process an offset, if compute_offset is set, write into the dex ir item, otherwise read the
   // existing offset and use that for writing.
@@ -1713,7 +1713,7 @@ void DexLayout::LayoutStringData(const DexFile* dex_file) {
   }
   if (kIsDebugBuild) {
     std::unordered_set<dex_ir::StringData*> visited;
-    for (const std::unique_ptr<dex_ir::StringData>& data : string_datas) {
+    for (const auto& data : string_datas) {
       visited.insert(data.get());
     }
     for (auto& string_id : header_->StringIds()) {
@@ -1784,7 +1784,7 @@ void DexLayout::LayoutCodeItems(const DexFile* dex_file) {
   const auto& code_items = header_->CodeItems();
   if (VLOG_IS_ON(dex)) {
     size_t layout_count[static_cast<size_t>(LayoutType::kLayoutTypeCount)] = {};
-    for (const std::unique_ptr<dex_ir::CodeItem>& code_item : code_items) {
+    for (const auto& code_item : code_items) {
       auto it = code_item_layout.find(code_item.get());
       DCHECK(it != code_item_layout.end());
       ++layout_count[static_cast<size_t>(it->second)];
@@ -1798,8 +1798,7 @@ void DexLayout::LayoutCodeItems(const DexFile* dex_file) {
   // all the offsets. Stable sort to preserve any existing locality that might be there.
   std::stable_sort(code_items.begin(),
                    code_items.end(),
-                   [&](const std::unique_ptr<dex_ir::CodeItem>& a,
-                       const std::unique_ptr<dex_ir::CodeItem>& b) {
+                   [&](const auto& a, const auto& b) {
     auto it_a = code_item_layout.find(a.get());
     auto it_b = code_item_layout.find(b.get());
     DCHECK(it_a != code_item_layout.end());
@@ -23,12 +23,16 @@
  * List all methods in all concrete classes in one or more DEX files.
  */
 
+#include <fcntl.h>
 #include <inttypes.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
-#include <android-base/file.h>
 #include <android-base/logging.h>
+#include <android-base/mapped_file.h>
+#include <android-base/unique_fd.h>
 
 #include "dex/class_accessor-inl.h"
 #include "dex/code_item_accessors-inl.h"
@@ -152,6 +156,33 @@ void dumpClass(const DexFile* pDexFile, u4 idx) {
   }
 }
 
+/*
+ * Maps a whole file read-only, so that plain dex files are used in place rather
+ * than copied.
+ */
+static std::unique_ptr<android::base::MappedFile> mapFile(const char* fileName) {
+  android::base::unique_fd fd(TEMP_FAILURE_RETRY(open(fileName, O_RDONLY | O_CLOEXEC)));
+  if (fd == -1) {
+    PLOG(ERROR) << "Can't open " << fileName;
+    return nullptr;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    PLOG(ERROR) << "Can't stat " << fileName;
+    return nullptr;
+  }
+  if (st.st_size == 0) {
+    LOG(ERROR) << "Empty file " << fileName;
+    return nullptr;
+  }
+  std::unique_ptr<android::base::MappedFile> map =
+      android::base::MappedFile::FromFd(fd, 0, st.st_size, PROT_READ);
+  if (map == nullptr) {
+    PLOG(ERROR) << "Can't map " << fileName;
+  }
+  return map;
+}
+
 /*
  * Processes a single file (either direct .dex or indirect .zip/.jar/.apk).
  */
@@ -159,18 +190,16 @@ static int processFile(const char* fileName) {
   // If the file is not a .dex file, the function tries .zip/.jar/.apk files,
   // all of which are Zip archives with "classes.dex" inside.
   static constexpr bool kVerifyChecksum = true;
-  std::string content;
-  // TODO: add an api to android::base to read a std::vector<uint8_t>.
-  if (!android::base::ReadFileToString(fileName, &content)) {
-    LOG(ERROR) << "ReadFileToString failed";
+  std::unique_ptr<android::base::MappedFile> content = mapFile(fileName);
+  if (content == nullptr) {
     return -1;
   }
   std::vector<std::unique_ptr<const DexFile>> dex_files;
   DexFileLoaderErrorCode error_code;
   std::string error_msg;
   const DexFileLoader dex_file_loader;
-  if (!dex_file_loader.OpenAll(reinterpret_cast<const uint8_t*>(content.data()),
-                               content.size(),
+  if (!dex_file_loader.OpenAll(reinterpret_cast<const uint8_t*>(content->data()),
+                               content->size(),
                                fileName,
                                /*verify=*/ true,
                                kVerifyChecksum,
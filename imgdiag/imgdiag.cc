@@ -23,11 +23,13 @@
 #include <map>
 #include <optional>
 #include <set>
+#include <sstream>
 #include <string>
 #include <unordered_set>
 #include <vector>
 
 #include <android-base/parseint.h>
+#include "android-base/strings.h"
 #include "android-base/stringprintf.h"
 
 #include "art_field-inl.h"
@@ -46,6 +48,7 @@
 #include "oat_file.h"
 #include "oat_file_manager.h"
 #include "scoped_thread_state_change-inl.h"
+#include "thread_pool.h"
 
 #include "backtrace/BacktraceMap.h"
 #include "cmdline.h"
@@ -519,6 +522,17 @@ class RegionSpecializedBase<mirror::Object> : public RegionCommon<mirror::Object
     }
   }
 
+  // The descriptors of the dirty objects above, in the format of dex2oat's
+  // --dirty-image-objects file.
+  void CollectDirtyObjectDescriptors(std::set<std::string>* descriptors)
+      REQUIRES_SHARED(Locks::mutator_lock_) {
+    for (mirror::Object* obj : dirty_objects_) {
+      if (obj->IsClass()) {
+        descriptors->insert(obj->AsClass()->PrettyDescriptor());
+      }
+    }
+  }
+
   void DumpDirtyEntries() REQUIRES_SHARED(Locks::mutator_lock_) {
     // vector of pairs (size_t count, Class*)
     auto dirty_object_class_values =
@@ -1299,6 +1313,11 @@ class ImgDiagDumper {
     return ret;
   }
 
+  // Descriptors of the dirty class objects found by Dump() with `dump_dirty_objects`.
+  const std::set<std::string>& GetDirtyObjectDescriptors() const {
+    return dirty_object_descriptors_;
+  }
+
  private:
   bool DumpImageDiff(const ImageHeader& image_header, const std::string& image_location)
       REQUIRES_SHARED(Locks::mutator_lock_) {
@@ -1306,101 +1325,115 @@ class ImgDiagDumper {
   }
 
   bool ComputeDirtyBytes(const ImageHeader& image_header,
-                         const uint8_t* image_begin,
                          const backtrace_map_t& boot_map,
                          ArrayRef<uint8_t> remote_contents,
                          MappingData* mapping_data /*out*/) {
     std::ostream& os = *os_;
 
-    size_t virtual_page_idx = 0;   // Virtual page number (for an absolute memory address)
-    size_t page_idx = 0;           // Page index relative to 0
-    size_t previous_page_idx = 0;  // Previous page index relative to 0
+    // We treat the image header as part of the memory map for now
+    // If we wanted to change this, we could pass base=start+sizeof(ImageHeader)
+    // But it might still be interesting to see if any of the ImageHeader data mutated
+    const uint8_t* local_begin = reinterpret_cast<const uint8_t*>(&image_header);
+    const size_t num_pages = (boot_map.end - boot_map.start) / kPageSize;
+    DCHECK_ALIGNED(local_begin, kPageSize);
+
+    // Read the pagemap entries of the whole mapping at once rather than page by page, both
+    // for the remote mapping and for the local "clean" one. The flags and mapping counts are
+    // read in runs of consecutive page frames.
+    std::string error_msg;
+    std::vector<uint64_t> page_frame_numbers(num_pages);
+    std::vector<uint64_t> clean_page_frame_numbers(num_pages);
+    std::vector<uint64_t> page_flags(num_pages);
+    std::vector<uint64_t> page_counts(num_pages);
+    if (num_pages != 0u &&
+        (!GetPageFrameNumbers(&image_pagemap_file_,
+                              boot_map.start / kPageSize,
+                              ArrayRef<uint64_t>(page_frame_numbers),
+                              &error_msg) ||
+         !GetPageFrameNumbers(&clean_pagemap_file_,
+                              reinterpret_cast<uintptr_t>(local_begin) / kPageSize,
+                              ArrayRef<uint64_t>(clean_page_frame_numbers),
+                              &error_msg) ||
+         !GetPageFlagsOrCounts(&kpageflags_file_,
+                               ArrayRef<const uint64_t>(page_frame_numbers),
+                               ArrayRef<uint64_t>(page_flags),
+                               &error_msg) ||
+         !GetPageFlagsOrCounts(&kpagecount_file_,
+                               ArrayRef<const uint64_t>(page_frame_numbers),
+                               ArrayRef<uint64_t>(page_counts),
+                               &error_msg))) {
+      os << error_msg;
+      return false;
+    }
 
+    std::vector<size_t> private_dirty_pages_for_section(ImageHeader::kSectionCount, 0u);
 
     // Iterate through one page at a time. Boot map begin/end already implicitly aligned.
-    for (uintptr_t begin = boot_map.start; begin != boot_map.end; begin += kPageSize) {
-      ptrdiff_t offset = begin - boot_map.start;
-
-      // We treat the image header as part of the memory map for now
-      // If we wanted to change this, we could pass base=start+sizeof(ImageHeader)
-      // But it might still be interesting to see if any of the ImageHeader data mutated
-      const uint8_t* local_ptr = reinterpret_cast<const uint8_t*>(&image_header) + offset;
+    for (size_t i = 0; i != num_pages; ++i) {
+      ptrdiff_t offset = i * kPageSize;
+      const uint8_t* local_ptr = local_begin + offset;
       const uint8_t* remote_ptr = &remote_contents[offset];
 
+      // Only pages that differ need to be compared byte by byte.
       if (memcmp(local_ptr, remote_ptr, kPageSize) != 0) {
         mapping_data->different_pages++;
 
-        // Count the number of 32-bit integers that are different.
-        for (size_t i = 0; i < kPageSize / sizeof(uint32_t); ++i) {
-          const uint32_t* remote_ptr_int32 = reinterpret_cast<const uint32_t*>(remote_ptr);
-          const uint32_t* local_ptr_int32 = reinterpret_cast<const uint32_t*>(local_ptr);
-
-          if (remote_ptr_int32[i] != local_ptr_int32[i]) {
+        // Count the number of 32-bit integers and bytes that are different.
+        const uint32_t* remote_ptr_int32 = reinterpret_cast<const uint32_t*>(remote_ptr);
+        const uint32_t* local_ptr_int32 = reinterpret_cast<const uint32_t*>(local_ptr);
+        for (size_t j = 0; j < kPageSize / sizeof(uint32_t); ++j) {
+          if (remote_ptr_int32[j] != local_ptr_int32[j]) {
             mapping_data->different_int32s++;
+            for (size_t k = 0; k != sizeof(uint32_t); ++k) {
+              if (local_ptr[j * sizeof(uint32_t) + k] != remote_ptr[j * sizeof(uint32_t) + k]) {
+                mapping_data->different_bytes++;
+              }
+            }
           }
         }
       }
-    }
-
-    std::vector<size_t> private_dirty_pages_for_section(ImageHeader::kSectionCount, 0u);
-
-    // Iterate through one byte at a time.
-    ptrdiff_t page_off_begin = image_header.GetImageBegin() - image_begin;
-    for (uintptr_t begin = boot_map.start; begin != boot_map.end; ++begin) {
-      previous_page_idx = page_idx;
-      ptrdiff_t offset = begin - boot_map.start;
-
-      // We treat the image header as part of the memory map for now
-      // If we wanted to change this, we could pass base=start+sizeof(ImageHeader)
-      // But it might still be interesting to see if any of the ImageHeader data mutated
-      const uint8_t* local_ptr = reinterpret_cast<const uint8_t*>(&image_header) + offset;
-      const uint8_t* remote_ptr = &remote_contents[offset];
-
-      virtual_page_idx = reinterpret_cast<uintptr_t>(local_ptr) / kPageSize;
 
-      // Calculate the page index, relative to the 0th page where the image begins
-      page_idx = (offset + page_off_begin) / kPageSize;
-      if (*local_ptr != *remote_ptr) {
-        // Track number of bytes that are different
-        mapping_data->different_bytes++;
+      // Independently count the # of dirty pages on the remote side, starting with the
+      // page after the one holding the image header.
+      // TODO: virtual_page_idx needs to be from the same process
+      if (i == 0u) {
+        continue;
+      }
+      uint64_t kpage_flags_entry = page_flags[i];
+      uint64_t page_count = page_counts[i];
+      // There must be a page frame at the requested address.
+      CHECK_EQ(kpage_flags_entry & kPageFlagsNoPageMask, 0u);
+      // The page frame must be memory mapped
+      CHECK_NE(kpage_flags_entry & kPageFlagsMmapMask, 0u);
+
+      // Page is dirty, i.e. has diverged from file, if the 4th bit is set to 1
+      bool flags_dirty = (kpage_flags_entry & kPageFlagsDirtyMask) != 0;
+      // page_frame_number_clean must come from the *same* process
+      // but a *different* mmap than page_frame_number
+      if (flags_dirty && page_frame_numbers[i] != clean_page_frame_numbers[i]) {
+        // FIXME: This check sometimes fails and the reason is not understood. b/123852774
+        LOG(ERROR) << "Check failed: page_frame_number != page_frame_number_clean "
+            << "(page_frame_number=" << page_frame_numbers[i]
+            << ", page_frame_number_clean=" << clean_page_frame_numbers[i] << ")"
+            << " count: " << page_count << " flags: 0x" << std::hex << kpage_flags_entry;
       }
 
-      // Independently count the # of dirty pages on the remote side
-      size_t remote_virtual_page_idx = begin / kPageSize;
-      if (previous_page_idx != page_idx) {
-        uint64_t page_count = 0xC0FFEE;
-        // TODO: virtual_page_idx needs to be from the same process
-        std::string error_msg;
-        int dirtiness = (IsPageDirty(&image_pagemap_file_,     // Image-diff-pid procmap
-                                     &clean_pagemap_file_,     // Self procmap
-                                     &kpageflags_file_,
-                                     &kpagecount_file_,
-                                     remote_virtual_page_idx,  // potentially "dirty" page
-                                     virtual_page_idx,         // true "clean" page
-                                     &page_count,
-                                     &error_msg));
-        if (dirtiness < 0) {
-          os << error_msg;
-          return false;
-        } else if (dirtiness > 0) {
-          mapping_data->dirty_pages++;
-          mapping_data->dirty_page_set.insert(mapping_data->dirty_page_set.end(), virtual_page_idx);
-        }
-
-        bool is_dirty = dirtiness > 0;
-        bool is_private = page_count == 1;
-
-        if (page_count == 1) {
-          mapping_data->private_pages++;
-        }
-
-        if (is_dirty && is_private) {
-          mapping_data->private_dirty_pages++;
-          for (size_t i = 0; i < ImageHeader::kSectionCount; ++i) {
-            const ImageHeader::ImageSections section = static_cast<ImageHeader::ImageSections>(i);
-            if (image_header.GetImageSection(section).Contains(offset)) {
-              ++private_dirty_pages_for_section[i];
-            }
+      bool is_dirty = page_frame_numbers[i] != clean_page_frame_numbers[i];
+      bool is_private = page_count == 1;
+      if (is_dirty) {
+        size_t virtual_page_idx = reinterpret_cast<uintptr_t>(local_ptr) / kPageSize;
+        mapping_data->dirty_pages++;
+        mapping_data->dirty_page_set.insert(mapping_data->dirty_page_set.end(), virtual_page_idx);
+      }
+      if (is_private) {
+        mapping_data->private_pages++;
+      }
+      if (is_dirty && is_private) {
+        mapping_data->private_dirty_pages++;
+        for (size_t s = 0; s < ImageHeader::kSectionCount; ++s) {
+          const ImageHeader::ImageSections section = static_cast<ImageHeader::ImageSections>(s);
+          if (image_header.GetImageSection(section).Contains(offset)) {
+            ++private_dirty_pages_for_section[s];
           }
         }
       }
@@ -1561,7 +1594,7 @@ class ImgDiagDumper {
 
     os << "Mapping at [" << reinterpret_cast<void*>(boot_map.start) << ", "
        << reinterpret_cast<void*>(boot_map.end) << ") had:\n  ";
-    if (!ComputeDirtyBytes(image_header, image_begin, boot_map, remote_contents, &mapping_data)) {
+    if (!ComputeDirtyBytes(image_header, boot_map, remote_contents, &mapping_data)) {
       return false;
     }
     RemoteProcesses remotes;
@@ -1583,6 +1616,7 @@ class ImgDiagDumper {
     object_region_data.ProcessRegion(mapping_data,
                                      remotes,
                                      image_begin_unaligned);
+    object_region_data.CollectDirtyObjectDescriptors(&dirty_object_descriptors_);
 
     // Check all the ArtMethod entries in the image.
     RegionData<ArtMethod> artmethod_region_data(os_,
@@ -1597,18 +1631,6 @@ class ImgDiagDumper {
     return true;
   }
 
-  // Note: On failure, `*page_frame_number` shall be clobbered.
-  static bool GetPageFrameNumber(File* page_map_file,
-                                 size_t virtual_page_index,
-                                 /*out*/ uint64_t* page_frame_number,
-                                 /*out*/ std::string* error_msg) {
-    CHECK(page_frame_number != nullptr);
-    return GetPageFrameNumbers(page_map_file,
-                               virtual_page_index,
-                               ArrayRef<uint64_t>(page_frame_number, 1u),
-                               error_msg);
-  }
-
   // Note: On failure, `page_frame_numbers[.]` shall be clobbered.
   static bool GetPageFrameNumbers(File* page_map_file,
                                   size_t virtual_page_index,
@@ -1672,77 +1694,6 @@ class ImgDiagDumper {
     return true;
   }
 
-  static int IsPageDirty(File* page_map_file,
-                         File* clean_pagemap_file,
-                         File* kpageflags_file,
-                         File* kpagecount_file,
-                         size_t virtual_page_idx,
-                         size_t clean_virtual_page_idx,
-                         // Out parameters:
-                         uint64_t* page_count, std::string* error_msg) {
-    CHECK(page_map_file != nullptr);
-    CHECK(clean_pagemap_file != nullptr);
-    CHECK_NE(page_map_file, clean_pagemap_file);
-    CHECK(kpageflags_file != nullptr);
-    CHECK(kpagecount_file != nullptr);
-    CHECK(page_count != nullptr);
-    CHECK(error_msg != nullptr);
-
-    // Constants are from https://www.kernel.org/doc/Documentation/vm/pagemap.txt
-
-    uint64_t page_frame_number = 0;
-    if (!GetPageFrameNumber(page_map_file, virtual_page_idx, &page_frame_number, error_msg)) {
-      return -1;
-    }
-
-    uint64_t page_frame_number_clean = 0;
-    if (!GetPageFrameNumber(clean_pagemap_file, clean_virtual_page_idx, &page_frame_number_clean,
-                            error_msg)) {
-      return -1;
-    }
-
-    // Read 64-bit entry from /proc/kpageflags to get the dirty bit for a page
-    uint64_t kpage_flags_entry = 0;
-    if (!kpageflags_file->PreadFully(&kpage_flags_entry,
-                                     kPageFlagsEntrySize,
-                                     page_frame_number * kPageFlagsEntrySize)) {
-      *error_msg = StringPrintf("Failed to read the page flags from %s",
-                                kpageflags_file->GetPath().c_str());
-      return -1;
-    }
-
-    // Read 64-bit entyry from /proc/kpagecount to get mapping counts for a page
-    if (!kpagecount_file->PreadFully(page_count /*out*/,
-                                     kPageCountEntrySize,
-                                     page_frame_number * kPageCountEntrySize)) {
-      *error_msg = StringPrintf("Failed to read the page count from %s",
-                                kpagecount_file->GetPath().c_str());
-      return -1;
-    }
-
-    // There must be a page frame at the requested address.
-    CHECK_EQ(kpage_flags_entry & kPageFlagsNoPageMask, 0u);
-    // The page frame must be memory mapped
-    CHECK_NE(kpage_flags_entry & kPageFlagsMmapMask, 0u);
-
-    // Page is dirty, i.e. has diverged from file, if the 4th bit is set to 1
-    bool flags_dirty = (kpage_flags_entry & kPageFlagsDirtyMask) != 0;
-
-    // page_frame_number_clean must come from the *same* process
-    // but a *different* mmap than page_frame_number
-    if (flags_dirty) {
-      // FIXME: This check sometimes fails and the reason is not understood. b/123852774
-      if (page_frame_number != page_frame_number_clean) {
-        LOG(ERROR) << "Check failed: page_frame_number != page_frame_number_clean "
-            << "(page_frame_number=" << page_frame_number
-            << ", page_frame_number_clean=" << page_frame_number_clean << ")"
-            << " count: " << *page_count << " flags: 0x" << std::hex << kpage_flags_entry;
-      }
-    }
-
-    return (page_frame_number != page_frame_number_clean) ? 1 : 0;
-  }
-
   void PrintPidLine(const std::string& kind, pid_t pid) {
     if (pid < 0) {
       *os_ << kind << " DIFF PID: disabled\n\n";
@@ -1804,39 +1755,190 @@ class ImgDiagDumper {
   // A File for reading /proc/kpagecount.
   File kpagecount_file_;
 
+  std::set<std::string> dirty_object_descriptors_;
+
   DISALLOW_COPY_AND_ASSIGN(ImgDiagDumper);
 };
 
-static int DumpImage(Runtime* runtime,
-                     std::ostream* os,
-                     pid_t image_diff_pid,
-                     pid_t zygote_diff_pid,
-                     bool dump_dirty_objects) {
-  ScopedObjectAccess soa(Thread::Current());
+// The diff of one boot image space, buffered so that spaces diffed in parallel are printed
+// in order.
+struct ImageSpaceDiff {
+  std::ostringstream output;
+  std::unique_ptr<ImgDiagDumper> dumper;
+  bool success = false;
+};
+
+class ImageSpaceDiffTask final : public Task {
+ public:
+  ImageSpaceDiffTask(ImageSpaceDiff* diff, const gc::space::ImageSpace* image_space)
+      : diff_(diff), image_space_(image_space) {}
+
+  void Run(Thread* self) override {
+    ScopedObjectAccess soa(self);
+    diff_->success =
+        diff_->dumper->Dump(image_space_->GetImageHeader(), image_space_->GetImageLocation());
+  }
+
+  void Finalize() override {
+    delete this;
+  }
+
+ private:
+  ImageSpaceDiff* const diff_;
+  const gc::space::ImageSpace* const image_space_;
+
+  DISALLOW_COPY_AND_ASSIGN(ImageSpaceDiffTask);
+};
+
+// Diff all the boot image spaces against the given processes. With a thread pool, the spaces
+// are diffed in parallel, each by its own dumper.
+static bool DiffImageSpaces(Runtime* runtime,
+                            ThreadPool* thread_pool,
+                            std::ostream* os,
+                            pid_t image_diff_pid,
+                            pid_t zygote_diff_pid,
+                            bool dump_dirty_objects,
+                            /*out*/ std::set<std::string>* dirty_object_descriptors)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
   gc::Heap* heap = runtime->GetHeap();
   const std::vector<gc::space::ImageSpace*>& image_spaces = heap->GetBootImageSpaces();
   CHECK(!image_spaces.empty());
-  ImgDiagDumper img_diag_dumper(os,
-                                image_diff_pid,
-                                zygote_diff_pid,
-                                dump_dirty_objects);
-  if (!img_diag_dumper.Init()) {
-    return EXIT_FAILURE;
-  }
   for (gc::space::ImageSpace* image_space : image_spaces) {
-    const ImageHeader& image_header = image_space->GetImageHeader();
-    if (!image_header.IsValid()) {
+    if (!image_space->GetImageHeader().IsValid()) {
       fprintf(stderr, "Invalid image header %s\n", image_space->GetImageLocation().c_str());
-      return EXIT_FAILURE;
+      return false;
     }
+  }
 
-    if (!img_diag_dumper.Dump(image_header, image_space->GetImageLocation())) {
-      return EXIT_FAILURE;
+  if (thread_pool == nullptr) {
+    ImgDiagDumper img_diag_dumper(os,
+                                  image_diff_pid,
+                                  zygote_diff_pid,
+                                  dump_dirty_objects);
+    if (!img_diag_dumper.Init()) {
+      return false;
+    }
+    for (gc::space::ImageSpace* image_space : image_spaces) {
+      if (!img_diag_dumper.Dump(image_space->GetImageHeader(), image_space->GetImageLocation())) {
+        return false;
+      }
     }
+    const std::set<std::string>& descriptors = img_diag_dumper.GetDirtyObjectDescriptors();
+    dirty_object_descriptors->insert(descriptors.begin(), descriptors.end());
+    return true;
+  }
+
+  std::vector<ImageSpaceDiff> diffs(image_spaces.size());
+  for (ImageSpaceDiff& diff : diffs) {
+    diff.dumper.reset(
+        new ImgDiagDumper(&diff.output, image_diff_pid, zygote_diff_pid, dump_dirty_objects));
+    if (!diff.dumper->Init()) {
+      *os << diff.output.str();
+      return false;
+    }
+  }
+  Thread* self = Thread::Current();
+  for (size_t i = 0; i != image_spaces.size(); ++i) {
+    thread_pool->AddTask(self, new ImageSpaceDiffTask(&diffs[i], image_spaces[i]));
+  }
+  thread_pool->StartWorkers(self);
+  thread_pool->Wait(self, /* do_work= */ true, /* may_hold_locks= */ true);
+  thread_pool->StopWorkers(self);
+
+  for (ImageSpaceDiff& diff : diffs) {
+    *os << diff.output.str();
+    if (!diff.success) {
+      return false;
+    }
+    const std::set<std::string>& descriptors = diff.dumper->GetDirtyObjectDescriptors();
+    dirty_object_descriptors->insert(descriptors.begin(), descriptors.end());
+  }
+  return true;
+}
+
+static std::unique_ptr<ThreadPool> CreateThreadPool(size_t num_threads) {
+  // The main thread also diffs image spaces while it waits for the pool.
+  if (num_threads <= 1u) {
+    return nullptr;
+  }
+  return std::make_unique<ThreadPool>("imgdiag thread pool", num_threads - 1u);
+}
+
+static int DumpImage(Runtime* runtime,
+                     std::ostream* os,
+                     pid_t image_diff_pid,
+                     pid_t zygote_diff_pid,
+                     bool dump_dirty_objects,
+                     size_t num_threads) {
+  std::unique_ptr<ThreadPool> thread_pool = CreateThreadPool(num_threads);
+  ScopedObjectAccess soa(Thread::Current());
+  std::set<std::string> dirty_object_descriptors;
+  if (!DiffImageSpaces(runtime,
+                       thread_pool.get(),
+                       os,
+                       image_diff_pid,
+                       zygote_diff_pid,
+                       dump_dirty_objects,
+                       &dirty_object_descriptors)) {
+    return EXIT_FAILURE;
   }
   return EXIT_SUCCESS;
 }
 
+// Diff the boot image of each process and print the classes with dirty static fields in any
+// of them, most frequently dirty first, as input for dex2oat's --dirty-image-objects.
+static int DumpDirtyImageObjects(Runtime* runtime,
+                                 std::ostream* os,
+                                 const std::vector<pid_t>& image_diff_pids,
+                                 pid_t zygote_diff_pid,
+                                 size_t num_threads) {
+  std::unique_ptr<ThreadPool> thread_pool = CreateThreadPool(num_threads);
+  ScopedObjectAccess soa(Thread::Current());
+  std::map<std::string, size_t> dirty_process_counts;
+  size_t num_processes = 0u;
+  for (pid_t pid : image_diff_pids) {
+    // Only the aggregated objects are printed, not the diff of each process.
+    std::ostringstream diff_output;
+    std::set<std::string> dirty_object_descriptors;
+    if (!DiffImageSpaces(runtime,
+                         thread_pool.get(),
+                         &diff_output,
+                         pid,
+                         zygote_diff_pid,
+                         /* dump_dirty_objects= */ true,
+                         &dirty_object_descriptors)) {
+      // Processes may exit while we look at them, so skip the ones that fail.
+      LOG(WARNING) << "Skipping process " << pid << ", failed to diff its boot image";
+      continue;
+    }
+    ++num_processes;
+    for (const std::string& descriptor : dirty_object_descriptors) {
+      ++dirty_process_counts[descriptor];
+    }
+  }
+
+  std::vector<std::pair<size_t, std::string>> sorted_descriptors;
+  for (const auto& entry : dirty_process_counts) {
+    sorted_descriptors.emplace_back(entry.second, entry.first);
+  }
+  std::sort(sorted_descriptors.begin(),
+            sorted_descriptors.end(),
+            [](const auto& lhs, const auto& rhs) {
+              return (lhs.first != rhs.first) ? lhs.first > rhs.first : lhs.second < rhs.second;
+            });
+  *os << "# Dirty image objects of " << num_processes << " processes\n";
+  size_t previous_count = 0u;
+  for (const auto& entry : sorted_descriptors) {
+    if (entry.first != previous_count) {
+      *os << "# Dirty in " << entry.first << " processes\n";
+      previous_count = entry.first;
+    }
+    *os << entry.second << "\n";
+  }
+  *os << std::flush;
+  return (num_processes != 0u) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
 struct ImgDiagArgs : public CmdlineArgs {
  protected:
   using Base = CmdlineArgs;
@@ -1869,6 +1971,22 @@ struct ImgDiagArgs : public CmdlineArgs {
       }
     } else if (option == "--dump-dirty-objects") {
       dump_dirty_objects_ = true;
+    } else if (StartsWith(option, "--dirty-image-objects-pids=")) {
+      const char* pids = raw_option + strlen("--dirty-image-objects-pids=");
+      for (const std::string& pid_str : android::base::Split(pids, ",")) {
+        pid_t pid;
+        if (!android::base::ParseInt(pid_str, &pid)) {
+          *error_msg = "Dirty image objects pid out of range";
+          return kParseError;
+        }
+        dirty_image_objects_pids_.push_back(pid);
+      }
+    } else if (StartsWith(option, "--threads=")) {
+      if (!android::base::ParseUint(raw_option + strlen("--threads="), &num_threads_) ||
+          num_threads_ == 0u) {
+        *error_msg = "Number of threads must be positive";
+        return kParseError;
+      }
     } else {
       return kParseUnknownArgument;
     }
@@ -1885,16 +2003,22 @@ struct ImgDiagArgs : public CmdlineArgs {
 
     // Perform our own checks.
 
-    if (kill(image_diff_pid_,
-             /*sig*/0) != 0) {  // No signal is sent, perform error-checking only.
-      // Check if the pid exists before proceeding.
-      if (errno == ESRCH) {
-        *error_msg = "Process specified does not exist";
-      } else {
-        *error_msg = StringPrintf("Failed to check process status: %s", strerror(errno));
+    std::vector<pid_t> pids = dirty_image_objects_pids_;
+    if (pids.empty()) {
+      pids.push_back(image_diff_pid_);
+    }
+    for (pid_t pid : pids) {
+      if (kill(pid, /*sig*/0) != 0) {  // No signal is sent, perform error-checking only.
+        // Check if the pid exists before proceeding.
+        if (errno == ESRCH) {
+          *error_msg = StringPrintf("Process %d specified does not exist", pid);
+        } else {
+          *error_msg = StringPrintf("Failed to check process status: %s", strerror(errno));
+        }
+        return kParseError;
       }
-      return kParseError;
-    } else if (instruction_set_ != InstructionSet::kNone && instruction_set_ != kRuntimeISA) {
+    }
+    if (instruction_set_ != InstructionSet::kNone && instruction_set_ != kRuntimeISA) {
       // Don't allow different ISAs since the images are ISA-specific.
       // Right now the code assumes both the runtime ISA and the remote ISA are identical.
       *error_msg = "Must use the default runtime ISA; changing ISA is not supported.";
@@ -1922,6 +2046,12 @@ struct ImgDiagArgs : public CmdlineArgs {
         "against.\n"
         "      Example: --zygote-diff-pid=$(pid zygote)\n"
         "  --dump-dirty-objects: additionally output dirty objects of interest.\n"
+        "  --dirty-image-objects-pids=<pid>[,<pid>...]: diff the boot.art of each process and\n"
+        "      print the classes with dirty static fields in any of them, most frequently dirty\n"
+        "      first, in the format of the dex2oat --dirty-image-objects file.\n"
+        "      Example: --dirty-image-objects-pids=$(pidof -s system_server),$(pidof -s com.foo)\n"
+        "  --threads=<n>: diff the boot image spaces on n threads.\n"
+        "      Example: --threads=4\n"
         "\n";
 
     return usage;
@@ -1931,17 +2061,27 @@ struct ImgDiagArgs : public CmdlineArgs {
   pid_t image_diff_pid_ = -1;
   pid_t zygote_diff_pid_ = -1;
   bool dump_dirty_objects_ = false;
+  std::vector<pid_t> dirty_image_objects_pids_;
+  size_t num_threads_ = 1u;
 };
 
 struct ImgDiagMain : public CmdlineMain<ImgDiagArgs> {
   bool ExecuteWithRuntime(Runtime* runtime) override {
     CHECK(args_ != nullptr);
 
+    if (!args_->dirty_image_objects_pids_.empty()) {
+      return DumpDirtyImageObjects(runtime,
+                                   args_->os_,
+                                   args_->dirty_image_objects_pids_,
+                                   args_->zygote_diff_pid_,
+                                   args_->num_threads_) == EXIT_SUCCESS;
+    }
     return DumpImage(runtime,
                      args_->os_,
                      args_->image_diff_pid_,
                      args_->zygote_diff_pid_,
-                     args_->dump_dirty_objects_) == EXIT_SUCCESS;
+                     args_->dump_dirty_objects_,
+                     args_->num_threads_) == EXIT_SUCCESS;
   }
 };
 
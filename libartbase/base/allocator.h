@@ -37,6 +37,12 @@ class Allocator {
   virtual void* Alloc(size_t) = 0;
   virtual void Free(void*) = 0;
 
+  // Free memory of a known size. Allocators that can reuse freed memory only for a given
+  // size override this; the default just calls Free().
+  virtual void FreeSized(void* p, size_t size ATTRIBUTE_UNUSED) {
+    Free(p);
+  }
+
  private:
   DISALLOW_COPY_AND_ASSIGN(Allocator);
 };
@@ -18,6 +18,7 @@
 
 
 #include <algorithm>
+#include <atomic>
 #include <cstddef>
 #include <iomanip>
 #include <numeric>
@@ -95,6 +96,7 @@ const char* const ArenaAllocatorStatsImpl<kCount>::kAllocNames[] = {
   "Scheduler    ",
   "Profile      ",
   "SBCloner     ",
+  "Transaction  ",
 };
 
 template <bool kCount>
@@ -188,6 +190,105 @@ void ArenaAllocatorMemoryTool::DoMakeInaccessible(void* ptr, size_t size) {
 Arena::Arena() : bytes_allocated_(0), memory_(nullptr), size_(0), next_(nullptr) {
 }
 
+ArenaFreeList::ArenaFreeList() : free_arenas_(nullptr), num_reused_(0u), num_new_(0u) {
+}
+
+ArenaFreeList::~ArenaFreeList() {
+  DCHECK(TakeAll() == nullptr) << "Arenas must be reclaimed by the pool";
+}
+
+size_t ArenaFreeList::CacheIndexForCurrentThread() {
+  // Spread threads round-robin over the caches. Threads that exit leave their arenas in the
+  // cache for the next thread with the same index, or for the pool to reclaim.
+  static std::atomic<size_t> next_index(0u);
+  static thread_local size_t index =
+      next_index.fetch_add(1u, std::memory_order_relaxed) % kNumCaches;
+  return index;
+}
+
+Arena* ArenaFreeList::Take(size_t size) {
+  Cache& cache = caches_[CacheIndexForCurrentThread()];
+  {
+    std::lock_guard<std::mutex> lock(cache.lock);
+    if (cache.arenas != nullptr && LIKELY(cache.arenas->Size() >= size)) {
+      Arena* ret = cache.arenas;
+      cache.arenas = ret->next_;
+      --cache.num_arenas;
+      ++cache.num_reused;
+      return ret;
+    }
+  }
+  std::lock_guard<std::mutex> lock(lock_);
+  if (free_arenas_ != nullptr && LIKELY(free_arenas_->Size() >= size)) {
+    Arena* ret = free_arenas_;
+    free_arenas_ = ret->next_;
+    ++num_reused_;
+    return ret;
+  }
+  return nullptr;
+}
+
+void ArenaFreeList::Put(Arena* first) {
+  Cache& cache = caches_[CacheIndexForCurrentThread()];
+  {
+    std::lock_guard<std::mutex> lock(cache.lock);
+    while (first != nullptr && cache.num_arenas < kMaxArenasPerCache) {
+      Arena* next = first->next_;
+      first->next_ = cache.arenas;
+      cache.arenas = first;
+      ++cache.num_arenas;
+      first = next;
+    }
+  }
+  if (first != nullptr) {
+    Arena* last = first;
+    while (last->next_ != nullptr) {
+      last = last->next_;
+    }
+    std::lock_guard<std::mutex> lock(lock_);
+    last->next_ = free_arenas_;
+    free_arenas_ = first;
+  }
+}
+
+Arena* ArenaFreeList::TakeAll() {
+  std::lock_guard<std::mutex> lock(lock_);
+  FlushCachesLocked();
+  Arena* ret = free_arenas_;
+  free_arenas_ = nullptr;
+  return ret;
+}
+
+void ArenaFreeList::FlushCachesLocked() const {
+  for (Cache& cache : caches_) {
+    std::lock_guard<std::mutex> cache_lock(cache.lock);
+    while (cache.arenas != nullptr) {
+      Arena* arena = cache.arenas;
+      cache.arenas = arena->next_;
+      arena->next_ = free_arenas_;
+      free_arenas_ = arena;
+    }
+    cache.num_arenas = 0u;
+  }
+}
+
+void ArenaFreeList::RecordNewArena() {
+  std::lock_guard<std::mutex> lock(lock_);
+  ++num_new_;
+}
+
+void ArenaFreeList::DumpStats(std::ostream& os) const {
+  size_t num_reused_from_caches = 0u;
+  for (Cache& cache : caches_) {
+    std::lock_guard<std::mutex> cache_lock(cache.lock);
+    num_reused_from_caches += cache.num_reused;
+  }
+  std::lock_guard<std::mutex> lock(lock_);
+  os << "Arena pool: new arenas=" << num_new_
+     << " reused from thread caches=" << num_reused_from_caches
+     << " reused from shared list=" << num_reused_;
+}
+
 size_t ArenaAllocator::BytesAllocated() const {
   return ArenaAllocatorStats::BytesAllocated();
 }
@@ -208,7 +309,19 @@ ArenaAllocator::ArenaAllocator(ArenaPool* pool)
     begin_(nullptr),
     end_(nullptr),
     ptr_(nullptr),
-    arena_head_(nullptr) {
+    arena_head_(nullptr),
+    recycled_blocks_() {
+}
+
+void* ArenaAllocator::AllocRecycled(size_t size_class, size_t bytes, ArenaAllocKind kind) {
+  void* block = recycled_blocks_[size_class];
+  if (block == nullptr) {
+    return Alloc(RecycledSizeClassBytes(size_class), kind);
+  }
+  recycled_blocks_[size_class] = *reinterpret_cast<void**>(block);
+  ArenaAllocatorStats::RecordAlloc(bytes, kind);
+  memset(block, 0, bytes);
+  return block;
 }
 
 void ArenaAllocator::UpdateBytesAllocated() {
@@ -20,11 +20,17 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include <algorithm>
+#include <array>
+#include <iosfwd>
+#include <mutex>
+
 #include "bit_utils.h"
 #include "debug_stack.h"
 #include "dchecked_vector.h"
 #include "macros.h"
 #include "memory_tool.h"
+#include "native_memory_tracker.h"
 
 namespace art {
 
@@ -104,6 +110,7 @@ enum ArenaAllocKind {
   kArenaAllocScheduler,
   kArenaAllocProfile,
   kArenaAllocSuperblockCloner,
+  kArenaAllocTransaction,
   kNumArenaAllocKinds
 };
 
@@ -212,6 +219,7 @@ class Arena {
   uint8_t* memory_;
   size_t size_;
   Arena* next_;
+  friend class ArenaFreeList;
   friend class MallocArenaPool;
   friend class MemMapArenaPool;
   friend class ArenaAllocator;
@@ -236,14 +244,82 @@ class ArenaPool {
   virtual void LockReclaimMemory() = 0;
   // Trim the maps in arenas by madvising, used by JIT to reduce memory usage.
   virtual void TrimMaps() = 0;
+  // Dump how often arena allocations were served by reusing free arenas.
+  virtual void DumpStats(std::ostream& os) const = 0;
+
+  // Which NativeMemoryTracker tag the arenas allocated from now on count towards.
+  void SetNativeMemoryTag(NativeMemoryTag tag) {
+    native_memory_tag_ = tag;
+  }
+  NativeMemoryTag GetNativeMemoryTag() const {
+    return native_memory_tag_;
+  }
 
  protected:
   ArenaPool() = default;
 
  private:
+  NativeMemoryTag native_memory_tag_ = NativeMemoryTag::kOther;
+
   DISALLOW_COPY_AND_ASSIGN(ArenaPool);
 };
 
+// Free arenas of an ArenaPool. Compiler threads allocate and free arenas all the time, so
+// instead of a single list guarded by one lock, each thread mostly works with a small cache
+// of its own, picked by a per-thread index. Caches are bounded and overflow to a shared list.
+class ArenaFreeList {
+ public:
+  ArenaFreeList();
+  ~ArenaFreeList();
+
+  // Take a free arena of at least `size` bytes, or return null if there is none at hand.
+  Arena* Take(size_t size);
+  // Make a chain of arenas available for reuse.
+  void Put(Arena* first);
+  // Return all free arenas as a chain, leaving the free list empty.
+  Arena* TakeAll();
+  // Move the arenas of the per-thread caches to the shared list and call `visitor` for each free
+  // arena while holding the lock of the shared list.
+  template <typename Visitor>
+  void VisitArenas(const Visitor& visitor) const;
+  // Count a newly allocated arena, i.e. a failure to reuse one.
+  void RecordNewArena();
+  void DumpStats(std::ostream& os) const;
+
+ private:
+  static constexpr size_t kNumCaches = 8;
+  static constexpr size_t kMaxArenasPerCache = 8;
+
+  // Align to avoid false sharing between the caches of different threads.
+  struct alignas(64) Cache {
+    std::mutex lock;
+    Arena* arenas = nullptr;
+    size_t num_arenas = 0u;
+    size_t num_reused = 0u;  // Allocations served by this cache.
+  };
+
+  static size_t CacheIndexForCurrentThread();
+  void FlushCachesLocked() const;
+
+  mutable Cache caches_[kNumCaches];
+  // Use a std::mutex here as Arenas are at the bottom of the lock hierarchy.
+  mutable std::mutex lock_;
+  mutable Arena* free_arenas_;
+  size_t num_reused_;  // Allocations served by the shared list.
+  size_t num_new_;  // Allocations of new arenas.
+
+  DISALLOW_COPY_AND_ASSIGN(ArenaFreeList);
+};
+
+template <typename Visitor>
+void ArenaFreeList::VisitArenas(const Visitor& visitor) const {
+  std::lock_guard<std::mutex> lock(lock_);
+  FlushCachesLocked();
+  for (Arena* arena = free_arenas_; arena != nullptr; arena = arena->next_) {
+    visitor(arena);
+  }
+}
+
 // Fast single-threaded allocator for zero-initialized memory chunks.
 //
 // Memory is allocated from ArenaPool in large chunks and then rationed through
@@ -331,6 +407,31 @@ class ArenaAllocator
     return new_ptr;
   }
 
+  // Returns zeroed memory. Blocks of at least kMinRecycledSize bytes are rounded up to a size
+  // class and taken from the blocks returned with Free() when possible, so that temporary
+  // structures that are grown or discarded do not keep adding to the arena footprint.
+  void* AllocRecyclable(size_t bytes, ArenaAllocKind kind = kArenaAllocMisc) ALWAYS_INLINE {
+    if (bytes >= kMinRecycledSize && LIKELY(!IsRunningOnMemoryTool())) {
+      const size_t size_class = RecycledSizeClassRoundUp(bytes);
+      if (size_class < kNumRecycledSizeClasses) {
+        return AllocRecycled(size_class, bytes, kind);
+      }
+    }
+    return Alloc(bytes, kind);
+  }
+
+  // Give back a block of `bytes` bytes allocated from this allocator. The block is reused by
+  // later AllocRecyclable() calls; blocks smaller than kMinRecycledSize are simply dropped.
+  void Free(void* ptr, size_t bytes) ALWAYS_INLINE {
+    if (UNLIKELY(IsRunningOnMemoryTool())) {
+      MakeInaccessible(ptr, bytes);
+    } else if (bytes >= kMinRecycledSize) {
+      const size_t size_class = RecycledSizeClassRoundDown(bytes);
+      *reinterpret_cast<void**>(ptr) = recycled_blocks_[size_class];
+      recycled_blocks_[size_class] = ptr;
+    }
+  }
+
   template <typename T>
   T* Alloc(ArenaAllocKind kind = kArenaAllocMisc) {
     return AllocArray<T>(1, kind);
@@ -361,7 +462,40 @@ class ArenaAllocator
   // The alignment required for the whole Arena rather than individual allocations.
   static constexpr size_t kArenaAlignment = 16u;
 
+  // Recycled blocks are kept in free lists by size class. Each power of two range is split
+  // into 1 << kRecycledSizeClassBits classes, so rounding up wastes at most 25%.
+  static constexpr size_t kRecycledSizeClassBits = 2u;
+  static constexpr size_t kMinRecycledSizeShift = 6u;
+  static constexpr size_t kMinRecycledSize = 1u << kMinRecycledSizeShift;
+  static constexpr size_t kNumRecycledSizeClasses = 64u;
+
+  static size_t RecycledSizeClassBytes(size_t size_class) {
+    DCHECK_LT(size_class, kNumRecycledSizeClasses);
+    const size_t shift = (size_class >> kRecycledSizeClassBits) + kMinRecycledSizeShift;
+    const size_t sub_class = size_class & ((1u << kRecycledSizeClassBits) - 1u);
+    return ((1u << kRecycledSizeClassBits) + sub_class) << (shift - kRecycledSizeClassBits);
+  }
+
+  // Return the largest size class not bigger than `bytes`.
+  static size_t RecycledSizeClassRoundDown(size_t bytes) {
+    DCHECK_GE(bytes, kMinRecycledSize);
+    const size_t shift = BitSizeOf<size_t>() - 1u - CLZ(bytes);
+    const size_t sub_class =
+        (bytes >> (shift - kRecycledSizeClassBits)) & ((1u << kRecycledSizeClassBits) - 1u);
+    const size_t size_class =
+        ((shift - kMinRecycledSizeShift) << kRecycledSizeClassBits) + sub_class;
+    return std::min(size_class, kNumRecycledSizeClasses - 1u);
+  }
+
+  // Return the smallest size class not smaller than `bytes`, or kNumRecycledSizeClasses
+  // if `bytes` is bigger than all size classes.
+  static size_t RecycledSizeClassRoundUp(size_t bytes) {
+    const size_t size_class = RecycledSizeClassRoundDown(bytes);
+    return (RecycledSizeClassBytes(size_class) < bytes) ? size_class + 1u : size_class;
+  }
+
  private:
+  void* AllocRecycled(size_t size_class, size_t bytes, ArenaAllocKind kind);
   void* AllocWithMemoryTool(size_t bytes, ArenaAllocKind kind);
   void* AllocWithMemoryToolAlign16(size_t bytes, ArenaAllocKind kind);
   uint8_t* AllocFromNewArena(size_t bytes);
@@ -374,6 +508,8 @@ class ArenaAllocator
   uint8_t* end_;
   uint8_t* ptr_;
   Arena* arena_head_;
+  // Heads of the intrusive free lists of recycled blocks, one per size class.
+  std::array<void*, kNumRecycledSizeClasses> recycled_blocks_;
 
   template <typename U>
   friend class ArenaAllocatorAdapter;
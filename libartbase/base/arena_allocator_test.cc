@@ -349,5 +349,43 @@ TEST_F(ArenaAllocatorTest, ReallocAlignment) {
   }
 }
 
+TEST_F(ArenaAllocatorTest, RecycledSizeClasses) {
+  for (size_t size_class = 0; size_class != ArenaAllocator::kNumRecycledSizeClasses; ++size_class) {
+    const size_t bytes = ArenaAllocator::RecycledSizeClassBytes(size_class);
+    ASSERT_TRUE(IsAligned<ArenaAllocator::kAlignment>(bytes));
+    ASSERT_EQ(size_class, ArenaAllocator::RecycledSizeClassRoundDown(bytes));
+    ASSERT_EQ(size_class, ArenaAllocator::RecycledSizeClassRoundUp(bytes));
+    ASSERT_EQ(size_class, ArenaAllocator::RecycledSizeClassRoundDown(bytes + 1u));
+    ASSERT_EQ(size_class + 1u, ArenaAllocator::RecycledSizeClassRoundUp(bytes + 1u));
+    if (size_class != 0u) {
+      ASSERT_LT(ArenaAllocator::RecycledSizeClassBytes(size_class - 1u), bytes);
+    }
+  }
+}
+
+TEST_F(ArenaAllocatorTest, Recycle) {
+  MallocArenaPool pool;
+  ArenaAllocator allocator(&pool);
+  // Small blocks are not recycled.
+  void* small = allocator.AllocRecyclable(ArenaAllocator::kMinRecycledSize / 2u);
+  allocator.Free(small, ArenaAllocator::kMinRecycledSize / 2u);
+  EXPECT_NE(small, allocator.AllocRecyclable(ArenaAllocator::kMinRecycledSize / 2u));
+
+  const size_t size = 1000u;
+  uint8_t* block = static_cast<uint8_t*>(allocator.AllocRecyclable(size));
+  memset(block, 0xff, size);
+  allocator.Free(block, size);
+  if (IsRunningOnMemoryTool()) {
+    return;  // Freed memory is not reused with the memory tool.
+  }
+  // A smaller block of the same size class reuses the memory, zeroed.
+  const size_t bytes_used = allocator.BytesUsed();
+  uint8_t* reused = static_cast<uint8_t*>(allocator.AllocRecyclable(size - 8u));
+  EXPECT_EQ(block, reused);
+  EXPECT_TRUE(std::all_of(reused, reused + size - 8u, [](uint8_t b) { return b == 0u; }));
+  EXPECT_EQ(bytes_used, allocator.BytesUsed());
+  // The free list for the size class is now empty.
+  EXPECT_NE(block, allocator.AllocRecyclable(size));
+}
 
 }  // namespace art
@@ -18,6 +18,7 @@
 
 #include "allocator.h"
 #include "arena_allocator.h"
+#include "scoped_arena_allocator.h"
 
 namespace art {
 
@@ -49,6 +50,25 @@ class ArenaBitVectorAllocatorKindImpl {
 using ArenaBitVectorAllocatorKind =
     ArenaBitVectorAllocatorKindImpl<kArenaAllocatorCountAllocations>;
 
+// Only the ArenaAllocator can reuse freed storage; the ScopedArenaAllocator releases all its
+// memory at once when it goes out of scope.
+static void* AllocFromArena(ArenaAllocator* allocator, size_t size, ArenaAllocKind kind) {
+  return allocator->AllocRecyclable(size, kind);
+}
+
+static void* AllocFromArena(ScopedArenaAllocator* allocator, size_t size, ArenaAllocKind kind) {
+  return allocator->Alloc(size, kind);
+}
+
+static void FreeToArena(ArenaAllocator* allocator, void* p, size_t size) {
+  allocator->Free(p, size);
+}
+
+static void FreeToArena(ScopedArenaAllocator* allocator ATTRIBUTE_UNUSED,
+                        void* p ATTRIBUTE_UNUSED,
+                        size_t size ATTRIBUTE_UNUSED) {
+}
+
 template <typename ArenaAlloc>
 class ArenaBitVectorAllocator final : public Allocator, private ArenaBitVectorAllocatorKind {
  public:
@@ -63,11 +83,15 @@ class ArenaBitVectorAllocator final : public Allocator, private ArenaBitVectorAl
   }
 
   void* Alloc(size_t size) override {
-    return allocator_->Alloc(size, this->Kind());
+    return AllocFromArena(allocator_, size, this->Kind());
   }
 
   void Free(void*) override {}  // Nop.
 
+  void FreeSized(void* p, size_t size) override {
+    FreeToArena(allocator_, p, size);
+  }
+
  private:
   ArenaBitVectorAllocator(ArenaAlloc* allocator, ArenaAllocKind kind)
       : ArenaBitVectorAllocatorKind(kind), allocator_(allocator) { }
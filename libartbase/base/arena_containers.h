@@ -197,10 +197,11 @@ class ArenaAllocatorAdapter : private ArenaAllocatorAdapterKind {
   pointer allocate(size_type n,
                    ArenaAllocatorAdapter<void>::pointer hint ATTRIBUTE_UNUSED = nullptr) {
     DCHECK_LE(n, max_size());
-    return allocator_->AllocArray<T>(n, ArenaAllocatorAdapterKind::Kind());
+    return static_cast<T*>(
+        allocator_->AllocRecyclable(n * sizeof(T), ArenaAllocatorAdapterKind::Kind()));
   }
   void deallocate(pointer p, size_type n) {
-    allocator_->MakeInaccessible(p, sizeof(T) * n);
+    allocator_->Free(p, sizeof(T) * n);
   }
 
   template <typename U, typename... Args>
@@ -24,6 +24,10 @@
 
 namespace art {
 
+// The loops below are written without data-dependent branches so that the compiler can
+// vectorize them; `changed` is accumulated from the bits that differ instead of being
+// checked word by word.
+
 BitVector::BitVector(bool expandable,
                      Allocator* allocator,
                      uint32_t storage_size,
@@ -60,7 +64,7 @@ BitVector::BitVector(const BitVector& src,
 }
 
 BitVector::~BitVector() {
-  allocator_->Free(storage_);
+  allocator_->FreeSized(storage_, storage_size_ * kWordBytes);
 }
 
 bool BitVector::SameBitsSet(const BitVector *src) const {
@@ -105,14 +109,12 @@ bool BitVector::IsSubsetOf(const BitVector *other) const {
 
   // Compare each 32-bit word.
   size_t this_highest_index = BitsToWords(this_highest + 1);
+  const uint32_t* other_storage = other->storage_;
+  uint32_t extra_bits = 0u;
   for (size_t i = 0; i < this_highest_index; ++i) {
-    uint32_t this_storage = storage_[i];
-    uint32_t other_storage = other->storage_[i];
-    if ((this_storage | other_storage) != other_storage) {
-      return false;
-    }
+    extra_bits |= storage_[i] & ~other_storage[i];
   }
-  return true;
+  return extra_bits == 0u;
 }
 
 void BitVector::Intersect(const BitVector* src) {
@@ -121,9 +123,11 @@ void BitVector::Intersect(const BitVector* src) {
   // Get the minimum size between us and source.
   uint32_t min_size = (storage_size_ < src_storage_size) ? storage_size_ : src_storage_size;
 
+  uint32_t* storage = storage_;
+  const uint32_t* src_storage = src->GetRawStorage();
   uint32_t idx;
   for (idx = 0; idx < min_size; idx++) {
-    storage_[idx] &= src->GetRawStorageWord(idx);
+    storage[idx] &= src_storage[idx];
   }
 
   // Now, due to this being an intersection, there are two possibilities:
@@ -158,15 +162,16 @@ bool BitVector::Union(const BitVector* src) {
     DCHECK_LT(static_cast<uint32_t> (highest_bit), storage_size_ * kWordBits);
   }
 
+  uint32_t* storage = storage_;
+  const uint32_t* src_storage = src->GetRawStorage();
+  uint32_t diff = 0u;
   for (uint32_t idx = 0; idx < src_size; idx++) {
-    uint32_t existing = storage_[idx];
-    uint32_t update = existing | src->GetRawStorageWord(idx);
-    if (existing != update) {
-      changed = true;
-      storage_[idx] = update;
-    }
+    uint32_t existing = storage[idx];
+    uint32_t update = existing | src_storage[idx];
+    diff |= existing ^ update;
+    storage[idx] = update;
   }
-  return changed;
+  return changed || diff != 0u;
 }
 
 bool BitVector::UnionIfNotIn(const BitVector* union_with, const BitVector* not_in) {
@@ -191,27 +196,26 @@ bool BitVector::UnionIfNotIn(const BitVector* union_with, const BitVector* not_i
   }
 
   uint32_t not_in_size = not_in->GetStorageSize();
+  uint32_t* storage = storage_;
+  const uint32_t* union_with_storage = union_with->GetRawStorage();
+  const uint32_t* not_in_storage = not_in->GetRawStorage();
+  uint32_t diff = 0u;
 
   uint32_t idx = 0;
-  for (; idx < std::min(not_in_size, union_with_size); idx++) {
-    uint32_t existing = storage_[idx];
-    uint32_t update = existing |
-        (union_with->GetRawStorageWord(idx) & ~not_in->GetRawStorageWord(idx));
-    if (existing != update) {
-      changed = true;
-      storage_[idx] = update;
-    }
+  for (uint32_t end = std::min(not_in_size, union_with_size); idx < end; idx++) {
+    uint32_t existing = storage[idx];
+    uint32_t update = existing | (union_with_storage[idx] & ~not_in_storage[idx]);
+    diff |= existing ^ update;
+    storage[idx] = update;
   }
 
   for (; idx < union_with_size; idx++) {
-    uint32_t existing = storage_[idx];
-    uint32_t update = existing | union_with->GetRawStorageWord(idx);
-    if (existing != update) {
-      changed = true;
-      storage_[idx] = update;
-    }
+    uint32_t existing = storage[idx];
+    uint32_t update = existing | union_with_storage[idx];
+    diff |= existing ^ update;
+    storage[idx] = update;
   }
-  return changed;
+  return changed || diff != 0u;
 }
 
 void BitVector::Subtract(const BitVector *src) {
@@ -224,8 +228,10 @@ void BitVector::Subtract(const BitVector *src) {
   //   There is no need to do more:
   //     If we are bigger than src, the upper bits are unchanged.
   //     If we are smaller than src, the nonexistent upper bits are 0 and thus can't get subtracted.
+  uint32_t* storage = storage_;
+  const uint32_t* src_storage = src->GetRawStorage();
   for (uint32_t idx = 0; idx < min_size; idx++) {
-    storage_[idx] &= (~(src->GetRawStorageWord(idx)));
+    storage[idx] &= ~src_storage[idx];
   }
 }
 
@@ -360,7 +366,7 @@ void BitVector::EnsureSize(uint32_t idx) {
     // TODO: collect stats on space wasted because of resize.
 
     // Free old storage.
-    allocator_->Free(storage_);
+    allocator_->FreeSized(storage_, storage_size_ * kWordBytes);
 
     // Set fields.
     storage_ = new_storage;
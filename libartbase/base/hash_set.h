@@ -89,6 +89,7 @@ class HashSetIterator : std::iterator<std::forward_iterator_tag, Elem> {
   friend bool operator==(const HashSetIterator<Elem1, HashSetType1>& lhs,
                          const HashSetIterator<Elem2, HashSetType2>& rhs);
   template <class T, class EmptyFn, class HashFn, class Pred, class Alloc> friend class HashSet;
+  template <class T, class HashFn, class Pred, class Alloc> friend class SwissHashSet;
   template <class OtherElem, class OtherHashSetType> friend class HashSetIterator;
 };
 
@@ -578,6 +579,12 @@ class HashSet {
     return num_buckets_;
   }
 
+  // Returns the bucket array, NumBuckets() elements long. Empty buckets satisfy EmptyFn::IsEmpty.
+  // Elements are placed by linear probing starting at `hash % NumBuckets()`.
+  const T* data() const {
+    return data_;
+  }
+
  private:
   T& ElementForIndex(size_t index) {
     DCHECK_LT(index, NumBuckets());
@@ -17,6 +17,8 @@
 #ifndef ART_LIBARTBASE_BASE_LEB128_H_
 #define ART_LIBARTBASE_BASE_LEB128_H_
 
+#include <string.h>
+
 #include <vector>
 
 #include <android-base/logging.h>
@@ -55,6 +57,43 @@ static inline uint32_t DecodeUnsignedLeb128(const uint8_t** data) {
   return static_cast<uint32_t>(result);
 }
 
+// Reads `count` unsigned LEB128 values into `out`, updating the given pointer to point just past
+// the end of the last value. Most values in dex tables are small, so runs of single-byte values
+// are checked with one word load and copied without the per-byte continuation tests. Loading
+// N bytes is safe when at least N values remain since each value takes at least one byte.
+static inline void DecodeUnsignedLeb128s(const uint8_t** data, uint32_t* out, size_t count) {
+  const uint8_t* ptr = *data;
+  size_t i = 0u;
+  while (i != count) {
+    const size_t remaining = count - i;
+    if (remaining >= 8u) {
+      uint64_t word;
+      memcpy(&word, ptr, sizeof(word));
+      if ((word & UINT64_C(0x8080808080808080)) == 0u) {
+        for (size_t j = 0; j != 8u; ++j) {
+          out[i + j] = ptr[j];
+        }
+        i += 8u;
+        ptr += 8u;
+        continue;
+      }
+    } else if (remaining >= 2u) {
+      uint16_t half_word;
+      memcpy(&half_word, ptr, sizeof(half_word));
+      if ((half_word & 0x8080u) == 0u) {
+        out[i] = ptr[0];
+        out[i + 1u] = ptr[1];
+        i += 2u;
+        ptr += 2u;
+        continue;
+      }
+    }
+    out[i] = DecodeUnsignedLeb128(&ptr);
+    ++i;
+  }
+  *data = ptr;
+}
+
 static inline uint32_t DecodeUnsignedLeb128WithoutMovingCursor(const uint8_t* data) {
   return DecodeUnsignedLeb128(&data);
 }
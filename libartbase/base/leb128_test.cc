@@ -172,6 +172,33 @@ TEST(Leb128Test, UnsignedStream) {
   EXPECT_EQ(data_size, static_cast<size_t>(encoded_data_ptr - encoded_data));
 }
 
+TEST(Leb128Test, UnsignedBulk) {
+  // Mix runs of single-byte values with longer values to cover the word-sized fast paths.
+  std::vector<uint32_t> values;
+  for (size_t i = 0; i < 64; ++i) {
+    values.push_back((i % 11 == 10) ? uleb128_tests[i % arraysize(uleb128_tests)].decoded : i);
+  }
+  uint8_t encoded_data[5 * 64];
+  uint8_t* end = encoded_data;
+  for (uint32_t value : values) {
+    end = EncodeUnsignedLeb128(end, value);
+  }
+  for (size_t count = 0; count <= values.size(); ++count) {
+    std::vector<uint32_t> decoded(count);
+    const uint8_t* bulk_ptr = encoded_data;
+    DecodeUnsignedLeb128s(&bulk_ptr, decoded.data(), count);
+    const uint8_t* single_ptr = encoded_data;
+    for (size_t i = 0; i < count; ++i) {
+      EXPECT_EQ(values[i], decoded[i]) << " count = " << count << " i = " << i;
+      DecodeUnsignedLeb128(&single_ptr);
+    }
+    EXPECT_EQ(single_ptr, bulk_ptr) << " count = " << count;
+    if (count == values.size()) {
+      EXPECT_EQ(end, bulk_ptr);
+    }
+  }
+}
+
 TEST(Leb128Test, SignedSinglesVector) {
   // Test individual encodings.
   for (size_t i = 0; i < arraysize(sleb128_tests); ++i) {
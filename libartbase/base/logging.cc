@@ -16,13 +16,18 @@
 
 #include "logging.h"
 
+#include <condition_variable>
 #include <iostream>
 #include <limits>
+#include <mutex>
 #include <sstream>
+#include <thread>
+#include <vector>
 
 #include "aborting.h"
 #include "os.h"
 #include "unix_file/fd_file.h"
+#include "utils.h"
 
 // Headers for LogMessage::LogLine.
 #ifdef ART_TARGET_ANDROID
@@ -41,6 +46,8 @@ std::atomic<unsigned int> gAborting(0);
 static std::unique_ptr<std::string> gCmdLine;
 static std::unique_ptr<std::string> gProgramInvocationName;
 static std::unique_ptr<std::string> gProgramInvocationShortName;
+// The logger passed to android::base::InitLogging() by InitLogging().
+static std::unique_ptr<android::base::LogFunction> gDefaultLogger;
 
 const char* GetCmdLine() {
   return (gCmdLine.get() != nullptr) ? gCmdLine->c_str() : nullptr;
@@ -83,11 +90,139 @@ void InitLogging(char* argv[], AbortFunction& abort_function) {
 #else
 #define INIT_LOGGING_DEFAULT_LOGGER android::base::StderrLogger
 #endif
-  android::base::InitLogging(argv, INIT_LOGGING_DEFAULT_LOGGER,
+  gDefaultLogger.reset(new android::base::LogFunction(INIT_LOGGING_DEFAULT_LOGGER));
+  android::base::InitLogging(argv,
+                             android::base::LogFunction(*gDefaultLogger),
                              std::move<AbortFunction>(abort_function));
 #undef INIT_LOGGING_DEFAULT_LOGGER
 }
 
+// Logger queueing messages for a background writer thread.
+class AsyncLogger {
+ public:
+  explicit AsyncLogger(const android::base::LogFunction& logger)
+      : logger_(logger),
+        writer_(&AsyncLogger::WriterLoop, this) {
+    writer_.detach();
+  }
+
+  void Log(android::base::LogId id,
+           LogSeverity severity,
+           const char* tag,
+           const char* file,
+           unsigned int line,
+           const char* message) {
+    if (severity < android::base::FATAL_WITHOUT_ABORT) {
+      std::lock_guard<std::mutex> lock(queue_lock_);
+      // When the writer cannot keep up, fall back to writing synchronously below rather than
+      // dropping messages or growing the queue without bound.
+      if (pending_.size() < kMaxPendingMessages) {
+        if (pending_.empty()) {
+          queue_cond_.notify_one();
+        }
+        pending_.push_back(Entry { id,
+                                   severity,
+                                   (tag != nullptr) ? tag : "",
+                                   (file != nullptr) ? file : "",
+                                   line,
+                                   message,
+                                   GetTid() });
+        return;
+      }
+    }
+    std::lock_guard<std::mutex> write_lock(write_lock_);
+    WritePendingLocked();
+    logger_(id, severity, tag, file, line, message);
+  }
+
+  void Flush() {
+    std::lock_guard<std::mutex> write_lock(write_lock_);
+    WritePendingLocked();
+  }
+
+ private:
+  static constexpr size_t kMaxPendingMessages = 4096u;
+
+  struct Entry {
+    android::base::LogId id;
+    LogSeverity severity;
+    std::string tag;
+    std::string file;
+    unsigned int line;
+    std::string message;
+    pid_t tid;
+  };
+
+  void WriterLoop() {
+    while (true) {
+      {
+        std::unique_lock<std::mutex> lock(queue_lock_);
+        queue_cond_.wait(lock, [this]() { return !pending_.empty(); });
+      }
+      Flush();
+    }
+  }
+
+  // Must be called with write_lock_ held, so that batches are written in order.
+  void WritePendingLocked() {
+    std::vector<Entry> batch;
+    {
+      std::lock_guard<std::mutex> lock(queue_lock_);
+      batch.swap(pending_);
+    }
+    for (const Entry& entry : batch) {
+      std::string message = "[tid " + std::to_string(entry.tid) + "] " + entry.message;
+      // Null tag and file select the logger defaults, keep them null.
+      logger_(entry.id,
+              entry.severity,
+              entry.tag.empty() ? nullptr : entry.tag.c_str(),
+              entry.file.empty() ? nullptr : entry.file.c_str(),
+              entry.line,
+              message.c_str());
+    }
+  }
+
+  const android::base::LogFunction logger_;
+  std::mutex queue_lock_;
+  std::condition_variable queue_cond_;
+  std::vector<Entry> pending_;  // Guarded by queue_lock_.
+  std::mutex write_lock_;  // Held while writing, orders batches and synchronous messages.
+  std::thread writer_;
+};
+
+// Created on first use and never destroyed, the writer thread may outlive any owner.
+static AsyncLogger* gAsyncLogger = nullptr;
+
+static void FlushAsyncLogger() {
+  gAsyncLogger->Flush();
+}
+
+void StartAsyncLogging() {
+  if (gDefaultLogger == nullptr) {
+    return;
+  }
+  if (gAsyncLogger == nullptr) {
+    gAsyncLogger = new AsyncLogger(*gDefaultLogger);
+    atexit(FlushAsyncLogger);
+  }
+  android::base::SetLogger([](android::base::LogId id,
+                              LogSeverity severity,
+                              const char* tag,
+                              const char* file,
+                              unsigned int line,
+                              const char* message) {
+    gAsyncLogger->Log(id, severity, tag, file, line, message);
+  });
+}
+
+void StopAsyncLogging() {
+  if (gAsyncLogger == nullptr) {
+    return;
+  }
+  android::base::SetLogger(android::base::LogFunction(*gDefaultLogger));
+  gAsyncLogger->Flush();
+}
+
 #ifdef ART_TARGET_ANDROID
 static const android_LogPriority kLogSeverityToAndroidLogPriority[] = {
   ANDROID_LOG_VERBOSE, ANDROID_LOG_DEBUG, ANDROID_LOG_INFO, ANDROID_LOG_WARN,
@@ -70,6 +70,16 @@ extern LogVerbosity gLogVerbosity;
 // This can be used to reveal or conceal logs with specific tags.
 extern void InitLogging(char* argv[], AbortFunction& default_aborter);
 
+// Hand messages to a background thread that writes them with the logger set up by InitLogging,
+// so that threads logging on hot paths only pay for formatting the message. Messages keep their
+// order and are tagged with the id of the thread that logged them. FATAL messages first write
+// all pending messages and are then written synchronously. Has no effect if InitLogging has not
+// been called.
+extern void StartAsyncLogging();
+
+// Write pending messages and go back to writing messages synchronously.
+extern void StopAsyncLogging();
+
 // Returns the command line used to invoke the current tool or null if InitLogging hasn't been
 // performed.
 extern const char* GetCmdLine();
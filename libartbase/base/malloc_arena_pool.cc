@@ -30,7 +30,7 @@ namespace art {
 
 class MallocArena final : public Arena {
  public:
-  explicit MallocArena(size_t size = arena_allocator::kArenaDefaultSize);
+  MallocArena(size_t size, NativeMemoryTag tag);
   virtual ~MallocArena();
  private:
   static constexpr size_t RequiredOverallocation() {
@@ -40,9 +40,10 @@ class MallocArena final : public Arena {
   }
 
   uint8_t* unaligned_memory_;
+  const NativeMemoryTag tag_;
 };
 
-MallocArena::MallocArena(size_t size) {
+MallocArena::MallocArena(size_t size, NativeMemoryTag tag) : tag_(tag) {
   // We need to guarantee kArenaAlignment aligned allocation for the new arena.
   // TODO: Use std::aligned_alloc() when it becomes available with C++17.
   constexpr size_t overallocation = RequiredOverallocation();
@@ -62,6 +63,7 @@ MallocArena::MallocArena(size_t size) {
   }
   DCHECK_ALIGNED(memory_, ArenaAllocator::kArenaAlignment);
   size_ = size;
+  NativeMemoryTracker::RegisterAllocation(tag_, size_);
 }
 
 MallocArena::~MallocArena() {
@@ -73,6 +75,7 @@ MallocArena::~MallocArena() {
     MEMORY_TOOL_MAKE_UNDEFINED(memory_ + size_, tail);
   }
   free(reinterpret_cast<void*>(unaligned_memory_));
+  NativeMemoryTracker::RegisterFree(tag_, size_);
 }
 
 void Arena::Reset() {
@@ -82,7 +85,7 @@ void Arena::Reset() {
   }
 }
 
-MallocArenaPool::MallocArenaPool() : free_arenas_(nullptr) {
+MallocArenaPool::MallocArenaPool() {
 }
 
 MallocArenaPool::~MallocArenaPool() {
@@ -90,29 +93,23 @@ MallocArenaPool::~MallocArenaPool() {
 }
 
 void MallocArenaPool::ReclaimMemory() {
-  while (free_arenas_ != nullptr) {
-    Arena* arena = free_arenas_;
-    free_arenas_ = free_arenas_->next_;
+  Arena* arena = free_arenas_.TakeAll();
+  while (arena != nullptr) {
+    Arena* next = arena->next_;
     delete arena;
+    arena = next;
   }
 }
 
 void MallocArenaPool::LockReclaimMemory() {
-  std::lock_guard<std::mutex> lock(lock_);
   ReclaimMemory();
 }
 
 Arena* MallocArenaPool::AllocArena(size_t size) {
-  Arena* ret = nullptr;
-  {
-    std::lock_guard<std::mutex> lock(lock_);
-    if (free_arenas_ != nullptr && LIKELY(free_arenas_->Size() >= size)) {
-      ret = free_arenas_;
-      free_arenas_ = free_arenas_->next_;
-    }
-  }
+  Arena* ret = free_arenas_.Take(size);
   if (ret == nullptr) {
-    ret = new MallocArena(size);
+    free_arenas_.RecordNewArena();
+    ret = new MallocArena(size, GetNativeMemoryTag());
   }
   ret->Reset();
   return ret;
@@ -124,13 +121,16 @@ void MallocArenaPool::TrimMaps() {
 
 size_t MallocArenaPool::GetBytesAllocated() const {
   size_t total = 0;
-  std::lock_guard<std::mutex> lock(lock_);
-  for (Arena* arena = free_arenas_; arena != nullptr; arena = arena->next_) {
+  free_arenas_.VisitArenas([&total](Arena* arena) {
     total += arena->GetBytesAllocated();
-  }
+  });
   return total;
 }
 
+void MallocArenaPool::DumpStats(std::ostream& os) const {
+  free_arenas_.DumpStats(os);
+}
+
 void MallocArenaPool::FreeArenaChain(Arena* first) {
   if (kRunningOnMemoryTool) {
     for (Arena* arena = first; arena != nullptr; arena = arena->next_) {
@@ -148,15 +148,7 @@ void MallocArenaPool::FreeArenaChain(Arena* first) {
     return;
   }
 
-  if (first != nullptr) {
-    Arena* last = first;
-    while (last->next_ != nullptr) {
-      last = last->next_;
-    }
-    std::lock_guard<std::mutex> lock(lock_);
-    last->next_ = free_arenas_;
-    free_arenas_ = first;
-  }
+  free_arenas_.Put(first);
 }
 
 }  // namespace art
@@ -17,8 +17,6 @@
 #ifndef ART_LIBARTBASE_BASE_MALLOC_ARENA_POOL_H_
 #define ART_LIBARTBASE_BASE_MALLOC_ARENA_POOL_H_
 
-#include <mutex>
-
 #include "arena_allocator.h"
 
 namespace art {
@@ -34,11 +32,10 @@ class MallocArenaPool final : public ArenaPool {
   void LockReclaimMemory() override;
   // Is a nop for malloc pools.
   void TrimMaps() override;
+  void DumpStats(std::ostream& os) const override;
 
  private:
-  Arena* free_arenas_;
-  // Use a std::mutex here as Arenas are at the bottom of the lock hierarchy when malloc is used.
-  mutable std::mutex lock_;
+  ArenaFreeList free_arenas_;
 
   DISALLOW_COPY_AND_ASSIGN(MallocArenaPool);
 };
@@ -28,6 +28,7 @@
 
 #include <map>
 #include <memory>
+#include <set>
 #include <sstream>
 
 #include "android-base/stringprintf.h"
@@ -39,6 +40,8 @@
 #include "logging.h"  // For VLOG_IS_ON.
 #include "memory_tool.h"
 #include "mman.h"  // For the PROT_* and MAP_* constants.
+#include "sharded_stats.h"
+#include "time_utils.h"
 #include "utils.h"
 
 #ifndef MAP_ANONYMOUS
@@ -90,6 +93,8 @@ std::ostream& operator<<(std::ostream& os, const Maps& mem_maps) {
 
 std::mutex* MemMap::mem_maps_lock_ = nullptr;
 
+bool MemMap::use_huge_pages_ = false;
+
 #if USE_ART_LOW_4G_ALLOCATOR
 // Handling mem_map in 32b address range for 64b architectures that do not support MAP_32BIT.
 
@@ -146,6 +151,167 @@ static uintptr_t GenerateNextMemPos() {
 
 // Initialize linear scan to random position.
 uintptr_t MemMap::next_mem_pos_ = GenerateNextMemPos();
+
+// Tracks which parts of the low 4GB are covered by MemMaps, so that the low 4GB allocator can
+// jump from gap to gap instead of walking over every map in gMaps, and fail without scanning
+// when no gap is big enough. MemMaps may overlap (e.g. a reservation and the maps created
+// inside it), so each address range stores the number of maps covering it.
+class Low4GBCoverage {
+ public:
+  static constexpr uintptr_t kEnd = 4 * GB;
+
+  Low4GBCoverage() {
+    gap_sizes_.insert(kEnd - LOW_MEM_START);
+  }
+
+  void Add(uintptr_t begin, uintptr_t end) {
+    begin = std::max(begin, LOW_MEM_START);
+    end = std::min(end, kEnd);
+    if (begin >= end) {
+      return;
+    }
+    ranges_.emplace(begin, end);
+    Update(begin, end, /* add= */ true);
+  }
+
+  // Remove a range recorded by Add() for a map starting at `begin`. The map may have been
+  // resized since, in which case another range recorded at `begin` may be removed instead;
+  // that keeps the counts consistent and only makes the coverage temporarily approximate.
+  void Remove(uintptr_t begin, uintptr_t end) {
+    auto range = ranges_.equal_range(std::max(begin, LOW_MEM_START));
+    if (range.first == range.second) {
+      return;
+    }
+    auto it = range.first;
+    for (auto match = range.first; match != range.second; ++match) {
+      if (match->second == end) {
+        it = match;
+        break;
+      }
+    }
+    const uintptr_t recorded_begin = it->first;
+    const uintptr_t recorded_end = it->second;
+    ranges_.erase(it);
+    Update(recorded_begin, recorded_end, /* add= */ false);
+  }
+
+  // Return the start of the first uncovered range of at least `length` bytes at or after
+  // `ptr`, or kEnd if there is none.
+  uintptr_t FindGap(uintptr_t ptr, size_t length) const {
+    if (gap_sizes_.empty() || *gap_sizes_.rbegin() < length) {
+      return kEnd;
+    }
+    uintptr_t result = kEnd;
+    ForEachGap(ptr, kEnd, [&](uintptr_t gap_begin, uintptr_t gap_end) {
+      gap_begin = std::max(gap_begin, ptr);
+      if (gap_end - gap_begin >= length) {
+        result = gap_begin;
+        return false;
+      }
+      return true;
+    });
+    return result;
+  }
+
+ private:
+  // Number of maps covering the segment from a boundary to the next one. Addresses before the
+  // first boundary are not covered. Adjacent segments always have different counts, so each
+  // segment with a zero count is a maximal gap.
+  using Counts = std::map<uintptr_t, size_t>;
+
+  size_t CountBefore(Counts::const_iterator it) const {
+    return (it == counts_.begin()) ? 0u : std::prev(it)->second;
+  }
+
+  // Call `visitor(gap_begin, gap_end)` for the gaps intersecting [from, to] in address order,
+  // until it returns false.
+  template <typename Visitor>
+  void ForEachGap(uintptr_t from, uintptr_t to, const Visitor& visitor) const {
+    auto it = counts_.upper_bound(from);
+    uintptr_t segment_begin = LOW_MEM_START;
+    size_t count = 0u;
+    if (it != counts_.begin()) {
+      segment_begin = std::prev(it)->first;
+      count = std::prev(it)->second;
+    }
+    while (segment_begin <= to) {
+      const uintptr_t segment_end = (it != counts_.end()) ? it->first : kEnd;
+      if (count == 0u && segment_begin < segment_end && !visitor(segment_begin, segment_end)) {
+        return;
+      }
+      if (it == counts_.end()) {
+        return;
+      }
+      segment_begin = it->first;
+      count = it->second;
+      ++it;
+    }
+  }
+
+  void UpdateGapSizes(uintptr_t from, uintptr_t to, bool insert) {
+    ForEachGap(from, to, [&](uintptr_t gap_begin, uintptr_t gap_end) {
+      if (insert) {
+        gap_sizes_.insert(gap_end - gap_begin);
+      } else {
+        gap_sizes_.erase(gap_sizes_.find(gap_end - gap_begin));
+      }
+      return true;
+    });
+  }
+
+  // Make sure there is a boundary at `address`.
+  Counts::iterator Split(uintptr_t address) {
+    auto it = counts_.lower_bound(address);
+    if (it != counts_.end() && it->first == address) {
+      return it;
+    }
+    return counts_.emplace_hint(it, address, CountBefore(it));
+  }
+
+  void Update(uintptr_t begin, uintptr_t end, bool add) {
+    // Only the gaps touching [begin, end] can change.
+    UpdateGapSizes(begin - 1u, end, /* insert= */ false);
+    auto begin_it = Split(begin);
+    auto end_it = Split(end);
+    for (auto it = begin_it; it != end_it; ++it) {
+      DCHECK(add || it->second != 0u);
+      it->second = add ? it->second + 1u : it->second - 1u;
+    }
+    // Drop the boundaries that no longer separate different counts.
+    for (auto it : { begin_it, end_it }) {
+      if (it->second == CountBefore(it)) {
+        counts_.erase(it);
+      }
+    }
+    UpdateGapSizes(begin - 1u, end, /* insert= */ true);
+  }
+
+  Counts counts_;
+  std::multiset<size_t> gap_sizes_;
+  // The ranges passed to Add() and not yet removed, indexed by begin.
+  std::multimap<uintptr_t, uintptr_t> ranges_;
+};
+
+static Low4GBCoverage* gLow4GBCoverage GUARDED_BY(MemMap::GetMemMapsLock()) = nullptr;
+
+// Statistics of the low 4GB allocator.
+static ShardedCounter gLow4GBReservations;
+static ShardedCounter gLow4GBReservationNs;
+static ShardedCounter gLow4GBPageProbes;
+
+static void TrackLow4GB(const void* begin, size_t size) REQUIRES(MemMap::GetMemMapsLock()) {
+  const uintptr_t address = reinterpret_cast<uintptr_t>(begin);
+  gLow4GBCoverage->Add(address, address + size);
+}
+
+static void UntrackLow4GB(const void* begin, size_t size) REQUIRES(MemMap::GetMemMapsLock()) {
+  const uintptr_t address = reinterpret_cast<uintptr_t>(begin);
+  gLow4GBCoverage->Remove(address, address + size);
+}
+#else
+static void TrackLow4GB(const void* begin ATTRIBUTE_UNUSED, size_t size ATTRIBUTE_UNUSED) {}
+static void UntrackLow4GB(const void* begin ATTRIBUTE_UNUSED, size_t size ATTRIBUTE_UNUSED) {}
+#endif
 #endif
 
 // Return true if the address range is contained in a single memory map by either reading
@@ -485,6 +651,7 @@ bool MemMap::ReplaceWith(MemMap* source, /*out*/std::string* error) {
   source->Invalidate();
 
   size_ = source_size;
+  RegisterNativeMemory(new_base_size - base_size_);
   base_size_ = new_base_size;
   // Reduce base_size if needed (this will unmap the extra pages).
   SetSize(source_size);
@@ -591,14 +758,16 @@ MemMap MemMap::MapFileAtAddress(uint8_t* expected_ptr,
     DCHECK_EQ(actual, reservation->Begin());
     reservation->ReleaseReservedMemory(byte_count);
   }
-  return MemMap(filename,
-                actual + page_offset,
-                byte_count,
-                actual,
-                page_aligned_byte_count,
-                prot,
-                reuse,
-                redzone_size);
+  MemMap map(filename,
+             actual + page_offset,
+             byte_count,
+             actual,
+             page_aligned_byte_count,
+             prot,
+             reuse,
+             redzone_size);
+  map.SetNativeMemoryTag(NativeMemoryTag::kMappedFiles);
+  return map;
 }
 
 MemMap::MemMap(MemMap&& other) noexcept
@@ -641,6 +810,8 @@ void MemMap::Invalidate() {
   std::lock_guard<std::mutex> mu(*mem_maps_lock_);
   auto it = GetGMapsEntry(*this);
   gMaps->erase(it);
+  UntrackLow4GB(base_begin_, base_size_);
+  RegisterNativeMemoryFree(base_size_);
 
   // Mark it as invalid.
   base_size_ = 0u;
@@ -681,6 +852,7 @@ void MemMap::SwapMembers(MemMap& other) {
   std::swap(reuse_, other.reuse_);
   std::swap(already_unmapped_, other.already_unmapped_);
   std::swap(redzone_size_, other.redzone_size_);
+  std::swap(native_memory_tag_, other.native_memory_tag_);
 }
 
 MemMap::MemMap(const std::string& name, uint8_t* begin, size_t size, void* base_begin,
@@ -700,6 +872,31 @@ MemMap::MemMap(const std::string& name, uint8_t* begin, size_t size, void* base_
     std::lock_guard<std::mutex> mu(*mem_maps_lock_);
     DCHECK(gMaps != nullptr);
     gMaps->insert(std::make_pair(base_begin_, this));
+    TrackLow4GB(base_begin_, base_size_);
+    RegisterNativeMemory(base_size_);
+  }
+}
+
+void MemMap::RegisterNativeMemory(size_t bytes) const {
+  // Views of other mappings do not own memory.
+  if (!reuse_) {
+    NativeMemoryTracker::RegisterAllocation(native_memory_tag_, bytes);
+  }
+}
+
+void MemMap::RegisterNativeMemoryFree(size_t bytes) const {
+  if (!reuse_) {
+    NativeMemoryTracker::RegisterFree(native_memory_tag_, bytes);
+  }
+}
+
+void MemMap::SetNativeMemoryTag(NativeMemoryTag tag) {
+  if (IsValid()) {
+    RegisterNativeMemoryFree(base_size_);
+    native_memory_tag_ = tag;
+    RegisterNativeMemory(base_size_);
+  } else {
+    native_memory_tag_ = tag;
   }
 }
 
@@ -771,23 +968,29 @@ MemMap MemMap::RemapAtEnd(uint8_t* new_end,
     std::lock_guard<std::mutex> mu(*mem_maps_lock_);
     auto it = GetGMapsEntry(*this);
     gMaps->erase(it);
+    UntrackLow4GB(base_begin_, base_size_);
   }
 
   if (use_debug_name) {
     SetDebugName(actual, tail_name, tail_base_size);
   }
 
+  RegisterNativeMemoryFree(base_size_ - new_base_size);
   size_ = new_size;
   base_size_ = new_base_size;
   // Return the new mapping.
-  return MemMap(tail_name, actual, tail_size, actual, tail_base_size, tail_prot, false);
+  MemMap tail(tail_name, actual, tail_size, actual, tail_base_size, tail_prot, false);
+  tail.SetNativeMemoryTag(native_memory_tag_);
+  return tail;
 }
 
 MemMap MemMap::TakeReservedMemory(size_t byte_count) {
   uint8_t* begin = Begin();
   ReleaseReservedMemory(byte_count);  // Performs necessary DCHECK()s on this reservation.
   size_t base_size = RoundUp(byte_count, kPageSize);
-  return MemMap(name_, begin, byte_count, begin, base_size, prot_, /* reuse= */ false);
+  MemMap map(name_, begin, byte_count, begin, base_size, prot_, /* reuse= */ false);
+  map.SetNativeMemoryTag(native_memory_tag_);
+  return map;
 }
 
 void MemMap::ReleaseReservedMemory(size_t byte_count) {
@@ -813,12 +1016,15 @@ void MemMap::ReleaseReservedMemory(size_t byte_count) {
     std::lock_guard<std::mutex> mu(*mem_maps_lock_);
     auto it = GetGMapsEntry(*this);
     auto node = gMaps->extract(it);
+    UntrackLow4GB(base_begin_, base_size_);
+    RegisterNativeMemoryFree(byte_count);
     begin_ += byte_count;
     size_ -= byte_count;
     base_begin_ = begin_;
     base_size_ = size_;
     node.key() = base_begin_;
     gMaps->insert(std::move(node));
+    TrackLow4GB(base_begin_, base_size_);
   }
 }
 
@@ -839,6 +1045,23 @@ void MemMap::MadviseDontNeedAndZero() {
   }
 }
 
+void MemMap::MadviseHugePages() {
+#ifdef MADV_HUGEPAGE
+  if (!use_huge_pages_ || base_begin_ == nullptr) {
+    return;
+  }
+  uint8_t* begin = AlignUp(reinterpret_cast<uint8_t*>(base_begin_), kHugePageSize);
+  uint8_t* end = AlignDown(reinterpret_cast<uint8_t*>(BaseEnd()), kHugePageSize);
+  if (begin < end) {
+    int result = madvise(begin, end - begin, MADV_HUGEPAGE);
+    if (result == -1) {
+      // Not fatal, the kernel may be built without transparent huge page support.
+      PLOG(WARNING) << "madvise(MADV_HUGEPAGE) failed for " << name_;
+    }
+  }
+#endif
+}
+
 bool MemMap::Sync() {
 #ifdef _WIN32
   // TODO: add FlushViewOfFile support.
@@ -981,6 +1204,19 @@ MemMap* MemMap::GetLargestMemMapAt(void* address) {
   return largest_map;
 }
 
+void MemMap::DumpForSigQuit(std::ostream& os) {
+#if USE_ART_LOW_4G_ALLOCATOR
+  const uint64_t reservations = gLow4GBReservations.Get();
+  if (reservations != 0u) {
+    os << "Low 4GB reservations: " << reservations
+       << " total time: " << PrettyDuration(gLow4GBReservationNs.Get())
+       << " pages probed: " << gLow4GBPageProbes.Get() << "\n";
+  }
+#else
+  UNUSED(os);
+#endif
+}
+
 void MemMap::Init() {
   if (mem_maps_lock_ != nullptr) {
     // dex2oat calls MemMap::Init twice since its needed before the runtime is created.
@@ -991,6 +1227,10 @@ void MemMap::Init() {
   std::lock_guard<std::mutex> mu(*mem_maps_lock_);
   DCHECK(gMaps == nullptr);
   gMaps = new Maps;
+#if USE_ART_LOW_4G_ALLOCATOR
+  DCHECK(gLow4GBCoverage == nullptr);
+  gLow4GBCoverage = new Low4GBCoverage;
+#endif
 
   TargetMMapInit();
 }
@@ -1006,6 +1246,10 @@ void MemMap::Shutdown() {
     DCHECK(gMaps != nullptr);
     delete gMaps;
     gMaps = nullptr;
+#if USE_ART_LOW_4G_ALLOCATOR
+    delete gLow4GBCoverage;
+    gLow4GBCoverage = nullptr;
+#endif
   }
   delete mem_maps_lock_;
   mem_maps_lock_ = nullptr;
@@ -1028,10 +1272,56 @@ void MemMap::SetSize(size_t new_size) {
                         reinterpret_cast<uintptr_t>(BaseBegin()) + new_base_size),
                         base_size_ - new_base_size), 0)
                         << new_base_size << " " << base_size_;
+  RegisterNativeMemoryFree(base_size_ - new_base_size);
   base_size_ = new_base_size;
   size_ = new_size;
 }
 
+bool MemMap::Grow(size_t new_size, /*out*/std::string* error_msg) {
+#if !HAVE_MREMAP_SYSCALL
+  UNUSED(new_size);
+  *error_msg = "Cannot grow the mapping because we are missing the required mremap syscall";
+  return false;
+#else  // !HAVE_MREMAP_SYSCALL
+  CHECK(IsValid());
+  CHECK_GT(new_size, size_);
+  if (reuse_ || already_unmapped_) {
+    *error_msg = "Mapping is not a real mmap!";
+    return false;
+  }
+  // TODO Support redzones.
+  if (redzone_size_ != 0u || begin_ != base_begin_) {
+    *error_msg = "Mapping does not start at its page-aligned base";
+    return false;
+  }
+  size_t new_base_size = RoundUp(new_size, kPageSize);
+  if (new_base_size == base_size_) {
+    size_ = new_size;
+    return true;
+  }
+  // Hold the lock across the mremap so that nobody sees the `gMaps` entry of the old range after
+  // the kernel may have reused it.
+  std::lock_guard<std::mutex> mu(*mem_maps_lock_);
+  void* res = mremap(base_begin_, base_size_, new_base_size, MREMAP_MAYMOVE);
+  if (res == MAP_FAILED) {
+    *error_msg = std::string("Failed to mremap to grow the mapping. Error was ") + strerror(errno);
+    return false;
+  }
+  auto it = GetGMapsEntry(*this);
+  auto node = gMaps->extract(it);
+  UntrackLow4GB(base_begin_, base_size_);
+  RegisterNativeMemory(new_base_size - base_size_);
+  begin_ = reinterpret_cast<uint8_t*>(res);
+  size_ = new_size;
+  base_begin_ = res;
+  base_size_ = new_base_size;
+  node.key() = base_begin_;
+  gMaps->insert(std::move(node));
+  TrackLow4GB(base_begin_, base_size_);
+  return true;
+#endif  // !HAVE_MREMAP_SYSCALL
+}
+
 void* MemMap::MapInternalArtLow4GBAllocator(size_t length,
                                             int prot,
                                             int flags,
@@ -1042,36 +1332,26 @@ void* MemMap::MapInternalArtLow4GBAllocator(size_t length,
 
   bool first_run = true;
 
+  const uint64_t start_ns = NanoTime();
+  gLow4GBReservations.Add();
+  auto record_time = [start_ns]() {
+    gLow4GBReservationNs.Add(NanoTime() - start_ns);
+  };
+
   std::lock_guard<std::mutex> mu(*mem_maps_lock_);
   for (uintptr_t ptr = next_mem_pos_; ptr < 4 * GB; ptr += kPageSize) {
-    // Use gMaps as an optimization to skip over large maps.
-    // Find the first map which is address > ptr.
-    auto it = gMaps->upper_bound(reinterpret_cast<void*>(ptr));
-    if (it != gMaps->begin()) {
-      auto before_it = it;
-      --before_it;
-      // Start at the end of the map before the upper bound.
-      ptr = std::max(ptr, reinterpret_cast<uintptr_t>(before_it->second->BaseEnd()));
-      CHECK_ALIGNED(ptr, kPageSize);
-    }
-    while (it != gMaps->end()) {
-      // How much space do we have until the next map?
-      size_t delta = reinterpret_cast<uintptr_t>(it->first) - ptr;
-      // If the space may be sufficient, break out of the loop.
-      if (delta >= length) {
-        break;
-      }
-      // Otherwise, skip to the end of the map.
-      ptr = reinterpret_cast<uintptr_t>(it->second->BaseEnd());
-      CHECK_ALIGNED(ptr, kPageSize);
-      ++it;
-    }
+    // Skip over the ART maps to the first gap big enough for the request.
+    ptr = gLow4GBCoverage->FindGap(ptr, length);
+    CHECK_ALIGNED(ptr, kPageSize);
 
-    // Try to see if we get lucky with this address since none of the ART maps overlap.
-    actual = TryMemMapLow4GB(reinterpret_cast<void*>(ptr), length, prot, flags, fd, offset);
-    if (actual != MAP_FAILED) {
-      next_mem_pos_ = reinterpret_cast<uintptr_t>(actual) + length;
-      return actual;
+    if (ptr < 4U * GB) {
+      // Try to see if we get lucky with this address since none of the ART maps overlap.
+      actual = TryMemMapLow4GB(reinterpret_cast<void*>(ptr), length, prot, flags, fd, offset);
+      if (actual != MAP_FAILED) {
+        next_mem_pos_ = reinterpret_cast<uintptr_t>(actual) + length;
+        record_time();
+        return actual;
+      }
     }
 
     if (4U * GB - ptr < length) {
@@ -1092,6 +1372,7 @@ void* MemMap::MapInternalArtLow4GBAllocator(size_t length,
     // Check pages are free.
     bool safe = true;
     for (tail_ptr = ptr; tail_ptr < ptr + length; tail_ptr += kPageSize) {
+      gLow4GBPageProbes.Add();
       if (msync(reinterpret_cast<void*>(tail_ptr), kPageSize, 0) == 0) {
         safe = false;
         break;
@@ -1105,6 +1386,7 @@ void* MemMap::MapInternalArtLow4GBAllocator(size_t length,
     if (safe == true) {
       actual = TryMemMapLow4GB(reinterpret_cast<void*>(ptr), length, prot, flags, fd, offset);
       if (actual != MAP_FAILED) {
+        record_time();
         return actual;
       }
     } else {
@@ -1117,6 +1399,7 @@ void* MemMap::MapInternalArtLow4GBAllocator(size_t length,
     LOG(ERROR) << "Could not find contiguous low-memory space.";
     errno = ENOMEM;
   }
+  record_time();
   return actual;
 #else
   UNUSED(length, prot, flags, fd, offset);
@@ -1286,8 +1569,11 @@ void MemMap::AlignBy(size_t size) {
     node.key() = aligned_base_begin;
     gMaps->insert(std::move(node));
   }
+  UntrackLow4GB(base_begin_, base_size_);
+  RegisterNativeMemoryFree(base_size_ - aligned_base_size);
   base_begin_ = aligned_base_begin;
   base_size_ = aligned_base_size;
+  TrackLow4GB(base_begin_, base_size_);
   begin_ = aligned_base_begin;
   size_ = aligned_base_size;
   DCHECK(gMaps != nullptr);
@@ -26,6 +26,7 @@
 
 #include "android-base/thread_annotations.h"
 #include "macros.h"
+#include "native_memory_tracker.h"
 
 namespace art {
 
@@ -233,10 +234,32 @@ class MemMap {
 
   void MadviseDontNeedAndZero();
 
+  // If huge pages are enabled, ask the kernel to back the 2MB-aligned part of the mapping with
+  // transparent huge pages. Partial huge pages at either end are left with base pages. Releasing
+  // pages with MadviseDontNeedAndZero() or ZeroAndReleasePages() stays correct, the kernel splits
+  // the huge pages covering the released range.
+  void MadviseHugePages();
+
+  // Opt-in for MadviseHugePages(). Set once at startup, before the mappings are created.
+  static void SetUseHugePages(bool use_huge_pages) {
+    use_huge_pages_ = use_huge_pages;
+  }
+  static bool UseHugePages() {
+    return use_huge_pages_;
+  }
+
   int GetProtect() const {
     return prot_;
   }
 
+  // Attributes the memory of this mapping to `tag` in the NativeMemoryTracker. Mappings of files
+  // are tagged kMappedFiles, others kOther until their owner tags them.
+  void SetNativeMemoryTag(NativeMemoryTag tag);
+
+  NativeMemoryTag GetNativeMemoryTag() const {
+    return native_memory_tag_;
+  }
+
   uint8_t* Begin() const {
     return begin_;
   }
@@ -248,6 +271,13 @@ class MemMap {
   // Resize the mem-map by unmapping pages at the end. Currently only supports shrinking.
   void SetSize(size_t new_size);
 
+  // Grow the mem-map to `new_size` bytes with mremap, letting the kernel move the pages to a new
+  // address instead of copying the data. Begin() may change. The new pages are zero-filled.
+  // Only supported for anonymous mappings that own all their pages, have no manual redzone and
+  // start at the page-aligned base. The mapping may move out of the low 4GB, so callers must not
+  // rely on a low 4GB placement. On failure returns false and leaves the mapping unchanged.
+  bool Grow(size_t new_size, /*out*/std::string* error_msg);
+
   uint8_t* End() const {
     return Begin() + Size();
   }
@@ -298,6 +328,9 @@ class MemMap {
   static void DumpMaps(std::ostream& os, bool terse = false)
       REQUIRES(!MemMap::mem_maps_lock_);
 
+  // Dump the statistics of the low 4GB allocator, if it is used.
+  static void DumpForSigQuit(std::ostream& os);
+
   // Init and Shutdown are NOT thread safe.
   // Both may be called multiple times and MemMap objects may be created any
   // time after the first call to Init and before the first call to Shutodwn.
@@ -331,6 +364,10 @@ class MemMap {
   void Invalidate();
   void SwapMembers(MemMap& other);
 
+  // Count `bytes` more or less of this mapping in the NativeMemoryTracker.
+  void RegisterNativeMemory(size_t bytes) const;
+  void RegisterNativeMemoryFree(size_t bytes) const;
+
   static void DumpMapsLocked(std::ostream& os, bool terse)
       REQUIRES(MemMap::mem_maps_lock_);
   static bool HasMemMap(MemMap& map)
@@ -389,6 +426,8 @@ class MemMap {
 
   size_t redzone_size_ = 0u;
 
+  NativeMemoryTag native_memory_tag_ = NativeMemoryTag::kOther;
+
 #if USE_ART_LOW_4G_ALLOCATOR
   static uintptr_t next_mem_pos_;   // Next memory location to check for low_4g extent.
 
@@ -406,6 +445,8 @@ class MemMap {
 
   static std::mutex* mem_maps_lock_;
 
+  static bool use_huge_pages_;
+
   friend class MemMapTest;  // To allow access to base_begin_ and base_size_.
 };
 
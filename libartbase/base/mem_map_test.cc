@@ -319,6 +319,40 @@ TEST_F(MemMapTest, ReplaceMapping_FailureOverlap) {
   ASSERT_EQ(memcmp(source.Begin(), data.data(), data.size()), 0);
   ASSERT_EQ(memcmp(dest.Begin(), dest_data.data(), dest_data.size()), 0);
 }
+
+TEST_F(MemMapTest, Grow) {
+  std::string error_msg;
+  MemMap map = MemMap::MapAnonymous("MapAnonymous-grow",
+                                    2 * kPageSize,
+                                    PROT_READ | PROT_WRITE,
+                                    /*low_4gb=*/ false,
+                                    &error_msg);
+  ASSERT_TRUE(map.IsValid()) << error_msg;
+  std::vector<uint8_t> data = RandomData(2 * kPageSize);
+  memcpy(map.Begin(), data.data(), data.size());
+
+  ASSERT_TRUE(map.Grow(5 * kPageSize, &error_msg)) << error_msg;
+  ASSERT_EQ(map.Size(), 5 * kPageSize);
+  ASSERT_EQ(map.BaseSize(), 5 * kPageSize);
+  ASSERT_TRUE(IsAddressMapped(map.Begin()));
+  ASSERT_TRUE(IsAddressMapped(map.End() - 1));
+  ASSERT_EQ(memcmp(map.Begin(), data.data(), data.size()), 0);
+  // The new pages are zero-filled and writable.
+  for (uint8_t* p = map.Begin() + data.size(); p != map.End(); ++p) {
+    ASSERT_EQ(*p, 0u);
+  }
+  memset(map.Begin() + data.size(), 0x5a, map.Size() - data.size());
+
+  // The grown mapping is still tracked, a new mapping right after it does not overlap.
+  MemMap other = MemMap::MapAnonymous("MapAnonymous-grow-other",
+                                      kPageSize,
+                                      PROT_READ | PROT_WRITE,
+                                      /*low_4gb=*/ false,
+                                      &error_msg);
+  ASSERT_TRUE(other.IsValid()) << error_msg;
+  ASSERT_FALSE(map.Begin() < other.End() && other.Begin() < map.End());
+  ASSERT_TRUE(MemMap::CheckNoGaps(map, map));
+}
 #endif  // HAVE_MREMAP_SYSCALL
 
 TEST_F(MemMapTest, MapAnonymousEmpty) {
@@ -876,6 +910,38 @@ TEST_F(MemMapTest, Reservation) {
   ASSERT_FALSE(map2.IsValid());
 }
 
+TEST_F(MemMapTest, NativeMemoryTag) {
+  CommonInit();
+  std::string error_msg;
+  constexpr NativeMemoryTag kTag = NativeMemoryTag::kMonitors;
+  const size_t start_bytes = NativeMemoryTracker::GetCurrentBytes(kTag);
+  MemMap map = MemMap::MapAnonymous("NativeMemoryTag",
+                                    4 * kPageSize,
+                                    PROT_READ | PROT_WRITE,
+                                    /*low_4gb=*/ false,
+                                    &error_msg);
+  ASSERT_TRUE(map.IsValid()) << error_msg;
+  EXPECT_EQ(NativeMemoryTag::kOther, map.GetNativeMemoryTag());
+  map.SetNativeMemoryTag(kTag);
+  EXPECT_EQ(start_bytes + 4 * kPageSize, NativeMemoryTracker::GetCurrentBytes(kTag));
+  EXPECT_GE(NativeMemoryTracker::GetPeakBytes(kTag), start_bytes + 4 * kPageSize);
+
+  // The tail keeps the tag, so the total does not change.
+  MemMap tail = map.RemapAtEnd(map.Begin() + 3 * kPageSize,
+                               "NativeMemoryTag tail",
+                               PROT_READ | PROT_WRITE,
+                               &error_msg);
+  ASSERT_TRUE(tail.IsValid()) << error_msg;
+  EXPECT_EQ(kTag, tail.GetNativeMemoryTag());
+  EXPECT_EQ(start_bytes + 4 * kPageSize, NativeMemoryTracker::GetCurrentBytes(kTag));
+
+  map.SetSize(2 * kPageSize);
+  EXPECT_EQ(start_bytes + 3 * kPageSize, NativeMemoryTracker::GetCurrentBytes(kTag));
+  map.Reset();
+  tail.Reset();
+  EXPECT_EQ(start_bytes, NativeMemoryTracker::GetCurrentBytes(kTag));
+}
+
 }  // namespace art
 
 namespace {
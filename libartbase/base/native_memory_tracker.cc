@@ -0,0 +1,55 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "native_memory_tracker.h"
+
+#include <ostream>
+
+#include "utils.h"
+
+namespace art {
+
+Atomic<size_t> NativeMemoryTracker::current_bytes_[kNumTags];
+Atomic<size_t> NativeMemoryTracker::peak_bytes_[kNumTags];
+
+std::ostream& operator<<(std::ostream& os, NativeMemoryTag tag) {
+  switch (tag) {
+    case NativeMemoryTag::kOther: return os << "other";
+    case NativeMemoryTag::kJavaHeap: return os << "Java heap";
+    case NativeMemoryTag::kMappedFiles: return os << "mapped files";
+    case NativeMemoryTag::kRuntimeArenas: return os << "runtime arenas";
+    case NativeMemoryTag::kCompilerArenas: return os << "compiler arenas";
+    case NativeMemoryTag::kJitCodeCache: return os << "JIT code cache";
+    case NativeMemoryTag::kGcAccounting: return os << "GC accounting";
+    case NativeMemoryTag::kJniReferences: return os << "JNI references";
+    case NativeMemoryTag::kMonitors: return os << "monitors";
+  }
+  return os << "NativeMemoryTag[" << static_cast<int>(tag) << "]";
+}
+
+void NativeMemoryTracker::Dump(std::ostream& os) {
+  os << "Native memory (current / peak):\n";
+  for (size_t i = 0; i != kNumTags; ++i) {
+    NativeMemoryTag tag = static_cast<NativeMemoryTag>(i);
+    size_t peak = GetPeakBytes(tag);
+    if (peak != 0u) {
+      os << "  " << tag << ": " << PrettySize(GetCurrentBytes(tag)) << " / " << PrettySize(peak)
+         << "\n";
+    }
+  }
+}
+
+}  // namespace art
@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_LIBARTBASE_BASE_NATIVE_MEMORY_TRACKER_H_
+#define ART_LIBARTBASE_BASE_NATIVE_MEMORY_TRACKER_H_
+
+#include <stddef.h>
+
+#include <iosfwd>
+
+#include "atomic.h"
+#include "macros.h"
+
+namespace art {
+
+// What native memory is used for. Memory maps are tagged by their owner with
+// MemMap::SetNativeMemoryTag, arenas by the pool they come from.
+enum class NativeMemoryTag : uint8_t {
+  kOther,
+  kJavaHeap,
+  kMappedFiles,
+  kRuntimeArenas,   // Class metadata (LinearAlloc), verifier and other runtime arenas.
+  kCompilerArenas,
+  kJitCodeCache,
+  kGcAccounting,    // Card table, bitmaps and mark stacks.
+  kJniReferences,
+  kMonitors,
+  kLast = kMonitors,
+};
+std::ostream& operator<<(std::ostream& os, NativeMemoryTag tag);
+
+// Always-on current and peak byte counts of the native memory used by each NativeMemoryTag.
+// Unlike TrackedAllocators, which counts STL containers and is compiled out by default, this
+// counts the big memory users: memory maps and arenas. Updates are relaxed atomic adds, so they
+// can be done from any thread without locks; the peaks are approximate under concurrent updates.
+class NativeMemoryTracker {
+ public:
+  static constexpr size_t kNumTags = static_cast<size_t>(NativeMemoryTag::kLast) + 1u;
+
+  static void RegisterAllocation(NativeMemoryTag tag, size_t bytes) {
+    size_t index = static_cast<size_t>(tag);
+    size_t current = current_bytes_[index].fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    size_t peak = peak_bytes_[index].load(std::memory_order_relaxed);
+    while (peak < current &&
+           !peak_bytes_[index].compare_exchange_weak(peak, current, std::memory_order_relaxed)) {
+    }
+  }
+
+  static void RegisterFree(NativeMemoryTag tag, size_t bytes) {
+    current_bytes_[static_cast<size_t>(tag)].fetch_sub(bytes, std::memory_order_relaxed);
+  }
+
+  static size_t GetCurrentBytes(NativeMemoryTag tag) {
+    return current_bytes_[static_cast<size_t>(tag)].load(std::memory_order_relaxed);
+  }
+
+  static size_t GetPeakBytes(NativeMemoryTag tag) {
+    return peak_bytes_[static_cast<size_t>(tag)].load(std::memory_order_relaxed);
+  }
+
+  // Prints the current and peak usage of each tag which has been used.
+  static void Dump(std::ostream& os);
+
+ private:
+  static Atomic<size_t> current_bytes_[kNumTags];
+  static Atomic<size_t> peak_bytes_[kNumTags];
+
+  DISALLOW_IMPLICIT_CONSTRUCTORS(NativeMemoryTracker);
+};
+
+}  // namespace art
+
+#endif  // ART_LIBARTBASE_BASE_NATIVE_MEMORY_TRACKER_H_
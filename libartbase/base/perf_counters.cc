@@ -0,0 +1,148 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "perf_counters.h"
+
+#include <errno.h>
+#include <string.h>
+
+#include <ostream>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "android-base/logging.h"
+
+namespace art {
+
+void PerfCounterValues::Dump(std::ostream& os) const {
+  os << "cycles: " << cycles << " instructions: " << instructions;
+  if (cycles != 0u) {
+    os << " IPC: " << static_cast<double>(instructions) / cycles;
+  }
+  os << " cache misses: " << cache_misses << " branch misses: " << branch_misses;
+  if (instructions != 0u) {
+    os << " (per 1k instructions: " << cache_misses * 1000.0 / instructions
+       << ", " << branch_misses * 1000.0 / instructions << ")";
+  }
+}
+
+PerfCounters::PerfCounters() : group_fd_(-1) {
+  for (int& fd : fds_) {
+    fd = -1;
+  }
+}
+
+PerfCounters::~PerfCounters() {
+  Close();
+}
+
+void PerfCounters::Close() {
+#if defined(__linux__)
+  for (int& fd : fds_) {
+    if (fd != -1) {
+      close(fd);
+      fd = -1;
+    }
+  }
+#endif
+  group_fd_ = -1;
+}
+
+#if defined(__linux__)
+
+bool PerfCounters::Open(std::string* error_msg) {
+  DCHECK(!IsOpen());
+  static constexpr uint64_t kEvents[kNumCounters] = {
+      PERF_COUNT_HW_CPU_CYCLES,
+      PERF_COUNT_HW_INSTRUCTIONS,
+      PERF_COUNT_HW_CACHE_MISSES,
+      PERF_COUNT_HW_BRANCH_MISSES,
+  };
+  for (size_t i = 0; i != kNumCounters; ++i) {
+    perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = kEvents[i];
+    attr.read_format =
+        PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    // The leader starts disabled and enables the whole group once it is complete.
+    attr.disabled = (i == 0) ? 1 : 0;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    fds_[i] = static_cast<int>(syscall(__NR_perf_event_open,
+                                       &attr,
+                                       /* pid= */ 0,
+                                       /* cpu= */ -1,
+                                       /* group_fd= */ (i == 0) ? -1 : fds_[0],
+                                       PERF_FLAG_FD_CLOEXEC));
+    if (fds_[i] == -1) {
+      *error_msg = std::string("perf_event_open failed: ") + strerror(errno);
+      Close();
+      return false;
+    }
+  }
+  group_fd_ = fds_[0];
+  if (ioctl(group_fd_, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP) != 0) {
+    *error_msg = std::string("Could not enable the perf counters: ") + strerror(errno);
+    Close();
+    return false;
+  }
+  return true;
+}
+
+bool PerfCounters::Read(PerfCounterValues* values) const {
+  DCHECK(IsOpen());
+  // Layout for PERF_FORMAT_GROUP with both total times.
+  struct {
+    uint64_t nr;
+    uint64_t time_enabled;
+    uint64_t time_running;
+    uint64_t values[kNumCounters];
+  } data;
+  ssize_t size = TEMP_FAILURE_RETRY(read(group_fd_, &data, sizeof(data)));
+  if (size != static_cast<ssize_t>(sizeof(data)) || data.nr != kNumCounters) {
+    return false;
+  }
+  double scale = (data.time_running != 0u && data.time_running < data.time_enabled)
+      ? static_cast<double>(data.time_enabled) / data.time_running
+      : 1.0;
+  values->cycles = static_cast<uint64_t>(data.values[0] * scale);
+  values->instructions = static_cast<uint64_t>(data.values[1] * scale);
+  values->cache_misses = static_cast<uint64_t>(data.values[2] * scale);
+  values->branch_misses = static_cast<uint64_t>(data.values[3] * scale);
+  return true;
+}
+
+#else  // __linux__
+
+bool PerfCounters::Open(std::string* error_msg) {
+  *error_msg = "Performance counters are only supported on Linux";
+  return false;
+}
+
+bool PerfCounters::Read(PerfCounterValues* values ATTRIBUTE_UNUSED) const {
+  return false;
+}
+
+#endif  // __linux__
+
+}  // namespace art
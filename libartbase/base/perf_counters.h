@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_LIBARTBASE_BASE_PERF_COUNTERS_H_
+#define ART_LIBARTBASE_BASE_PERF_COUNTERS_H_
+
+#include <stdint.h>
+
+#include <iosfwd>
+#include <string>
+
+#include "macros.h"
+
+namespace art {
+
+// Hardware event counts, as read from the CPU performance monitoring unit.
+struct PerfCounterValues {
+  uint64_t cycles = 0u;
+  uint64_t instructions = 0u;
+  uint64_t cache_misses = 0u;
+  uint64_t branch_misses = 0u;
+
+  PerfCounterValues& operator+=(const PerfCounterValues& other) {
+    cycles += other.cycles;
+    instructions += other.instructions;
+    cache_misses += other.cache_misses;
+    branch_misses += other.branch_misses;
+    return *this;
+  }
+
+  PerfCounterValues operator-(const PerfCounterValues& other) const {
+    PerfCounterValues result;
+    result.cycles = cycles - other.cycles;
+    result.instructions = instructions - other.instructions;
+    result.cache_misses = cache_misses - other.cache_misses;
+    result.branch_misses = branch_misses - other.branch_misses;
+    return result;
+  }
+
+  // Prints the counts with the instructions per cycle and the misses per thousand instructions.
+  void Dump(std::ostream& os) const;
+};
+
+// Counts the hardware events of the thread which opens the counters, in user space only, with
+// perf_event_open(2). The counters form one group, so that they are scheduled on the PMU together
+// and cover the same interval. Opening fails when the kernel or the SELinux policy does not allow
+// the access, or on hosts other than Linux.
+class PerfCounters {
+ public:
+  PerfCounters();
+  ~PerfCounters();
+
+  bool Open(std::string* error_msg);
+
+  bool IsOpen() const {
+    return group_fd_ != -1;
+  }
+
+  // Counts since Open, scaled up if the kernel had to multiplex the PMU between groups.
+  bool Read(PerfCounterValues* values) const;
+
+ private:
+  static constexpr size_t kNumCounters = 4u;
+
+  void Close();
+
+  int group_fd_;
+  int fds_[kNumCounters];
+
+  DISALLOW_COPY_AND_ASSIGN(PerfCounters);
+};
+
+}  // namespace art
+
+#endif  // ART_LIBARTBASE_BASE_PERF_COUNTERS_H_
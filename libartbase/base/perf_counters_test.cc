@@ -0,0 +1,65 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "perf_counters.h"
+
+#include <sstream>
+
+#include "gtest/gtest.h"
+
+namespace art {
+
+TEST(PerfCounters, Values) {
+  PerfCounterValues a;
+  a.cycles = 1000u;
+  a.instructions = 2000u;
+  a.cache_misses = 10u;
+  a.branch_misses = 4u;
+  PerfCounterValues b = a;
+  b += a;
+  EXPECT_EQ(2000u, b.cycles);
+  EXPECT_EQ(8u, b.branch_misses);
+  PerfCounterValues c = b - a;
+  EXPECT_EQ(a.instructions, c.instructions);
+  EXPECT_EQ(a.cache_misses, c.cache_misses);
+
+  std::ostringstream oss;
+  a.Dump(oss);
+  EXPECT_NE(std::string::npos, oss.str().find("IPC: 2"));
+}
+
+TEST(PerfCounters, Read) {
+  PerfCounters counters;
+  std::string error_msg;
+  if (!counters.Open(&error_msg)) {
+    // Emulators, containers and most SELinux domains have no access to the PMU.
+    GTEST_LOG_(INFO) << "Performance counters not available, skipping test: " << error_msg;
+    return;
+  }
+  ASSERT_TRUE(counters.IsOpen());
+  PerfCounterValues start;
+  ASSERT_TRUE(counters.Read(&start));
+  volatile uint64_t sum = 0u;
+  for (uint64_t i = 0; i != 100000u; ++i) {
+    sum += i;
+  }
+  PerfCounterValues end;
+  ASSERT_TRUE(counters.Read(&end));
+  EXPECT_GT(end.instructions, start.instructions);
+  EXPECT_GE(end.cycles, start.cycles);
+}
+
+}  // namespace art
@@ -0,0 +1,190 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_LIBARTBASE_BASE_SHARDED_STATS_H_
+#define ART_LIBARTBASE_BASE_SHARDED_STATS_H_
+
+#include <stdint.h>
+
+#include <array>
+#include <atomic>
+#include <ostream>
+
+#include <android-base/logging.h>
+
+#include "bit_utils.h"
+#include "macros.h"
+
+namespace art {
+
+// Statistics that are cheap enough to keep always on in hot paths. Updates are relaxed atomic
+// adds to one of several shards, picked per thread, so threads rarely write the same cache line.
+// Reads sum up all the shards and are only approximate while updates are in flight.
+
+static constexpr size_t kNumStatsShards = 8;
+static constexpr size_t kStatsShardAlignment = 64;  // Cache line size on supported targets.
+
+// Return the shard for the current thread. Threads are assigned shards round-robin.
+inline size_t CurrentStatsShard() {
+  static std::atomic<size_t> next_shard(0u);
+  static thread_local size_t shard =
+      next_shard.fetch_add(1u, std::memory_order_relaxed) % kNumStatsShards;
+  return shard;
+}
+
+class ShardedCounter {
+ public:
+  ShardedCounter() {}
+
+  ALWAYS_INLINE void Add(uint64_t value = 1u) {
+    shards_[CurrentStatsShard()].value.fetch_add(value, std::memory_order_relaxed);
+  }
+
+  uint64_t Get() const {
+    uint64_t total = 0u;
+    for (const Shard& shard : shards_) {
+      total += shard.value.load(std::memory_order_relaxed);
+    }
+    return total;
+  }
+
+  void Reset() {
+    for (Shard& shard : shards_) {
+      shard.value.store(0u, std::memory_order_relaxed);
+    }
+  }
+
+ private:
+  struct alignas(kStatsShardAlignment) Shard {
+    std::atomic<uint64_t> value{0u};
+  };
+
+  std::array<Shard, kNumStatsShards> shards_;
+
+  DISALLOW_COPY_AND_ASSIGN(ShardedCounter);
+};
+
+// Log-linear histogram of uint64_t values. Each power of two range is split into
+// kSubBuckets equal buckets, so the bucket width is within 25% of the values it holds
+// for any range of values, with a fixed number of buckets and no configuration.
+class ShardedHistogram {
+ public:
+  static constexpr size_t kSubBucketBits = 2u;
+  static constexpr size_t kSubBuckets = 1u << kSubBucketBits;
+  static constexpr size_t kNumBuckets =
+      (BitSizeOf<uint64_t>() - kSubBucketBits + 1u) * kSubBuckets;
+
+  // Aggregated view of the histogram.
+  struct Data {
+    uint64_t count = 0u;
+    uint64_t sum = 0u;
+    std::array<uint64_t, kNumBuckets> buckets = {};
+
+    double Mean() const {
+      return (count != 0u) ? static_cast<double>(sum) / static_cast<double>(count) : 0.0;
+    }
+
+    // Return the lower bound of the bucket holding the given percentile, in [0, 100].
+    uint64_t Percentile(double percentile) const {
+      DCHECK_GE(percentile, 0.0);
+      DCHECK_LE(percentile, 100.0);
+      const uint64_t rank = static_cast<uint64_t>(static_cast<double>(count) * percentile / 100.0);
+      uint64_t seen = 0u;
+      for (size_t i = 0; i < kNumBuckets; ++i) {
+        seen += buckets[i];
+        if (seen > rank) {
+          return BucketLowerBound(i);
+        }
+      }
+      return (count != 0u) ? BucketLowerBound(kNumBuckets - 1u) : 0u;
+    }
+  };
+
+  ShardedHistogram() {}
+
+  ALWAYS_INLINE void AddValue(uint64_t value) {
+    Shard& shard = shards_[CurrentStatsShard()];
+    shard.count.fetch_add(1u, std::memory_order_relaxed);
+    shard.sum.fetch_add(value, std::memory_order_relaxed);
+    shard.buckets[BucketIndex(value)].fetch_add(1u, std::memory_order_relaxed);
+  }
+
+  Data GetData() const {
+    Data data;
+    for (const Shard& shard : shards_) {
+      data.count += shard.count.load(std::memory_order_relaxed);
+      data.sum += shard.sum.load(std::memory_order_relaxed);
+      for (size_t i = 0; i < kNumBuckets; ++i) {
+        data.buckets[i] += shard.buckets[i].load(std::memory_order_relaxed);
+      }
+    }
+    return data;
+  }
+
+  void Reset() {
+    for (Shard& shard : shards_) {
+      shard.count.store(0u, std::memory_order_relaxed);
+      shard.sum.store(0u, std::memory_order_relaxed);
+      for (std::atomic<uint64_t>& bucket : shard.buckets) {
+        bucket.store(0u, std::memory_order_relaxed);
+      }
+    }
+  }
+
+  // Print count, mean and a few percentiles on one line.
+  void Dump(std::ostream& os) const {
+    Data data = GetData();
+    os << "count=" << data.count
+       << " mean=" << data.Mean()
+       << " p50=" << data.Percentile(50.0)
+       << " p90=" << data.Percentile(90.0)
+       << " p99=" << data.Percentile(99.0);
+  }
+
+  static size_t BucketIndex(uint64_t value) {
+    if (value < kSubBuckets) {
+      return value;
+    }
+    const size_t msb = BitSizeOf<uint64_t>() - 1u - CLZ(value);
+    const size_t sub_bucket = (value >> (msb - kSubBucketBits)) & (kSubBuckets - 1u);
+    return (msb - kSubBucketBits + 1u) * kSubBuckets + sub_bucket;
+  }
+
+  static uint64_t BucketLowerBound(size_t index) {
+    DCHECK_LT(index, kNumBuckets);
+    if (index < kSubBuckets) {
+      return index;
+    }
+    const size_t msb = index / kSubBuckets + kSubBucketBits - 1u;
+    const uint64_t sub_bucket = index % kSubBuckets;
+    return (kSubBuckets + sub_bucket) << (msb - kSubBucketBits);
+  }
+
+ private:
+  struct alignas(kStatsShardAlignment) Shard {
+    std::atomic<uint64_t> count{0u};
+    std::atomic<uint64_t> sum{0u};
+    std::array<std::atomic<uint64_t>, kNumBuckets> buckets = {};
+  };
+
+  std::array<Shard, kNumStatsShards> shards_;
+
+  DISALLOW_COPY_AND_ASSIGN(ShardedHistogram);
+};
+
+}  // namespace art
+
+#endif  // ART_LIBARTBASE_BASE_SHARDED_STATS_H_
@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "sharded_stats.h"
+
+#include <limits>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace art {
+
+TEST(ShardedStatsTest, CounterAcrossThreads) {
+  static constexpr size_t kNumThreads = 16;
+  static constexpr size_t kNumAdds = 10000;
+  ShardedCounter counter;
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < kNumThreads; ++i) {
+    threads.emplace_back([&counter]() {
+      for (size_t j = 0; j < kNumAdds; ++j) {
+        counter.Add();
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(kNumThreads * kNumAdds, counter.Get());
+  counter.Reset();
+  EXPECT_EQ(0u, counter.Get());
+}
+
+TEST(ShardedStatsTest, HistogramBuckets) {
+  // Every value falls in the bucket whose range contains it.
+  static constexpr uint64_t kValues[] = {
+      0u, 1u, 3u, 4u, 5u, 7u, 8u, 9u, 1000u, 123456789u, std::numeric_limits<uint64_t>::max()
+  };
+  for (uint64_t value : kValues) {
+    size_t index = ShardedHistogram::BucketIndex(value);
+    ASSERT_LT(index, ShardedHistogram::kNumBuckets) << value;
+    EXPECT_LE(ShardedHistogram::BucketLowerBound(index), value) << value;
+    if (index + 1u < ShardedHistogram::kNumBuckets) {
+      EXPECT_GT(ShardedHistogram::BucketLowerBound(index + 1u), value) << value;
+    }
+  }
+  EXPECT_EQ(ShardedHistogram::kNumBuckets - 1u,
+            ShardedHistogram::BucketIndex(std::numeric_limits<uint64_t>::max()));
+}
+
+TEST(ShardedStatsTest, HistogramPercentiles) {
+  ShardedHistogram histogram;
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < 4; ++i) {
+    threads.emplace_back([&histogram]() {
+      for (uint64_t value = 1u; value <= 1000u; ++value) {
+        histogram.AddValue(value);
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  ShardedHistogram::Data data = histogram.GetData();
+  EXPECT_EQ(4000u, data.count);
+  EXPECT_EQ(4u * 500500u, data.sum);
+  EXPECT_DOUBLE_EQ(500.5, data.Mean());
+  // Buckets are within 25% of their values.
+  EXPECT_LE(data.Percentile(50.0), 500u);
+  EXPECT_GE(data.Percentile(50.0), 375u);
+  EXPECT_LE(data.Percentile(99.0), 990u);
+  EXPECT_GE(data.Percentile(99.0), 742u);
+  histogram.Reset();
+  EXPECT_EQ(0u, histogram.GetData().count);
+}
+
+}  // namespace art
@@ -0,0 +1,564 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_LIBARTBASE_BASE_SWISS_HASH_SET_H_
+#define ART_LIBARTBASE_BASE_SWISS_HASH_SET_H_
+
+#include <stdint.h>
+#include <string.h>
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include <android-base/logging.h>
+
+#include "bit_utils.h"
+#include "hash_set.h"
+#include "macros.h"
+
+namespace art {
+
+namespace swiss_hash_set_internal {
+
+// Control bytes. A full slot stores the low 7 bits of the element hash (H2), so the high bit
+// distinguishes full slots from empty and deleted ones.
+static constexpr uint8_t kEmpty = 0x80u;
+static constexpr uint8_t kDeleted = 0xfeu;
+
+ALWAYS_INLINE static inline bool IsFull(uint8_t ctrl) {
+  return (ctrl & 0x80u) == 0u;
+}
+
+// Set of matching slots within a group, iterated from the lowest slot.
+// `kShift` is log2 of the number of mask bits per slot.
+template <typename MaskType, size_t kShift>
+class GroupMask {
+ public:
+  explicit GroupMask(MaskType mask) : mask_(mask) {}
+
+  bool HasMatch() const {
+    return mask_ != 0u;
+  }
+
+  size_t LowestMatch() const {
+    DCHECK(HasMatch());
+    return static_cast<size_t>(CTZ(mask_)) >> kShift;
+  }
+
+  void ClearLowestMatch() {
+    mask_ &= mask_ - 1u;
+  }
+
+ private:
+  MaskType mask_;
+};
+
+#if defined(__SSE2__)
+
+// Probe 16 control bytes at a time with SSE2 compares.
+class Group {
+ public:
+  static constexpr size_t kWidth = 16u;
+  using Mask = GroupMask<uint32_t, 0u>;
+
+  explicit Group(const uint8_t* ctrl)
+      : ctrl_(_mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl))) {}
+
+  Mask Match(uint8_t h2) const {
+    __m128i match = _mm_cmpeq_epi8(_mm_set1_epi8(static_cast<char>(h2)), ctrl_);
+    return Mask(static_cast<uint32_t>(_mm_movemask_epi8(match)));
+  }
+
+  Mask MatchEmpty() const {
+    return Match(kEmpty);
+  }
+
+  Mask MatchEmptyOrDeleted() const {
+    // Empty and deleted slots are the only ones with the high bit set.
+    return Mask(static_cast<uint32_t>(_mm_movemask_epi8(ctrl_)));
+  }
+
+ private:
+  __m128i ctrl_;
+};
+
+#else
+
+// Probe 8 control bytes at a time with bit tricks on a 64-bit word. This is used on targets
+// without SSE2; the arithmetic compiles to a handful of instructions on arm64 as well.
+class Group {
+ public:
+  static constexpr size_t kWidth = 8u;
+  using Mask = GroupMask<uint64_t, 3u>;
+
+  explicit Group(const uint8_t* ctrl) {
+    memcpy(&ctrl_, ctrl, sizeof(ctrl_));
+  }
+
+  Mask Match(uint8_t h2) const {
+    // May report false positives for bytes following a true match; the caller compares the
+    // elements anyway. There are no false negatives.
+    uint64_t x = ctrl_ ^ (kLsbs * h2);
+    return Mask((x - kLsbs) & ~x & kMsbs);
+  }
+
+  Mask MatchEmpty() const {
+    // kEmpty is the only control byte with the high bit set and bit 1 clear.
+    return Mask((ctrl_ & ~(ctrl_ << 6)) & kMsbs);
+  }
+
+  Mask MatchEmptyOrDeleted() const {
+    return Mask(ctrl_ & kMsbs);
+  }
+
+ private:
+  static constexpr uint64_t kLsbs = UINT64_C(0x0101010101010101);
+  static constexpr uint64_t kMsbs = UINT64_C(0x8080808080808080);
+
+  uint64_t ctrl_;
+};
+
+#endif
+
+}  // namespace swiss_hash_set_internal
+
+// Open addressing hash set with a separate byte of control metadata per slot, probing a whole
+// group of control bytes at once (SSE2 on x86, SWAR elsewhere). Unlike HashSet<> it does not
+// need an empty element value, and since a probe looks at a full group of slots per step and
+// only compares elements whose 7-bit hash tag matches, it keeps short probe sequences at much
+// higher load factors. It is a drop-in alternative for HashSet<> (minus serialization to
+// memory), selected per instantiation.
+template <class T,
+          class HashFn = DefaultHashFn<T>,
+          class Pred = DefaultPred<T>,
+          class Alloc = std::allocator<T>>
+class SwissHashSet {
+  using Group = swiss_hash_set_internal::Group;
+  using AllocTraits = std::allocator_traits<Alloc>;
+  using CtrlAlloc = typename AllocTraits::template rebind_alloc<uint8_t>;
+
+ public:
+  using value_type = T;
+  using allocator_type = Alloc;
+  using reference = T&;
+  using const_reference = const T&;
+  using pointer = T*;
+  using const_pointer = const T*;
+  using iterator = HashSetIterator<T, SwissHashSet>;
+  using const_iterator = HashSetIterator<const T, const SwissHashSet>;
+  using size_type = size_t;
+  using difference_type = ptrdiff_t;
+
+  // Maximum load factor is 7/8. Group probing keeps the probe sequences short at this load.
+  static constexpr size_t kMaxLoadNumerator = 7u;
+  static constexpr size_t kMaxLoadDenominator = 8u;
+  static constexpr size_t kMinBuckets = 2u * Group::kWidth;
+
+  SwissHashSet() noexcept : SwissHashSet(allocator_type()) {}
+
+  explicit SwissHashSet(const allocator_type& alloc) noexcept
+      : allocfn_(alloc),
+        ctrl_allocfn_(alloc),
+        hashfn_(),
+        pred_(),
+        num_elements_(0u),
+        num_buckets_(0u),
+        growth_left_(0u),
+        ctrl_(nullptr),
+        data_(nullptr) {}
+
+  SwissHashSet(const SwissHashSet& other) noexcept
+      : allocfn_(other.allocfn_),
+        ctrl_allocfn_(other.ctrl_allocfn_),
+        hashfn_(other.hashfn_),
+        pred_(other.pred_),
+        num_elements_(0u),
+        num_buckets_(0u),
+        growth_left_(0u),
+        ctrl_(nullptr),
+        data_(nullptr) {
+    if (other.num_buckets_ != 0u) {
+      AllocateStorage(other.num_buckets_);
+      memcpy(ctrl_, other.ctrl_, num_buckets_);
+      for (size_t i = 0; i < num_buckets_; ++i) {
+        if (IsFull(i)) {
+          AllocTraits::construct(allocfn_, &data_[i], other.data_[i]);
+        }
+      }
+      num_elements_ = other.num_elements_;
+      growth_left_ = other.growth_left_;
+    }
+  }
+
+  SwissHashSet(SwissHashSet&& other) noexcept
+      : allocfn_(std::move(other.allocfn_)),
+        ctrl_allocfn_(std::move(other.ctrl_allocfn_)),
+        hashfn_(std::move(other.hashfn_)),
+        pred_(std::move(other.pred_)),
+        num_elements_(other.num_elements_),
+        num_buckets_(other.num_buckets_),
+        growth_left_(other.growth_left_),
+        ctrl_(other.ctrl_),
+        data_(other.data_) {
+    other.num_elements_ = 0u;
+    other.num_buckets_ = 0u;
+    other.growth_left_ = 0u;
+    other.ctrl_ = nullptr;
+    other.data_ = nullptr;
+  }
+
+  ~SwissHashSet() {
+    DeallocateStorage();
+  }
+
+  SwissHashSet& operator=(SwissHashSet&& other) noexcept {
+    SwissHashSet(std::move(other)).swap(*this);
+    return *this;
+  }
+
+  SwissHashSet& operator=(const SwissHashSet& other) noexcept {
+    SwissHashSet(other).swap(*this);  // NOLINT(runtime/explicit) - a case of lint gone mad.
+    return *this;
+  }
+
+  void clear() {
+    DeallocateStorage();
+    num_elements_ = 0u;
+    growth_left_ = 0u;
+  }
+
+  // Lower case for c++11 for each.
+  iterator begin() {
+    return iterator(this, FirstFullSlot());
+  }
+
+  const_iterator begin() const {
+    return const_iterator(this, FirstFullSlot());
+  }
+
+  iterator end() {
+    return iterator(this, NumBuckets());
+  }
+
+  const_iterator end() const {
+    return const_iterator(this, NumBuckets());
+  }
+
+  size_t size() const {
+    return num_elements_;
+  }
+
+  bool empty() const {
+    return size() == 0u;
+  }
+
+  // Erasing leaves a tombstone unless the slot's group still has an empty slot, in which case
+  // no probe sequence can have continued past it. Unlike HashSet<>, elements never move, so
+  // iteration visits each remaining element exactly once.
+  iterator erase(iterator it) {
+    size_t index = it.index_;
+    DCHECK(IsFull(index));
+    AllocTraits::destroy(allocfn_, &data_[index]);
+    size_t group_start = index & ~(Group::kWidth - 1u);
+    if (Group(ctrl_ + group_start).MatchEmpty().HasMatch()) {
+      ctrl_[index] = swiss_hash_set_internal::kEmpty;
+      ++growth_left_;
+    } else {
+      ctrl_[index] = swiss_hash_set_internal::kDeleted;
+    }
+    --num_elements_;
+    return iterator(this, NextNonEmptySlot(index));
+  }
+
+  // Find an element, returns end() if not found.
+  // Allows custom key (K) types, see HashSet<>::find().
+  template <typename K>
+  iterator find(const K& key) {
+    return FindWithHash(key, hashfn_(key));
+  }
+
+  template <typename K>
+  const_iterator find(const K& key) const {
+    return FindWithHash(key, hashfn_(key));
+  }
+
+  template <typename K>
+  iterator FindWithHash(const K& key, size_t hash) {
+    return iterator(this, FindIndex(key, hash));
+  }
+
+  template <typename K>
+  const_iterator FindWithHash(const K& key, size_t hash) const {
+    return const_iterator(this, FindIndex(key, hash));
+  }
+
+  // Insert an element, allows duplicates.
+  iterator insert(const T& element) {
+    return InsertWithHash(element, hashfn_(element));
+  }
+
+  iterator insert(T&& element) {
+    return InsertWithHash(std::move(element), hashfn_(element));
+  }
+
+  template <typename U, typename = typename std::enable_if<std::is_convertible<U, T>::value>::type>
+  iterator InsertWithHash(U&& element, size_t hash) {
+    DCHECK_EQ(hash, hashfn_(element));
+    if (UNLIKELY(growth_left_ == 0u)) {
+      Expand();
+    }
+    size_t index = FirstAvailableSlot(hash);
+    if (ctrl_[index] == swiss_hash_set_internal::kEmpty) {
+      --growth_left_;
+    }
+    ctrl_[index] = H2(hash);
+    AllocTraits::construct(allocfn_, &data_[index], std::forward<U>(element));
+    ++num_elements_;
+    return iterator(this, index);
+  }
+
+  void swap(SwissHashSet& other) {
+    // Use argument-dependent lookup with fall-back to std::swap() for function objects.
+    using std::swap;
+    swap(allocfn_, other.allocfn_);
+    swap(ctrl_allocfn_, other.ctrl_allocfn_);
+    swap(hashfn_, other.hashfn_);
+    swap(pred_, other.pred_);
+    std::swap(num_elements_, other.num_elements_);
+    std::swap(num_buckets_, other.num_buckets_);
+    std::swap(growth_left_, other.growth_left_);
+    std::swap(ctrl_, other.ctrl_);
+    std::swap(data_, other.data_);
+  }
+
+  allocator_type get_allocator() const {
+    return allocfn_;
+  }
+
+  // Reserve enough room to insert until size() == num_elements without requiring to grow the
+  // hash set. No-op if the hash set is already large enough to do this.
+  void reserve(size_t num_elements) {
+    if (num_elements > num_elements_ + growth_left_) {
+      Resize(BucketsForElements(num_elements));
+    }
+  }
+
+  // Total number of groups probed past the first one while looking up the inserted elements.
+  // Used for measuring how good hash functions are.
+  size_t TotalProbeDistance() const {
+    size_t total = 0u;
+    for (size_t i = 0; i < NumBuckets(); ++i) {
+      if (IsFull(i)) {
+        size_t group = GroupForHash(hashfn_(data_[i]));
+        for (size_t step = 0u; group != i / Group::kWidth; ++step) {
+          group = NextGroup(group, step);
+          ++total;
+        }
+      }
+    }
+    return total;
+  }
+
+  // Calculate the current load factor and return it.
+  double CalculateLoadFactor() const {
+    return static_cast<double>(size()) / static_cast<double>(NumBuckets());
+  }
+
+  size_t NumBuckets() const {
+    return num_buckets_;
+  }
+
+ private:
+  static uint8_t H2(size_t hash) {
+    return static_cast<uint8_t>(hash & 0x7fu);
+  }
+
+  // Use the bits above H2 to select the first group, so that the bits compared within a group
+  // are independent of the group index.
+  size_t GroupForHash(size_t hash) const {
+    return (hash >> 7) & (NumGroups() - 1u);
+  }
+
+  // Triangular probing over groups visits every group once since NumGroups() is a power of two.
+  size_t NextGroup(size_t group, size_t step) const {
+    return (group + step + 1u) & (NumGroups() - 1u);
+  }
+
+  size_t NumGroups() const {
+    return num_buckets_ / Group::kWidth;
+  }
+
+  static size_t BucketsForElements(size_t num_elements) {
+    size_t min_buckets = num_elements * kMaxLoadDenominator / kMaxLoadNumerator + 1u;
+    return std::max(kMinBuckets, RoundUpToPowerOfTwo(min_buckets));
+  }
+
+  bool IsFull(size_t index) const {
+    return swiss_hash_set_internal::IsFull(ctrl_[index]);
+  }
+
+  // Used by HashSetIterator.
+  bool IsFreeSlot(size_t index) const {
+    return !IsFull(index);
+  }
+
+  T& ElementForIndex(size_t index) {
+    DCHECK_LT(index, NumBuckets());
+    DCHECK(IsFull(index));
+    return data_[index];
+  }
+
+  const T& ElementForIndex(size_t index) const {
+    DCHECK_LT(index, NumBuckets());
+    DCHECK(IsFull(index));
+    return data_[index];
+  }
+
+  size_t FirstFullSlot() const {
+    size_t index = 0u;
+    while (index < NumBuckets() && !IsFull(index)) {
+      ++index;
+    }
+    return index;
+  }
+
+  size_t NextNonEmptySlot(size_t index) const {
+    DCHECK_LT(index, NumBuckets());
+    do {
+      ++index;
+    } while (index < NumBuckets() && !IsFull(index));
+    return index;
+  }
+
+  // Find the hash table slot for an element, or return NumBuckets() if not found.
+  template <typename K>
+  size_t FindIndex(const K& element, size_t hash) const {
+    if (UNLIKELY(NumBuckets() == 0u)) {
+      return 0u;
+    }
+    DCHECK_EQ(hashfn_(element), hash);
+    const uint8_t h2 = H2(hash);
+    size_t group = GroupForHash(hash);
+    for (size_t step = 0u; ; ++step) {
+      DCHECK_LT(step, NumGroups());  // Don't loop forever.
+      const size_t group_start = group * Group::kWidth;
+      Group g(ctrl_ + group_start);
+      for (auto match = g.Match(h2); match.HasMatch(); match.ClearLowestMatch()) {
+        size_t index = group_start + match.LowestMatch();
+        if (LIKELY(IsFull(index)) && pred_(data_[index], element)) {
+          return index;
+        }
+      }
+      if (LIKELY(g.MatchEmpty().HasMatch())) {
+        return NumBuckets();
+      }
+      group = NextGroup(group, step);
+    }
+  }
+
+  // Find the first empty or deleted slot on the probe sequence of the hash.
+  size_t FirstAvailableSlot(size_t hash) const {
+    size_t group = GroupForHash(hash);
+    for (size_t step = 0u; ; ++step) {
+      DCHECK_LT(step, NumGroups());  // Don't loop forever.
+      auto match = Group(ctrl_ + group * Group::kWidth).MatchEmptyOrDeleted();
+      if (match.HasMatch()) {
+        return group * Group::kWidth + match.LowestMatch();
+      }
+      group = NextGroup(group, step);
+    }
+  }
+
+  void AllocateStorage(size_t num_buckets) {
+    DCHECK(IsPowerOfTwo(num_buckets));
+    DCHECK_GE(num_buckets, kMinBuckets);
+    num_buckets_ = num_buckets;
+    ctrl_ = ctrl_allocfn_.allocate(num_buckets);
+    memset(ctrl_, swiss_hash_set_internal::kEmpty, num_buckets);
+    data_ = AllocTraits::allocate(allocfn_, num_buckets);
+    growth_left_ = num_buckets * kMaxLoadNumerator / kMaxLoadDenominator;
+  }
+
+  void DeallocateStorage() {
+    if (ctrl_ != nullptr) {
+      for (size_t i = 0; i < NumBuckets(); ++i) {
+        if (IsFull(i)) {
+          AllocTraits::destroy(allocfn_, &data_[i]);
+        }
+      }
+      ctrl_allocfn_.deallocate(ctrl_, num_buckets_);
+      AllocTraits::deallocate(allocfn_, data_, num_buckets_);
+    }
+    ctrl_ = nullptr;
+    data_ = nullptr;
+    num_buckets_ = 0u;
+  }
+
+  // Grow the set, or just rehash it in place of the same size if it is mostly tombstones.
+  void Expand() {
+    Resize(BucketsForElements(2u * std::max<size_t>(num_elements_, 1u)));
+  }
+
+  void Resize(size_t new_size) {
+    DCHECK_GE(new_size * kMaxLoadNumerator / kMaxLoadDenominator, size());
+    uint8_t* const old_ctrl = ctrl_;
+    T* const old_data = data_;
+    const size_t old_num_buckets = num_buckets_;
+    AllocateStorage(new_size);
+    for (size_t i = 0; i < old_num_buckets; ++i) {
+      if (swiss_hash_set_internal::IsFull(old_ctrl[i])) {
+        T& element = old_data[i];
+        size_t hash = hashfn_(element);
+        size_t index = FirstAvailableSlot(hash);
+        ctrl_[index] = H2(hash);
+        AllocTraits::construct(allocfn_, &data_[index], std::move(element));
+        AllocTraits::destroy(allocfn_, &element);
+      }
+    }
+    growth_left_ -= num_elements_;
+    if (old_ctrl != nullptr) {
+      ctrl_allocfn_.deallocate(old_ctrl, old_num_buckets);
+      AllocTraits::deallocate(allocfn_, old_data, old_num_buckets);
+    }
+  }
+
+  Alloc allocfn_;  // Allocator function for elements.
+  CtrlAlloc ctrl_allocfn_;  // Allocator function for control bytes.
+  HashFn hashfn_;  // Hashing function.
+  Pred pred_;  // Equals function.
+  size_t num_elements_;  // Number of inserted elements.
+  size_t num_buckets_;  // Number of slots, a power of two and a multiple of the group width.
+  size_t growth_left_;  // Number of empty slots that may be filled until we need to rehash.
+  uint8_t* ctrl_;  // Control bytes, one per slot.
+  T* data_;  // Slot storage, only constructed for full slots.
+
+  template <class Elem, class HashSetType>
+  friend class HashSetIterator;
+};
+
+template <class T, class HashFn, class Pred, class Alloc>
+void swap(SwissHashSet<T, HashFn, Pred, Alloc>& lhs, SwissHashSet<T, HashFn, Pred, Alloc>& rhs) {
+  lhs.swap(rhs);
+}
+
+}  // namespace art
+
+#endif  // ART_LIBARTBASE_BASE_SWISS_HASH_SET_H_
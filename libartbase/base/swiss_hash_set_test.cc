@@ -0,0 +1,202 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "swiss_hash_set.h"
+
+#include <map>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace art {
+
+class SwissHashSetTest : public testing::Test {
+ public:
+  SwissHashSetTest() : seed_(97421), unique_number_(0) {
+  }
+  std::string RandomString(size_t len) {
+    std::ostringstream oss;
+    for (size_t i = 0; i < len; ++i) {
+      oss << static_cast<char>('A' + PRand() % 64);
+    }
+    oss << " " << unique_number_++;
+    return oss.str();
+  }
+  size_t PRand() {  // Pseudo random.
+    seed_ = seed_ * 1103515245 + 12345;
+    return seed_;
+  }
+
+ private:
+  size_t seed_;
+  size_t unique_number_;
+};
+
+TEST_F(SwissHashSetTest, TestSmoke) {
+  SwissHashSet<std::string> hash_set;
+  const std::string test_string = "hello world 1234";
+  ASSERT_TRUE(hash_set.empty());
+  ASSERT_EQ(hash_set.size(), 0U);
+  ASSERT_TRUE(hash_set.find(test_string) == hash_set.end());
+  hash_set.insert(test_string);
+  auto it = hash_set.find(test_string);
+  ASSERT_EQ(*it, test_string);
+  auto after_it = hash_set.erase(it);
+  ASSERT_TRUE(after_it == hash_set.end());
+  ASSERT_TRUE(hash_set.empty());
+  ASSERT_EQ(hash_set.size(), 0U);
+  it = hash_set.find(test_string);
+  ASSERT_TRUE(it == hash_set.end());
+}
+
+TEST_F(SwissHashSetTest, TestInsertAndErase) {
+  SwissHashSet<std::string> hash_set;
+  static constexpr size_t count = 1000;
+  std::vector<std::string> strings;
+  for (size_t i = 0; i < count; ++i) {
+    // Insert a bunch of elements and make sure we can find them.
+    strings.push_back(RandomString(10));
+    hash_set.insert(strings[i]);
+    auto it = hash_set.find(strings[i]);
+    ASSERT_TRUE(it != hash_set.end());
+    ASSERT_EQ(*it, strings[i]);
+  }
+  ASSERT_EQ(strings.size(), hash_set.size());
+  // Try to erase the odd strings.
+  for (size_t i = 1; i < count; i += 2) {
+    auto it = hash_set.find(strings[i]);
+    ASSERT_TRUE(it != hash_set.end());
+    ASSERT_EQ(*it, strings[i]);
+    hash_set.erase(it);
+  }
+  // Test removed.
+  for (size_t i = 1; i < count; i += 2) {
+    auto it = hash_set.find(strings[i]);
+    ASSERT_TRUE(it == hash_set.end());
+  }
+  for (size_t i = 0; i < count; i += 2) {
+    auto it = hash_set.find(strings[i]);
+    ASSERT_TRUE(it != hash_set.end());
+    ASSERT_EQ(*it, strings[i]);
+  }
+  // Reuse the erased slots.
+  for (size_t i = 1; i < count; i += 2) {
+    hash_set.insert(strings[i]);
+  }
+  ASSERT_EQ(strings.size(), hash_set.size());
+  for (size_t i = 0; i < count; ++i) {
+    ASSERT_TRUE(hash_set.find(strings[i]) != hash_set.end());
+  }
+}
+
+TEST_F(SwissHashSetTest, TestIterator) {
+  SwissHashSet<std::string> hash_set;
+  ASSERT_TRUE(hash_set.begin() == hash_set.end());
+  static constexpr size_t count = 1000;
+  std::vector<std::string> strings;
+  for (size_t i = 0; i < count; ++i) {
+    strings.push_back(RandomString(10));
+    hash_set.insert(strings[i]);
+  }
+  // Make sure we visit each string exactly once.
+  std::map<std::string, size_t> found_count;
+  for (const std::string& s : hash_set) {
+    ++found_count[s];
+  }
+  for (size_t i = 0; i < count; ++i) {
+    ASSERT_EQ(found_count[strings[i]], 1U);
+  }
+  found_count.clear();
+  // Remove all the elements with iterator erase.
+  for (auto it = hash_set.begin(); it != hash_set.end();) {
+    ++found_count[*it];
+    it = hash_set.erase(it);
+  }
+  ASSERT_TRUE(hash_set.empty());
+  for (size_t i = 0; i < count; ++i) {
+    ASSERT_EQ(found_count[strings[i]], 1U);
+  }
+}
+
+TEST_F(SwissHashSetTest, TestCopyAndSwap) {
+  SwissHashSet<std::string> hash_seta, hash_setb;
+  std::vector<std::string> strings;
+  static constexpr size_t count = 1000;
+  for (size_t i = 0; i < count; ++i) {
+    strings.push_back(RandomString(10));
+    hash_seta.insert(strings[i]);
+  }
+  std::swap(hash_seta, hash_setb);
+  ASSERT_TRUE(hash_seta.empty());
+  ASSERT_EQ(count, hash_setb.size());
+  SwissHashSet<std::string> hash_setc(hash_setb);
+  hash_setb.clear();
+  for (size_t i = 0; i < count; ++i) {
+    ASSERT_TRUE(hash_setb.find(strings[i]) == hash_setb.end());
+    ASSERT_TRUE(hash_setc.find(strings[i]) != hash_setc.end());
+  }
+}
+
+TEST_F(SwissHashSetTest, TestReserveAndLoadFactor) {
+  SwissHashSet<std::string> hash_set;
+  static constexpr size_t count = 10000;
+  hash_set.reserve(count);
+  const size_t num_buckets = hash_set.NumBuckets();
+  for (size_t i = 0; i < count; ++i) {
+    hash_set.insert(RandomString(10));
+  }
+  // Reserving must avoid rehashing, and the table should not be more than 7/8 full.
+  EXPECT_EQ(num_buckets, hash_set.NumBuckets());
+  EXPECT_LE(hash_set.CalculateLoadFactor(), 7.0 / 8.0);
+  // With a reasonable hash function most elements are found in their first group.
+  EXPECT_LT(hash_set.TotalProbeDistance(), count);
+}
+
+TEST_F(SwissHashSetTest, TestDuplicates) {
+  SwissHashSet<int> hash_set;
+  for (int i = 0; i < 100; ++i) {
+    hash_set.insert(42);
+  }
+  ASSERT_EQ(100U, hash_set.size());
+  size_t erased = 0u;
+  for (auto it = hash_set.find(42); it != hash_set.end(); it = hash_set.find(42)) {
+    hash_set.erase(it);
+    ++erased;
+  }
+  ASSERT_EQ(100U, erased);
+  ASSERT_TRUE(hash_set.empty());
+}
+
+struct IsEqualStringView {
+  bool operator()(const std::string& lhs, std::string_view rhs) const {
+    return lhs == rhs;
+  }
+  bool operator()(const std::string& lhs, const std::string& rhs) const {
+    return lhs == rhs;
+  }
+};
+
+TEST_F(SwissHashSetTest, TestLookupByAlternateKeyType) {
+  SwissHashSet<std::string, DataHash, IsEqualStringView> hash_set;
+  hash_set.insert("ASDF");
+  ASSERT_TRUE(hash_set.find(std::string_view("ASDF")) != hash_set.end());
+  ASSERT_TRUE(hash_set.find(std::string_view("QWER")) == hash_set.end());
+}
+
+}  // namespace art
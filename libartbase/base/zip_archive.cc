@@ -16,8 +16,10 @@
 
 #include "zip_archive.h"
 
+#include <errno.h>
 #include <fcntl.h>
 #include <stdio.h>
+#include <string.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
@@ -26,6 +28,7 @@
 #include "android-base/stringprintf.h"
 #include "ziparchive/zip_archive.h"
 
+#include "base/file_utils.h"
 #include "base/mman.h"
 #include "bit_utils.h"
 #include "unix_file/fd_file.h"
@@ -253,6 +256,21 @@ ZipArchive* ZipArchive::OpenFromFd(int fd, const char* filename, std::string* er
   return new ZipArchive(handle);
 }
 
+ZipArchive* ZipArchive::Reopen(std::string* error_msg) const {
+  const int fd = GetFileDescriptor(handle_);
+  if (fd < 0) {
+    *error_msg = "Zip archive is not file backed";
+    return nullptr;
+  }
+  const int dup_fd = DupCloexec(fd);
+  if (dup_fd < 0) {
+    *error_msg = StringPrintf("Failed to duplicate zip archive fd: %s", strerror(errno));
+    return nullptr;
+  }
+  // The new archive owns the duplicate descriptor and closes it.
+  return OpenFromFd(dup_fd, "reopened zip archive", error_msg);
+}
+
 ZipEntry* ZipArchive::Find(const char* name, std::string* error_msg) const {
   DCHECK(name != nullptr);
 
@@ -90,6 +90,11 @@ class ZipArchive {
 
   ZipEntry* Find(const char* name, std::string* error_msg) const;
 
+  // Open the same archive again through a duplicate of its file descriptor. ZipArchive is not
+  // thread-safe, so threads extracting entries concurrently each need their own archive.
+  // Returns null on error, including when the archive is not file backed.
+  ZipArchive* Reopen(std::string* error_msg) const;
+
   ~ZipArchive();
 
  private:
@@ -18,6 +18,10 @@
 
 #include <sys/stat.h>
 
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
 #include "android-base/stringprintf.h"
 
 #include "base/file_magic.h"
@@ -477,6 +481,69 @@ std::unique_ptr<const DexFile> ArtDexFileLoader::OpenOneDexFileFromZip(
 // seems an excessive number.
 static constexpr size_t kWarnOnManyDexFilesThreshold = 100;
 
+// Maximum number of threads used to open the dex files of a multidex zip.
+static constexpr size_t kMaxOpenThreads = 4;
+
+// Extracting and verifying the entries dominates the time to open a multidex zip, and each dex
+// file is handled independently of the others. Errors are ignored here, the entries which failed
+// are opened again by the caller, which reports them.
+std::vector<std::unique_ptr<const DexFile>> ArtDexFileLoader::OpenDexFilesInParallel(
+    const ZipArchive& zip_archive,
+    const std::string& location,
+    bool verify,
+    bool verify_checksum) const {
+  std::vector<std::string> entry_names;
+  size_t num_compressed = 0u;
+  std::string error_msg;
+  for (size_t i = 0; ; ++i) {
+    std::string name = GetMultiDexClassesDexName(i);
+    std::unique_ptr<ZipEntry> zip_entry(zip_archive.Find(name.c_str(), &error_msg));
+    if (zip_entry == nullptr) {
+      break;
+    }
+    if (!zip_entry->IsUncompressed()) {
+      ++num_compressed;
+    }
+    entry_names.push_back(std::move(name));
+  }
+  std::vector<std::unique_ptr<const DexFile>> dex_files(entry_names.size());
+  // Uncompressed entries which are not verified are only mapped, which is not worth a thread.
+  if (entry_names.size() < 2u || (!verify && num_compressed < 2u)) {
+    return dex_files;
+  }
+
+  ScopedTrace trace("Parallel dex open from " + location);
+  std::atomic<size_t> next(0u);
+  auto open = [&]() {
+    std::string thread_error_msg;
+    std::unique_ptr<ZipArchive> archive(zip_archive.Reopen(&thread_error_msg));
+    if (archive == nullptr) {
+      return;
+    }
+    for (size_t i = next.fetch_add(1u); i < entry_names.size(); i = next.fetch_add(1u)) {
+      DexFileLoaderErrorCode error_code;
+      dex_files[i] = OpenOneDexFileFromZip(*archive,
+                                           entry_names[i].c_str(),
+                                           (i == 0u) ? location
+                                                     : GetMultiDexLocation(i, location.c_str()),
+                                           verify,
+                                           verify_checksum,
+                                           &thread_error_msg,
+                                           &error_code);
+    }
+  };
+  const size_t num_threads = std::min(entry_names.size(), kMaxOpenThreads);
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < num_threads; ++i) {
+    threads.emplace_back(open);
+  }
+  open();  // Use the calling thread as well.
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  return dex_files;
+}
+
 bool ArtDexFileLoader::OpenAllDexFilesFromZip(
     const ZipArchive& zip_archive,
     const std::string& location,
@@ -487,13 +554,21 @@ bool ArtDexFileLoader::OpenAllDexFilesFromZip(
   ScopedTrace trace("Dex file open from Zip " + std::string(location));
   DCHECK(dex_files != nullptr) << "DexFile::OpenFromZip: out-param is nullptr";
   DexFileLoaderErrorCode error_code;
-  std::unique_ptr<const DexFile> dex_file(OpenOneDexFileFromZip(zip_archive,
-                                                                kClassesDex,
-                                                                location,
-                                                                verify,
-                                                                verify_checksum,
-                                                                error_msg,
-                                                                &error_code));
+  std::vector<std::unique_ptr<const DexFile>> opened_dex_files =
+      OpenDexFilesInParallel(zip_archive, location, verify, verify_checksum);
+  auto open_dex_file = [&](size_t i, const char* name, const std::string& dex_location) {
+    if (i < opened_dex_files.size() && opened_dex_files[i] != nullptr) {
+      return std::move(opened_dex_files[i]);
+    }
+    return OpenOneDexFileFromZip(zip_archive,
+                                 name,
+                                 dex_location,
+                                 verify,
+                                 verify_checksum,
+                                 error_msg,
+                                 &error_code);
+  };
+  std::unique_ptr<const DexFile> dex_file(open_dex_file(0u, kClassesDex, location));
   if (dex_file.get() == nullptr) {
     return false;
   } else {
@@ -508,13 +583,8 @@ bool ArtDexFileLoader::OpenAllDexFilesFromZip(
     for (size_t i = 1; ; ++i) {
       std::string name = GetMultiDexClassesDexName(i);
       std::string fake_location = GetMultiDexLocation(i, location.c_str());
-      std::unique_ptr<const DexFile> next_dex_file(OpenOneDexFileFromZip(zip_archive,
-                                                                         name.c_str(),
-                                                                         fake_location,
-                                                                         verify,
-                                                                         verify_checksum,
-                                                                         error_msg,
-                                                                         &error_code));
+      std::unique_ptr<const DexFile> next_dex_file(
+          open_dex_file(i, name.c_str(), fake_location));
       if (next_dex_file.get() == nullptr) {
         if (error_code != DexFileLoaderErrorCode::kEntryNotFound) {
           LOG(WARNING) << "Zip open failed: " << *error_msg;
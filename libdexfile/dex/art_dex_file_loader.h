@@ -137,6 +137,15 @@ class ArtDexFileLoader : public DexFileLoader {
                                                        std::string* error_msg,
                                                        DexFileLoaderErrorCode* error_code) const;
 
+  // Opens the classesN.dex entries of a multidex zip on several threads, which extract and verify
+  // them. Returns the dex files indexed by multidex index, null for the entries that could not be
+  // opened or were not opened in parallel.
+  std::vector<std::unique_ptr<const DexFile>> OpenDexFilesInParallel(
+      const ZipArchive& zip_archive,
+      const std::string& location,
+      bool verify,
+      bool verify_checksum) const;
+
   static std::unique_ptr<DexFile> OpenCommon(const uint8_t* base,
                                              size_t size,
                                              const uint8_t* data_base,
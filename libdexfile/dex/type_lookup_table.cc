@@ -27,6 +27,19 @@
 namespace art {
 
 static inline bool ModifiedUtf8StringEquals(const char* lhs, const char* rhs) {
+  // Descriptors are almost always ASCII. Compare the bytes up to the first difference and only
+  // decode code points if that difference is not between two ASCII characters, since the same
+  // string can have more than one Modified UTF-8 encoding.
+  size_t i = 0u;
+  while (lhs[i] == rhs[i]) {
+    if (lhs[i] == '\0') {
+      return true;
+    }
+    ++i;
+  }
+  if ((static_cast<uint8_t>(lhs[i]) | static_cast<uint8_t>(rhs[i])) < 0x80u) {
+    return false;
+  }
   return CompareModifiedUtf8ToModifiedUtf8AsUtf16CodePointValues(lhs, rhs) == 0;
 }
 
@@ -16,6 +16,8 @@
 
 #include "utf.h"
 
+#include <string.h>
+
 #include <android-base/logging.h>
 #include <android-base/stringprintf.h>
 #include <android-base/strings.h>
@@ -27,6 +29,33 @@ namespace art {
 
 using android::base::StringAppendF;
 
+// Runs of ASCII characters are processed a 64-bit word at a time. Compilers turn the
+// loops over whole words into NEON/SSE code, and any non-ASCII byte makes the caller
+// fall back to the scalar decoding below.
+static constexpr size_t kAsciiWordSize = sizeof(uint64_t);
+
+ALWAYS_INLINE static bool IsAsciiWord(const char* utf8) {
+  uint64_t word;
+  memcpy(&word, utf8, sizeof(word));
+  return (word & UINT64_C(0x8080808080808080)) == 0u;
+}
+
+ALWAYS_INLINE static void WidenAsciiWord(uint16_t* utf16_out, const char* utf8) {
+  for (size_t i = 0; i != kAsciiWordSize; ++i) {
+    utf16_out[i] = static_cast<uint8_t>(utf8[i]);
+  }
+}
+
+// Fold four characters into `hash`, the same as four steps of `hash * 31 + c`. The
+// steps do not depend on each other, which lets the CPU compute them in parallel.
+ALWAYS_INLINE static uint32_t HashFourChars(uint32_t hash, const char* chars) {
+  return hash * (31u * 31u * 31u * 31u) +
+         static_cast<uint8_t>(chars[0]) * (31u * 31u * 31u) +
+         static_cast<uint8_t>(chars[1]) * (31u * 31u) +
+         static_cast<uint8_t>(chars[2]) * 31u +
+         static_cast<uint8_t>(chars[3]);
+}
+
 // This is used only from debugger and test code.
 size_t CountModifiedUtf8Chars(const char* utf8) {
   return CountModifiedUtf8Chars(utf8, strlen(utf8));
@@ -52,6 +81,14 @@ size_t CountModifiedUtf8Chars(const char* utf8, size_t byte_count) {
   size_t len = 0;
   const char* end = utf8 + byte_count;
   for (; utf8 < end; ++utf8) {
+    // Skip runs of one-byte encodings a word at a time.
+    while (static_cast<size_t>(end - utf8) >= kAsciiWordSize && IsAsciiWord(utf8)) {
+      utf8 += kAsciiWordSize;
+      len += kAsciiWordSize;
+    }
+    if (utf8 == end) {
+      break;
+    }
     int ic = *utf8;
     len++;
     if (LIKELY((ic & 0x80) == 0)) {
@@ -110,6 +147,12 @@ void ConvertModifiedUtf8ToUtf16(uint16_t* utf16_data_out, size_t out_chars,
 
   // String contains non-ASCII characters.
   for (const char *p = in_start; p < in_end;) {
+    if (static_cast<size_t>(in_end - p) >= kAsciiWordSize && IsAsciiWord(p)) {
+      WidenAsciiWord(out_p, p);
+      out_p += kAsciiWordSize;
+      p += kAsciiWordSize;
+      continue;
+    }
     const uint32_t ch = GetUtf16FromUtf8(&p);
     const uint16_t leading = GetLeadingUtf16Char(ch);
     const uint16_t trailing = GetTrailingUtf16Char(ch);
@@ -192,10 +235,16 @@ int32_t ComputeUtf16HashFromModifiedUtf8(const char* utf8, size_t utf16_length)
 }
 
 uint32_t ComputeModifiedUtf8Hash(const char* chars) {
+  // The hash does not decode the characters, so it does not need an ASCII fast path.
+  // Finding the length first with the vectorized strlen() lets the loop hash four
+  // characters per step.
+  const char* end = chars + strlen(chars);
   uint32_t hash = 0;
-  while (*chars != '\0') {
+  for (; end - chars >= 4; chars += 4) {
+    hash = HashFourChars(hash, chars);
+  }
+  for (; chars != end; ++chars) {
     hash = hash * 31 + static_cast<uint8_t>(*chars);
-    ++chars;
   }
   return hash;
 }
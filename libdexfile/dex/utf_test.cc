@@ -17,6 +17,7 @@
 #include "utf.h"
 
 #include <map>
+#include <string>
 #include <vector>
 
 #include <android-base/stringprintf.h>
@@ -115,6 +116,37 @@ TEST_F(UtfTest, CountModifiedUtf8Chars) {
   EXPECT_EQ(2u, CountModifiedUtf8Chars(reinterpret_cast<const char *>(kSurrogateEncoding)));
 }
 
+TEST_F(UtfTest, DecodeAsciiRunsAroundMultiByteSequences) {
+  // Place multi-byte sequences at every offset within and across the word-sized
+  // ASCII runs handled by the fast paths.
+  const std::string ascii = "abcdefghijklmnopqrstuvwxyz0123456789";
+  const std::string encodings[] = { "\xc4\x81", "\xed\xbb\xb0", "\xf0\x90\xa0\x82" };
+  for (const std::string& encoding : encodings) {
+    for (size_t pos = 0; pos <= ascii.size(); ++pos) {
+      const std::string utf8 = ascii.substr(0, pos) + encoding + ascii.substr(pos);
+      std::vector<uint16_t> expected;
+      for (const char* p = utf8.c_str(); *p != '\0';) {
+        const uint32_t pair = GetUtf16FromUtf8(&p);
+        expected.push_back(GetLeadingUtf16Char(pair));
+        if (GetTrailingUtf16Char(pair) != 0) {
+          expected.push_back(GetTrailingUtf16Char(pair));
+        }
+      }
+      ASSERT_EQ(expected.size(), CountModifiedUtf8Chars(utf8.c_str(), utf8.size()));
+
+      std::vector<uint16_t> utf16(expected.size());
+      ConvertModifiedUtf8ToUtf16(utf16.data(), utf16.size(), utf8.c_str(), utf8.size());
+      EXPECT_EQ(expected, utf16);
+
+      uint32_t expected_hash = 0;
+      for (char c : utf8) {
+        expected_hash = expected_hash * 31 + static_cast<uint8_t>(c);
+      }
+      EXPECT_EQ(expected_hash, ComputeModifiedUtf8Hash(utf8.c_str()));
+    }
+  }
+}
+
 static void AssertConversion(const std::vector<uint16_t>& input,
                              const std::vector<uint8_t>& expected) {
   ASSERT_EQ(expected.size(), CountUtf8Bytes(&input[0], input.size()));
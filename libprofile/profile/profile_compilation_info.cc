@@ -17,6 +17,7 @@
 #include "profile_compilation_info.h"
 
 #include <sys/file.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
@@ -103,7 +104,8 @@ ProfileCompilationInfo::ProfileCompilationInfo(ArenaPool* custom_arena_pool)
       allocator_(custom_arena_pool),
       info_(allocator_.Adapter(kArenaAllocProfile)),
       profile_key_map_(std::less<const std::string>(), allocator_.Adapter(kArenaAllocProfile)),
-      aggregation_count_(0) {
+      aggregation_count_(0),
+      store_uncompressed_(false) {
   InitProfileVersionInternal(kProfileVersion);
 }
 
@@ -112,7 +114,8 @@ ProfileCompilationInfo::ProfileCompilationInfo()
       allocator_(&default_arena_pool_),
       info_(allocator_.Adapter(kArenaAllocProfile)),
       profile_key_map_(std::less<const std::string>(), allocator_.Adapter(kArenaAllocProfile)),
-      aggregation_count_(0) {
+      aggregation_count_(0),
+      store_uncompressed_(false) {
   InitProfileVersionInternal(kProfileVersion);
 }
 
@@ -323,6 +326,118 @@ bool ProfileCompilationInfo::Save(const std::string& filename, uint64_t* bytes_w
   return result;
 }
 
+std::string ProfileCompilationInfo::GetDeltaLogFilename(const std::string& profile_filename) {
+  return profile_filename + ".delta";
+}
+
+bool ProfileCompilationInfo::AppendToDeltaLog(const std::string& profile_filename,
+                                              uint64_t* bytes_written) {
+  ScopedTrace trace(__PRETTY_FUNCTION__);
+  std::string error;
+  std::string delta_log = GetDeltaLogFilename(profile_filename);
+#ifdef _WIN32
+  int flags = O_WRONLY | O_APPEND | O_CREAT;
+#else
+  int flags = O_WRONLY | O_APPEND | O_CREAT | O_NOFOLLOW | O_CLOEXEC;
+#endif
+  ScopedFlock log_file = LockedFile::Open(delta_log.c_str(), flags, /*block=*/false, &error);
+  if (log_file.get() == nullptr) {
+    LOG(WARNING) << "Couldn't lock the profile delta log " << delta_log << ": " << error;
+    return false;
+  }
+
+  int64_t size_before = log_file->GetLength();
+  bool result = Save(log_file->Fd());
+  if (result) {
+    int64_t size_after = log_file->GetLength();
+    if (size_before >= 0 && size_after >= size_before) {
+      VLOG(profiler) << "Successfully appended " << (size_after - size_before)
+                     << " bytes to profile delta log " << delta_log << " Size: " << size_after;
+      if (bytes_written != nullptr) {
+        *bytes_written = static_cast<uint64_t>(size_after - size_before);
+      }
+    }
+  } else {
+    VLOG(profiler) << "Failed to append profile info to " << delta_log;
+  }
+  return result;
+}
+
+bool ProfileCompilationInfo::MergeWithDeltaLog(const std::string& profile_filename,
+                                               const ProfileLoadFilterFn& filter_fn) {
+  ScopedTrace trace(__PRETTY_FUNCTION__);
+  std::string delta_log = GetDeltaLogFilename(profile_filename);
+  if (!OS::FileExists(delta_log.c_str())) {
+    return true;
+  }
+
+  std::string error;
+#ifdef _WIN32
+  int flags = O_RDONLY;
+#else
+  int flags = O_RDONLY | O_NOFOLLOW | O_CLOEXEC;
+#endif
+  ScopedFlock log_file = LockedFile::Open(delta_log.c_str(), flags, /*block=*/false, &error);
+  if (log_file.get() == nullptr) {
+    LOG(WARNING) << "Couldn't lock the profile delta log " << delta_log << ": " << error;
+    return false;
+  }
+
+  int fd = log_file->Fd();
+  int64_t log_size = log_file->GetLength();
+  if (log_size < 0) {
+    PLOG(WARNING) << "Could not get the size of the profile delta log " << delta_log;
+    return false;
+  }
+  std::unique_ptr<ProfileSource> source(ProfileSource::Create(fd));
+  // The records are complete profiles written back to back. Loading one leaves the
+  // file offset at the start of the next one.
+  while (true) {
+    off_t offset = TEMP_FAILURE_RETRY(lseek(fd, 0, SEEK_CUR));
+    if (offset == static_cast<off_t>(-1)) {
+      PLOG(WARNING) << "Could not read the profile delta log " << delta_log;
+      return false;
+    }
+    if (offset >= log_size) {
+      return true;
+    }
+    ProfileLoadStatus status = LoadRecord(*source,
+                                          &error,
+                                          /*merge_classes=*/ true,
+                                          filter_fn,
+                                          /*expect_end_of_data=*/ false);
+    if (status != kProfileLoadSuccess) {
+      LOG(WARNING) << "Could not load record at offset " << offset << " of profile delta log "
+                   << delta_log << ": " << error;
+      return false;
+    }
+  }
+}
+
+bool ProfileCompilationInfo::ClearDeltaLog(const std::string& profile_filename) {
+  std::string delta_log = GetDeltaLogFilename(profile_filename);
+  if (!OS::FileExists(delta_log.c_str())) {
+    return true;
+  }
+
+  std::string error;
+#ifdef _WIN32
+  int flags = O_WRONLY;
+#else
+  int flags = O_WRONLY | O_NOFOLLOW | O_CLOEXEC;
+#endif
+  ScopedFlock log_file = LockedFile::Open(delta_log.c_str(), flags, /*block=*/false, &error);
+  if (log_file.get() == nullptr) {
+    LOG(WARNING) << "Couldn't lock the profile delta log " << delta_log << ": " << error;
+    return false;
+  }
+  if (!log_file->ClearContent()) {
+    PLOG(WARNING) << "Could not clear profile delta log: " << delta_log;
+    return false;
+  }
+  return true;
+}
+
 // Returns true if all the bytes were successfully written to the file descriptor.
 static bool WriteBuffer(int fd, const uint8_t* buffer, size_t byte_count) {
   while (byte_count > 0) {
@@ -359,6 +474,8 @@ static constexpr size_t kLineHeaderSize =
  *    profile_line_data2...]],global_aggregation_counter]
  * profile_header:
  *   magic,version,number_of_dex_files,uncompressed_size_of_zipped_data,compressed_data_size
+ *   A compressed_data_size of 0 means that the data is stored uncompressed. A zlib stream is
+ *   never empty, so this does not collide with compressed data.
  * profile_line_header:
  *   dex_location,number_of_classes,methods_region_size,dex_location_checksum,num_method_ids
  * profile_line_data:
@@ -505,6 +622,20 @@ bool ProfileCompilationInfo::Save(int fd) {
     AddUintToBuffer(&buffer, aggregation_count_);
   }
 
+  if (store_uncompressed_) {
+    std::vector<uint8_t> size_buffer;
+    AddUintToBuffer(&size_buffer, static_cast<uint32_t>(0u));
+    if (!WriteBuffer(fd, size_buffer.data(), size_buffer.size())) {
+      return false;
+    }
+    if (!WriteBuffer(fd, buffer.data(), required_capacity)) {
+      return false;
+    }
+    VLOG(profiler) << "Time to save uncompressed profile: "
+                   << std::to_string(NanoTime() - start);
+    return true;
+  }
+
   uint32_t output_size = 0;
   std::unique_ptr<uint8_t[]> compressed_buffer = DeflateBuffer(buffer.data(),
                                                                required_capacity,
@@ -978,8 +1109,9 @@ ProfileCompilationInfo::ProfileLoadStatus ProfileCompilationInfo::SafeBuffer::Fi
       ProfileSource& source,
       const std::string& debug_stage,
       /*out*/ std::string* error) {
+  DCHECK(storage_ != nullptr);
   size_t byte_count = (ptr_end_ - ptr_current_) * sizeof(*ptr_current_);
-  uint8_t* buffer = ptr_current_;
+  uint8_t* buffer = storage_.get() + (ptr_current_ - storage_.get());
   return source.Read(buffer, byte_count, debug_stage, error);
 }
 
@@ -1329,10 +1461,8 @@ ProfileCompilationInfo::ProfileLoadStatus ProfileCompilationInfo::ProfileSource:
     if (mem_map_cur_ + byte_count > mem_map_.Size()) {
       return kProfileLoadBadData;
     }
-    for (size_t i = 0; i < byte_count; i++) {
-      buffer[i] = *(mem_map_.Begin() + mem_map_cur_);
-      mem_map_cur_++;
-    }
+    memcpy(buffer, mem_map_.Begin() + mem_map_cur_, byte_count);
+    mem_map_cur_ += byte_count;
   } else {
     while (byte_count > 0) {
       int bytes_read = TEMP_FAILURE_RETRY(read(fd_, buffer, byte_count));;
@@ -1350,6 +1480,47 @@ ProfileCompilationInfo::ProfileLoadStatus ProfileCompilationInfo::ProfileSource:
   return kProfileLoadSuccess;
 }
 
+const uint8_t* ProfileCompilationInfo::ProfileSource::ReadInPlace(size_t byte_count) {
+  if (IsMemMap()) {
+    if (!mem_map_.IsValid() || mem_map_cur_ + byte_count > mem_map_.Size()) {
+      return nullptr;
+    }
+    const uint8_t* data = mem_map_.Begin() + mem_map_cur_;
+    mem_map_cur_ += byte_count;
+    return data;
+  }
+
+  off_t offset = TEMP_FAILURE_RETRY(lseek(fd_, 0, SEEK_CUR));
+  if (offset == static_cast<off_t>(-1)) {
+    return nullptr;
+  }
+  struct stat stat_buffer;
+  if (fstat(fd_, &stat_buffer) != 0 ||
+      !S_ISREG(stat_buffer.st_mode) ||
+      static_cast<uint64_t>(offset) + byte_count > static_cast<uint64_t>(stat_buffer.st_size)) {
+    return nullptr;
+  }
+  // Map from the start of the file, the offset of a mapping must be page aligned.
+  std::string error;
+  fd_map_ = MemMap::MapFile(offset + byte_count,
+                            PROT_READ,
+                            MAP_PRIVATE,
+                            fd_,
+                            /*start=*/ 0,
+                            /*low_4gb=*/ false,
+                            "profile",
+                            &error);
+  if (!fd_map_.IsValid()) {
+    VLOG(profiler) << "Could not map profile: " << error;
+    return nullptr;
+  }
+  if (TEMP_FAILURE_RETRY(lseek(fd_, byte_count, SEEK_CUR)) == static_cast<off_t>(-1)) {
+    fd_map_.Reset();
+    return nullptr;
+  }
+  return fd_map_.Begin() + offset;
+}
+
 bool ProfileCompilationInfo::ProfileSource::HasConsumedAllData() const {
   return IsMemMap()
       ? (!mem_map_.IsValid() || mem_map_cur_ == mem_map_.Size())
@@ -1390,15 +1561,24 @@ ProfileCompilationInfo::ProfileLoadStatus ProfileCompilationInfo::LoadInternal(
     return kProfileLoadSuccess;
   }
 
+  return LoadRecord(*source, error, merge_classes, filter_fn, /*expect_end_of_data=*/ true);
+}
+
+ProfileCompilationInfo::ProfileLoadStatus ProfileCompilationInfo::LoadRecord(
+      ProfileSource& source,
+      std::string* error,
+      bool merge_classes,
+      const ProfileLoadFilterFn& filter_fn,
+      bool expect_end_of_data) {
   // Read profile header: magic + version + number_of_dex_files.
   uint8_t number_of_dex_files;
   uint32_t uncompressed_data_size;
   uint32_t compressed_data_size;
-  status = ReadProfileHeader(*source,
-                             &number_of_dex_files,
-                             &uncompressed_data_size,
-                             &compressed_data_size,
-                             error);
+  ProfileLoadStatus status = ReadProfileHeader(source,
+                                               &number_of_dex_files,
+                                               &uncompressed_data_size,
+                                               &compressed_data_size,
+                                               error);
 
   if (status != kProfileLoadSuccess) {
     return status;
@@ -1417,29 +1597,50 @@ ProfileCompilationInfo::ProfileLoadStatus ProfileCompilationInfo::LoadInternal(
                  << " bytes";
   }
 
-  std::unique_ptr<uint8_t[]> compressed_data(new uint8_t[compressed_data_size]);
-  status = source->Read(compressed_data.get(), compressed_data_size, "ReadContent", error);
-  if (status != kProfileLoadSuccess) {
-    *error += "Unable to read compressed profile data";
-    return status;
-  }
+  std::unique_ptr<SafeBuffer> uncompressed_buffer;
+  if (compressed_data_size == 0u) {
+    // The data is stored uncompressed. Parse it in place if possible.
+    const uint8_t* data = source.ReadInPlace(uncompressed_data_size);
+    if (data != nullptr) {
+      uncompressed_buffer.reset(new SafeBuffer(data, uncompressed_data_size));
+    } else {
+      uncompressed_buffer.reset(new SafeBuffer(uncompressed_data_size));
+      status = uncompressed_buffer->Fill(source, "ReadContent", error);
+      if (status != kProfileLoadSuccess) {
+        *error += "Unable to read uncompressed profile data";
+        return status;
+      }
+    }
+    if (expect_end_of_data && !source.HasConsumedAllData()) {
+      *error += "Unexpected data in the profile file.";
+      return kProfileLoadBadData;
+    }
+  } else {
+    std::unique_ptr<uint8_t[]> compressed_data(new uint8_t[compressed_data_size]);
+    status = source.Read(compressed_data.get(), compressed_data_size, "ReadContent", error);
+    if (status != kProfileLoadSuccess) {
+      *error += "Unable to read compressed profile data";
+      return status;
+    }
 
-  if (!source->HasConsumedAllData()) {
-    *error += "Unexpected data in the profile file.";
-    return kProfileLoadBadData;
-  }
+    if (expect_end_of_data && !source.HasConsumedAllData()) {
+      *error += "Unexpected data in the profile file.";
+      return kProfileLoadBadData;
+    }
 
-  SafeBuffer uncompressed_data(uncompressed_data_size);
+    uncompressed_buffer.reset(new SafeBuffer(uncompressed_data_size));
 
-  int ret = InflateBuffer(compressed_data.get(),
-                          compressed_data_size,
-                          uncompressed_data_size,
-                          uncompressed_data.Get());
+    int ret = InflateBuffer(compressed_data.get(),
+                            compressed_data_size,
+                            uncompressed_data_size,
+                            uncompressed_buffer->Get());
 
-  if (ret != Z_STREAM_END) {
-    *error += "Error reading uncompressed profile data";
-    return kProfileLoadBadData;
+    if (ret != Z_STREAM_END) {
+      *error += "Error reading uncompressed profile data";
+      return kProfileLoadBadData;
+    }
   }
+  SafeBuffer& uncompressed_data = *uncompressed_buffer;
 
   std::vector<ProfileLineHeader> profile_line_headers;
   // Read profile line headers.
@@ -1770,6 +1971,50 @@ bool ProfileCompilationInfo::ContainsClass(const DexFile& dex_file, dex::TypeInd
   return (dex_data != nullptr) && dex_data->ContainsClass(type_idx);
 }
 
+void ProfileCompilationInfo::RemoveDataPresentIn(const ProfileCompilationInfo& other) {
+  for (DexFileData* dex_data : info_) {
+    const DexFileData* other_dex_data = other.FindDexData(dex_data->profile_key,
+                                                          dex_data->checksum);
+    if (other_dex_data == nullptr ||
+        other_dex_data->num_method_ids != dex_data->num_method_ids) {
+      continue;
+    }
+    for (const dex::TypeIndex& type_index : other_dex_data->class_set) {
+      dex_data->class_set.erase(type_index);
+    }
+    DCHECK_EQ(dex_data->bitmap_storage.size(), other_dex_data->bitmap_storage.size());
+    for (size_t i = 0; i < dex_data->bitmap_storage.size(); ++i) {
+      dex_data->bitmap_storage[i] &= ~other_dex_data->bitmap_storage[i];
+    }
+    for (auto it = dex_data->method_map.begin(); it != dex_data->method_map.end(); ) {
+      auto other_it = other_dex_data->method_map.find(it->first);
+      bool covered = (other_it != other_dex_data->method_map.end());
+      for (const auto& dex_pc_entry : it->second) {
+        if (!covered) {
+          break;
+        }
+        auto other_pc_it = other_it->second.find(dex_pc_entry.first);
+        if (other_pc_it == other_it->second.end()) {
+          covered = false;
+        } else {
+          const DexPcData& dex_pc_data = dex_pc_entry.second;
+          const DexPcData& other_dex_pc_data = other_pc_it->second;
+          covered = other_dex_pc_data.is_megamorphic ||
+              other_dex_pc_data.is_missing_types ||
+              (!dex_pc_data.is_megamorphic &&
+               !dex_pc_data.is_missing_types &&
+               dex_pc_data.classes.size() <= other_dex_pc_data.classes.size());
+        }
+      }
+      if (covered) {
+        it = dex_data->method_map.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+}
+
 uint32_t ProfileCompilationInfo::GetNumberOfMethods() const {
   uint32_t total = 0;
   for (const DexFileData* dex_data : info_) {
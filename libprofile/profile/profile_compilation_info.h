@@ -354,6 +354,30 @@ class ProfileCompilationInfo {
   // Save the current profile into the given file. The file will be cleared before saving.
   bool Save(const std::string& filename, uint64_t* bytes_written);
 
+  // Return the name of the delta log that accompanies the given profile file. The log is a
+  // sequence of profiles appended by AppendToDeltaLog(); together with the profile file it
+  // describes the full profile.
+  static std::string GetDeltaLogFilename(const std::string& profile_filename);
+
+  // Append the current profile as a new record to the delta log of the given profile file,
+  // creating the log if needed.
+  bool AppendToDeltaLog(const std::string& profile_filename, uint64_t* bytes_written);
+
+  // Merge all the records of the delta log of the given profile file, keeping only the
+  // dex files accepted by `filter_fn`. Returns true if there is no delta log.
+  bool MergeWithDeltaLog(const std::string& profile_filename,
+                         const ProfileLoadFilterFn& filter_fn = ProfileFilterFnAcceptAll);
+
+  // Remove all the records from the delta log of the given profile file. This should be
+  // called once the profile file itself contains the data of the log.
+  static bool ClearDeltaLog(const std::string& profile_filename);
+
+  // Remove from the current profile the data that is already present in `other`: resolved
+  // classes, method flags and hot methods whose inline caches are covered by the ones in
+  // `other`. Inline caches are compared by size only, so a method is kept whenever one of
+  // its inline caches may have gained a type.
+  void RemoveDataPresentIn(const ProfileCompilationInfo& other);
+
   // Return the number of methods that were profiled.
   uint32_t GetNumberOfMethods() const;
 
@@ -457,6 +481,13 @@ class ProfileCompilationInfo {
   // Returns true if the profile is configured to store aggregation counters.
   bool StoresAggregationCounters() const;
 
+  // Make Save() store the profile data without compressing it. Uncompressed profiles
+  // are larger on disk but Load() parses them directly from a mapping of the file,
+  // without inflating them into a copy first.
+  void SetStoreUncompressed(bool store_uncompressed) {
+    store_uncompressed_ = store_uncompressed;
+  }
+
   // Returns the aggregation counter for the given method.
   // Returns -1 if the method is not in the profile.
   // CHECKs that the profile is configured to store aggregations counters.
@@ -703,6 +734,14 @@ class ProfileCompilationInfo {
                            const std::string& debug_stage,
                            std::string* error);
 
+    /**
+     * Return a pointer to the next `byte_count` bytes of this source without copying
+     * them and advance past them. Sources backed by a file descriptor map the file.
+     * Return null if the data cannot be accessed in place; the source position is
+     * unchanged in that case.
+     */
+    const uint8_t* ReadInPlace(size_t byte_count);
+
     /** Return true if the source has 0 data. */
     bool HasEmptyContent() const;
     /** Return true if all the information from this source has been read. */
@@ -717,6 +756,7 @@ class ProfileCompilationInfo {
     int32_t fd_;  // The fd is not owned by this class.
     MemMap mem_map_;
     size_t mem_map_cur_;  // Current position in the map to read from.
+    MemMap fd_map_;  // Mapping of the fd for data read in place.
   };
 
   // A helper structure to make sure we don't read past our buffers in the loops.
@@ -727,6 +767,10 @@ class ProfileCompilationInfo {
       ptr_end_ = ptr_current_ + size;
     }
 
+    // Create a buffer reading `size` bytes of `data`, which it does not own. Such a
+    // buffer cannot be filled.
+    SafeBuffer(const uint8_t* data, size_t size) : ptr_end_(data + size), ptr_current_(data) {}
+
     // Reads the content of the descriptor at the current position.
     ProfileLoadStatus Fill(ProfileSource& source,
                            const std::string& debug_stage,
@@ -754,8 +798,8 @@ class ProfileCompilationInfo {
 
    private:
     std::unique_ptr<uint8_t[]> storage_;
-    uint8_t* ptr_end_;
-    uint8_t* ptr_current_;
+    const uint8_t* ptr_end_;
+    const uint8_t* ptr_current_;
   };
 
   ProfileLoadStatus OpenSource(int32_t fd,
@@ -769,6 +813,14 @@ class ProfileCompilationInfo {
       bool merge_classes = true,
       const ProfileLoadFilterFn& filter_fn = ProfileFilterFnAcceptAll);
 
+  // Load one profile record from the current position of the source. If
+  // `expect_end_of_data` is true, the record must end the source.
+  ProfileLoadStatus LoadRecord(ProfileSource& source,
+                               std::string* error,
+                               bool merge_classes,
+                               const ProfileLoadFilterFn& filter_fn,
+                               bool expect_end_of_data);
+
   // Read the profile header from the given fd and store the number of profile
   // lines into number_of_dex_files.
   ProfileLoadStatus ReadProfileHeader(ProfileSource& source,
@@ -872,6 +924,9 @@ class ProfileCompilationInfo {
 
   // Stored only when the profile is configured to keep track of aggregation counters.
   uint16_t aggregation_count_;
+
+  // Whether Save() stores the profile data uncompressed.
+  bool store_uncompressed_;
 };
 
 }  // namespace art
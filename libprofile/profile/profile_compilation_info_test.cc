@@ -16,9 +16,11 @@
 
 #include <gtest/gtest.h>
 #include <stdio.h>
+#include <unistd.h>
 
 #include "base/arena_allocator.h"
 #include "base/common_art_test.h"
+#include "base/os.h"
 #include "base/unix_file/fd_file.h"
 #include "dex/dex_file.h"
 #include "dex/dex_file_loader.h"
@@ -236,6 +238,89 @@ TEST_F(ProfileCompilationInfoTest, SaveFd) {
   ASSERT_TRUE(loaded_info2.Equals(saved_info));
 }
 
+TEST_F(ProfileCompilationInfoTest, SaveUncompressedFd) {
+  ScratchFile profile;
+
+  ProfileCompilationInfo saved_info;
+  ProfileCompilationInfo::OfflineProfileMethodInfo pmi = GetOfflineProfileMethodInfo();
+  for (uint16_t i = 0; i < 10; i++) {
+    ASSERT_TRUE(AddMethod("dex_location1", /* checksum= */ 1, /* method_idx= */ i, &saved_info));
+    ASSERT_TRUE(AddMethod("dex_location2", /* checksum= */ 2, /* method_idx= */ i, pmi,
+                          &saved_info));
+    ASSERT_TRUE(AddClass("dex_location1", /* checksum= */ 1, dex::TypeIndex(i), &saved_info));
+  }
+  saved_info.SetStoreUncompressed(true);
+  ASSERT_TRUE(saved_info.Save(GetFd(profile)));
+  ASSERT_EQ(0, profile.GetFile()->Flush());
+
+  // Check that we get back what we saved, both from the file descriptor and the file name.
+  ProfileCompilationInfo loaded_info;
+  ASSERT_TRUE(profile.GetFile()->ResetOffset());
+  ASSERT_TRUE(loaded_info.Load(GetFd(profile)));
+  ASSERT_TRUE(loaded_info.Equals(saved_info));
+
+  ProfileCompilationInfo loaded_info2;
+  ASSERT_TRUE(loaded_info2.Load(profile.GetFilename(), /*clear_if_invalid=*/ false));
+  ASSERT_TRUE(loaded_info2.Equals(saved_info));
+
+  // Saving the loaded profile compresses it again by default.
+  ScratchFile compressed_profile;
+  ASSERT_TRUE(loaded_info.Save(GetFd(compressed_profile)));
+  ASSERT_EQ(0, compressed_profile.GetFile()->Flush());
+  ASSERT_LT(compressed_profile.GetFile()->GetLength(), profile.GetFile()->GetLength());
+  ProfileCompilationInfo loaded_info3;
+  ASSERT_TRUE(compressed_profile.GetFile()->ResetOffset());
+  ASSERT_TRUE(loaded_info3.Load(GetFd(compressed_profile)));
+  ASSERT_TRUE(loaded_info3.Equals(saved_info));
+}
+
+TEST_F(ProfileCompilationInfoTest, DeltaLog) {
+  ScratchFile profile;
+  std::string delta_log = ProfileCompilationInfo::GetDeltaLogFilename(profile.GetFilename());
+
+  ProfileCompilationInfo base_info;
+  ProfileCompilationInfo full_info;
+  for (uint16_t i = 0; i < 5; i++) {
+    ASSERT_TRUE(AddMethod("dex_location1", /* checksum= */ 1, /* method_idx= */ i, &base_info));
+    ASSERT_TRUE(AddClass("dex_location1", /* checksum= */ 1, dex::TypeIndex(i), &base_info));
+  }
+  ASSERT_TRUE(base_info.Save(GetFd(profile)));
+  ASSERT_EQ(0, profile.GetFile()->Flush());
+  ASSERT_TRUE(full_info.MergeWith(base_info));
+
+  // The first delta only keeps what the base profile does not have.
+  ProfileCompilationInfo delta1;
+  for (uint16_t i = 0; i < 10; i++) {
+    ASSERT_TRUE(AddMethod("dex_location1", /* checksum= */ 1, /* method_idx= */ i, &delta1));
+    ASSERT_TRUE(AddClass("dex_location1", /* checksum= */ 1, dex::TypeIndex(i), &delta1));
+  }
+  ASSERT_TRUE(full_info.MergeWith(delta1));
+  delta1.RemoveDataPresentIn(base_info);
+  ASSERT_EQ(5u, delta1.GetNumberOfMethods());
+  ASSERT_EQ(5u, delta1.GetNumberOfResolvedClasses());
+  ASSERT_TRUE(delta1.AppendToDeltaLog(profile.GetFilename(), /*bytes_written=*/ nullptr));
+
+  ProfileCompilationInfo delta2;
+  ProfileCompilationInfo::OfflineProfileMethodInfo pmi = GetOfflineProfileMethodInfo();
+  ASSERT_TRUE(AddMethod("dex_location2", /* checksum= */ 2, /* method_idx= */ 3, pmi, &delta2));
+  ASSERT_TRUE(full_info.MergeWith(delta2));
+  ASSERT_TRUE(delta2.AppendToDeltaLog(profile.GetFilename(), /*bytes_written=*/ nullptr));
+
+  // The profile and its delta log together hold everything.
+  ProfileCompilationInfo loaded_info;
+  ASSERT_TRUE(loaded_info.Load(profile.GetFilename(), /*clear_if_invalid=*/ false));
+  ASSERT_TRUE(loaded_info.MergeWithDeltaLog(profile.GetFilename()));
+  ASSERT_TRUE(loaded_info.Equals(full_info));
+
+  ASSERT_TRUE(ProfileCompilationInfo::ClearDeltaLog(profile.GetFilename()));
+  ASSERT_EQ(0, OS::GetFileSizeBytes(delta_log.c_str()));
+  ProfileCompilationInfo base_only_info;
+  ASSERT_TRUE(base_only_info.Load(profile.GetFilename(), /*clear_if_invalid=*/ false));
+  ASSERT_TRUE(base_only_info.MergeWithDeltaLog(profile.GetFilename()));
+  ASSERT_TRUE(base_only_info.Equals(base_info));
+  ASSERT_EQ(0, unlink(delta_log.c_str()));
+}
+
 TEST_F(ProfileCompilationInfoTest, AddMethodsAndClassesFail) {
   ScratchFile profile;
 
@@ -17,12 +17,15 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#include <atomic>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <map>
 #include <set>
+#include <sstream>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -348,7 +351,9 @@ class OatDumperOptions {
                    const char* export_dex_location,
                    const char* app_image,
                    const char* app_oat,
-                   uint32_t addr2instr)
+                   uint32_t addr2instr,
+                   size_t num_threads,
+                   const char* stats_format)
     : dump_vmap_(dump_vmap),
       dump_code_info_stack_maps_(dump_code_info_stack_maps),
       disassemble_code_(disassemble_code),
@@ -362,6 +367,8 @@ class OatDumperOptions {
       app_image_(app_image),
       app_oat_(app_oat),
       addr2instr_(addr2instr),
+      num_threads_(num_threads),
+      stats_format_(stats_format),
       class_loader_(nullptr) {}
 
   const bool dump_vmap_;
@@ -377,6 +384,11 @@ class OatDumperOptions {
   const char* const app_image_;
   const char* const app_oat_;
   uint32_t addr2instr_;
+  // Number of threads used to dump the classes of each dex file. The output is the same
+  // as with a single thread.
+  const size_t num_threads_;
+  // If not null, "json" or "csv". Only the size statistics are printed, in that format.
+  const char* const stats_format_;
   Handle<mirror::ClassLoader>* class_loader_;
 };
 
@@ -388,15 +400,8 @@ class OatDumper {
       options_(options),
       resolved_addr2instr_(0),
       instruction_set_(oat_file_.GetOatHeader().GetInstructionSet()),
-      disassembler_(Disassembler::Create(instruction_set_,
-                                         new DisassemblerOptions(
-                                             options_.absolute_addresses_,
-                                             oat_file.Begin(),
-                                             oat_file.End(),
-                                             /* can_read_literals_= */ true,
-                                             Is64BitInstructionSet(instruction_set_)
-                                                 ? &Thread::DumpThreadOffset<PointerSize::k64>
-                                                 : &Thread::DumpThreadOffset<PointerSize::k32>))) {
+      disassembler_(CreateDisassembler()),
+      stats_lock_("oatdump stats lock", kGenericBottomLock) {
     CHECK(options_.class_loader_ != nullptr);
     CHECK(options_.class_filter_ != nullptr);
     CHECK(options_.method_filter_ != nullptr);
@@ -407,6 +412,18 @@ class OatDumper {
     delete disassembler_;
   }
 
+  Disassembler* CreateDisassembler() const {
+    return Disassembler::Create(instruction_set_,
+                                new DisassemblerOptions(
+                                    options_.absolute_addresses_,
+                                    oat_file_.Begin(),
+                                    oat_file_.End(),
+                                    /* can_read_literals_= */ true,
+                                    Is64BitInstructionSet(instruction_set_)
+                                        ? &Thread::DumpThreadOffset<PointerSize::k64>
+                                        : &Thread::DumpThreadOffset<PointerSize::k32>));
+  }
+
   InstructionSet GetInstructionSet() {
     return instruction_set_;
   }
@@ -414,6 +431,10 @@ class OatDumper {
   using DexFileUniqV = std::vector<std::unique_ptr<const DexFile>>;
 
   bool Dump(std::ostream& os) {
+    if (options_.stats_format_ != nullptr) {
+      return DumpStatsOnly(os);
+    }
+
     bool success = true;
     const OatHeader& oat_header = oat_file_.GetOatHeader();
 
@@ -679,6 +700,7 @@ class OatDumper {
     {
       os << "OAT FILE STATS:\n";
       VariableIndentationOutputStream vios(&os);
+      MutexLock mu(Thread::Current(), stats_lock_);
       stats_.AddBytes(oat_file_.Size());
       DumpStats(vios, "OatFile", stats_, stats_.Value());
     }
@@ -687,6 +709,107 @@ class OatDumper {
     return success;
   }
 
+  // Collect the same size stats as a full dump, without disassembling, and print them in
+  // `options_.stats_format_` for tools that track sizes across builds.
+  bool DumpStatsOnly(std::ostream& os) {
+    bool success = true;
+    for (const OatDexFile* oat_dex_file : oat_dex_files_) {
+      CHECK(oat_dex_file != nullptr);
+      std::string error_msg;
+      const DexFile* const dex_file = OpenDexFile(oat_dex_file, &error_msg);
+      if (dex_file == nullptr) {
+        LOG(ERROR) << "Failed to open dex file '" << oat_dex_file->GetDexFileLocation()
+                   << "': " << error_msg;
+        success = false;
+        continue;
+      }
+      for (ClassAccessor accessor : dex_file->GetClasses()) {
+        if (!MatchesClassFilter(accessor)) {
+          continue;
+        }
+        const OatFile::OatClass oat_class =
+            oat_dex_file->GetOatClass(accessor.GetClassDefIndex());
+        uint32_t class_method_index = 0;
+        for (const ClassAccessor::Method& method : accessor.GetMethods()) {
+          std::string method_name =
+              dex_file->GetMethodName(dex_file->GetMethodId(method.GetIndex()));
+          if (method_name.find(options_.method_filter_) != std::string::npos) {
+            CollectOatMethodStats(oat_class.GetOatMethod(class_method_index),
+                                  CodeItemDataAccessor(*dex_file, method.GetCodeItem()));
+          }
+          class_method_index++;
+        }
+      }
+    }
+
+    MutexLock mu(Thread::Current(), stats_lock_);
+    stats_.AddBytes(oat_file_.Size());
+    if (strcmp(options_.stats_format_, "json") == 0) {
+      DumpStatsAsJson(os, "OatFile", stats_);
+      os << "\n";
+    } else {
+      DCHECK_EQ(strcmp(options_.stats_format_, "csv"), 0);
+      os << "path,bytes,count\n";
+      DumpStatsAsCsv(os, "OatFile", stats_);
+    }
+    os << std::flush;
+    return success;
+  }
+
+  // Add the stats that DumpOatMethod() and DumpCode() would add for this method.
+  void CollectOatMethodStats(const OatFile::OatMethod& oat_method,
+                             const CodeItemDataAccessor& code_item_accessor) {
+    const OatQuickMethodHeader* method_header = oat_method.GetOatQuickMethodHeader();
+    AddStatsBytes(method_header, "QuickMethodHeader", sizeof(*method_header));
+    if (oat_method.GetOatQuickMethodHeaderOffset() > oat_file_.Size() ||
+        oat_method.GetQuickCodeSizeOffset() > oat_file_.Size()) {
+      return;
+    }
+    const void* code = oat_method.GetQuickCode();
+    uint32_t code_size = oat_method.GetQuickCodeSize();
+    AddStatsBytes(code, "Code", code_size);
+    uint64_t aligned_code_end = AlignCodeOffset(oat_method.GetCodeOffset()) + code_size;
+    if (code != nullptr &&
+        code_size != 0u &&
+        code_size <= kMaxCodeSize &&
+        aligned_code_end <= oat_file_.Size() &&
+        IsMethodGeneratedByOptimizingCompiler(oat_method, code_item_accessor)) {
+      AddCodeInfoStats(oat_method.GetVmapTable());
+    }
+  }
+
+  // Children are sorted by name so that the output of two builds can be diffed.
+  static std::map<std::string, const Stats*> SortedStatsChildren(const Stats& stats) {
+    std::map<std::string, const Stats*> sorted_children;
+    for (const auto& it : stats.Children()) {
+      sorted_children.emplace(it.first, &it.second);
+    }
+    return sorted_children;
+  }
+
+  static void DumpStatsAsJson(std::ostream& os, const std::string& name, const Stats& stats) {
+    os << "{\"name\":\"" << name << "\","
+       << "\"bytes\":" << std::fixed << std::setprecision(3) << stats.Value() << ","
+       << "\"count\":" << stats.Count() << ","
+       << "\"children\":[";
+    const char* separator = "";
+    for (const auto& it : SortedStatsChildren(stats)) {
+      os << separator;
+      DumpStatsAsJson(os, it.first, *it.second);
+      separator = ",";
+    }
+    os << "]}";
+  }
+
+  static void DumpStatsAsCsv(std::ostream& os, const std::string& path, const Stats& stats) {
+    os << path << ","
+       << std::fixed << std::setprecision(3) << stats.Value() << ","
+       << stats.Count() << "\n";
+    for (const auto& it : SortedStatsChildren(stats)) {
+      DumpStatsAsCsv(os, path + "/" + it.first, *it.second);
+    }
+  }
+
   size_t ComputeSize(const void* oat_data) {
     if (reinterpret_cast<const uint8_t*>(oat_data) < oat_file_.Begin() ||
         reinterpret_cast<const uint8_t*>(oat_data) > oat_file_.End()) {
@@ -797,10 +920,25 @@ class OatDumper {
     return vdex_file;
   }
 
-  bool AddStatsObject(const void* address) {
+  bool AddStatsObject(const void* address) REQUIRES(stats_lock_) {
     return seen_stats_objects_.insert(address).second;  // Inserted new entry.
   }
 
+  // The stats are shared by all dumping threads, so they are updated under `stats_lock_`.
+  void AddStatsBytes(const void* address, const char* name, size_t bytes) {
+    MutexLock mu(Thread::Current(), stats_lock_);
+    if (AddStatsObject(address)) {
+      stats_.Child(name)->AddBytes(bytes);
+    }
+  }
+
+  void AddCodeInfoStats(const uint8_t* code_info) {
+    MutexLock mu(Thread::Current(), stats_lock_);
+    if (AddStatsObject(code_info)) {
+      CodeInfo::CollectSizeStats(code_info, &stats_);
+    }
+  }
+
   void DumpStats(VariableIndentationOutputStream& os,
                  const std::string& name,
                  const Stats& stats,
@@ -921,30 +1059,20 @@ class OatDumper {
                          table_offset + table_size - 1);
     }
 
+    if (CanDumpClassesInParallel()) {
+      success = DumpClassesInParallel(os, oat_dex_file, *dex_file);
+      os << "\n";
+      os << std::flush;
+      return success;
+    }
+
     VariableIndentationOutputStream vios(&os);
     ScopedIndentation indent1(&vios);
     for (ClassAccessor accessor : dex_file->GetClasses()) {
-      // TODO: Support regex
-      const char* descriptor = accessor.GetDescriptor();
-      if (DescriptorToDot(descriptor).find(options_.class_filter_) == std::string::npos) {
+      if (!MatchesClassFilter(accessor)) {
         continue;
       }
-
-      const uint16_t class_def_index = accessor.GetClassDefIndex();
-      uint32_t oat_class_offset = oat_dex_file.GetOatClassOffset(class_def_index);
-      const OatFile::OatClass oat_class = oat_dex_file.GetOatClass(class_def_index);
-      os << StringPrintf("%zd: %s (offset=0x%08x) (type_idx=%d)",
-                         static_cast<ssize_t>(class_def_index),
-                         descriptor,
-                         oat_class_offset,
-                         accessor.GetClassIdx().index_)
-         << " (" << oat_class.GetStatus() << ")"
-         << " (" << oat_class.GetType() << ")\n";
-      // TODO: include bitmap here if type is kOatClassSomeCompiled?
-      if (options_.list_classes_) {
-        continue;
-      }
-      if (!DumpOatClass(&vios, oat_class, *dex_file, accessor, &stop_analysis)) {
+      if (!DumpClass(os, &vios, oat_dex_file, *dex_file, accessor, &stop_analysis)) {
         success = false;
       }
       if (stop_analysis) {
@@ -957,6 +1085,102 @@ class OatDumper {
     return success;
   }
 
+  bool MatchesClassFilter(const ClassAccessor& accessor) const {
+    // TODO: Support regex
+    return DescriptorToDot(accessor.GetDescriptor()).find(options_.class_filter_) !=
+        std::string::npos;
+  }
+
+  // Dump the class header line to `os` and the methods to `vios`, which wraps `os`.
+  bool DumpClass(std::ostream& os,
+                 VariableIndentationOutputStream* vios,
+                 const OatDexFile& oat_dex_file,
+                 const DexFile& dex_file,
+                 const ClassAccessor& accessor,
+                 bool* stop_analysis) {
+    const uint16_t class_def_index = accessor.GetClassDefIndex();
+    uint32_t oat_class_offset = oat_dex_file.GetOatClassOffset(class_def_index);
+    const OatFile::OatClass oat_class = oat_dex_file.GetOatClass(class_def_index);
+    os << StringPrintf("%zd: %s (offset=0x%08x) (type_idx=%d)",
+                       static_cast<ssize_t>(class_def_index),
+                       accessor.GetDescriptor(),
+                       oat_class_offset,
+                       accessor.GetClassIdx().index_)
+       << " (" << oat_class.GetStatus() << ")"
+       << " (" << oat_class.GetType() << ")\n";
+    // TODO: include bitmap here if type is kOatClassSomeCompiled?
+    if (options_.list_classes_) {
+      return true;
+    }
+    return DumpOatClass(vios, oat_class, dex_file, accessor, stop_analysis);
+  }
+
+  // The verifier needs the runtime and --addr2instr stops at the first match, so both of
+  // them dump sequentially.
+  bool CanDumpClassesInParallel() const {
+    return options_.num_threads_ > 1u &&
+        !options_.list_classes_ &&
+        resolved_addr2instr_ == 0u &&
+        Runtime::Current() == nullptr;
+  }
+
+  // Dump the classes on `options_.num_threads_` threads. Each class is dumped to its own
+  // buffer and the buffers are written out in class order, so the output matches the
+  // sequential dump. Classes are processed in batches to bound the memory used by buffers.
+  bool DumpClassesInParallel(std::ostream& os,
+                             const OatDexFile& oat_dex_file,
+                             const DexFile& dex_file) {
+    static constexpr size_t kClassesPerBatch = 1024u;
+    std::vector<ClassAccessor> classes;
+    for (ClassAccessor accessor : dex_file.GetClasses()) {
+      if (MatchesClassFilter(accessor)) {
+        classes.push_back(accessor);
+      }
+    }
+
+    std::atomic<bool> success(true);
+    std::vector<std::string> outputs(std::min(classes.size(), kClassesPerBatch));
+    for (size_t batch_begin = 0; batch_begin < classes.size(); batch_begin += kClassesPerBatch) {
+      const size_t batch_end = std::min(classes.size(), batch_begin + kClassesPerBatch);
+      std::atomic<size_t> next_class(batch_begin);
+      auto dump_classes = [&]() {
+        std::unique_ptr<Disassembler> disassembler(CreateDisassembler());
+        worker_disassembler_ = disassembler.get();
+        for (size_t i = next_class.fetch_add(1u, std::memory_order_relaxed);
+             i < batch_end;
+             i = next_class.fetch_add(1u, std::memory_order_relaxed)) {
+          std::ostringstream class_os;
+          VariableIndentationOutputStream vios(&class_os);
+          ScopedIndentation indent1(&vios);
+          bool stop_analysis = false;  // Only set by --addr2instr.
+          if (!DumpClass(class_os, &vios, oat_dex_file, dex_file, classes[i], &stop_analysis)) {
+            success.store(false, std::memory_order_relaxed);
+          }
+          outputs[i - batch_begin] = class_os.str();
+        }
+        worker_disassembler_ = nullptr;
+      };
+      const size_t num_threads = std::min(options_.num_threads_, batch_end - batch_begin);
+      std::vector<std::thread> threads;
+      for (size_t t = 1u; t < num_threads; ++t) {
+        threads.emplace_back(dump_classes);
+      }
+      dump_classes();
+      for (std::thread& thread : threads) {
+        thread.join();
+      }
+      for (size_t i = batch_begin; i != batch_end; ++i) {
+        os << outputs[i - batch_begin];
+        outputs[i - batch_begin].clear();
+      }
+    }
+    return success.load(std::memory_order_relaxed);
+  }
+
+  Disassembler* GetDisassembler() const {
+    return (worker_disassembler_ != nullptr) ? worker_disassembler_ : disassembler_;
+  }
+
   // Backwards compatible Dex file export. If dex_file is nullptr (valid Vdex file not present) the
   // Dex resource is extracted from the oat_dex_file and its checksum is repaired since it's not
   // unquickened. Otherwise the dex_file has been fully unquickened and is expected to verify the
@@ -1198,9 +1422,7 @@ class OatDumper {
       vios->Stream() << "OatQuickMethodHeader ";
       uint32_t method_header_offset = oat_method.GetOatQuickMethodHeaderOffset();
       const OatQuickMethodHeader* method_header = oat_method.GetOatQuickMethodHeader();
-      if (AddStatsObject(method_header)) {
-        stats_.Child("QuickMethodHeader")->AddBytes(sizeof(*method_header));
-      }
+      AddStatsBytes(method_header, "QuickMethodHeader", sizeof(*method_header));
       if (options_.absolute_addresses_) {
         vios->Stream() << StringPrintf("%p ", method_header);
       }
@@ -1272,9 +1494,7 @@ class OatDumper {
         const void* code = oat_method.GetQuickCode();
         uint32_t aligned_code_begin = AlignCodeOffset(code_offset);
         uint64_t aligned_code_end = aligned_code_begin + code_size;
-        if (AddStatsObject(code)) {
-          stats_.Child("Code")->AddBytes(code_size);
-        }
+        AddStatsBytes(code, "Code", code_size);
 
         if (options_.absolute_addresses_) {
           vios->Stream() << StringPrintf("%p ", code);
@@ -1622,13 +1842,11 @@ class OatDumper {
                                                                    code_item_accessor)) {
       // The optimizing compiler outputs its CodeInfo data in the vmap table.
       StackMapsHelper helper(oat_method.GetVmapTable(), instruction_set_);
-      if (AddStatsObject(oat_method.GetVmapTable())) {
-        helper.GetCodeInfo().CollectSizeStats(oat_method.GetVmapTable(), &stats_);
-      }
+      AddCodeInfoStats(oat_method.GetVmapTable());
       const uint8_t* quick_native_pc = reinterpret_cast<const uint8_t*>(quick_code);
       size_t offset = 0;
       while (offset < code_size) {
-        offset += disassembler_->Dump(vios->Stream(), quick_native_pc + offset);
+        offset += GetDisassembler()->Dump(vios->Stream(), quick_native_pc + offset);
         if (offset == helper.GetOffset()) {
           ScopedIndentation indent1(vios);
           StackMap stack_map = helper.GetStackMap();
@@ -1648,7 +1866,7 @@ class OatDumper {
       const uint8_t* quick_native_pc = reinterpret_cast<const uint8_t*>(quick_code);
       size_t offset = 0;
       while (offset < code_size) {
-        offset += disassembler_->Dump(vios->Stream(), quick_native_pc + offset);
+        offset += GetDisassembler()->Dump(vios->Stream(), quick_native_pc + offset);
       }
     }
   }
@@ -1783,10 +2001,15 @@ class OatDumper {
   const InstructionSet instruction_set_;
   std::set<uintptr_t> offsets_;
   Disassembler* disassembler_;
-  Stats stats_;
-  std::unordered_set<const void*> seen_stats_objects_;
+  // Disassemblers are not thread-safe, so each parallel dumping thread uses its own.
+  static thread_local Disassembler* worker_disassembler_;
+  Mutex stats_lock_;
+  Stats stats_ GUARDED_BY(stats_lock_);
+  std::unordered_set<const void*> seen_stats_objects_ GUARDED_BY(stats_lock_);
 };
 
+thread_local Disassembler* OatDumper::worker_disassembler_ = nullptr;
+
 class ImageDumper {
  public:
   ImageDumper(std::ostream* os,
@@ -2349,7 +2572,34 @@ class ImageDumper {
       }
     }
     std::string temp;
-    stats_.Update(obj_class->GetDescriptor(&temp), object_bytes);
+    const char* descriptor = obj_class->GetDescriptor(&temp);
+    stats_.Update(descriptor, object_bytes);
+    if (!obj_class->IsVariableSize()) {
+      size_t field_gap_bytes = GetFieldGapBytes(obj_class);
+      if (field_gap_bytes != 0u) {
+        stats_.UpdateFieldGaps(descriptor, field_gap_bytes);
+      }
+    }
+  }
+
+  // Returns the bytes of an instance of `klass` not covered by its fields or those of its
+  // superclasses, excluding the alignment of the object size.
+  size_t GetFieldGapBytes(ObjPtr<mirror::Class> klass) REQUIRES_SHARED(Locks::mutator_lock_) {
+    auto it = field_gap_bytes_.find(klass.Ptr());
+    if (it != field_gap_bytes_.end()) {
+      return it->second;
+    }
+    // The object header is made of the fields of java.lang.Object.
+    size_t field_bytes = 0u;
+    for (ObjPtr<mirror::Class> c = klass; c != nullptr; c = c->GetSuperClass()) {
+      for (ArtField& field : c->GetIFields()) {
+        field_bytes += Primitive::ComponentSize(field.GetTypeAsPrimitiveType());
+      }
+    }
+    size_t object_size = klass->GetObjectSize();
+    size_t gap_bytes = (object_size > field_bytes) ? object_size - field_bytes : 0u;
+    field_gap_bytes_.Put(klass.Ptr(), gap_bytes);
+    return gap_bytes;
   }
 
   void DumpMethod(ArtMethod* method, std::ostream& indent_os)
@@ -2485,6 +2735,10 @@ class ImageDumper {
     };
     using SizeAndCountTable = SafeMap<std::string, SizeAndCount>;
     SizeAndCountTable sizes_and_counts;
+    // Padding between the instance fields of objects, by class. Only classes with padding
+    // are recorded.
+    SizeAndCountTable field_gaps;
+    size_t field_gap_bytes = 0u;
 
     void Update(const char* descriptor, size_t object_bytes_in) {
       SizeAndCountTable::iterator it = sizes_and_counts.find(descriptor);
@@ -2496,6 +2750,17 @@ class ImageDumper {
       }
     }
 
+    void UpdateFieldGaps(const char* descriptor, size_t gap_bytes_in) {
+      field_gap_bytes += gap_bytes_in;
+      SizeAndCountTable::iterator it = field_gaps.find(descriptor);
+      if (it != field_gaps.end()) {
+        it->second.bytes += gap_bytes_in;
+        it->second.count += 1;
+      } else {
+        field_gaps.Put(descriptor, SizeAndCount(gap_bytes_in, 1));
+      }
+    }
+
     double PercentOfOatBytes(size_t size) {
       return (static_cast<double>(size) / static_cast<double>(oat_file_bytes)) * 100;
     }
@@ -2670,6 +2935,17 @@ class ImageDumper {
       os << "\n" << std::flush;
       CHECK_EQ(object_bytes, object_bytes_total);
 
+      os << StringPrintf("field_gap_bytes = %8zd (%2.0f%% of object_bytes, padding between"
+                         " instance fields, excluding alignment_bytes)\n",
+                         field_gap_bytes, PercentOfObjectBytes(field_gap_bytes));
+      for (const auto& field_gap : field_gaps) {
+        const std::string& descriptor(field_gap.first);
+        os << StringPrintf("%32s %8zd bytes %6zd instances (%4zd bytes/instance)\n",
+                           descriptor.c_str(), field_gap.second.bytes, field_gap.second.count,
+                           field_gap.second.bytes / field_gap.second.count);
+      }
+      os << "\n" << std::flush;
+
       os << StringPrintf("oat_file_bytes               = %8zd\n"
                          "managed_code_bytes           = %8zd (%2.0f%% of oat file bytes)\n"
                          "native_to_managed_code_bytes = %8zd (%2.0f%% of oat file bytes)\n\n"
@@ -2731,6 +3007,8 @@ class ImageDumper {
   std::unique_ptr<OatDumper> oat_dumper_;
   OatDumperOptions* oat_dumper_options_;
   std::set<mirror::Object*> dex_caches_;
+  // Cache for GetFieldGapBytes(). Image classes do not move.
+  SafeMap<mirror::Class*, size_t> field_gap_bytes_;
 
   DISALLOW_COPY_AND_ASSIGN(ImageDumper);
 };
@@ -3445,6 +3723,18 @@ struct OatdumpArgs : public CmdlineArgs {
       imt_dump_ = std::string(option.substr(strlen("--dump-imt=")));
     } else if (option == "--dump-imt-stats") {
       imt_stat_dump_ = true;
+    } else if (StartsWith(option, "--dump-threads=")) {
+      if (!android::base::ParseUint(raw_option + strlen("--dump-threads="), &dump_threads_) ||
+          dump_threads_ == 0u) {
+        *error_msg = "--dump-threads must be a positive number";
+        return kParseError;
+      }
+    } else if (StartsWith(option, "--stats-format=")) {
+      stats_format_ = raw_option + strlen("--stats-format=");
+      if (strcmp(stats_format_, "json") != 0 && strcmp(stats_format_, "csv") != 0) {
+        *error_msg = "--stats-format must be json or csv";
+        return kParseError;
+      }
     } else {
       return kParseUnknownArgument;
     }
@@ -3551,6 +3841,14 @@ struct OatdumpArgs : public CmdlineArgs {
         "\n"
         "  --dump-imt-stats: output IMT statistics for the given boot image\n"
         "      Example: --dump-imt-stats"
+        "\n"
+        "  --dump-threads=<n>: dump the classes of each dex file on n threads. The output\n"
+        "                      does not depend on the number of threads.\n"
+        "      Example: --dump-threads=8\n"
+        "\n"
+        "  --stats-format=<json|csv>: only print the oat file size statistics, in the given\n"
+        "                             format. Code is not disassembled.\n"
+        "      Example: --stats-format=json\n"
         "\n";
 
     return usage;
@@ -3574,6 +3872,8 @@ struct OatdumpArgs : public CmdlineArgs {
   bool dump_header_only_ = false;
   bool imt_stat_dump_ = false;
   uint32_t addr2instr_ = 0;
+  size_t dump_threads_ = 1u;
+  const char* stats_format_ = nullptr;
   const char* export_dex_location_ = nullptr;
   const char* app_image_ = nullptr;
   const char* app_oat_ = nullptr;
@@ -3599,7 +3899,9 @@ struct OatdumpMain : public CmdlineMain<OatdumpArgs> {
         args_->export_dex_location_,
         args_->app_image_,
         args_->app_oat_,
-        args_->addr2instr_));
+        args_->addr2instr_,
+        args_->dump_threads_,
+        args_->stats_format_));
 
     return (args_->boot_image_location_ != nullptr ||
             args_->image_location_ != nullptr ||
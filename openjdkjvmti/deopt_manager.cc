@@ -38,13 +38,17 @@
 #include "art_jvmti.h"
 #include "art_method-inl.h"
 #include "base/enums.h"
+#include "art_field-inl.h"
 #include "base/mutex-inl.h"
+#include "class_linker.h"
 #include "dex/dex_file_annotations.h"
+#include "dex/dex_instruction-inl.h"
 #include "dex/modifiers.h"
 #include "events-inl.h"
 #include "gc/collector_type.h"
 #include "gc/heap.h"
 #include "gc/scoped_gc_critical_section.h"
+#include "handle.h"
 #include "instrumentation.h"
 #include "jit/jit.h"
 #include "jni/jni_internal.h"
@@ -95,6 +99,10 @@ DeoptManager::DeoptManager()
     deopter_count_(0),
     breakpoint_status_lock_("JVMTI_BreakpointStatusLock",
                             static_cast<art::LockLevel>(art::LockLevel::kAbortLock + 1)),
+    field_watch_lock_("JVMTI_FieldWatchLock",
+                      static_cast<art::LockLevel>(art::LockLevel::kAbortLock + 1)),
+    next_field_watch_id_(0),
+    num_field_watches_(0),
     inspection_callback_(this),
     set_local_variable_called_(false) { }
 
@@ -116,6 +124,13 @@ void DeoptManager::Shutdown() {
 
 void DeoptManager::DumpDeoptInfo(art::Thread* self, std::ostream& stream) {
   art::ScopedObjectAccess soa(self);
+  {
+    art::MutexLock mufwl(self, field_watch_lock_);
+    for (const auto& [field, watch] : field_watches_) {
+      stream << "Field watch: " << field->PrettyField() << " (" << watch.methods.size()
+             << " methods deoptimized)\n";
+    }
+  }
   art::MutexLock mutll(self, *art::Locks::thread_list_lock_);
   art::MutexLock mudsl(self, deoptimization_status_lock_);
   art::MutexLock mubsl(self, breakpoint_status_lock_);
@@ -313,6 +328,176 @@ void DeoptManager::RemoveMethodBreakpoint(art::ArtMethod* method) {
   }
 }
 
+// Returns true if the method has a field instruction that might access the field. Field references
+// are compared by name and type only since they can name a subclass of the declaring class and
+// need not be resolved yet. Quickened field instructions are compared by offset.
+static bool MethodMightAccessField(art::ArtMethod* method, art::ArtField* field)
+    REQUIRES_SHARED(art::Locks::mutator_lock_) {
+  if (!method->IsInvokable() ||
+      method->IsNative() ||
+      method->IsProxyMethod() ||
+      method->IsObsolete() ||
+      method->GetCodeItem() == nullptr) {
+    return false;
+  }
+  const art::DexFile* dex_file = method->GetDexFile();
+  const char* name = field->GetName();
+  const char* type = field->GetTypeDescriptor();
+  for (const art::DexInstructionPcPair& inst : method->DexInstructions()) {
+    art::Instruction::Code opcode = inst->Opcode();
+    switch (art::Instruction::IndexTypeOf(opcode)) {
+      case art::Instruction::kIndexFieldRef: {
+        uint32_t field_idx = (art::Instruction::FormatOf(opcode) == art::Instruction::k22c)
+            ? inst->VRegC_22c()
+            : inst->VRegB_21c();
+        const art::dex::FieldId& field_id = dex_file->GetFieldId(field_idx);
+        if (strcmp(dex_file->GetFieldName(field_id), name) == 0 &&
+            strcmp(dex_file->GetFieldTypeDescriptor(field_id), type) == 0) {
+          return true;
+        }
+        break;
+      }
+      case art::Instruction::kIndexFieldOffset:
+        if (!field->IsStatic() && inst->VRegC_22c() == field->GetOffset().Uint32Value()) {
+          return true;
+        }
+        break;
+      default:
+        break;
+    }
+  }
+  return false;
+}
+
+static void CollectMethodsAccessingField(art::ObjPtr<art::mirror::Class> klass,
+                                         art::ArtField* field,
+                                         std::vector<art::ArtMethod*>* methods)
+    REQUIRES_SHARED(art::Locks::mutator_lock_) {
+  for (art::ArtMethod& method : klass->GetDeclaredMethods(art::kRuntimePointerSize)) {
+    if (MethodMightAccessField(&method, field)) {
+      methods->push_back(&method);
+    }
+  }
+}
+
+void DeoptManager::AddFieldWatch(art::ArtField* field) {
+  art::Thread* self = art::Thread::Current();
+  // Each watch holds a deoptimization request until it is removed.
+  AddDeoptimizationRequester();
+  uint64_t id;
+  {
+    art::MutexLock mu(self, field_watch_lock_);
+    FieldWatch& watch = field_watches_[field];
+    if (watch.count++ != 0u) {
+      // The methods are already deoptimized.
+      return;
+    }
+    id = next_field_watch_id_++;
+    watch.id = id;
+    num_field_watches_.fetch_add(1u, std::memory_order_release);
+  }
+  // Look for the methods only after publishing the watch so that a class being prepared
+  // concurrently is handled either here or by HandleClassPrepare.
+  class FieldAccessClassVisitor : public art::ClassVisitor {
+   public:
+    FieldAccessClassVisitor(art::ArtField* field, std::vector<art::ArtMethod*>* methods)
+        : field_(field), methods_(methods) {}
+
+    bool operator()(art::ObjPtr<art::mirror::Class> klass)
+        override REQUIRES_SHARED(art::Locks::mutator_lock_) {
+      // Classes that are not resolved yet are handled by HandleClassPrepare.
+      if (klass->IsResolved() && !klass->IsTemp() && !klass->IsRetired()) {
+        CollectMethodsAccessingField(klass, field_, methods_);
+      }
+      return true;
+    }
+
+   private:
+    art::ArtField* field_;
+    std::vector<art::ArtMethod*>* methods_;
+  };
+  std::vector<art::ArtMethod*> methods;
+  FieldAccessClassVisitor visitor(field, &methods);
+  art::Runtime::Current()->GetClassLinker()->VisitClasses(&visitor);
+  // Keep deoptimization enabled until the methods are recorded even if the watch is removed
+  // concurrently.
+  AddDeoptimizationRequester();
+  for (art::ArtMethod* method : methods) {
+    AddMethodBreakpoint(method);
+  }
+  RecordFieldWatchMethods(field, id, methods);
+  RemoveDeoptimizationRequester();
+}
+
+void DeoptManager::RemoveFieldWatch(art::ArtField* field) {
+  std::vector<art::ArtMethod*> methods;
+  {
+    art::MutexLock mu(art::Thread::Current(), field_watch_lock_);
+    auto it = field_watches_.find(field);
+    DCHECK(it != field_watches_.end()) << "Removing a field watch that was never added!";
+    if (--it->second.count == 0u) {
+      methods = std::move(it->second.methods);
+      field_watches_.erase(it);
+      num_field_watches_.fetch_sub(1u, std::memory_order_release);
+    }
+  }
+  for (art::ArtMethod* method : methods) {
+    RemoveMethodBreakpoint(method);
+  }
+  RemoveDeoptimizationRequester();
+}
+
+void DeoptManager::HandleClassPrepare(art::Handle<art::mirror::Class> klass) {
+  if (LIKELY(num_field_watches_.load(std::memory_order_acquire) == 0u)) {
+    return;
+  }
+  std::vector<std::pair<art::ArtField*, uint64_t>> watches;
+  {
+    art::MutexLock mu(art::Thread::Current(), field_watch_lock_);
+    for (const auto& [field, watch] : field_watches_) {
+      watches.emplace_back(field, watch.id);
+    }
+  }
+  std::vector<std::vector<art::ArtMethod*>> methods(watches.size());
+  bool found_any = false;
+  for (size_t i = 0; i != watches.size(); ++i) {
+    CollectMethodsAccessingField(klass.Get(), watches[i].first, &methods[i]);
+    found_any = found_any || !methods[i].empty();
+  }
+  if (!found_any) {
+    return;
+  }
+  // Keep deoptimization enabled until the methods are recorded even if the watches are removed
+  // concurrently.
+  AddDeoptimizationRequester();
+  for (size_t i = 0; i != watches.size(); ++i) {
+    for (art::ArtMethod* method : methods[i]) {
+      AddMethodBreakpoint(method);
+    }
+    RecordFieldWatchMethods(watches[i].first, watches[i].second, methods[i]);
+  }
+  RemoveDeoptimizationRequester();
+}
+
+void DeoptManager::RecordFieldWatchMethods(art::ArtField* field,
+                                           uint64_t id,
+                                           const std::vector<art::ArtMethod*>& methods) {
+  bool watch_removed;
+  {
+    art::MutexLock mu(art::Thread::Current(), field_watch_lock_);
+    auto it = field_watches_.find(field);
+    watch_removed = (it == field_watches_.end() || it->second.id != id);
+    if (!watch_removed) {
+      it->second.methods.insert(it->second.methods.end(), methods.begin(), methods.end());
+    }
+  }
+  if (watch_removed) {
+    for (art::ArtMethod* method : methods) {
+      RemoveMethodBreakpoint(method);
+    }
+  }
+}
+
 void DeoptManager::WaitForDeoptimizationToFinishLocked(art::Thread* self) {
   while (performing_deoptimization_) {
     deoptimization_condition_.Wait(self);
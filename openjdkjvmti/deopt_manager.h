@@ -35,6 +35,7 @@
 #include <atomic>
 #include <iosfwd>
 #include <unordered_map>
+#include <vector>
 
 #include "base/mutex.h"
 #include "runtime_callbacks.h"
@@ -42,8 +43,10 @@
 #include <jvmti.h>
 
 namespace art {
+class ArtField;
 class ArtMethod;
 class ScopedObjectAccessUnchecked;
+template <typename T> class Handle;
 namespace mirror {
 class Class;
 }  // namespace mirror
@@ -96,6 +99,22 @@ class DeoptManager {
       REQUIRES(!deoptimization_status_lock_, !art::Roles::uninterruptible_)
       REQUIRES_SHARED(art::Locks::mutator_lock_);
 
+  // Deoptimize the methods that might read or write the given field so that the interpreter can
+  // report events for it, instead of deoptimizing everything. Each call to AddFieldWatch must be
+  // balanced by a call to RemoveFieldWatch.
+  void AddFieldWatch(art::ArtField* field)
+      REQUIRES(!deoptimization_status_lock_, !field_watch_lock_, !art::Roles::uninterruptible_)
+      REQUIRES_SHARED(art::Locks::mutator_lock_);
+
+  void RemoveFieldWatch(art::ArtField* field)
+      REQUIRES(!deoptimization_status_lock_, !field_watch_lock_, !art::Roles::uninterruptible_)
+      REQUIRES_SHARED(art::Locks::mutator_lock_);
+
+  // Deoptimize the methods of a newly prepared class that might access a watched field.
+  void HandleClassPrepare(art::Handle<art::mirror::Class> klass)
+      REQUIRES(!deoptimization_status_lock_, !field_watch_lock_, !art::Roles::uninterruptible_)
+      REQUIRES_SHARED(art::Locks::mutator_lock_);
+
   void AddDeoptimizeAllMethods()
       REQUIRES(!deoptimization_status_lock_, !art::Roles::uninterruptible_)
       REQUIRES_SHARED(art::Locks::mutator_lock_);
@@ -135,6 +154,14 @@ class DeoptManager {
   bool MethodHasBreakpointsLocked(art::ArtMethod* method)
       REQUIRES(breakpoint_status_lock_);
 
+  // Record the methods deoptimized for the field watch with the given id, or undo their
+  // deoptimization if the watch was removed in the meantime.
+  void RecordFieldWatchMethods(art::ArtField* field,
+                               uint64_t id,
+                               const std::vector<art::ArtMethod*>& methods)
+      REQUIRES(!deoptimization_status_lock_, !field_watch_lock_, !art::Roles::uninterruptible_)
+      REQUIRES_SHARED(art::Locks::mutator_lock_);
+
   // Wait until nothing is currently in the middle of deoptimizing/undeoptimizing something. This is
   // needed to ensure that everything is synchronized since threads need to drop the
   // deoptimization_status_lock_ while deoptimizing methods.
@@ -187,6 +214,23 @@ class DeoptManager {
   std::unordered_map<art::ArtMethod*, uint32_t> breakpoint_status_
       GUARDED_BY(breakpoint_status_lock_);
 
+  struct FieldWatch {
+    // Number of AddFieldWatch calls not yet balanced by RemoveFieldWatch.
+    uint32_t count;
+    // Unique id of this watch, so that late additions can tell if the watch went away.
+    uint64_t id;
+    // The methods deoptimized for this watch, each holding one breakpoint count.
+    std::vector<art::ArtMethod*> methods;
+  };
+
+  // Protects the field watches. Like breakpoint_status_lock_ nothing else is locked while holding
+  // it.
+  art::Mutex field_watch_lock_ ACQUIRED_BEFORE(art::Locks::abort_lock_);
+  std::unordered_map<art::ArtField*, FieldWatch> field_watches_ GUARDED_BY(field_watch_lock_);
+  uint64_t next_field_watch_id_ GUARDED_BY(field_watch_lock_);
+  // Number of watched fields, checked without the lock on class prepare.
+  std::atomic<size_t> num_field_watches_;
+
   // The MethodInspectionCallback we use to tell the runtime if we care about particular methods.
   JvmtiMethodInspectionCallback inspection_callback_;
 
@@ -988,6 +988,10 @@ static DeoptRequirement GetDeoptRequirement(ArtJvmtiEvent event, jthread thread)
   switch (event) {
     case ArtJvmtiEvent::kBreakpoint:
     case ArtJvmtiEvent::kException:
+    // Only the methods that might access a watched field are deoptimized, see
+    // DeoptManager::AddFieldWatch.
+    case ArtJvmtiEvent::kFieldModification:
+    case ArtJvmtiEvent::kFieldAccess:
       return DeoptRequirement::kLimited;
     // TODO MethodEntry is needed due to inconsistencies between the interpreter and the trampoline
     // in how to handle exceptions.
@@ -995,8 +999,6 @@ static DeoptRequirement GetDeoptRequirement(ArtJvmtiEvent event, jthread thread)
     case ArtJvmtiEvent::kExceptionCatch:
       return DeoptRequirement::kFull;
     case ArtJvmtiEvent::kMethodExit:
-    case ArtJvmtiEvent::kFieldModification:
-    case ArtJvmtiEvent::kFieldAccess:
     case ArtJvmtiEvent::kSingleStep:
     case ArtJvmtiEvent::kFramePop:
       return thread == nullptr ? DeoptRequirement::kFull : DeoptRequirement::kThread;
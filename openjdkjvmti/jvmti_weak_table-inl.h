@@ -35,6 +35,7 @@
 #include "jvmti_weak_table.h"
 
 #include <limits>
+#include <vector>
 
 #include <android-base/logging.h>
 
@@ -170,8 +171,7 @@ bool JvmtiWeakTable<T>::SetLocked(art::Thread* self, art::ObjPtr<art::mirror::Ob
   }
 
   // New element.
-  auto insert_it = tagged_objects_.emplace(art::GcRoot<art::mirror::Object>(obj), new_tag);
-  DCHECK(insert_it.second);
+  tagged_objects_.insert(std::make_pair(art::GcRoot<art::mirror::Object>(obj), new_tag));
   return false;
 }
 
@@ -210,14 +210,9 @@ void JvmtiWeakTable<T>::SweepImpl(art::IsMarkedVisitor* visitor) {
 template <typename T>
 template <typename Updater, typename JvmtiWeakTable<T>::TableUpdateNullTarget kTargetNull>
 ALWAYS_INLINE inline void JvmtiWeakTable<T>::UpdateTableWith(Updater& updater) {
-  // We optimistically hope that elements will still be well-distributed when re-inserting them.
-  // So play with the map mechanics, and postpone rehashing. This avoids the need of a side
-  // vector and two passes.
-  float original_max_load_factor = tagged_objects_.max_load_factor();
-  tagged_objects_.max_load_factor(std::numeric_limits<float>::max());
-  // For checking that a max load-factor actually does what we expect.
-  size_t original_bucket_count = tagged_objects_.bucket_count();
-
+  // Entries cannot be re-inserted while iterating over the open addressing table, so collect
+  // the moved ones and insert them at the end.
+  std::vector<std::pair<art::mirror::Object*, T>> moved;
   for (auto it = tagged_objects_.begin(); it != tagged_objects_.end();) {
     DCHECK(!it->first.IsNull());
     art::mirror::Object* original_obj = it->first.template Read<art::kWithoutReadBarrier>();
@@ -229,8 +224,7 @@ ALWAYS_INLINE inline void JvmtiWeakTable<T>::UpdateTableWith(Updater& updater) {
         T tag = it->second;
         it = tagged_objects_.erase(it);
         if (target_obj != nullptr) {
-          tagged_objects_.emplace(art::GcRoot<art::mirror::Object>(target_obj), tag);
-          DCHECK_EQ(original_bucket_count, tagged_objects_.bucket_count());
+          moved.emplace_back(target_obj, tag);
         } else if (kTargetNull == kCallHandleNull) {
           HandleNullSweep(tag);
         }
@@ -240,8 +234,10 @@ ALWAYS_INLINE inline void JvmtiWeakTable<T>::UpdateTableWith(Updater& updater) {
     it++;
   }
 
-  tagged_objects_.max_load_factor(original_max_load_factor);
-  // TODO: consider rehash here.
+  for (const auto& entry : moved) {
+    tagged_objects_.insert(
+        std::make_pair(art::GcRoot<art::mirror::Object>(entry.first), entry.second));
+  }
 }
 
 template <typename T>
@@ -302,6 +298,21 @@ struct JvmtiWeakTable<T>::ReleasableContainer {
   size_t capacity;
 };
 
+template <typename T>
+template <typename Visitor>
+void JvmtiWeakTable<T>::VisitTaggedObjects(const Visitor& visitor) {
+  art::Thread* self = art::Thread::Current();
+  art::MutexLock mu(self, allow_disallow_lock_);
+  Wait(self);
+
+  for (auto& pair : tagged_objects_) {
+    art::ObjPtr<art::mirror::Object> obj = pair.first.template Read<art::kWithReadBarrier>();
+    if (obj != nullptr) {
+      visitor(obj, pair.second);
+    }
+  }
+}
+
 template <typename T>
 jvmtiError JvmtiWeakTable<T>::GetTaggedObjects(jvmtiEnv* jvmti_env,
                                                jint tag_count,
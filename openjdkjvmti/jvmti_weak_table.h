@@ -32,9 +32,10 @@
 #ifndef ART_OPENJDKJVMTI_JVMTI_WEAK_TABLE_H_
 #define ART_OPENJDKJVMTI_JVMTI_WEAK_TABLE_H_
 
-#include <unordered_map>
+#include <utility>
 
 #include "base/globals.h"
+#include "base/hash_map.h"
 #include "base/macros.h"
 #include "base/mutex.h"
 #include "gc/system_weak.h"
@@ -113,6 +114,13 @@ class JvmtiWeakTable : public art::gc::SystemWeakHolder {
       REQUIRES_SHARED(art::Locks::mutator_lock_)
       REQUIRES(!allow_disallow_lock_);
 
+  // Call `visitor(obj, tag)` for each live object with a mapping. The visitor must not access
+  // the table.
+  template <typename Visitor>
+  ALWAYS_INLINE void VisitTaggedObjects(const Visitor& visitor)
+      REQUIRES_SHARED(art::Locks::mutator_lock_)
+      REQUIRES(!allow_disallow_lock_);
+
   // Locking functions, to allow coarse-grained locking and amortization.
   ALWAYS_INLINE  void Lock() ACQUIRE(allow_disallow_lock_);
   ALWAYS_INLINE void Unlock() RELEASE(allow_disallow_lock_);
@@ -198,7 +206,9 @@ class JvmtiWeakTable : public art::gc::SystemWeakHolder {
   struct HashGcRoot {
     size_t operator()(const art::GcRoot<art::mirror::Object>& r) const
         REQUIRES_SHARED(art::Locks::mutator_lock_) {
-      return reinterpret_cast<uintptr_t>(r.Read<art::kWithoutReadBarrier>());
+      // Drop the alignment bits, the table uses the hash modulo the number of buckets.
+      return reinterpret_cast<uintptr_t>(r.Read<art::kWithoutReadBarrier>()) >>
+          art::kObjectAlignmentShift;
     }
   };
 
@@ -210,12 +220,25 @@ class JvmtiWeakTable : public art::gc::SystemWeakHolder {
     }
   };
 
-  using TagAllocator = JvmtiAllocator<std::pair<const art::GcRoot<art::mirror::Object>, T>>;
-  std::unordered_map<art::GcRoot<art::mirror::Object>,
-                     T,
-                     HashGcRoot,
-                     EqGcRoot,
-                     TagAllocator> tagged_objects_
+  using Entry = std::pair<art::GcRoot<art::mirror::Object>, T>;
+
+  struct EmptyEntry {
+    void MakeEmpty(Entry& entry) const {
+      entry.first = art::GcRoot<art::mirror::Object>();
+    }
+    bool IsEmpty(const Entry& entry) const {
+      return entry.first.IsNull();
+    }
+  };
+
+  // Open addressing keeps the entries in one array, so sweeping the table on every GC is a
+  // linear scan rather than a walk over separately allocated nodes.
+  art::HashMap<art::GcRoot<art::mirror::Object>,
+               T,
+               EmptyEntry,
+               HashGcRoot,
+               EqGcRoot,
+               JvmtiAllocator<Entry>> tagged_objects_
       GUARDED_BY(allow_disallow_lock_)
       GUARDED_BY(art::Locks::mutator_lock_);
   // To avoid repeatedly scanning the whole table, remember if we did that since the last sweep.
@@ -38,6 +38,8 @@
 #include "base/mutex.h"
 #include "deopt_manager.h"
 #include "events-inl.h"
+#include "flight_recorder.h"
+#include "gc/heap.h"
 #include "runtime_callbacks.h"
 #include "scoped_thread_state_change-inl.h"
 #include "thread-current-inl.h"
@@ -90,4 +92,71 @@ jvmtiError DumpUtil::DumpInternalState(jvmtiEnv *jvmti, char **data) {
   return err;
 }
 
+jvmtiError DumpUtil::GetFlightRecorderDump(jvmtiEnv* jvmti, char** data) {
+  art::Thread* self = art::Thread::Current();
+  if (jvmti == nullptr || self == nullptr) {
+    return ERR(INVALID_ENVIRONMENT);
+  } else if (data == nullptr) {
+    return ERR(NULL_POINTER);
+  }
+  art::FlightRecorder* flight_recorder = art::Runtime::Current()->GetFlightRecorder();
+  if (flight_recorder == nullptr) {
+    return ERR(NOT_AVAILABLE);
+  }
+
+  std::stringstream ss;
+  flight_recorder->Dump(ss);
+
+  jvmtiError err = OK;
+  JvmtiUniquePtr<char[]> res = CopyString(jvmti, ss.str().c_str(), &err);
+  *data = res.release();
+  return err;
+}
+
+jvmtiError DumpUtil::GetDuplicateStrings(jvmtiEnv* jvmti, jint max_entries, char** data) {
+  art::Thread* self = art::Thread::Current();
+  if (jvmti == nullptr || self == nullptr) {
+    return ERR(INVALID_ENVIRONMENT);
+  } else if (data == nullptr) {
+    return ERR(NULL_POINTER);
+  } else if (max_entries < 0) {
+    return ERR(ILLEGAL_ARGUMENT);
+  }
+
+  std::stringstream ss;
+  {
+    art::ScopedObjectAccess soa(self);
+    art::Runtime::Current()->GetHeap()->DumpDuplicateStrings(ss,
+                                                             static_cast<size_t>(max_entries));
+  }
+
+  jvmtiError err = OK;
+  JvmtiUniquePtr<char[]> res = CopyString(jvmti, ss.str().c_str(), &err);
+  *data = res.release();
+  return err;
+}
+
+jvmtiError DumpUtil::GetSharedDirtyObjects(jvmtiEnv* jvmti, jint max_entries, char** data) {
+  art::Thread* self = art::Thread::Current();
+  if (jvmti == nullptr || self == nullptr) {
+    return ERR(INVALID_ENVIRONMENT);
+  } else if (data == nullptr) {
+    return ERR(NULL_POINTER);
+  } else if (max_entries < 0) {
+    return ERR(ILLEGAL_ARGUMENT);
+  }
+
+  std::stringstream ss;
+  {
+    art::ScopedObjectAccess soa(self);
+    art::Runtime::Current()->GetHeap()->DumpSharedDirtyObjects(ss,
+                                                               static_cast<size_t>(max_entries));
+  }
+
+  jvmtiError err = OK;
+  JvmtiUniquePtr<char[]> res = CopyString(jvmti, ss.str().c_str(), &err);
+  *data = res.release();
+  return err;
+}
+
 }  // namespace openjdkjvmti
@@ -45,6 +45,9 @@ class DumpUtil {
   static void Unregister();
 
   static jvmtiError DumpInternalState(jvmtiEnv* jvmti, char** data);
+  static jvmtiError GetFlightRecorderDump(jvmtiEnv* jvmti, char** data);
+  static jvmtiError GetDuplicateStrings(jvmtiEnv* jvmti, jint max_entries, char** data);
+  static jvmtiError GetSharedDirtyObjects(jvmtiEnv* jvmti, jint max_entries, char** data);
 };
 
 }  // namespace openjdkjvmti
@@ -195,6 +195,26 @@ jvmtiError ExtensionUtil::GetExtensionFunctions(jvmtiEnv* env,
     return error;
   }
 
+  error = add_extension(
+      reinterpret_cast<jvmtiExtensionFunction>(HeapExtensions::GetGcCycleRecords),
+      "com.android.art.gc.get_gc_cycle_records",
+      "Retrieves records of the most recent completed GC cycles, oldest first, without blocking"
+      " the GC. Each record is fields_per_record jlongs: end time (ns, monotonic clock), duration"
+      " (ns), total pause time (ns), number of pauses, the first four pause times (ns), GC cause,"
+      " GC type, collector type, freed objects, freed bytes, freed large objects, freed large"
+      " object bytes, bytes allocated after the GC and the region space footprint after the GC"
+      " in bytes. New fields are only ever appended. The records must be deallocated by the"
+      " caller.",
+      {
+          { "record_count", JVMTI_KIND_OUT, JVMTI_TYPE_JINT, false },
+          { "fields_per_record", JVMTI_KIND_OUT, JVMTI_TYPE_JINT, false },
+          { "records", JVMTI_KIND_ALLOC_BUF, JVMTI_TYPE_JLONG, false },
+      },
+      { ERR(NULL_POINTER), ERR(OUT_OF_MEMORY) });
+  if (error != ERR(NONE)) {
+    return error;
+  }
+
   error = add_extension(
       reinterpret_cast<jvmtiExtensionFunction>(AllocUtil::GetGlobalJvmtiAllocationState),
       "com.android.art.alloc.get_global_jvmti_allocation_state",
@@ -276,6 +296,27 @@ jvmtiError ExtensionUtil::GetExtensionFunctions(jvmtiEnv* env,
     return error;
   }
 
+  // Monitor contention profile.
+  error = add_extension(
+      reinterpret_cast<jvmtiExtensionFunction>(MonitorUtil::GetContentionProfile),
+      "com.android.art.monitor.get_contention_profile",
+      "Retrieves the time threads spent blocked on contended monitors, aggregated by the method"
+      " and dex pc that blocked, most waited on first. For each of the site_count sites the"
+      " methods array holds the method and site_data holds fields_per_site jlongs: the dex pc,"
+      " the number of waits, the total and the longest wait time in ns, then a histogram of the"
+      " wait times where bucket i counts the waits of [2^i, 2^(i+1)) microseconds. New fields"
+      " are only ever appended. Both arrays must be deallocated by the caller.",
+      {
+          { "site_count", JVMTI_KIND_OUT, JVMTI_TYPE_JINT, false },
+          { "methods", JVMTI_KIND_ALLOC_BUF, JVMTI_TYPE_JMETHODID, false },
+          { "fields_per_site", JVMTI_KIND_OUT, JVMTI_TYPE_JINT, false },
+          { "site_data", JVMTI_KIND_ALLOC_BUF, JVMTI_TYPE_JLONG, false },
+      },
+      { ERR(NULL_POINTER), ERR(OUT_OF_MEMORY) });
+  if (error != ERR(NONE)) {
+    return error;
+  }
+
   // GetLastError extension
   error = add_extension(
       reinterpret_cast<jvmtiExtensionFunction>(LogUtil::GetLastError),
@@ -327,6 +368,54 @@ jvmtiError ExtensionUtil::GetExtensionFunctions(jvmtiEnv* env,
     return error;
   }
 
+  // Flight recorder.
+  error = add_extension(
+      reinterpret_cast<jvmtiExtensionFunction>(DumpUtil::GetFlightRecorderDump),
+      "com.android.art.misc.get_flight_recorder_dump",
+      "Gets the most recent runtime events (GCs, JIT compilations, deoptimizations, contended"
+      " monitor enters, class definitions and suspensions of all threads) kept by each thread,"
+      " oldest first, as human readable text. Only available if the runtime was started with"
+      " -XX:FlightRecorder.",
+      {
+          { "msg", JVMTI_KIND_ALLOC_BUF, JVMTI_TYPE_CCHAR, false },
+      },
+      { ERR(NULL_POINTER), ERR(NOT_AVAILABLE) });
+  if (error != ERR(NONE)) {
+    return error;
+  }
+
+  // Duplicate strings.
+  error = add_extension(
+      reinterpret_cast<jvmtiExtensionFunction>(DumpUtil::GetDuplicateStrings),
+      "com.android.art.heap.get_duplicate_strings",
+      "Counts the strings in the heap which have the same contents as another one, and lists"
+      " the 'max_entries' which use the most memory, as human readable text. All threads are"
+      " suspended while the heap is walked.",
+      {
+          { "max_entries", JVMTI_KIND_IN, JVMTI_TYPE_JINT, false },
+          { "msg", JVMTI_KIND_ALLOC_BUF, JVMTI_TYPE_CCHAR, false },
+      },
+      { ERR(NULL_POINTER), ERR(ILLEGAL_ARGUMENT) });
+  if (error != ERR(NONE)) {
+    return error;
+  }
+
+  // Boot image and zygote objects dirtied by this process.
+  error = add_extension(
+      reinterpret_cast<jvmtiExtensionFunction>(DumpUtil::GetSharedDirtyObjects),
+      "com.android.art.heap.get_shared_dirty_objects",
+      "Finds the boot image and zygote space objects which lie on pages this process has written"
+      " to, and lists the 'max_entries' classes with the most such objects, as human readable"
+      " text. All threads are suspended while the heap is walked.",
+      {
+          { "max_entries", JVMTI_KIND_IN, JVMTI_TYPE_JINT, false },
+          { "msg", JVMTI_KIND_ALLOC_BUF, JVMTI_TYPE_CCHAR, false },
+      },
+      { ERR(NULL_POINTER), ERR(ILLEGAL_ARGUMENT) });
+  if (error != ERR(NONE)) {
+    return error;
+  }
+
   // Copy into output buffer.
 
   *extension_count_ptr = ext_vector.size();
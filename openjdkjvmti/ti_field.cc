@@ -34,6 +34,7 @@
 #include "art_field-inl.h"
 #include "art_jvmti.h"
 #include "base/enums.h"
+#include "deopt_manager.h"
 #include "dex/dex_file_annotations.h"
 #include "dex/modifiers.h"
 #include "jni/jni_internal.h"
@@ -189,69 +190,89 @@ jvmtiError FieldUtil::IsFieldSynthetic(jvmtiEnv* env ATTRIBUTE_UNUSED,
 
 jvmtiError FieldUtil::SetFieldModificationWatch(jvmtiEnv* jenv, jclass klass, jfieldID field) {
   ArtJvmTiEnv* env = ArtJvmTiEnv::AsArtJvmTiEnv(jenv);
-  art::WriterMutexLock lk(art::Thread::Current(), env->event_info_mutex_);
   if (klass == nullptr) {
     return ERR(INVALID_CLASS);
   }
   if (field == nullptr) {
     return ERR(INVALID_FIELDID);
   }
-  auto res_pair = env->modify_watched_fields.insert(art::jni::DecodeArtField(field));
-  if (!res_pair.second) {
-    // Didn't get inserted because it's already present!
-    return ERR(DUPLICATE);
+  art::ArtField* art_field = art::jni::DecodeArtField(field);
+  {
+    art::WriterMutexLock lk(art::Thread::Current(), env->event_info_mutex_);
+    auto res_pair = env->modify_watched_fields.insert(art_field);
+    if (!res_pair.second) {
+      // Didn't get inserted because it's already present!
+      return ERR(DUPLICATE);
+    }
   }
+  art::ScopedObjectAccess soa(art::Thread::Current());
+  DeoptManager::Get()->AddFieldWatch(art_field);
   return OK;
 }
 
 jvmtiError FieldUtil::ClearFieldModificationWatch(jvmtiEnv* jenv, jclass klass, jfieldID field) {
   ArtJvmTiEnv* env = ArtJvmTiEnv::AsArtJvmTiEnv(jenv);
-  art::WriterMutexLock lk(art::Thread::Current(), env->event_info_mutex_);
   if (klass == nullptr) {
     return ERR(INVALID_CLASS);
   }
   if (field == nullptr) {
     return ERR(INVALID_FIELDID);
   }
-  auto pos = env->modify_watched_fields.find(art::jni::DecodeArtField(field));
-  if (pos == env->modify_watched_fields.end()) {
-    return ERR(NOT_FOUND);
+  art::ArtField* art_field = art::jni::DecodeArtField(field);
+  {
+    art::WriterMutexLock lk(art::Thread::Current(), env->event_info_mutex_);
+    auto pos = env->modify_watched_fields.find(art_field);
+    if (pos == env->modify_watched_fields.end()) {
+      return ERR(NOT_FOUND);
+    }
+    env->modify_watched_fields.erase(pos);
   }
-  env->modify_watched_fields.erase(pos);
+  art::ScopedObjectAccess soa(art::Thread::Current());
+  DeoptManager::Get()->RemoveFieldWatch(art_field);
   return OK;
 }
 
 jvmtiError FieldUtil::SetFieldAccessWatch(jvmtiEnv* jenv, jclass klass, jfieldID field) {
   ArtJvmTiEnv* env = ArtJvmTiEnv::AsArtJvmTiEnv(jenv);
-  art::WriterMutexLock lk(art::Thread::Current(), env->event_info_mutex_);
   if (klass == nullptr) {
     return ERR(INVALID_CLASS);
   }
   if (field == nullptr) {
     return ERR(INVALID_FIELDID);
   }
-  auto res_pair = env->access_watched_fields.insert(art::jni::DecodeArtField(field));
-  if (!res_pair.second) {
-    // Didn't get inserted because it's already present!
-    return ERR(DUPLICATE);
+  art::ArtField* art_field = art::jni::DecodeArtField(field);
+  {
+    art::WriterMutexLock lk(art::Thread::Current(), env->event_info_mutex_);
+    auto res_pair = env->access_watched_fields.insert(art_field);
+    if (!res_pair.second) {
+      // Didn't get inserted because it's already present!
+      return ERR(DUPLICATE);
+    }
   }
+  art::ScopedObjectAccess soa(art::Thread::Current());
+  DeoptManager::Get()->AddFieldWatch(art_field);
   return OK;
 }
 
 jvmtiError FieldUtil::ClearFieldAccessWatch(jvmtiEnv* jenv, jclass klass, jfieldID field) {
   ArtJvmTiEnv* env = ArtJvmTiEnv::AsArtJvmTiEnv(jenv);
-  art::WriterMutexLock lk(art::Thread::Current(), env->event_info_mutex_);
   if (klass == nullptr) {
     return ERR(INVALID_CLASS);
   }
   if (field == nullptr) {
     return ERR(INVALID_FIELDID);
   }
-  auto pos = env->access_watched_fields.find(art::jni::DecodeArtField(field));
-  if (pos == env->access_watched_fields.end()) {
-    return ERR(NOT_FOUND);
+  art::ArtField* art_field = art::jni::DecodeArtField(field);
+  {
+    art::WriterMutexLock lk(art::Thread::Current(), env->event_info_mutex_);
+    auto pos = env->access_watched_fields.find(art_field);
+    if (pos == env->access_watched_fields.end()) {
+      return ERR(NOT_FOUND);
+    }
+    env->access_watched_fields.erase(pos);
   }
-  env->access_watched_fields.erase(pos);
+  art::ScopedObjectAccess soa(art::Thread::Current());
+  DeoptManager::Get()->RemoveFieldWatch(art_field);
   return OK;
 }
 
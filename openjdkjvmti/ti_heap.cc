@@ -23,6 +23,7 @@
 #include "class_linker.h"
 #include "dex/primitive.h"
 #include "gc/heap-visit-objects-inl.h"
+#include "gc/gc_cycle_records.h"
 #include "gc/heap.h"
 #include "gc_root-inl.h"
 #include "java_frame_root_info.h"
@@ -643,6 +644,38 @@ struct HeapFilter {
   const bool any_filter;
 };
 
+// Visit the objects that have a tag in `tag_table`, with the same guarantees as
+// Heap::VisitObjects(): objects do not move while the visitor runs.
+template <typename Visitor>
+void VisitTaggedObjects(ObjectTagTable* tag_table, const Visitor& visitor)
+    REQUIRES_SHARED(art::Locks::mutator_lock_) {
+  // Snapshot the table first, the visitor may update tags.
+  auto visit_snapshot = [&]() REQUIRES_SHARED(art::Locks::mutator_lock_) {
+    std::vector<art::mirror::Object*> objects;
+    tag_table->VisitTaggedObjects(
+        [&](art::ObjPtr<art::mirror::Object> obj, jlong tag ATTRIBUTE_UNUSED) {
+          objects.push_back(obj.Ptr());
+        });
+    for (art::mirror::Object* obj : objects) {
+      visitor(obj);
+    }
+  };
+  art::Thread* self = art::Thread::Current();
+  art::gc::Heap* heap = art::Runtime::Current()->GetHeap();
+  if (heap->IsGcConcurrentAndMoving()) {
+    heap->IncrementDisableMovingGC(self);
+    {
+      art::ScopedThreadSuspension sts(self, art::kWaitingForVisitObjects);
+      art::ScopedSuspendAll ssa(__FUNCTION__);
+      visit_snapshot();
+    }
+    heap->DecrementDisableMovingGC(self);
+  } else {
+    art::ScopedAssertNoThreadSuspension ants("Visiting tagged objects");
+    visit_snapshot();
+  }
+}
+
 }  // namespace
 
 void HeapUtil::Register() {
@@ -743,11 +776,18 @@ static jvmtiError DoIterateThroughHeap(T fn,
 
     art::ScopedAssertNoThreadSuspension no_suspension("IterateThroughHeapCallback");
 
+    // Check the class filter first, it does not need the tag table.
+    art::ObjPtr<art::mirror::Class> klass = obj->GetClass();
+    if (filter_klass != nullptr) {
+      if (filter_klass != klass) {
+        return;
+      }
+    }
+
     jlong tag = 0;
     tag_table->GetTag(obj, &tag);
 
     jlong class_tag = 0;
-    art::ObjPtr<art::mirror::Class> klass = obj->GetClass();
     tag_table->GetTag(klass.Ptr(), &class_tag);
     // For simplicity, even if we find a tag = 0, assume 0 = not tagged.
 
@@ -755,12 +795,6 @@ static jvmtiError DoIterateThroughHeap(T fn,
       return;
     }
 
-    if (filter_klass != nullptr) {
-      if (filter_klass != klass) {
-        return;
-      }
-    }
-
     jlong size = obj->SizeOf();
 
     jint length = -1;
@@ -791,7 +825,13 @@ static jvmtiError DoIterateThroughHeap(T fn,
       stop_reports = ReportPrimitiveField::Report(obj, tag_table, callbacks, user_data);
     }
   };
-  art::Runtime::Current()->GetHeap()->VisitObjects(visitor);
+  if (heap_filter.filter_out_untagged) {
+    // Only tagged objects can be reported. Agents tracking a few objects in a big heap
+    // use this, so walk the tag table instead of the whole heap.
+    VisitTaggedObjects(tag_table, visitor);
+  } else {
+    art::Runtime::Current()->GetHeap()->VisitObjects(visitor);
+  }
 
   return ERR(NONE);
 }
@@ -1585,4 +1625,31 @@ jvmtiError HeapExtensions::IterateThroughHeapExt(jvmtiEnv* env,
                               user_data);
 }
 
+jvmtiError HeapExtensions::GetGcCycleRecords(jvmtiEnv* env,
+                                             jint* record_count,
+                                             jint* fields_per_record,
+                                             jlong** records,
+                                             ...) {
+  if (record_count == nullptr || fields_per_record == nullptr || records == nullptr) {
+    return ERR(NULL_POINTER);
+  }
+  // Reading the records never blocks the GC, so there is no need to synchronize with it.
+  std::vector<art::gc::GcCycleRecord> gc_records =
+      art::Runtime::Current()->GetHeap()->GetGcCycleRecords().GetRecords();
+  constexpr size_t kFieldsPerRecord = sizeof(art::gc::GcCycleRecord) / sizeof(jlong);
+  jvmtiError error;
+  JvmtiUniquePtr<jlong[]> data =
+      AllocJvmtiUniquePtr<jlong[]>(env, gc_records.size() * kFieldsPerRecord, &error);
+  if (data == nullptr && !gc_records.empty()) {
+    return error;
+  }
+  if (!gc_records.empty()) {
+    memcpy(data.get(), gc_records.data(), gc_records.size() * sizeof(art::gc::GcCycleRecord));
+  }
+  *record_count = static_cast<jint>(gc_records.size());
+  *fields_per_record = static_cast<jint>(kFieldsPerRecord);
+  *records = data.release();
+  return ERR(NONE);
+}
+
 }  // namespace openjdkjvmti
@@ -72,6 +72,12 @@ class HeapExtensions {
                                                   jclass klass,
                                                   const jvmtiHeapCallbacks* callbacks,
                                                   const void* user_data);
+
+  static jvmtiError JNICALL GetGcCycleRecords(jvmtiEnv* env,
+                                              jint* record_count,
+                                              jint* fields_per_record,
+                                              jlong** records,
+                                              ...);
 };
 
 }  // namespace openjdkjvmti
@@ -38,8 +38,10 @@
 
 #include "art_jvmti.h"
 #include "gc_root-inl.h"
+#include "jni/jni_internal.h"
 #include "mirror/object-inl.h"
 #include "monitor.h"
+#include "monitor_contention_profile.h"
 #include "runtime.h"
 #include "scoped_thread_state_change-inl.h"
 #include "thread-current-inl.h"
@@ -434,4 +436,52 @@ jvmtiError MonitorUtil::GetCurrentContendedMonitor(jvmtiEnv* env ATTRIBUTE_UNUSE
   return OK;
 }
 
+jvmtiError MonitorUtil::GetContentionProfile(jvmtiEnv* env,
+                                              jint* site_count,
+                                              jmethodID** methods,
+                                              jint* fields_per_site,
+                                              jlong** site_data,
+                                              ...) {
+  if (site_count == nullptr ||
+      methods == nullptr ||
+      fields_per_site == nullptr ||
+      site_data == nullptr) {
+    return ERR(NULL_POINTER);
+  }
+  // dex pc, wait count, total and maximum wait time, then the histogram buckets.
+  constexpr size_t kFieldsPerSite = 4u + art::MonitorContentionProfile::kNumBuckets;
+  // Keep the methods from being unloaded while we encode them.
+  art::ScopedObjectAccess soa(art::Thread::Current());
+  std::vector<art::MonitorContentionProfile::SiteInfo> sites =
+      art::Runtime::Current()->GetMonitorContentionProfile()->GetSites();
+  jvmtiError error;
+  JvmtiUniquePtr<jmethodID[]> out_methods =
+      AllocJvmtiUniquePtr<jmethodID[]>(env, sites.size(), &error);
+  if (out_methods == nullptr && !sites.empty()) {
+    return error;
+  }
+  JvmtiUniquePtr<jlong[]> out_data =
+      AllocJvmtiUniquePtr<jlong[]>(env, sites.size() * kFieldsPerSite, &error);
+  if (out_data == nullptr && !sites.empty()) {
+    return error;
+  }
+  for (size_t i = 0; i < sites.size(); ++i) {
+    const art::MonitorContentionProfile::SiteInfo& info = sites[i];
+    out_methods[i] = art::jni::EncodeArtMethod(info.method);
+    jlong* data = &out_data[i * kFieldsPerSite];
+    data[0] = static_cast<jlong>(info.dex_pc);
+    data[1] = static_cast<jlong>(info.count);
+    data[2] = static_cast<jlong>(info.total_wait_ns);
+    data[3] = static_cast<jlong>(info.max_wait_ns);
+    for (size_t j = 0; j < art::MonitorContentionProfile::kNumBuckets; ++j) {
+      data[4u + j] = static_cast<jlong>(info.buckets[j]);
+    }
+  }
+  *site_count = static_cast<jint>(sites.size());
+  *methods = out_methods.release();
+  *fields_per_site = static_cast<jint>(kFieldsPerSite);
+  *site_data = out_data.release();
+  return OK;
+}
+
 }  // namespace openjdkjvmti
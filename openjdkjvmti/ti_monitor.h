@@ -56,6 +56,13 @@ class MonitorUtil {
   static jvmtiError RawMonitorNotifyAll(jvmtiEnv* env, jrawMonitorID monitor);
 
   static jvmtiError GetCurrentContendedMonitor(jvmtiEnv* env, jthread thr, jobject* monitor);
+
+  static jvmtiError JNICALL GetContentionProfile(jvmtiEnv* env,
+                                                 jint* site_count,
+                                                 jmethodID** methods,
+                                                 jint* fields_per_site,
+                                                 jlong** site_data,
+                                                 ...);
 };
 
 }  // namespace openjdkjvmti
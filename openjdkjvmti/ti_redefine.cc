@@ -209,56 +209,58 @@ class ObsoleteMap {
 
 // This visitor walks thread stacks and allocates and sets up the obsolete methods. It also does
 // some basic sanity checks that the obsolete method is sane.
+// Where the obsolete versions of the methods of one redefined class go.
+struct ObsoleteMethodsTarget {
+  ObsoleteMap* obsolete_map;
+  // The linear allocator we should use to make new methods.
+  art::LinearAlloc* allocator;
+};
+
+using ObsoletedMethodsMap = std::unordered_map<art::ArtMethod*, ObsoleteMethodsTarget>;
+
 class ObsoleteMethodStackVisitor : public art::StackVisitor {
  protected:
   ObsoleteMethodStackVisitor(
       art::Thread* thread,
-      art::LinearAlloc* allocator,
-      const std::unordered_set<art::ArtMethod*>& obsoleted_methods,
-      ObsoleteMap* obsolete_maps)
+      const ObsoletedMethodsMap& obsoleted_methods)
         : StackVisitor(thread,
                        /*context=*/nullptr,
                        StackVisitor::StackWalkKind::kIncludeInlinedFrames),
-          allocator_(allocator),
-          obsoleted_methods_(obsoleted_methods),
-          obsolete_maps_(obsolete_maps) { }
+          obsoleted_methods_(obsoleted_methods) { }
 
   ~ObsoleteMethodStackVisitor() override {}
 
  public:
-  // Returns true if we successfully installed obsolete methods on this thread, filling
-  // obsolete_maps_ with the translations if needed. Returns false and fills error_msg if we fail.
-  // The stack is cleaned up when we fail.
+  // Installs obsolete methods for all the obsoleted methods on this thread's stack, filling the
+  // obsolete maps of their classes with the translations if needed.
   static void UpdateObsoleteFrames(
       art::Thread* thread,
-      art::LinearAlloc* allocator,
-      const std::unordered_set<art::ArtMethod*>& obsoleted_methods,
-      ObsoleteMap* obsolete_maps)
+      const ObsoletedMethodsMap& obsoleted_methods)
         REQUIRES(art::Locks::mutator_lock_) {
-    ObsoleteMethodStackVisitor visitor(thread,
-                                       allocator,
-                                       obsoleted_methods,
-                                       obsolete_maps);
+    ObsoleteMethodStackVisitor visitor(thread, obsoleted_methods);
     visitor.WalkStack();
   }
 
   bool VisitFrame() override REQUIRES(art::Locks::mutator_lock_) {
     art::ScopedAssertNoThreadSuspension snts("Fixing up the stack for obsolete methods.");
     art::ArtMethod* old_method = GetMethod();
-    if (obsoleted_methods_.find(old_method) != obsoleted_methods_.end()) {
+    auto target = obsoleted_methods_.find(old_method);
+    if (target != obsoleted_methods_.end()) {
+      ObsoleteMap* obsolete_map = target->second.obsolete_map;
       // We cannot ensure that the right dex file is used in inlined frames so we don't support
       // redefining them.
       DCHECK(!IsInInlinedFrame()) << "Inlined frames are not supported when using redefinition: "
                                   << old_method->PrettyMethod() << " is inlined into "
                                   << GetOuterMethod()->PrettyMethod();
-      art::ArtMethod* new_obsolete_method = obsolete_maps_->FindObsoleteVersion(old_method);
+      art::ArtMethod* new_obsolete_method = obsolete_map->FindObsoleteVersion(old_method);
       if (new_obsolete_method == nullptr) {
         // Create a new Obsolete Method and put it in the list.
         art::Runtime* runtime = art::Runtime::Current();
         art::ClassLinker* cl = runtime->GetClassLinker();
         auto ptr_size = cl->GetImagePointerSize();
         const size_t method_size = art::ArtMethod::Size(ptr_size);
-        auto* method_storage = allocator_->Alloc(art::Thread::Current(), method_size);
+        auto* method_storage =
+            target->second.allocator->Alloc(art::Thread::Current(), method_size);
         CHECK(method_storage != nullptr) << "Unable to allocate storage for obsolete version of '"
                                          << old_method->PrettyMethod() << "'";
         new_obsolete_method = new (method_storage) art::ArtMethod();
@@ -267,7 +269,7 @@ class ObsoleteMethodStackVisitor : public art::StackVisitor {
         new_obsolete_method->SetIsObsolete();
         new_obsolete_method->SetDontCompile();
         cl->SetEntryPointsForObsoleteMethod(new_obsolete_method);
-        obsolete_maps_->RecordObsolete(old_method, new_obsolete_method);
+        obsolete_map->RecordObsolete(old_method, new_obsolete_method);
       }
       DCHECK(new_obsolete_method != nullptr);
       SetMethod(new_obsolete_method);
@@ -276,14 +278,11 @@ class ObsoleteMethodStackVisitor : public art::StackVisitor {
   }
 
  private:
-  // The linear allocator we should use to make new methods.
-  art::LinearAlloc* allocator_;
-  // The set of all methods which could be obsoleted.
-  const std::unordered_set<art::ArtMethod*>& obsoleted_methods_;
-  // A map from the original to the newly allocated obsolete method for frames on this thread. The
-  // values in this map are added to the obsolete_methods_ (and obsolete_dex_caches_) fields of
-  // the redefined classes ClassExt as it is filled.
-  ObsoleteMap* obsolete_maps_;
+  // All the methods which could be obsoleted, with the obsolete map of their class. The obsolete
+  // maps translate the original to the newly allocated obsolete methods. Their values are added to
+  // the obsolete_methods_ (and obsolete_dex_caches_) fields of the redefined classes ClassExt as
+  // they are filled.
+  const ObsoletedMethodsMap& obsoleted_methods_;
 };
 
 jvmtiError Redefiner::IsModifiableClass(jvmtiEnv* env ATTRIBUTE_UNUSED,
@@ -596,62 +595,65 @@ art::mirror::Object* Redefiner::ClassRedefinition::AllocateOrGetOriginalDexFile(
 }
 
 struct CallbackCtx {
-  ObsoleteMap* obsolete_map;
-  art::LinearAlloc* allocator;
-  std::unordered_set<art::ArtMethod*> obsolete_methods;
-
-  explicit CallbackCtx(ObsoleteMap* map, art::LinearAlloc* alloc)
-      : obsolete_map(map), allocator(alloc) {}
+  ObsoletedMethodsMap obsolete_methods;
 };
 
 void DoAllocateObsoleteMethodsCallback(art::Thread* t, void* vdata) NO_THREAD_SAFETY_ANALYSIS {
   CallbackCtx* data = reinterpret_cast<CallbackCtx*>(vdata);
-  ObsoleteMethodStackVisitor::UpdateObsoleteFrames(t,
-                                                   data->allocator,
-                                                   data->obsolete_methods,
-                                                   data->obsolete_map);
+  ObsoleteMethodStackVisitor::UpdateObsoleteFrames(t, data->obsolete_methods);
 }
 
 // This creates any ArtMethod* structures needed for obsolete methods and ensures that the stack is
-// updated so they will be run.
-// TODO Rewrite so we can do this only once regardless of how many redefinitions there are.
-void Redefiner::ClassRedefinition::FindAndAllocateObsoleteMethods(
-    art::ObjPtr<art::mirror::Class> art_klass) {
+// updated so they will be run. All the redefined classes are handled in a single walk of each
+// thread's stack since this happens while all threads are suspended.
+void Redefiner::FindAndAllocateObsoleteMethods(RedefinitionDataHolder& holder) {
   art::ScopedAssertNoThreadSuspension ns("No thread suspension during thread stack walking");
-  art::ObjPtr<art::mirror::ClassExt> ext = art_klass->GetExtData();
-  CHECK(ext->GetObsoleteMethods() != nullptr);
-  art::ClassLinker* linker = driver_->runtime_->GetClassLinker();
-  // This holds pointers to the obsolete methods map fields which are updated as needed.
-  ObsoleteMap map(ext->GetObsoleteMethods(), ext->GetObsoleteDexCaches(), art_klass->GetDexCache());
-  CallbackCtx ctx(&map, linker->GetAllocatorForClassLoader(art_klass->GetClassLoader()));
-  // Add all the declared methods to the map
-  for (auto& m : art_klass->GetDeclaredMethods(art::kRuntimePointerSize)) {
-    if (m.IsIntrinsic()) {
-      LOG(WARNING) << "Redefining intrinsic method " << m.PrettyMethod() << ". This may cause the "
-                   << "unexpected use of the original definition of " << m.PrettyMethod() << "in "
-                   << "methods that have already been compiled.";
+  art::ClassLinker* linker = runtime_->GetClassLinker();
+  // These hold pointers to the obsolete methods map fields which are updated as needed. Reserve
+  // them all up front since the visitor keeps pointers to them.
+  std::vector<ObsoleteMap> maps;
+  maps.reserve(redefinitions_.size());
+  CallbackCtx ctx;
+  for (RedefinitionDataIter data = holder.begin(); data != holder.end(); ++data) {
+    art::ObjPtr<art::mirror::Class> art_klass = data.GetMirrorClass();
+    art::ObjPtr<art::mirror::ClassExt> ext = art_klass->GetExtData();
+    CHECK(ext->GetObsoleteMethods() != nullptr);
+    DCHECK_LT(maps.size(), maps.capacity());
+    maps.emplace_back(
+        ext->GetObsoleteMethods(), ext->GetObsoleteDexCaches(), art_klass->GetDexCache());
+    ObsoleteMethodsTarget target = {
+        &maps.back(), linker->GetAllocatorForClassLoader(art_klass->GetClassLoader()) };
+    // Add all the declared methods to the map
+    for (auto& m : art_klass->GetDeclaredMethods(art::kRuntimePointerSize)) {
+      if (m.IsIntrinsic()) {
+        LOG(WARNING) << "Redefining intrinsic method " << m.PrettyMethod() << ". This may cause the "
+                     << "unexpected use of the original definition of " << m.PrettyMethod() << "in "
+                     << "methods that have already been compiled.";
+      }
+      // It is possible to simply filter out some methods where they cannot really become obsolete,
+      // such as native methods and keep their original (possibly optimized) implementations. We
+      // don't do this, however, since we would need to mark these functions (still in the classes
+      // declared_methods array) as obsolete so we will find the correct dex file to get meta-data
+      // from (for example about stack-frame size). Furthermore we would be unable to get some
+      // useful error checking from the interpreter which ensure we don't try to start executing
+      // obsolete methods.
+      ctx.obsolete_methods.emplace(&m, target);
     }
-    // It is possible to simply filter out some methods where they cannot really become obsolete,
-    // such as native methods and keep their original (possibly optimized) implementations. We don't
-    // do this, however, since we would need to mark these functions (still in the classes
-    // declared_methods array) as obsolete so we will find the correct dex file to get meta-data
-    // from (for example about stack-frame size). Furthermore we would be unable to get some useful
-    // error checking from the interpreter which ensure we don't try to start executing obsolete
-    // methods.
-    ctx.obsolete_methods.insert(&m);
   }
   {
-    art::MutexLock mu(driver_->self_, *art::Locks::thread_list_lock_);
-    art::ThreadList* list = art::Runtime::Current()->GetThreadList();
+    art::MutexLock mu(self_, *art::Locks::thread_list_lock_);
+    art::ThreadList* list = runtime_->GetThreadList();
     list->ForEach(DoAllocateObsoleteMethodsCallback, static_cast<void*>(&ctx));
     // After we've done walking all threads' stacks and updating method pointers on them,
     // update JIT data structures (used by the stack walk above) to point to the new methods.
-    art::jit::Jit* jit = art::Runtime::Current()->GetJit();
+    art::jit::Jit* jit = runtime_->GetJit();
     if (jit != nullptr) {
-      for (const ObsoleteMap::ObsoleteMethodPair& it : *ctx.obsolete_map) {
-        // Notify the JIT we are making this obsolete method. It will update the jit's internal
-        // structures to keep track of the new obsolete method.
-        jit->GetCodeCache()->MoveObsoleteMethod(it.old_method, it.obsolete_method);
+      for (const ObsoleteMap& map : maps) {
+        for (const ObsoleteMap::ObsoleteMethodPair& it : map) {
+          // Notify the JIT we are making this obsolete method. It will update the jit's internal
+          // structures to keep track of the new obsolete method.
+          jit->GetCodeCache()->MoveObsoleteMethod(it.old_method, it.obsolete_method);
+        }
       }
     }
   }
@@ -1437,16 +1439,14 @@ jvmtiError Redefiner::Run() {
   // TODO This isn't right. We need to change state without any chance of suspend ideally!
   art::ScopedThreadSuspension sts(self_, art::ThreadState::kNative);
   art::ScopedSuspendAll ssa("Final installation of redefined Classes!", /*long_suspend=*/true);
+  FindAndAllocateObsoleteMethods(holder);
   for (RedefinitionDataIter data = holder.begin(); data != holder.end(); ++data) {
     art::ScopedAssertNoThreadSuspension nts("Updating runtime objects for redefinition");
     ClassRedefinition& redef = data.GetRedefinition();
     if (data.GetSourceClassLoader() != nullptr) {
       ClassLoaderHelper::UpdateJavaDexFile(data.GetJavaDexFile(), data.GetNewDexFileCookie());
     }
-    art::ObjPtr<art::mirror::Class> klass = data.GetMirrorClass();
-    // TODO Rewrite so we don't do a stack walk for each and every class.
-    redef.FindAndAllocateObsoleteMethods(klass);
-    redef.UpdateClass(klass, data.GetNewDexCache(), data.GetOriginalDexFile());
+    redef.UpdateClass(data.GetMirrorClass(), data.GetNewDexCache(), data.GetOriginalDexFile());
   }
   RestoreObsoleteMethodMapsIfUnneeded(holder);
   // TODO We should check for if any of the redefined methods are intrinsic methods here and, if any
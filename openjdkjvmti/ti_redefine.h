@@ -143,9 +143,6 @@ class Redefiner {
         /*out*/RedefinitionDataIter* cur_data)
           REQUIRES_SHARED(art::Locks::mutator_lock_);
 
-    void FindAndAllocateObsoleteMethods(art::ObjPtr<art::mirror::Class> art_klass)
-        REQUIRES(art::Locks::mutator_lock_);
-
     // Checks that the dex file contains only the single expected class and that the top-level class
     // data has not been modified in an incompatible manner.
     bool CheckClass() REQUIRES_SHARED(art::Locks::mutator_lock_);
@@ -242,6 +239,8 @@ class Redefiner {
       REQUIRES_SHARED(art::Locks::mutator_lock_);
   void ReleaseAllDexFiles() REQUIRES_SHARED(art::Locks::mutator_lock_);
   void UnregisterAllBreakpoints() REQUIRES_SHARED(art::Locks::mutator_lock_);
+  void FindAndAllocateObsoleteMethods(RedefinitionDataHolder& holder)
+      REQUIRES(art::Locks::mutator_lock_);
   // Restores the old obsolete methods maps if it turns out they weren't needed (ie there were no
   // new obsolete methods).
   void RestoreObsoleteMethodMapsIfUnneeded(RedefinitionDataHolder& holder)
@@ -32,6 +32,7 @@
 #include "ti_stack.h"
 
 #include <algorithm>
+#include <functional>
 #include <list>
 #include <unordered_map>
 #include <vector>
@@ -343,12 +344,17 @@ struct GetAllStackTracesVectorClosure : public art::Closure {
   Data* data;
 };
 
+// Runs the stack walk on the threads accepted by `filter`, other threads are left alone so that
+// asking for a few stacks does not interrupt every thread.
 template <typename Data>
-static void RunCheckpointAndWait(Data* data, size_t max_frame_count)
+static void RunCheckpointAndWait(Data* data,
+                                 size_t max_frame_count,
+                                 const std::function<bool(art::Thread*)>& filter)
     REQUIRES_SHARED(art::Locks::mutator_lock_) {
   // Note: requires the mutator lock as the checkpoint requires the mutator lock.
   GetAllStackTracesVectorClosure<Data> closure(max_frame_count, data);
-  size_t barrier_count = art::Runtime::Current()->GetThreadList()->RunCheckpoint(&closure, nullptr);
+  size_t barrier_count =
+      art::Runtime::Current()->GetThreadList()->RunCheckpointOnThreads(&closure, filter);
   if (barrier_count == 0) {
     return;
   }
@@ -407,7 +413,9 @@ jvmtiError StackUtil::GetAllStackTraces(jvmtiEnv* env,
   art::Thread* current = art::Thread::Current();
   {
     art::ScopedObjectAccess soa(current);
-    RunCheckpointAndWait(&data, static_cast<size_t>(max_frame_count));
+    RunCheckpointAndWait(&data,
+                         static_cast<size_t>(max_frame_count),
+                         [](art::Thread*) { return true; });
   }
 
   // Convert the data into our output format.
@@ -567,7 +575,17 @@ jvmtiError StackUtil::GetThreadListStackTraces(jvmtiEnv* env,
     data.handles.push_back(hs.NewHandle(soa.Decode<art::mirror::Object>(thread_list[i])));
   }
 
-  RunCheckpointAndWait(&data, static_cast<size_t>(max_frame_count));
+  // Only the requested threads run the checkpoint.
+  auto is_requested = [&](art::Thread* thread) REQUIRES_SHARED(art::Locks::mutator_lock_) {
+    art::ObjPtr<art::mirror::Object> peer = thread->GetPeerFromOtherThread();
+    for (const art::Handle<art::mirror::Object>& handle : data.handles) {
+      if (peer == handle.Get()) {
+        return true;
+      }
+    }
+    return false;
+  };
+  RunCheckpointAndWait(&data, static_cast<size_t>(max_frame_count), is_requested);
 
   // Convert the data into our output format.
 
@@ -16,7 +16,14 @@
 
 #include "profile_assistant.h"
 
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
 #include "base/os.h"
+#include "base/time_utils.h"
 #include "base/unix_file/fd_file.h"
 
 namespace art {
@@ -29,12 +36,34 @@ static constexpr const uint32_t kMinNewClassesForCompilation = 50;
 static constexpr const uint32_t kMinNewClassesPercentChangeForCompilation = 2;
 
 
+bool ProfileAssistant::MergeProfileRange(size_t begin,
+                                         size_t end,
+                                         const ProfileLoaderFn& load_profile,
+                                         ProfileCompilationInfo* info) {
+  for (size_t i = begin; i != end; ++i) {
+    ProfileCompilationInfo cur_info;
+    if (!load_profile(i, &cur_info)) {
+      LOG(WARNING) << "Could not load profile file at index " << i;
+      return false;
+    }
+    if (!info->MergeWith(cur_info)) {
+      LOG(WARNING) << "Could not merge profile file at index " << i;
+      return false;
+    }
+  }
+  return true;
+}
+
 ProfileAssistant::ProcessingResult ProfileAssistant::ProcessProfilesInternal(
-        const std::vector<ScopedFlock>& profile_files,
+        size_t num_profiles,
+        const ProfileLoaderFn& load_profile,
         const ScopedFlock& reference_profile_file,
         const ProfileCompilationInfo::ProfileLoadFilterFn& filter_fn,
-        bool store_aggregation_counters) {
-  DCHECK(!profile_files.empty());
+        bool store_aggregation_counters,
+        bool store_uncompressed,
+        const MergeOptions& merge_options) {
+  DCHECK_NE(num_profiles, 0u);
+  uint64_t start_ns = NanoTime();
 
   ProfileCompilationInfo info;
   // Load the reference profile.
@@ -53,17 +82,51 @@ ProfileAssistant::ProcessingResult ProfileAssistant::ProcessProfilesInternal(
   uint32_t number_of_methods = info.GetNumberOfMethods();
   uint32_t number_of_classes = info.GetNumberOfResolvedClasses();
 
-  // Merge all current profiles.
-  for (size_t i = 0; i < profile_files.size(); i++) {
-    ProfileCompilationInfo cur_info;
-    if (!cur_info.Load(profile_files[i]->Fd(), /*merge_classes=*/ true, filter_fn)) {
-      LOG(WARNING) << "Could not load profile file at index " << i;
+  // Merge all current profiles. Only one input profile per thread is loaded at any time.
+  size_t num_threads = store_aggregation_counters
+      ? 1u
+      : std::min(std::max(merge_options.num_threads, static_cast<size_t>(1u)), num_profiles);
+  if (num_threads == 1u) {
+    if (!MergeProfileRange(0u, num_profiles, load_profile, &info)) {
       return kErrorBadProfiles;
     }
-    if (!info.MergeWith(cur_info)) {
-      LOG(WARNING) << "Could not merge profile file at index " << i;
+  } else {
+    std::vector<ProfileCompilationInfo> partial_infos(num_threads);
+    std::atomic<bool> success(true);
+    std::vector<std::thread> threads;
+    threads.reserve(num_threads);
+    for (size_t t = 0; t != num_threads; ++t) {
+      size_t begin = num_profiles * t / num_threads;
+      size_t end = num_profiles * (t + 1u) / num_threads;
+      threads.emplace_back([begin, end, &load_profile, &partial_infos, &success, t]() {
+        if (!MergeProfileRange(begin, end, load_profile, &partial_infos[t])) {
+          success.store(false, std::memory_order_relaxed);
+        }
+      });
+    }
+    for (std::thread& thread : threads) {
+      thread.join();
+    }
+    if (!success.load(std::memory_order_relaxed)) {
       return kErrorBadProfiles;
     }
+    // Merge the partial results in order so that dex files keep their first-come indexes.
+    for (size_t t = 0; t != num_threads; ++t) {
+      if (!info.MergeWith(partial_infos[t])) {
+        LOG(WARNING) << "Could not merge the profiles at indexes "
+                     << (num_profiles * t / num_threads) << " to "
+                     << (num_profiles * (t + 1u) / num_threads - 1u);
+        return kErrorBadProfiles;
+      }
+      partial_infos[t].ClearData();
+    }
+  }
+
+  if (merge_options.report_stats) {
+    struct rusage usage;
+    long max_rss_kb = (getrusage(RUSAGE_SELF, &usage) == 0) ? usage.ru_maxrss : -1;  // NOLINT
+    LOG(INFO) << "Merged " << num_profiles << " profiles with " << num_threads << " threads in "
+              << PrettyDuration(NanoTime() - start_ns) << ", peak RSS " << max_rss_kb << " KiB";
   }
 
   uint32_t min_change_in_methods_for_compilation = std::max(
@@ -80,6 +143,7 @@ ProfileAssistant::ProcessingResult ProfileAssistant::ProcessProfilesInternal(
   }
 
   // We were successful in merging all profile information. Update the reference profile.
+  info.SetStoreUncompressed(store_uncompressed);
   if (!reference_profile_file->ClearContent()) {
     PLOG(WARNING) << "Could not clear reference profile file";
     return kErrorIO;
@@ -132,7 +196,9 @@ ProfileAssistant::ProcessingResult ProfileAssistant::ProcessProfiles(
         const std::vector<int>& profile_files_fd,
         int reference_profile_file_fd,
         const ProfileCompilationInfo::ProfileLoadFilterFn& filter_fn,
-        bool store_aggregation_counters) {
+        bool store_aggregation_counters,
+        bool store_uncompressed,
+        const MergeOptions& merge_options) {
   DCHECK_GE(reference_profile_file_fd, 0);
 
   std::string error;
@@ -153,21 +219,31 @@ ProfileAssistant::ProcessingResult ProfileAssistant::ProcessProfiles(
     return kErrorCannotLock;
   }
 
-  return ProcessProfilesInternal(profile_files.Get(),
+  const std::vector<ScopedFlock>& locked_files = profile_files.Get();
+  auto load_profile = [&locked_files, &filter_fn](size_t index, ProfileCompilationInfo* info) {
+    return info->Load(locked_files[index]->Fd(), /*merge_classes=*/ true, filter_fn);
+  };
+  return ProcessProfilesInternal(locked_files.size(),
+                                 load_profile,
                                  reference_profile_file,
                                  filter_fn,
-                                 store_aggregation_counters);
+                                 store_aggregation_counters,
+                                 store_uncompressed,
+                                 merge_options);
 }
 
 ProfileAssistant::ProcessingResult ProfileAssistant::ProcessProfiles(
         const std::vector<std::string>& profile_files,
         const std::string& reference_profile_file,
         const ProfileCompilationInfo::ProfileLoadFilterFn& filter_fn,
-        bool store_aggregation_counters) {
+        bool store_aggregation_counters,
+        bool store_uncompressed,
+        const MergeOptions& merge_options) {
   std::string error;
 
-  ScopedFlockList profile_files_list(profile_files.size());
-  if (!profile_files_list.Init(profile_files, &error)) {
+  // When streaming, each profile file is locked only while it is loaded.
+  ScopedFlockList profile_files_list(merge_options.stream_inputs ? 0u : profile_files.size());
+  if (!merge_options.stream_inputs && !profile_files_list.Init(profile_files, &error)) {
     LOG(WARNING) << "Could not lock profile files: " << error;
     return kErrorCannotLock;
   }
@@ -179,10 +255,37 @@ ProfileAssistant::ProcessingResult ProfileAssistant::ProcessProfiles(
     return kErrorCannotLock;
   }
 
-  return ProcessProfilesInternal(profile_files_list.Get(),
+  const std::vector<ScopedFlock>& locked_files = profile_files_list.Get();
+  auto load_profile = [&](size_t index, ProfileCompilationInfo* info) {
+    ScopedFlock streamed_file;
+    const ScopedFlock* file = &streamed_file;
+    if (merge_options.stream_inputs) {
+      std::string open_error;
+      streamed_file = LockedFile::Open(
+          profile_files[index].c_str(), O_RDWR, /* block= */ true, &open_error);
+      if (streamed_file.get() == nullptr) {
+        LOG(WARNING) << "Could not lock profile file: " << open_error;
+        return false;
+      }
+    } else {
+      file = &locked_files[index];
+    }
+    if (!info->Load((*file)->Fd(), /*merge_classes=*/ true, filter_fn)) {
+      return false;
+    }
+    // The runtime may have appended recent data to a delta log next to the profile.
+    if (!info->MergeWithDeltaLog(profile_files[index], filter_fn)) {
+      LOG(WARNING) << "Could not merge the delta log of profile file at index " << index;
+    }
+    return true;
+  };
+  return ProcessProfilesInternal(profile_files.size(),
+                                 load_profile,
                                  locked_reference_profile_file,
                                  filter_fn,
-                                 store_aggregation_counters);
+                                 store_aggregation_counters,
+                                 store_uncompressed,
+                                 merge_options);
 }
 
 }  // namespace art
@@ -17,6 +17,7 @@
 #ifndef ART_PROFMAN_PROFILE_ASSISTANT_H_
 #define ART_PROFMAN_PROFILE_ASSISTANT_H_
 
+#include <functional>
 #include <string>
 #include <vector>
 
@@ -37,6 +38,20 @@ class ProfileAssistant {
     kErrorCannotLock = 4
   };
 
+  // Options for merging the input profiles.
+  struct MergeOptions {
+    // Number of threads loading and merging the input profiles. Each thread merges a contiguous
+    // range of the inputs and the partial results are merged in order, so the output does not
+    // depend on the number of threads. Profiles with aggregation counters are always merged
+    // sequentially since the counters depend on the merge order.
+    size_t num_threads = 1;
+    // Open and lock the profile files one at a time while merging them instead of locking them
+    // all up front. Only applies to profiles given by name.
+    bool stream_inputs = false;
+    // Log the time and the peak memory used by the merge.
+    bool report_stats = false;
+  };
+
   // Process the profile information present in the given files. Returns one of
   // ProcessingResult values depending on profile information and whether or not
   // the analysis ended up successfully (i.e. no errors during reading,
@@ -56,21 +71,38 @@ class ProfileAssistant {
       const std::string& reference_profile_file,
       const ProfileCompilationInfo::ProfileLoadFilterFn& filter_fn
           = ProfileCompilationInfo::ProfileFilterFnAcceptAll,
-      bool store_aggregation_counters = false);
+      bool store_aggregation_counters = false,
+      bool store_uncompressed = false,
+      const MergeOptions& merge_options = MergeOptions());
 
   static ProcessingResult ProcessProfiles(
       const std::vector<int>& profile_files_fd_,
       int reference_profile_file_fd,
       const ProfileCompilationInfo::ProfileLoadFilterFn& filter_fn
           = ProfileCompilationInfo::ProfileFilterFnAcceptAll,
-      bool store_aggregation_counters = false);
+      bool store_aggregation_counters = false,
+      bool store_uncompressed = false,
+      const MergeOptions& merge_options = MergeOptions());
 
  private:
+  // Loads the input profile with the given index. Must be safe to call concurrently for
+  // different indexes.
+  using ProfileLoaderFn = std::function<bool(size_t index, ProfileCompilationInfo* info)>;
+
   static ProcessingResult ProcessProfilesInternal(
-      const std::vector<ScopedFlock>& profile_files,
+      size_t num_profiles,
+      const ProfileLoaderFn& load_profile,
       const ScopedFlock& reference_profile_file,
       const ProfileCompilationInfo::ProfileLoadFilterFn& filter_fn,
-      bool store_aggregation_counters);
+      bool store_aggregation_counters,
+      bool store_uncompressed,
+      const MergeOptions& merge_options);
+
+  // Merges the input profiles with the given indexes into `info`.
+  static bool MergeProfileRange(size_t begin,
+                                size_t end,
+                                const ProfileLoaderFn& load_profile,
+                                ProfileCompilationInfo* info);
 
   DISALLOW_COPY_AND_ASSIGN(ProfileAssistant);
 };
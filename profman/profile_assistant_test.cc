@@ -456,6 +456,43 @@ TEST_F(ProfileAssistantTest, AdviseCompilationEmptyReferences) {
   CheckProfileInfo(profile2, info2);
 }
 
+TEST_F(ProfileAssistantTest, ParallelStreamingMerge) {
+  static constexpr size_t kNumProfiles = 5;
+  const uint16_t kNumberOfMethodsToEnableCompilation = 100;
+  std::vector<ScratchFile> profiles(kNumProfiles);
+  std::vector<ProfileCompilationInfo> infos(kNumProfiles);
+  std::vector<std::string> profile_names;
+  ProfileCompilationInfo expected;
+  for (size_t i = 0; i != kNumProfiles; ++i) {
+    // Alternate the dex files so that their first-come order matters.
+    SetupProfile("p" + std::to_string(i % 2),
+                 i % 2 + 1u,
+                 kNumberOfMethodsToEnableCompilation + i,
+                 0,
+                 profiles[i],
+                 &infos[i]);
+    profile_names.push_back(profiles[i].GetFilename());
+    ASSERT_TRUE(expected.MergeWith(infos[i]));
+  }
+  ScratchFile reference_profile;
+
+  ProfileAssistant::MergeOptions merge_options;
+  merge_options.num_threads = 3;
+  merge_options.stream_inputs = true;
+  ASSERT_EQ(ProfileAssistant::kCompile,
+            ProfileAssistant::ProcessProfiles(profile_names,
+                                              reference_profile.GetFilename(),
+                                              ProfileCompilationInfo::ProfileFilterFnAcceptAll,
+                                              /*store_aggregation_counters=*/ false,
+                                              /*store_uncompressed=*/ false,
+                                              merge_options));
+  // The result must be the same as merging the inputs sequentially.
+  ProfileCompilationInfo result;
+  ASSERT_TRUE(reference_profile.GetFile()->ResetOffset());
+  ASSERT_TRUE(result.Load(GetFd(reference_profile)));
+  ASSERT_TRUE(expected.Equals(result));
+}
+
 // TODO(calin): Add more tests for classes.
 TEST_F(ProfileAssistantTest, AdviseCompilationEmptyReferencesBecauseOfClasses) {
   ScratchFile profile1;
@@ -161,6 +161,15 @@ NO_RETURN static void Usage(const char *fmt, ...) {
   UsageError("  --store-aggregation-counters: if present, profman will compute and store");
   UsageError("      the aggregation counters of classes and methods in the output profile.");
   UsageError("      In this case the profile will have a different version.");
+  UsageError("  --store-uncompressed: if present, profman will store the output profile");
+  UsageError("      uncompressed. It is larger but loads without being inflated.");
+  UsageError("  --profile-file-list=<filename>: same as --profile-file for each profile file");
+  UsageError("      listed in the given file, one per line.");
+  UsageError("  --merge-threads=<number>: number of threads used to load and merge the profile");
+  UsageError("      files. Ignored with --store-aggregation-counters. Default is 1.");
+  UsageError("  --stream-profile-files: lock the profile files given by name one at a time while");
+  UsageError("      merging them instead of locking all of them up front.");
+  UsageError("  --report-merge-stats: log the time and peak memory used to merge the profiles.");
   UsageError("");
 
   exit(EXIT_FAILURE);
@@ -232,7 +241,8 @@ class ProfMan final {
       test_profile_seed_(NanoTime()),
       start_ns_(NanoTime()),
       copy_and_update_profile_key_(false),
-      store_aggregation_counters_(false) {}
+      store_aggregation_counters_(false),
+      store_uncompressed_(false) {}
 
   ~ProfMan() {
     LogCompletionTime();
@@ -316,6 +326,22 @@ class ProfMan final {
         copy_and_update_profile_key_ = true;
       } else if (option == "--store-aggregation-counters") {
         store_aggregation_counters_ = true;
+      } else if (option == "--store-uncompressed") {
+        store_uncompressed_ = true;
+      } else if (StartsWith(option, "--profile-file-list=")) {
+        std::string list_file(option.substr(strlen("--profile-file-list=")));
+        std::unique_ptr<std::vector<std::string>> files(
+            ReadCommentedInputFromFile<std::vector<std::string>>(list_file.c_str(), nullptr));
+        if (files == nullptr) {
+          Usage("Could not read profile file list '%s'", list_file.c_str());
+        }
+        profile_files_.insert(profile_files_.end(), files->begin(), files->end());
+      } else if (StartsWith(option, "--merge-threads=")) {
+        ParseUintOption(raw_option, "--merge-threads=", &merge_options_.num_threads);
+      } else if (option == "--stream-profile-files") {
+        merge_options_.stream_inputs = true;
+      } else if (option == "--report-merge-stats") {
+        merge_options_.report_stats = true;
       } else {
         Usage("Unknown argument '%s'", raw_option);
       }
@@ -393,13 +419,17 @@ class ProfMan final {
       result = ProfileAssistant::ProcessProfiles(profile_files_fd_,
                                                  reference_profile_file_fd_,
                                                  filter_fn,
-                                                 store_aggregation_counters_);
+                                                 store_aggregation_counters_,
+                                                 store_uncompressed_,
+                                                 merge_options_);
       CloseAllFds(profile_files_fd_, "profile_files_fd_");
     } else {
       result = ProfileAssistant::ProcessProfiles(profile_files_,
                                                  reference_profile_file_,
                                                  filter_fn,
-                                                 store_aggregation_counters_);
+                                                 store_aggregation_counters_,
+                                                 store_uncompressed_,
+                                                 merge_options_);
     }
     return result;
   }
@@ -1278,6 +1308,7 @@ class ProfMan final {
       if (!profile.UpdateProfileKeys(dex_files)) {
         return kErrorFailedToUpdateProfile;
       }
+      profile.SetStoreUncompressed(store_uncompressed_);
       bool result = use_fds
           ? profile.Save(reference_profile_file_fd_)
           : profile.Save(reference_profile_file_, /*bytes_written=*/ nullptr);
@@ -1334,6 +1365,8 @@ class ProfMan final {
   uint64_t start_ns_;
   bool copy_and_update_profile_key_;
   bool store_aggregation_counters_;
+  bool store_uncompressed_;
+  ProfileAssistant::MergeOptions merge_options_;
 };
 
 // See ProfileAssistant::ProcessingResult for return codes.
@@ -1990,7 +1990,9 @@ TEST_F(StubTest, StringIndexOf) {
   // Use array so we can index into it and use a matrix for expected results
   // Setup: The first half is standard. The second half uses a non-zero offset.
   // TODO: Shared backing arrays.
-  const char* c_str[] = { "", "a", "ba", "cba", "dcba", "edcba", "asdfghjkl" };
+  // The last string is long enough to exercise the vectorized loops.
+  const char* c_str[] = { "", "a", "ba", "cba", "dcba", "edcba", "asdfghjkl",
+                          "zyxwvutsrqponmlkjihgfedcbazyxwvutsrqponm" };
   static constexpr size_t kStringCount = arraysize(c_str);
   const char c_char[] = { 'a', 'b', 'c', 'd', 'e' };
   static constexpr size_t kCharCount = arraysize(c_char);
@@ -2005,7 +2007,7 @@ TEST_F(StubTest, StringIndexOf) {
   // Matrix of expectations. First component is first parameter. Note we only check against the
   // sign, not the value. As we are testing random offsets, we need to compute this and need to
   // rely on String::CompareTo being correct.
-  static constexpr size_t kMaxLen = 9;
+  static constexpr size_t kMaxLen = 40;
   DCHECK_LE(strlen(c_str[kStringCount-1]), kMaxLen) << "Please fix the indexof test.";
 
   // Last dimension: start, offset by 1.
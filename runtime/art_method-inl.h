@@ -78,6 +78,23 @@ inline bool ArtMethod::CASDeclaringClass(ObjPtr<mirror::Class> expected_class,
   return atomic_root_class->CompareAndSetStrongSequentiallyConsistent(expected_root, desired_root);
 }
 
+inline bool ArtMethod::CASImtConflictTable(ImtConflictTable* expected_table,
+                                            ImtConflictTable* desired_table,
+                                            PointerSize pointer_size) {
+  DCHECK(IsRuntimeMethod());
+  DCHECK(IsImagePointerSize(pointer_size));
+  const auto addr = reinterpret_cast<uintptr_t>(this) + DataOffset(pointer_size).Uint32Value();
+  if (pointer_size == PointerSize::k32) {
+    return reinterpret_cast<Atomic<uint32_t>*>(addr)->CompareAndSetStrongRelease(
+        dchecked_integral_cast<uint32_t>(reinterpret_cast<uintptr_t>(expected_table)),
+        dchecked_integral_cast<uint32_t>(reinterpret_cast<uintptr_t>(desired_table)));
+  } else {
+    return reinterpret_cast<Atomic<uint64_t>*>(addr)->CompareAndSetStrongRelease(
+        reinterpret_cast<uintptr_t>(expected_table),
+        reinterpret_cast<uintptr_t>(desired_table));
+  }
+}
+
 inline uint16_t ArtMethod::GetMethodIndex() {
   DCHECK(IsRuntimeMethod() || GetDeclaringClass()->IsResolved());
   return method_index_;
@@ -475,6 +475,12 @@ class ArtMethod final {
     SetDataPtrSize(table, pointer_size);
   }
 
+  // Publish `desired_table` if the current table is still `expected_table`. Has release semantics
+  // so that the conflict trampolines see the entries of the new table.
+  bool CASImtConflictTable(ImtConflictTable* expected_table,
+                           ImtConflictTable* desired_table,
+                           PointerSize pointer_size);
+
   ProfilingInfo* GetProfilingInfo(PointerSize pointer_size) REQUIRES_SHARED(Locks::mutator_lock_) {
     if (UNLIKELY(IsNative() || IsProxyMethod() || !IsInvokable())) {
       return nullptr;
@@ -33,7 +33,7 @@ namespace art {
 
 class MemMapArena final : public Arena {
  public:
-  MemMapArena(size_t size, bool low_4gb, const char* name);
+  MemMapArena(size_t size, bool low_4gb, const char* name, NativeMemoryTag tag);
   virtual ~MemMapArena();
   void Release() override;
 
@@ -43,8 +43,9 @@ class MemMapArena final : public Arena {
   MemMap map_;
 };
 
-MemMapArena::MemMapArena(size_t size, bool low_4gb, const char* name)
+MemMapArena::MemMapArena(size_t size, bool low_4gb, const char* name, NativeMemoryTag tag)
     : map_(Allocate(size, low_4gb, name)) {
+  map_.SetNativeMemoryTag(tag);
   memory_ = map_.Begin();
   static_assert(ArenaAllocator::kArenaAlignment <= kPageSize,
                 "Arena should not need stronger alignment than kPageSize.");
@@ -79,8 +80,7 @@ void MemMapArena::Release() {
 
 MemMapArenaPool::MemMapArenaPool(bool low_4gb, const char* name)
     : low_4gb_(low_4gb),
-      name_(name),
-      free_arenas_(nullptr) {
+      name_(name) {
   MemMap::Init();
 }
 
@@ -89,29 +89,23 @@ MemMapArenaPool::~MemMapArenaPool() {
 }
 
 void MemMapArenaPool::ReclaimMemory() {
-  while (free_arenas_ != nullptr) {
-    Arena* arena = free_arenas_;
-    free_arenas_ = free_arenas_->next_;
+  Arena* arena = free_arenas_.TakeAll();
+  while (arena != nullptr) {
+    Arena* next = arena->next_;
     delete arena;
+    arena = next;
   }
 }
 
 void MemMapArenaPool::LockReclaimMemory() {
-  std::lock_guard<std::mutex> lock(lock_);
   ReclaimMemory();
 }
 
 Arena* MemMapArenaPool::AllocArena(size_t size) {
-  Arena* ret = nullptr;
-  {
-    std::lock_guard<std::mutex> lock(lock_);
-    if (free_arenas_ != nullptr && LIKELY(free_arenas_->Size() >= size)) {
-      ret = free_arenas_;
-      free_arenas_ = free_arenas_->next_;
-    }
-  }
+  Arena* ret = free_arenas_.Take(size);
   if (ret == nullptr) {
-    ret = new MemMapArena(size, low_4gb_, name_);
+    free_arenas_.RecordNewArena();
+    ret = new MemMapArena(size, low_4gb_, name_, GetNativeMemoryTag());
   }
   ret->Reset();
   return ret;
@@ -119,21 +113,23 @@ Arena* MemMapArenaPool::AllocArena(size_t size) {
 
 void MemMapArenaPool::TrimMaps() {
   ScopedTrace trace(__PRETTY_FUNCTION__);
-  std::lock_guard<std::mutex> lock(lock_);
-  for (Arena* arena = free_arenas_; arena != nullptr; arena = arena->next_) {
+  free_arenas_.VisitArenas([](Arena* arena) {
     arena->Release();
-  }
+  });
 }
 
 size_t MemMapArenaPool::GetBytesAllocated() const {
   size_t total = 0;
-  std::lock_guard<std::mutex> lock(lock_);
-  for (Arena* arena = free_arenas_; arena != nullptr; arena = arena->next_) {
+  free_arenas_.VisitArenas([&total](Arena* arena) {
     total += arena->GetBytesAllocated();
-  }
+  });
   return total;
 }
 
+void MemMapArenaPool::DumpStats(std::ostream& os) const {
+  free_arenas_.DumpStats(os);
+}
+
 void MemMapArenaPool::FreeArenaChain(Arena* first) {
   if (kRunningOnMemoryTool) {
     for (Arena* arena = first; arena != nullptr; arena = arena->next_) {
@@ -151,15 +147,7 @@ void MemMapArenaPool::FreeArenaChain(Arena* first) {
     return;
   }
 
-  if (first != nullptr) {
-    Arena* last = first;
-    while (last->next_ != nullptr) {
-      last = last->next_;
-    }
-    std::lock_guard<std::mutex> lock(lock_);
-    last->next_ = free_arenas_;
-    free_arenas_ = first;
-  }
+  free_arenas_.Put(first);
 }
 
 }  // namespace art
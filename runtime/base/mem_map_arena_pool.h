@@ -32,14 +32,14 @@ class MemMapArenaPool final : public ArenaPool {
   void LockReclaimMemory() override;
   // Trim the maps in arenas by madvising, used by JIT to reduce memory usage.
   void TrimMaps() override;
+  void DumpStats(std::ostream& os) const override;
 
  private:
   const bool low_4gb_;
   const char* name_;
-  Arena* free_arenas_;
-  // Use a std::mutex here as Arenas are second-from-the-bottom when using MemMaps, and MemMap
-  // itself uses std::mutex scoped to within an allocate/free only.
-  mutable std::mutex lock_;
+  // ArenaFreeList uses std::mutex as Arenas are second-from-the-bottom when using MemMaps, and
+  // MemMap itself uses std::mutex scoped to within an allocate/free only.
+  ArenaFreeList free_arenas_;
 
   DISALLOW_COPY_AND_ASSIGN(MemMapArenaPool);
 };
@@ -77,6 +77,12 @@ void ClassHierarchyAnalysis::RemoveDependentsWithMethodHeaders(
       map_it++;
     }
   }
+  // Freed code has no frames left, and its memory may be reused for other code.
+  if (!pending_deoptimization_headers_.empty()) {
+    for (OatQuickMethodHeader* method_header : method_headers) {
+      pending_deoptimization_headers_.erase(method_header);
+    }
+  }
 }
 
 void ClassHierarchyAnalysis::ResetSingleImplementationInHierarchy(ObjPtr<mirror::Class> klass,
@@ -212,7 +218,7 @@ class CHAStackVisitor final  : public StackVisitor {
       // This compiled version doesn't have should_deoptimize flag. Skip.
       return true;
     }
-    auto it = std::find(method_headers_.begin(), method_headers_.end(), method_header);
+    auto it = method_headers_.find(const_cast<OatQuickMethodHeader*>(method_header));
     if (it == method_headers_.end()) {
       // Not in the list of method headers that should be deoptimized.
       return true;
@@ -632,8 +638,6 @@ void ClassHierarchyAnalysis::InvalidateSingleImplementationMethods(
   if (!invalidated_single_impl_methods.empty()) {
     Runtime* const runtime = Runtime::Current();
     Thread *self = Thread::Current();
-    // Method headers for compiled code to be invalidated.
-    std::unordered_set<OatQuickMethodHeader*> dependent_method_headers;
     PointerSize image_pointer_size =
         Runtime::Current()->GetClassLinker()->GetImagePointerSize();
 
@@ -674,10 +678,13 @@ void ClassHierarchyAnalysis::InvalidateSingleImplementationMethods(
             // since it would run into problems with lock-ordering. We don't want to re-order the
             // locks since that would make code-commit racy.
             headers.push_back({method, method_header});
-            dependent_method_headers.insert(method_header);
+            pending_deoptimization_headers_.insert(method_header);
           }
           RemoveAllDependenciesFor(invalidated);
         }
+        if (!headers.empty()) {
+          has_pending_deoptimizations_.store(true, std::memory_order_release);
+        }
       }
       // Since we are still loading the class that invalidated the code it's fine we have this after
       // getting rid of the dependency. Any calls would need to be with the old version (since the
@@ -692,16 +699,51 @@ void ClassHierarchyAnalysis::InvalidateSingleImplementationMethods(
       }
     }
 
-    if (dependent_method_headers.empty()) {
-      return;
+    // Deoptimize compiled code on stack that should have been invalidated, unless a
+    // ScopedCHABatch does it later for all classes defined in it.
+    if (self->GetCHABatchDepth() == 0u) {
+      DeoptimizePendingFrames(self);
     }
-    // Deoptimze compiled code on stack that should have been invalidated.
-    CHACheckpoint checkpoint(dependent_method_headers);
-    size_t threads_running_checkpoint = runtime->GetThreadList()->RunCheckpoint(&checkpoint);
+  }
+}
+
+void ClassHierarchyAnalysis::DeoptimizePendingFrames(Thread* self) {
+  if (!HasPendingDeoptimizations()) {
+    return;
+  }
+  std::unordered_set<OatQuickMethodHeader*> method_headers;
+  {
+    MutexLock cha_mu(self, *Locks::cha_lock_);
+    method_headers = pending_deoptimization_headers_;
+  }
+  if (!method_headers.empty()) {
+    CHACheckpoint checkpoint(method_headers);
+    size_t threads_running_checkpoint =
+        Runtime::Current()->GetThreadList()->RunCheckpoint(&checkpoint);
     if (threads_running_checkpoint != 0) {
       checkpoint.WaitForThreadsToRunThroughCheckpoint(threads_running_checkpoint);
     }
   }
+  MutexLock cha_mu(self, *Locks::cha_lock_);
+  for (OatQuickMethodHeader* method_header : method_headers) {
+    pending_deoptimization_headers_.erase(method_header);
+  }
+  if (pending_deoptimization_headers_.empty()) {
+    has_pending_deoptimizations_.store(false, std::memory_order_release);
+  }
+}
+
+ScopedCHABatch::ScopedCHABatch(Thread* self) : self_(self) {
+  self_->SetCHABatchDepth(self_->GetCHABatchDepth() + 1u);
+}
+
+ScopedCHABatch::~ScopedCHABatch() {
+  DCHECK_NE(self_->GetCHABatchDepth(), 0u);
+  self_->SetCHABatchDepth(self_->GetCHABatchDepth() - 1u);
+  if (self_->GetCHABatchDepth() == 0u) {
+    Runtime::Current()->GetClassLinker()->GetClassHierarchyAnalysis()->DeoptimizePendingFrames(
+        self_);
+  }
 }
 
 void ClassHierarchyAnalysis::RemoveDependenciesForLinearAlloc(const LinearAlloc* linear_alloc) {
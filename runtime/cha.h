@@ -20,6 +20,7 @@
 #include <unordered_map>
 #include <unordered_set>
 
+#include "base/atomic.h"
 #include "base/enums.h"
 #include "base/locks.h"
 #include "handle.h"
@@ -30,6 +31,7 @@ namespace art {
 
 class ArtMethod;
 class LinearAlloc;
+class Thread;
 
 /**
  * Class Hierarchy Analysis (CHA) tries to devirtualize virtual calls into
@@ -129,6 +131,16 @@ class ClassHierarchyAnalysis {
   void RemoveDependenciesForLinearAlloc(const LinearAlloc* linear_alloc)
       REQUIRES(!Locks::cha_lock_);
 
+  // Whether some invalidated code may still have frames that are not marked for
+  // deoptimization, see ScopedCHABatch.
+  bool HasPendingDeoptimizations() const {
+    return has_pending_deoptimizations_.load(std::memory_order_acquire);
+  }
+
+  // Marks the frames of all invalidated code for deoptimization, with one checkpoint.
+  void DeoptimizePendingFrames(Thread* self)
+      REQUIRES(!Locks::cha_lock_) REQUIRES_SHARED(Locks::mutator_lock_);
+
  private:
   void InitSingleImplementationFlag(Handle<mirror::Class> klass,
                                     ArtMethod* method,
@@ -171,9 +183,32 @@ class ClassHierarchyAnalysis {
   std::unordered_map<ArtMethod*, ListOfDependentPairs> cha_dependency_map_
     GUARDED_BY(Locks::cha_lock_);
 
+  // Headers of invalidated code whose frames have not been marked for deoptimization yet.
+  // Entries are only removed once the checkpoint marking them has completed, so that a
+  // concurrent DeoptimizePendingFrames does not return before the frames are marked.
+  std::unordered_set<OatQuickMethodHeader*> pending_deoptimization_headers_
+      GUARDED_BY(Locks::cha_lock_);
+  Atomic<bool> has_pending_deoptimizations_{false};
+
   DISALLOW_COPY_AND_ASSIGN(ClassHierarchyAnalysis);
 };
 
+// Defers marking the frames of code invalidated by class linking until the outermost scope on
+// the thread ends, so that defining a class along with its superclasses and interfaces walks the
+// thread stacks once rather than once per class. The classes defined in the scope cannot have
+// instances before they are initialized, and ClassLinker::InitializeClass deoptimizes the pending
+// frames first, so no invalidated code can see such an instance.
+class ScopedCHABatch {
+ public:
+  explicit ScopedCHABatch(Thread* self);
+  ~ScopedCHABatch() REQUIRES_SHARED(Locks::mutator_lock_);
+
+ private:
+  Thread* const self_;
+
+  DISALLOW_COPY_AND_ASSIGN(ScopedCHABatch);
+};
+
 }  // namespace art
 
 #endif  // ART_RUNTIME_CHA_H_
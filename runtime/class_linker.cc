@@ -71,6 +71,7 @@
 #include "entrypoints/entrypoint_utils.h"
 #include "entrypoints/runtime_asm_entrypoints.h"
 #include "experimental_flags.h"
+#include "flight_recorder.h"
 #include "gc/accounting/card_table-inl.h"
 #include "gc/accounting/heap_bitmap-inl.h"
 #include "gc/accounting/space_bitmap-inl.h"
@@ -79,6 +80,7 @@
 #include "gc/scoped_gc_critical_section.h"
 #include "gc/space/image_space.h"
 #include "gc/space/space-inl.h"
+#include "gc/task_processor.h"
 #include "gc_root-inl.h"
 #include "handle_scope-inl.h"
 #include "hidden_api.h"
@@ -122,6 +124,7 @@
 #include "mirror/string-inl.h"
 #include "mirror/throwable.h"
 #include "mirror/var_handle.h"
+#include "monitor_contention_profile.h"
 #include "native/dalvik_system_DexFile.h"
 #include "nativehelper/scoped_local_ref.h"
 #include "oat.h"
@@ -2659,7 +2662,7 @@ ClassLinker::~ClassLinker() {
   for (const ClassLoaderData& data : class_loaders_) {
     // CHA unloading analysis is not needed. No negative consequences are expected because
     // all the classloaders are deleted at the same time.
-    DeleteClassLoader(self, data, /*cleanup_cha=*/ false);
+    DeleteClassLoader(self, data, /*cleanup_cha=*/ false, /*free_native_memory=*/ true);
   }
   class_loaders_.clear();
   while (!running_visibly_initialized_callbacks_.empty()) {
@@ -2669,7 +2672,10 @@ ClassLinker::~ClassLinker() {
   }
 }
 
-void ClassLinker::DeleteClassLoader(Thread* self, const ClassLoaderData& data, bool cleanup_cha) {
+void ClassLinker::DeleteClassLoader(Thread* self,
+                                    const ClassLoaderData& data,
+                                    bool cleanup_cha,
+                                    bool free_native_memory) {
   Runtime* const runtime = Runtime::Current();
   JavaVMExt* const vm = runtime->GetJavaVM();
   vm->DeleteWeakGlobalRef(self, data.weak_root);
@@ -2684,16 +2690,48 @@ void ClassLinker::DeleteClassLoader(Thread* self, const ClassLoaderData& data, b
     // If we don't have a JIT, we need to manually remove the CHA dependencies manually.
     cha_->RemoveDependenciesForLinearAlloc(data.allocator);
   }
+  if (runtime->GetMonitorContentionProfile() != nullptr) {
+    runtime->GetMonitorContentionProfile()->RemoveMethodsIn(*data.allocator);
+  }
   // Cleanup references to single implementation ArtMethods that will be deleted.
   if (cleanup_cha) {
     CHAOnDeleteUpdateClassVisitor visitor(data.allocator);
     data.class_table->Visit<CHAOnDeleteUpdateClassVisitor, kWithoutReadBarrier>(visitor);
   }
 
-  delete data.allocator;
-  delete data.class_table;
+  if (free_native_memory) {
+    delete data.allocator;
+    delete data.class_table;
+  }
 }
 
+// Frees the class tables and LinearAllocs of unloaded class loaders on the heap task thread, so
+// that the GC which found them unloaded does not spend its time returning their memory. Nothing
+// refers to them anymore: the class loaders are gone from class_loaders_ and DeleteClassLoader()
+// already removed the JIT code and CHA dependencies of their methods.
+class FreeClassLoaderMemoryTask : public gc::HeapTask {
+ public:
+  FreeClassLoaderMemoryTask(std::vector<ClassTable*>&& class_tables,
+                            std::vector<LinearAlloc*>&& allocators)
+      : gc::HeapTask(NanoTime()),
+        class_tables_(std::move(class_tables)),
+        allocators_(std::move(allocators)) {}
+
+  // If the task is finalized without running at shutdown, the memory is left to the process exit.
+  void Run(Thread* self ATTRIBUTE_UNUSED) override {
+    for (LinearAlloc* allocator : allocators_) {
+      delete allocator;
+    }
+    for (ClassTable* class_table : class_tables_) {
+      delete class_table;
+    }
+  }
+
+ private:
+  const std::vector<ClassTable*> class_tables_;
+  const std::vector<LinearAlloc*> allocators_;
+};
+
 ObjPtr<mirror::PointerArray> ClassLinker::AllocPointerArray(Thread* self, size_t length) {
   return ObjPtr<mirror::PointerArray>::DownCast(
       image_pointer_size_ == PointerSize::k64
@@ -3123,6 +3161,17 @@ ObjPtr<mirror::Class> ClassLinker::FindClassInBaseDexClassLoaderClassPath(
          IsDelegateLastClassLoader(soa, class_loader))
       << "Unexpected class loader for descriptor " << descriptor;
 
+  // Probes with Class.forName() for classes that are not there can otherwise cost one lookup in
+  // each dex file of the class loader, every time.
+  ClassTable* const class_table = class_loader->GetClassTable();
+  StackHandleScope<1> hs(soa.Self());
+  Handle<mirror::Object> dex_elements = hs.NewHandle(GetDexElements(class_loader.Get()));
+  if (class_table != nullptr &&
+      !dex_elements.IsNull() &&
+      class_table->IsKnownMissingFromDexPath(descriptor, hash, dex_elements.Get())) {
+    return nullptr;
+  }
+
   ObjPtr<mirror::Class> ret;
   auto define_class = [&](const DexFile* cp_dex_file) REQUIRES_SHARED(Locks::mutator_lock_) {
     const dex::ClassDef* dex_class_def = OatDexFile::FindClassDef(*cp_dex_file, descriptor, hash);
@@ -3147,6 +3196,14 @@ ObjPtr<mirror::Class> ClassLinker::FindClassInBaseDexClassLoaderClassPath(
   };
 
   VisitClassLoaderDexFiles(soa, class_loader, define_class);
+  if (ret == nullptr &&
+      !soa.Self()->IsExceptionPending() &&
+      class_table != nullptr &&
+      !dex_elements.IsNull() &&
+      GetDexElements(class_loader.Get()) == dex_elements.Get()) {
+    // Only record the miss if the dex path did not change while we searched it.
+    class_table->AddKnownMissingFromDexPath(descriptor, hash, dex_elements.Get());
+  }
   return ret;
 }
 
@@ -3353,6 +3410,11 @@ ObjPtr<mirror::Class> ClassLinker::DefineClass(Thread* self,
                                                Handle<mirror::ClassLoader> class_loader,
                                                const DexFile& dex_file,
                                                const dex::ClassDef& dex_class_def) {
+  // Superclasses and interfaces defined while resolving those of this class share one
+  // deoptimization checkpoint for the code their linking invalidates.
+  ScopedCHABatch cha_batch(self);
+  FlightRecorder* flight_recorder = Runtime::Current()->GetFlightRecorder();
+  uint64_t define_start_ns = (flight_recorder != nullptr) ? NanoTime() : 0u;
   StackHandleScope<3> hs(self);
   auto klass = hs.NewHandle<mirror::Class>(nullptr);
 
@@ -3524,6 +3586,14 @@ ObjPtr<mirror::Class> ClassLinker::DefineClass(Thread* self,
    * at this point.
    */
   Runtime::Current()->GetRuntimeCallbacks()->ClassPrepare(klass, h_new_class);
+  if (flight_recorder != nullptr) {
+    flight_recorder->Record(self,
+                            FlightRecorder::EventType::kClassPrepare,
+                            define_start_ns,
+                            NanoTime() - define_start_ns,
+                            /* arg= */ 0u,
+                            descriptor);
+  }
 
   // Notify native debugger of the new class and its layout.
   jit::Jit::NewTypeLoadedIfUsingJit(h_new_class.Get());
@@ -4270,6 +4340,15 @@ bool ClassLinker::IsDexFileRegistered(Thread* self, const DexFile& dex_file) {
   return DecodeDexCache(self, FindDexCacheDataLocked(dex_file)) != nullptr;
 }
 
+void ClassLinker::MadviseAppDexFiles(Thread* self, MadviseState state) {
+  ReaderMutexLock mu(self, *Locks::dex_lock_);
+  for (const DexCacheData& data : dex_caches_) {
+    if (data.IsValid() && !ContainsElement(boot_class_path_, data.dex_file)) {
+      OatDexFile::MadviseDexFile(*data.dex_file, state);
+    }
+  }
+}
+
 ObjPtr<mirror::DexCache> ClassLinker::FindDexCache(Thread* self, const DexFile& dex_file) {
   ReaderMutexLock mu(self, *Locks::dex_lock_);
   DexCacheData dex_cache_data = FindDexCacheDataLocked(dex_file);
@@ -5356,6 +5435,12 @@ bool ClassLinker::InitializeClass(Thread* self,
     return false;
   }
 
+  // Classes still being defined in a ScopedCHABatch on another thread may already be visible.
+  // Their instances must not reach code whose frames were not yet marked for deoptimization.
+  if (UNLIKELY(cha_->HasPendingDeoptimizations())) {
+    cha_->DeoptimizePendingFrames(self);
+  }
+
   self->AllowThreadSuspension();
   Runtime* const runtime = Runtime::Current();
   const bool stats_enabled = runtime->HasStatsEnabled();
@@ -6880,7 +6965,6 @@ ArtMethod* ClassLinker::AddMethodToConflictTable(ObjPtr<mirror::Class> klass,
                                                  ArtMethod* interface_method,
                                                  ArtMethod* method,
                                                  bool force_new_conflict_method) {
-  ImtConflictTable* current_table = conflict_method->GetImtConflictTable(kRuntimePointerSize);
   Runtime* const runtime = Runtime::Current();
   LinearAlloc* linear_alloc = GetAllocatorForClassLoader(klass->GetClassLoader());
   bool new_entry = conflict_method == runtime->GetImtConflictMethod() || force_new_conflict_method;
@@ -6890,28 +6974,41 @@ ArtMethod* ClassLinker::AddMethodToConflictTable(ObjPtr<mirror::Class> klass,
       ? runtime->CreateImtConflictMethod(linear_alloc)
       : conflict_method;
 
-  // Allocate a new table. Note that we will leak this table at the next conflict,
-  // but that's a tradeoff compared to making the table fixed size.
-  void* data = linear_alloc->Alloc(
-      Thread::Current(), ImtConflictTable::ComputeSizeWithOneMoreEntry(current_table,
-                                                                       image_pointer_size_));
-  if (data == nullptr) {
-    LOG(ERROR) << "Failed to allocate conflict table";
-    return conflict_method;
-  }
-  ImtConflictTable* new_table = new (data) ImtConflictTable(current_table,
-                                                            interface_method,
-                                                            method,
-                                                            image_pointer_size_);
-
-  // Do a fence to ensure threads see the data in the table before it is assigned
-  // to the conflict method.
-  // Note that there is a race in the presence of multiple threads and we may leak
-  // memory from the LinearAlloc, but that's a tradeoff compared to using
-  // atomic operations.
-  std::atomic_thread_fence(std::memory_order_release);
-  new_conflict_method->SetImtConflictTable(new_table, image_pointer_size_);
-  return new_conflict_method;
+  // Tables are immutable once published, so that the conflict trampolines can scan them without
+  // synchronization. Appending copies the table and swaps it in with a CAS; a thread that loses
+  // the race retries on top of the table of the winner instead of dropping its entry.
+  ImtConflictTable* current_table = conflict_method->GetImtConflictTable(kRuntimePointerSize);
+  for (;;) {
+    if (!new_entry && current_table->Lookup(interface_method, image_pointer_size_) != nullptr) {
+      // Added by another thread since the caller's lookup.
+      return conflict_method;
+    }
+    // Allocate a new table. Note that we will leak this table at the next conflict,
+    // but that's a tradeoff compared to making the table fixed size.
+    void* data = linear_alloc->Alloc(
+        Thread::Current(), ImtConflictTable::ComputeSizeWithOneMoreEntry(current_table,
+                                                                         image_pointer_size_));
+    if (data == nullptr) {
+      LOG(ERROR) << "Failed to allocate conflict table";
+      return conflict_method;
+    }
+    ImtConflictTable* new_table = new (data) ImtConflictTable(current_table,
+                                                              interface_method,
+                                                              method,
+                                                              image_pointer_size_);
+    if (new_entry) {
+      // Not visible to other threads yet, the caller publishes it through the IMT. Do a fence to
+      // ensure threads see the data in the table before the conflict method is stored there.
+      std::atomic_thread_fence(std::memory_order_release);
+      new_conflict_method->SetImtConflictTable(new_table, image_pointer_size_);
+      return new_conflict_method;
+    }
+    if (conflict_method->CASImtConflictTable(current_table, new_table, image_pointer_size_)) {
+      return conflict_method;
+    }
+    // Lost the race, the allocation of `new_table` is leaked.
+    current_table = conflict_method->GetImtConflictTable(kRuntimePointerSize);
+  }
 }
 
 bool ClassLinker::AllocateIfTableMethodArrays(Thread* self,
@@ -8135,6 +8232,7 @@ bool ClassLinker::LinkInterfaceMethods(
   Runtime* const runtime = Runtime::Current();
 
   const bool is_interface = klass->IsInterface();
+  const bool is_proxy = klass->IsProxyClass();
   const bool has_superclass = klass->HasSuperClass();
   const bool fill_tables = !is_interface;
   const size_t super_ifcount = has_superclass ? klass->GetSuperClass()->GetIfTableCount() : 0U;
@@ -8230,14 +8328,36 @@ bool ClassLinker::LinkInterfaceMethods(
         // To find defaults we need to do the same but also go over interfaces.
         bool found_impl = false;
         ArtMethod* vtable_impl = nullptr;
+        // A proxy method is a copy of one of the interface methods it implements, so most
+        // interface methods find their proxy method by identity. Proxy methods have unique
+        // signatures, so the one found is also the last match in the table. Comparing names and
+        // signatures is only needed for the methods that were merged with another prototype.
+        ArtMethod* proxy_impl = nullptr;
+        if (is_proxy) {
+          ArtMethod* np_interface_method =
+              interface_method->GetInterfaceMethodIfProxy(image_pointer_size_);
+          for (int32_t k = input_array_length - 1; k >= 0; --k) {
+            ArtMethod* vtable_method = using_virtuals ?
+                &input_virtual_methods[k] :
+                input_vtable_array->GetElementPtrSize<ArtMethod*>(k, image_pointer_size_);
+            if (vtable_method->IsProxyMethod() &&
+                vtable_method->GetInterfaceMethodIfProxy(image_pointer_size_) ==
+                    np_interface_method) {
+              proxy_impl = vtable_method;
+              break;
+            }
+          }
+        }
         for (int32_t k = input_array_length - 1; k >= 0; --k) {
           ArtMethod* vtable_method = using_virtuals ?
               &input_virtual_methods[k] :
               input_vtable_array->GetElementPtrSize<ArtMethod*>(k, image_pointer_size_);
           ArtMethod* vtable_method_for_name_comparison =
               vtable_method->GetInterfaceMethodIfProxy(image_pointer_size_);
-          if (interface_name_comparator.HasSameNameAndSignature(
-              vtable_method_for_name_comparison)) {
+          if ((proxy_impl != nullptr)
+                  ? vtable_method == proxy_impl
+                  : interface_name_comparator.HasSameNameAndSignature(
+                        vtable_method_for_name_comparison)) {
             if (!vtable_method->IsAbstract() && !vtable_method->IsPublic()) {
               // Must do EndAssertNoThreadSuspension before throw since the throw can cause
               // allocations.
@@ -9848,9 +9968,24 @@ void ClassLinker::CleanupClassLoaders() {
       }
     }
   }
+  if (to_delete.empty()) {
+    return;
+  }
+  gc::TaskProcessor* task_processor = Runtime::Current()->GetHeap()->GetTaskProcessor();
+  const bool free_in_background = task_processor != nullptr && task_processor->IsRunning();
+  std::vector<ClassTable*> class_tables;
+  std::vector<LinearAlloc*> allocators;
   for (ClassLoaderData& data : to_delete) {
     // CHA unloading analysis and SingleImplementaion cleanups are required.
-    DeleteClassLoader(self, data, /*cleanup_cha=*/ true);
+    DeleteClassLoader(self, data, /*cleanup_cha=*/ true, !free_in_background);
+    if (free_in_background) {
+      class_tables.push_back(data.class_table);
+      allocators.push_back(data.allocator);
+    }
+  }
+  if (free_in_background) {
+    task_processor->AddTask(
+        self, new FreeClassLoaderMemoryTask(std::move(class_tables), std::move(allocators)));
   }
 }
 
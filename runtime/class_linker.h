@@ -87,6 +87,7 @@ template<typename T> class LengthPrefixedArray;
 template<class T> class MutableHandle;
 class InternTable;
 class LinearAlloc;
+enum class MadviseState : uint8_t;
 class OatFile;
 template<class T> class ObjectLock;
 class Runtime;
@@ -471,6 +472,10 @@ class ClassLinker {
       REQUIRES(!Locks::dex_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Madvise the registered dex files that are not on the boot class path to `state`. The boot
+  // class path dex files are shared with the other processes and left alone.
+  void MadviseAppDexFiles(Thread* self, MadviseState state) REQUIRES(!Locks::dex_lock_);
+
   LengthPrefixedArray<ArtField>* AllocArtFieldArray(Thread* self,
                                                     LinearAlloc* allocator,
                                                     size_t length);
@@ -785,7 +790,13 @@ class ClassLinker {
       REQUIRES(!Locks::dex_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
-  void DeleteClassLoader(Thread* self, const ClassLoaderData& data, bool cleanup_cha)
+  // Removes the JIT code, CHA dependencies and profiling data of the class loader's methods. The
+  // class table and LinearAlloc are freed only if `free_native_memory`, otherwise the caller
+  // takes care of them.
+  void DeleteClassLoader(Thread* self,
+                         const ClassLoaderData& data,
+                         bool cleanup_cha,
+                         bool free_native_memory)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
   void VisitClassesInternal(ClassVisitor* visitor)
@@ -1719,6 +1719,39 @@ TEST_F(ClassLinkerClassLoaderTest, CreateDelegateLastClassLoader) {
   VerifyClassResolution("LDefinedInB;", class_loader_a, nullptr, /*should_find=*/ false);
 }
 
+TEST_F(ClassLinkerClassLoaderTest, CreateInMemoryDexClassLoader) {
+  jobject class_loader_a = LoadDexInInMemoryDexClassLoader("ForClassLoaderA", nullptr);
+  VerifyClassResolution("LDefinedInA;", class_loader_a, class_loader_a);
+  VerifyClassResolution("Ljava/lang/String;", class_loader_a, nullptr);
+  VerifyClassResolution("LDefinedInB;", class_loader_a, nullptr, /*should_find=*/ false);
+}
+
+TEST_F(ClassLinkerClassLoaderTest, CreateClassLoaderChainWithInMemoryDexClassLoader) {
+  // The chain is
+  //    ClassLoaderA (InMemoryDexClassLoader, defines: A, AB, AC, AD)
+  //       ^
+  //       |
+  //    ClassLoaderB (DelegateLastClassLoader, defines: B, AB, BC, BD)
+  //       ^
+  //       |
+  //    ClassLoaderC (InMemoryDexClassLoader, defines: C, AC, BC, CD)
+  jobject class_loader_a = LoadDexInInMemoryDexClassLoader("ForClassLoaderA", nullptr);
+  jobject class_loader_b = LoadDexInDelegateLastClassLoader("ForClassLoaderB", class_loader_a);
+  jobject class_loader_c = LoadDexInInMemoryDexClassLoader("ForClassLoaderC", class_loader_b);
+
+  VerifyClassResolution("LDefinedInC;", class_loader_c, class_loader_c);
+  VerifyClassResolution("LDefinedInB;", class_loader_c, class_loader_b);
+  VerifyClassResolution("LDefinedInA;", class_loader_c, class_loader_a);
+
+  // B is a DelegateLastClassLoader, it wins over its parent but not over the boot class path.
+  VerifyClassResolution("LDefinedInAB;", class_loader_c, class_loader_b);
+  VerifyClassResolution("LDefinedInBC;", class_loader_c, class_loader_b);
+  VerifyClassResolution("LDefinedInAC;", class_loader_c, class_loader_a);
+  VerifyClassResolution("Ljava/lang/String;", class_loader_c, nullptr);
+
+  VerifyClassResolution("LNotDefined;", class_loader_c, nullptr, /*should_find=*/ false);
+}
+
 TEST_F(ClassLinkerClassLoaderTest, CreateClassLoaderChain) {
   // The chain is
   //    ClassLoaderA (PathClassLoader, defines: A, AB, AC, AD)
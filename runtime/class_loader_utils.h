@@ -59,6 +59,21 @@ inline bool IsDelegateLastClassLoader(ScopedObjectAccessAlreadyRunnable& soa,
       soa.Decode<mirror::Class>(WellKnownClasses::dalvik_system_DelegateLastClassLoader);
 }
 
+// Return the DexPathList.dexElements array of the given classloader, it is replaced by a new array
+// when the dex path changes. This function assumes that the given classloader is a subclass of
+// BaseDexClassLoader!
+inline ObjPtr<mirror::Object> GetDexElements(ObjPtr<mirror::ClassLoader> class_loader)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  ObjPtr<mirror::Object> dex_path_list =
+      jni::DecodeArtField(WellKnownClasses::dalvik_system_BaseDexClassLoader_pathList)->
+          GetObject(class_loader);
+  if (dex_path_list == nullptr) {
+    return nullptr;
+  }
+  return jni::DecodeArtField(WellKnownClasses::dalvik_system_DexPathList_dexElements)->
+      GetObject(dex_path_list);
+}
+
 // Visit the DexPathList$Element instances in the given classloader with the given visitor.
 // Constraints on the visitor:
 //   * The visitor should return true to continue visiting more Elements.
@@ -38,6 +38,7 @@ void ClassTable::VisitRoots(Visitor& visitor) {
   for (GcRoot<mirror::Object>& root : strong_roots_) {
     visitor.VisitRoot(root.AddressWithoutBarrier());
   }
+  visitor.VisitRootIfNonNull(known_missing_dex_elements_.AddressWithoutBarrier());
   for (const OatFile* oat_file : oat_files_) {
     for (GcRoot<mirror::Object>& root : oat_file->GetBssGcRoots()) {
       visitor.VisitRootIfNonNull(root.AddressWithoutBarrier());
@@ -56,6 +57,7 @@ void ClassTable::VisitRoots(const Visitor& visitor) {
   for (GcRoot<mirror::Object>& root : strong_roots_) {
     visitor.VisitRoot(root.AddressWithoutBarrier());
   }
+  visitor.VisitRootIfNonNull(known_missing_dex_elements_.AddressWithoutBarrier());
   for (const OatFile* oat_file : oat_files_) {
     for (GcRoot<mirror::Object>& root : oat_file->GetBssGcRoots()) {
       visitor.VisitRootIfNonNull(root.AddressWithoutBarrier());
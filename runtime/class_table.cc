@@ -16,21 +16,50 @@
 
 #include "class_table-inl.h"
 
+#include <string_view>
+
 #include "base/stl_util.h"
 #include "mirror/class-inl.h"
 #include "oat_file.h"
 
 namespace art {
 
-ClassTable::ClassTable() : lock_("Class loader classes", kClassLoaderClassesLock) {
+class ClassTable::ScopedWriteSequence {
+ public:
+  explicit ScopedWriteSequence(ClassTable* table) : table_(table) {
+    const uint32_t sequence = table_->sequence_.load(std::memory_order_relaxed);
+    DCHECK_EQ(sequence & 1u, 0u);
+    table_->sequence_.store(sequence + 1u, std::memory_order_relaxed);
+    // Order the odd sequence before any of the writes to the class sets.
+    std::atomic_thread_fence(std::memory_order_release);
+  }
+
+  ~ScopedWriteSequence() {
+    const uint32_t sequence = table_->sequence_.load(std::memory_order_relaxed);
+    table_->sequence_.store(sequence + 1u, std::memory_order_release);
+  }
+
+ private:
+  ClassTable* const table_;
+
+  DISALLOW_COPY_AND_ASSIGN(ScopedWriteSequence);
+};
+
+ClassTable::ClassTable()
+    : lock_("Class loader classes", kClassLoaderClassesLock),
+      sequence_(0u),
+      read_view_(nullptr) {
   Runtime* const runtime = Runtime::Current();
   classes_.push_back(ClassSet(runtime->GetHashTableMinLoadFactor(),
                               runtime->GetHashTableMaxLoadFactor()));
+  PublishReadView();
 }
 
 void ClassTable::FreezeSnapshot() {
   WriterMutexLock mu(Thread::Current(), lock_);
+  ScopedWriteSequence sws(this);
   classes_.push_back(ClassSet());
+  PublishReadView();
 }
 
 bool ClassTable::Contains(ObjPtr<mirror::Class> klass) {
@@ -38,15 +67,9 @@ bool ClassTable::Contains(ObjPtr<mirror::Class> klass) {
 }
 
 ObjPtr<mirror::Class> ClassTable::LookupByDescriptor(ObjPtr<mirror::Class> klass) {
-  ReaderMutexLock mu(Thread::Current(), lock_);
-  TableSlot slot(klass);
-  for (ClassSet& class_set : classes_) {
-    auto it = class_set.find(slot);
-    if (it != class_set.end()) {
-      return it->Read();
-    }
-  }
-  return nullptr;
+  std::string temp;
+  const char* descriptor = klass->GetDescriptor(&temp);
+  return Lookup(descriptor, ComputeModifiedUtf8Hash(descriptor));
 }
 
 ObjPtr<mirror::Class> ClassTable::UpdateClass(const char* descriptor,
@@ -72,6 +95,7 @@ ObjPtr<mirror::Class> ClassTable::UpdateClass(const char* descriptor,
   VerifyObject(klass);
   // Update the element in the hash set with the new class. This is safe to do since the descriptor
   // doesn't change.
+  ScopedWriteSequence sws(this);
   *existing_it = TableSlot(klass, hash);
   return existing;
 }
@@ -117,6 +141,10 @@ size_t ClassTable::NumReferencedNonZygoteClasses() const {
 
 ObjPtr<mirror::Class> ClassTable::Lookup(const char* descriptor, size_t hash) {
   DescriptorHashPair pair(descriptor, hash);
+  ObjPtr<mirror::Class> result;
+  if (TryLookupWithoutLock(pair, hash, &result)) {
+    return result;
+  }
   ReaderMutexLock mu(Thread::Current(), lock_);
   for (ClassSet& class_set : classes_) {
     auto it = class_set.FindWithHash(pair, hash);
@@ -127,23 +155,105 @@ ObjPtr<mirror::Class> ClassTable::Lookup(const char* descriptor, size_t hash) {
   return nullptr;
 }
 
+bool ClassTable::TryLookupWithoutLock(const DescriptorHashPair& pair,
+                                      size_t hash,
+                                      /*out*/ ObjPtr<mirror::Class>* result) {
+  ClassDescriptorHashEquals pred;
+  for (size_t attempt = 0; attempt != kMaxLockFreeLookupAttempts; ++attempt) {
+    const uint32_t sequence = sequence_.load(std::memory_order_acquire);
+    if ((sequence & 1u) != 0u) {
+      continue;  // A writer is modifying the class sets.
+    }
+    // The probing below may observe a class set in the middle of a modification, for example an
+    // erase shifting entries back, but every non-null slot it sees refers to a class that was in
+    // the table during this attempt. Such a class cannot be freed before we reach a suspend point
+    // since we hold the mutator lock, so comparing its descriptor is safe; the sequence check
+    // then rejects any result that may be inconsistent.
+    const ReadView* view = read_view_.load(std::memory_order_acquire);
+    ObjPtr<mirror::Class> found = nullptr;
+    for (const ReadView::Buckets& buckets : view->sets) {
+      if (buckets.num_buckets == 0u) {
+        continue;
+      }
+      size_t index = hash % buckets.num_buckets;
+      for (size_t probes = 0; probes != buckets.num_buckets; ++probes) {
+        const TableSlot& slot = buckets.data[index];
+        if (slot.IsNull()) {
+          break;
+        }
+        if (pred(slot, pair)) {
+          // Do not use the read barrier here, it may update the slot.
+          found = slot.Read<kWithoutReadBarrier>();
+          break;
+        }
+        index = (index + 1u == buckets.num_buckets) ? 0u : index + 1u;
+      }
+      if (found != nullptr) {
+        break;
+      }
+    }
+    // Order the reads of the slots before re-reading the sequence.
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (sequence_.load(std::memory_order_relaxed) == sequence) {
+      *result = (found != nullptr) ? GcRoot<mirror::Class>(found).Read() : nullptr;
+      return true;
+    }
+  }
+  return false;
+}
+
+void ClassTable::InsertLocked(const TableSlot& slot, size_t hash) {
+  ScopedWriteSequence sws(this);
+  ClassSet& latest = classes_.back();
+  if (latest.size() >= latest.ElementsUntilExpand()) {
+    GrowLatestClassSet();
+  }
+  DCHECK_LT(latest.size(), latest.ElementsUntilExpand());
+  latest.InsertWithHash(slot, hash);
+}
+
+void ClassTable::GrowLatestClassSet() {
+  ClassSet& latest = classes_.back();
+  // Grow like HashSet::Expand() would, based on the minimum load factor, but into new storage.
+  ClassSet grown(latest.GetMinLoadFactor(), latest.GetMaxLoadFactor());
+  grown.reserve(
+      static_cast<size_t>(latest.size() * latest.GetMaxLoadFactor() / latest.GetMinLoadFactor()));
+  for (const TableSlot& slot : latest) {
+    grown.insert(slot);
+  }
+  latest.swap(grown);
+  retired_class_sets_.push_back(std::move(grown));
+  PublishReadView();
+}
+
+void ClassTable::PublishReadView() {
+  std::unique_ptr<ReadView> view(new ReadView());
+  view->sets.reserve(classes_.size());
+  for (const ClassSet& class_set : classes_) {
+    view->sets.push_back({class_set.data(), class_set.NumBuckets()});
+  }
+  read_view_.store(view.get(), std::memory_order_release);
+  read_views_.push_back(std::move(view));
+}
+
 ObjPtr<mirror::Class> ClassTable::TryInsert(ObjPtr<mirror::Class> klass) {
-  TableSlot slot(klass);
+  const uint32_t hash = TableSlot::HashDescriptor(klass);
+  TableSlot slot(klass, hash);
   WriterMutexLock mu(Thread::Current(), lock_);
   for (ClassSet& class_set : classes_) {
-    auto it = class_set.find(slot);
+    auto it = class_set.FindWithHash(slot, hash);
     if (it != class_set.end()) {
       return it->Read();
     }
   }
-  classes_.back().insert(slot);
+  InsertLocked(slot, hash);
   return klass;
 }
 
 void ClassTable::Insert(ObjPtr<mirror::Class> klass) {
   const uint32_t hash = TableSlot::HashDescriptor(klass);
   WriterMutexLock mu(Thread::Current(), lock_);
-  classes_.back().InsertWithHash(TableSlot(klass, hash), hash);
+  InsertLocked(TableSlot(klass, hash), hash);
 }
 
 void ClassTable::CopyWithoutLocks(const ClassTable& source_table) {
@@ -152,21 +262,53 @@ void ClassTable::CopyWithoutLocks(const ClassTable& source_table) {
       CHECK(class_set.empty());
     }
   }
+  ClassDescriptorHashEquals hash_fn;
   for (const ClassSet& class_set : source_table.classes_) {
     for (const TableSlot& slot : class_set) {
-      classes_.back().insert(slot);
+      InsertLocked(slot, hash_fn(slot));
     }
   }
 }
 
 void ClassTable::InsertWithoutLocks(ObjPtr<mirror::Class> klass) {
   const uint32_t hash = TableSlot::HashDescriptor(klass);
-  classes_.back().InsertWithHash(TableSlot(klass, hash), hash);
+  InsertLocked(TableSlot(klass, hash), hash);
+}
+
+size_t ClassTable::DescriptorHash::operator()(const std::string& descriptor) const {
+  return ComputeModifiedUtf8Hash(descriptor.c_str());
+}
+
+bool ClassTable::IsKnownMissingFromDexPath(const char* descriptor,
+                                           size_t hash,
+                                           ObjPtr<mirror::Object> dex_elements) {
+  ReaderMutexLock mu(Thread::Current(), lock_);
+  return !known_missing_dex_elements_.IsNull() &&
+         known_missing_dex_elements_.Read() == dex_elements &&
+         known_missing_from_dex_path_.FindWithHash(std::string_view(descriptor), hash) !=
+             known_missing_from_dex_path_.end();
+}
+
+void ClassTable::AddKnownMissingFromDexPath(const char* descriptor,
+                                            size_t hash,
+                                            ObjPtr<mirror::Object> dex_elements) {
+  DCHECK(dex_elements != nullptr);
+  WriterMutexLock mu(Thread::Current(), lock_);
+  if (known_missing_dex_elements_.IsNull() ||
+      known_missing_dex_elements_.Read() != dex_elements ||
+      known_missing_from_dex_path_.size() >= kMaxKnownMissingFromDexPath) {
+    known_missing_from_dex_path_.clear();
+    known_missing_dex_elements_ = GcRoot<mirror::Object>(dex_elements);
+  }
+  if (known_missing_from_dex_path_.FindWithHash(std::string_view(descriptor), hash) ==
+      known_missing_from_dex_path_.end()) {
+    known_missing_from_dex_path_.InsertWithHash(std::string(descriptor), hash);
+  }
 }
 
 void ClassTable::InsertWithHash(ObjPtr<mirror::Class> klass, size_t hash) {
   WriterMutexLock mu(Thread::Current(), lock_);
-  classes_.back().InsertWithHash(TableSlot(klass, hash), hash);
+  InsertLocked(TableSlot(klass, hash), hash);
 }
 
 bool ClassTable::Remove(const char* descriptor) {
@@ -175,6 +317,7 @@ bool ClassTable::Remove(const char* descriptor) {
   for (ClassSet& class_set : classes_) {
     auto it = class_set.find(pair);
     if (it != class_set.end()) {
+      ScopedWriteSequence sws(this);
       class_set.erase(it);
       return true;
     }
@@ -283,7 +426,9 @@ size_t ClassTable::ReadFromMemory(uint8_t* ptr) {
 
 void ClassTable::AddClassSet(ClassSet&& set) {
   WriterMutexLock mu(Thread::Current(), lock_);
+  ScopedWriteSequence sws(this);
   classes_.insert(classes_.begin(), std::move(set));
+  PublishReadView();
 }
 
 void ClassTable::ClearStrongRoots() {
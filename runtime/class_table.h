@@ -17,11 +17,13 @@
 #ifndef ART_RUNTIME_CLASS_TABLE_H_
 #define ART_RUNTIME_CLASS_TABLE_H_
 
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "base/allocator.h"
+#include "base/atomic.h"
 #include "base/hash_set.h"
 #include "base/macros.h"
 #include "base/mutex.h"
@@ -200,6 +202,7 @@ class ClassTable {
       REQUIRES_SHARED(Locks::mutator_lock_);
 
   // Return the first class that matches the descriptor. Returns null if there are none.
+  // Readers normally do not take `lock_`, see TryLookupWithoutLock().
   ObjPtr<mirror::Class> Lookup(const char* descriptor, size_t hash)
       REQUIRES(!lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
@@ -223,6 +226,21 @@ class ClassTable {
       REQUIRES(!lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Negative cache of descriptors that the dex files of the owning class loader do not define,
+  // see ClassLinker::FindClassInBaseDexClassLoaderClassPath(). The entries are only valid for
+  // the DexPathList.dexElements array they were recorded for, recording a miss for another array
+  // drops them.
+  bool IsKnownMissingFromDexPath(const char* descriptor,
+                                 size_t hash,
+                                 ObjPtr<mirror::Object> dex_elements)
+      REQUIRES(!lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+  void AddKnownMissingFromDexPath(const char* descriptor,
+                                  size_t hash,
+                                  ObjPtr<mirror::Object> dex_elements)
+      REQUIRES(!lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   // Returns true if the class was found and removed, false otherwise.
   bool Remove(const char* descriptor)
       REQUIRES(!lock_)
@@ -269,10 +287,49 @@ class ClassTable {
   }
 
  private:
+  // Snapshot of the bucket arrays of `classes_`, used by lookups that do not take `lock_`. A view
+  // is immutable once published and, like every bucket array it refers to, is only freed with
+  // the table.
+  struct ReadView {
+    struct Buckets {
+      const TableSlot* data;
+      size_t num_buckets;
+    };
+    std::vector<Buckets> sets;
+  };
+
+  // Brackets a mutation of `classes_` by making `sequence_` odd for its duration.
+  class ScopedWriteSequence;
+
+  // Number of lock-free lookup attempts before a reader falls back to taking `lock_`.
+  static constexpr size_t kMaxLockFreeLookupAttempts = 3u;
+
   // Only copies classes.
   void CopyWithoutLocks(const ClassTable& source_table) NO_THREAD_SAFETY_ANALYSIS;
   void InsertWithoutLocks(ObjPtr<mirror::Class> klass) NO_THREAD_SAFETY_ANALYSIS;
 
+  // Look up `pair` in the published read view without taking `lock_` and without writing to any
+  // shared memory. Returns false if writers kept interfering, in which case the caller must retry
+  // with `lock_` held.
+  bool TryLookupWithoutLock(const DescriptorHashPair& pair,
+                            size_t hash,
+                            /*out*/ ObjPtr<mirror::Class>* result)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Insert into the latest class set. Never lets the hash set reallocate in place since lock-free
+  // readers may still be probing the old bucket array; see GrowLatestClassSet().
+  void InsertLocked(const TableSlot& slot, size_t hash)
+      REQUIRES(lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Move the latest class set to a larger bucket array and retire the old one.
+  void GrowLatestClassSet()
+      REQUIRES(lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Publish a new ReadView of `classes_`. Requires `lock_` unless the table is not shared yet.
+  void PublishReadView() NO_THREAD_SAFETY_ANALYSIS;
+
   size_t CountDefiningLoaderClasses(ObjPtr<mirror::ClassLoader> defining_loader,
                                     const ClassSet& set) const
       REQUIRES(lock_)
@@ -283,6 +340,15 @@ class ClassTable {
       REQUIRES(lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // The negative cache is dropped instead of growing past this.
+  static constexpr size_t kMaxKnownMissingFromDexPath = 1024;
+
+  class DescriptorHash {
+   public:
+    size_t operator()(const std::string& descriptor) const;
+  };
+  using DescriptorSet = HashSet<std::string, DefaultEmptyFn<std::string>, DescriptorHash>;
+
   // Lock to guard inserting and removing.
   mutable ReaderWriterMutex lock_;
   // We have a vector to help prevent dirty pages after the zygote forks by calling FreezeSnapshot.
@@ -293,6 +359,17 @@ class ClassTable {
   std::vector<GcRoot<mirror::Object>> strong_roots_ GUARDED_BY(lock_);
   // Keep track of oat files with GC roots associated with dex caches in `strong_roots_`.
   std::vector<const OatFile*> oat_files_ GUARDED_BY(lock_);
+  // Seqlock sequence for lock-free readers, odd while a writer is modifying `classes_`.
+  Atomic<uint32_t> sequence_;
+  // Current view of `classes_` for lock-free readers.
+  Atomic<const ReadView*> read_view_;
+  // All views ever published and the bucket arrays replaced by GrowLatestClassSet(). Readers may
+  // hold on to them without any synchronization so they are kept until the table is destroyed.
+  std::vector<std::unique_ptr<const ReadView>> read_views_ GUARDED_BY(lock_);
+  std::vector<ClassSet> retired_class_sets_ GUARDED_BY(lock_);
+  // The dexElements array `known_missing_from_dex_path_` is valid for, null if it is empty.
+  GcRoot<mirror::Object> known_missing_dex_elements_ GUARDED_BY(lock_);
+  DescriptorSet known_missing_from_dex_path_ GUARDED_BY(lock_);
 
   friend class linker::ImageWriter;  // for InsertWithoutLocks.
 };
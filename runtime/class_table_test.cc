@@ -19,12 +19,14 @@
 #include "art_field-inl.h"
 #include "art_method-inl.h"
 #include "class_linker-inl.h"
+#include "class_root.h"
 #include "common_runtime_test.h"
 #include "dex/dex_file.h"
 #include "gc/accounting/card_table-inl.h"
 #include "gc/heap.h"
 #include "handle_scope-inl.h"
 #include "mirror/class-alloc-inl.h"
+#include "mirror/object_array-alloc-inl.h"
 #include "obj_ptr.h"
 #include "scoped_thread_state_change-inl.h"
 
@@ -159,5 +161,73 @@ TEST_F(ClassTableTest, ClassTable) {
   // TODO: Add tests for UpdateClass, InsertOatFile.
 }
 
+TEST_F(ClassTableTest, LookupAcrossGrowth) {
+  ScopedObjectAccess soa(Thread::Current());
+  class CollectClassesVisitor : public ClassVisitor {
+   public:
+    bool operator()(ObjPtr<mirror::Class> klass) override {
+      classes_.push_back(klass.Ptr());
+      return true;
+    }
+    std::vector<mirror::Class*> classes_;
+  };
+  CollectClassesVisitor visitor;
+  class_linker_->VisitClasses(&visitor);
+  // Needs enough classes to grow the latest class set several times.
+  ASSERT_GT(visitor.classes_.size(), 2000u);
+
+  ClassTable table;
+  const size_t half = visitor.classes_.size() / 2;
+  for (size_t i = 0; i != visitor.classes_.size(); ++i) {
+    if (i == half) {
+      table.FreezeSnapshot();
+    }
+    table.Insert(visitor.classes_[i]);
+  }
+  for (mirror::Class* klass : visitor.classes_) {
+    std::string temp;
+    const char* descriptor = klass->GetDescriptor(&temp);
+    EXPECT_OBJ_PTR_EQ(table.Lookup(descriptor, ComputeModifiedUtf8Hash(descriptor)), klass);
+    EXPECT_OBJ_PTR_EQ(table.LookupByDescriptor(klass), klass);
+  }
+  EXPECT_EQ(table.NumReferencedZygoteClasses(), half);
+  EXPECT_EQ(table.NumReferencedNonZygoteClasses(), visitor.classes_.size() - half);
+}
+
+TEST_F(ClassTableTest, KnownMissingFromDexPath) {
+  ScopedObjectAccess soa(Thread::Current());
+  StackHandleScope<3> hs(soa.Self());
+  ObjPtr<mirror::Class> object_array_class = GetClassRoot<ObjectArray<Object>>();
+  Handle<ObjectArray<Object>> dex_elements =
+      hs.NewHandle(ObjectArray<Object>::Alloc(soa.Self(), object_array_class, 1));
+  Handle<ObjectArray<Object>> other_dex_elements =
+      hs.NewHandle(ObjectArray<Object>::Alloc(soa.Self(), object_array_class, 2));
+  ASSERT_TRUE(dex_elements != nullptr);
+  ASSERT_TRUE(other_dex_elements != nullptr);
+  const char* descriptor = "LNotThere;";
+  const size_t hash = ComputeModifiedUtf8Hash(descriptor);
+  ClassTable table;
+  EXPECT_FALSE(table.IsKnownMissingFromDexPath(descriptor, hash, dex_elements.Get()));
+
+  table.AddKnownMissingFromDexPath(descriptor, hash, dex_elements.Get());
+  EXPECT_TRUE(table.IsKnownMissingFromDexPath(descriptor, hash, dex_elements.Get()));
+  const char* other_descriptor = "LAlsoNotThere;";
+  EXPECT_FALSE(table.IsKnownMissingFromDexPath(
+      other_descriptor, ComputeModifiedUtf8Hash(other_descriptor), dex_elements.Get()));
+  // Entries do not apply to another dex path.
+  EXPECT_FALSE(table.IsKnownMissingFromDexPath(descriptor, hash, other_dex_elements.Get()));
+
+  // Recording a miss for the new dex path drops the old entries.
+  table.AddKnownMissingFromDexPath(
+      other_descriptor, ComputeModifiedUtf8Hash(other_descriptor), other_dex_elements.Get());
+  EXPECT_FALSE(table.IsKnownMissingFromDexPath(descriptor, hash, dex_elements.Get()));
+  EXPECT_FALSE(table.IsKnownMissingFromDexPath(descriptor, hash, other_dex_elements.Get()));
+
+  // The dex elements are a root of the table.
+  CollectRootVisitor roots;
+  table.VisitRoots(roots);
+  EXPECT_TRUE(roots.roots_.find(other_dex_elements.Get()) != roots.roots_.end());
+}
+
 }  // namespace mirror
 }  // namespace art
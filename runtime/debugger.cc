@@ -985,9 +985,7 @@ JDWP::JdwpError Dbg::GetInstances(JDWP::RefTypeId class_id, int32_t max_count,
                                               /* use_is_assignable_from= */ false,
                                               max_count,
                                               raw_instances);
-  for (size_t i = 0; i < raw_instances.size(); ++i) {
-    instances->push_back(gRegistry->Add(raw_instances[i].Get()));
-  }
+  gRegistry->AddAll(raw_instances, instances);
   return JDWP::ERR_NONE;
 }
 
@@ -1003,9 +1001,7 @@ JDWP::JdwpError Dbg::GetReferringObjects(JDWP::ObjectId object_id, int32_t max_c
   VariableSizedHandleScope hs(Thread::Current());
   std::vector<Handle<mirror::Object>> raw_instances;
   heap->GetReferringObjects(hs, hs.NewHandle(o), max_count, raw_instances);
-  for (size_t i = 0; i < raw_instances.size(); ++i) {
-    referring_objects->push_back(gRegistry->Add(raw_instances[i].Get()));
-  }
+  gRegistry->AddAll(raw_instances, referring_objects);
   return JDWP::ERR_NONE;
 }
 
@@ -1049,8 +1045,8 @@ JDWP::JdwpError Dbg::IsCollected(JDWP::ObjectId object_id, bool* is_collected) {
   return JDWP::ERR_NONE;
 }
 
-void Dbg::DisposeObject(JDWP::ObjectId object_id, uint32_t reference_count) {
-  gRegistry->DisposeObject(object_id, reference_count);
+void Dbg::DisposeObjects(const std::vector<std::pair<JDWP::ObjectId, uint32_t>>& objects) {
+  gRegistry->DisposeObjects(objects);
 }
 
 JDWP::JdwpTypeTag Dbg::GetTypeTag(ObjPtr<mirror::Class> klass) {
@@ -24,6 +24,7 @@
 #include <pthread.h>
 
 #include <set>
+#include <utility>
 #include <string>
 #include <vector>
 
@@ -399,7 +400,7 @@ class Dbg {
       REQUIRES_SHARED(Locks::mutator_lock_);
   static JDWP::JdwpError IsCollected(JDWP::ObjectId object_id, bool* is_collected)
       REQUIRES_SHARED(Locks::mutator_lock_);
-  static void DisposeObject(JDWP::ObjectId object_id, uint32_t reference_count)
+  static void DisposeObjects(const std::vector<std::pair<JDWP::ObjectId, uint32_t>>& objects)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
   //
@@ -17,6 +17,8 @@
 #ifndef ART_RUNTIME_DEOPTIMIZATION_KIND_H_
 #define ART_RUNTIME_DEOPTIMIZATION_KIND_H_
 
+#include "base/logging.h"
+
 namespace art {
 
 enum class DeoptimizationKind {
@@ -28,7 +30,8 @@ enum class DeoptimizationKind {
   kBlockBCE,
   kCHA,
   kFullFrame,
-  kLast = kFullFrame
+  kJitOsr,
+  kLast = kJitOsr
 };
 
 inline const char* GetDeoptimizationKindName(DeoptimizationKind kind) {
@@ -41,6 +44,7 @@ inline const char* GetDeoptimizationKindName(DeoptimizationKind kind) {
     case DeoptimizationKind::kBlockBCE: return "block bounds check elimination";
     case DeoptimizationKind::kCHA: return "class hierarchy analysis";
     case DeoptimizationKind::kFullFrame: return "full frame";
+    case DeoptimizationKind::kJitOsr: return "JIT on-stack replacement";
   }
   LOG(FATAL) << "Unexpected kind " << static_cast<size_t>(kind);
   UNREACHABLE();
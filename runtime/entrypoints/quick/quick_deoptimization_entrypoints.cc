@@ -16,7 +16,9 @@
 
 #include "base/logging.h"  // For VLOG_IS_ON.
 #include "base/mutex.h"
+#include "base/time_utils.h"
 #include "callee_save_frame.h"
+#include "flight_recorder.h"
 #include "interpreter/interpreter.h"
 #include "obj_ptr-inl.h"  // TODO: Find the other include that isn't complete, and clean this up.
 #include "quick_exception_handler.h"
@@ -28,6 +30,15 @@ namespace art {
 NO_RETURN static void artDeoptimizeImpl(Thread* self, DeoptimizationKind kind, bool single_frame)
     REQUIRES_SHARED(Locks::mutator_lock_) {
   Runtime::Current()->IncrementDeoptimizationCount(kind);
+  FlightRecorder* flight_recorder = Runtime::Current()->GetFlightRecorder();
+  if (flight_recorder != nullptr) {
+    flight_recorder->Record(self,
+                            FlightRecorder::EventType::kDeoptimization,
+                            NanoTime(),
+                            /* duration_ns= */ 0u,
+                            static_cast<uint32_t>(kind),
+                            /* name= */ nullptr);
+  }
   if (VLOG_IS_ON(deopt)) {
     if (single_frame) {
       // Deopt logging will be in DeoptimizeSingleFrame. It is there to take advantage of the
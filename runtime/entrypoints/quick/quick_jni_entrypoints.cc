@@ -63,25 +63,37 @@ extern uint32_t JniMethodFastStart(Thread* self) {
 }
 
 // Called on entry to JNI, transition out of Runnable and release share of mutator_lock_.
+// Unsynchronized @FastNative methods use JniMethodFastStart, so there is no need to look up the
+// native method here.
 extern uint32_t JniMethodStart(Thread* self) {
   JNIEnvExt* env = self->GetJniEnv();
   DCHECK(env != nullptr);
   uint32_t saved_local_ref_cookie = bit_cast<uint32_t>(env->GetLocalRefCookie());
   env->SetLocalRefCookie(env->GetLocalsSegmentState());
-  ArtMethod* native_method = *self->GetManagedStack()->GetTopQuickFrame();
-  // TODO: Introduce special entrypoint for synchronized @FastNative methods?
-  //       Or ban synchronized @FastNative outright to avoid the extra check here?
-  DCHECK(!native_method->IsFastNative() || native_method->IsSynchronized());
-  if (!native_method->IsFastNative()) {
-    // When not fast JNI we transition out of runnable.
-    self->TransitionFromRunnableToSuspended(kNative);
+  if (kIsDebugBuild) {
+    ArtMethod* native_method = *self->GetManagedStack()->GetTopQuickFrame();
+    CHECK(!native_method->IsFastNative()) << native_method->PrettyMethod();
   }
+  self->TransitionFromRunnableToSuspended(kNative);
   return saved_local_ref_cookie;
 }
 
+// TODO: Introduce special entrypoint for synchronized @FastNative methods?
+//       Or ban synchronized @FastNative outright to avoid the extra check here?
 extern uint32_t JniMethodStartSynchronized(jobject to_lock, Thread* self) {
   self->DecodeJObject(to_lock)->MonitorEnter(self);
-  return JniMethodStart(self);
+  ArtMethod* native_method = *self->GetManagedStack()->GetTopQuickFrame();
+  return native_method->IsFastNative() ? JniMethodFastStart(self) : JniMethodStart(self);
+}
+
+// For the entrypoints that only normal native methods use, the stubs and the generic JNI
+// trampoline pick the Fast variants for @FastNative methods.
+static void GoToRunnableNormal(Thread* self) NO_THREAD_SAFETY_ANALYSIS {
+  if (kIsDebugBuild) {
+    ArtMethod* native_method = *self->GetManagedStack()->GetTopQuickFrame();
+    CHECK(!native_method->IsFastNative()) << native_method->PrettyMethod();
+  }
+  self->TransitionFromSuspendedToRunnable();
 }
 
 // TODO: NO_THREAD_SAFETY_ANALYSIS due to different control paths depending on fast JNI.
@@ -127,7 +139,7 @@ static void PopLocalReferences(uint32_t saved_local_ref_cookie, Thread* self)
 // Otherwise there's just too much repetitive boilerplate.
 
 extern void JniMethodEnd(uint32_t saved_local_ref_cookie, Thread* self) {
-  GoToRunnable(self);
+  GoToRunnableNormal(self);
   PopLocalReferences(saved_local_ref_cookie, self);
 }
 
@@ -176,7 +188,7 @@ extern mirror::Object* JniMethodFastEndWithReference(jobject result,
 extern mirror::Object* JniMethodEndWithReference(jobject result,
                                                  uint32_t saved_local_ref_cookie,
                                                  Thread* self) {
-  GoToRunnable(self);
+  GoToRunnableNormal(self);
   return JniMethodEndWithReferenceHandleResult(result, saved_local_ref_cookie, self);
 }
 
@@ -203,7 +215,7 @@ extern uint64_t GenericJniMethodEnd(Thread* self,
 
   // @Fast and @CriticalNative do not do a state transition.
   if (LIKELY(normal_native)) {
-    GoToRunnable(self);
+    GoToRunnableNormal(self);
   }
   // We need the mutator lock (i.e., calling GoToRunnable()) before accessing the shorty or the
   // locked object.
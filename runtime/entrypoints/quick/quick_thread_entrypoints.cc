@@ -15,14 +15,26 @@
  */
 
 #include "callee_save_frame.h"
+#include "deoptimization_kind.h"
+#include "jit/jit.h"
+#include "runtime.h"
 #include "thread-inl.h"
 
 namespace art {
 
+extern "C" NO_RETURN void artDeoptimizeFromCompiledCode(DeoptimizationKind kind, Thread* self)
+    REQUIRES_SHARED(Locks::mutator_lock_);
+
 extern "C" void artTestSuspendFromCode(Thread* self) REQUIRES_SHARED(Locks::mutator_lock_) {
   // Called when suspend count check value is 0 and thread->suspend_count_ != 0
   ScopedQuickEntrypointChecks sqec(self);
   self->CheckSuspend();
+  jit::Jit* jit = Runtime::Current()->GetJit();
+  if (jit != nullptr && jit->ShouldLeaveBaselineLoop(self)) {
+    // Resume the loop in the interpreter, which enters the OSR compiled code at its next back
+    // edge.
+    artDeoptimizeFromCompiledCode(DeoptimizationKind::kJitOsr, self);
+  }
 }
 
 }  // namespace art
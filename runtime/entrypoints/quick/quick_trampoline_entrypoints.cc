@@ -2306,12 +2306,13 @@ extern "C" const void* artFindNativeMethod(Thread* self);
 
 static uint64_t artQuickGenericJniEndJNIRef(Thread* self,
                                             uint32_t cookie,
-                                            bool fast_native ATTRIBUTE_UNUSED,
+                                            bool fast_native,
                                             jobject l,
                                             jobject lock) {
-  // TODO: add entrypoints for @FastNative returning objects.
   if (lock != nullptr) {
     return reinterpret_cast<uint64_t>(JniMethodEndWithReferenceSynchronized(l, cookie, lock, self));
+  } else if (UNLIKELY(fast_native)) {
+    return reinterpret_cast<uint64_t>(JniMethodFastEndWithReference(l, cookie, self));
   } else {
     return reinterpret_cast<uint64_t>(JniMethodEndWithReference(l, cookie, self));
   }
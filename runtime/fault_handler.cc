@@ -330,15 +330,20 @@ bool FaultManager::IsInGeneratedCode(siginfo_t* siginfo, void* context, bool che
 
   // We can be certain that this is a method now.  Check if we have a GC map
   // at the return PC address.
-  if (true || kIsDebugBuild) {
+  if (VLOG_IS_ON(signals)) {
     VLOG(signals) << "looking for dex pc for return pc " << std::hex << return_pc;
     uint32_t sought_offset = return_pc -
         reinterpret_cast<uintptr_t>(method_header->GetEntryPoint());
     VLOG(signals) << "pc offset: " << std::hex << sought_offset;
   }
+  if (!check_dex_pc) {
+    // Decoding the stack maps is the most expensive part of the check, skip it when the
+    // caller does not need a dex pc.
+    return true;
+  }
   uint32_t dexpc = method_header->ToDexPc(method_obj, return_pc, false);
   VLOG(signals) << "dexpc: " << dexpc;
-  return !check_dex_pc || dexpc != dex::kDexNoIndex;
+  return dexpc != dex::kDexNoIndex;
 }
 
 FaultHandler::FaultHandler(FaultManager* manager) : manager_(manager) {
@@ -0,0 +1,182 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "flight_recorder.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <ostream>
+
+#include "base/time_utils.h"
+#include "deoptimization_kind.h"
+#include "gc/gc_cause.h"
+#include "thread.h"
+
+namespace art {
+
+// Written only by the thread which owns it, read by anyone who dumps the recorder.
+class FlightRecorderRing {
+ public:
+  FlightRecorderRing() : count_(0u) {}
+
+  void Add(const FlightRecorder::Event& event) {
+    size_t count = count_.load(std::memory_order_relaxed);
+    events_[count % FlightRecorder::kEventsPerThread] = event;
+    count_.store(count + 1u, std::memory_order_release);
+  }
+
+  void CopyTo(std::vector<FlightRecorder::Event>* events) const {
+    size_t count = count_.load(std::memory_order_acquire);
+    size_t first = count - std::min(count, FlightRecorder::kEventsPerThread);
+    for (size_t i = first; i != count; ++i) {
+      events->push_back(events_[i % FlightRecorder::kEventsPerThread]);
+    }
+  }
+
+ private:
+  Atomic<size_t> count_;
+  FlightRecorder::Event events_[FlightRecorder::kEventsPerThread];
+
+  DISALLOW_COPY_AND_ASSIGN(FlightRecorderRing);
+};
+
+FlightRecorder::FlightRecorder() : lock_("flight recorder lock", kGenericBottomLock) {}
+
+FlightRecorder::~FlightRecorder() {}
+
+FlightRecorderRing* FlightRecorder::AcquireRing(Thread* self) {
+  MutexLock mu(self, lock_);
+  FlightRecorderRing* ring = nullptr;
+  if (!free_rings_.empty()) {
+    ring = free_rings_.back();
+    free_rings_.pop_back();
+  } else if (rings_.size() != kMaxRings) {
+    rings_.emplace_back(new FlightRecorderRing());
+    ring = rings_.back().get();
+  }
+  return ring;
+}
+
+void FlightRecorder::ReleaseRing(Thread* self) {
+  FlightRecorderRing* ring = self->GetFlightRecorderRing();
+  if (ring != nullptr) {
+    self->SetFlightRecorderRing(nullptr);
+    MutexLock mu(self, lock_);
+    free_rings_.push_back(ring);
+  }
+}
+
+void FlightRecorder::Record(Thread* self,
+                            EventType type,
+                            uint64_t start_ns,
+                            uint64_t duration_ns,
+                            uint32_t arg,
+                            const char* name) {
+  if (self == nullptr) {
+    return;
+  }
+  FlightRecorderRing* ring = self->GetFlightRecorderRing();
+  if (UNLIKELY(ring == nullptr)) {
+    ring = AcquireRing(self);
+    if (ring == nullptr) {
+      return;
+    }
+    self->SetFlightRecorderRing(ring);
+  }
+  Event event;
+  event.start_ns = start_ns;
+  event.duration_ns = duration_ns;
+  event.tid = static_cast<uint32_t>(self->GetTid());
+  event.arg = arg;
+  event.type = type;
+  if (name != nullptr) {
+    size_t length = strlen(name);
+    size_t offset = (length < kNameSize) ? 0u : length - (kNameSize - 1u);
+    memcpy(event.name, name + offset, length - offset);
+    event.name[length - offset] = '\0';
+  } else {
+    event.name[0] = '\0';
+  }
+  ring->Add(event);
+}
+
+std::vector<FlightRecorder::Event> FlightRecorder::GetEvents() {
+  std::vector<Event> events;
+  {
+    MutexLock mu(Thread::Current(), lock_);
+    events.reserve(rings_.size() * kEventsPerThread);
+    for (const std::unique_ptr<FlightRecorderRing>& ring : rings_) {
+      ring->CopyTo(&events);
+    }
+  }
+  std::stable_sort(events.begin(), events.end(), [](const Event& lhs, const Event& rhs) {
+    return lhs.start_ns < rhs.start_ns;
+  });
+  return events;
+}
+
+const char* FlightRecorder::EventTypeName(EventType type) {
+  switch (type) {
+    case EventType::kGc: return "GC";
+    case EventType::kJitCompile: return "JIT compile";
+    case EventType::kDeoptimization: return "Deoptimization";
+    case EventType::kMonitorContention: return "Monitor contention";
+    case EventType::kClassPrepare: return "Class prepare";
+    case EventType::kSuspendAll: return "Suspend all";
+  }
+  UNREACHABLE();
+}
+
+void FlightRecorder::Dump(std::ostream& os) {
+  std::vector<Event> events = GetEvents();
+  os << "Flight recorder: " << events.size() << " events\n";
+  if (events.empty()) {
+    return;
+  }
+  // Times are relative to the last event, which is the closest to the moment of the dump.
+  uint64_t end_ns = events.back().start_ns;
+  for (const Event& event : events) {
+    os << "  -" << PrettyDuration(end_ns - event.start_ns)
+       << " tid=" << event.tid
+       << " " << EventTypeName(event.type);
+    if (event.duration_ns != 0u) {
+      os << " duration=" << PrettyDuration(event.duration_ns);
+    }
+    switch (event.type) {
+      case EventType::kGc:
+        os << " cause=" << gc::PrettyCause(static_cast<gc::GcCause>(event.arg));
+        break;
+      case EventType::kJitCompile:
+        os << ((event.arg & kJitCompileSuccess) != 0u ? " success" : " failure")
+           << ((event.arg & kJitCompileOsr) != 0u ? " osr" : "")
+           << ((event.arg & kJitCompileBaseline) != 0u ? " baseline" : "");
+        break;
+      case EventType::kDeoptimization:
+        os << " kind="
+           << GetDeoptimizationKindName(static_cast<DeoptimizationKind>(event.arg));
+        break;
+      default:
+        break;
+    }
+    if (event.name[0] != '\0') {
+      os << " " << event.name;
+    }
+    os << "\n";
+  }
+}
+
+}  // namespace art
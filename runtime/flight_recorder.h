@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_FLIGHT_RECORDER_H_
+#define ART_RUNTIME_FLIGHT_RECORDER_H_
+
+#include <stdint.h>
+#include <iosfwd>
+#include <memory>
+#include <vector>
+
+#include "base/atomic.h"
+#include "base/locks.h"
+#include "base/macros.h"
+#include "base/mutex.h"
+
+namespace art {
+
+class FlightRecorderRing;
+class Thread;
+
+// Keeps the most recent runtime events of each thread in a fixed-size ring, so that the history
+// leading to a slowdown can be looked at after the fact: dumped on SIGQUIT, or read through the
+// com.android.art.misc.get_flight_recorder_dump JVMTI extension. Enabled with
+// -XX:FlightRecorder. Recording an event only writes to the ring of the current thread, without
+// locks or allocation, except for the first event of each thread, which takes a ring.
+//
+// The rings are read without stopping their writers, so the events being written while a dump
+// runs may come out torn. This is the price of not synchronizing the writers.
+class FlightRecorder {
+ public:
+  enum class EventType : uint8_t {
+    kGc,                  // arg: GcCause, name: collector.
+    kJitCompile,          // arg: see JitCompileFlags, name: method.
+    kDeoptimization,      // arg: DeoptimizationKind.
+    kMonitorContention,   // name: class of the locked object.
+    kClassPrepare,        // Time to define the class, name: class descriptor.
+    kSuspendAll,          // Time to suspend all threads, name: cause.
+  };
+
+  enum JitCompileFlags : uint32_t {
+    kJitCompileSuccess = 1u << 0,
+    kJitCompileOsr = 1u << 1,
+    kJitCompileBaseline = 1u << 2,
+  };
+
+  static constexpr size_t kEventsPerThread = 256;
+  // Longer names are truncated from the front, since their end is the most specific part.
+  static constexpr size_t kNameSize = 32;
+  // Threads started once all rings are in use do not record events.
+  static constexpr size_t kMaxRings = 1024;
+
+  struct Event {
+    uint64_t start_ns;
+    uint64_t duration_ns;
+    uint32_t tid;
+    uint32_t arg;
+    EventType type;
+    char name[kNameSize];
+  };
+
+  FlightRecorder();
+  ~FlightRecorder();
+
+  // `name` may be null.
+  void Record(Thread* self,
+              EventType type,
+              uint64_t start_ns,
+              uint64_t duration_ns,
+              uint32_t arg,
+              const char* name) REQUIRES(!lock_);
+
+  // Called when `self` exits, to hand its ring to a later thread. The events stay until the new
+  // owner overwrites them.
+  void ReleaseRing(Thread* self) REQUIRES(!lock_);
+
+  // Returns the events of all threads, oldest first.
+  std::vector<Event> GetEvents() REQUIRES(!lock_);
+
+  void Dump(std::ostream& os) REQUIRES(!lock_);
+
+  static const char* EventTypeName(EventType type);
+
+ private:
+  FlightRecorderRing* AcquireRing(Thread* self) REQUIRES(!lock_);
+
+  // Guards the list of rings, not their contents.
+  Mutex lock_;
+  std::vector<std::unique_ptr<FlightRecorderRing>> rings_ GUARDED_BY(lock_);
+  std::vector<FlightRecorderRing*> free_rings_ GUARDED_BY(lock_);
+
+  DISALLOW_COPY_AND_ASSIGN(FlightRecorder);
+};
+
+}  // namespace art
+
+#endif  // ART_RUNTIME_FLIGHT_RECORDER_H_
@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "flight_recorder.h"
+
+#include <string.h>
+
+#include <sstream>
+#include <string>
+
+#include "common_runtime_test.h"
+#include "gc/gc_cause.h"
+#include "thread-current-inl.h"
+
+namespace art {
+
+class FlightRecorderTest : public CommonRuntimeTest {};
+
+TEST_F(FlightRecorderTest, RecordAndDump) {
+  Thread* self = Thread::Current();
+  FlightRecorder recorder;
+  recorder.Record(self,
+                  FlightRecorder::EventType::kSuspendAll,
+                  /* start_ns= */ 2000u,
+                  /* duration_ns= */ 10u,
+                  /* arg= */ 0u,
+                  "Test");
+  recorder.Record(self,
+                  FlightRecorder::EventType::kGc,
+                  /* start_ns= */ 1000u,
+                  /* duration_ns= */ 500u,
+                  static_cast<uint32_t>(gc::kGcCauseExplicit),
+                  "concurrent copying");
+  recorder.Record(self,
+                  FlightRecorder::EventType::kClassPrepare,
+                  /* start_ns= */ 3000u,
+                  /* duration_ns= */ 0u,
+                  /* arg= */ 0u,
+                  "Lcom/example/a/very/long/package/name/Klass;");
+
+  std::vector<FlightRecorder::Event> events = recorder.GetEvents();
+  ASSERT_EQ(3u, events.size());
+  // Sorted by start time.
+  EXPECT_EQ(FlightRecorder::EventType::kGc, events[0].type);
+  EXPECT_EQ(FlightRecorder::EventType::kSuspendAll, events[1].type);
+  EXPECT_EQ(static_cast<uint32_t>(self->GetTid()), events[0].tid);
+  // Long names keep their end.
+  EXPECT_EQ(FlightRecorder::kNameSize - 1u, strlen(events[2].name));
+  EXPECT_STREQ("ong/package/name/Klass;",
+               events[2].name + strlen(events[2].name) - strlen("ong/package/name/Klass;"));
+
+  std::ostringstream oss;
+  recorder.Dump(oss);
+  EXPECT_NE(std::string::npos, oss.str().find("Flight recorder: 3 events"));
+  EXPECT_NE(std::string::npos, oss.str().find("GC duration="));
+  EXPECT_NE(std::string::npos, oss.str().find("cause=Explicit concurrent copying"));
+
+  recorder.ReleaseRing(self);
+}
+
+TEST_F(FlightRecorderTest, KeepsMostRecentEvents) {
+  Thread* self = Thread::Current();
+  FlightRecorder recorder;
+  for (size_t i = 0; i != FlightRecorder::kEventsPerThread + 10u; ++i) {
+    recorder.Record(self,
+                    FlightRecorder::EventType::kDeoptimization,
+                    /* start_ns= */ i,
+                    /* duration_ns= */ 0u,
+                    /* arg= */ 0u,
+                    /* name= */ nullptr);
+  }
+  std::vector<FlightRecorder::Event> events = recorder.GetEvents();
+  ASSERT_EQ(FlightRecorder::kEventsPerThread, events.size());
+  EXPECT_EQ(10u, events.front().start_ns);
+  EXPECT_EQ(FlightRecorder::kEventsPerThread + 9u, events.back().start_ns);
+
+  // A released ring is reused, with its events, by the next thread to record.
+  recorder.ReleaseRing(self);
+  EXPECT_TRUE(self->GetFlightRecorderRing() == nullptr);
+  EXPECT_EQ(FlightRecorder::kEventsPerThread, recorder.GetEvents().size());
+}
+
+}  // namespace art
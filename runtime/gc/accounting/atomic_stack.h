@@ -258,6 +258,7 @@ class AtomicStack {
                                     /*low_4gb=*/ false,
                                     &error_msg);
     CHECK(mem_map_.IsValid()) << "couldn't allocate mark stack.\n" << error_msg;
+    mem_map_.SetNativeMemoryTag(NativeMemoryTag::kGcAccounting);
     uint8_t* addr = mem_map_.Begin();
     CHECK(addr != nullptr);
     debug_is_sorted_ = true;
@@ -55,6 +55,8 @@ MemMap Bitmap::AllocateMemMap(const std::string& name, size_t num_bits) {
                                         &error_msg);
   if (UNLIKELY(!mem_map.IsValid())) {
     LOG(ERROR) << "Failed to allocate bitmap " << name << ": " << error_msg;
+  } else {
+    mem_map.SetNativeMemoryTag(NativeMemoryTag::kGcAccounting);
   }
   return mem_map;
 }
@@ -51,6 +51,14 @@ static inline bool byte_cas(uint8_t old_value, uint8_t new_value, uint8_t* addre
 #endif
 }
 
+inline bool CardTable::IsCleanChunk(const uintptr_t* words) {
+  uintptr_t dirty_bits = 0;
+  for (size_t i = 0; i < kScanChunkWords; ++i) {
+    dirty_bits |= words[i];
+  }
+  return dirty_bits == 0;
+}
+
 template <bool kClearCard, typename Visitor>
 inline size_t CardTable::Scan(ContinuousSpaceBitmap* bitmap,
                               uint8_t* const scan_begin,
@@ -83,6 +91,15 @@ inline size_t CardTable::Scan(ContinuousSpaceBitmap* bitmap,
   uintptr_t* word_end = reinterpret_cast<uintptr_t*>(aligned_end);
   for (uintptr_t* word_cur = reinterpret_cast<uintptr_t*>(card_cur); word_cur < word_end;
       ++word_cur) {
+    // Skip clean cards a chunk at a time. The compiler turns the chunk check into wide vector
+    // loads, so a sparsely dirty card table is only bounded by the memory bandwidth.
+    while (static_cast<size_t>(word_end - word_cur) >= kScanChunkWords &&
+           IsCleanChunk(word_cur)) {
+      word_cur += kScanChunkWords;
+    }
+    if (UNLIKELY(word_cur >= word_end)) {
+      break;
+    }
     while (LIKELY(*word_cur == 0)) {
       ++word_cur;
       if (UNLIKELY(word_cur >= word_end)) {
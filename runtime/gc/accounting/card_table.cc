@@ -70,6 +70,7 @@ CardTable* CardTable::Create(const uint8_t* heap_begin, size_t heap_capacity) {
                                         /*low_4gb=*/ false,
                                         &error_msg);
   CHECK(mem_map.IsValid()) << "couldn't allocate card table: " << error_msg;
+  mem_map.SetNativeMemoryTag(NativeMemoryTag::kGcAccounting);
   // All zeros is the correct initial value; all clean. Anonymous mmaps are initialized to zero, we
   // don't clear the card table to avoid unnecessary pages being allocated
   static_assert(kCardClean == 0, "kCardClean must be 0");
@@ -150,6 +150,12 @@ class CardTable {
 
   void CheckCardValid(uint8_t* card) const ALWAYS_INLINE;
 
+  // Number of card table words that Scan checks at once when skipping clean cards.
+  static constexpr size_t kScanChunkWords = 4;
+
+  // Returns true if the `kScanChunkWords` words starting at `words` are all clean.
+  static bool IsCleanChunk(const uintptr_t* words) ALWAYS_INLINE;
+
   // Verifies that all gray objects are on a dirty card.
   void VerifyCardTable();
 
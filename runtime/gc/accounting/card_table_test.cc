@@ -25,6 +25,7 @@
 #include "mirror/class-inl.h"
 #include "mirror/string-inl.h"  // Strings are easiest to allocate
 #include "scoped_thread_state_change-inl.h"
+#include "space_bitmap-inl.h"
 #include "thread_pool.h"
 
 namespace art {
@@ -145,7 +146,47 @@ TEST_F(CardTableTest, TestModifyCardsAtomic) {
   }
 }
 
-// TODO: Add test for CardTable::Scan.
+TEST_F(CardTableTest, TestScan) {
+  CommonSetup();
+  std::unique_ptr<ContinuousSpaceBitmap> bitmap(
+      ContinuousSpaceBitmap::Create("test bitmap", HeapBegin(), HeapLimit() - HeapBegin()));
+  ASSERT_TRUE(bitmap != nullptr);
+  // One object at the start of each card.
+  for (uint8_t* addr = HeapBegin(); addr < HeapLimit(); addr += CardTable::kCardSize) {
+    bitmap->Set(reinterpret_cast<mirror::Object*>(addr));
+  }
+  // Sparse dirty and aged cards, and a run of dirty cards crossing several scan chunks.
+  size_t expected_cards = 0;
+  size_t expected_aged_cards = 0;
+  const size_t num_cards = (HeapLimit() - HeapBegin()) / CardTable::kCardSize;
+  for (size_t i = 0; i < num_cards; ++i) {
+    uint8_t* card = card_table_->CardFromAddr(HeapBegin() + i * CardTable::kCardSize);
+    if (i % 97 == 3 || (i >= 500 && i < 600)) {
+      *card = CardTable::kCardDirty;
+      ++expected_cards;
+    } else if (i % 89 == 5) {
+      *card = CardTable::kCardAged;
+      ++expected_aged_cards;
+    }
+  }
+  size_t visited_objects = 0;
+  size_t cards_scanned = card_table_->Scan</*kClearCard=*/ false>(
+      bitmap.get(),
+      HeapBegin(),
+      HeapLimit(),
+      [&](mirror::Object* obj) {
+        EXPECT_TRUE(card_table_->IsDirty(obj));
+        ++visited_objects;
+      },
+      CardTable::kCardDirty);
+  EXPECT_EQ(expected_cards, cards_scanned);
+  EXPECT_EQ(expected_cards, visited_objects);
+  // Aged cards are scanned with a lower minimum age.
+  cards_scanned = card_table_->Scan</*kClearCard=*/ false>(
+      bitmap.get(), HeapBegin(), HeapLimit(), [](mirror::Object*) {}, CardTable::kCardAged);
+  EXPECT_EQ(expected_cards + expected_aged_cards, cards_scanned);
+}
+
 }  // namespace accounting
 }  // namespace gc
 }  // namespace art
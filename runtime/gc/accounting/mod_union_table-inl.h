@@ -28,14 +28,31 @@ namespace accounting {
 // A mod-union table to record image references to the Zygote and alloc space.
 class ModUnionTableToZygoteAllocspace : public ModUnionTableReferenceCache {
  public:
+  // References into [boot_images_begin, boot_images_end), i.e. to any of the boot image spaces
+  // which are never collected nor moved, are not recorded. Not recording them keeps the cards of
+  // objects that only point to other boot images out of the table. The concurrent copying
+  // collector grays the objects on the table's cards in every GC, so each recorded card costs
+  // read barrier slow paths until the GC has scanned it.
   explicit ModUnionTableToZygoteAllocspace(const std::string& name,
                                            Heap* heap,
-                                           space::ContinuousSpace* space)
-      : ModUnionTableReferenceCache(name, heap, space) {}
+                                           space::ContinuousSpace* space,
+                                           const uint8_t* boot_images_begin = nullptr,
+                                           const uint8_t* boot_images_end = nullptr)
+      : ModUnionTableReferenceCache(name, heap, space),
+        boot_images_begin_(boot_images_begin),
+        boot_images_end_(boot_images_end) {}
 
   bool ShouldAddReference(const mirror::Object* ref) const override ALWAYS_INLINE {
+    const uint8_t* addr = reinterpret_cast<const uint8_t*>(ref);
+    if (addr >= boot_images_begin_ && addr < boot_images_end_) {
+      return false;
+    }
     return !space_->HasAddress(ref);
   }
+
+ private:
+  const uint8_t* const boot_images_begin_;
+  const uint8_t* const boot_images_end_;
 };
 
 }  // namespace accounting
@@ -93,6 +93,7 @@ SpaceBitmap<kAlignment>* SpaceBitmap<kAlignment>::Create(
     LOG(ERROR) << "Failed to allocate bitmap " << name << ": " << error_msg;
     return nullptr;
   }
+  mem_map.SetNativeMemoryTag(NativeMemoryTag::kGcAccounting);
   return CreateFromMemMap(name, std::move(mem_map), heap_begin, heap_capacity);
 }
 
@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2019 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "allocation_sampler.h"
+
+#include <algorithm>
+#include <ostream>
+#include <vector>
+
+#include "art_method-inl.h"
+#include "base/enums.h"
+#include "base/time_utils.h"
+#include "stack.h"
+#include "thread.h"
+
+namespace art {
+namespace gc {
+
+AllocationSampler::AllocationSampler(size_t mean_interval)
+    : mean_interval_(mean_interval),
+      lock_("allocation sampler lock", kAllocTrackerLock),
+      random_(static_cast<std::minstd_rand::result_type>(NanoTime())),
+      interval_distribution_(1.0 / static_cast<double>(mean_interval)),
+      total_samples_(0u) {
+  DCHECK_NE(mean_interval, 0u);
+}
+
+size_t AllocationSampler::NextInterval() {
+  // Never return 0, which the threads use for "no interval drawn yet".
+  return std::max<size_t>(static_cast<size_t>(interval_distribution_(random_)), 1u);
+}
+
+void AllocationSampler::RecordRefill(Thread* self, size_t refill_bytes) {
+  size_t* bytes_until_sample = self->GetBytesUntilAllocationSample();
+  if (UNLIKELY(*bytes_until_sample == 0u)) {
+    MutexLock mu(self, lock_);
+    *bytes_until_sample = NextInterval();
+  }
+  if (LIKELY(refill_bytes < *bytes_until_sample)) {
+    *bytes_until_sample -= refill_bytes;
+    return;
+  }
+  // Capture the stack before taking the lock, the walk does not suspend the thread.
+  std::vector<std::pair<ArtMethod*, uint32_t>> frames;
+  frames.reserve(kMaxStackDepth);
+  StackVisitor::WalkStack(
+      [&](const art::StackVisitor* stack_visitor) REQUIRES_SHARED(Locks::mutator_lock_) {
+        if (frames.size() >= kMaxStackDepth) {
+          return false;
+        }
+        ArtMethod* m = stack_visitor->GetMethod();
+        // m may be null if we have inlined methods of unresolved classes.
+        if (m != nullptr && !m->IsRuntimeMethod()) {
+          m = m->GetInterfaceMethodIfProxy(kRuntimePointerSize);
+          frames.emplace_back(m, stack_visitor->GetDexPc());
+        }
+        return true;
+      },
+      self,
+      /* context= */ nullptr,
+      art::StackVisitor::StackWalkKind::kIncludeInlinedFrames);
+  // Methods may be unloaded before the dump, so key the samples by the printed frames.
+  std::string stack;
+  for (auto it = frames.rbegin(); it != frames.rend(); ++it) {
+    if (!stack.empty()) {
+      stack += ';';
+    }
+    stack += it->first->PrettyMethod(/* with_signature= */ false);
+    stack += ':';
+    stack += std::to_string(it->second);
+  }
+  if (stack.empty()) {
+    stack = "<no managed frames>";
+  }
+
+  MutexLock mu(self, lock_);
+  // A refill larger than the interval may stand for several samples.
+  uint64_t samples = 1u + (refill_bytes - *bytes_until_sample) / mean_interval_;
+  StackStats& stats = stacks_[stack];
+  stats.samples += samples;
+  stats.estimated_bytes += samples * mean_interval_;
+  total_samples_ += samples;
+  *bytes_until_sample = NextInterval();
+}
+
+void AllocationSampler::Dump(std::ostream& os) {
+  Thread* self = Thread::Current();
+  std::vector<std::pair<std::string, StackStats>> stacks;
+  uint64_t total_samples;
+  {
+    MutexLock mu(self, lock_);
+    stacks.assign(stacks_.begin(), stacks_.end());
+    total_samples = total_samples_;
+  }
+  std::sort(stacks.begin(), stacks.end(), [](const auto& lhs, const auto& rhs) {
+    return lhs.second.estimated_bytes > rhs.second.estimated_bytes;
+  });
+  os << "Allocation samples: " << total_samples << " in " << stacks.size()
+     << " stacks, one sample per " << mean_interval_ << " bytes on average\n";
+  for (const auto& entry : stacks) {
+    os << entry.first << " " << entry.second.estimated_bytes << "\n";
+  }
+}
+
+}  // namespace gc
+}  // namespace art
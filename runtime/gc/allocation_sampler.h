@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2019 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_GC_ALLOCATION_SAMPLER_H_
+#define ART_RUNTIME_GC_ALLOCATION_SAMPLER_H_
+
+#include <iosfwd>
+#include <map>
+#include <random>
+#include <string>
+
+#include "base/locks.h"
+#include "base/mutex.h"
+
+namespace art {
+
+class Thread;
+
+namespace gc {
+
+// Low overhead allocation profiler. Unlike AllocRecordObjectMap, which records every allocation
+// and needs the instrumented allocation entrypoints, the sampler only runs on the TLAB refill
+// slow path. Each thread counts down the bytes handed to it in TLAB refills and, when an
+// exponentially distributed interval with the given mean has passed, records the stack of the
+// allocation that caused the refill. This approximates a Poisson sampling of the allocated bytes
+// with one sample per `mean_interval` bytes on average.
+class AllocationSampler {
+ public:
+  // Sampled stacks are truncated to this many frames, starting from the allocation site.
+  static constexpr size_t kMaxStackDepth = 16;
+
+  explicit AllocationSampler(size_t mean_interval);
+
+  size_t GetMeanInterval() const {
+    return mean_interval_;
+  }
+
+  // Called after `self` got `refill_bytes` new TLAB bytes to satisfy an allocation.
+  void RecordRefill(Thread* self, size_t refill_bytes)
+      REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!lock_);
+
+  // Dumps the sampled stacks in the collapsed stack format, one "frame;...;frame bytes" line per
+  // stack with the outermost frame first and the estimated number of bytes allocated there.
+  void Dump(std::ostream& os) REQUIRES(!lock_);
+
+ private:
+  struct StackStats {
+    uint64_t samples = 0;
+    uint64_t estimated_bytes = 0;
+  };
+
+  size_t NextInterval() REQUIRES(lock_);
+
+  const size_t mean_interval_;
+  Mutex lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
+  std::minstd_rand random_ GUARDED_BY(lock_);
+  std::exponential_distribution<double> interval_distribution_ GUARDED_BY(lock_);
+  // Keyed by the collapsed stack so that identical stacks share an entry.
+  std::map<std::string, StackStats> stacks_ GUARDED_BY(lock_);
+  uint64_t total_samples_ GUARDED_BY(lock_);
+};
+
+}  // namespace gc
+}  // namespace art
+
+#endif  // ART_RUNTIME_GC_ALLOCATION_SAMPLER_H_
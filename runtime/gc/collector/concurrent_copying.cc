@@ -45,6 +45,7 @@
 #include "scoped_thread_state_change-inl.h"
 #include "thread-inl.h"
 #include "thread_list.h"
+#include "thread_pool.h"
 #include "well_known_classes.h"
 
 namespace art {
@@ -397,6 +398,7 @@ void ConcurrentCopying::InitializePhase() {
   if (!use_generational_cc_ || !young_gen_) {
     if (gc_cause == kGcCauseExplicit ||
         gc_cause == kGcCauseCollectorTransition ||
+        gc_cause == kGcCauseIdleCompaction ||
         GetCurrentIteration()->GetClearSoftReferences()) {
       force_evacuate_all_ = true;
     }
@@ -1543,6 +1545,17 @@ void ConcurrentCopying::CopyingPhase() {
     immune_gray_stack_.clear();
   }
 
+  if (use_generational_cc_ && !young_gen_ && !force_evacuate_all_) {
+    // The marking phase left the live objects marked in the region space bitmap. The region live
+    // bytes were reset by the flip, so use the bitmap to evacuate the from-space regions in
+    // parallel. Objects which died since the marking phase survive until the next cycle.
+    const size_t thread_count = GetMarkingThreadCount();
+    if (thread_count > 1) {
+      TimingLogger::ScopedTiming split1("EvacuateMarkedFromSpaceObjects", GetTimings());
+      EvacuateMarkedFromSpaceObjectsParallel(thread_count);
+    }
+  }
+
   {
     TimingLogger::ScopedTiming split2("VisitConcurrentRoots", GetTimings());
     Runtime::Current()->VisitConcurrentRoots(this, kVisitRootFlagAllRoots);
@@ -2038,12 +2051,17 @@ bool ConcurrentCopying::ProcessMarkStackOnce() {
   MarkStackMode mark_stack_mode = mark_stack_mode_.load(std::memory_order_relaxed);
   if (mark_stack_mode == kMarkStackModeThreadLocal) {
     // Process the thread-local mark stacks and the GC mark stack.
-    count += ProcessThreadLocalMarkStacks(/* disable_weak_ref_access= */ false,
-                                          /* checkpoint_callback= */ nullptr,
-                                          [this] (mirror::Object* ref)
-                                              REQUIRES_SHARED(Locks::mutator_lock_) {
-                                            ProcessMarkStackRef(ref);
-                                          });
+    const size_t thread_count = GetMarkingThreadCount();
+    if (thread_count > 1) {
+      count += ProcessThreadLocalMarkStacksParallel(thread_count);
+    } else {
+      count += ProcessThreadLocalMarkStacks(/* disable_weak_ref_access= */ false,
+                                            /* checkpoint_callback= */ nullptr,
+                                            [this] (mirror::Object* ref)
+                                                REQUIRES_SHARED(Locks::mutator_lock_) {
+                                              ProcessMarkStackRef(ref);
+                                            });
+    }
     while (!gc_mark_stack_->IsEmpty()) {
       mirror::Object* to_ref = gc_mark_stack_->PopBack();
       ProcessMarkStackRef(to_ref);
@@ -2134,6 +2152,147 @@ size_t ConcurrentCopying::ProcessThreadLocalMarkStacks(bool disable_weak_ref_acc
   return count;
 }
 
+size_t ConcurrentCopying::GetMarkingThreadCount() const {
+  // Use less threads if we are in a background state (non jank perceptible) since we want to leave
+  // more CPU time for the foreground apps.
+  if (heap_->GetThreadPool() == nullptr || !Runtime::Current()->InJankPerceptibleProcessState()) {
+    return 1;
+  }
+  return heap_->GetConcGCThreadCount() + 1;
+}
+
+// Drains a share of the revoked thread-local mark stacks. Workers claim whole mark stacks so that
+// the faster ones take over the remaining stacks of the slower ones.
+class ConcurrentCopying::ParallelMarkStackTask : public Task {
+ public:
+  ParallelMarkStackTask(ConcurrentCopying* collector,
+                        const std::vector<accounting::ObjectStack*>* mark_stacks,
+                        Atomic<size_t>* next_mark_stack,
+                        Atomic<size_t>* count)
+      : collector_(collector),
+        mark_stacks_(mark_stacks),
+        next_mark_stack_(next_mark_stack),
+        count_(count) {}
+
+  void Run(Thread* self ATTRIBUTE_UNUSED) override REQUIRES_SHARED(Locks::mutator_lock_) {
+    size_t count = 0;
+    size_t index;
+    while ((index = next_mark_stack_->fetch_add(1, std::memory_order_relaxed)) <
+           mark_stacks_->size()) {
+      accounting::ObjectStack* mark_stack = (*mark_stacks_)[index];
+      for (StackReference<mirror::Object>* p = mark_stack->Begin(); p != mark_stack->End(); ++p) {
+        collector_->ProcessMarkStackRef</*kParallel=*/ true>(p->AsMirrorPtr());
+        ++count;
+      }
+    }
+    count_->fetch_add(count, std::memory_order_relaxed);
+  }
+
+  void Finalize() override {
+    delete this;
+  }
+
+ private:
+  ConcurrentCopying* const collector_;
+  const std::vector<accounting::ObjectStack*>* const mark_stacks_;
+  Atomic<size_t>* const next_mark_stack_;
+  Atomic<size_t>* const count_;
+};
+
+// Copies the marked objects of the from-space regions it claims. Copied objects are grayed and
+// pushed onto the mark stack of the copying thread, to be scanned by ProcessMarkStack().
+class ConcurrentCopying::EvacuateRegionsTask : public Task {
+ public:
+  EvacuateRegionsTask(ConcurrentCopying* collector, Atomic<size_t>* next_region)
+      : collector_(collector), next_region_(next_region) {}
+
+  void Run(Thread* self) override REQUIRES_SHARED(Locks::mutator_lock_) {
+    ConcurrentCopying* const collector = collector_;
+    collector->region_space_->ScanFromSpaceRegions(
+        collector->region_space_bitmap_,
+        next_region_,
+        [collector, self](mirror::Object* obj) REQUIRES_SHARED(Locks::mutator_lock_) {
+          // A mutator or another copying thread may have got to it first.
+          if (collector->GetFwdPtr(obj) == nullptr) {
+            collector->Copy(self, obj, /* holder= */ nullptr, MemberOffset(0));
+          }
+        });
+  }
+
+  void Finalize() override {
+    delete this;
+  }
+
+ private:
+  ConcurrentCopying* const collector_;
+  Atomic<size_t>* const next_region_;
+};
+
+void ConcurrentCopying::EvacuateMarkedFromSpaceObjectsParallel(size_t thread_count) {
+  DCHECK_GT(thread_count, 1u);
+  DCHECK_EQ(static_cast<uint32_t>(mark_stack_mode_.load(std::memory_order_relaxed)),
+            static_cast<uint32_t>(kMarkStackModeThreadLocal));
+  Thread* const self = thread_running_gc_;
+  Atomic<size_t> next_region(0);
+  ThreadPool* const thread_pool = heap_->GetThreadPool();
+  for (size_t i = 0; i < thread_count; ++i) {
+    thread_pool->AddTask(self, new EvacuateRegionsTask(this, &next_region));
+  }
+  thread_pool->SetMaxActiveWorkers(thread_count - 1);
+  thread_pool->StartWorkers(self);
+  thread_pool->Wait(self, /* do_work= */ true, /* may_hold_locks= */ true);
+  thread_pool->StopWorkers(self);
+}
+
+size_t ConcurrentCopying::ProcessThreadLocalMarkStacksParallel(size_t thread_count) {
+  DCHECK_GT(thread_count, 1u);
+  DCHECK_EQ(static_cast<uint32_t>(mark_stack_mode_.load(std::memory_order_relaxed)),
+            static_cast<uint32_t>(kMarkStackModeThreadLocal));
+  Thread* const self = thread_running_gc_;
+  RevokeThreadLocalMarkStacks(/* disable_weak_ref_access= */ false,
+                              /* checkpoint_callback= */ nullptr);
+  std::vector<accounting::ObjectStack*> mark_stacks;
+  {
+    MutexLock mu(self, mark_stack_lock_);
+    mark_stacks.swap(revoked_mark_stacks_);
+  }
+  if (mark_stacks.empty()) {
+    return 0;
+  }
+  thread_count = std::min(thread_count, mark_stacks.size());
+  Atomic<size_t> next_mark_stack(0);
+  Atomic<size_t> count(0);
+  if (thread_count > 1) {
+    ThreadPool* const thread_pool = heap_->GetThreadPool();
+    for (size_t i = 0; i < thread_count; ++i) {
+      thread_pool->AddTask(
+          self, new ParallelMarkStackTask(this, &mark_stacks, &next_mark_stack, &count));
+    }
+    thread_pool->SetMaxActiveWorkers(thread_count - 1);
+    thread_pool->StartWorkers(self);
+    thread_pool->Wait(self, /* do_work= */ true, /* may_hold_locks= */ true);
+    thread_pool->StopWorkers(self);
+  } else {
+    ParallelMarkStackTask task(this, &mark_stacks, &next_mark_stack, &count);
+    task.Run(self);
+  }
+  {
+    MutexLock mu(self, mark_stack_lock_);
+    for (accounting::ObjectStack* mark_stack : mark_stacks) {
+      if (pooled_mark_stacks_.size() >= kMarkStackPoolSize) {
+        // The pool has enough. Delete it.
+        delete mark_stack;
+      } else {
+        // Otherwise, put it into the pool for later reuse.
+        mark_stack->Reset();
+        pooled_mark_stacks_.push_back(mark_stack);
+      }
+    }
+  }
+  return count.load(std::memory_order_relaxed);
+}
+
+template <bool kParallel>
 inline void ConcurrentCopying::ProcessMarkStackRef(mirror::Object* to_ref) {
   DCHECK(!region_space_->IsInFromSpace(to_ref));
   space::RegionSpace::RegionType rtype = region_space_->GetRegionType(to_ref);
@@ -2156,8 +2315,11 @@ inline void ConcurrentCopying::ProcessMarkStackRef(mirror::Object* to_ref) {
   bool perform_scan = false;
   switch (rtype) {
     case space::RegionSpace::RegionType::kRegionTypeUnevacFromSpace:
-      // Mark the bitmap only in the GC thread here so that we don't need a CAS.
-      if (!kUseBakerReadBarrier || !region_space_bitmap_->Set(to_ref)) {
+      // Mark the bitmap only in the GC thread here so that we don't need a CAS, unless other GC
+      // threads are marking at the same time.
+      if (!kUseBakerReadBarrier ||
+          !(kParallel ? region_space_bitmap_->AtomicTestAndSet(to_ref)
+                      : region_space_bitmap_->Set(to_ref))) {
         // It may be already marked if we accidentally pushed the same object twice due to the racy
         // bitmap read in MarkUnevacFromSpaceRegion.
         if (use_generational_cc_ && young_gen_) {
@@ -2179,7 +2341,11 @@ inline void ConcurrentCopying::ProcessMarkStackRef(mirror::Object* to_ref) {
     case space::RegionSpace::RegionType::kRegionTypeToSpace:
       if (use_generational_cc_) {
         // Copied to to-space, set the bit so that the next GC can scan objects.
-        region_space_bitmap_->Set(to_ref);
+        if (kParallel) {
+          region_space_bitmap_->AtomicTestAndSet(to_ref);
+        } else {
+          region_space_bitmap_->Set(to_ref);
+        }
       }
       perform_scan = true;
       break;
@@ -2209,13 +2375,15 @@ inline void ConcurrentCopying::ProcessMarkStackRef(mirror::Object* to_ref) {
           accounting::LargeObjectBitmap* los_bitmap =
               heap_->GetLargeObjectsSpace()->GetMarkBitmap();
           DCHECK(los_bitmap->HasAddress(to_ref));
-          // Only the GC thread could be setting the LOS bit map hence doesn't
-          // need to be atomically done.
-          perform_scan = !los_bitmap->Set(to_ref);
+          // Only the GC threads could be setting the LOS bit map hence doesn't
+          // need to be atomically done unless marking in parallel.
+          perform_scan = kParallel ? !los_bitmap->AtomicTestAndSet(to_ref)
+                                   : !los_bitmap->Set(to_ref);
         } else {
-          // Only the GC thread could be setting the non-moving space bit map
-          // hence doesn't need to be atomically done.
-          perform_scan = !mark_bitmap->Set(to_ref);
+          // Only the GC threads could be setting the non-moving space bit map
+          // hence doesn't need to be atomically done unless marking in parallel.
+          perform_scan = kParallel ? !mark_bitmap->AtomicTestAndSet(to_ref)
+                                   : !mark_bitmap->Set(to_ref);
         }
       } else {
         perform_scan = true;
@@ -2223,9 +2391,9 @@ inline void ConcurrentCopying::ProcessMarkStackRef(mirror::Object* to_ref) {
   }
   if (perform_scan) {
     if (use_generational_cc_ && young_gen_) {
-      Scan<true>(to_ref);
+      Scan</*kNoUnEvac=*/ true, kParallel>(to_ref);
     } else {
-      Scan<false>(to_ref);
+      Scan</*kNoUnEvac=*/ false, kParallel>(to_ref);
     }
   }
   if (kUseBakerReadBarrier) {
@@ -2266,12 +2434,16 @@ inline void ConcurrentCopying::ProcessMarkStackRef(mirror::Object* to_ref) {
 #endif
 
   if (add_to_live_bytes) {
-    // Add to the live bytes per unevacuated from-space. Note this code is always run by the
-    // GC-running thread (no synchronization required).
+    // Add to the live bytes per unevacuated from-space. Note this code is only run by the
+    // GC-running thread (no synchronization required) unless marking in parallel.
     DCHECK(region_space_bitmap_->Test(to_ref));
     size_t obj_size = to_ref->SizeOf<kDefaultVerifyFlags>();
     size_t alloc_size = RoundUp(obj_size, space::RegionSpace::kAlignment);
-    region_space_->AddLiveBytes(to_ref, alloc_size);
+    if (kParallel) {
+      region_space_->AtomicAddLiveBytes(to_ref, alloc_size);
+    } else {
+      region_space_->AddLiveBytes(to_ref, alloc_size);
+    }
   }
   if (ReadBarrier::kEnableToSpaceInvariantChecks) {
     CHECK(to_ref != nullptr);
@@ -3030,7 +3202,7 @@ void ConcurrentCopying::AssertToSpaceInvariantInNonMovingSpace(mirror::Object* o
 }
 
 // Used to scan ref fields of an object.
-template <bool kNoUnEvac>
+template <bool kNoUnEvac, bool kParallel>
 class ConcurrentCopying::RefFieldsVisitor {
  public:
   explicit RefFieldsVisitor(ConcurrentCopying* collector, Thread* const thread)
@@ -3042,7 +3214,7 @@ class ConcurrentCopying::RefFieldsVisitor {
   void operator()(mirror::Object* obj, MemberOffset offset, bool /* is_static */)
       const ALWAYS_INLINE REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES_SHARED(Locks::heap_bitmap_lock_) {
-    collector_->Process<kNoUnEvac>(obj, offset);
+    collector_->Process<kNoUnEvac, kParallel>(thread_, obj, offset);
   }
 
   void operator()(ObjPtr<mirror::Class> klass, ObjPtr<mirror::Reference> ref) const
@@ -3062,7 +3234,9 @@ class ConcurrentCopying::RefFieldsVisitor {
   void VisitRoot(mirror::CompressedReference<mirror::Object>* root) const
       ALWAYS_INLINE
       REQUIRES_SHARED(Locks::mutator_lock_) {
-    collector_->MarkRoot</*kGrayImmuneObject=*/false>(thread_, root);
+    // GC worker threads follow the mutator protocol for immune objects, which is a no-op once
+    // all immune objects have been updated.
+    collector_->MarkRoot</*kGrayImmuneObject=*/kParallel>(thread_, root);
   }
 
  private:
@@ -3070,39 +3244,45 @@ class ConcurrentCopying::RefFieldsVisitor {
   Thread* const thread_;
 };
 
-template <bool kNoUnEvac>
+template <bool kNoUnEvac, bool kParallel>
 inline void ConcurrentCopying::Scan(mirror::Object* to_ref) {
   // Cannot have `kNoUnEvac` when Generational CC collection is disabled.
   DCHECK(!kNoUnEvac || use_generational_cc_);
+  Thread* const self = kParallel ? Thread::Current() : thread_running_gc_;
   if (kDisallowReadBarrierDuringScan && !Runtime::Current()->IsActiveTransaction()) {
     // Avoid all read barriers during visit references to help performance.
     // Don't do this in transaction mode because we may read the old value of an field which may
     // trigger read barriers.
-    Thread::Current()->ModifyDebugDisallowReadBarrier(1);
+    self->ModifyDebugDisallowReadBarrier(1);
   }
   DCHECK(!region_space_->IsInFromSpace(to_ref));
-  DCHECK_EQ(Thread::Current(), thread_running_gc_);
-  RefFieldsVisitor<kNoUnEvac> visitor(this, thread_running_gc_);
+  DCHECK_EQ(Thread::Current(), self);
+  RefFieldsVisitor<kNoUnEvac, kParallel> visitor(this, self);
   // Disable the read barrier for a performance reason.
   to_ref->VisitReferences</*kVisitNativeRoots=*/true, kDefaultVerifyFlags, kWithoutReadBarrier>(
       visitor, visitor);
   if (kDisallowReadBarrierDuringScan && !Runtime::Current()->IsActiveTransaction()) {
-    thread_running_gc_->ModifyDebugDisallowReadBarrier(-1);
+    self->ModifyDebugDisallowReadBarrier(-1);
   }
 }
 
-template <bool kNoUnEvac>
-inline void ConcurrentCopying::Process(mirror::Object* obj, MemberOffset offset) {
+template <bool kNoUnEvac, bool kParallel>
+inline void ConcurrentCopying::Process(Thread* const self,
+                                       mirror::Object* obj,
+                                       MemberOffset offset) {
   // Cannot have `kNoUnEvac` when Generational CC collection is disabled.
   DCHECK(!kNoUnEvac || use_generational_cc_);
-  DCHECK_EQ(Thread::Current(), thread_running_gc_);
+  DCHECK_EQ(Thread::Current(), self);
+  DCHECK(kParallel || self == thread_running_gc_);
   mirror::Object* ref = obj->GetFieldObject<
       mirror::Object, kVerifyNone, kWithoutReadBarrier, false>(offset);
-  mirror::Object* to_ref = Mark</*kGrayImmuneObject=*/false, kNoUnEvac, /*kFromGCThread=*/true>(
-      thread_running_gc_,
-      ref,
-      /*holder=*/ obj,
-      offset);
+  // GC worker threads mark like mutators do: they push newly marked objects onto their
+  // thread-local mark stacks instead of the GC mark stack.
+  mirror::Object* to_ref = kParallel
+      ? Mark</*kGrayImmuneObject=*/true, kNoUnEvac, /*kFromGCThread=*/false>(
+            self, ref, /*holder=*/ obj, offset)
+      : Mark</*kGrayImmuneObject=*/false, kNoUnEvac, /*kFromGCThread=*/true>(
+            self, ref, /*holder=*/ obj, offset);
   if (to_ref == ref) {
     return;
   }
@@ -164,8 +164,9 @@ class ConcurrentCopying : public GarbageCollector {
                        MemberOffset offset)
       REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(!mark_stack_lock_, !skipped_blocks_lock_, !immune_gray_stack_lock_);
-  // Scan the reference fields of object `to_ref`.
-  template <bool kNoUnEvac>
+  // Scan the reference fields of object `to_ref`. If `kParallel` is true, the scan may be done by
+  // a GC worker thread concurrently with the GC-running thread.
+  template <bool kNoUnEvac, bool kParallel = false>
   void Scan(mirror::Object* to_ref) REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(!mark_stack_lock_);
   // Scan the reference fields of object 'obj' in the dirty cards during
@@ -176,8 +177,8 @@ class ConcurrentCopying : public GarbageCollector {
   void ScanDirtyObject(mirror::Object* obj) REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(!mark_stack_lock_);
   // Process a field.
-  template <bool kNoUnEvac>
-  void Process(mirror::Object* obj, MemberOffset offset)
+  template <bool kNoUnEvac, bool kParallel = false>
+  void Process(Thread* const self, mirror::Object* obj, MemberOffset offset)
       REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(!mark_stack_lock_ , !skipped_blocks_lock_, !immune_gray_stack_lock_);
   void VisitRoots(mirror::Object*** roots, size_t count, const RootInfo& info) override
@@ -198,8 +199,20 @@ class ConcurrentCopying : public GarbageCollector {
   void ProcessMarkStack() override REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(!mark_stack_lock_);
   bool ProcessMarkStackOnce() REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!mark_stack_lock_);
+  // Process a popped mark stack entry. If `kParallel` is true, other threads may be processing
+  // entries at the same time, so the mark bitmaps and region live bytes are updated atomically.
+  template <bool kParallel = false>
   void ProcessMarkStackRef(mirror::Object* to_ref) REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(!mark_stack_lock_);
+  // Number of threads (including the GC-running thread) to use for parallel marking; 1 disables
+  // parallel marking.
+  size_t GetMarkingThreadCount() const;
+  // Copy the from-space objects marked by the marking phase of a full generational cycle out of
+  // their regions on the heap thread pool, so that the single-threaded mark stack processing
+  // mostly finds already evacuated objects.
+  void EvacuateMarkedFromSpaceObjectsParallel(size_t thread_count)
+      REQUIRES_SHARED(Locks::mutator_lock_)
+      REQUIRES(!mark_stack_lock_, !skipped_blocks_lock_);
   void GrayAllDirtyImmuneObjects()
       REQUIRES(Locks::mutator_lock_)
       REQUIRES(!mark_stack_lock_);
@@ -217,6 +230,11 @@ class ConcurrentCopying : public GarbageCollector {
                                       Closure* checkpoint_callback,
                                       const Processor& processor)
       REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!mark_stack_lock_);
+  // Revoke the thread-local mark stacks and drain them with `thread_count` threads from the heap
+  // thread pool. Objects newly marked by the workers go onto the workers' own thread-local mark
+  // stacks, which are picked up by the next round.
+  size_t ProcessThreadLocalMarkStacksParallel(size_t thread_count)
+      REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!mark_stack_lock_);
   void RevokeThreadLocalMarkStacks(bool disable_weak_ref_access, Closure* checkpoint_callback)
       REQUIRES_SHARED(Locks::mutator_lock_);
   void SwitchToSharedMarkStackMode() REQUIRES_SHARED(Locks::mutator_lock_)
@@ -470,11 +488,13 @@ class ConcurrentCopying : public GarbageCollector {
   class DisableMarkingCallback;
   class DisableMarkingCheckpoint;
   class DisableWeakRefAccessCallback;
+  class EvacuateRegionsTask;
   class FlipCallback;
   template <bool kConcurrent> class GrayImmuneObjectVisitor;
   class ImmuneSpaceScanObjVisitor;
   class LostCopyVisitor;
-  template <bool kNoUnEvac> class RefFieldsVisitor;
+  class ParallelMarkStackTask;
+  template <bool kNoUnEvac, bool kParallel = false> class RefFieldsVisitor;
   class RevokeThreadLocalMarkStackCheckpoint;
   class ScopedGcGraysImmuneObjects;
   class ThreadFlipVisitor;
@@ -29,6 +29,7 @@
 #include "base/systrace.h"
 #include "base/time_utils.h"
 #include "base/utils.h"
+#include "flight_recorder.h"
 #include "gc/accounting/heap_bitmap.h"
 #include "gc/gc_pause_listener.h"
 #include "gc/heap.h"
@@ -85,6 +86,7 @@ void GarbageCollector::ResetCumulativeStatistics() {
   total_time_ns_ = 0u;
   total_freed_objects_ = 0u;
   total_freed_bytes_ = 0;
+  total_perf_counters_ = PerfCounterValues();
   rss_histogram_.Reset();
   freed_bytes_histogram_.Reset();
   MutexLock mu(Thread::Current(), pause_histogram_lock_);
@@ -154,7 +156,22 @@ void GarbageCollector::Run(GcCause gc_cause, bool clear_soft_references) {
   // Note transaction mode is single-threaded and there's no asynchronous GC and this flag doesn't
   // change in the middle of a GC.
   is_transaction_active_ = Runtime::Current()->IsActiveTransaction();
+  PerfCounters perf_counters;
+  PerfCounterValues perf_counters_start;
+  bool count_perf_events = false;
+  if (UNLIKELY(Runtime::Current()->UsePerfCounters())) {
+    std::string error_msg;
+    count_perf_events = perf_counters.Open(&error_msg) && perf_counters.Read(&perf_counters_start);
+    if (!count_perf_events) {
+      VLOG(gc) << "Not counting hardware events: " << error_msg;
+    }
+  }
   RunPhases();  // Run all the GC phases.
+  PerfCounterValues perf_counters_end;
+  if (count_perf_events && perf_counters.Read(&perf_counters_end)) {
+    // Only counts the thread running the phases, not the GC worker threads it hands work to.
+    total_perf_counters_ += perf_counters_end - perf_counters_start;
+  }
   GetHeap()->CalculatePostGcWeightedAllocatedBytes();
   // Add the current timings to the cumulative timings.
   cumulative_timings_.AddLogger(*GetTimings());
@@ -181,6 +198,15 @@ void GarbageCollector::Run(GcCause gc_cause, bool clear_soft_references) {
     MutexLock mu(self, pause_histogram_lock_);
     pause_histogram_.AdjustAndAddValue(pause_time);
   }
+  FlightRecorder* flight_recorder = Runtime::Current()->GetFlightRecorder();
+  if (flight_recorder != nullptr) {
+    flight_recorder->Record(self,
+                            FlightRecorder::EventType::kGc,
+                            start_time,
+                            current_iteration->GetDurationNs(),
+                            static_cast<uint32_t>(gc_cause),
+                            GetName());
+  }
   is_transaction_active_ = false;
 }
 
@@ -232,6 +258,7 @@ void GarbageCollector::ResetMeasurements() {
   total_time_ns_ = 0u;
   total_freed_objects_ = 0u;
   total_freed_bytes_ = 0;
+  total_perf_counters_ = PerfCounterValues();
 }
 
 GarbageCollector::ScopedPause::ScopedPause(GarbageCollector* collector, bool with_reporting)
@@ -329,6 +356,11 @@ void GarbageCollector::DumpPerformanceInfo(std::ostream& os) {
      << "  per cpu-time: "
      << static_cast<uint64_t>(freed_bytes / cpu_seconds) << "/s / "
      << PrettySize(freed_bytes / cpu_seconds) << "/s\n";
+  if (total_perf_counters_.cycles != 0u) {
+    os << GetName() << " hardware events: ";
+    total_perf_counters_.Dump(os);
+    os << "\n";
+  }
 }
 
 }  // namespace collector
@@ -22,6 +22,7 @@
 
 #include "base/histogram.h"
 #include "base/mutex.h"
+#include "base/perf_counters.h"
 #include "base/timing_logger.h"
 #include "gc/collector_type.h"
 #include "gc/gc_cause.h"
@@ -160,6 +161,8 @@ class GarbageCollector : public RootVisitor, public IsMarkedVisitor, public Mark
   uint64_t total_time_ns_;
   uint64_t total_freed_objects_;
   int64_t total_freed_bytes_;
+  // Hardware events of the GC threads running RunPhases, with -XX:PerfCounters.
+  PerfCounterValues total_perf_counters_;
   CumulativeLogger cumulative_timings_;
   mutable Mutex pause_histogram_lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
   bool is_transaction_active_;
@@ -65,6 +65,9 @@ static constexpr bool kParallelRecursiveMark = true;
 // ProcessMarkStack with very small mark stacks.
 static constexpr size_t kMinimumParallelMarkStackSize = 128;
 static constexpr bool kParallelProcessMarkStack = true;
+// Sweep RosAlloc spaces in parallel, in ranges of at least kMinimumParallelSweepRange bytes.
+static constexpr bool kParallelSweep = true;
+static constexpr size_t kMinimumParallelSweepRange = 1 * MB;
 
 // Profiling and information flags.
 static constexpr bool kProfileLargeObjects = false;
@@ -1317,18 +1320,83 @@ void MarkSweep::Sweep(bool swap_bitmaps) {
     live_stack->Reset();
     DCHECK(mark_stack_->IsEmpty());
   }
+  const size_t thread_count = GetThreadCount(false);
   for (const auto& space : GetHeap()->GetContinuousSpaces()) {
     if (space->IsContinuousMemMapAllocSpace()) {
       space::ContinuousMemMapAllocSpace* alloc_space = space->AsContinuousMemMapAllocSpace();
       TimingLogger::ScopedTiming split(
           alloc_space->IsZygoteSpace() ? "SweepZygoteSpace" : "SweepMallocSpace",
           GetTimings());
-      RecordFree(alloc_space->Sweep(swap_bitmaps));
+      if (kParallelSweep && thread_count > 1 && alloc_space->IsRosAllocSpace()) {
+        RecordFree(ParallelSweep(alloc_space, swap_bitmaps, thread_count));
+      } else {
+        RecordFree(alloc_space->Sweep(swap_bitmaps));
+      }
     }
   }
   SweepLargeObjects(swap_bitmaps);
 }
 
+class MarkSweep::SweepTask : public Task {
+ public:
+  SweepTask(space::ContinuousMemMapAllocSpace* space,
+            bool swap_bitmaps,
+            uint8_t* begin,
+            uint8_t* end,
+            collector::ObjectBytePair* freed)
+      : space_(space), swap_bitmaps_(swap_bitmaps), begin_(begin), end_(end), freed_(freed) {}
+
+  void Run(Thread* self ATTRIBUTE_UNUSED) override NO_THREAD_SAFETY_ANALYSIS {
+    // Each task has its own result slot, the GC thread records them once all tasks are done.
+    *freed_ = space_->SweepRange(swap_bitmaps_, begin_, end_);
+  }
+
+  void Finalize() override {
+    delete this;
+  }
+
+ private:
+  space::ContinuousMemMapAllocSpace* const space_;
+  const bool swap_bitmaps_;
+  uint8_t* const begin_;
+  uint8_t* const end_;
+  collector::ObjectBytePair* const freed_;
+};
+
+collector::ObjectBytePair MarkSweep::ParallelSweep(space::ContinuousMemMapAllocSpace* space,
+                                                   bool swap_bitmaps,
+                                                   size_t thread_count) {
+  Thread* self = Thread::Current();
+  ThreadPool* thread_pool = GetHeap()->GetThreadPool();
+  uint8_t* const sweep_begin = space->Begin();
+  uint8_t* const sweep_end = space->End();
+  DCHECK_ALIGNED(sweep_begin, kPageSize);
+  // A few tasks per thread balance the uneven garbage density of the ranges. Page aligned range
+  // boundaries make sure that no two tasks clear bits in the same live bitmap word.
+  const size_t range_size = std::max(
+      RoundUp(static_cast<size_t>(sweep_end - sweep_begin) / (thread_count * 4u) + 1u, kPageSize),
+      kMinimumParallelSweepRange);
+  const size_t num_tasks = RoundUp(sweep_end - sweep_begin, range_size) / range_size;
+  // Each task frees its garbage in batches through the space's FreeList, i.e. RosAlloc's
+  // BulkFree.
+  std::vector<collector::ObjectBytePair> freed(num_tasks);
+  size_t task_index = 0;
+  for (uint8_t* begin = sweep_begin; begin < sweep_end; begin += range_size, ++task_index) {
+    uint8_t* end = std::min(begin + range_size, sweep_end);
+    thread_pool->AddTask(self, new SweepTask(space, swap_bitmaps, begin, end, &freed[task_index]));
+  }
+  DCHECK_EQ(task_index, num_tasks);
+  thread_pool->SetMaxActiveWorkers(thread_count - 1);
+  thread_pool->StartWorkers(self);
+  thread_pool->Wait(self, true, true);
+  thread_pool->StopWorkers(self);
+  collector::ObjectBytePair total;
+  for (const collector::ObjectBytePair& task_freed : freed) {
+    total.Add(task_freed);
+  }
+  return total;
+}
+
 void MarkSweep::SweepLargeObjects(bool swap_bitmaps) {
   space::LargeObjectSpace* los = heap_->GetLargeObjectsSpace();
   if (los != nullptr) {
@@ -153,6 +153,14 @@ class MarkSweep : public GarbageCollector {
   // Sweeps unmarked objects to complete the garbage collection.
   void SweepLargeObjects(bool swap_bitmaps) REQUIRES(Locks::heap_bitmap_lock_);
 
+  // Sweeps `space` by splitting it into page aligned ranges swept by the GC thread pool. The
+  // space's FreeList must be thread safe.
+  collector::ObjectBytePair ParallelSweep(space::ContinuousMemMapAllocSpace* space,
+                                          bool swap_bitmaps,
+                                          size_t thread_count)
+      REQUIRES(Locks::heap_bitmap_lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   // Sweep only pointers within an array. WARNING: Trashes objects.
   void SweepArray(accounting::ObjectStack* allocation_stack_, bool swap_bitmaps)
       REQUIRES(Locks::heap_bitmap_lock_)
@@ -364,6 +372,7 @@ class MarkSweep : public GarbageCollector {
   class RecursiveMarkTask;
   class ScanObjectParallelVisitor;
   class ScanObjectVisitor;
+  class SweepTask;
   class VerifyRootMarkedVisitor;
   class VerifyRootVisitor;
   class VerifySystemWeakVisitor;
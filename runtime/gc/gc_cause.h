@@ -62,6 +62,8 @@ enum GcCause {
   kGcCauseGetObjectsAllocated,
   // GC cause for the profile saver.
   kGcCauseProfileSaver,
+  // Full compaction of a fragmented heap while the process is in the background.
+  kGcCauseIdleCompaction,
 };
 
 const char* PrettyCause(GcCause cause);
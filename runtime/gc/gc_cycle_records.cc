@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2019 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gc_cycle_records.h"
+
+#include <string.h>
+
+#include <atomic>
+
+namespace art {
+namespace gc {
+
+GcCycleRecords::GcCycleRecords() : num_added_(0u) {
+  for (Slot& slot : slots_) {
+    slot.sequence.store(0u, std::memory_order_relaxed);
+    for (Atomic<uint64_t>& word : slot.words) {
+      word.store(0u, std::memory_order_relaxed);
+    }
+  }
+}
+
+void GcCycleRecords::Add(const GcCycleRecord& record) {
+  uint64_t words[kRecordWords];
+  memcpy(words, &record, sizeof(record));
+  const uint64_t index = num_added_.load(std::memory_order_relaxed);
+  Slot& slot = slots_[index % kNumRecords];
+  const uint64_t sequence = slot.sequence.load(std::memory_order_relaxed);
+  slot.sequence.store(sequence + 1u, std::memory_order_relaxed);
+  // Readers that see any of the new words also see the odd sequence number.
+  std::atomic_thread_fence(std::memory_order_release);
+  for (size_t i = 0; i < kRecordWords; ++i) {
+    slot.words[i].store(words[i], std::memory_order_relaxed);
+  }
+  slot.sequence.store(sequence + 2u, std::memory_order_release);
+  num_added_.store(index + 1u, std::memory_order_release);
+}
+
+std::vector<GcCycleRecord> GcCycleRecords::GetRecords() const {
+  const uint64_t num_added = num_added_.load(std::memory_order_acquire);
+  const uint64_t first = num_added > kNumRecords ? num_added - kNumRecords : 0u;
+  std::vector<GcCycleRecord> records;
+  records.reserve(num_added - first);
+  for (uint64_t index = first; index < num_added; ++index) {
+    const Slot& slot = slots_[index % kNumRecords];
+    // The sequence number the slot has right after the write of record `index` completed.
+    const uint64_t expected_sequence = 2u * (index / kNumRecords + 1u);
+    if (slot.sequence.load(std::memory_order_acquire) != expected_sequence) {
+      continue;  // Overwritten by a newer record.
+    }
+    uint64_t words[kRecordWords];
+    for (size_t i = 0; i < kRecordWords; ++i) {
+      words[i] = slot.words[i].load(std::memory_order_relaxed);
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.sequence.load(std::memory_order_relaxed) != expected_sequence) {
+      continue;  // Overwritten while we copied it.
+    }
+    GcCycleRecord record;
+    memcpy(&record, words, sizeof(record));
+    records.push_back(record);
+  }
+  return records;
+}
+
+}  // namespace gc
+}  // namespace art
@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2019 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_GC_GC_CYCLE_RECORDS_H_
+#define ART_RUNTIME_GC_GC_CYCLE_RECORDS_H_
+
+#include <stdint.h>
+#include <type_traits>
+#include <vector>
+
+#include "base/atomic.h"
+#include "base/macros.h"
+
+namespace art {
+namespace gc {
+
+// Summary of one completed GC cycle. All fields are 64 bits wide so that the record can be
+// exported as an array of jlongs, see the com.android.art.gc.get_gc_cycle_records extension.
+struct GcCycleRecord {
+  // Number of pause times recorded in `pause_ns`, further pauses only count in `total_pause_ns`.
+  static constexpr size_t kMaxPauses = 4;
+
+  uint64_t end_time_ns;
+  uint64_t duration_ns;
+  uint64_t total_pause_ns;
+  uint64_t num_pauses;
+  uint64_t pause_ns[kMaxPauses];
+  uint64_t gc_cause;        // GcCause.
+  uint64_t gc_type;         // collector::GcType.
+  uint64_t collector_type;  // CollectorType.
+  uint64_t freed_objects;
+  int64_t freed_bytes;
+  uint64_t freed_large_objects;
+  int64_t freed_large_object_bytes;
+  uint64_t bytes_allocated_after_gc;
+  // Bytes of the non-free regions after the GC, 0 without a region space.
+  uint64_t region_space_footprint;
+};
+
+// Fixed size ring of the most recent GC cycle records. The GC is the only writer, which never
+// blocks on readers; readers use a per slot sequence number to discard records that were
+// overwritten while they copied them.
+class GcCycleRecords {
+ public:
+  static constexpr size_t kNumRecords = 64;
+
+  GcCycleRecords();
+
+  // Only called by the thread that completes a GC, GCs do not run concurrently.
+  void Add(const GcCycleRecord& record);
+
+  // Returns up to kNumRecords of the most recent records, oldest first.
+  std::vector<GcCycleRecord> GetRecords() const;
+
+  uint64_t GetNumRecordsAdded() const {
+    return num_added_.load(std::memory_order_acquire);
+  }
+
+ private:
+  static_assert(std::is_trivially_copyable<GcCycleRecord>::value, "Record copied as raw words");
+  static_assert(sizeof(GcCycleRecord) % sizeof(uint64_t) == 0, "Record copied as raw words");
+  static constexpr size_t kRecordWords = sizeof(GcCycleRecord) / sizeof(uint64_t);
+
+  struct Slot {
+    // Odd while the slot is being written, 2 * (number of completed writes) otherwise.
+    Atomic<uint64_t> sequence;
+    Atomic<uint64_t> words[kRecordWords];
+  };
+
+  Slot slots_[kNumRecords];
+  Atomic<uint64_t> num_added_;
+
+  DISALLOW_COPY_AND_ASSIGN(GcCycleRecords);
+};
+
+}  // namespace gc
+}  // namespace art
+
+#endif  // ART_RUNTIME_GC_GC_CYCLE_RECORDS_H_
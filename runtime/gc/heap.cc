@@ -16,16 +16,26 @@
 
 #include "heap.h"
 
+#include <algorithm>
+#include <fcntl.h>
 #include <limits>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
 #if defined(__BIONIC__) || defined(__GLIBC__)
 #include <malloc.h>  // For mallinfo()
 #endif
 #include <memory>
+#include <unistd.h>
+#include <unordered_map>
 #include <vector>
 
+#include "android-base/file.h"
 #include "android-base/stringprintf.h"
+#include "android-base/unique_fd.h"
 
 #include "allocation_listener.h"
+#include "allocation_sampler.h"
 #include "art_field-inl.h"
 #include "backtrace_helper.h"
 #include "base/allocator.h"
@@ -84,6 +94,8 @@
 #include "mirror/object-refvisitor-inl.h"
 #include "mirror/object_array-inl.h"
 #include "mirror/reference-inl.h"
+#include "mirror/string-inl.h"
+#include "monitor_pool.h"
 #include "nativehelper/scoped_local_ref.h"
 #include "obj_ptr-inl.h"
 #include "reflection.h"
@@ -149,6 +161,11 @@ static constexpr bool kLogAllGCs = false;
 // allocate with relaxed ergonomics for that long.
 static constexpr size_t kPostForkMaxHeapDurationMS = 2000;
 
+// An idle compaction only runs if the live bytes of the region space fill less than this
+// percentage of its non-free regions, and the compaction would free at least this many regions.
+static constexpr uint64_t kIdleCompactionLivePercentThreshold = 75u;
+static constexpr uint64_t kIdleCompactionMinWastedRegions = 16u;
+
 #if defined(__LP64__) || !defined(ADDRESS_SANITIZER)
 // 300 MB (0x12c00000) - (default non-moving space capacity).
 uint8_t* const Heap::kPreferredAllocSpaceBegin =
@@ -244,6 +261,7 @@ Heap::Heap(size_t initial_size,
       native_bytes_registered_(0),
       old_native_bytes_allocated_(0),
       native_objects_notified_(0),
+      finalizable_objects_allocated_(0u),
       num_bytes_freed_revoke_(0),
       verify_missing_card_marks_(false),
       verify_system_weaks_(false),
@@ -272,6 +290,10 @@ Heap::Heap(size_t initial_size,
       max_free_(max_free),
       target_utilization_(target_utilization),
       foreground_heap_growth_multiplier_(foreground_heap_growth_multiplier),
+      gc_cpu_fraction_target_(0.0),
+      heap_growth_adjustment_(1.0),
+      adjustment_last_gc_cpu_time_ns_(0u),
+      adjustment_last_process_cpu_time_ns_(0u),
       total_wait_time_(0),
       verify_object_mode_(kVerifyObjectModeDisabled),
       disable_moving_gc_count_(0),
@@ -287,6 +309,7 @@ Heap::Heap(size_t initial_size,
       last_time_homogeneous_space_compaction_by_oom_(NanoTime()),
       pending_collector_transition_(nullptr),
       pending_heap_trim_(nullptr),
+      pending_idle_compaction_(nullptr),
       use_homogeneous_space_compaction_for_oom_(use_homogeneous_space_compaction_for_oom),
       use_generational_cc_(use_generational_cc),
       running_collection_is_blocking_(false),
@@ -295,6 +318,7 @@ Heap::Heap(size_t initial_size,
       last_update_time_gc_count_rate_histograms_(  // Round down by the window duration.
           (NanoTime() / kGcCountRateHistogramWindowDuration) * kGcCountRateHistogramWindowDuration),
       gc_count_last_window_(0U),
+      gcs_completed_(0U),
       blocking_gc_count_last_window_(0U),
       gc_count_rate_histogram_("gc count rate histogram", 1U, kGcCountRateMaxBucketCount),
       blocking_gc_count_rate_histogram_("blocking gc count rate histogram", 1U,
@@ -596,9 +620,16 @@ Heap::Heap(size_t initial_size,
   if (HasBootImageSpace()) {
     // Don't add the image mod union table if we are running without an image, this can crash if
     // we use the CardCache implementation.
+    // The boot images are loaded into a single reservation, so no other space lies between them.
+    uint8_t* boot_images_begin = GetBootImageSpaces().front()->Begin();
+    uint8_t* boot_images_end = GetBootImageSpaces().front()->End();
+    for (space::ImageSpace* image_space : GetBootImageSpaces()) {
+      boot_images_begin = std::min(boot_images_begin, image_space->Begin());
+      boot_images_end = std::max(boot_images_end, image_space->End());
+    }
     for (space::ImageSpace* image_space : GetBootImageSpaces()) {
       accounting::ModUnionTable* mod_union_table = new accounting::ModUnionTableToZygoteAllocspace(
-          "Image mod-union table", this, image_space);
+          "Image mod-union table", this, image_space, boot_images_begin, boot_images_end);
       CHECK(mod_union_table != nullptr) << "Failed to create image mod-union table";
       AddModUnionTable(mod_union_table);
     }
@@ -729,6 +760,10 @@ MemMap Heap::MapAnonymousPreferredAddress(const char* name,
                                       /*reuse=*/ false,
                                       /*reservation=*/ nullptr,
                                       out_error_str);
+    if (map.IsValid()) {
+      map.SetNativeMemoryTag(NativeMemoryTag::kJavaHeap);
+      map.MadviseHugePages();
+    }
     if (map.IsValid() || request_begin == nullptr) {
       return map;
     }
@@ -992,6 +1027,9 @@ void Heap::UpdateProcessState(ProcessState old_process_state, ProcessState new_p
                                  kStressCollectorTransition
                                      ? 0
                                      : kCollectorTransitionWait);
+      // Long lived background processes keep fragmenting the region space after the
+      // transition compaction, check it periodically.
+      RequestIdleCompaction(Thread::Current(), kIdleCompactionInterval);
     }
   }
 }
@@ -1143,8 +1181,16 @@ void Heap::DumpGcPerformanceInfo(std::ostream& os) {
     os << "Mean GC object throughput: "
        << (GetObjectsFreedEver() / total_seconds) << " objects/s\n";
   }
+  if (gc_cpu_fraction_target_ != 0.0) {
+    os << "Heap growth adjustment: " << heap_growth_adjustment_
+       << " (GC CPU fraction target " << gc_cpu_fraction_target_ << ")\n";
+  }
   uint64_t total_objects_allocated = GetObjectsAllocatedEver();
   os << "Total number of allocations " << total_objects_allocated << "\n";
+  // Finalizers which were scheduled but did not run yet wait in the FinalizerDaemon queue, which
+  // is only known to libcore.
+  os << "Total finalizable objects allocated " << GetFinalizableObjectsAllocated()
+     << ", finalizers scheduled " << GetReferenceProcessor()->GetFinalizersScheduled() << "\n";
   os << "Total bytes allocated " << PrettySize(GetBytesAllocatedEver()) << "\n";
   os << "Total bytes freed " << PrettySize(GetBytesFreedEver()) << "\n";
   os << "Free memory " << PrettySize(GetFreeMemory()) << "\n";
@@ -1187,9 +1233,41 @@ void Heap::DumpGcPerformanceInfo(std::ostream& os) {
   os << "Total native bytes at last GC: "
      << old_native_bytes_allocated_.load(std::memory_order_relaxed) << "\n";
 
+  DumpTlabStats(os);
+  if (allocation_sampler_ != nullptr) {
+    allocation_sampler_->Dump(os);
+  }
+  if (region_space_ != nullptr) {
+    region_space_->DumpFragmentation(os);
+  }
+
   BaseMutex::DumpAll(os);
 }
 
+void Heap::DumpTlabStats(std::ostream& os) {
+  if (!IsTLABAllocator(GetCurrentAllocator())) {
+    return;
+  }
+  Thread* self = Thread::Current();
+  MutexLock mu(self, *Locks::thread_list_lock_);
+  for (Thread* thread : Runtime::Current()->GetThreadList()->GetList()) {
+    // Racy reads of the other threads' state, which is fine for statistics.
+    const Thread::TlabSizingInfo* info = thread->GetTlabSizingInfo();
+    if (info->refill_count != 0u) {
+      os << "TLAB refills for " << *thread << ": " << info->refill_count
+         << ", current TLAB size " << PrettySize(info->size) << "\n";
+    }
+  }
+}
+
+void Heap::SetAllocationSamplingInterval(size_t mean_interval) {
+  if (mean_interval == 0u) {
+    allocation_sampler_.reset();
+  } else {
+    allocation_sampler_.reset(new AllocationSampler(mean_interval));
+  }
+}
+
 void Heap::ResetGcPerformanceInfo() {
   for (auto* collector : garbage_collectors_) {
     collector->ResetMeasurements();
@@ -1421,8 +1499,10 @@ void Heap::Trim(Thread* self) {
     ScopedSuspendAll ssa(__FUNCTION__);
     uint64_t start_time = NanoTime();
     size_t count = runtime->GetMonitorList()->DeflateMonitors();
-    VLOG(heap) << "Deflating " << count << " monitors took "
-        << PrettyDuration(NanoTime() - start_time);
+    // The deflated monitors went back to the pool, return the chunks that are now unused.
+    size_t trimmed_chunks = MonitorPool::TrimChunks(self);
+    VLOG(heap) << "Deflating " << count << " monitors and trimming " << trimmed_chunks
+        << " monitor chunks took " << PrettyDuration(NanoTime() - start_time);
   }
   TrimIndirectReferenceTables(self);
   TrimSpaces(self);
@@ -1902,6 +1982,15 @@ void Heap::SetTargetHeapUtilization(float target) {
   target_utilization_ = target;
 }
 
+void Heap::SetGcCpuFractionTarget(double fraction) {
+  DCHECK_GE(fraction, 0.0);
+  DCHECK_LT(fraction, 1.0);
+  gc_cpu_fraction_target_ = fraction;
+  heap_growth_adjustment_ = 1.0;
+  adjustment_last_gc_cpu_time_ns_ = GetTotalGcCpuTime();
+  adjustment_last_process_cpu_time_ns_ = ProcessCpuNanoTime();
+}
+
 size_t Heap::GetObjectsAllocated() const {
   Thread* const self = Thread::Current();
   ScopedThreadStateChange tsc(self, kWaitingForGetObjectsAllocated);
@@ -1975,6 +2064,172 @@ void Heap::GetInstances(VariableSizedHandleScope& scope,
   VisitObjects(instance_collector);
 }
 
+void Heap::DumpDuplicateStrings(std::ostream& os, size_t max_entries) {
+  struct StringGroup {
+    mirror::String* first;
+    size_t count;
+    size_t size;
+    std::string contents;  // Only set once a duplicate is found.
+  };
+  // Keyed by hash code, computed without storing it so that the walk does not dirty pages.
+  std::unordered_multimap<int32_t, StringGroup> groups;
+  size_t string_count = 0u;
+  size_t string_bytes = 0u;
+  size_t duplicate_count = 0u;
+  size_t duplicate_bytes = 0u;
+  // Objects may move once the visit ends, so the contents are copied during the visit.
+  auto string_visitor = [&](mirror::Object* obj) REQUIRES_SHARED(Locks::mutator_lock_) {
+    if (!obj->IsString()) {
+      return;
+    }
+    mirror::String* str = obj->AsString();
+    size_t size = str->SizeOf();
+    ++string_count;
+    string_bytes += size;
+    int32_t hash = str->IsCompressed()
+        ? ComputeUtf16Hash(str->GetValueCompressed(), str->GetLength())
+        : ComputeUtf16Hash(str->GetValue(), str->GetLength());
+    auto range = groups.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+      StringGroup& group = it->second;
+      if (group.first->Equals(str)) {
+        if (group.count == 1u) {
+          group.contents = group.first->ToModifiedUtf8();
+        }
+        ++group.count;
+        ++duplicate_count;
+        duplicate_bytes += size;
+        return;
+      }
+    }
+    groups.emplace(hash, StringGroup{str, 1u, size, std::string()});
+  };
+  VisitObjects(string_visitor);
+
+  std::vector<const StringGroup*> duplicated;
+  for (const auto& entry : groups) {
+    if (entry.second.count > 1u) {
+      duplicated.push_back(&entry.second);
+    }
+  }
+  std::sort(duplicated.begin(),
+            duplicated.end(),
+            [](const StringGroup* lhs, const StringGroup* rhs) {
+              return (lhs->count - 1u) * lhs->size > (rhs->count - 1u) * rhs->size;
+            });
+  os << "Strings: " << string_count << " (" << PrettySize(string_bytes) << "), duplicates: "
+     << duplicate_count << " (" << PrettySize(duplicate_bytes) << ") in " << duplicated.size()
+     << " distinct strings\n";
+  static constexpr size_t kMaxShownLength = 64u;
+  for (size_t i = 0; i != std::min(max_entries, duplicated.size()); ++i) {
+    const StringGroup* group = duplicated[i];
+    os << "  " << group->count << " copies of " << group->size << " bytes: \"";
+    if (group->contents.size() > kMaxShownLength) {
+      os << group->contents.substr(0u, kMaxShownLength) << "...";
+    } else {
+      os << group->contents;
+    }
+    os << "\"\n";
+  }
+}
+
+// Sets `exclusive_pages` to whether each page of [begin, end) is present and mapped only by this
+// process. Pages of the boot image and zygote spaces are shared with the zygote after a fork until
+// they are written to.
+static bool ReadExclusivePages(const uint8_t* begin,
+                               const uint8_t* end,
+                               std::vector<bool>* exclusive_pages) {
+  static constexpr uint64_t kPagemapPresent = UINT64_C(1) << 63;
+  static constexpr uint64_t kPagemapExclusive = UINT64_C(1) << 56;
+  android::base::unique_fd fd(
+      TEMP_FAILURE_RETRY(open("/proc/self/pagemap", O_RDONLY | O_CLOEXEC)));
+  if (fd.get() == -1) {
+    return false;
+  }
+  size_t page_count = (end - begin) / kPageSize;
+  std::vector<uint64_t> entries(page_count);
+  off_t offset = (reinterpret_cast<uintptr_t>(begin) / kPageSize) * sizeof(uint64_t);
+  size_t size = page_count * sizeof(uint64_t);
+  if (TEMP_FAILURE_RETRY(pread(fd.get(), entries.data(), size, offset)) !=
+          static_cast<ssize_t>(size)) {
+    return false;
+  }
+  exclusive_pages->resize(page_count);
+  for (size_t i = 0; i != page_count; ++i) {
+    (*exclusive_pages)[i] = (entries[i] & (kPagemapPresent | kPagemapExclusive)) ==
+        (kPagemapPresent | kPagemapExclusive);
+  }
+  return true;
+}
+
+void Heap::DumpSharedDirtyObjects(std::ostream& os, size_t max_entries) {
+  struct SharedSpace {
+    space::ContinuousSpace* space;
+    std::vector<bool> dirty_pages;
+  };
+  std::vector<SharedSpace> shared_spaces;
+  for (space::ImageSpace* space : boot_image_spaces_) {
+    shared_spaces.push_back(SharedSpace{space, std::vector<bool>()});
+  }
+  if (zygote_space_ != nullptr) {
+    shared_spaces.push_back(SharedSpace{zygote_space_, std::vector<bool>()});
+  }
+  for (SharedSpace& shared : shared_spaces) {
+    const uint8_t* begin = AlignDown(shared.space->Begin(), kPageSize);
+    const uint8_t* end = AlignUp(shared.space->End(), kPageSize);
+    if (!ReadExclusivePages(begin, end, &shared.dirty_pages)) {
+      os << "Could not read /proc/self/pagemap: " << strerror(errno) << "\n";
+      return;
+    }
+    size_t dirty_count = std::count(shared.dirty_pages.begin(), shared.dirty_pages.end(), true);
+    os << shared.space->GetName() << ": " << dirty_count << " of " << shared.dirty_pages.size()
+       << " pages dirty\n";
+  }
+
+  struct DirtyClass {
+    size_t count;
+    size_t bytes;
+  };
+  std::unordered_map<mirror::Class*, DirtyClass> dirty_classes;
+  size_t dirty_objects = 0u;
+  auto dirty_visitor = [&](mirror::Object* obj) REQUIRES_SHARED(Locks::mutator_lock_) {
+    for (const SharedSpace& shared : shared_spaces) {
+      if (!shared.space->HasAddress(obj)) {
+        continue;
+      }
+      const uint8_t* space_begin = AlignDown(shared.space->Begin(), kPageSize);
+      const uint8_t* obj_begin = reinterpret_cast<const uint8_t*>(obj);
+      size_t size = obj->SizeOf();
+      size_t first_page = (obj_begin - space_begin) / kPageSize;
+      size_t last_page = (obj_begin + size - 1u - space_begin) / kPageSize;
+      for (size_t page = first_page; page <= last_page; ++page) {
+        if (shared.dirty_pages[page]) {
+          DirtyClass& dirty = dirty_classes[obj->GetClass<kVerifyNone, kWithoutReadBarrier>()];
+          ++dirty.count;
+          dirty.bytes += size;
+          ++dirty_objects;
+          break;
+        }
+      }
+      return;
+    }
+  };
+  VisitObjects(dirty_visitor);
+
+  std::vector<std::pair<mirror::Class*, DirtyClass>> sorted(dirty_classes.begin(),
+                                                            dirty_classes.end());
+  std::sort(sorted.begin(),
+            sorted.end(),
+            [](const auto& lhs, const auto& rhs) { return lhs.second.count > rhs.second.count; });
+  os << "Objects on dirty pages: " << dirty_objects << " of " << sorted.size() << " classes\n";
+  // Descriptors are printed in the format of the dirty-image-objects list.
+  for (size_t i = 0; i != std::min(max_entries, sorted.size()); ++i) {
+    std::string temp;
+    os << "  " << sorted[i].second.count << " objects (" << PrettySize(sorted[i].second.bytes)
+       << "): " << sorted[i].first->GetDescriptor(&temp) << "\n";
+  }
+}
+
 void Heap::GetReferringObjects(VariableSizedHandleScope& scope,
                                Handle<mirror::Object> o,
                                int32_t max_count,
@@ -2773,7 +3028,11 @@ collector::GcType Heap::CollectGarbageInternal(collector::GcType gc_type,
       }
       CHECK(temp_space_->IsEmpty());
     }
-    gc_type = collector::kGcTypeFull;  // TODO: Not hard code this in.
+    // A young-generation CC cycle only collects the regions allocated since the last GC, report
+    // it as sticky so that callers (and `last_gc_type_`) can tell minor from major collections.
+    gc_type = (use_generational_cc_ && collector == young_concurrent_copying_collector_)
+        ? collector::kGcTypeSticky
+        : collector::kGcTypeFull;
   } else if (current_allocator_ == kAllocatorTypeRosAlloc ||
       current_allocator_ == kAllocatorTypeDlMalloc) {
     collector = FindCollectorByGcType(gc_type);
@@ -2793,6 +3052,7 @@ collector::GcType Heap::CollectGarbageInternal(collector::GcType gc_type,
   // Grow the heap so that we know when to perform the next GC.
   GrowForUtilization(collector, bytes_allocated_before_gc);
   LogGC(gc_cause, collector);
+  RecordGcCycle(gc_type, collector);
   FinishGC(self, gc_type);
   // Actually enqueue all cleared references. Do this after the GC has officially finished since
   // otherwise we can deadlock.
@@ -2847,6 +3107,34 @@ void Heap::LogGC(GcCause gc_cause, collector::GarbageCollector* collector) {
   }
 }
 
+void Heap::RecordGcCycle(collector::GcType gc_type, collector::GarbageCollector* collector) {
+  const collector::Iteration* iteration = GetCurrentGcIteration();
+  GcCycleRecord record = {};
+  record.end_time_ns = NanoTime();
+  record.duration_ns = iteration->GetDurationNs();
+  const std::vector<uint64_t>& pause_times = iteration->GetPauseTimes();
+  record.num_pauses = pause_times.size();
+  for (size_t i = 0; i < pause_times.size(); ++i) {
+    record.total_pause_ns += pause_times[i];
+    if (i < GcCycleRecord::kMaxPauses) {
+      record.pause_ns[i] = pause_times[i];
+    }
+  }
+  record.gc_cause = iteration->GetGcCause();
+  record.gc_type = gc_type;
+  record.collector_type = collector->GetCollectorType();
+  record.freed_objects = iteration->GetFreedObjects();
+  record.freed_bytes = iteration->GetFreedBytes();
+  record.freed_large_objects = iteration->GetFreedLargeObjects();
+  record.freed_large_object_bytes = iteration->GetFreedLargeObjectBytes();
+  record.bytes_allocated_after_gc = GetBytesAllocated();
+  if (region_space_ != nullptr) {
+    record.region_space_footprint =
+        region_space_->GetNumNonFreeRegions() * space::RegionSpace::kRegionSize;
+  }
+  gc_cycle_records_.Add(record);
+}
+
 void Heap::FinishGC(Thread* self, collector::GcType gc_type) {
   MutexLock mu(self, *gc_complete_lock_);
   collector_type_running_ = kCollectorTypeNone;
@@ -2855,6 +3143,7 @@ void Heap::FinishGC(Thread* self, collector::GcType gc_type) {
 
     // Update stats.
     ++gc_count_last_window_;
+    gcs_completed_.fetch_add(1u, std::memory_order_relaxed);
     if (running_collection_is_blocking_) {
       // If the currently running collection was a blocking one,
       // increment the counters and reset the flag.
@@ -3611,6 +3900,24 @@ bool Heap::IsMovableObject(ObjPtr<mirror::Object> obj) const {
   return false;
 }
 
+bool Heap::PinObject(Thread* self ATTRIBUTE_UNUSED, ObjPtr<mirror::Object> obj) {
+  // Only the concurrent copying collector, which decides per region what to evacuate, can
+  // leave the region of a pinned object in place.
+  if (kUseReadBarrier && region_space_ != nullptr && region_space_->HasAddress(obj.Ptr())) {
+    region_space_->PinRegionOf(obj.Ptr());
+    return true;
+  }
+  return false;
+}
+
+bool Heap::UnpinObject(Thread* self ATTRIBUTE_UNUSED, ObjPtr<mirror::Object> obj) {
+  if (kUseReadBarrier && region_space_ != nullptr && region_space_->HasAddress(obj.Ptr())) {
+    region_space_->UnpinRegionOf(obj.Ptr());
+    return true;
+  }
+  return false;
+}
+
 collector::GarbageCollector* Heap::FindCollectorByGcType(collector::GcType gc_type) {
   for (auto* collector : garbage_collectors_) {
     if (collector->GetCollectorType() == collector_type_ &&
@@ -3629,6 +3936,47 @@ double Heap::HeapGrowthMultiplier() const {
   return foreground_heap_growth_multiplier_;
 }
 
+// Reads the share of the last 10 seconds in which some task stalled on memory, in percent, from
+// the pressure stall information of the kernel. Returns false if the kernel does not provide it.
+static bool ReadMemoryPressure(double* some_avg10) {
+  std::string contents;
+  if (!android::base::ReadFileToString("/proc/pressure/memory", &contents)) {
+    return false;
+  }
+  return sscanf(contents.c_str(), "some avg10=%lf", some_avg10) == 1;
+}
+
+void Heap::UpdateHeapGrowthAdjustment() {
+  // Do not let the adaptive sizing grow the heap beyond the static policy when the system is
+  // short on memory.
+  static constexpr double kMemoryPressureThreshold = 10.0;
+  static constexpr double kMinHeapGrowthAdjustment = 0.5;
+  static constexpr double kMaxHeapGrowthAdjustment = 4.0;
+  const uint64_t gc_cpu_time = GetTotalGcCpuTime();
+  const uint64_t process_cpu_time = ProcessCpuNanoTime();
+  const uint64_t process_cpu_delta = process_cpu_time - adjustment_last_process_cpu_time_ns_;
+  if (process_cpu_delta == 0u) {
+    return;
+  }
+  const double gc_cpu_fraction =
+      static_cast<double>(gc_cpu_time - adjustment_last_gc_cpu_time_ns_) / process_cpu_delta;
+  adjustment_last_gc_cpu_time_ns_ = gc_cpu_time;
+  adjustment_last_process_cpu_time_ns_ = process_cpu_time;
+  // The GC cost is roughly inversely proportional to the free space, take the square root of the
+  // ratio to damp the oscillations between GCs with very different costs.
+  double adjustment = heap_growth_adjustment_ * sqrt(gc_cpu_fraction / gc_cpu_fraction_target_);
+  double memory_pressure;
+  if (adjustment > 1.0 &&
+      ReadMemoryPressure(&memory_pressure) &&
+      memory_pressure >= kMemoryPressureThreshold) {
+    adjustment = 1.0;
+  }
+  heap_growth_adjustment_ =
+      std::max(kMinHeapGrowthAdjustment, std::min(adjustment, kMaxHeapGrowthAdjustment));
+  VLOG(heap) << "GC CPU fraction " << gc_cpu_fraction << ", heap growth adjustment "
+             << heap_growth_adjustment_;
+}
+
 void Heap::GrowForUtilization(collector::GarbageCollector* collector_ran,
                               size_t bytes_allocated_before_gc) {
   // We know what our utilization is at this moment.
@@ -3642,13 +3990,17 @@ void Heap::GrowForUtilization(collector::GarbageCollector* collector_ran,
   const double multiplier = HeapGrowthMultiplier();  // Use the multiplier to grow more for
   // foreground.
   const size_t adjusted_min_free = static_cast<size_t>(min_free_ * multiplier);
-  const size_t adjusted_max_free = static_cast<size_t>(max_free_ * multiplier);
+  if (gc_cpu_fraction_target_ != 0.0 && gc_type != collector::kGcTypeSticky) {
+    UpdateHeapGrowthAdjustment();
+  }
+  const size_t adjusted_max_free =
+      static_cast<size_t>(max_free_ * multiplier * heap_growth_adjustment_);
   if (gc_type != collector::kGcTypeSticky) {
     // Grow the heap for non sticky GC.
     uint64_t delta = bytes_allocated * (1.0 / GetTargetHeapUtilization() - 1.0);
     DCHECK_LE(delta, std::numeric_limits<size_t>::max()) << "bytes_allocated=" << bytes_allocated
         << " target_utilization_=" << target_utilization_;
-    target_size = bytes_allocated + delta * multiplier;
+    target_size = bytes_allocated + delta * multiplier * heap_growth_adjustment_;
     target_size = std::min(target_size,
                            static_cast<uint64_t>(bytes_allocated + adjusted_max_free));
     target_size = std::max(target_size,
@@ -3767,6 +4119,7 @@ void Heap::ClearGrowthLimit() {
 }
 
 void Heap::AddFinalizerReference(Thread* self, ObjPtr<mirror::Object>* object) {
+  finalizable_objects_allocated_.fetch_add(1u, std::memory_order_relaxed);
   ScopedObjectAccess soa(self);
   ScopedLocalRef<jobject> arg(self->GetJniEnv(), soa.AddLocalReference<jobject>(*object));
   jvalue args[1];
@@ -3885,6 +4238,77 @@ void Heap::RequestCollectorTransition(CollectorType desired_collector_type, uint
   task_processor_->AddTask(self, added_task);
 }
 
+class Heap::IdleCompactionTask : public HeapTask {
+ public:
+  explicit IdleCompactionTask(uint64_t target_time) : HeapTask(target_time) {}
+
+  void Run(Thread* self) override {
+    gc::Heap* heap = Runtime::Current()->GetHeap();
+    heap->ClearPendingIdleCompaction(self);
+    if (heap->DoIdleCompaction()) {
+      heap->RequestIdleCompaction(self, kIdleCompactionInterval);
+    }
+  }
+};
+
+void Heap::ClearPendingIdleCompaction(Thread* self) {
+  MutexLock mu(self, *pending_task_lock_);
+  pending_idle_compaction_ = nullptr;
+}
+
+void Heap::RequestIdleCompaction(Thread* self, uint64_t delta_time) {
+  if (region_space_ == nullptr || !CanAddHeapTask(self)) {
+    return;
+  }
+  IdleCompactionTask* added_task = nullptr;
+  const uint64_t target_time = NanoTime() + delta_time;
+  {
+    MutexLock mu(self, *pending_task_lock_);
+    if (pending_idle_compaction_ != nullptr) {
+      task_processor_->UpdateTargetRunTime(self, pending_idle_compaction_, target_time);
+      return;
+    }
+    added_task = new IdleCompactionTask(target_time);
+    pending_idle_compaction_ = added_task;
+  }
+  task_processor_->AddTask(self, added_task);
+}
+
+bool Heap::DoIdleCompaction() {
+  if (CareAboutPauseTimes() || collector_type_ != kCollectorTypeCC) {
+    // Do not compact behind the back of a foreground process; the next transition to the
+    // background restarts the checks.
+    return false;
+  }
+  DCHECK(region_space_ != nullptr);
+  // Right after a GC, the bytes allocated outside of the region space and the region space
+  // footprint tell how much of the non-free regions is wasted by dead objects. Objects that died
+  // since the last GC are counted as live, which only makes the estimate conservative.
+  uint64_t other_bytes = 0u;
+  if (non_moving_space_ != nullptr) {
+    other_bytes += non_moving_space_->GetBytesAllocated();
+  }
+  if (large_object_space_ != nullptr) {
+    other_bytes += large_object_space_->GetBytesAllocated();
+  }
+  const uint64_t bytes_allocated = GetBytesAllocated();
+  const uint64_t region_bytes = bytes_allocated > other_bytes ? bytes_allocated - other_bytes : 0u;
+  const uint64_t footprint =
+      static_cast<uint64_t>(region_space_->GetNumNonFreeRegions()) *
+      space::RegionSpace::kRegionSize;
+  const uint64_t wasted_bytes = footprint > region_bytes ? footprint - region_bytes : 0u;
+  if (wasted_bytes >= kIdleCompactionMinWastedRegions * space::RegionSpace::kRegionSize &&
+      region_bytes * 100u < kIdleCompactionLivePercentThreshold * footprint) {
+    VLOG(heap) << "Idle compaction of " << PrettySize(footprint) << " of regions holding "
+               << PrettySize(region_bytes);
+    // A full compaction evacuates all regions, ClearFromSpace releases the freed ones.
+    CollectGarbageInternal(collector::kGcTypeFull,
+                           kGcCauseIdleCompaction,
+                           /*clear_soft_references=*/false);
+  }
+  return true;
+}
+
 class Heap::HeapTrimTask : public HeapTask {
  public:
   explicit HeapTrimTask(uint64_t delta_time) : HeapTask(NanoTime() + delta_time) { }
@@ -4330,7 +4754,7 @@ mirror::Object* Heap::AllocWithNewTLAB(Thread* self,
     DCHECK_LE(alloc_size, self->TlabSize());
   } else if (allocator_type == kAllocatorTypeTLAB) {
     DCHECK(bump_pointer_space_ != nullptr);
-    const size_t new_tlab_size = alloc_size + kDefaultTLABSize;
+    const size_t new_tlab_size = alloc_size + NextTlabSize(self, kDefaultTLABSize);
     if (UNLIKELY(IsOutOfMemoryOnAllocation(allocator_type, new_tlab_size, grow))) {
       return nullptr;
     }
@@ -4349,7 +4773,8 @@ mirror::Object* Heap::AllocWithNewTLAB(Thread* self,
                                             space::RegionSpace::kRegionSize,
                                             grow))) {
         const size_t new_tlab_size = kUsePartialTlabs
-            ? std::max(alloc_size, kPartialTlabSize)
+            ? std::min(std::max(alloc_size, NextTlabSize(self, kPartialTlabSize)),
+                       gc::space::RegionSpace::kRegionSize)
             : gc::space::RegionSpace::kRegionSize;
         // Try to allocate a tlab.
         if (!region_space_->AllocNewTlab(self, new_tlab_size, bytes_tl_bulk_allocated)) {
@@ -4382,6 +4807,9 @@ mirror::Object* Heap::AllocWithNewTLAB(Thread* self,
       return nullptr;
     }
   }
+  if (allocation_sampler_ != nullptr) {
+    allocation_sampler_->RecordRefill(self, *bytes_tl_bulk_allocated);
+  }
   // Refilled TLAB, return.
   mirror::Object* ret = self->AllocTlab(alloc_size);
   DCHECK(ret != nullptr);
@@ -4390,6 +4818,31 @@ mirror::Object* Heap::AllocWithNewTLAB(Thread* self,
   return ret;
 }
 
+size_t Heap::NextTlabSize(Thread* self, size_t initial_size) {
+  Thread::TlabSizingInfo* info = self->GetTlabSizingInfo();
+  const uint64_t now = NanoTime();
+  const uint32_t gcs_completed = gcs_completed_.load(std::memory_order_relaxed);
+  size_t size = initial_size;
+  if (info->refill_count != 0u) {
+    const uint64_t refill_interval = now - info->last_refill_time_ns;
+    const bool gc_since_last_refill = gcs_completed != info->gc_count_at_last_refill;
+    size = info->size;
+    if (!gc_since_last_refill && refill_interval < kFastTlabRefillInterval) {
+      // The thread allocates a lot, refill less often.
+      size = std::min(size * 2u, kMaxTlabSize);
+    } else if (gc_since_last_refill || refill_interval > kSlowTlabRefillInterval) {
+      // The thread allocates little, the unused rest of its TLAB would be wasted when the
+      // TLAB gets revoked by the GC.
+      size = std::max(size / 2u, kMinTlabSize);
+    }
+  }
+  info->size = size;
+  info->refill_count++;
+  info->last_refill_time_ns = now;
+  info->gc_count_at_last_refill = gcs_completed;
+  return size;
+}
+
 const Verification* Heap::GetVerification() const {
   return verification_.get();
 }
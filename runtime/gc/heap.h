@@ -35,6 +35,7 @@
 #include "gc/collector/iteration.h"
 #include "gc/collector_type.h"
 #include "gc/gc_cause.h"
+#include "gc/gc_cycle_records.h"
 #include "gc/space/image_space_loading_order.h"
 #include "gc/space/large_object_space.h"
 #include "handle.h"
@@ -67,6 +68,7 @@ namespace gc {
 
 class AllocationListener;
 class AllocRecordObjectMap;
+class AllocationSampler;
 class GcPauseListener;
 class ReferenceProcessor;
 class TaskProcessor;
@@ -140,6 +142,13 @@ class Heap {
   static constexpr size_t kDefaultLongPauseLogThreshold = MsToNs(5);
   static constexpr size_t kDefaultLongGCLogThreshold = MsToNs(100);
   static constexpr size_t kDefaultTLABSize = 32 * KB;
+  // Bounds of the adaptive per-thread TLAB size.
+  static constexpr size_t kMinTlabSize = kPartialTlabSize;
+  static constexpr size_t kMaxTlabSize = 256 * KB;
+  // A thread that refills its TLAB faster than this gets a larger TLAB on its next refill.
+  static constexpr uint64_t kFastTlabRefillInterval = MsToNs(1);
+  // A thread that refills its TLAB slower than this gets a smaller TLAB on its next refill.
+  static constexpr uint64_t kSlowTlabRefillInterval = MsToNs(100);
   static constexpr double kDefaultTargetUtilization = 0.5;
   static constexpr double kDefaultHeapGrowthMultiplier = 2.0;
   // Primitive arrays larger than this size are put in the large object space.
@@ -178,6 +187,9 @@ class Heap {
   static constexpr uint64_t kHeapTrimWait = MsToNs(5000);
   // How long we wait after a transition request to perform a collector transition (nanoseconds).
   static constexpr uint64_t kCollectorTransitionWait = MsToNs(5000);
+  // How often we check whether a background process has a fragmented enough region space to
+  // be worth compacting (nanoseconds).
+  static constexpr uint64_t kIdleCompactionInterval = MsToNs(60 * 1000);
   // Whether the transition-wait applies or not. Zero wait will stress the
   // transition code and collector, but increases jank probability.
   DECLARE_RUNTIME_DEBUG_FLAG(kStressCollectorTransition);
@@ -353,6 +365,14 @@ class Heap {
   // Returns true if there is any chance that the object (obj) will move.
   bool IsMovableObject(ObjPtr<mirror::Object> obj) const REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Keeps `obj` from moving by pinning its region instead of disabling moving GC. Returns false
+  // if the object's space does not support pinning, the caller then has to disable moving GC
+  // or the thread flip. A successful call must be paired with UnpinObject.
+  bool PinObject(Thread* self, ObjPtr<mirror::Object> obj) REQUIRES_SHARED(Locks::mutator_lock_);
+  // Returns false, without doing anything, where PinObject would have returned false.
+  bool UnpinObject(Thread* self, ObjPtr<mirror::Object> obj)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   // Enables us to compacting GC until objects are released.
   void IncrementDisableMovingGC(Thread* self) REQUIRES(!*gc_complete_lock_);
   void DecrementDisableMovingGC(Thread* self) REQUIRES(!*gc_complete_lock_);
@@ -403,6 +423,21 @@ class Heap {
       REQUIRES(!Locks::heap_bitmap_lock_, !*gc_complete_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Counts the strings of the heap with equal contents, and dumps the `max_entries` ones which
+  // waste the most memory. Strings cannot be merged by the GC since their identity is visible to
+  // the application, this shows which ones the application could intern or share.
+  void DumpDuplicateStrings(std::ostream& os, size_t max_entries)
+      REQUIRES(!Locks::heap_bitmap_lock_, !*gc_complete_lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Finds the objects of the boot image and zygote spaces which lie on pages this process has
+  // written to, and dumps the `max_entries` classes with the most such objects. In a process
+  // forked from the zygote these are the pages no longer shared with other apps, so the classes
+  // are candidates for the dirty-image-objects list and for segregation at PreZygoteFork.
+  void DumpSharedDirtyObjects(std::ostream& os, size_t max_entries)
+      REQUIRES(!Locks::heap_bitmap_lock_, !*gc_complete_lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   // Removes the growth limit on the alloc space so it may grow to its maximum capacity. Used to
   // implement dalvik.system.VMRuntime.clearGrowthLimit.
   void ClearGrowthLimit();
@@ -456,6 +491,11 @@ class Heap {
   // dalvik.system.VMRuntime.setTargetHeapUtilization.
   void SetTargetHeapUtilization(float target);
 
+  // Makes non sticky GCs scale the free space given by the target utilization so that the GC
+  // threads use about `fraction` of the process CPU time. 0 keeps the static sizing. Must be called
+  // before the first GC.
+  void SetGcCpuFractionTarget(double fraction);
+
   // For the alloc space, sets the maximum number of bytes that the heap is allowed to allocate
   // from the system. Doesn't allow the space to exceed its growth limit.
   void SetIdealFootprint(size_t max_allowed_footprint);
@@ -489,6 +529,11 @@ class Heap {
     return &current_gc_iteration_;
   }
 
+  // Records of the most recent GC cycles, readable without blocking the GC.
+  const GcCycleRecords& GetGcCycleRecords() const {
+    return gc_cycle_records_;
+  }
+
   // Enable verification of object references when the runtime is sufficiently initialized.
   void EnableObjectValidation() {
     verify_object_mode_ = kVerifyObjectSupport;
@@ -516,6 +561,11 @@ class Heap {
   // Scales heap growth, min free, and max free.
   double HeapGrowthMultiplier() const;
 
+  // Moves `heap_growth_adjustment_` towards the value which meets `gc_cpu_fraction_target_`, given
+  // the GC CPU time since the previous call, and stops it from growing the heap under memory
+  // pressure.
+  void UpdateHeapGrowthAdjustment();
+
   // Freed bytes can be negative in cases where we copy objects from a compacted space to a
   // free-list backed space.
   void RecordFree(uint64_t freed_objects, int64_t freed_bytes);
@@ -533,6 +583,11 @@ class Heap {
 
   void AddFinalizerReference(Thread* self, ObjPtr<mirror::Object>* object);
 
+  // Returns the number of objects with a finalizer allocated since the heap was created.
+  uint64_t GetFinalizableObjectsAllocated() const {
+    return finalizable_objects_allocated_.load(std::memory_order_relaxed);
+  }
+
   // Returns the number of bytes currently allocated.
   // The result should be treated as an approximation, if it is being concurrently updated.
   size_t GetBytesAllocated() const {
@@ -621,7 +676,8 @@ class Heap {
   std::string DumpSpaceNameFromAddress(const void* addr) const
       REQUIRES_SHARED(Locks::mutator_lock_);
 
-  void DumpForSigQuit(std::ostream& os) REQUIRES(!*gc_complete_lock_);
+  void DumpForSigQuit(std::ostream& os)
+      REQUIRES(!*gc_complete_lock_, !Locks::thread_list_lock_);
 
   // Do a pending collector transition.
   void DoPendingCollectorTransition() REQUIRES(!*gc_complete_lock_, !*pending_task_lock_);
@@ -738,7 +794,7 @@ class Heap {
 
   // GC performance measuring
   void DumpGcPerformanceInfo(std::ostream& os)
-      REQUIRES(!*gc_complete_lock_);
+      REQUIRES(!*gc_complete_lock_, !Locks::thread_list_lock_);
   void ResetGcPerformanceInfo() REQUIRES(!*gc_complete_lock_);
 
   // Thread pool.
@@ -875,6 +931,14 @@ class Heap {
   void BroadcastForNewAllocationRecords() const
       REQUIRES(!Locks::alloc_tracker_lock_);
 
+  // Enables sampling of one allocation stack per `mean_interval` bytes on average on the TLAB
+  // refill slow path, 0 disables it. Must be called before other threads start allocating.
+  void SetAllocationSamplingInterval(size_t mean_interval);
+
+  AllocationSampler* GetAllocationSampler() const {
+    return allocation_sampler_.get();
+  }
+
   void DisableGCForShutdown() REQUIRES(!*gc_complete_lock_);
 
   // Create a new alloc space and compact default alloc space to it.
@@ -905,6 +969,7 @@ class Heap {
   class ConcurrentGCTask;
   class CollectorTransitionTask;
   class HeapTrimTask;
+  class IdleCompactionTask;
   class TriggerPostForkCCGcTask;
 
   // Compact source space to target space. Returns the collector used.
@@ -914,6 +979,8 @@ class Heap {
       REQUIRES(Locks::mutator_lock_);
 
   void LogGC(GcCause gc_cause, collector::GarbageCollector* collector);
+  // Adds the just completed GC cycle to gc_cycle_records_.
+  void RecordGcCycle(collector::GcType gc_type, collector::GarbageCollector* collector);
   void StartGC(Thread* self, GcCause cause, CollectorType collector_type)
       REQUIRES(!*gc_complete_lock_);
   void FinishGC(Thread* self, collector::GcType gc_type) REQUIRES(!*gc_complete_lock_);
@@ -1034,6 +1101,13 @@ class Heap {
                                    size_t* bytes_tl_bulk_allocated)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Returns the size of the next TLAB for `self`, adapted to how fast the thread filled its
+  // previous TLABs and whether they survived a GC. Starts out with `initial_size`.
+  size_t NextTlabSize(Thread* self, size_t initial_size);
+
+  // Dumps the TLAB refill statistics of all threads.
+  void DumpTlabStats(std::ostream& os) REQUIRES(!Locks::thread_list_lock_);
+
   void ThrowOutOfMemoryError(Thread* self, size_t byte_count, AllocatorType allocator_type)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
@@ -1057,6 +1131,14 @@ class Heap {
   void RequestCollectorTransition(CollectorType desired_collector_type, uint64_t delta_time)
       REQUIRES(!*pending_task_lock_);
 
+  // Schedules a periodic idle compaction check while the process is not jank perceptible.
+  void RequestIdleCompaction(Thread* self, uint64_t delta_time) REQUIRES(!*pending_task_lock_);
+
+  // Compacts the region space with a full GC if enough of its regions are wasted by dead
+  // objects. The freed regions are released to the kernel. Returns false if the checks should
+  // stop, e.g. since the process became jank perceptible.
+  bool DoIdleCompaction() REQUIRES(!*gc_complete_lock_, !*pending_task_lock_);
+
   void RequestConcurrentGCAndSaveObject(Thread* self, bool force_full, ObjPtr<mirror::Object>* obj)
       REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(!*pending_task_lock_);
@@ -1135,6 +1217,7 @@ class Heap {
   void ClearConcurrentGCRequest();
   void ClearPendingTrim(Thread* self) REQUIRES(!*pending_task_lock_);
   void ClearPendingCollectorTransition(Thread* self) REQUIRES(!*pending_task_lock_);
+  void ClearPendingIdleCompaction(Thread* self) REQUIRES(!*pending_task_lock_);
 
   // What kind of concurrency behavior is the runtime after? Currently true for concurrent mark
   // sweep GC, false for other GC types.
@@ -1356,6 +1439,9 @@ class Heap {
   // Allows us to check for GC only roughly every kNotifyNativeInterval allocations.
   Atomic<uint32_t> native_objects_notified_;
 
+  // Total number of objects registered with FinalizerReference.add.
+  Atomic<uint64_t> finalizable_objects_allocated_;
+
   // Number of bytes freed by thread local buffer revokes. This will
   // cancel out the ahead-of-time bulk counting of bytes allocated in
   // rosalloc thread-local buffers.  It is temporarily accumulated
@@ -1366,6 +1452,9 @@ class Heap {
   // Info related to the current or previous GC iteration.
   collector::Iteration current_gc_iteration_;
 
+  // Summaries of the last few GC iterations, for telemetry.
+  GcCycleRecords gc_cycle_records_;
+
   // Heap verification flags.
   const bool verify_missing_card_marks_;
   const bool verify_system_weaks_;
@@ -1451,6 +1540,15 @@ class Heap {
   // How much more we grow the heap when we are a foreground app instead of background.
   double foreground_heap_growth_multiplier_;
 
+  // Fraction of the process CPU time the GC should use, 0 if the heap growth is not adaptive.
+  double gc_cpu_fraction_target_;
+
+  // Factor applied to the free space after a non sticky GC, kept by UpdateHeapGrowthAdjustment.
+  // Only accessed by the thread running the GC.
+  double heap_growth_adjustment_;
+  uint64_t adjustment_last_gc_cpu_time_ns_;
+  uint64_t adjustment_last_process_cpu_time_ns_;
+
   // Total time which mutators are paused or waiting for GC to complete.
   uint64_t total_wait_time_;
 
@@ -1497,6 +1595,7 @@ class Heap {
   // Active tasks which we can modify (change target time, desired collector type, etc..).
   CollectorTransitionTask* pending_collector_transition_ GUARDED_BY(pending_task_lock_);
   HeapTrimTask* pending_heap_trim_ GUARDED_BY(pending_task_lock_);
+  IdleCompactionTask* pending_idle_compaction_ GUARDED_BY(pending_task_lock_);
 
   // Whether or not we use homogeneous space compaction to avoid OOM errors.
   bool use_homogeneous_space_compaction_for_oom_;
@@ -1521,6 +1620,8 @@ class Heap {
   uint64_t last_update_time_gc_count_rate_histograms_;
   // The running count of GC runs in the last window.
   uint64_t gc_count_last_window_;
+  // The number of GCs completed, used to adapt the TLAB sizes.
+  Atomic<uint32_t> gcs_completed_;
   // The running count of blocking GC runs in the last window.
   uint64_t blocking_gc_count_last_window_;
   // The maximum number of buckets in the GC count rate histograms.
@@ -1535,6 +1636,9 @@ class Heap {
   std::unique_ptr<AllocRecordObjectMap> allocation_records_;
   size_t alloc_record_depth_;
 
+  // Sampling allocation profiler, null unless enabled with -XX:AllocationSamplingInterval.
+  std::unique_ptr<AllocationSampler> allocation_sampler_;
+
   // GC stress related data structures.
   Mutex* backtrace_lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
   // Debugging variables, seen backtraces vs unique backtraces.
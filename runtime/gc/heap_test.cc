@@ -99,6 +99,36 @@ TEST_F(HeapTest, DumpGCPerformanceOnShutdown) {
   Runtime::Current()->SetDumpGCPerformanceOnShutdown(true);
 }
 
+TEST_F(HeapTest, GcCycleRecords) {
+  Heap* heap = Runtime::Current()->GetHeap();
+  const uint64_t records_before = heap->GetGcCycleRecords().GetNumRecordsAdded();
+  heap->CollectGarbage(/* clear_soft_references= */ false);
+  EXPECT_EQ(records_before + 1u, heap->GetGcCycleRecords().GetNumRecordsAdded());
+  std::vector<GcCycleRecord> records = heap->GetGcCycleRecords().GetRecords();
+  ASSERT_FALSE(records.empty());
+  const GcCycleRecord& record = records.back();
+  EXPECT_EQ(static_cast<uint64_t>(kGcCauseExplicit), record.gc_cause);
+  EXPECT_NE(0u, record.duration_ns);
+  EXPECT_LE(record.total_pause_ns, record.duration_ns);
+}
+
+TEST_F(HeapTest, GcCycleRecordsWrapAround) {
+  GcCycleRecords ring;
+  EXPECT_TRUE(ring.GetRecords().empty());
+  const size_t num_records = GcCycleRecords::kNumRecords + 10u;
+  for (size_t i = 0; i < num_records; ++i) {
+    GcCycleRecord record = {};
+    record.end_time_ns = i;
+    ring.Add(record);
+  }
+  std::vector<GcCycleRecord> records = ring.GetRecords();
+  ASSERT_EQ(GcCycleRecords::kNumRecords, records.size());
+  // Only the most recent records are kept, oldest first.
+  for (size_t i = 0; i < records.size(); ++i) {
+    EXPECT_EQ(num_records - GcCycleRecords::kNumRecords + i, records[i].end_time_ns);
+  }
+}
+
 class ZygoteHeapTest : public CommonRuntimeTest {
   void SetUpRuntimeOptions(RuntimeOptions* options) override {
     CommonRuntimeTest::SetUpRuntimeOptions(options);
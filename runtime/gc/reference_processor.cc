@@ -47,7 +47,8 @@ ReferenceProcessor::ReferenceProcessor()
       weak_reference_queue_(Locks::reference_queue_weak_references_lock_),
       finalizer_reference_queue_(Locks::reference_queue_finalizer_references_lock_),
       phantom_reference_queue_(Locks::reference_queue_phantom_references_lock_),
-      cleared_references_(Locks::reference_queue_cleared_references_lock_) {
+      cleared_references_(Locks::reference_queue_cleared_references_lock_),
+      finalizers_scheduled_(0u) {
 }
 
 static inline MemberOffset GetSlowPathFlagOffset(ObjPtr<mirror::Class> reference_class)
@@ -192,6 +193,12 @@ void ReferenceProcessor::ProcessReferences(bool concurrent,
   // Clear all remaining soft and weak references with white referents.
   soft_reference_queue_.ClearWhiteReferences(&cleared_references_, collector);
   weak_reference_queue_.ClearWhiteReferences(&cleared_references_, collector);
+  if (concurrent) {
+    // Mutators blocked in GetReferent() on a reference that has just been cleared, or whose
+    // referent has been marked by forwarding the soft references, can return now rather than
+    // wait for the finalizer references to be processed.
+    BroadcastForSlowPath(self);
+  }
   {
     TimingLogger::ScopedTiming t2(concurrent ? "EnqueueFinalizerReferences" :
         "(Paused)EnqueueFinalizerReferences", timings);
@@ -199,7 +206,9 @@ void ReferenceProcessor::ProcessReferences(bool concurrent,
       StartPreservingReferences(self);
     }
     // Preserve all white objects with finalize methods and schedule them for finalization.
-    finalizer_reference_queue_.EnqueueFinalizerReferences(&cleared_references_, collector);
+    size_t num_scheduled =
+        finalizer_reference_queue_.EnqueueFinalizerReferences(&cleared_references_, collector);
+    finalizers_scheduled_.fetch_add(num_scheduled, std::memory_order_relaxed);
     collector->ProcessMarkStack();
     if (concurrent) {
       StopPreservingReferences(self);
@@ -210,6 +219,11 @@ void ReferenceProcessor::ProcessReferences(bool concurrent,
   weak_reference_queue_.ClearWhiteReferences(&cleared_references_, collector);
   // Clear all phantom references with white referents.
   phantom_reference_queue_.ClearWhiteReferences(&cleared_references_, collector);
+  if (concurrent && kUseReadBarrier) {
+    // With the read barrier, weak reference access is only re-enabled after the system weaks have
+    // been swept. Let the mutators blocked on references resolved by now go ahead already.
+    BroadcastForSlowPath(self);
+  }
   // At this point all reference queues other than the cleared references should be empty.
   DCHECK(soft_reference_queue_.IsEmpty());
   DCHECK(weak_reference_queue_.IsEmpty());
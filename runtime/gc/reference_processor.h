@@ -17,6 +17,7 @@
 #ifndef ART_RUNTIME_GC_REFERENCE_PROCESSOR_H_
 #define ART_RUNTIME_GC_REFERENCE_PROCESSOR_H_
 
+#include "base/atomic.h"
 #include "base/locks.h"
 #include "jni.h"
 #include "reference_queue.h"
@@ -78,6 +79,11 @@ class ReferenceProcessor {
   void ClearReferent(ObjPtr<mirror::Reference> ref)
       REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(!Locks::reference_processor_lock_);
+  // Returns the number of objects whose finalizers were scheduled to run since the runtime
+  // started.
+  uint64_t GetFinalizersScheduled() const {
+    return finalizers_scheduled_.load(std::memory_order_relaxed);
+  }
 
  private:
   bool SlowPathEnabled() REQUIRES_SHARED(Locks::mutator_lock_);
@@ -108,6 +114,8 @@ class ReferenceProcessor {
   ReferenceQueue finalizer_reference_queue_;
   ReferenceQueue phantom_reference_queue_;
   ReferenceQueue cleared_references_;
+  // Only written by the GC, during reference processing.
+  Atomic<uint64_t> finalizers_scheduled_;
 
   DISALLOW_COPY_AND_ASSIGN(ReferenceProcessor);
 };
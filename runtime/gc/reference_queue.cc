@@ -152,8 +152,9 @@ void ReferenceQueue::ClearWhiteReferences(ReferenceQueue* cleared_references,
   }
 }
 
-void ReferenceQueue::EnqueueFinalizerReferences(ReferenceQueue* cleared_references,
-                                                collector::GarbageCollector* collector) {
+size_t ReferenceQueue::EnqueueFinalizerReferences(ReferenceQueue* cleared_references,
+                                                  collector::GarbageCollector* collector) {
+  size_t num_enqueued = 0u;
   while (!IsEmpty()) {
     ObjPtr<mirror::FinalizerReference> ref = DequeuePendingReference()->AsFinalizerReference();
     mirror::HeapReference<mirror::Object>* referent_addr = ref->GetReferentReferenceAddr();
@@ -170,11 +171,13 @@ void ReferenceQueue::EnqueueFinalizerReferences(ReferenceQueue* cleared_referenc
         ref->ClearReferent<false>();
       }
       cleared_references->EnqueueReference(ref);
+      ++num_enqueued;
     }
     // Delay disabling the read barrier until here so that the ClearReferent call above in
     // transaction mode will trigger the read barrier.
     DisableReadBarrierForReference(ref->AsReference());
   }
+  return num_enqueued;
 }
 
 void ReferenceQueue::ForwardSoftReferences(MarkObjectVisitor* visitor) {
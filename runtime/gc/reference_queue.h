@@ -78,8 +78,9 @@ class ReferenceQueue {
       REQUIRES_SHARED(Locks::mutator_lock_);
 
   // Enqueues finalizer references with white referents.  White referents are blackened, moved to
-  // the zombie field, and the referent field is cleared.
-  void EnqueueFinalizerReferences(ReferenceQueue* cleared_references,
+  // the zombie field, and the referent field is cleared. Returns the number of references
+  // enqueued.
+  size_t EnqueueFinalizerReferences(ReferenceQueue* cleared_references,
                                   collector::GarbageCollector* collector)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
@@ -37,6 +37,7 @@ BumpPointerSpace* BumpPointerSpace::Create(const std::string& name, size_t capac
         << PrettySize(capacity) << " with message " << error_msg;
     return nullptr;
   }
+  mem_map.SetNativeMemoryTag(NativeMemoryTag::kJavaHeap);
   return new BumpPointerSpace(name, std::move(mem_map));
 }
 
@@ -1209,6 +1209,57 @@ class ImageSpace::Loader {
     PatchObjectVisitor<kPointerSize, ForwardObject, ForwardCode> patch_object_visitor(
         forward_object,
         forward_metadata);
+    // The native metadata only references objects through pointers that are forwarded without
+    // being read, so it does not depend on the object fixup below. Relocate it on a worker of the
+    // startup thread pool while this thread fixes up the objects.
+    auto fixup_metadata = [&](TimingLogger* metadata_logger) NO_THREAD_SAFETY_ANALYSIS {
+      {
+        // Only touches objects in the app image, no need for mutator lock.
+        TimingLogger::ScopedTiming timing("Fixup methods", metadata_logger);
+        image_header.VisitPackedArtMethods([&](ArtMethod& method) NO_THREAD_SAFETY_ANALYSIS {
+          // TODO: Consider a separate visitor for runtime vs normal methods.
+          if (UNLIKELY(method.IsRuntimeMethod())) {
+            ImtConflictTable* table = method.GetImtConflictTable(kPointerSize);
+            if (table != nullptr) {
+              ImtConflictTable* new_table = forward_metadata(table);
+              if (table != new_table) {
+                method.SetImtConflictTable(new_table, kPointerSize);
+              }
+            }
+            const void* old_code = method.GetEntryPointFromQuickCompiledCodePtrSize(kPointerSize);
+            const void* new_code = forward_code(old_code);
+            if (old_code != new_code) {
+              method.SetEntryPointFromQuickCompiledCodePtrSize(new_code, kPointerSize);
+            }
+          } else {
+            method.UpdateObjectsForImageRelocation(forward_object);
+            method.UpdateEntrypoints(forward_code, kPointerSize);
+          }
+        }, target_base, kPointerSize);
+      }
+      {
+        // Only touches objects in the app image, no need for mutator lock.
+        TimingLogger::ScopedTiming timing("Fixup fields", metadata_logger);
+        image_header.VisitPackedArtFields([&](ArtField& field) NO_THREAD_SAFETY_ANALYSIS {
+          field.UpdateObjects(forward_object);
+        }, target_base);
+      }
+      {
+        TimingLogger::ScopedTiming timing("Fixup imt", metadata_logger);
+        image_header.VisitPackedImTables(forward_metadata, target_base, kPointerSize);
+      }
+      {
+        TimingLogger::ScopedTiming timing("Fixup conflict tables", metadata_logger);
+        image_header.VisitPackedImtConflictTables(forward_metadata, target_base, kPointerSize);
+      }
+    };
+    Runtime::ScopedThreadPoolUsage stpu;
+    ThreadPool* const pool = stpu.GetThreadPool();
+    Thread* const self = Thread::Current();
+    TimingLogger metadata_logger("RelocateInPlace metadata", true, false);
+    if (pool != nullptr) {
+      pool->AddTask(self, new FunctionTask([&](Thread*) { fixup_metadata(&metadata_logger); }));
+    }
     if (fixup_image) {
       // Two pass approach, fix up all classes first, then fix up non class-objects.
       // The visited bitmap is used to ensure that pointer arrays are not forwarded twice.
@@ -1290,46 +1341,16 @@ class ImageSpace::Loader {
         patch_object_visitor.VisitDexCacheArrays(dex_cache);
       }
     }
-    {
-      // Only touches objects in the app image, no need for mutator lock.
-      TimingLogger::ScopedTiming timing("Fixup methods", &logger);
-      image_header.VisitPackedArtMethods([&](ArtMethod& method) NO_THREAD_SAFETY_ANALYSIS {
-        // TODO: Consider a separate visitor for runtime vs normal methods.
-        if (UNLIKELY(method.IsRuntimeMethod())) {
-          ImtConflictTable* table = method.GetImtConflictTable(kPointerSize);
-          if (table != nullptr) {
-            ImtConflictTable* new_table = forward_metadata(table);
-            if (table != new_table) {
-              method.SetImtConflictTable(new_table, kPointerSize);
-            }
-          }
-          const void* old_code = method.GetEntryPointFromQuickCompiledCodePtrSize(kPointerSize);
-          const void* new_code = forward_code(old_code);
-          if (old_code != new_code) {
-            method.SetEntryPointFromQuickCompiledCodePtrSize(new_code, kPointerSize);
-          }
-        } else {
-          method.UpdateObjectsForImageRelocation(forward_object);
-          method.UpdateEntrypoints(forward_code, kPointerSize);
-        }
-      }, target_base, kPointerSize);
+    if (pool != nullptr) {
+      ScopedTrace trace("Waiting for workers");
+      pool->Wait(self, /*do_work=*/ true, /*may_hold_locks=*/ false);
+      if (VLOG_IS_ON(image)) {
+        metadata_logger.Dump(LOG_STREAM(INFO));
+      }
+    } else {
+      fixup_metadata(&logger);
     }
     if (fixup_image) {
-      {
-        // Only touches objects in the app image, no need for mutator lock.
-        TimingLogger::ScopedTiming timing("Fixup fields", &logger);
-        image_header.VisitPackedArtFields([&](ArtField& field) NO_THREAD_SAFETY_ANALYSIS {
-          field.UpdateObjects(forward_object);
-        }, target_base);
-      }
-      {
-        TimingLogger::ScopedTiming timing("Fixup imt", &logger);
-        image_header.VisitPackedImTables(forward_metadata, target_base, kPointerSize);
-      }
-      {
-        TimingLogger::ScopedTiming timing("Fixup conflict tables", &logger);
-        image_header.VisitPackedImtConflictTables(forward_metadata, target_base, kPointerSize);
-      }
       // In the app image case, the image methods are actually in the boot image.
       image_header.RelocateImageMethods(boot_image.Delta());
       // Fix up the intern table.
@@ -1509,7 +1530,10 @@ class ImageSpace::BootImageLoader {
     std::vector<std::unique_ptr<ImageSpace>> spaces;
     spaces.reserve(locations.size());
     for (std::size_t i = 0u, size = locations.size(); i != size; ++i) {
+      const uint64_t start_time = NanoTime();
       spaces.push_back(Load(locations[i], filenames[i], logger, &image_reservation, error_msg));
+      VLOG(startup) << "Loaded boot image component " << locations[i] << " in "
+                    << PrettyDuration(NanoTime() - start_time);
       const ImageSpace* space = spaces.back().get();
       if (space == nullptr) {
         return false;
@@ -1684,8 +1708,11 @@ class ImageSpace::BootImageLoader {
       constructor_class = GetClassRoot<mirror::Constructor, kWithoutReadBarrier>(class_roots);
     }
 
-    for (size_t s = 0u, size = spaces.size(); s != size; ++s) {
-      const ImageSpace* space = spaces[s].get();
+    // The remaining objects of each space only refer to their own native data, so the spaces
+    // are patched in parallel. `patched_objects` is only read from here on.
+    auto relocate_space_objects = [&](const ImageSpace* space)
+        REQUIRES_SHARED(Locks::mutator_lock_) {
+      const uint64_t start_time = NanoTime();
       const ImageHeader& image_header = space->GetImageHeader();
 
       static_assert(IsAligned<kObjectAlignment>(sizeof(ImageHeader)), "Header alignment check");
@@ -1715,6 +1742,28 @@ class ImageSpace::BootImageLoader {
         }
         pos += RoundUp(object->SizeOf<kVerifyNone>(), kObjectAlignment);
       }
+      VLOG(startup) << "Relocated objects of " << space->GetImageLocation() << " in "
+                    << PrettyDuration(NanoTime() - start_time);
+    };
+    Runtime::ScopedThreadPoolUsage stpu;
+    ThreadPool* const pool = stpu.GetThreadPool();
+    Thread* const self = Thread::Current();
+    if (pool != nullptr && spaces.size() > 1u) {
+      for (size_t s = 1u, size = spaces.size(); s != size; ++s) {
+        const ImageSpace* space = spaces[s].get();
+        pool->AddTask(self, new FunctionTask([space, &relocate_space_objects](Thread* worker) {
+          ScopedObjectAccess soa(worker);
+          relocate_space_objects(space);
+        }));
+      }
+      // The primary component is usually the largest one, patch it on this thread.
+      relocate_space_objects(spaces.front().get());
+      ScopedTrace trace("Waiting for workers");
+      pool->Wait(self, /*do_work=*/ true, /*may_hold_locks=*/ true);
+    } else {
+      for (const std::unique_ptr<ImageSpace>& space : spaces) {
+        relocate_space_objects(space.get());
+      }
     }
   }
 
@@ -2380,10 +2429,15 @@ void ImageSpace::DisablePreResolvedStrings() {
   // Clear dex cache pointers.
   ObjPtr<mirror::ObjectArray<mirror::DexCache>> dex_caches =
       GetImageHeader().GetImageRoot(ImageHeader::kDexCaches)->AsObjectArray<mirror::DexCache>();
+  size_t num_copied = 0u;
   for (size_t len = dex_caches->GetLength(), i = 0; i < len; ++i) {
     ObjPtr<mirror::DexCache> dex_cache = dex_caches->Get(i);
+    // Keep what we can of the startup strings so that their first use after startup does not
+    // go through the slow path.
+    num_copied += dex_cache->CopyPreResolvedStringsToStringCache();
     dex_cache->ClearPreResolvedStrings();
   }
+  VLOG(image) << "Copied " << num_copied << " preresolved strings to dex cache string arrays";
 }
 
 void ImageSpace::ReleaseMetadata() {
@@ -145,6 +145,7 @@ mirror::Object* LargeObjectMapSpace::Alloc(Thread* self, size_t num_bytes,
     LOG(WARNING) << "Large object allocation failed: " << error_msg;
     return nullptr;
   }
+  mem_map.SetNativeMemoryTag(NativeMemoryTag::kJavaHeap);
   mirror::Object* const obj = reinterpret_cast<mirror::Object*>(mem_map.Begin());
   const size_t allocation_size = mem_map.BaseSize();
   MutexLock mu(self, lock_);
@@ -361,6 +362,7 @@ FreeListSpace* FreeListSpace::Create(const std::string& name, size_t size) {
                                         /*low_4gb=*/ true,
                                         &error_msg);
   CHECK(mem_map.IsValid()) << "Failed to allocate large object space mem map: " << error_msg;
+  mem_map.SetNativeMemoryTag(NativeMemoryTag::kJavaHeap);
   return new FreeListSpace(name, std::move(mem_map), mem_map.Begin(), mem_map.End());
 }
 
@@ -382,6 +384,7 @@ FreeListSpace::FreeListSpace(const std::string& name,
                            /*low_4gb=*/ false,
                            &error_msg);
   CHECK(allocation_info_map_.IsValid()) << "Failed to allocate allocation info map" << error_msg;
+  allocation_info_map_.SetNativeMemoryTag(NativeMemoryTag::kGcAccounting);
   allocation_info_ = reinterpret_cast<AllocationInfo*>(allocation_info_map_.Begin());
 }
 
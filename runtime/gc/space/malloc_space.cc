@@ -115,6 +115,8 @@ MemMap MallocSpace::CreateMemMap(const std::string& name,
   if (!mem_map.IsValid()) {
     LOG(ERROR) << "Failed to allocate pages for alloc space (" << name << ") of size "
                << PrettySize(*capacity) << ": " << error_msg;
+  } else {
+    mem_map.SetNativeMemoryTag(NativeMemoryTag::kJavaHeap);
   }
   return mem_map;
 }
@@ -259,7 +261,8 @@ void MallocSpace::SweepCallback(size_t num_ptrs, mirror::Object** ptrs, void* ar
   SweepCallbackContext* context = static_cast<SweepCallbackContext*>(arg);
   space::MallocSpace* space = context->space->AsMallocSpace();
   Thread* self = context->self;
-  Locks::heap_bitmap_lock_->AssertExclusiveHeld(self);
+  // The GC thread holds the heap bitmap lock, but a parallel sweep runs this on its workers.
+  DCHECK_GT(Locks::heap_bitmap_lock_->GetExclusiveOwnerTid(), 0);
   // If the bitmaps aren't swapped we need to clear the bits since the GC isn't going to re-swap
   // the bitmaps as an optimization.
   if (!context->swap_bitmaps) {
@@ -227,6 +227,24 @@ inline void RegionSpace::ScanUnevacFromSpace(accounting::ContinuousSpaceBitmap*
   }
 }
 
+template <typename Visitor>
+inline void RegionSpace::ScanFromSpaceRegions(accounting::ContinuousSpaceBitmap* bitmap,
+                                              Atomic<size_t>* next_region,
+                                              Visitor&& visitor) {
+  const size_t iter_limit = kUseTableLookupReadBarrier
+      ? num_regions_ : std::min(num_regions_, non_free_region_index_limit_);
+  size_t i;
+  while ((i = next_region->fetch_add(1, std::memory_order_relaxed)) < iter_limit) {
+    Region* r = &regions_[i];
+    // Large objects are not copied by evacuation; skip their regions.
+    if (r->IsInFromSpace() && !r->IsLarge() && !r->IsLargeTail()) {
+      bitmap->VisitMarkedRange(reinterpret_cast<uintptr_t>(r->Begin()),
+                               reinterpret_cast<uintptr_t>(r->Top()),
+                               visitor);
+    }
+  }
+}
+
 template<bool kToSpaceOnly, typename Visitor>
 inline void RegionSpace::WalkInternal(Visitor&& visitor) {
   // TODO: MutexLock on region_lock_ won't work due to lock order
@@ -379,6 +397,10 @@ inline mirror::Object* RegionSpace::AllocLarge(size_t num_bytes,
       return region;
     }
   }
+  if (!kForEvac && kCompactFragmentedLargeRegions) {
+    // There are enough free regions, they are just not contiguous.
+    compact_large_regions_ = true;
+  }
   return nullptr;
 }
 
@@ -77,6 +77,7 @@ MemMap RegionSpace::CreateMemMap(const std::string& name,
     MemMap::DumpMaps(LOG_STREAM(ERROR));
     return MemMap::Invalid();
   }
+  mem_map.SetNativeMemoryTag(NativeMemoryTag::kJavaHeap);
   CHECK_EQ(mem_map.Size(), capacity + kRegionSize);
   CHECK_EQ(mem_map.Begin(), mem_map.BaseBegin());
   CHECK_EQ(mem_map.Size(), mem_map.BaseSize());
@@ -91,6 +92,7 @@ MemMap RegionSpace::CreateMemMap(const std::string& name,
   CHECK_ALIGNED(mem_map.Begin(), kRegionSize);
   CHECK_ALIGNED(mem_map.End(), kRegionSize);
   CHECK_EQ(mem_map.Size(), capacity);
+  mem_map.MadviseHugePages();
   return mem_map;
 }
 
@@ -116,7 +118,8 @@ RegionSpace::RegionSpace(const std::string& name, MemMap&& mem_map, bool use_gen
       non_free_region_index_limit_(0U),
       current_region_(&full_region_),
       evac_region_(nullptr),
-      cyclic_alloc_region_index_(0U) {
+      cyclic_alloc_region_index_(0U),
+      compact_large_regions_(false) {
   CHECK_ALIGNED(mem_map_.Size(), kRegionSize);
   CHECK_ALIGNED(mem_map_.Begin(), kRegionSize);
   DCHECK_GT(num_regions_, 0U);
@@ -189,8 +192,8 @@ void RegionSpace::Region::SetAsUnevacFromSpace(bool clear_live_bytes) {
   type_ = RegionType::kRegionTypeUnevacFromSpace;
   if (IsNewlyAllocated()) {
     // A newly allocated region set as unevac from-space must be
-    // a large or large tail region.
-    DCHECK(IsLarge() || IsLargeTail()) << static_cast<uint>(state_);
+    // a large or large tail region, or a pinned region.
+    DCHECK(IsLarge() || IsLargeTail() || IsPinned()) << static_cast<uint>(state_);
     // Always clear the live bytes of a newly allocated (large or
     // large tail) region.
     clear_live_bytes = true;
@@ -225,6 +228,10 @@ inline bool RegionSpace::Region::ShouldBeEvacuated(EvacMode evac_mode) {
   // - the evacuation is forced (`evac_mode == kEvacModeForceAll`); or
   // - the region was allocated after the start of the previous GC (newly allocated region); or
   // - the live ratio is below threshold (`kEvacuateLivePercentThreshold`).
+  // Objects in pinned regions must not move, not even when the evacuation is forced.
+  if (UNLIKELY(IsPinned())) {
+    return false;
+  }
   if (UNLIKELY(evac_mode == kEvacModeForceAll)) {
     return true;
   }
@@ -346,6 +353,13 @@ void RegionSpace::SetFromSpace(accounting::ReadBarrierTable* rb_table,
   // Flag to store whether the previously seen large region has been evacuated.
   // This is used to apply the same evacuation policy to related large tail regions.
   bool prev_large_evacuated = false;
+  // Compact the large regions if an allocation failed due to fragmentation. Only do this during
+  // full-heap collections, sticky-bit collections must not move the old large objects.
+  const bool compact_large_regions =
+      compact_large_regions_ && evac_mode == kEvacModeLivePercentNewlyAllocated;
+  if (compact_large_regions) {
+    compact_large_regions_ = false;
+  }
   VerifyNonFreeRegionLimit();
   const size_t iter_limit = kUseTableLookupReadBarrier
       ? num_regions_
@@ -362,6 +376,21 @@ void RegionSpace::SetFromSpace(accounting::ReadBarrierTable* rb_table,
                type == RegionType::kRegionTypeToSpace);
         bool should_evacuate = r->ShouldBeEvacuated(evac_mode);
         bool is_newly_allocated = r->IsNewlyAllocated();
+        if (compact_large_regions && r->IsLarge() && !is_newly_allocated) {
+          should_evacuate = true;
+        }
+        if (r->IsPinned()) {
+          should_evacuate = false;
+          // As for the newly allocated large regions below, objects marked before this call in a
+          // 2-phase full heap GC would not be counted in the live bytes. Clear their marks so
+          // that the live bytes are recomputed when the objects are marked again.
+          if (use_generational_cc_ &&
+              is_newly_allocated &&
+              state == RegionState::kRegionStateAllocated) {
+            GetMarkBitmap()->ClearRange(reinterpret_cast<mirror::Object*>(r->Begin()),
+                                        reinterpret_cast<mirror::Object*>(r->Top()));
+          }
+        }
         if (should_evacuate) {
           r->SetAsFromSpace();
           DCHECK(r->IsInFromSpace());
@@ -727,35 +756,44 @@ void RegionSpace::LogFragmentationAllocFailure(std::ostream& os,
     // We reserve half of the regions for evaluation only. If we
     // occupy more than half the regions, do not report the free
     // regions as available.
-    size_t max_contiguous_free_regions = 0;
-    size_t num_contiguous_free_regions = 0;
-    bool prev_free_region = false;
-    for (size_t i = 0; i < num_regions_; ++i) {
-      Region* r = &regions_[i];
-      if (r->IsFree()) {
-        if (!prev_free_region) {
-          CHECK_EQ(num_contiguous_free_regions, 0U);
-          prev_free_region = true;
-        }
-        ++num_contiguous_free_regions;
-      } else {
-        if (prev_free_region) {
-          CHECK_NE(num_contiguous_free_regions, 0U);
-          max_contiguous_free_regions = std::max(max_contiguous_free_regions,
-                                                 num_contiguous_free_regions);
-          num_contiguous_free_regions = 0U;
-          prev_free_region = false;
-        }
-      }
-    }
     max_contiguous_allocation = std::max(max_contiguous_allocation,
-                                         max_contiguous_free_regions * kRegionSize);
+                                         MaxContiguousFreeRegionsLocked() * kRegionSize);
   }
   os << "; failed due to fragmentation (largest possible contiguous allocation "
      <<  max_contiguous_allocation << " bytes)";
   // Caller's job to print failed_alloc_bytes.
 }
 
+size_t RegionSpace::MaxContiguousFreeRegionsLocked() {
+  size_t max_contiguous_free_regions = 0;
+  size_t num_contiguous_free_regions = 0;
+  for (size_t i = 0; i < num_regions_; ++i) {
+    Region* r = &regions_[i];
+    if (r->IsFree()) {
+      ++num_contiguous_free_regions;
+      max_contiguous_free_regions = std::max(max_contiguous_free_regions,
+                                             num_contiguous_free_regions);
+    } else {
+      num_contiguous_free_regions = 0U;
+    }
+  }
+  return max_contiguous_free_regions;
+}
+
+void RegionSpace::DumpFragmentation(std::ostream& os) {
+  MutexLock mu(Thread::Current(), region_lock_);
+  const size_t num_free_regions = num_regions_ - num_non_free_regions_;
+  if (num_free_regions == 0u) {
+    return;
+  }
+  const size_t max_contiguous_free_regions = MaxContiguousFreeRegionsLocked();
+  os << GetName() << " free regions " << num_free_regions
+     << ", largest free run " << max_contiguous_free_regions
+     << " (" << PrettySize(max_contiguous_free_regions * kRegionSize) << ")"
+     << ", fragmentation "
+     << (100u - max_contiguous_free_regions * 100u / num_free_regions) << "%\n";
+}
+
 void RegionSpace::Clear() {
   MutexLock mu(Thread::Current(), region_lock_);
   for (size_t i = 0; i < num_regions_; ++i) {
@@ -1001,6 +1039,7 @@ size_t RegionSpace::AllocationSizeNonvirtual(mirror::Object* obj, size_t* usable
 }
 
 void RegionSpace::Region::Clear(bool zero_and_release_pages) {
+  DCHECK(!IsPinned());
   top_.store(begin_, std::memory_order_relaxed);
   state_ = RegionState::kRegionStateFree;
   type_ = RegionType::kRegionTypeNone;
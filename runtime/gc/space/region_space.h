@@ -43,6 +43,12 @@ namespace space {
 // only enable it in debug mode.
 static constexpr bool kCyclicRegionAllocation = kIsDebugBuild;
 
+// Large region compaction. If `true`, a failure to find contiguous free
+// regions for a large object while enough free regions remain makes the
+// next full-heap collection evacuate the live large regions, so that
+// the free regions left behind by them can be coalesced.
+static constexpr bool kCompactFragmentedLargeRegions = true;
+
 // A space that consists of equal-sized regions.
 class RegionSpace final : public ContinuousMemMapAllocSpace {
  public:
@@ -142,6 +148,9 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
   // Dump region containing object `obj`. Precondition: `obj` is in the region space.
   void DumpRegionForObject(std::ostream& os, mirror::Object* obj) REQUIRES(!region_lock_);
   void DumpNonFreeRegions(std::ostream& os) REQUIRES(!region_lock_);
+  // Dump the fragmentation of the free regions, i.e. how much of the free
+  // space cannot be used for the largest possible large object.
+  void DumpFragmentation(std::ostream& os) REQUIRES(!region_lock_);
 
   size_t RevokeThreadLocalBuffers(Thread* thread) override REQUIRES(!region_lock_);
   size_t RevokeThreadLocalBuffers(Thread* thread, const bool reuse) REQUIRES(!region_lock_);
@@ -224,6 +233,15 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
   ALWAYS_INLINE void ScanUnevacFromSpace(accounting::ContinuousSpaceBitmap* bitmap,
                                          Visitor&& visitor) NO_THREAD_SAFETY_ANALYSIS;
 
+  // Calls visitor for the objects in (non-large) from-space regions corresponding to the bits
+  // set in 'bitmap'. Regions are claimed one at a time through 'next_region', so several threads
+  // sharing the same counter evacuate disjoint sets of regions.
+  // Same restrictions as ScanUnevacFromSpace().
+  template <typename Visitor>
+  ALWAYS_INLINE void ScanFromSpaceRegions(accounting::ContinuousSpaceBitmap* bitmap,
+                                          Atomic<size_t>* next_region,
+                                          Visitor&& visitor) NO_THREAD_SAFETY_ANALYSIS;
+
   accounting::ContinuousSpaceBitmap::SweepCallback* GetSweepCallback() override {
     return nullptr;
   }
@@ -235,6 +253,17 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
   // The region size.
   static constexpr size_t kRegionSize = 256 * KB;
 
+  // Keeps the region holding `ref` from being evacuated until the matching UnpinRegionOf, so
+  // that `ref` does not move. Can be called concurrently with the GC, but only takes effect for
+  // the evacuation decisions made by later calls to SetFromSpace.
+  void PinRegionOf(mirror::Object* ref) {
+    RefToRegionUnlocked(ref)->Pin();
+  }
+
+  void UnpinRegionOf(mirror::Object* ref) {
+    RefToRegionUnlocked(ref)->Unpin();
+  }
+
   bool IsInFromSpace(mirror::Object* ref) {
     if (HasAddress(ref)) {
       Region* r = RefToRegionUnlocked(ref);
@@ -321,6 +350,12 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
     reg->AddLiveBytes(alloc_size);
   }
 
+  // Same as AddLiveBytes, for when several GC threads may add live bytes to the same region.
+  void AtomicAddLiveBytes(mirror::Object* ref, size_t alloc_size) {
+    Region* reg = RefToRegionUnlocked(ref);
+    reg->AtomicAddLiveBytes(alloc_size);
+  }
+
   void AssertAllRegionLiveBytesZeroOrCleared() REQUIRES(!region_lock_) {
     if (kIsDebugBuild) {
       MutexLock mu(Thread::Current(), region_lock_);
@@ -390,6 +425,7 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
           end_(nullptr),
           objects_allocated_(0),
           alloc_time_(0),
+          pin_count_(0u),
           is_newly_allocated_(false),
           is_a_tlab_(false),
           state_(RegionState::kRegionStateAllocated),
@@ -405,6 +441,7 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
       objects_allocated_.store(0, std::memory_order_relaxed);
       alloc_time_ = 0;
       live_bytes_ = static_cast<size_t>(-1);
+      pin_count_.store(0u, std::memory_order_relaxed);
       is_newly_allocated_ = false;
       is_a_tlab_ = false;
       thread_ = nullptr;
@@ -491,6 +528,20 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
       return is_newly_allocated_;
     }
 
+    // Pinned regions are never evacuated, see RegionSpace::PinRegionOf.
+    bool IsPinned() const {
+      return pin_count_.load(std::memory_order_relaxed) != 0u;
+    }
+
+    void Pin() {
+      pin_count_.fetch_add(1u, std::memory_order_relaxed);
+    }
+
+    void Unpin() {
+      uint32_t old_pin_count = pin_count_.fetch_sub(1u, std::memory_order_relaxed);
+      DCHECK_NE(old_pin_count, 0u);
+    }
+
     bool IsTlab() const {
       return is_a_tlab_;
     }
@@ -557,6 +608,15 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
       DCHECK_LE(live_bytes_, BytesAllocated());
     }
 
+    void AtomicAddLiveBytes(size_t live_bytes) {
+      DCHECK(GetUseGenerationalCC() || IsInUnevacFromSpace());
+      DCHECK(!IsLargeTail());
+      DCHECK_NE(live_bytes_, static_cast<size_t>(-1));
+      // For large allocations, we always consider all bytes in the regions live.
+      size_t delta = IsLarge() ? Top() - begin_ : live_bytes;
+      reinterpret_cast<Atomic<size_t>*>(&live_bytes_)->fetch_add(delta, std::memory_order_relaxed);
+    }
+
     bool AllAllocatedBytesAreLive() const {
       return LiveBytes() == static_cast<size_t>(Top() - Begin());
     }
@@ -618,6 +678,9 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
     // are concurrent updates.
     Atomic<size_t> objects_allocated_;  // The number of objects allocated.
     uint32_t alloc_time_;               // The allocation time of the region.
+    // Number of outstanding pins, e.g. from GetPrimitiveArrayCritical. Only changed by runnable
+    // threads, so SetFromSpace, which runs in a pause, sees a stable value.
+    Atomic<uint32_t> pin_count_;
     // Note that newly allocated and evacuated regions use -1 as
     // special value for `live_bytes_`.
     bool is_newly_allocated_;           // True if it's allocated after the last collection.
@@ -697,6 +760,9 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
   }
 
   Region* AllocateRegion(bool for_evac) REQUIRES(region_lock_);
+
+  // Returns the length of the longest run of free regions.
+  size_t MaxContiguousFreeRegionsLocked() REQUIRES(region_lock_);
   void RevokeThreadLocalBuffersLocked(Thread* thread, bool reuse) REQUIRES(region_lock_);
 
   // Scan region range [`begin`, `end`) in increasing order to try to
@@ -765,6 +831,10 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
   // `kCyclicRegionAllocation` is true.
   size_t cyclic_alloc_region_index_ GUARDED_BY(region_lock_);
 
+  // Whether the next full-heap collection should evacuate the large regions,
+  // see `kCompactFragmentedLargeRegions`.
+  bool compact_large_regions_ GUARDED_BY(region_lock_);
+
   // Mark bitmap used by the GC.
   std::unique_ptr<accounting::ContinuousSpaceBitmap> mark_bitmap_;
 
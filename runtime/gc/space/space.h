@@ -448,6 +448,10 @@ class ContinuousMemMapAllocSpace : public MemMapSpace, public AllocSpace {
   }
 
   collector::ObjectBytePair Sweep(bool swap_bitmaps);
+  // Sweeps the part [sweep_begin, sweep_end) of the space. Ranges aligned to kPageSize cover whole
+  // bitmap words, so disjoint ranges of spaces with a thread safe FreeList, e.g. RosAlloc spaces,
+  // can be swept in parallel.
+  collector::ObjectBytePair SweepRange(bool swap_bitmaps, uint8_t* sweep_begin, uint8_t* sweep_end);
   virtual accounting::ContinuousSpaceBitmap::SweepCallback* GetSweepCallback() = 0;
 
  protected:
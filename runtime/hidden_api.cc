@@ -20,6 +20,7 @@
 
 #include "art_field-inl.h"
 #include "art_method-inl.h"
+#include "base/atomic.h"
 #include "base/dumpable.h"
 #include "base/file_utils.h"
 #include "class_root.h"
@@ -42,6 +43,10 @@ namespace hiddenapi {
 // list.
 static constexpr bool kLogAllAccesses = false;
 
+static Atomic<uint64_t> gSlowPathChecks(0u);
+static Atomic<uint64_t> gDeniedAccesses(0u);
+static Atomic<uint64_t> gCorePlatformApiViolations(0u);
+
 static inline std::ostream& operator<<(std::ostream& os, AccessMethod value) {
   switch (value) {
     case AccessMethod::kNone:
@@ -112,6 +117,13 @@ void InitializeDexFileDomain(const DexFile& dex_file, ObjPtr<mirror::ClassLoader
   }
 }
 
+void DumpForSigQuit(std::ostream& os) {
+  os << "Hidden API slow path checks: " << gSlowPathChecks.load(std::memory_order_relaxed)
+     << ", denied: " << gDeniedAccesses.load(std::memory_order_relaxed)
+     << ", core platform API violations: "
+     << gCorePlatformApiViolations.load(std::memory_order_relaxed) << "\n";
+}
+
 namespace detail {
 
 // Do not change the values of items in this enum, as they are written to the
@@ -414,6 +426,7 @@ bool HandleCorePlatformApiViolation(T* member,
   DCHECK(policy != EnforcementPolicy::kDisabled)
       << "Should never enter this function when access checks are completely disabled";
 
+  gCorePlatformApiViolations.fetch_add(1u, std::memory_order_relaxed);
   if (access_method != AccessMethod::kNone) {
     LOG(WARNING) << "Core platform API violation: "
         << Dumpable<MemberSignature>(MemberSignature(member))
@@ -443,6 +456,10 @@ bool ShouldDenyAccessToMemberImpl(T* member, ApiList api_list, AccessMethod acce
       (policy == EnforcementPolicy::kEnabled) &&
       IsSdkVersionSetAndMoreThan(runtime->GetTargetSdkVersion(),
                                  api_list.GetMaxAllowedSdkVersion());
+  gSlowPathChecks.fetch_add(1u, std::memory_order_relaxed);
+  if (deny_access) {
+    gDeniedAccesses.fetch_add(1u, std::memory_order_relaxed);
+  }
 
   MemberSignature member_signature(member);
 
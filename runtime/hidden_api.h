@@ -380,6 +380,12 @@ ALWAYS_INLINE inline uint32_t GetRuntimeFlags(ArtMethod* method)
 // location and class loader.
 void InitializeDexFileDomain(const DexFile& dex_file, ObjPtr<mirror::ClassLoader> class_loader);
 
+// Dumps how many checks could not be answered from the access flags of the member and had to
+// decode the hiddenapi flags from the dex file, and how many of them denied access. Allowed
+// members are marked public API after the first such check, denied ones are not, so repeated
+// denied lookups show up here.
+void DumpForSigQuit(std::ostream& os);
+
 // Returns true if access to `member` should be denied in the given context.
 // The decision is based on whether the caller is in a trusted context or not.
 // Because determining the access context can be expensive, a lambda function
@@ -30,6 +30,7 @@
 #include <string.h>
 #include <sys/time.h>
 #include <sys/uio.h>
+#include <sys/wait.h>
 #include <time.h>
 #include <unistd.h>
 
@@ -442,7 +443,8 @@ class Hprof : public SingleRootVisitor {
     LOG(INFO) << "hprof: heap dump \"" << filename_ << "\" starting...";
   }
 
-  void Dump()
+  // Returns whether the dump was written successfully.
+  bool Dump()
     REQUIRES(Locks::mutator_lock_)
     REQUIRES(!Locks::heap_bitmap_lock_, !Locks::alloc_tracker_lock_) {
     {
@@ -483,6 +485,7 @@ class Hprof : public SingleRootVisitor {
                 << " objects " << total_objects_
                 << " objects with stack traces " << total_objects_with_stack_trace_;
     }
+    return okay;
   }
 
  private:
@@ -1599,9 +1602,57 @@ void Hprof::VisitRoot(mirror::Object* obj, const RootInfo& info) {
 // sent directly to DDMS.
 // If "fd" is >= 0, the output will be written to that file descriptor.
 // Otherwise, "filename" is used to create an output file.
+// Write the heap dump from a forked child process. Mutators are only paused until the fork
+// returns, the child then works on a copy-on-write snapshot of the heap.
+static void DumpHeapFromChild(Thread* self, const char* filename, int fd) {
+  pid_t pid;
+  {
+    gc::ScopedGCCriticalSection gcs(self,
+                                    gc::kGcCauseHprof,
+                                    gc::kCollectorTypeHprof);
+    ScopedSuspendAll ssa(__FUNCTION__);
+    // The child only has this thread. Hold the locks that the dump needs across the fork so that
+    // a thread which does not exist in the child cannot own them there.
+    Locks::heap_bitmap_lock_->ExclusiveLock(self);
+    Locks::alloc_tracker_lock_->ExclusiveLock(self);
+    pid = fork();
+    Locks::alloc_tracker_lock_->ExclusiveUnlock(self);
+    Locks::heap_bitmap_lock_->ExclusiveUnlock(self);
+    if (pid == 0) {
+      // Child process. We still hold the mutator lock exclusively. Exit without running any
+      // destructors or exit handlers, they belong to the parent.
+      Hprof hprof(filename, fd, /* direct_to_ddms= */ false);
+      _exit(hprof.Dump() ? 0 : 1);
+    }
+  }
+  ScopedObjectAccess soa(self);
+  if (pid == -1) {
+    ThrowRuntimeException("Couldn't dump heap; fork failed: %s", strerror(errno));
+    return;
+  }
+  int status;
+  pid_t rc;
+  {
+    ScopedThreadSuspension sts(self, kNative);
+    rc = TEMP_FAILURE_RETRY(waitpid(pid, &status, 0));
+  }
+  if (rc == -1) {
+    ThrowRuntimeException("Couldn't dump heap; waitpid(%d) failed: %s", pid, strerror(errno));
+  } else if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+    ThrowRuntimeException("Couldn't dump heap; writing \"%s\" in child process %d failed",
+                          filename,
+                          pid);
+  }
+}
+
 void DumpHeap(const char* filename, int fd, bool direct_to_ddms) {
   CHECK(filename != nullptr);
   Thread* self = Thread::Current();
+  // DDMS chunks are published through the debugger connection which only exists in this process.
+  if (!direct_to_ddms && Runtime::Current()->GetHprofDumpFromChild()) {
+    DumpHeapFromChild(self, filename, fd);
+    return;
+  }
   // Need to take a heap dump while GC isn't running. See the comment in Heap::VisitObjects().
   // Also we need the critical section to avoid visiting the same object twice. See b/34967844
   gc::ScopedGCCriticalSection gcs(self,
@@ -89,6 +89,7 @@ IndirectReferenceTable::IndirectReferenceTable(size_t max_count,
   }
 
   if (table_mem_map_.IsValid()) {
+    table_mem_map_.SetNativeMemoryTag(NativeMemoryTag::kJniReferences);
     table_ = reinterpret_cast<IrtEntry*>(table_mem_map_.Begin());
   } else {
     table_ = nullptr;
@@ -221,6 +222,17 @@ bool IndirectReferenceTable::Resize(size_t new_size, std::string* error_msg) {
   // Note: the above check also ensures that there is no overflow below.
 
   const size_t table_bytes = new_size * sizeof(IrtEntry);
+  // Prefer letting the kernel move the pages of the table, which avoids copying all the entries.
+  // Entries are addressed by index, so the table may move. Fall back to copying if the mapping
+  // cannot be grown in place.
+  std::string grow_error_msg;
+  if (table_mem_map_.Grow(table_bytes, &grow_error_msg)) {
+    table_ = reinterpret_cast<IrtEntry*>(table_mem_map_.Begin());
+    max_entries_ = new_size;
+    return true;
+  }
+  VLOG(jni) << "Could not grow indirect ref table mapping: " << grow_error_msg;
+
   MemMap new_map = MemMap::MapAnonymous("indirect ref table",
                                         table_bytes,
                                         PROT_READ | PROT_WRITE,
@@ -229,6 +241,7 @@ bool IndirectReferenceTable::Resize(size_t new_size, std::string* error_msg) {
   if (!new_map.IsValid()) {
     return false;
   }
+  new_map.SetNativeMemoryTag(NativeMemoryTag::kJniReferences);
 
   memcpy(new_map.Begin(), table_mem_map_.Begin(), table_mem_map_.Size());
   table_mem_map_ = std::move(new_map);
@@ -442,6 +455,12 @@ bool IndirectReferenceTable::Remove(IRTSegmentState previous_state, IndirectRef
   return true;
 }
 
+void IndirectReferenceTable::Reset() {
+  segment_state_ = kIRTFirstSegment;
+  last_known_previous_state_ = kIRTFirstSegment;
+  current_num_holes_ = 0;
+}
+
 void IndirectReferenceTable::Trim() {
   ScopedTrace trace(__PRETTY_FUNCTION__);
   const size_t top_index = Capacity();
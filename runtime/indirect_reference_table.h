@@ -291,6 +291,11 @@ class IndirectReferenceTable {
     return segment_state_.top_index;
   }
 
+  // Return the number of entries the table can hold before it needs to be resized.
+  size_t MaxEntries() const {
+    return max_entries_;
+  }
+
   // Ensure that at least free_capacity elements are available, or return false.
   bool EnsureFreeCapacity(size_t free_capacity, std::string* error_msg)
       REQUIRES_SHARED(Locks::mutator_lock_);
@@ -326,6 +331,10 @@ class IndirectReferenceTable {
   // Release pages past the end of the table that may have previously held references.
   void Trim() REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Drop all references, keeping the current capacity. Used when the table of a detached thread
+  // is reused for another thread.
+  void Reset() REQUIRES_SHARED(Locks::mutator_lock_);
+
   // Determine what kind of indirect reference this is. Opposite of EncodeIndirectRefKind.
   ALWAYS_INLINE static inline IndirectRefKind GetIndirectRefKind(IndirectRef iref) {
     return DecodeIndirectRefKind(reinterpret_cast<uintptr_t>(iref));
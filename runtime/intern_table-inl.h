@@ -55,23 +55,6 @@ inline size_t InternTable::AddTableFromMemory(const uint8_t* ptr,
   return read_count;
 }
 
-inline void InternTable::Table::AddInternStrings(UnorderedSet&& intern_strings,
-                                                 bool is_boot_image) {
-  static constexpr bool kCheckDuplicates = kIsDebugBuild;
-  if (kCheckDuplicates) {
-    // Avoid doing read barriers since the space might not yet be added to the heap.
-    // See b/117803941
-    for (GcRoot<mirror::String>& string : intern_strings) {
-      CHECK(Find(string.Read<kWithoutReadBarrier>()) == nullptr)
-          << "Already found " << string.Read<kWithoutReadBarrier>()->ToModifiedUtf8()
-          << " in the intern table";
-    }
-  }
-  // Insert at the front since we add new interns into the back.
-  tables_.insert(tables_.begin(),
-                 InternalTable(std::move(intern_strings), is_boot_image));
-}
-
 template <typename Visitor>
 inline void InternTable::VisitInterns(const Visitor& visitor,
                                       bool visit_boot_images,
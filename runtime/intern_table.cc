@@ -35,6 +35,27 @@
 
 namespace art {
 
+class InternTable::Table::ScopedWriteSequence {
+ public:
+  explicit ScopedWriteSequence(Table* table) : table_(table) {
+    const uint32_t sequence = table_->sequence_.load(std::memory_order_relaxed);
+    DCHECK_EQ(sequence & 1u, 0u);
+    table_->sequence_.store(sequence + 1u, std::memory_order_relaxed);
+    // Order the odd sequence before any of the writes to the sets.
+    std::atomic_thread_fence(std::memory_order_release);
+  }
+
+  ~ScopedWriteSequence() {
+    const uint32_t sequence = table_->sequence_.load(std::memory_order_relaxed);
+    table_->sequence_.store(sequence + 1u, std::memory_order_release);
+  }
+
+ private:
+  Table* const table_;
+
+  DISALLOW_COPY_AND_ASSIGN(ScopedWriteSequence);
+};
+
 InternTable::InternTable()
     : log_new_roots_(false),
       weak_intern_condition_("New intern condition", *Locks::intern_table_lock_),
@@ -95,6 +116,10 @@ ObjPtr<mirror::String> InternTable::LookupWeak(Thread* self, ObjPtr<mirror::Stri
 }
 
 ObjPtr<mirror::String> InternTable::LookupStrong(Thread* self, ObjPtr<mirror::String> s) {
+  ObjPtr<mirror::String> result;
+  if (TryLookupStrongWithoutLock(s, &result)) {
+    return result;
+  }
   MutexLock mu(self, *Locks::intern_table_lock_);
   return LookupStrongLocked(s);
 }
@@ -106,10 +131,29 @@ ObjPtr<mirror::String> InternTable::LookupStrong(Thread* self,
   Utf8String string(utf16_length,
                     utf8_data,
                     ComputeUtf16HashFromModifiedUtf8(utf8_data, utf16_length));
+  ObjPtr<mirror::String> result;
+  if (TryLookupStrongWithoutLock(string, &result)) {
+    return result;
+  }
   MutexLock mu(self, *Locks::intern_table_lock_);
   return strong_interns_.Find(string);
 }
 
+template <typename Key>
+bool InternTable::TryLookupStrongWithoutLock(const Key& key,
+                                             /*out*/ ObjPtr<mirror::String>* result) {
+  return strong_interns_.TryFindWithoutLock(key, result);
+}
+
+template <typename Key>
+bool InternTable::TryLookupWeakWithoutLock(const Key& key,
+                                           /*out*/ ObjPtr<mirror::String>* result) {
+  // Weak interns may only be read while weak reference access is enabled, see Insert().
+  DCHECK(kUseReadBarrier);
+  DCHECK(Thread::Current()->GetWeakRefAccessEnabled());
+  return weak_interns_.TryFindWithoutLock(key, result);
+}
+
 ObjPtr<mirror::String> InternTable::LookupWeakLocked(ObjPtr<mirror::String> s) {
   return weak_interns_.Find(s);
 }
@@ -204,6 +248,19 @@ ObjPtr<mirror::String> InternTable::Insert(ObjPtr<mirror::String> s,
     return nullptr;
   }
   Thread* const self = Thread::Current();
+  // Fast path for strings that are already interned. The weak table may only be read without the
+  // lock when weak reference access is enabled for this thread. With the read barrier this is
+  // only disabled through a checkpoint, so it cannot change before we reach a suspend point,
+  // and the GC does not sweep the weak interns while it is enabled.
+  ObjPtr<mirror::String> found;
+  if (TryLookupStrongWithoutLock(s, &found) && found != nullptr) {
+    return found;
+  }
+  if (kUseReadBarrier && !is_strong && self->GetWeakRefAccessEnabled()) {
+    if (TryLookupWeakWithoutLock(s, &found) && found != nullptr) {
+      return found;
+    }
+  }
   MutexLock mu(self, *Locks::intern_table_lock_);
   if (kDebugLocking && !holding_locks) {
     Locks::mutator_lock_->AssertSharedHeld(self);
@@ -366,6 +423,7 @@ void InternTable::Table::Remove(ObjPtr<mirror::String> s) {
   for (InternalTable& table : tables_) {
     auto it = table.set_.find(GcRoot<mirror::String>(s));
     if (it != table.set_.end()) {
+      ScopedWriteSequence sws(this);
       table.set_.erase(it);
       return;
     }
@@ -395,15 +453,122 @@ ObjPtr<mirror::String> InternTable::Table::Find(const Utf8String& string) {
   return nullptr;
 }
 
+bool InternTable::Table::TryFindWithoutLock(ObjPtr<mirror::String> s,
+                                            /*out*/ ObjPtr<mirror::String>* result) {
+  GcRoot<mirror::String> key(s);
+  return TryFindWithoutLockImpl(key, StringHashEquals()(key), result);
+}
+
+bool InternTable::Table::TryFindWithoutLock(const Utf8String& string,
+                                            /*out*/ ObjPtr<mirror::String>* result) {
+  return TryFindWithoutLockImpl(string, StringHashEquals()(string), result);
+}
+
+template <typename Key>
+bool InternTable::Table::TryFindWithoutLockImpl(const Key& key,
+                                                size_t hash,
+                                                /*out*/ ObjPtr<mirror::String>* result) {
+  StringHashEquals pred;
+  for (size_t attempt = 0; attempt != kMaxLockFreeLookupAttempts; ++attempt) {
+    const uint32_t sequence = sequence_.load(std::memory_order_acquire);
+    if ((sequence & 1u) != 0u) {
+      continue;  // A writer is modifying the tables.
+    }
+    // The probing may observe a set in the middle of a modification, but every non-null entry it
+    // sees was interned during this attempt and cannot be freed before we reach a suspend point.
+    // The sequence check rejects any result that may be inconsistent.
+    const ReadView* view = read_view_.load(std::memory_order_acquire);
+    ObjPtr<mirror::String> found = nullptr;
+    for (const ReadView::Buckets& buckets : view->sets) {
+      if (buckets.num_buckets == 0u) {
+        continue;
+      }
+      size_t index = hash % buckets.num_buckets;
+      for (size_t probes = 0; probes != buckets.num_buckets; ++probes) {
+        const GcRoot<mirror::String>& root = buckets.data[index];
+        if (root.IsNull()) {
+          break;
+        }
+        if (pred(root, key)) {
+          found = root.Read<kWithoutReadBarrier>();
+          break;
+        }
+        index = (index + 1u == buckets.num_buckets) ? 0u : index + 1u;
+      }
+      if (found != nullptr) {
+        break;
+      }
+    }
+    // Order the reads of the entries before re-reading the sequence.
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (sequence_.load(std::memory_order_relaxed) == sequence) {
+      // Apply the read barrier to a copy, reading through the entry could update it.
+      *result = (found != nullptr) ? GcRoot<mirror::String>(found).Read() : nullptr;
+      return true;
+    }
+  }
+  return false;
+}
+
+void InternTable::Table::AddInternStrings(UnorderedSet&& intern_strings, bool is_boot_image) {
+  static constexpr bool kCheckDuplicates = kIsDebugBuild;
+  if (kCheckDuplicates) {
+    // Avoid doing read barriers since the space might not yet be added to the heap.
+    // See b/117803941
+    for (GcRoot<mirror::String>& string : intern_strings) {
+      CHECK(Find(string.Read<kWithoutReadBarrier>()) == nullptr)
+          << "Already found " << string.Read<kWithoutReadBarrier>()->ToModifiedUtf8()
+          << " in the intern table";
+    }
+  }
+  // Insert at the front since we add new interns into the back.
+  ScopedWriteSequence sws(this);
+  tables_.insert(tables_.begin(),
+                 InternalTable(std::move(intern_strings), is_boot_image));
+  PublishReadView();
+}
+
 void InternTable::Table::AddNewTable() {
+  ScopedWriteSequence sws(this);
   tables_.push_back(InternalTable());
+  PublishReadView();
 }
 
 void InternTable::Table::Insert(ObjPtr<mirror::String> s) {
   // Always insert the last table, the image tables are before and we avoid inserting into these
   // to prevent dirty pages.
   DCHECK(!tables_.empty());
-  tables_.back().set_.insert(GcRoot<mirror::String>(s));
+  ScopedWriteSequence sws(this);
+  UnorderedSet& latest = tables_.back().set_;
+  if (latest.size() >= latest.ElementsUntilExpand()) {
+    GrowLatestTable();
+  }
+  DCHECK_LT(latest.size(), latest.ElementsUntilExpand());
+  latest.insert(GcRoot<mirror::String>(s));
+}
+
+void InternTable::Table::GrowLatestTable() {
+  UnorderedSet& latest = tables_.back().set_;
+  // Grow like HashSet::Expand() would, based on the minimum load factor, but into new storage.
+  UnorderedSet grown(latest.GetMinLoadFactor(), latest.GetMaxLoadFactor());
+  grown.reserve(
+      static_cast<size_t>(latest.size() * latest.GetMaxLoadFactor() / latest.GetMinLoadFactor()));
+  for (const GcRoot<mirror::String>& string : latest) {
+    grown.insert(string);
+  }
+  latest.swap(grown);
+  retired_sets_.push_back(std::move(grown));
+  PublishReadView();
+}
+
+void InternTable::Table::PublishReadView() {
+  std::unique_ptr<ReadView> view(new ReadView());
+  view->sets.reserve(tables_.size());
+  for (const InternalTable& table : tables_) {
+    view->sets.push_back({table.set_.data(), table.set_.NumBuckets()});
+  }
+  read_view_.store(view.get(), std::memory_order_release);
+  read_views_.push_back(std::move(view));
 }
 
 void InternTable::Table::VisitRoots(RootVisitor* visitor) {
@@ -417,6 +582,7 @@ void InternTable::Table::VisitRoots(RootVisitor* visitor) {
 }
 
 void InternTable::Table::SweepWeaks(IsMarkedVisitor* visitor) {
+  ScopedWriteSequence sws(this);
   for (InternalTable& table : tables_) {
     SweepWeaks(&table.set_, visitor);
   }
@@ -458,12 +624,13 @@ void InternTable::ChangeWeakRootStateLocked(gc::WeakRootState new_state) {
   }
 }
 
-InternTable::Table::Table() {
+InternTable::Table::Table() : sequence_(0u), read_view_(nullptr) {
   Runtime* const runtime = Runtime::Current();
   InternalTable initial_table;
   initial_table.set_.SetLoadFactor(runtime->GetHashTableMinLoadFactor(),
                                    runtime->GetHashTableMaxLoadFactor());
   tables_.push_back(std::move(initial_table));
+  PublishReadView();
 }
 
 }  // namespace art
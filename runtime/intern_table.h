@@ -17,7 +17,9 @@
 #ifndef ART_RUNTIME_INTERN_TABLE_H_
 #define ART_RUNTIME_INTERN_TABLE_H_
 
+#include <memory>
 #include <unordered_set>
+#include <vector>
 
 #include "base/atomic.h"
 #include "base/allocator.h"
@@ -241,6 +243,13 @@ class InternTable {
         REQUIRES(Locks::intern_table_lock_);
     ObjPtr<mirror::String> Find(const Utf8String& string) REQUIRES_SHARED(Locks::mutator_lock_)
         REQUIRES(Locks::intern_table_lock_);
+    // Versions of Find() that do not take the intern table lock and do not write to the table.
+    // Return false if concurrent modifications prevented a consistent lookup, in which case the
+    // caller must use Find() with the lock held instead.
+    bool TryFindWithoutLock(ObjPtr<mirror::String> s, /*out*/ ObjPtr<mirror::String>* result)
+        REQUIRES_SHARED(Locks::mutator_lock_);
+    bool TryFindWithoutLock(const Utf8String& string, /*out*/ ObjPtr<mirror::String>* result)
+        REQUIRES_SHARED(Locks::mutator_lock_);
     void Insert(ObjPtr<mirror::String> s) REQUIRES_SHARED(Locks::mutator_lock_)
         REQUIRES(Locks::intern_table_lock_);
     void Remove(ObjPtr<mirror::String> s)
@@ -265,6 +274,37 @@ class InternTable {
         REQUIRES(Locks::intern_table_lock_) REQUIRES_SHARED(Locks::mutator_lock_);
 
    private:
+    // Snapshot of the bucket arrays of `tables_` for lookups that do not hold the intern table
+    // lock. A view is immutable once published and, like every bucket array it refers to, is
+    // only freed with the table.
+    struct ReadView {
+      struct Buckets {
+        const GcRoot<mirror::String>* data;
+        size_t num_buckets;
+      };
+      std::vector<Buckets> sets;
+    };
+
+    // Brackets a modification of `tables_` by making `sequence_` odd for its duration.
+    class ScopedWriteSequence;
+
+    // Number of lock-free lookup attempts before giving up in favor of the locked lookup.
+    static constexpr size_t kMaxLockFreeLookupAttempts = 3u;
+
+    template <typename Key>
+    bool TryFindWithoutLockImpl(const Key& key,
+                                size_t hash,
+                                /*out*/ ObjPtr<mirror::String>* result)
+        REQUIRES_SHARED(Locks::mutator_lock_);
+
+    // Move the latest set to a larger bucket array and retire the old one. Used instead of
+    // letting the set expand in place since lock-free readers may still probe the old array.
+    void GrowLatestTable() REQUIRES(Locks::intern_table_lock_) REQUIRES_SHARED(Locks::mutator_lock_);
+
+    // Publish a new ReadView of `tables_`. Requires the intern table lock unless the table is
+    // still being constructed.
+    void PublishReadView() NO_THREAD_SAFETY_ANALYSIS;
+
     void SweepWeaks(UnorderedSet* set, IsMarkedVisitor* visitor)
         REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(Locks::intern_table_lock_);
 
@@ -275,6 +315,14 @@ class InternTable {
     // We call AddNewTable when we create the zygote to reduce private dirty pages caused by
     // modifying the zygote intern table. The back of table is modified when strings are interned.
     std::vector<InternalTable> tables_;
+    // Seqlock sequence for lock-free readers, odd while `tables_` is being modified.
+    Atomic<uint32_t> sequence_;
+    // Current view of `tables_` for lock-free readers.
+    Atomic<const ReadView*> read_view_;
+    // All views ever published and the sets replaced by GrowLatestTable(). Lock-free readers may
+    // still be using them, so they are kept for the lifetime of the table.
+    std::vector<std::unique_ptr<const ReadView>> read_views_;
+    std::vector<UnorderedSet> retired_sets_;
 
     friend class InternTable;
     friend class linker::ImageWriter;
@@ -287,6 +335,15 @@ class InternTable {
   ObjPtr<mirror::String> Insert(ObjPtr<mirror::String> s, bool is_strong, bool holding_locks)
       REQUIRES(!Locks::intern_table_lock_) REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Lock-free lookups, see Table::TryFindWithoutLock(). The tables are only read in a way that is
+  // safe without the intern table lock, hence NO_THREAD_SAFETY_ANALYSIS.
+  template <typename Key>
+  bool TryLookupStrongWithoutLock(const Key& key, /*out*/ ObjPtr<mirror::String>* result)
+      REQUIRES_SHARED(Locks::mutator_lock_) NO_THREAD_SAFETY_ANALYSIS;
+  template <typename Key>
+  bool TryLookupWeakWithoutLock(const Key& key, /*out*/ ObjPtr<mirror::String>* result)
+      REQUIRES_SHARED(Locks::mutator_lock_) NO_THREAD_SAFETY_ANALYSIS;
+
   // Add a table from memory to the strong interns.
   template <typename Visitor>
   size_t AddTableFromMemory(const uint8_t* ptr, const Visitor& visitor, bool is_boot_image)
@@ -234,4 +234,27 @@ TEST_F(InternTableTest, LookupStrong) {
   EXPECT_TRUE(lookup_foobbS == nullptr);
 }
 
+TEST_F(InternTableTest, LookupStrongAcrossGrowth) {
+  ScopedObjectAccess soa(Thread::Current());
+  InternTable intern_table;
+  // Enough strings to grow the latest table several times, split across two tables.
+  static constexpr size_t kNumStrings = 5000u;
+  for (size_t i = 0; i != kNumStrings; ++i) {
+    if (i == kNumStrings / 2) {
+      intern_table.AddNewTable();
+    }
+    std::string str = "string" + std::to_string(i);
+    ASSERT_TRUE(intern_table.InternStrong(str.c_str()) != nullptr);
+  }
+  EXPECT_EQ(kNumStrings, intern_table.StrongSize());
+  for (size_t i = 0; i != kNumStrings; ++i) {
+    std::string str = "string" + std::to_string(i);
+    ObjPtr<mirror::String> lookup = intern_table.LookupStrong(soa.Self(), str.length(), str.c_str());
+    ASSERT_TRUE(lookup != nullptr) << str;
+    EXPECT_TRUE(lookup->Equals(str.c_str()));
+  }
+  ObjPtr<mirror::String> missing = intern_table.LookupStrong(soa.Self(), 7, "missing");
+  EXPECT_TRUE(missing == nullptr);
+}
+
 }  // namespace art
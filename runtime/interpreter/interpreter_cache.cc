@@ -15,7 +15,13 @@
  */
 
 #include "interpreter_cache.h"
+
+#include <ostream>
+
+#include "base/mutex.h"
+#include "runtime.h"
 #include "thread-inl.h"
+#include "thread_list.h"
 
 namespace art {
 
@@ -25,6 +31,34 @@ void InterpreterCache::Clear(Thread* owning_thread) {
   data_.fill(Entry{});
 }
 
+void InterpreterCache::DumpForSigQuit(std::ostream& os) {
+  struct Totals {
+    uint64_t hits = 0u;
+    uint64_t misses = 0u;
+    uint64_t conflicts = 0u;
+  } totals;
+  {
+    MutexLock mu(Thread::Current(), *Locks::thread_list_lock_);
+    Runtime::Current()->GetThreadList()->ForEach(
+        [](Thread* thread, void* arg) {
+          Totals* t = reinterpret_cast<Totals*>(arg);
+          const InterpreterCache* cache = thread->GetInterpreterCache();
+          t->hits += cache->hits_;
+          t->misses += cache->misses_;
+          t->conflicts += cache->conflicts_;
+        },
+        &totals);
+  }
+  const uint64_t lookups = totals.hits + totals.misses;
+  os << "Interpreter cache: " << kSize << " entries; "
+     << totals.hits << " hits; " << totals.misses << " misses; "
+     << totals.conflicts << " conflicts";
+  if (lookups != 0u) {
+    os << "; " << (totals.hits * 100u / lookups) << "% hit rate";
+  }
+  os << "\n";
+}
+
 bool InterpreterCache::IsCalledFromOwningThread() {
   return Thread::Current()->GetInterpreterCache() == this;
 }
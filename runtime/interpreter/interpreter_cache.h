@@ -19,6 +19,7 @@
 
 #include <array>
 #include <atomic>
+#include <iosfwd>
 
 #include "base/bit_utils.h"
 #include "base/macros.h"
@@ -38,28 +39,37 @@ class Thread;
 //   iget/iput: The field offset. The field must be non-volatile.
 //   sget/sput: The ArtField* pointer. The field must be non-volitile.
 //   invoke: The ArtMethod* pointer (before vtable indirection, etc).
+//   invoke-interface: Also the ArtMethod* the last IMT conflict dispatched to, keyed by
+//     InterfaceTargetKey(). It is only used when the receiver class is its declaring class.
 //
 // We ensure consistency of the cache by clearing it
 // whenever any dex file is unloaded.
 //
 // Aligned to 16-bytes to make it easier to get the address of the cache
 // from assembly (it ensures that the offset is valid immediate value).
+// The entries must stay at the start of the cache for the same reason.
 class ALIGNED(16) InterpreterCache {
   // Aligned since we load the whole entry in single assembly instruction.
   typedef std::pair<const void*, size_t> Entry ALIGNED(2 * sizeof(size_t));
 
  public:
   // 2x size increase/decrease corresponds to ~0.5% interpreter performance change.
-  // Value of 256 has around 75% cache hit rate.
+  // Value of 256 has around 75% cache hit rate. Builds can override the size with
+  // ART_INTERPRETER_CACHE_SIZE_LOG2, the hit rate reported on SIGQUIT helps picking it.
+#ifdef ART_INTERPRETER_CACHE_SIZE_LOG2
+  static constexpr size_t kSize = static_cast<size_t>(1) << ART_INTERPRETER_CACHE_SIZE_LOG2;
+#else
   static constexpr size_t kSize = 256;
+#endif
 
-  InterpreterCache() {
+  InterpreterCache() : hits_(0u), misses_(0u), conflicts_(0u) {
     // We can not use the Clear() method since the constructor will not
     // be called from the owning thread.
     data_.fill(Entry{});
   }
 
   // Clear the whole cache. It requires the owning thread for DCHECKs.
+  // This does not reset the statistics.
   void Clear(Thread* owning_thread);
 
   ALWAYS_INLINE bool Get(const void* key, /* out */ size_t* value) {
@@ -67,16 +77,34 @@ class ALIGNED(16) InterpreterCache {
     Entry& entry = data_[IndexOf(key)];
     if (LIKELY(entry.first == key)) {
       *value = entry.second;
+      ++hits_;
       return true;
     }
+    ++misses_;
     return false;
   }
 
   ALWAYS_INLINE void Set(const void* key, size_t value) {
     DCHECK(IsCalledFromOwningThread());
-    data_[IndexOf(key)] = Entry{key, value};
+    Entry& entry = data_[IndexOf(key)];
+    if (entry.first != nullptr && entry.first != key) {
+      // Evicting the entry of another dex pc mapping to the same index.
+      ++conflicts_;
+    }
+    entry = Entry{key, value};
+  }
+
+  // Key of the dispatch target of an invoke-interface. It is the address of the third code unit of
+  // the instruction, which is never the start of an instruction and maps to a different index.
+  static const void* InterfaceTargetKey(const void* invoke_instruction) {
+    return reinterpret_cast<const uint16_t*>(invoke_instruction) + 2;
   }
 
+  // Dump the hit, miss and conflict counts summed over all the threads.
+  // Hits in assembly fast paths (e.g. the arm64 mterp iget/iput) do not go through Get()
+  // and are not counted, their misses are.
+  static void DumpForSigQuit(std::ostream& os);
+
  private:
   bool IsCalledFromOwningThread();
 
@@ -88,6 +116,11 @@ class ALIGNED(16) InterpreterCache {
   }
 
   std::array<Entry, kSize> data_;
+
+  // Statistics. Only updated by the owning thread, and read without synchronization when dumping.
+  size_t hits_;
+  size_t misses_;
+  size_t conflicts_;
 };
 
 }  // namespace art
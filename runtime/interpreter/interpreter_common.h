@@ -185,9 +185,27 @@ static ALWAYS_INLINE bool DoInvoke(Thread* self,
     DCHECK(receiver->GetClass()->ShouldHaveEmbeddedVTable());
     called_method = receiver->GetClass()->GetEmbeddedVTableEntry(
         /*vtable_idx=*/ method_idx, Runtime::Current()->GetClassLinker()->GetImagePointerSize());
+  } else if (type == kInterface &&
+             receiver != nullptr &&
+             tls_cache->Get(InterpreterCache::InterfaceTargetKey(inst), &tls_value) &&
+             reinterpret_cast<ArtMethod*>(tls_value)->GetDeclaringClass() == receiver->GetClass()) {
+    // Monomorphic inline cache of the call site, only filled for IMT conflicts.
+    called_method = reinterpret_cast<ArtMethod*>(tls_value);
   } else {
     called_method = FindMethodToCall<type, do_access_check>(
         method_idx, resolved_method, &receiver, sf_method, self);
+    if (type == kInterface &&
+        called_method != nullptr &&
+        called_method->GetDeclaringClass() == receiver->GetClass()) {
+      PointerSize pointer_size = Runtime::Current()->GetClassLinker()->GetImagePointerSize();
+      ArtMethod* imt_method = receiver->GetClass()->GetImt(pointer_size)->Get(
+          resolved_method->GetImtIndex(), pointer_size);
+      if (imt_method->IsRuntimeMethod()) {
+        // The IMT did not resolve the call, avoid searching the iftable the next time.
+        tls_cache->Set(InterpreterCache::InterfaceTargetKey(inst),
+                       reinterpret_cast<size_t>(called_method));
+      }
+    }
   }
   if (UNLIKELY(called_method == nullptr)) {
     CHECK(self->IsExceptionPending());
@@ -268,11 +268,20 @@ class InstructionHandler {
     return true;
   }
 
+  // Back edges are reported to the JIT in batches, like mterp does with the hotness countdown.
+  // AddSamples() only looks at the thresholds once a batch boundary is crossed anyway, except
+  // for the first batch which we keep reporting one sample at a time.
   ALWAYS_INLINE void HotnessUpdate()
       REQUIRES_SHARED(Locks::mutator_lock_) {
     jit::Jit* jit = Runtime::Current()->GetJit();
     if (jit != nullptr) {
-      jit->AddSamples(self, shadow_frame.GetMethod(), 1, /*with_backedges=*/ true);
+      ArtMethod* method = shadow_frame.GetMethod();
+      ++ctx->pending_hotness_samples;
+      if (ctx->pending_hotness_samples >= jit::kJitSamplesBatchSize ||
+          method->GetCounter() < jit::kJitSamplesBatchSize) {
+        jit->AddSamples(self, method, ctx->pending_hotness_samples, /*with_backedges=*/ true);
+        ctx->pending_hotness_samples = 0u;
+      }
     }
   }
 
@@ -2615,15 +2624,50 @@ class InstructionHandler {
 #undef POSSIBLY_HANDLE_PENDING_EXCEPTION_ON_INVOKE_POLYMORPHIC
 #undef HANDLE_PENDING_EXCEPTION
 
+// Dispatch through a table of label addresses rather than a switch. Each handler then ends with
+// its own indirect branch, which the branch predictor can learn per opcode pair, instead of
+// every instruction going through the single jump of the switch. This matters when mterp cannot
+// be used, e.g. for debuggable apps, under instrumentation or in transactions.
+#if defined(__clang__) || defined(__GNUC__)
+#define ART_SWITCH_IMPL_THREADED_DISPATCH 1
+#else
+#define ART_SWITCH_IMPL_THREADED_DISPATCH 0
+#endif
+
 // TODO On ASAN builds this function gets a huge stack frame. Since normally we run in the mterp
 // this shouldn't cause any problems for stack overflow detection. Remove this once b/117341496 is
 // fixed.
+// Reports the back edge samples still batched in the context when leaving the frame.
+class ScopedFlushHotnessSamples {
+ public:
+  explicit ScopedFlushHotnessSamples(SwitchImplContext* ctx) : ctx_(ctx) {}
+
+  ~ScopedFlushHotnessSamples() REQUIRES_SHARED(Locks::mutator_lock_) {
+    if (ctx_->pending_hotness_samples != 0u) {
+      jit::Jit* jit = Runtime::Current()->GetJit();
+      if (jit != nullptr) {
+        jit->AddSamples(ctx_->self,
+                        ctx_->shadow_frame.GetMethod(),
+                        ctx_->pending_hotness_samples,
+                        /*with_backedges=*/ true);
+      }
+      ctx_->pending_hotness_samples = 0u;
+    }
+  }
+
+ private:
+  SwitchImplContext* const ctx_;
+
+  DISALLOW_COPY_AND_ASSIGN(ScopedFlushHotnessSamples);
+};
+
 template<bool do_access_check, bool transaction_active>
 ATTRIBUTE_NO_SANITIZE_ADDRESS void ExecuteSwitchImplCpp(SwitchImplContext* ctx) {
   Thread* self = ctx->self;
   const CodeItemDataAccessor& accessor = ctx->accessor;
   ShadowFrame& shadow_frame = ctx->shadow_frame;
   self->VerifyStack();
+  ScopedFlushHotnessSamples flush_hotness_samples(ctx);
 
   uint32_t dex_pc = shadow_frame.GetDexPC();
   const auto* const instrumentation = Runtime::Current()->GetInstrumentation();
@@ -2635,6 +2679,62 @@ ATTRIBUTE_NO_SANITIZE_ADDRESS void ExecuteSwitchImplCpp(SwitchImplContext* ctx)
       << "Entered interpreter from invoke without retry instruction being handled!";
 
   bool const interpret_one_instruction = ctx->interpret_one_instruction;
+#if ART_SWITCH_IMPL_THREADED_DISPATCH
+  // Indexed by opcode, DEX_INSTRUCTION_LIST is sorted by opcode value.
+  static const void* const kOpcodeHandlers[] = {
+#define OPCODE_LABEL(OPCODE, OPCODE_NAME, pname, f, i, a, e, v) &&op_##OPCODE_NAME,
+DEX_INSTRUCTION_LIST(OPCODE_LABEL)
+#undef OPCODE_LABEL
+  };
+  static_assert(arraysize(kOpcodeHandlers) == Instruction::kNumPackedOpcodes,
+                "Missing opcode handlers");
+
+  // Runs the preamble of the instruction at `inst` and jumps to its handler. This is expanded
+  // at the end of every handler so that each one gets its own indirect branch.
+#define DISPATCH_NEXT_INSTRUCTION()                                                               \
+  do {                                                                                            \
+    dex_pc = inst->GetDexPc(insns);                                                               \
+    shadow_frame.SetDexPC(dex_pc);                                                                \
+    TraceExecution(shadow_frame, inst, dex_pc);                                                   \
+    inst_data = inst->Fetch16(0);                                                                 \
+    bool exit_loop = false;                                                                       \
+    InstructionHandler<do_access_check, transaction_active> handler(                              \
+        ctx, instrumentation, self, shadow_frame, dex_pc, inst, inst_data, exit_loop);            \
+    if (!handler.Preamble()) {                                                                    \
+      if (UNLIKELY(exit_loop)) {                                                                  \
+        return;                                                                                   \
+      }                                                                                           \
+      if (UNLIKELY(interpret_one_instruction)) {                                                  \
+        goto done;                                                                                \
+      }                                                                                           \
+      goto dispatch;                                                                              \
+    }                                                                                             \
+    goto *kOpcodeHandlers[inst->Opcode(inst_data)];                                               \
+  } while (false)
+
+ dispatch:
+  DISPATCH_NEXT_INSTRUCTION();
+
+#define OPCODE_HANDLER(OPCODE, OPCODE_NAME, pname, f, i, a, e, v)                                 \
+ op_##OPCODE_NAME: {                                                                              \
+    bool exit_loop = false;                                                                       \
+    InstructionHandler<do_access_check, transaction_active> handler(                              \
+        ctx, instrumentation, self, shadow_frame, dex_pc, inst, inst_data, exit_loop);            \
+    handler.OPCODE_NAME();                                                                        \
+    if (UNLIKELY(exit_loop)) {                                                                    \
+      return;                                                                                     \
+    }                                                                                             \
+    if (UNLIKELY(interpret_one_instruction)) {                                                    \
+      goto done;                                                                                  \
+    }                                                                                             \
+  }                                                                                               \
+  DISPATCH_NEXT_INSTRUCTION();
+DEX_INSTRUCTION_LIST(OPCODE_HANDLER)
+#undef OPCODE_HANDLER
+#undef DISPATCH_NEXT_INSTRUCTION
+
+ done:
+#else
   while (true) {
     dex_pc = inst->GetDexPc(insns);
     shadow_frame.SetDexPC(dex_pc);
@@ -2674,12 +2774,15 @@ DEX_INSTRUCTION_LIST(OPCODE_CASE)
       break;
     }
   }
+#endif  // ART_SWITCH_IMPL_THREADED_DISPATCH
   // Record where we stopped.
   shadow_frame.SetDexPC(inst->GetDexPc(insns));
   ctx->result = ctx->result_register;
   return;
 }  // NOLINT(readability/fn_size)
 
+#undef ART_SWITCH_IMPL_THREADED_DISPATCH
+
 }  // namespace interpreter
 }  // namespace art
 
@@ -42,6 +42,8 @@ struct SwitchImplContext {
   JValue& result_register;
   bool interpret_one_instruction;
   JValue result;
+  // Back edge samples not yet reported to the JIT.
+  uint16_t pending_hotness_samples;
 };
 
 // The actual internal implementation of the switch interpreter.
@@ -67,6 +69,7 @@ ALWAYS_INLINE JValue ExecuteSwitchImpl(Thread* self, const CodeItemDataAccessor&
     .result_register = result_register,
     .interpret_one_instruction = interpret_one_instruction,
     .result = JValue(),
+    .pending_hotness_samples = 0u,
   };
   void* impl = reinterpret_cast<void*>(&ExecuteSwitchImplCpp<do_access_check, transaction_active>);
   const uint16_t* dex_pc = ctx.accessor.Insns();
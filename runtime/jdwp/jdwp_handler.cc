@@ -19,6 +19,8 @@
 #include <unistd.h>
 #include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "android-base/stringprintf.h"
 
@@ -304,11 +306,14 @@ static JdwpError VM_ClassPaths(JdwpState*, Request*, ExpandBuf* pReply)
 static JdwpError VM_DisposeObjects(JdwpState*, Request* request, ExpandBuf*)
     REQUIRES_SHARED(Locks::mutator_lock_) {
   size_t object_count = request->ReadUnsigned32("object_count");
+  std::vector<std::pair<ObjectId, uint32_t>> objects;
+  objects.reserve(object_count);
   for (size_t i = 0; i < object_count; ++i) {
     ObjectId object_id = request->ReadObjectId();
     uint32_t reference_count = request->ReadUnsigned32("reference_count");
-    Dbg::DisposeObject(object_id, reference_count);
+    objects.emplace_back(object_id, reference_count);
   }
+  Dbg::DisposeObjects(objects);
   return ERR_NONE;
 }
 
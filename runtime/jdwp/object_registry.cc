@@ -28,13 +28,13 @@ namespace art {
 std::ostream& operator<<(std::ostream& os, const ObjectRegistryEntry& rhs) {
   os << "ObjectRegistryEntry[" << rhs.jni_reference_type
      << ",reference=" << rhs.jni_reference
-     << ",count=" << rhs.reference_count
+     << ",count=" << rhs.reference_count.load(std::memory_order_relaxed)
      << ",id=" << rhs.id << "]";
   return os;
 }
 
 ObjectRegistry::ObjectRegistry()
-    : lock_("ObjectRegistry lock", kJdwpObjectRegistryLock), next_id_(1) {
+    : lock_("ObjectRegistry lock", kJdwpObjectRegistryLock), first_id_(1), next_id_(1) {
   Locks::AddToExpectedMutexesOnWeakRefAccess(&lock_);
 }
 
@@ -94,34 +94,70 @@ JDWP::ObjectId ObjectRegistry::InternalAdd(Handle<T> obj_h) {
   int32_t identity_hash_code = obj_h->IdentityHashCode();
 
   ScopedObjectAccessUnchecked soa(self);
-  MutexLock mu(soa.Self(), lock_);
-  ObjectRegistryEntry* entry = nullptr;
-  if (ContainsLocked(soa.Self(), obj_h.Get(), identity_hash_code, &entry)) {
-    // This object was already in our map.
-    ++entry->reference_count;
-  } else {
-    entry = new ObjectRegistryEntry;
-    entry->jni_reference_type = JNIWeakGlobalRefType;
-    entry->jni_reference = nullptr;
-    entry->reference_count = 0;
-    entry->id = 0;
-    entry->identity_hash_code = identity_hash_code;
-    object_to_entry_.insert(std::make_pair(identity_hash_code, entry));
-
-    // This object isn't in the registry yet, so add it.
-    JNIEnv* env = soa.Env();
+  {
+    // Most objects the debugger asks about are already registered. Only the reference
+    // count changes for those, so a shared lock is enough.
+    ReaderMutexLock mu(soa.Self(), lock_);
+    ObjectRegistryEntry* entry = nullptr;
+    if (ContainsLocked(soa.Self(), obj_h.Get(), identity_hash_code, &entry)) {
+      entry->reference_count.fetch_add(1, std::memory_order_relaxed);
+      return entry->id;
+    }
+  }
+  WriterMutexLock mu(soa.Self(), lock_);
+  return AddLocked(soa, obj_h.Get(), identity_hash_code);
+}
 
-    jobject local_reference = soa.AddLocalReference<jobject>(obj_h.Get());
+void ObjectRegistry::AddAll(const std::vector<Handle<mirror::Object>>& objects,
+                            std::vector<JDWP::ObjectId>* ids) {
+  Thread* const self = Thread::Current();
+  self->AssertNoPendingException();
+  Locks::thread_list_lock_->AssertNotHeld(self);
+  Locks::thread_suspend_count_lock_->AssertNotHeld(self);
 
-    entry->jni_reference_type = JNIWeakGlobalRefType;
-    entry->jni_reference = env->NewWeakGlobalRef(local_reference);
-    entry->reference_count = 1;
-    entry->id = next_id_++;
+  // As in InternalAdd, get the identity hash codes before taking lock_.
+  std::vector<int32_t> identity_hash_codes;
+  identity_hash_codes.reserve(objects.size());
+  for (Handle<mirror::Object> obj_h : objects) {
+    identity_hash_codes.push_back(obj_h != nullptr ? obj_h->IdentityHashCode() : 0);
+  }
 
-    id_to_entry_.Put(entry->id, entry);
+  ScopedObjectAccessUnchecked soa(self);
+  WriterMutexLock mu(soa.Self(), lock_);
+  ids->reserve(ids->size() + objects.size());
+  for (size_t i = 0; i < objects.size(); ++i) {
+    if (objects[i] == nullptr) {
+      ids->push_back(0);
+    } else {
+      ids->push_back(AddLocked(soa, objects[i].Get(), identity_hash_codes[i]));
+    }
+  }
+}
 
-    env->DeleteLocalRef(local_reference);
+JDWP::ObjectId ObjectRegistry::AddLocked(const ScopedObjectAccessUnchecked& soa,
+                                         ObjPtr<mirror::Object> o,
+                                         int32_t identity_hash_code) {
+  ObjectRegistryEntry* entry = nullptr;
+  if (ContainsLocked(soa.Self(), o, identity_hash_code, &entry)) {
+    // This object was already in our map.
+    entry->reference_count.fetch_add(1, std::memory_order_relaxed);
+    return entry->id;
   }
+
+  // This object isn't in the registry yet, so add it.
+  JNIEnv* env = soa.Env();
+  jobject local_reference = soa.AddLocalReference<jobject>(o);
+  entry = new ObjectRegistryEntry;
+  entry->jni_reference_type = JNIWeakGlobalRefType;
+  entry->jni_reference = env->NewWeakGlobalRef(local_reference);
+  entry->reference_count.store(1, std::memory_order_relaxed);
+  entry->id = next_id_++;
+  entry->identity_hash_code = identity_hash_code;
+  env->DeleteLocalRef(local_reference);
+
+  object_to_entry_.emplace(identity_hash_code, entry);
+  DCHECK_EQ(entry->id - first_id_, id_to_entry_.size());
+  id_to_entry_.push_back(entry);
   return entry->id;
 }
 
@@ -130,8 +166,8 @@ bool ObjectRegistry::ContainsLocked(Thread* self,
                                     int32_t identity_hash_code,
                                     ObjectRegistryEntry** out_entry) {
   DCHECK(o != nullptr);
-  for (auto it = object_to_entry_.lower_bound(identity_hash_code), end = object_to_entry_.end();
-       it != end && it->first == identity_hash_code; ++it) {
+  auto range = object_to_entry_.equal_range(identity_hash_code);
+  for (auto it = range.first; it != range.second; ++it) {
     ObjectRegistryEntry* entry = it->second;
     if (o == self->DecodeJObject(entry->jni_reference)) {
       if (out_entry != nullptr) {
@@ -143,6 +179,13 @@ bool ObjectRegistry::ContainsLocked(Thread* self,
   return false;
 }
 
+ObjectRegistryEntry* ObjectRegistry::FindLocked(JDWP::ObjectId id) {
+  if (id < first_id_ || id - first_id_ >= id_to_entry_.size()) {
+    return nullptr;
+  }
+  return id_to_entry_[id - first_id_];
+}
+
 void ObjectRegistry::Clear() {
   Thread* const self = Thread::Current();
 
@@ -158,7 +201,7 @@ void ObjectRegistry::Clear() {
   //    thread to re-enable access to them.
   Locks::mutator_lock_->AssertNotExclusiveHeld(self);
 
-  MutexLock mu(self, lock_);
+  WriterMutexLock mu(self, lock_);
   VLOG(jdwp) << "Object registry contained " << object_to_entry_.size() << " entries";
   // Delete all the JNI references.
   JNIEnv* env = self->GetJniEnv();
@@ -174,19 +217,19 @@ void ObjectRegistry::Clear() {
   // Clear the maps.
   object_to_entry_.clear();
   id_to_entry_.clear();
+  first_id_ = next_id_;
 }
 
 ObjPtr<mirror::Object> ObjectRegistry::InternalGet(JDWP::ObjectId id, JDWP::JdwpError* error) {
   Thread* self = Thread::Current();
-  MutexLock mu(self, lock_);
-  auto it = id_to_entry_.find(id);
-  if (it == id_to_entry_.end()) {
+  ReaderMutexLock mu(self, lock_);
+  ObjectRegistryEntry* entry = FindLocked(id);
+  if (entry == nullptr) {
     *error = JDWP::ERR_INVALID_OBJECT;
     return nullptr;
   }
-  ObjectRegistryEntry& entry = *it->second;
   *error = JDWP::ERR_NONE;
-  return self->DecodeJObject(entry.jni_reference);
+  return self->DecodeJObject(entry->jni_reference);
 }
 
 jobject ObjectRegistry::GetJObject(JDWP::ObjectId id) {
@@ -194,27 +237,26 @@ jobject ObjectRegistry::GetJObject(JDWP::ObjectId id) {
     return nullptr;
   }
   Thread* self = Thread::Current();
-  MutexLock mu(self, lock_);
-  auto it = id_to_entry_.find(id);
-  CHECK(it != id_to_entry_.end()) << id;
-  ObjectRegistryEntry& entry = *it->second;
-  return entry.jni_reference;
+  ReaderMutexLock mu(self, lock_);
+  ObjectRegistryEntry* entry = FindLocked(id);
+  CHECK(entry != nullptr) << id;
+  return entry->jni_reference;
 }
 
 void ObjectRegistry::DisableCollection(JDWP::ObjectId id) {
   Thread* self = Thread::Current();
-  MutexLock mu(self, lock_);
-  auto it = id_to_entry_.find(id);
-  CHECK(it != id_to_entry_.end());
-  Promote(*it->second);
+  WriterMutexLock mu(self, lock_);
+  ObjectRegistryEntry* entry = FindLocked(id);
+  CHECK(entry != nullptr);
+  Promote(*entry);
 }
 
 void ObjectRegistry::EnableCollection(JDWP::ObjectId id) {
   Thread* self = Thread::Current();
-  MutexLock mu(self, lock_);
-  auto it = id_to_entry_.find(id);
-  CHECK(it != id_to_entry_.end());
-  Demote(*it->second);
+  WriterMutexLock mu(self, lock_);
+  ObjectRegistryEntry* entry = FindLocked(id);
+  CHECK(entry != nullptr);
+  Demote(*entry);
 }
 
 void ObjectRegistry::Demote(ObjectRegistryEntry& entry) {
@@ -241,13 +283,12 @@ void ObjectRegistry::Promote(ObjectRegistryEntry& entry) {
 
 bool ObjectRegistry::IsCollected(JDWP::ObjectId id) {
   Thread* self = Thread::Current();
-  MutexLock mu(self, lock_);
-  auto it = id_to_entry_.find(id);
-  CHECK(it != id_to_entry_.end());
-  ObjectRegistryEntry& entry = *it->second;
-  if (entry.jni_reference_type == JNIWeakGlobalRefType) {
+  ReaderMutexLock mu(self, lock_);
+  ObjectRegistryEntry* entry = FindLocked(id);
+  CHECK(entry != nullptr);
+  if (entry->jni_reference_type == JNIWeakGlobalRefType) {
     JNIEnv* env = self->GetJniEnv();
-    return env->IsSameObject(entry.jni_reference, nullptr);  // Has the jweak been collected?
+    return env->IsSameObject(entry->jni_reference, nullptr);  // Has the jweak been collected?
   } else {
     return false;  // We hold a strong reference, so we know this is live.
   }
@@ -255,22 +296,37 @@ bool ObjectRegistry::IsCollected(JDWP::ObjectId id) {
 
 void ObjectRegistry::DisposeObject(JDWP::ObjectId id, uint32_t reference_count) {
   Thread* self = Thread::Current();
-  MutexLock mu(self, lock_);
-  auto it = id_to_entry_.find(id);
-  if (it == id_to_entry_.end()) {
+  WriterMutexLock mu(self, lock_);
+  DisposeObjectLocked(self->GetJniEnv(), id, reference_count);
+  TrimLocked();
+}
+
+void ObjectRegistry::DisposeObjects(
+    const std::vector<std::pair<JDWP::ObjectId, uint32_t>>& objects) {
+  Thread* self = Thread::Current();
+  WriterMutexLock mu(self, lock_);
+  JNIEnv* env = self->GetJniEnv();
+  for (const std::pair<JDWP::ObjectId, uint32_t>& object : objects) {
+    DisposeObjectLocked(env, object.first, object.second);
+  }
+  TrimLocked();
+}
+
+void ObjectRegistry::DisposeObjectLocked(JNIEnv* env,
+                                         JDWP::ObjectId id,
+                                         uint32_t reference_count) {
+  ObjectRegistryEntry* entry = FindLocked(id);
+  if (entry == nullptr) {
     return;
   }
-  ObjectRegistryEntry* entry = it->second;
-  entry->reference_count -= reference_count;
-  if (entry->reference_count <= 0) {
-    JNIEnv* env = self->GetJniEnv();
+  entry->reference_count.fetch_sub(static_cast<int32_t>(reference_count), std::memory_order_relaxed);
+  if (entry->reference_count.load(std::memory_order_relaxed) <= 0) {
     // Erase the object from the maps. Note object may be null if it's
     // a weak ref and the GC has cleared it.
-    int32_t hash_code = entry->identity_hash_code;
-    for (auto inner_it = object_to_entry_.lower_bound(hash_code), end = object_to_entry_.end();
-         inner_it != end && inner_it->first == hash_code; ++inner_it) {
-      if (entry == inner_it->second) {
-        object_to_entry_.erase(inner_it);
+    auto range = object_to_entry_.equal_range(entry->identity_hash_code);
+    for (auto it = range.first; it != range.second; ++it) {
+      if (entry == it->second) {
+        object_to_entry_.erase(it);
         break;
       }
     }
@@ -279,9 +335,22 @@ void ObjectRegistry::DisposeObject(JDWP::ObjectId id, uint32_t reference_count)
     } else {
       env->DeleteGlobalRef(entry->jni_reference);
     }
-    id_to_entry_.erase(id);
+    id_to_entry_[id - first_id_] = nullptr;
     delete entry;
   }
 }
 
+void ObjectRegistry::TrimLocked() {
+  // Drop the disposed slots at the start of the id table once they make up half of it,
+  // so that the cost of moving the live slots is spread over many disposals.
+  size_t disposed = 0u;
+  while (disposed < id_to_entry_.size() && id_to_entry_[disposed] == nullptr) {
+    ++disposed;
+  }
+  if (disposed != 0u && disposed * 2u >= id_to_entry_.size()) {
+    id_to_entry_.erase(id_to_entry_.begin(), id_to_entry_.begin() + disposed);
+    first_id_ += disposed;
+  }
+}
+
 }  // namespace art
@@ -20,10 +20,13 @@
 #include <jni.h>
 #include <stdint.h>
 
-#include <map>
+#include <atomic>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "base/casts.h"
-#include "base/safe_map.h"
+#include "base/mutex.h"
 #include "handle.h"
 #include "jdwp/jdwp.h"
 #include "obj_ptr.h"
@@ -35,6 +38,8 @@ class Object;
 class Class;
 }  // namespace mirror
 
+class ScopedObjectAccessUnchecked;
+
 struct ObjectRegistryEntry {
   // Is jni_reference a weak global or a regular global reference?
   jobjectRefType jni_reference_type;
@@ -42,8 +47,9 @@ struct ObjectRegistryEntry {
   // The reference itself.
   jobject jni_reference;
 
-  // A reference count, so we can implement DisposeObject.
-  int32_t reference_count;
+  // A reference count, so we can implement DisposeObject. Atomic since adding an object
+  // that is already registered only holds the registry lock shared.
+  std::atomic<int32_t> reference_count;
 
   // The corresponding id, so we only need one map lookup in Add.
   JDWP::ObjectId id;
@@ -59,6 +65,10 @@ std::ostream& operator<<(std::ostream& os, const ObjectRegistryEntry& rhs);
 // still be garbage collected. The debugger can ask us to retain objects, though, so we can
 // also promote references to regular JNI global references (and demote them back again if
 // the debugger tells us that's okay).
+//
+// Lookups by id and adding objects that are already registered only hold the registry lock
+// shared, so mutators posting events and the JDWP thread answering queries do not serialize
+// on each other. Ids are handed out sequentially and index a dense table.
 class ObjectRegistry {
  public:
   ObjectRegistry();
@@ -81,6 +91,13 @@ class ObjectRegistry {
       REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(!Locks::thread_list_lock_, !Locks::thread_suspend_count_lock_, !lock_);
 
+  // Add all of `objects` taking the registry lock once, and append their ids to `ids`.
+  // Null objects get id 0.
+  void AddAll(const std::vector<Handle<mirror::Object>>& objects,
+              std::vector<JDWP::ObjectId>* ids)
+      REQUIRES_SHARED(Locks::mutator_lock_)
+      REQUIRES(!Locks::thread_list_lock_, !Locks::thread_suspend_count_lock_, !lock_);
+
   template<typename T>
   ObjPtr<T> Get(JDWP::ObjectId id, JDWP::JdwpError* error)
       REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!lock_);
@@ -99,6 +116,10 @@ class ObjectRegistry {
   void DisposeObject(JDWP::ObjectId id, uint32_t reference_count)
       REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!lock_);
 
+  // Same as DisposeObject for each (id, reference count) pair, taking the registry lock once.
+  void DisposeObjects(const std::vector<std::pair<JDWP::ObjectId, uint32_t>>& objects)
+      REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!lock_);
+
   // This is needed to get the jobject instead of the ObjPtr<Object>.
   // Avoid using this and use standard Get when possible.
   jobject GetJObject(JDWP::ObjectId id) REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!lock_);
@@ -109,9 +130,24 @@ class ObjectRegistry {
       REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(!lock_, !Locks::thread_list_lock_, !Locks::thread_suspend_count_lock_);
 
+  // Add `o`, or take one more reference on it if it is already registered.
+  JDWP::ObjectId AddLocked(const ScopedObjectAccessUnchecked& soa,
+                           ObjPtr<mirror::Object> o,
+                           int32_t identity_hash_code)
+      REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(lock_);
+
   ObjPtr<mirror::Object> InternalGet(JDWP::ObjectId id, JDWP::JdwpError* error)
       REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!lock_);
 
+  // Return the entry for `id`, or null if there is none.
+  ObjectRegistryEntry* FindLocked(JDWP::ObjectId id) REQUIRES_SHARED(lock_);
+
+  void DisposeObjectLocked(JNIEnv* env, JDWP::ObjectId id, uint32_t reference_count)
+      REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(lock_);
+
+  // Drop disposed slots from the start of the id table.
+  void TrimLocked() REQUIRES(lock_);
+
   void Demote(ObjectRegistryEntry& entry)
       REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(lock_);
 
@@ -122,11 +158,15 @@ class ObjectRegistry {
                       ObjPtr<mirror::Object> o,
                       int32_t identity_hash_code,
                       ObjectRegistryEntry** out_entry)
-      REQUIRES(lock_) REQUIRES_SHARED(Locks::mutator_lock_);
+      REQUIRES_SHARED(lock_) REQUIRES_SHARED(Locks::mutator_lock_);
+
+  ReaderWriterMutex lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
+  std::unordered_multimap<int32_t, ObjectRegistryEntry*> object_to_entry_ GUARDED_BY(lock_);
 
-  Mutex lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
-  std::multimap<int32_t, ObjectRegistryEntry*> object_to_entry_ GUARDED_BY(lock_);
-  SafeMap<JDWP::ObjectId, ObjectRegistryEntry*> id_to_entry_ GUARDED_BY(lock_);
+  // Entries indexed by `id - first_id_`. Disposed entries leave a null slot, as ids are
+  // never reused.
+  std::vector<ObjectRegistryEntry*> id_to_entry_ GUARDED_BY(lock_);
+  JDWP::ObjectId first_id_ GUARDED_BY(lock_);
 
   size_t next_id_ GUARDED_BY(lock_);
 };
@@ -294,6 +294,10 @@ static void MaybePackJitMiniDebugInfo(PackElfFileForJITFunction pack,
   constexpr uint32_t kGroupSize = 64 * KB;
   // Even if there are no removed entries, we want to pack new entries on regular basis.
   constexpr uint32_t kPackFrequency = 64;
+  // Packing compresses the symbols of each group and runs on the JIT thread while it adds the
+  // debug info of a new method. Stop once this much time is spent, the remaining groups are
+  // packed by the next calls.
+  constexpr uint64_t kPackTimeBudgetNs = MsToNs(5);
 
   std::deque<const void*>& removed_entries = g_jit_removed_entries;
   std::sort(removed_entries.begin(), removed_entries.end());
@@ -305,7 +309,13 @@ static void MaybePackJitMiniDebugInfo(PackElfFileForJITFunction pack,
   std::vector<const void*> removed_symbols;
   auto added_it = g_jit_debug_entries.begin();
   auto removed_it = removed_entries.begin();
+  const uint64_t pack_start_ns = NanoTime();
+  bool out_of_budget = false;
   while (added_it != g_jit_debug_entries.end()) {
+    if (NanoTime() - pack_start_ns > kPackTimeBudgetNs) {
+      out_of_budget = true;
+      break;
+    }
     // Collect all entries that have been added or removed within our memory range.
     const void* group_ptr = AlignDown(added_it->first, kGroupSize);
     added_elf_files.clear();
@@ -352,6 +362,14 @@ static void MaybePackJitMiniDebugInfo(PackElfFileForJITFunction pack,
     g_jit_debug_entries.erase(added_begin, added_it);
     g_jit_debug_entries.emplace(group_ptr, packed_entry);
   }
+  if (out_of_budget) {
+    // Keep the removals of the groups not visited, and the count of unpacked entries so that
+    // the next call resumes packing. The groups already packed are skipped quickly.
+    removed_entries.erase(removed_entries.begin(), removed_it);
+    VLOG(jit) << "JIT mini-debug-info packing postponed, "
+              << removed_entries.size() << " removed entries left";
+    return;
+  }
   CHECK(added_it == g_jit_debug_entries.end());
   CHECK(removed_it == removed_entries.end());
   removed_entries.clear();
@@ -19,17 +19,25 @@
 #include <dlfcn.h>
 
 #include "art_method-inl.h"
+#include "base/callee_save_type.h"
+#include "base/casts.h"
 #include "base/enums.h"
 #include "base/file_utils.h"
 #include "base/logging.h"  // For VLOG.
 #include "base/memory_tool.h"
 #include "base/runtime_debug.h"
 #include "base/scoped_flock.h"
+#include "base/stl_util.h"
+#include "base/time_utils.h"
 #include "base/utils.h"
+#include "class_loader_utils.h"
 #include "class_root.h"
 #include "debugger.h"
+#include "dex/dex_file_loader.h"
 #include "dex/type_lookup_table.h"
 #include "entrypoints/runtime_asm_entrypoints.h"
+#include "flight_recorder.h"
+#include "handle_scope-inl.h"
 #include "interpreter/interpreter.h"
 #include "jit-inl.h"
 #include "jit_code_cache.h"
@@ -41,6 +49,7 @@
 #include "oat_quick_method_header.h"
 #include "profile/profile_compilation_info.h"
 #include "profile_saver.h"
+#include "runtime-inl.h"
 #include "runtime.h"
 #include "runtime_options.h"
 #include "stack.h"
@@ -58,6 +67,10 @@ static constexpr size_t kJitDefaultCompileThreshold           = 10000;  // Non-d
 static constexpr size_t kJitStressDefaultCompileThreshold     = 100;    // Fast-debug build.
 static constexpr size_t kJitSlowStressDefaultCompileThreshold = 2;      // Slow-debug build.
 
+// With tiered compilation, how many sample batches to see between checks for the baseline
+// compiled methods to optimize.
+static constexpr uint32_t kJitOptimizeCheckBatches = 256;
+
 // JIT compiler
 void* Jit::jit_library_handle_ = nullptr;
 void* Jit::jit_compiler_handle_ = nullptr;
@@ -67,6 +80,8 @@ bool (*Jit::jit_compile_method_)(void*, ArtMethod*, Thread*, bool, bool) = nullp
 void (*Jit::jit_types_loaded_)(void*, mirror::Class**, size_t count) = nullptr;
 bool (*Jit::jit_generate_debug_info_)(void*) = nullptr;
 void (*Jit::jit_update_options_)(void*) = nullptr;
+void (*Jit::jit_code_deoptimized_)(void*, const void*, uint32_t) = nullptr;
+void (*Jit::jit_code_unloaded_)(void*, const void*) = nullptr;
 
 struct StressModeHelper {
   DECLARE_RUNTIME_DEBUG_FLAG(kSlowMode);
@@ -91,10 +106,18 @@ JitOptions* JitOptions::CreateFromRuntimeArguments(const RuntimeArgumentMap& opt
       options.GetOrDefault(RuntimeArgumentMap::JITCodeCacheMaxCapacity);
   jit_options->dump_info_on_shutdown_ =
       options.Exists(RuntimeArgumentMap::DumpJITInfoOnShutdown);
+  jit_options->perf_profiling_ = options.Exists(RuntimeArgumentMap::JITPerfProfiling);
   jit_options->profile_saver_options_ =
       options.GetOrDefault(RuntimeArgumentMap::ProfileSaverOpts);
   jit_options->thread_pool_pthread_priority_ =
       options.GetOrDefault(RuntimeArgumentMap::JITPoolThreadPthreadPriority);
+  jit_options->warmup_trace_file_ =
+      options.GetOrDefault(RuntimeArgumentMap::JITWarmupTraceFile);
+  jit_options->thread_pool_thread_count_ =
+      options.GetOrDefault(RuntimeArgumentMap::JITPoolThreadCount);
+  if (jit_options->thread_pool_thread_count_ == 0) {
+    LOG(FATAL) << "JIT thread pool cannot have 0 threads.";
+  }
 
   if (options.Exists(RuntimeArgumentMap::JITCompileThreshold)) {
     jit_options->compile_threshold_ = *options.Get(RuntimeArgumentMap::JITCompileThreshold);
@@ -126,6 +149,22 @@ JitOptions* JitOptions::CreateFromRuntimeArguments(const RuntimeArgumentMap& opt
   }
   jit_options->osr_threshold_ = RoundUpThreshold(jit_options->osr_threshold_);
 
+  // Finding the baseline compiled methods to optimize relies on the read barrier GC state to
+  // not race with class unloading.
+  jit_options->use_tiered_jit_compilation_ =
+      kUseReadBarrier && options.GetOrDefault(RuntimeArgumentMap::JITUseTieredCompilation);
+  jit_options->precompile_hot_methods_ =
+      options.GetOrDefault(RuntimeArgumentMap::JITPrecompileHotMethods);
+  if (options.Exists(RuntimeArgumentMap::JITOptimizeThreshold)) {
+    jit_options->optimize_threshold_ = *options.Get(RuntimeArgumentMap::JITOptimizeThreshold);
+    if (jit_options->optimize_threshold_ > std::numeric_limits<uint16_t>::max()) {
+      LOG(FATAL) << "Method optimization threshold is above its internal limit.";
+    }
+  } else {
+    // Baseline compiled code counts method entries and back edges like the interpreter does.
+    jit_options->optimize_threshold_ = jit_options->compile_threshold_;
+  }
+
   if (options.Exists(RuntimeArgumentMap::JITPriorityThreadWeight)) {
     jit_options->priority_thread_weight_ =
         *options.Get(RuntimeArgumentMap::JITPriorityThreadWeight);
@@ -162,6 +201,11 @@ void Jit::DumpInfo(std::ostream& os) {
   cumulative_timings_.Dump(os);
   MutexLock mu(Thread::Current(), lock_);
   memory_use_.PrintMemoryUse(os);
+  if (compile_perf_counters_.cycles != 0u) {
+    os << "JIT compilation hardware events: ";
+    compile_perf_counters_.Dump(os);
+    os << "\n";
+  }
 }
 
 void Jit::DumpForSigQuit(std::ostream& os) {
@@ -178,7 +222,9 @@ Jit::Jit(JitCodeCache* code_cache, JitOptions* options)
       options_(options),
       cumulative_timings_("JIT timings"),
       memory_use_("Memory used for compilation", 16),
-      lock_("JIT memory use lock") {}
+      lock_("JIT memory use lock"),
+      batches_since_optimize_check_(0),
+      optimize_check_pending_(false) {}
 
 Jit* Jit::Create(JitCodeCache* code_cache, JitOptions* options) {
   if (jit_load_ == nullptr) {
@@ -191,6 +237,9 @@ Jit* Jit::Create(JitCodeCache* code_cache, JitOptions* options) {
     return nullptr;
   }
   std::unique_ptr<Jit> jit(new Jit(code_cache, options));
+  if (!options->GetWarmupTraceFile().empty()) {
+    jit->warmup_trace_.reset(new JitWarmupTrace());
+  }
 
   // If the code collector is enabled, check if that still holds:
   // With 'perf', we want a 1-1 mapping between an address and a method.
@@ -239,6 +288,9 @@ bool Jit::LoadCompilerLibrary(std::string* error_msg) {
   all_resolved = all_resolved && LoadSymbol(&jit_update_options_, "jit_update_options", error_msg);
   all_resolved = all_resolved &&
       LoadSymbol(&jit_generate_debug_info_, "jit_generate_debug_info", error_msg);
+  all_resolved = all_resolved &&
+      LoadSymbol(&jit_code_deoptimized_, "jit_code_deoptimized", error_msg);
+  all_resolved = all_resolved && LoadSymbol(&jit_code_unloaded_, "jit_code_unloaded", error_msg);
   if (!all_resolved) {
     dlclose(jit_library_handle_);
     return false;
@@ -269,15 +321,53 @@ bool Jit::CompileMethod(ArtMethod* method, Thread* self, bool baseline, bool osr
   // If we get a request to compile a proxy method, we pass the actual Java method
   // of that proxy method, as the compiler does not expect a proxy method.
   ArtMethod* method_to_compile = method->GetInterfaceMethodIfProxy(kRuntimePointerSize);
-  if (!code_cache_->NotifyCompilationOf(method_to_compile, self, osr, prejit)) {
+  if (!code_cache_->NotifyCompilationOf(method_to_compile, self, osr, prejit, baseline)) {
     return false;
   }
 
+  JitWarmupTrace::Tier tier = osr
+      ? JitWarmupTrace::Tier::kOsr
+      : (baseline ? JitWarmupTrace::Tier::kBaseline : JitWarmupTrace::Tier::kOptimized);
+  RecordWarmupEvent(JitWarmupTrace::Event::kCompileStart, tier, method_to_compile);
+
   VLOG(jit) << "Compiling method "
             << ArtMethod::PrettyMethod(method_to_compile)
-            << " osr=" << std::boolalpha << osr;
+            << " osr=" << std::boolalpha << osr
+            << " baseline=" << std::boolalpha << baseline;
+  PerfCounters perf_counters;
+  PerfCounterValues perf_counters_start;
+  bool count_perf_events = false;
+  if (UNLIKELY(Runtime::Current()->UsePerfCounters())) {
+    std::string error_msg;
+    count_perf_events = perf_counters.Open(&error_msg) && perf_counters.Read(&perf_counters_start);
+    if (!count_perf_events) {
+      VLOG(jit) << "Not counting hardware events: " << error_msg;
+    }
+  }
+  FlightRecorder* flight_recorder = Runtime::Current()->GetFlightRecorder();
+  uint64_t start_ns = (flight_recorder != nullptr) ? NanoTime() : 0u;
   bool success = jit_compile_method_(jit_compiler_handle_, method_to_compile, self, baseline, osr);
-  code_cache_->DoneCompiling(method_to_compile, self, osr);
+  if (flight_recorder != nullptr) {
+    uint32_t flags = (success ? FlightRecorder::kJitCompileSuccess : 0u) |
+        (osr ? FlightRecorder::kJitCompileOsr : 0u) |
+        (baseline ? FlightRecorder::kJitCompileBaseline : 0u);
+    flight_recorder->Record(self,
+                            FlightRecorder::EventType::kJitCompile,
+                            start_ns,
+                            NanoTime() - start_ns,
+                            flags,
+                            method_to_compile->PrettyMethod(/* with_signature= */ false).c_str());
+  }
+  PerfCounterValues perf_counters_end;
+  if (count_perf_events && perf_counters.Read(&perf_counters_end)) {
+    MutexLock mu(self, lock_);
+    compile_perf_counters_ += perf_counters_end - perf_counters_start;
+  }
+  code_cache_->DoneCompiling(method_to_compile, self, osr, baseline, success);
+  RecordWarmupEvent(
+      success ? JitWarmupTrace::Event::kCompileEnd : JitWarmupTrace::Event::kCompileFailed,
+      tier,
+      method_to_compile);
   if (!success) {
     VLOG(jit) << "Failed to compile method "
               << ArtMethod::PrettyMethod(method_to_compile)
@@ -330,6 +420,12 @@ void Jit::StartProfileSaver(const std::string& filename,
   if (options_->GetSaveProfilingInfo()) {
     ProfileSaver::Start(options_->GetProfileSaverOptions(), filename, code_cache_, code_paths);
   }
+  if (options_->PrecompileHotMethods() &&
+      UseJitCompilation() &&
+      thread_pool_ != nullptr &&
+      !filename.empty()) {
+    thread_pool_->AddTask(Thread::Current(), new AppProfileTask(filename, code_paths));
+  }
 }
 
 void Jit::StopProfileSaver() {
@@ -353,6 +449,12 @@ Jit::~Jit() {
     Runtime::Current()->DumpDeoptimizations(LOG_STREAM(INFO));
   }
   DeleteThreadPool();
+  if (warmup_trace_ != nullptr) {
+    std::string error_msg;
+    if (!warmup_trace_->WriteToFile(options_->GetWarmupTraceFile(), &error_msg)) {
+      LOG(WARNING) << "Failed to write the JIT warmup trace: " << error_msg;
+    }
+  }
   if (jit_compiler_handle_ != nullptr) {
     jit_unload_(jit_compiler_handle_);
     jit_compiler_handle_ = nullptr;
@@ -375,6 +477,18 @@ void Jit::NewTypeLoadedIfUsingJit(mirror::Class* type) {
   }
 }
 
+void Jit::NotifyCodeDeoptimized(const void* code_ptr, DeoptimizationKind kind) {
+  if (jit_compiler_handle_ != nullptr) {
+    jit_code_deoptimized_(jit_compiler_handle_, code_ptr, static_cast<uint32_t>(kind));
+  }
+}
+
+void Jit::NotifyCodeUnloaded(const void* code_ptr) {
+  if (jit_compiler_handle_ != nullptr) {
+    jit_code_unloaded_(jit_compiler_handle_, code_ptr);
+  }
+}
+
 void Jit::DumpTypeInfoForLoadedTypes(ClassLinker* linker) {
   struct CollectClasses : public ClassVisitor {
     bool operator()(ObjPtr<mirror::Class> klass) override REQUIRES_SHARED(Locks::mutator_lock_) {
@@ -554,7 +668,22 @@ void Jit::AddMemoryUsage(ArtMethod* method, size_t bytes) {
   memory_use_.AddValue(bytes);
 }
 
-class JitCompileTask final : public Task {
+// A task of the JIT thread pool, which runs the task with the highest priority first.
+class JitTask : public Task {
+ public:
+  static constexpr uint32_t kMaxPriority = std::numeric_limits<uint32_t>::max();
+
+  // Called with the queue lock of the pool held, so this must be cheap and must not take locks.
+  virtual uint32_t GetPriority() const = 0;
+
+  // Whether running the task became useless since it was added. The pool hands out stale tasks
+  // first so that they leave the queue quickly, and their Run() does nothing.
+  virtual bool IsStale() const {
+    return false;
+  }
+};
+
+class JitCompileTask final : public JitTask {
  public:
   enum class TaskKind {
     kAllocateProfile,
@@ -581,28 +710,81 @@ class JitCompileTask final : public Task {
     }
   }
 
-  void Run(Thread* self) override {
-    ScopedObjectAccess soa(self);
+  // The pool reads the method state without the mutator lock: the values are only hints, and
+  // the method stays alive while the task holds its declaring class.
+  uint32_t GetPriority() const override NO_THREAD_SAFETY_ANALYSIS {
     switch (kind_) {
+      case TaskKind::kAllocateProfile:
+        // Cheap, and the inline caches are only collected once the profiling info exists.
+        return kMaxPriority;
+      case TaskKind::kCompileOsr:
+        // The method is looping in the interpreter right now.
+        return kMaxPriority - 1;
+      case TaskKind::kCompile:
+      case TaskKind::kCompileBaseline:
+        // The interpreter keeps counting samples while the method waits in the queue.
+        return method_->GetCounter();
       case TaskKind::kPreCompile:
+        return 0;
+    }
+    UNREACHABLE();
+  }
+
+  bool IsStale() const override NO_THREAD_SAFETY_ANALYSIS {
+    Jit* jit = Runtime::Current()->GetJit();
+    switch (kind_) {
+      case TaskKind::kAllocateProfile:
+        return method_->GetProfilingInfo(kRuntimePointerSize) != nullptr;
       case TaskKind::kCompile:
+        // With tiered compilation, optimized code replaces baseline code.
+        if (jit->UseTieredJitCompilation()) {
+          return false;
+        }
+        FALLTHROUGH_INTENDED;
       case TaskKind::kCompileBaseline:
-      case TaskKind::kCompileOsr: {
-        Runtime::Current()->GetJit()->CompileMethod(
-            method_,
-            self,
-            /* baseline= */ (kind_ == TaskKind::kCompileBaseline),
-            /* osr= */ (kind_ == TaskKind::kCompileOsr),
-            /* prejit= */ (kind_ == TaskKind::kPreCompile));
-        break;
+        return jit->GetCodeCache()->ContainsPc(method_->GetEntryPointFromQuickCompiledCode());
+      case TaskKind::kCompileOsr:
+      case TaskKind::kPreCompile:
+        return false;
+    }
+    UNREACHABLE();
+  }
+
+  void Run(Thread* self) override {
+    Jit* jit = Runtime::Current()->GetJit();
+    bool osr_compiled = false;
+    {
+      ScopedObjectAccess soa(self);
+      if (IsStale()) {
+        return;
       }
-      case TaskKind::kAllocateProfile: {
-        if (ProfilingInfo::Create(self, method_, /* retry_allocation= */ true)) {
-          VLOG(jit) << "Start profiling " << ArtMethod::PrettyMethod(method_);
+      switch (kind_) {
+        case TaskKind::kPreCompile:
+        case TaskKind::kCompile:
+        case TaskKind::kCompileBaseline:
+        case TaskKind::kCompileOsr: {
+          bool success = jit->CompileMethod(
+              method_,
+              self,
+              /* baseline= */ (kind_ == TaskKind::kCompileBaseline),
+              /* osr= */ (kind_ == TaskKind::kCompileOsr),
+              /* prejit= */ (kind_ == TaskKind::kPreCompile));
+          osr_compiled = success && (kind_ == TaskKind::kCompileOsr);
+          break;
+        }
+        case TaskKind::kAllocateProfile: {
+          if (ProfilingInfo::Create(self, method_, /* retry_allocation= */ true)) {
+            VLOG(jit) << "Start profiling " << ArtMethod::PrettyMethod(method_);
+          }
+          break;
         }
-        break;
       }
     }
+    if (osr_compiled && jit->UseTieredJitCompilation()) {
+      // Make the threads looping in the baseline compiled code of the method go through a
+      // suspend check, where they move to the OSR compiled code.
+      Runtime::Current()->GetThreadList()->RunEmptyCheckpoint();
+    }
     ProfileSaver::NotifyJitActivity();
   }
 
@@ -618,10 +800,159 @@ class JitCompileTask final : public Task {
   DISALLOW_IMPLICIT_CONSTRUCTORS(JitCompileTask);
 };
 
-class ZygoteTask final : public Task {
+class OptimizeBaselineMethodsTask final : public JitTask {
+ public:
+  OptimizeBaselineMethodsTask() {}
+
+  uint32_t GetPriority() const override {
+    return kMaxPriority;
+  }
+
+  void Run(Thread* self) override {
+    Jit* jit = Runtime::Current()->GetJit();
+    bool enqueued = false;
+    {
+      ScopedObjectAccess soa(self);
+      jit->optimize_check_pending_.store(false, std::memory_order_relaxed);
+      enqueued = jit->EnqueueOptimizedCompilations(self);
+    }
+    if (enqueued) {
+      // A thread looping in the baseline compiled code of a hot method only finds out about it
+      // in a suspend check, where it queues the OSR compilation of the loop.
+      Runtime::Current()->GetThreadList()->RunEmptyCheckpoint();
+    }
+  }
+
+  void Finalize() override {
+    delete this;
+  }
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(OptimizeBaselineMethodsTask);
+};
+
+bool Jit::EnqueueOptimizedCompilations(Thread* self) {
+  std::vector<ArtMethod*> methods;
+  code_cache_->GetBaselineMethodsToOptimize(self, OptimizeMethodThreshold(), &methods);
+  // No suspension point until the tasks hold the declaring classes of the methods.
+  for (ArtMethod* method : methods) {
+    VLOG(jit) << "Optimizing baseline compiled " << method->PrettyMethod();
+    thread_pool_->AddTask(self, new JitCompileTask(method, JitCompileTask::TaskKind::kCompile));
+    RecordWarmupEvent(
+        JitWarmupTrace::Event::kEnqueued, JitWarmupTrace::Tier::kOptimized, method);
+  }
+  return !methods.empty();
+}
+
+// Return whether `dex_pc` is the target of a back edge of the method.
+static bool IsLoopHeader(const CodeItemDataAccessor& accessor, uint32_t dex_pc) {
+  for (const DexInstructionPcPair& inst : accessor) {
+    if (inst->IsBranch()) {
+      int32_t offset = inst->GetTargetOffset();
+      if (offset <= 0 && inst.DexPc() + offset == dex_pc) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+bool Jit::ShouldLeaveBaselineLoop(Thread* self) {
+  if (!kEnableOnStackReplacement || !UseTieredJitCompilation() || thread_pool_ == nullptr) {
+    return false;
+  }
+
+  if (UNLIKELY(__builtin_frame_address(0) < self->GetStackEnd())) {
+    // Like for MaybeDoOnStackReplacement, the interpreter frame could overflow the stack.
+    return false;
+  }
+
+  // Find the compiled frame doing the suspend check. Only the suspend check entrypoint saves
+  // all the registers that deoptimizing the frame needs.
+  ArtMethod* suspend_check_method =
+      Runtime::Current()->GetCalleeSaveMethod(CalleeSaveType::kSaveEverythingForSuspendCheck);
+  bool from_suspend_check = false;
+  ArtMethod* method = nullptr;
+  const OatQuickMethodHeader* method_header = nullptr;
+  uint32_t dex_pc = dex::kDexNoIndex;
+  StackVisitor::WalkStack(
+      [&](const StackVisitor* visitor) REQUIRES_SHARED(Locks::mutator_lock_) {
+        ArtMethod* m = visitor->GetMethod();
+        if (m->IsRuntimeMethod()) {
+          from_suspend_check = (m == suspend_check_method);
+          return from_suspend_check;
+        }
+        if (!visitor->IsShadowFrame() && !visitor->IsInInlinedFrame()) {
+          method = m;
+          method_header = visitor->GetCurrentOatQuickMethodHeader();
+          dex_pc = visitor->GetDexPc(/* abort_on_failure= */ false);
+        }
+        return false;
+      },
+      self,
+      /* context= */ nullptr,
+      StackVisitor::StackWalkKind::kIncludeInlinedFrames);
+  if (!from_suspend_check ||
+      method == nullptr ||
+      method_header == nullptr ||
+      dex_pc == dex::kDexNoIndex ||
+      !code_cache_->ContainsPc(method_header->GetCode())) {
+    return false;
+  }
+
+  // With tiered compilation, JIT code that is not the OSR code nor the current optimized code
+  // of the method is baseline code.
+  const OatQuickMethodHeader* osr_method = code_cache_->LookupOsrMethodHeader(method);
+  if (method_header == osr_method) {
+    return false;
+  }
+  if (method_header->GetEntryPoint() == method->GetEntryPointFromQuickCompiledCode()) {
+    ProfilingInfo* info = method->GetProfilingInfo(kRuntimePointerSize);
+    if (info == nullptr || !info->IsBaselineCompiled()) {
+      return false;
+    }
+  }
+
+  if (osr_method == nullptr) {
+    CodeItemDataAccessor accessor(method->DexInstructionData());
+    if (IsLoopHeader(accessor, dex_pc)) {
+      VLOG(jit) << "Compiling the baseline compiled loop of " << method->PrettyMethod()
+                << "@" << dex_pc << " for OSR";
+      thread_pool_->AddTask(self,
+                            new JitCompileTask(method, JitCompileTask::TaskKind::kCompileOsr));
+      RecordWarmupEvent(JitWarmupTrace::Event::kEnqueued, JitWarmupTrace::Tier::kOsr, method);
+    }
+    return false;
+  }
+
+  {
+    ScopedAssertNoThreadSuspension sts("Holding OSR method");
+    // The OSR method may have been collected since the lookup.
+    osr_method = code_cache_->LookupOsrMethodHeader(method);
+    if (osr_method == nullptr ||
+        !CodeInfo(osr_method).GetOsrStackMapForDexPc(dex_pc).IsValid()) {
+      return false;
+    }
+  }
+
+  // Like for MaybeDoOnStackReplacement, do not move to OSR code while e.g. single stepping.
+  if (Runtime::Current()->GetRuntimeCallbacks()->IsMethodBeingInspected(method)) {
+    return false;
+  }
+
+  VLOG(jit) << "Leaving the baseline compiled loop of " << method->PrettyMethod()
+            << "@" << dex_pc << " for OSR";
+  return true;
+}
+
+class ZygoteTask final : public JitTask {
  public:
   ZygoteTask() {}
 
+  uint32_t GetPriority() const override {
+    return 0;
+  }
+
   void Run(Thread* self) override {
     Runtime* runtime = Runtime::Current();
     std::string profile_file;
@@ -638,7 +969,12 @@ class ZygoteTask final : public Task {
     // We add to the queue for zygote so that we can fork processes in-between
     // compilations.
     runtime->GetJit()->CompileMethodsFromProfile(
-        self, boot_class_path, profile_file, null_handle, /* add_to_queue= */ true);
+        self,
+        boot_class_path,
+        profile_file,
+        null_handle,
+        /* add_to_queue= */ true,
+        /* hot_methods_only= */ false);
   }
 
   void Finalize() override {
@@ -657,7 +993,7 @@ static std::string GetProfileFile(const std::string& dex_location) {
   return dex_location + ".prof";
 }
 
-class JitProfileTask final : public Task {
+class JitProfileTask final : public JitTask {
  public:
   JitProfileTask(const std::vector<std::unique_ptr<const DexFile>>& dex_files,
                  ObjPtr<mirror::ClassLoader> class_loader) {
@@ -672,6 +1008,10 @@ class JitProfileTask final : public Task {
     class_loader_ = soa.Vm()->AddGlobalRef(soa.Self(), class_loader.Ptr());
   }
 
+  uint32_t GetPriority() const override {
+    return 0;
+  }
+
   void Run(Thread* self) override {
     ScopedObjectAccess soa(self);
     StackHandleScope<1> hs(self);
@@ -682,7 +1022,8 @@ class JitProfileTask final : public Task {
         dex_files_,
         GetProfileFile(dex_files_[0]->GetLocation()),
         loader,
-        /* add_to_queue= */ false);
+        /* add_to_queue= */ false,
+        /* hot_methods_only= */ false);
   }
 
   void Finalize() override {
@@ -696,13 +1037,126 @@ class JitProfileTask final : public Task {
   DISALLOW_COPY_AND_ASSIGN(JitProfileTask);
 };
 
+// Takes a snapshot of the class loaders, see GetClassLoadersVisitor in profile_saver.cc.
+class CollectClassLoadersVisitor : public ClassLoaderVisitor {
+ public:
+  CollectClassLoadersVisitor(VariableSizedHandleScope* hs,
+                             std::vector<Handle<mirror::ClassLoader>>* class_loaders)
+      : hs_(hs),
+        class_loaders_(class_loaders) {}
+
+  void Visit(ObjPtr<mirror::ClassLoader> class_loader)
+      REQUIRES_SHARED(Locks::classlinker_classes_lock_, Locks::mutator_lock_) override {
+    class_loaders_->push_back(hs_->NewHandle(class_loader));
+  }
+
+ private:
+  VariableSizedHandleScope* const hs_;
+  std::vector<Handle<mirror::ClassLoader>>* const class_loaders_;
+};
+
+// Compiles the hot methods recorded in the profile of a previous run of the app, so that
+// they reach optimized code without going through interpretation and warmup again.
+class AppProfileTask final : public JitTask {
+ public:
+  AppProfileTask(const std::string& profile_file, const std::vector<std::string>& code_paths)
+      : profile_file_(profile_file),
+        code_paths_(code_paths) {}
+
+  uint32_t GetPriority() const override {
+    return 0;
+  }
+
+  void Run(Thread* self) override {
+    ScopedObjectAccess soa(self);
+    VariableSizedHandleScope hs(self);
+    std::vector<Handle<mirror::ClassLoader>> class_loaders;
+    ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
+    {
+      ReaderMutexLock mu(self, *Locks::classlinker_classes_lock_);
+      CollectClassLoadersVisitor visitor(&hs, &class_loaders);
+      class_linker->VisitClassLoaders(&visitor);
+    }
+    for (Handle<mirror::ClassLoader> class_loader : class_loaders) {
+      if (!IsPathOrDexClassLoader(soa, class_loader) &&
+          !IsDelegateLastClassLoader(soa, class_loader)) {
+        continue;
+      }
+      std::vector<const DexFile*> dex_files;
+      VisitClassLoaderDexFiles(soa,
+                               class_loader,
+                               [&](const DexFile* dex_file) REQUIRES_SHARED(Locks::mutator_lock_) {
+        std::string location = DexFileLoader::GetBaseLocation(dex_file->GetLocation());
+        if (ContainsElement(code_paths_, location)) {
+          dex_files.push_back(dex_file);
+        }
+        return true;
+      });
+      if (!dex_files.empty()) {
+        Runtime::Current()->GetJit()->CompileMethodsFromProfile(
+            self,
+            dex_files,
+            profile_file_,
+            class_loader,
+            /* add_to_queue= */ true,
+            /* hot_methods_only= */ true);
+      }
+    }
+  }
+
+  void Finalize() override {
+    delete this;
+  }
+
+ private:
+  const std::string profile_file_;
+  const std::vector<std::string> code_paths_;
+
+  DISALLOW_COPY_AND_ASSIGN(AppProfileTask);
+};
+
+// The JIT thread pool. Only JitTasks get added to it.
+class JitThreadPool final : public ThreadPool {
+ public:
+  JitThreadPool(size_t num_threads, bool create_peers)
+      : ThreadPool("Jit thread pool", num_threads, create_peers) {}
+
+ protected:
+  // Hand out the task with the highest priority, the oldest one among equals. Priorities change
+  // while tasks wait in the queue, so scan the queue instead of keeping it sorted. The scan is
+  // cheap compared to a compilation.
+  Task* TryGetTaskLocked() override REQUIRES(task_queue_lock_) {
+    if (!HasOutstandingTasks()) {
+      return nullptr;
+    }
+    auto best = tasks_.begin();
+    uint32_t best_priority = 0;
+    for (auto it = tasks_.begin(); it != tasks_.end(); ++it) {
+      JitTask* task = down_cast<JitTask*>(*it);
+      if (task->IsStale()) {
+        best = it;
+        break;
+      }
+      uint32_t priority = task->GetPriority();
+      if (priority > best_priority) {
+        best = it;
+        best_priority = priority;
+      }
+    }
+    Task* task = *best;
+    tasks_.erase(best);
+    return task;
+  }
+};
+
 void Jit::CreateThreadPool() {
   // There is a DCHECK in the 'AddSamples' method to ensure the tread pool
   // is not null when we instrument.
 
   // We need peers as we may report the JIT thread, e.g., in the debugger.
   constexpr bool kJitPoolNeedsPeers = true;
-  thread_pool_.reset(new ThreadPool("Jit thread pool", 1, kJitPoolNeedsPeers));
+  thread_pool_.reset(
+      new JitThreadPool(options_->GetThreadPoolThreadCount(), kJitPoolNeedsPeers));
 
   thread_pool_->SetPthreadPriority(options_->GetThreadPoolPthreadPriority());
   Start();
@@ -731,7 +1185,8 @@ void Jit::CompileMethodsFromProfile(
     const std::vector<const DexFile*>& dex_files,
     const std::string& profile_file,
     Handle<mirror::ClassLoader> class_loader,
-    bool add_to_queue) {
+    bool add_to_queue,
+    bool hot_methods_only) {
 
   if (profile_file.empty()) {
     LOG(WARNING) << "Expected a profile file in JIT zygote mode";
@@ -773,11 +1228,13 @@ void Jit::CompileMethodsFromProfile(
 
     std::set<dex::TypeIndex> class_types;
     std::set<uint16_t> all_methods;
+    std::set<uint16_t> other_methods;
+    std::set<uint16_t>* non_hot_methods = hot_methods_only ? &other_methods : &all_methods;
     if (!profile_info.GetClassesAndMethods(*dex_file,
                                            &class_types,
                                            &all_methods,
-                                           &all_methods,
-                                           &all_methods)) {
+                                           non_hot_methods,
+                                           non_hot_methods)) {
       // This means the profile file did not reference the dex file, which is the case
       // if there's no classes and methods of that dex file in the profile.
       continue;
@@ -796,6 +1253,12 @@ void Jit::CompileMethodsFromProfile(
         continue;
       }
       const void* entry_point = method->GetEntryPointFromQuickCompiledCode();
+      if (hot_methods_only && class_linker->IsQuickResolutionStub(entry_point)) {
+        // Static methods of classes not yet initialized keep the resolution stub, and the
+        // code cache only stashes the compiled code of those for the zygote. Leave them to
+        // the regular hotness counting.
+        continue;
+      }
       if (class_linker->IsQuickToInterpreterBridge(entry_point) ||
           class_linker->IsQuickGenericJniStub(entry_point) ||
           class_linker->IsQuickResolutionStub(entry_point)) {
@@ -861,6 +1324,9 @@ bool Jit::MaybeCompileMethod(Thread* self,
   DCHECK_GE(PriorityThreadWeight(), 1);
   DCHECK_LE(PriorityThreadWeight(), HotMethodThreshold());
 
+  if (old_count == 0) {
+    RecordWarmupEvent(JitWarmupTrace::Event::kFirstSample, JitWarmupTrace::Tier::kNone, method);
+  }
   if (old_count < WarmMethodThreshold() && new_count >= WarmMethodThreshold()) {
     // Note: Native method have no "warm" state or profiling info.
     if (!method->IsNative() && method->GetProfilingInfo(kRuntimePointerSize) == nullptr) {
@@ -893,11 +1359,27 @@ bool Jit::MaybeCompileMethod(Thread* self,
       return true;
     }
     if (old_count < HotMethodThreshold() && new_count >= HotMethodThreshold()) {
+      RecordWarmupEvent(JitWarmupTrace::Event::kHot, JitWarmupTrace::Tier::kNone, method);
       if (!code_cache_->ContainsPc(method->GetEntryPointFromQuickCompiledCode())) {
         DCHECK(thread_pool_ != nullptr);
-        thread_pool_->AddTask(self, new JitCompileTask(method, JitCompileTask::TaskKind::kCompile));
+        JitCompileTask::TaskKind kind = UseTieredJitCompilation()
+            ? JitCompileTask::TaskKind::kCompileBaseline
+            : JitCompileTask::TaskKind::kCompile;
+        thread_pool_->AddTask(self, new JitCompileTask(method, kind));
+        RecordWarmupEvent(JitWarmupTrace::Event::kEnqueued,
+                          UseTieredJitCompilation() ? JitWarmupTrace::Tier::kBaseline
+                                                    : JitWarmupTrace::Tier::kOptimized,
+                          method);
       }
     }
+    if (UseTieredJitCompilation() &&
+        batches_since_optimize_check_.fetch_add(1, std::memory_order_relaxed) %
+            kJitOptimizeCheckBatches == 0 &&
+        !optimize_check_pending_.exchange(true, std::memory_order_relaxed)) {
+      // Baseline compiled code only bumps the hotness counter; have a JIT thread look for the
+      // methods which got hot enough to be optimized.
+      thread_pool_->AddTask(self, new OptimizeBaselineMethodsTask());
+    }
     if (old_count < OSRMethodThreshold() && new_count >= OSRMethodThreshold()) {
       if (!with_backedges) {
         return false;
@@ -907,6 +1389,7 @@ bool Jit::MaybeCompileMethod(Thread* self,
         DCHECK(thread_pool_ != nullptr);
         thread_pool_->AddTask(
             self, new JitCompileTask(method, JitCompileTask::TaskKind::kCompileOsr));
+        RecordWarmupEvent(JitWarmupTrace::Event::kEnqueued, JitWarmupTrace::Tier::kOsr, method);
       }
     }
   }
@@ -17,11 +17,15 @@
 #ifndef ART_RUNTIME_JIT_JIT_H_
 #define ART_RUNTIME_JIT_JIT_H_
 
+#include "base/atomic.h"
 #include "base/histogram-inl.h"
 #include "base/macros.h"
 #include "base/mutex.h"
+#include "base/perf_counters.h"
 #include "base/timing_logger.h"
+#include "deoptimization_kind.h"
 #include "handle.h"
+#include "jit/jit_warmup_trace.h"
 #include "jit/profile_saver_options.h"
 #include "obj_ptr.h"
 #include "thread_pool.h"
@@ -69,6 +73,18 @@ class JitOptions {
     return osr_threshold_;
   }
 
+  uint16_t GetOptimizeThreshold() const {
+    return optimize_threshold_;
+  }
+
+  bool UseTieredJitCompilation() const {
+    return use_tiered_jit_compilation_;
+  }
+
+  bool PrecompileHotMethods() const {
+    return precompile_hot_methods_;
+  }
+
   uint16_t GetPriorityThreadWeight() const {
     return priority_thread_weight_;
   }
@@ -97,10 +113,24 @@ class JitOptions {
     return profile_saver_options_.IsEnabled();
   }
 
+  // Whether to write perf-PID.map and jit-PID.dump without --generate-debug-info.
+  bool GetPerfProfiling() const {
+    return perf_profiling_;
+  }
+
   int GetThreadPoolPthreadPriority() const {
     return thread_pool_pthread_priority_;
   }
 
+  size_t GetThreadPoolThreadCount() const {
+    return thread_pool_thread_count_;
+  }
+
+  // File to write the JitWarmupTrace to, empty if the trace is disabled.
+  const std::string& GetWarmupTraceFile() const {
+    return warmup_trace_file_;
+  }
+
   bool UseJitCompilation() const {
     return use_jit_compilation_;
   }
@@ -128,28 +158,39 @@ class JitOptions {
   static uint32_t RoundUpThreshold(uint32_t threshold);
 
   bool use_jit_compilation_;
+  bool use_tiered_jit_compilation_;
+  bool precompile_hot_methods_;
   size_t code_cache_initial_capacity_;
   size_t code_cache_max_capacity_;
   uint32_t compile_threshold_;
   uint32_t warmup_threshold_;
   uint32_t osr_threshold_;
+  uint32_t optimize_threshold_;
   uint16_t priority_thread_weight_;
   uint16_t invoke_transition_weight_;
   bool dump_info_on_shutdown_;
+  bool perf_profiling_;
   int thread_pool_pthread_priority_;
+  size_t thread_pool_thread_count_;
   ProfileSaverOptions profile_saver_options_;
+  std::string warmup_trace_file_;
 
   JitOptions()
       : use_jit_compilation_(false),
+        use_tiered_jit_compilation_(false),
+        precompile_hot_methods_(false),
         code_cache_initial_capacity_(0),
         code_cache_max_capacity_(0),
         compile_threshold_(0),
         warmup_threshold_(0),
         osr_threshold_(0),
+        optimize_threshold_(0),
         priority_thread_weight_(0),
         invoke_transition_weight_(0),
         dump_info_on_shutdown_(false),
-        thread_pool_pthread_priority_(kJitPoolThreadPthreadDefaultPriority) {}
+        perf_profiling_(false),
+        thread_pool_pthread_priority_(kJitPoolThreadPthreadDefaultPriority),
+        thread_pool_thread_count_(1) {}
 
   DISALLOW_COPY_AND_ASSIGN(JitOptions);
 };
@@ -167,6 +208,7 @@ class Jit {
   static Jit* Create(JitCodeCache* code_cache, JitOptions* options);
 
   bool CompileMethod(ArtMethod* method, Thread* self, bool baseline, bool osr, bool prejit)
+      REQUIRES(!lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
   const JitCodeCache* GetCodeCache() const {
@@ -207,6 +249,17 @@ class Jit {
     return options_->GetWarmupThreshold();
   }
 
+  // Hotness that baseline compiled code must reach before the method is recompiled with
+  // optimizations.
+  uint16_t OptimizeMethodThreshold() const {
+    return options_->GetOptimizeThreshold();
+  }
+
+  // Whether hot methods are first compiled with the baseline compiler.
+  bool UseTieredJitCompilation() const {
+    return options_->UseTieredJitCompilation();
+  }
+
   uint16_t PriorityThreadWeight() const {
     return options_->GetPriorityThreadWeight();
   }
@@ -261,6 +314,10 @@ class Jit {
   static void NewTypeLoadedIfUsingJit(mirror::Class* type)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Tell the compiler's perf logs that the jitted code at `code_ptr` was deoptimized or freed.
+  static void NotifyCodeDeoptimized(const void* code_ptr, DeoptimizationKind kind);
+  static void NotifyCodeUnloaded(const void* code_ptr);
+
   // If debug info generation is turned on then write the type information for types already loaded
   // into the specified class linker to the jit debug interface,
   void DumpTypeInfoForLoadedTypes(ClassLinker* linker);
@@ -285,6 +342,12 @@ class Jit {
                                         JValue* result)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Called from the suspend check of compiled code. Return whether the caller, a baseline
+  // compiled frame at a loop header, should deoptimize so that the interpreter can enter the
+  // OSR compiled version of the method at its next back edge. If the loop has no OSR compiled
+  // version yet, queue its compilation and return false.
+  bool ShouldLeaveBaselineLoop(Thread* self) REQUIRES_SHARED(Locks::mutator_lock_);
+
   // Load the compiler library.
   static bool LoadCompilerLibrary(std::string* error_msg);
 
@@ -292,6 +355,20 @@ class Jit {
     return thread_pool_.get();
   }
 
+  // Null unless -Xjitwarmuptrace is given.
+  JitWarmupTrace* GetWarmupTrace() const {
+    return warmup_trace_.get();
+  }
+
+  void RecordWarmupEvent(JitWarmupTrace::Event event,
+                         JitWarmupTrace::Tier tier,
+                         ArtMethod* method)
+      REQUIRES_SHARED(Locks::mutator_lock_) {
+    if (UNLIKELY(warmup_trace_ != nullptr)) {
+      warmup_trace_->Record(event, tier, method);
+    }
+  }
+
   // Stop the JIT by waiting for all current compilations and enqueued compilations to finish.
   void Stop();
 
@@ -309,12 +386,14 @@ class Jit {
 
   // Compile methods from the given profile. If `add_to_queue` is true, methods
   // in the profile are added to the JIT queue. Otherwise they are compiled
-  // directly.
+  // directly. If `hot_methods_only` is true, only the methods the profile
+  // marks as hot are compiled.
   void CompileMethodsFromProfile(Thread* self,
                                  const std::vector<const DexFile*>& dex_files,
                                  const std::string& profile_path,
                                  Handle<mirror::ClassLoader> class_loader,
-                                 bool add_to_queue);
+                                 bool add_to_queue,
+                                 bool hot_methods_only);
 
   // Register the dex files to the JIT. This is to perform any compilation/optimization
   // at the point of loading the dex files.
@@ -333,6 +412,10 @@ class Jit {
                           bool with_backedges)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Queue optimized compilations for the baseline compiled methods that got hot enough. Return
+  // whether any was queued.
+  bool EnqueueOptimizedCompilations(Thread* self) REQUIRES_SHARED(Locks::mutator_lock_);
+
   static bool BindCompilerMethods(std::string* error_msg);
 
   // JIT compiler
@@ -344,6 +427,8 @@ class Jit {
   static void (*jit_types_loaded_)(void*, mirror::Class**, size_t count);
   static void (*jit_update_options_)(void*);
   static bool (*jit_generate_debug_info_)(void*);
+  static void (*jit_code_deoptimized_)(void*, const void*, uint32_t);
+  static void (*jit_code_unloaded_)(void*, const void*);
   template <typename T> static bool LoadSymbol(T*, const char* symbol, std::string* error_msg);
 
   // JIT resources owned by runtime.
@@ -352,12 +437,22 @@ class Jit {
 
   std::unique_ptr<ThreadPool> thread_pool_;
   std::vector<std::unique_ptr<OatDexFile>> type_lookup_tables_;
+  std::unique_ptr<JitWarmupTrace> warmup_trace_;
 
   // Performance monitoring.
   CumulativeLogger cumulative_timings_;
   Histogram<uint64_t> memory_use_ GUARDED_BY(lock_);
+  // Hardware events of the compilations, with -XX:PerfCounters.
+  PerfCounterValues compile_perf_counters_ GUARDED_BY(lock_);
   Mutex lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
 
+  // Tiered compilation: number of sample batches since the last check for baseline compiled
+  // methods to optimize, and whether such a check is queued.
+  Atomic<uint32_t> batches_since_optimize_check_;
+  Atomic<bool> optimize_check_pending_;
+
+  friend class OptimizeBaselineMethodsTask;
+
   DISALLOW_COPY_AND_ASSIGN(Jit);
 };
 
@@ -16,6 +16,8 @@
 
 #include "jit_code_cache.h"
 
+#include <algorithm>
+#include <array>
 #include <sstream>
 
 #include <android-base/logging.h>
@@ -299,6 +301,9 @@ bool JitCodeCache::InitializeMappings(bool rwx_memory_allowed,
     *error_msg = oss.str();
     return false;
   }
+  // The executable view split off below keeps the tag. The non-executable view of the dual view
+  // maps the same memory and is counted as a mapped file.
+  data_pages.SetNativeMemoryTag(NativeMemoryTag::kJitCodeCache);
 
   MemMap exec_pages;
   MemMap non_exec_pages;
@@ -348,6 +353,9 @@ bool JitCodeCache::InitializeMappings(bool rwx_memory_allowed,
     // Profiling only. No memory for code required.
   }
 
+  // With a memory file, this only takes effect if shmem huge pages are enabled in "advise" mode.
+  data_pages.MadviseHugePages();
+  exec_pages.MadviseHugePages();
   data_pages_ = std::move(data_pages);
   exec_pages_ = std::move(exec_pages);
   non_exec_pages_ = std::move(non_exec_pages);
@@ -411,13 +419,17 @@ JitCodeCache::JitCodeCache()
     : lock_("Jit code cache", kJitCodeCacheLock),
       lock_cond_("Jit code cache condition variable", lock_),
       collection_in_progress_(false),
+      writing_code_(false),
+      code_writers_(0),
       last_collection_increased_code_cache_(false),
       garbage_collect_code_(true),
       used_memory_for_data_(0),
       used_memory_for_code_(0),
       number_of_compilations_(0),
       number_of_osr_compilations_(0),
+      number_of_code_write_batches_(0),
       number_of_collections_(0),
+      number_of_fragmented_collections_(0),
       histogram_stack_map_memory_use_("Memory used for stack maps", 16),
       histogram_code_memory_use_("Memory used for compiled code", 16),
       histogram_profiling_info_memory_use_("Memory used for profiling info", 16),
@@ -426,7 +438,9 @@ JitCodeCache::JitCodeCache()
       zygote_data_pages_(),
       zygote_exec_pages_(),
       zygote_data_mspace_(nullptr),
-      zygote_exec_mspace_(nullptr) {
+      zygote_exec_mspace_(nullptr),
+      zygote_used_memory_for_data_(0),
+      zygote_used_memory_for_code_(0) {
 }
 
 void JitCodeCache::InitializeState(size_t initial_capacity, size_t max_capacity) {
@@ -440,7 +454,9 @@ void JitCodeCache::InitializeState(size_t initial_capacity, size_t max_capacity)
   used_memory_for_code_ = 0;
   number_of_compilations_ = 0;
   number_of_osr_compilations_ = 0;
+  number_of_code_write_batches_ = 0;
   number_of_collections_ = 0;
+  number_of_fragmented_collections_ = 0;
 
   data_pages_ = MemMap();
   exec_pages_ = MemMap();
@@ -568,11 +584,18 @@ const void* JitCodeCache::GetZygoteSavedEntryPoint(ArtMethod* method) {
   return nullptr;
 }
 
+// Makes the code cache writable. Must be created and destroyed with the code cache lock held.
+// Scopes may overlap, as a batch of code writes releases the lock while it writes: the
+// permissions only change when the first scope starts and the last one ends.
 class ScopedCodeCacheWrite : ScopedTrace {
  public:
-  explicit ScopedCodeCacheWrite(const JitCodeCache* const code_cache)
+  explicit ScopedCodeCacheWrite(JitCodeCache* const code_cache) NO_THREAD_SAFETY_ANALYSIS
       : ScopedTrace("ScopedCodeCacheWrite"),
         code_cache_(code_cache) {
+    code_cache_->lock_.AssertHeld(Thread::Current());
+    if (code_cache_->code_writers_++ != 0) {
+      return;
+    }
     ScopedTrace trace("mprotect all");
     const MemMap* const updatable_pages = code_cache_->GetUpdatableCodeMapping();
     if (updatable_pages != nullptr) {
@@ -581,7 +604,12 @@ class ScopedCodeCacheWrite : ScopedTrace {
     }
   }
 
-  ~ScopedCodeCacheWrite() {
+  ~ScopedCodeCacheWrite() NO_THREAD_SAFETY_ANALYSIS {
+    code_cache_->lock_.AssertHeld(Thread::Current());
+    DCHECK_NE(code_cache_->code_writers_, 0u);
+    if (--code_cache_->code_writers_ != 0) {
+      return;
+    }
     ScopedTrace trace("mprotect code");
     const MemMap* const updatable_pages = code_cache_->GetUpdatableCodeMapping();
     if (updatable_pages != nullptr) {
@@ -591,7 +619,7 @@ class ScopedCodeCacheWrite : ScopedTrace {
   }
 
  private:
-  const JitCodeCache* const code_cache_;
+  JitCodeCache* const code_cache_;
 
   DISALLOW_COPY_AND_ASSIGN(ScopedCodeCacheWrite);
 };
@@ -633,6 +661,13 @@ uint8_t* JitCodeCache::CommitCode(Thread* self,
                                 has_should_deoptimize_flag,
                                 cha_single_implementation_list);
   }
+  if (result != nullptr) {
+    // Non OSR code has the tier of the kCompileStart of the method which precedes it.
+    Runtime::Current()->GetJit()->RecordWarmupEvent(
+        JitWarmupTrace::Event::kInstalled,
+        osr ? JitWarmupTrace::Tier::kOsr : JitWarmupTrace::Tier::kNone,
+        method);
+  }
   return result;
 }
 
@@ -800,6 +835,7 @@ void JitCodeCache::FreeCodeAndData(const void* code_ptr) {
   // Notify native debugger that we are about to remove the code.
   // It does nothing if we are not using native debugger.
   RemoveNativeDebugInfoForJit(Thread::Current(), code_ptr);
+  Jit::NotifyCodeUnloaded(code_ptr);
   if (OatQuickMethodHeader::FromCodePointer(code_ptr)->IsOptimized()) {
     FreeData(GetRootTable(code_ptr));
   }  // else this is a JNI stub without any data.
@@ -863,6 +899,9 @@ void JitCodeCache::RemoveMethodsIn(Thread* self, const LinearAlloc& alloc) {
           ++it;
         }
       }
+      code_index_.RemoveIf([&method_headers](const void* code_ptr) {
+        return method_headers.count(OatQuickMethodHeader::FromCodePointer(code_ptr)) != 0u;
+      });
     }
     for (auto it = osr_code_map_.begin(); it != osr_code_map_.end();) {
       if (alloc.ContainsUnsafe(it->first)) {
@@ -921,19 +960,30 @@ void JitCodeCache::DisallowInlineCacheAccess() {
   is_weak_access_enabled_.store(false, std::memory_order_seq_cst);
 }
 
-void JitCodeCache::CopyInlineCacheInto(const InlineCache& ic,
-                                       Handle<mirror::ObjectArray<mirror::Class>> array) {
+void JitCodeCache::CopyInlineCacheInto(
+    const InlineCache& ic,
+    Handle<mirror::ObjectArray<mirror::Class>> array,
+    /*out*/ uint16_t* counts) {
   WaitUntilInlineCacheAccessible(Thread::Current());
   // Note that we don't need to lock `lock_` here, the compiler calling
   // this method has already ensured the inline cache will not be deleted.
-  for (size_t in_cache = 0, in_array = 0;
-       in_cache < InlineCache::kIndividualCacheSize;
-       ++in_cache) {
+  std::array<std::pair<mirror::Class*, uint16_t>, InlineCache::kIndividualCacheSize> entries;
+  size_t number_of_entries = 0u;
+  for (size_t in_cache = 0; in_cache < InlineCache::kIndividualCacheSize; ++in_cache) {
     mirror::Class* object = ic.classes_[in_cache].Read();
     if (object != nullptr) {
-      array->Set(in_array++, object);
+      entries[number_of_entries++] = std::make_pair(object, ic.counts_[in_cache]);
     }
   }
+  // Hand out the most frequent receivers first so that the compiler checks for them first.
+  std::stable_sort(entries.begin(),
+                   entries.begin() + number_of_entries,
+                   [](const auto& lhs, const auto& rhs) { return lhs.second > rhs.second; });
+  std::fill_n(counts, InlineCache::kIndividualCacheSize, 0u);
+  for (size_t i = 0; i != number_of_entries; ++i) {
+    array->Set(i, entries[i].first);
+    counts[i] = entries[i].second;
+  }
 }
 
 static void ClearMethodCounter(ArtMethod* method, bool was_warm)
@@ -949,6 +999,17 @@ static void ClearMethodCounter(ArtMethod* method, bool was_warm)
   method->SetCounter(std::min(jit_warmup_threshold - 1, 1));
 }
 
+// Halve the samples a warm method collected past the warmup threshold. Methods that got warm a
+// while ago and then stopped running thus need to get hot again before we compile them, which
+// leaves the code cache to the methods that are hot now.
+static void DecayMethodCounter(ArtMethod* method) REQUIRES_SHARED(Locks::mutator_lock_) {
+  uint16_t jit_warmup_threshold = Runtime::Current()->GetJITOptions()->GetWarmupThreshold();
+  uint16_t counter = method->GetCounter();
+  if (counter > jit_warmup_threshold) {
+    method->SetCounter(jit_warmup_threshold + (counter - jit_warmup_threshold) / 2);
+  }
+}
+
 void JitCodeCache::WaitForPotentialCollectionToCompleteRunnable(Thread* self) {
   while (collection_in_progress_) {
     lock_.Unlock(self);
@@ -971,71 +1032,110 @@ const MemMap* JitCodeCache::GetUpdatableCodeMapping() const {
   }
 }
 
-uint8_t* JitCodeCache::CommitCodeInternal(Thread* self,
-                                          ArtMethod* method,
-                                          uint8_t* stack_map,
-                                          uint8_t* roots_data,
-                                          const uint8_t* code,
-                                          size_t code_size,
-                                          size_t data_size,
-                                          bool osr,
-                                          const std::vector<Handle<mirror::Object>>& roots,
-                                          bool has_should_deoptimize_flag,
-                                          const ArenaSet<ArtMethod*>&
-                                              cha_single_implementation_list) {
-  DCHECK(!method->IsNative() || !osr);
+// Cache flushes of code ranges at most this far apart are merged into a single flush.
+static constexpr size_t kMaxMergedCacheFlushGap = kPageSize;
 
-  if (!method->IsNative()) {
-    // We need to do this before grabbing the lock_ because it needs to be able to see the string
-    // InternTable. Native methods do not have roots.
-    DCheckRootsAreValid(roots);
+// Flush the processor caches for `ranges`, merging the flushes of ranges close to each other.
+// Return whether all the flushes succeeded.
+static bool FlushCpuCacheRanges(std::vector<std::pair<uint8_t*, uint8_t*>>* ranges) {
+  std::sort(ranges->begin(), ranges->end());
+  size_t i = 0;
+  while (i < ranges->size()) {
+    uint8_t* begin = (*ranges)[i].first;
+    uint8_t* end = (*ranges)[i].second;
+    for (++i; i < ranges->size() && (*ranges)[i].first <= end + kMaxMergedCacheFlushGap; ++i) {
+      end = std::max(end, (*ranges)[i].second);
+    }
+    if (!FlushCpuCaches(begin, end)) {
+      return false;
+    }
   }
+  return true;
+}
 
-  OatQuickMethodHeader* method_header = nullptr;
-  uint8_t* nox_memory = nullptr;
-  uint8_t* code_ptr = nullptr;
+void JitCodeCache::WriteCode(Thread* self, PendingCodeWrite* write) {
+  pending_code_writes_.push_back(write);
+  while (!write->done) {
+    if (collection_in_progress_) {
+      WaitForPotentialCollectionToCompleteRunnable(self);
+    } else if (!writing_code_) {
+      WriteCodeBatch(self);
+    } else {
+      // Wait for the batch being written. Our code may be in the next one.
+      lock_.Unlock(self);
+      {
+        ScopedThreadSuspension sts(self, kSuspended);
+        MutexLock mu(self, lock_);
+        while (writing_code_) {
+          lock_cond_.Wait(self);
+        }
+      }
+      lock_.Lock(self);
+    }
+  }
+}
 
-  MutexLock mu(self, lock_);
-  // We need to make sure that there will be no jit-gcs going on and wait for any ongoing one to
-  // finish.
-  WaitForPotentialCollectionToCompleteRunnable(self);
+void JitCodeCache::WriteCodeBatch(Thread* self) {
+  ScopedTrace trace(__FUNCTION__);
+  DCHECK(!writing_code_);
+  writing_code_ = true;
+  std::vector<PendingCodeWrite*> batch;
+  batch.swap(pending_code_writes_);
+
+  size_t alignment = GetJitCodeAlignment();
+  // Ensure the header ends up at expected instruction alignment.
+  size_t header_size = RoundUp(sizeof(OatQuickMethodHeader), alignment);
   {
     ScopedCodeCacheWrite scc(this);
 
-    size_t alignment = GetJitCodeAlignment();
-    // Ensure the header ends up at expected instruction alignment.
-    size_t header_size = RoundUp(sizeof(OatQuickMethodHeader), alignment);
-    size_t total_size = header_size + code_size;
-
-    // AllocateCode allocates memory in non-executable region for alignment header and code. The
-    // header size may include alignment padding.
-    nox_memory = AllocateCode(total_size);
-    if (nox_memory == nullptr) {
-      return nullptr;
+    for (PendingCodeWrite* write : batch) {
+      // AllocateCode allocates memory in non-executable region for alignment header and code.
+      // The header size may include alignment padding.
+      write->nox_memory = AllocateCode(header_size + write->code_size);
     }
 
-    // code_ptr points to non-executable code.
-    code_ptr = nox_memory + header_size;
-    std::copy(code, code + code_size, code_ptr);
-    method_header = OatQuickMethodHeader::FromCodePointer(code_ptr);
+    // The memory is allocated, so copying the code and flushing the caches do not need the lock.
+    // Other threads queue their code for the next batch meanwhile. The code cache stays writable
+    // until `scc` goes out of scope.
+    lock_.Unlock(self);
+    std::vector<std::pair<uint8_t*, uint8_t*>> nox_ranges;
+    std::vector<std::pair<uint8_t*, uint8_t*>> x_ranges;
+    for (PendingCodeWrite* write : batch) {
+      uint8_t* nox_memory = write->nox_memory;
+      if (nox_memory == nullptr) {
+        continue;
+      }
+      size_t total_size = header_size + write->code_size;
 
-    // From here code_ptr points to executable code.
-    if (HasDualCodeMapping()) {
-      code_ptr = TranslateAddress(code_ptr, non_exec_pages_, exec_pages_);
-    }
+      // code_ptr points to non-executable code.
+      uint8_t* code_ptr = nox_memory + header_size;
+      std::copy(write->code, write->code + write->code_size, code_ptr);
+      OatQuickMethodHeader* method_header = OatQuickMethodHeader::FromCodePointer(code_ptr);
 
-    new (method_header) OatQuickMethodHeader(
-        (stack_map != nullptr) ? code_ptr - stack_map : 0u,
-        code_size);
+      // From here code_ptr points to executable code.
+      if (HasDualCodeMapping()) {
+        code_ptr = TranslateAddress(code_ptr, non_exec_pages_, exec_pages_);
+      }
 
-    DCHECK(!Runtime::Current()->IsAotCompiler());
-    if (has_should_deoptimize_flag) {
-      method_header->SetHasShouldDeoptimizeFlag();
-    }
+      new (method_header) OatQuickMethodHeader(
+          (write->stack_map != nullptr) ? code_ptr - write->stack_map : 0u,
+          write->code_size);
 
-    // Update method_header pointer to executable code region.
-    if (HasDualCodeMapping()) {
-      method_header = TranslateAddress(method_header, non_exec_pages_, exec_pages_);
+      DCHECK(!Runtime::Current()->IsAotCompiler());
+      if (write->has_should_deoptimize_flag) {
+        method_header->SetHasShouldDeoptimizeFlag();
+      }
+
+      // Update method_header pointer to executable code region.
+      if (HasDualCodeMapping()) {
+        method_header = TranslateAddress(method_header, non_exec_pages_, exec_pages_);
+      }
+      write->code_ptr = code_ptr;
+      write->method_header = method_header;
+
+      nox_ranges.emplace_back(nox_memory, nox_memory + total_size);
+      uint8_t* x_memory = reinterpret_cast<uint8_t*>(FromCodeToAllocation(code_ptr));
+      x_ranges.emplace_back(x_memory, x_memory + total_size);
     }
 
     // Both instruction and data caches need flushing to the point of unification where both share
@@ -1056,36 +1156,92 @@ uint8_t* JitCodeCache::CommitCodeInternal(Thread* self,
     bool cache_flush_success = true;
     if (HasDualCodeMapping()) {
       // Flush the data cache lines associated with the non-executable copy of the code just added.
-      cache_flush_success = FlushCpuCaches(nox_memory, nox_memory + total_size);
+      cache_flush_success = FlushCpuCacheRanges(&nox_ranges);
     }
 
     // Invalidate i-cache for the executable mapping.
     if (cache_flush_success) {
-      uint8_t* x_memory = reinterpret_cast<uint8_t*>(FromCodeToAllocation(code_ptr));
-      cache_flush_success = FlushCpuCaches(x_memory, x_memory + total_size);
+      cache_flush_success = FlushCpuCacheRanges(&x_ranges);
     }
 
-    // If flushing the cache has failed, reject the allocation because we can't guarantee
-    // correctness of the instructions present in the processor caches.
     if (!cache_flush_success) {
       PLOG(ERROR) << "Cache flush failed for JIT code, code not committed.";
-      FreeCode(nox_memory);
-      return nullptr;
+    } else if (!x_ranges.empty()) {
+      // Ensure CPU instruction pipelines are flushed for all cores. This is necessary for
+      // correctness as code may still be in instruction pipelines despite the i-cache flush. It
+      // is not safe to assume that changing permissions with mprotect (RX->RWX->RX) will cause a
+      // TLB shootdown (incidentally invalidating the CPU pipelines by sending an IPI to all cores
+      // to notify them of the TLB invalidation). Some architectures, notably ARM and ARM64, have
+      // hardware support that broadcasts TLB invalidations and so their kernels have no software
+      // based TLB shootdown. The sync-core flavor of membarrier was introduced in Linux 4.16 to
+      // address this (see mbarrier(2)). The membarrier here will fail on prior kernels and on
+      // platforms lacking the appropriate support.
+      art::membarrier(art::MembarrierCommand::kPrivateExpeditedSyncCore);
+    }
+    lock_.Lock(self);
+
+    for (PendingCodeWrite* write : batch) {
+      if (write->nox_memory == nullptr) {
+        continue;
+      }
+      if (cache_flush_success) {
+        number_of_compilations_++;
+      } else {
+        // Reject the allocation because we can't guarantee correctness of the instructions
+        // present in the processor caches.
+        FreeCode(write->nox_memory);
+        write->nox_memory = nullptr;
+      }
     }
+  }
+
+  number_of_code_write_batches_++;
+  for (PendingCodeWrite* write : batch) {
+    write->done = true;
+  }
+  writing_code_ = false;
+  lock_cond_.Broadcast(self);
+}
+
+uint8_t* JitCodeCache::CommitCodeInternal(Thread* self,
+                                          ArtMethod* method,
+                                          uint8_t* stack_map,
+                                          uint8_t* roots_data,
+                                          const uint8_t* code,
+                                          size_t code_size,
+                                          size_t data_size,
+                                          bool osr,
+                                          const std::vector<Handle<mirror::Object>>& roots,
+                                          bool has_should_deoptimize_flag,
+                                          const ArenaSet<ArtMethod*>&
+                                              cha_single_implementation_list) {
+  DCHECK(!method->IsNative() || !osr);
 
-    // Ensure CPU instruction pipelines are flushed for all cores. This is necessary for
-    // correctness as code may still be in instruction pipelines despite the i-cache flush. It is
-    // not safe to assume that changing permissions with mprotect (RX->RWX->RX) will cause a TLB
-    // shootdown (incidentally invalidating the CPU pipelines by sending an IPI to all cores to
-    // notify them of the TLB invalidation). Some architectures, notably ARM and ARM64, have
-    // hardware support that broadcasts TLB invalidations and so their kernels have no software
-    // based TLB shootdown. The sync-core flavor of membarrier was introduced in Linux 4.16 to
-    // address this (see mbarrier(2)). The membarrier here will fail on prior kernels and on
-    // platforms lacking the appropriate support.
-    art::membarrier(art::MembarrierCommand::kPrivateExpeditedSyncCore);
+  if (!method->IsNative()) {
+    // We need to do this before grabbing the lock_ because it needs to be able to see the string
+    // InternTable. Native methods do not have roots.
+    DCheckRootsAreValid(roots);
+  }
 
-    number_of_compilations_++;
+  MutexLock mu(self, lock_);
+  // We need to make sure that there will be no jit-gcs going on and wait for any ongoing one to
+  // finish.
+  WaitForPotentialCollectionToCompleteRunnable(self);
+  PendingCodeWrite write;
+  write.code = code;
+  write.code_size = code_size;
+  write.stack_map = stack_map;
+  write.has_should_deoptimize_flag = has_should_deoptimize_flag;
+  WriteCode(self, &write);
+  if (write.nox_memory == nullptr) {
+    return nullptr;
   }
+  uint8_t* nox_memory = write.nox_memory;
+  uint8_t* code_ptr = write.code_ptr;
+  OatQuickMethodHeader* method_header = write.method_header;
+  // Writing the code may have let a collection start. The code is not in the maps yet, so the
+  // collection does not free it.
+  WaitForPotentialCollectionToCompleteRunnable(self);
 
   // We need to update the entry point in the runnable state for the instrumentation.
   {
@@ -1148,6 +1304,7 @@ uint8_t* JitCodeCache::CommitCodeInternal(Thread* self,
         }
       }
       method_code_map_.Put(code_ptr, method);
+      code_index_.Insert(code_ptr);
       if (osr) {
         number_of_osr_compilations_++;
         osr_code_map_.Put(method, code_ptr);
@@ -1247,6 +1404,7 @@ bool JitCodeCache::RemoveMethodLocked(ArtMethod* method, bool release_memory) {
     for (auto it = method_code_map_.begin(); it != method_code_map_.end();) {
       if (it->second == method) {
         in_cache = true;
+        code_index_.Remove(it->first);
         if (release_memory) {
           FreeCodeAndData(it->first);
         }
@@ -1505,6 +1663,12 @@ void JitCodeCache::MarkCompiledCodeOnThreadStacks(Thread* self) {
   }
 }
 
+bool JitCodeCache::IsCodeCacheFragmented() {
+  size_t data_capacity = current_capacity_ / kCodeAndDataCapacityDivider;
+  size_t code_capacity = current_capacity_ - data_capacity;
+  return used_memory_for_code_ <= code_capacity / 2 && used_memory_for_data_ <= data_capacity / 2;
+}
+
 bool JitCodeCache::ShouldDoFullCollection() {
   if (current_capacity_ == max_capacity_) {
     // Always do a full collection when the code cache is full.
@@ -1513,6 +1677,10 @@ bool JitCodeCache::ShouldDoFullCollection() {
     // Always do partial collection when the code cache size is below the reserved
     // capacity.
     return false;
+  } else if (IsCodeCacheFragmented()) {
+    // A full collection would throw away live code to make room that is mostly there already
+    // but in pieces too small to use. Do a partial collection, which grows the cache instead.
+    return false;
   } else if (last_collection_increased_code_cache_) {
     // This time do a full collection.
     return true;
@@ -1548,9 +1716,11 @@ void JitCodeCache::GarbageCollectCache(Thread* self) {
     TimingLogger::ScopedTiming st("Code cache collection", &logger);
 
     bool do_full_collection = false;
+    bool cache_is_fragmented = false;
     {
       MutexLock mu(self, lock_);
       do_full_collection = ShouldDoFullCollection();
+      cache_is_fragmented = current_capacity_ >= kReservedCapacity && IsCodeCacheFragmented();
     }
 
     VLOG(jit) << "Do "
@@ -1569,10 +1739,12 @@ void JitCodeCache::GarbageCollectCache(Thread* self) {
       MutexLock mu(self, lock_);
 
       // Increase the code cache only when we do partial collections.
-      // TODO: base this strategy on how full the code cache is?
       if (do_full_collection) {
         last_collection_increased_code_cache_ = false;
       } else {
+        if (cache_is_fragmented) {
+          number_of_fragmented_collections_++;
+        }
         last_collection_increased_code_cache_ = true;
         IncreaseCodeCacheCapacity();
       }
@@ -1651,6 +1823,9 @@ void JitCodeCache::RemoveUnmarkedCode(Thread* self) {
         it = method_code_map_.erase(it);
       }
     }
+    code_index_.RemoveIf([&method_headers](const void* code_ptr) {
+      return method_headers.count(OatQuickMethodHeader::FromCodePointer(code_ptr)) != 0u;
+    });
   }
   FreeAllMethodHeaders(method_headers);
 }
@@ -1682,6 +1857,16 @@ void JitCodeCache::DoCollection(Thread* self, bool collect_profiling_info) {
   ScopedTrace trace(__FUNCTION__);
   {
     MutexLock mu(self, lock_);
+    // Age the hotness of the methods still waiting to get compiled.
+    for (ProfilingInfo* info : profiling_infos_) {
+      ArtMethod* method = info->GetMethod();
+      if (!ContainsPc(method->GetEntryPointFromQuickCompiledCode()) &&
+          info->GetSavedEntryPoint() == nullptr &&
+          !info->IsInUseByCompiler() &&
+          !IsInZygoteDataSpace(info)) {
+        DecayMethodCounter(method);
+      }
+    }
     if (collect_profiling_info) {
       // Clear the profiling info of methods that do not have compiled code as entrypoint.
       // Also remove the saved entry point from the ProfilingInfo objects.
@@ -1791,6 +1976,20 @@ OatQuickMethodHeader* JitCodeCache::LookupMethodHeader(uintptr_t pc, ArtMethod*
     CHECK(method != nullptr);
   }
 
+  if (method != nullptr && LIKELY(!method->IsNative())) {
+    // Stack walks get here for every JIT frame, try without the lock first.
+    OatQuickMethodHeader* method_header = nullptr;
+    if (code_index_.Lookup(pc, &method_header)) {
+      if (kIsDebugBuild && method_header != nullptr) {
+        MutexLock mu(Thread::Current(), lock_);
+        auto it = method_code_map_.find(method_header->GetCode());
+        DCHECK(it != method_code_map_.end() && it->second == method)
+            << ArtMethod::PrettyMethod(method) << " " << std::hex << pc;
+      }
+      return method_header;
+    }
+  }
+
   MutexLock mu(Thread::Current(), lock_);
   OatQuickMethodHeader* method_header = nullptr;
   ArtMethod* found_method = nullptr;  // Only for DCHECK(), not for JNI stubs.
@@ -2012,9 +2211,21 @@ bool JitCodeCache::IsOsrCompiled(ArtMethod* method) {
   return osr_code_map_.find(method) != osr_code_map_.end();
 }
 
-bool JitCodeCache::NotifyCompilationOf(ArtMethod* method, Thread* self, bool osr, bool prejit) {
+bool JitCodeCache::NotifyCompilationOf(ArtMethod* method,
+                                       Thread* self,
+                                       bool osr,
+                                       bool prejit,
+                                       bool baseline) {
   if (!osr && ContainsPc(method->GetEntryPointFromQuickCompiledCode())) {
-    return false;
+    // Only baseline compiled code gets replaced, with optimized code.
+    if (baseline || method->IsNative()) {
+      return false;
+    }
+    MutexLock mu(self, lock_);
+    ProfilingInfo* info = method->GetProfilingInfo(kRuntimePointerSize);
+    if (info == nullptr || !info->IsBaselineCompiled()) {
+      return false;
+    }
   }
 
   ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
@@ -2110,7 +2321,11 @@ void JitCodeCache::DoneCompilerUse(ArtMethod* method, Thread* self) {
   info->DecrementInlineUse();
 }
 
-void JitCodeCache::DoneCompiling(ArtMethod* method, Thread* self, bool osr) {
+void JitCodeCache::DoneCompiling(ArtMethod* method,
+                                 Thread* self,
+                                 bool osr,
+                                 bool baseline,
+                                 bool success) {
   DCHECK_EQ(Thread::Current(), self);
   MutexLock mu(self, lock_);
   if (UNLIKELY(method->IsNative())) {
@@ -2127,6 +2342,36 @@ void JitCodeCache::DoneCompiling(ArtMethod* method, Thread* self, bool osr) {
     if (info != nullptr) {
       DCHECK(info->IsMethodBeingCompiled(osr));
       info->SetIsMethodBeingCompiled(false, osr);
+      if (success && !osr) {
+        info->SetIsBaselineCompiled(baseline);
+        if (baseline) {
+          // Count the hotness of the baseline compiled code from scratch.
+          method->SetCounter(0);
+        }
+      }
+    }
+  }
+}
+
+void JitCodeCache::GetBaselineMethodsToOptimize(Thread* self,
+                                                uint16_t threshold,
+                                                std::vector<ArtMethod*>* methods) {
+  DCHECK(kUseReadBarrier);
+  if (self->GetIsGcMarking()) {
+    // Classes found dead by the GC are only unloaded once marking is done.
+    return;
+  }
+  MutexLock mu(self, lock_);
+  for (ProfilingInfo* info : profiling_infos_) {
+    ArtMethod* method = info->GetMethod();
+    if (info->IsBaselineCompiled() &&
+        !info->IsMethodBeingCompiled(/* osr= */ false) &&
+        !IsInZygoteDataSpace(info) &&
+        method->GetCounter() >= threshold &&
+        ContainsPc(method->GetEntryPointFromQuickCompiledCode())) {
+      // Let the method get hot again if the compilation fails.
+      method->SetCounter(0);
+      methods->push_back(method);
     }
   }
 }
@@ -2162,6 +2407,23 @@ void JitCodeCache::InvalidateCompiledCodeFor(ArtMethod* method,
   }
 }
 
+void JitCodeCache::NotifyDeoptimization(ArtMethod* method,
+                                        const OatQuickMethodHeader* header,
+                                        DeoptimizationKind kind) {
+  DCHECK(!method->IsNative());
+  Jit::NotifyCodeDeoptimized(header->GetCode(), kind);
+  ProfilingInfo* profiling_info = method->GetProfilingInfo(kRuntimePointerSize);
+  if (profiling_info == nullptr) {
+    return;
+  }
+  MutexLock mu(Thread::Current(), lock_);
+  // The code is still installed until InvalidateCompiledCodeFor.
+  if (method->GetEntryPointFromQuickCompiledCode() == header->GetEntryPoint() ||
+      profiling_info->GetSavedEntryPoint() == header->GetEntryPoint()) {
+    profiling_info->IncrementDeoptimizationCount(kind);
+  }
+}
+
 uint8_t* JitCodeCache::AllocateCode(size_t allocation_size) {
   // Each allocation should be on its own set of cache lines. The allocation must be large enough
   // for header, code, and any padding.
@@ -2210,7 +2472,20 @@ void JitCodeCache::Dump(std::ostream& os) {
      << "Total number of JIT compilations: " << number_of_compilations_ << "\n"
      << "Total number of JIT compilations for on stack replacement: "
         << number_of_osr_compilations_ << "\n"
-     << "Total number of JIT code cache collections: " << number_of_collections_ << std::endl;
+     << "Total number of JIT code write batches: " << number_of_code_write_batches_ << "\n"
+     << "Total number of JIT code cache collections: " << number_of_collections_ << "\n"
+     << "Total number of JIT code cache collections growing a fragmented cache: "
+        << number_of_fragmented_collections_ << std::endl;
+  if (zygote_exec_pages_.IsValid()) {
+    // Code shared with the zygote, this process did not have to compile it.
+    size_t num_zygote_entries = std::count_if(
+        method_code_map_.begin(),
+        method_code_map_.end(),
+        [this](const auto& entry) { return IsInZygoteExecSpace(entry.first); });
+    os << "Zygote JIT code cache size: " << PrettySize(zygote_used_memory_for_code_) << "\n"
+       << "Zygote JIT data cache size: " << PrettySize(zygote_used_memory_for_data_) << "\n"
+       << "Current number of zygote JIT code cache entries: " << num_zygote_entries << std::endl;
+  }
   histogram_stack_map_memory_use_.PrintMemoryUse(os);
   histogram_code_memory_use_.PrintMemoryUse(os);
   histogram_profiling_info_memory_use_.PrintMemoryUse(os);
@@ -2227,6 +2502,8 @@ void JitCodeCache::PostForkChildAction(bool is_system_server, bool is_zygote) {
   zygote_exec_pages_ = std::move(exec_pages_);
   zygote_data_mspace_ = data_mspace_;
   zygote_exec_mspace_ = exec_mspace_;
+  zygote_used_memory_for_data_ = used_memory_for_data_;
+  zygote_used_memory_for_code_ = used_memory_for_code_;
 
   size_t initial_capacity = Runtime::Current()->GetJITOptions()->GetCodeCacheInitialCapacity();
   size_t max_capacity = Runtime::Current()->GetJITOptions()->GetCodeCacheMaxCapacity();
@@ -31,6 +31,8 @@
 #include "base/mem_map.h"
 #include "base/mutex.h"
 #include "base/safe_map.h"
+#include "deoptimization_kind.h"
+#include "jit/jit_code_index.h"
 
 namespace art {
 
@@ -100,7 +102,7 @@ class JitCodeCache {
                               std::string* error_msg);
   ~JitCodeCache();
 
-  bool NotifyCompilationOf(ArtMethod* method, Thread* self, bool osr, bool prejit)
+  bool NotifyCompilationOf(ArtMethod* method, Thread* self, bool osr, bool prejit, bool baseline)
       REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(!lock_);
 
@@ -116,7 +118,19 @@ class JitCodeCache {
       REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(!lock_);
 
-  void DoneCompiling(ArtMethod* method, Thread* self, bool osr)
+  // Notify the code cache that the compilation of `method` ended. `success` and `baseline` tell
+  // whether it produced code, and whether that code comes from the baseline compiler.
+  void DoneCompiling(ArtMethod* method, Thread* self, bool osr, bool baseline, bool success)
+      REQUIRES_SHARED(Locks::mutator_lock_)
+      REQUIRES(!lock_);
+
+  // Collect the methods running baseline compiled code whose hotness count reached `threshold`,
+  // and reset their count. Returns nothing while the GC is marking, as the collected methods may
+  // then belong to classes being unloaded. The caller must not suspend before taking a reference
+  // to the declaring classes of the collected methods.
+  void GetBaselineMethodsToOptimize(Thread* self,
+                                    uint16_t threshold,
+                                    std::vector<ArtMethod*>* methods)
       REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(!lock_);
 
@@ -202,7 +216,12 @@ class JitCodeCache {
       REQUIRES(!lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
-  void CopyInlineCacheInto(const InlineCache& ic, Handle<mirror::ObjectArray<mirror::Class>> array)
+  // Copy the classes of `ic` into `array`, most frequently seen receiver first, and
+  // their approximate receiver counts into `counts`, which must have room for
+  // InlineCache::kIndividualCacheSize entries.
+  void CopyInlineCacheInto(const InlineCache& ic,
+                           Handle<mirror::ObjectArray<mirror::Class>> array,
+                           /*out*/ uint16_t* counts)
       REQUIRES(!lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
@@ -231,6 +250,14 @@ class JitCodeCache {
       REQUIRES(!lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Count in the profiling info of `method` that its compiled code `code` deoptimized with
+  // `kind`. Only the first deoptimization from a given compiled code counts.
+  void NotifyDeoptimization(ArtMethod* method,
+                            const OatQuickMethodHeader* code,
+                            DeoptimizationKind kind)
+      REQUIRES(!lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   void Dump(std::ostream& os) REQUIRES(!lock_);
 
   bool IsOsrCompiled(ArtMethod* method) REQUIRES(!lock_);
@@ -305,6 +332,28 @@ class JitCodeCache {
       REQUIRES(!lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Code of a compiled method to write to the code cache. Committing threads queue their code, and
+  // one of them writes all the queued code in a batch.
+  struct PendingCodeWrite {
+    const uint8_t* code;
+    size_t code_size;
+    uint8_t* stack_map;
+    bool has_should_deoptimize_flag;
+    // Set once the code is written. `nox_memory` stays null if writing the code failed.
+    uint8_t* nox_memory = nullptr;
+    uint8_t* code_ptr = nullptr;
+    OatQuickMethodHeader* method_header = nullptr;
+    bool done = false;
+  };
+
+  // Queue `write` and return once its code is written, by this thread or by another one.
+  void WriteCode(Thread* self, PendingCodeWrite* write)
+      REQUIRES(lock_, !Roles::uninterruptible_) REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Write the code of all the queued PendingCodeWrites. The code cache is made writable once,
+  // and the processor caches and pipelines are flushed once, for the whole batch.
+  void WriteCodeBatch(Thread* self) REQUIRES(lock_);
+
   // Adds the given roots to the roots_data. Only a member for annotalysis.
   void FillRootTable(uint8_t* roots_data, const std::vector<Handle<mirror::Object>>& roots)
       REQUIRES(lock_)
@@ -363,6 +412,10 @@ class JitCodeCache {
   // Set the footprint limit of the code cache.
   void SetFootprintLimit(size_t new_footprint) REQUIRES(lock_);
 
+  // Return whether the cache ran out of memory although at most half of the current code and data
+  // capacity is in use, that is whether its free memory is too fragmented to be allocated.
+  bool IsCodeCacheFragmented() REQUIRES(lock_);
+
   // Return whether we should do a full collection given the current state of the cache.
   bool ShouldDoFullCollection()
       REQUIRES(lock_)
@@ -421,6 +474,11 @@ class JitCodeCache {
   ConditionVariable lock_cond_ GUARDED_BY(lock_);
   // Whether there is a code cache collection in progress.
   bool collection_in_progress_ GUARDED_BY(lock_);
+  // Code waiting to be written by the next batch, and whether a batch is being written.
+  std::vector<PendingCodeWrite*> pending_code_writes_ GUARDED_BY(lock_);
+  bool writing_code_ GUARDED_BY(lock_);
+  // Number of ScopedCodeCacheWrite alive. The code cache is writable while it is not zero.
+  size_t code_writers_ GUARDED_BY(lock_);
   // Mem map which holds data (stack maps and profiling info).
   MemMap data_pages_;
   // Mem map which holds code and has executable permission.
@@ -438,6 +496,8 @@ class JitCodeCache {
   SafeMap<JniStubKey, JniStubData> jni_stubs_map_ GUARDED_BY(lock_);
   // Holds compiled code associated to the ArtMethod.
   SafeMap<const void*, ArtMethod*> method_code_map_ GUARDED_BY(lock_);
+  // The code pointers of method_code_map_, for lookups without the lock. Updated with lock_ held.
+  JitCodeIndex code_index_;
   // Holds osr compiled code associated to the ArtMethod.
   SafeMap<ArtMethod*, const void*> osr_code_map_ GUARDED_BY(lock_);
   // ProfilingInfo objects we have allocated.
@@ -476,9 +536,16 @@ class JitCodeCache {
   // Number of compilations for on-stack-replacement done throughout the lifetime of the JIT.
   size_t number_of_osr_compilations_ GUARDED_BY(lock_);
 
+  // Number of batches the code of the compilations was written in.
+  size_t number_of_code_write_batches_ GUARDED_BY(lock_);
+
   // Number of code cache collections done throughout the lifetime of the JIT.
   size_t number_of_collections_ GUARDED_BY(lock_);
 
+  // Number of code cache collections that grew the cache instead of doing a full collection
+  // because it was fragmented.
+  size_t number_of_fragmented_collections_ GUARDED_BY(lock_);
+
   // Histograms for keeping track of stack map size statistics.
   Histogram<uint64_t> histogram_stack_map_memory_use_ GUARDED_BY(lock_);
 
@@ -504,6 +571,9 @@ class JitCodeCache {
   void* zygote_data_mspace_ GUARDED_BY(lock_);
   // The opaque mspace for allocating zygote code.
   void* zygote_exec_mspace_ GUARDED_BY(lock_);
+  // The size in bytes of used memory for the data and code inherited from the zygote.
+  size_t zygote_used_memory_for_data_ GUARDED_BY(lock_);
+  size_t zygote_used_memory_for_code_ GUARDED_BY(lock_);
 
   friend class art::JitJniStubTestHelper;
   friend class ScopedCodeCacheWrite;
@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2019 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "jit_code_index.h"
+
+#include <algorithm>
+
+#include "base/logging.h"
+#include "oat_quick_method_header.h"
+
+namespace art {
+namespace jit {
+
+JitCodeIndex::JitCodeIndex() : sequence_(0u), array_(nullptr), size_(0u) {}
+
+JitCodeIndex::~JitCodeIndex() {}
+
+void JitCodeIndex::BeginUpdate() {
+  uint32_t sequence = sequence_.load(std::memory_order_relaxed);
+  DCHECK_EQ(sequence & 1u, 0u);
+  sequence_.store(sequence + 1u, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+}
+
+void JitCodeIndex::EndUpdate() {
+  uint32_t sequence = sequence_.load(std::memory_order_relaxed);
+  DCHECK_EQ(sequence & 1u, 1u);
+  sequence_.store(sequence + 1u, std::memory_order_release);
+}
+
+void JitCodeIndex::Insert(const void* code_ptr) {
+  uintptr_t code = reinterpret_cast<uintptr_t>(code_ptr);
+  DCHECK_NE(code, 0u);
+  size_t size = size_.load(std::memory_order_relaxed);
+  Array* array = arrays_.empty() ? nullptr : arrays_.back().get();
+  if (array == nullptr || size == array->capacity) {
+    // Fill the new array before lookups can see it, only publishing it is part of the update.
+    size_t capacity = (array == nullptr) ? static_cast<size_t>(kInitialCapacity)
+                                          : 2u * array->capacity;
+    arrays_.push_back(std::make_unique<Array>(capacity));
+    Array* new_array = arrays_.back().get();
+    for (size_t i = 0; i != size; ++i) {
+      new_array->entries[i].store(array->entries[i].load(std::memory_order_relaxed),
+                                  std::memory_order_relaxed);
+    }
+    array = new_array;
+  }
+  size_t index = 0u;
+  while (index != size && array->entries[index].load(std::memory_order_relaxed) < code) {
+    ++index;
+  }
+  DCHECK(index == size || array->entries[index].load(std::memory_order_relaxed) != code);
+  BeginUpdate();
+  for (size_t i = size; i != index; --i) {
+    array->entries[i].store(array->entries[i - 1u].load(std::memory_order_relaxed),
+                            std::memory_order_relaxed);
+  }
+  array->entries[index].store(code, std::memory_order_relaxed);
+  size_.store(size + 1u, std::memory_order_relaxed);
+  array_.store(array, std::memory_order_relaxed);
+  EndUpdate();
+}
+
+void JitCodeIndex::Remove(const void* code_ptr) {
+  RemoveIf([code_ptr](const void* code) { return code == code_ptr; });
+}
+
+bool JitCodeIndex::Lookup(uintptr_t pc, /* out */ OatQuickMethodHeader** method_header) const {
+  for (size_t attempt = 0; attempt != kMaxLookupAttempts; ++attempt) {
+    uint32_t sequence = sequence_.load(std::memory_order_acquire);
+    if ((sequence & 1u) != 0u) {
+      continue;  // An update is in progress.
+    }
+    const Array* array = array_.load(std::memory_order_relaxed);
+    // A racing update may have published a bigger size for a new array.
+    size_t size = (array == nullptr)
+        ? 0u
+        : std::min(size_.load(std::memory_order_relaxed), array->capacity);
+    // Find the last code pointer lower than `pc`.
+    size_t low = 0u;
+    size_t high = size;
+    while (low != high) {
+      size_t mid = low + (high - low) / 2u;
+      if (array->entries[mid].load(std::memory_order_relaxed) < pc) {
+        low = mid + 1u;
+      } else {
+        high = mid;
+      }
+    }
+    OatQuickMethodHeader* found = nullptr;
+    uintptr_t code = (low != 0u) ? array->entries[low - 1u].load(std::memory_order_relaxed) : 0u;
+    // Racing updates may also show an entry that was never filled.
+    if (code != 0u) {
+      // The code may have been freed since we read the entry, in which case the sequence
+      // count below has changed and we ignore what we read from its header.
+      OatQuickMethodHeader* header =
+          OatQuickMethodHeader::FromCodePointer(reinterpret_cast<const void*>(code));
+      if (header->Contains(pc)) {
+        found = header;
+      }
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (sequence_.load(std::memory_order_relaxed) == sequence) {
+      *method_header = found;
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace jit
+}  // namespace art
@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2019 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_JIT_JIT_CODE_INDEX_H_
+#define ART_RUNTIME_JIT_JIT_CODE_INDEX_H_
+
+#include <stdint.h>
+#include <memory>
+#include <vector>
+
+#include "base/atomic.h"
+#include "base/macros.h"
+
+namespace art {
+
+class OatQuickMethodHeader;
+
+namespace jit {
+
+// Sorted array of the code pointers of the methods compiled in the code cache, for finding the
+// method header containing a pc without taking the JitCodeCache lock. Updates must be serialized
+// by the caller and bump a sequence count around their changes. Lookups are retried when the
+// sequence count shows they raced with an update. Replaced arrays are only freed with the index,
+// as a lookup may still be searching them. They grow geometrically, so this does not more than
+// double the memory used.
+class JitCodeIndex {
+ public:
+  JitCodeIndex();
+  ~JitCodeIndex();
+
+  void Insert(const void* code_ptr);
+  void Remove(const void* code_ptr);
+
+  // Removes all the code pointers for which `predicate` returns true.
+  template <typename Predicate>
+  void RemoveIf(Predicate&& predicate) {
+    BeginUpdate();
+    size_t size = size_.load(std::memory_order_relaxed);
+    size_t new_size = 0u;
+    for (size_t i = 0; i != size; ++i) {
+      uintptr_t code = arrays_.back()->entries[i].load(std::memory_order_relaxed);
+      if (!predicate(reinterpret_cast<const void*>(code))) {
+        arrays_.back()->entries[new_size].store(code, std::memory_order_relaxed);
+        ++new_size;
+      }
+    }
+    size_.store(new_size, std::memory_order_relaxed);
+    EndUpdate();
+  }
+
+  // Looks up the method header containing `pc`, null if there is none. Returns false if the
+  // lookup kept racing with updates, the caller should then search under the lock.
+  bool Lookup(uintptr_t pc, /* out */ OatQuickMethodHeader** method_header) const;
+
+  size_t Size() const {
+    return size_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  struct Array {
+    explicit Array(size_t capacity_in)
+        : capacity(capacity_in), entries(new Atomic<uintptr_t>[capacity_in]()) {}
+
+    const size_t capacity;
+    std::unique_ptr<Atomic<uintptr_t>[]> entries;
+  };
+
+  static constexpr size_t kInitialCapacity = 64u;
+  static constexpr size_t kMaxLookupAttempts = 4u;
+
+  void BeginUpdate();
+  void EndUpdate();
+
+  // Odd while an update is in progress.
+  Atomic<uint32_t> sequence_;
+  // The array searched by lookups, null until the first insertion.
+  Atomic<Array*> array_;
+  Atomic<size_t> size_;
+  // All the arrays ever used, the last one is the current one. Only used by updates.
+  std::vector<std::unique_ptr<Array>> arrays_;
+
+  DISALLOW_COPY_AND_ASSIGN(JitCodeIndex);
+};
+
+}  // namespace jit
+}  // namespace art
+
+#endif  // ART_RUNTIME_JIT_JIT_CODE_INDEX_H_
@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2019 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "jit_code_index.h"
+
+#include <new>
+
+#include "gtest/gtest.h"
+
+#include "base/macros.h"
+#include "oat_quick_method_header.h"
+
+namespace art {
+namespace jit {
+
+static constexpr size_t kNumMethods = 200u;
+static constexpr size_t kMethodSpacing = 64u;
+static constexpr uint32_t kCodeSize = 32u;
+
+class JitCodeIndexTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    for (size_t i = 0; i != kNumMethods; ++i) {
+      uint8_t* code = &memory_[(i + 1u) * kMethodSpacing];
+      new (OatQuickMethodHeader::FromCodePointer(code)) OatQuickMethodHeader(0u, kCodeSize);
+    }
+  }
+
+  const void* GetCode(size_t i) const {
+    return &memory_[(i + 1u) * kMethodSpacing];
+  }
+
+  OatQuickMethodHeader* Lookup(const JitCodeIndex& index, uintptr_t pc) {
+    OatQuickMethodHeader* method_header = nullptr;
+    // Without concurrent updates the lookup always succeeds.
+    EXPECT_TRUE(index.Lookup(pc, &method_header));
+    return method_header;
+  }
+
+  uintptr_t PcIn(size_t i) const {
+    return reinterpret_cast<uintptr_t>(GetCode(i)) + kCodeSize / 2u;
+  }
+
+  alignas(kMethodSpacing) uint8_t memory_[(kNumMethods + 1u) * kMethodSpacing];
+};
+
+TEST_F(JitCodeIndexTest, Lookup) {
+  JitCodeIndex index;
+  EXPECT_EQ(nullptr, Lookup(index, PcIn(0u)));
+
+  // Insert out of order, more than fit in the initial array.
+  for (size_t i = 0; i != kNumMethods; i += 2u) {
+    index.Insert(GetCode(i));
+  }
+  for (size_t i = 1; i < kNumMethods; i += 2u) {
+    index.Insert(GetCode(i));
+  }
+  EXPECT_EQ(kNumMethods, index.Size());
+  for (size_t i = 0; i != kNumMethods; ++i) {
+    EXPECT_EQ(OatQuickMethodHeader::FromCodePointer(GetCode(i)), Lookup(index, PcIn(i))) << i;
+    // Between the end of the code of a method and the start of the next one.
+    uintptr_t gap_pc = reinterpret_cast<uintptr_t>(GetCode(i)) + kCodeSize + 8u;
+    EXPECT_EQ(nullptr, Lookup(index, gap_pc)) << i;
+  }
+  EXPECT_EQ(nullptr, Lookup(index, reinterpret_cast<uintptr_t>(&memory_[0])));
+}
+
+TEST_F(JitCodeIndexTest, Remove) {
+  JitCodeIndex index;
+  for (size_t i = 0; i != kNumMethods; ++i) {
+    index.Insert(GetCode(i));
+  }
+  index.Remove(GetCode(10u));
+  EXPECT_EQ(kNumMethods - 1u, index.Size());
+  EXPECT_EQ(nullptr, Lookup(index, PcIn(10u)));
+  EXPECT_EQ(OatQuickMethodHeader::FromCodePointer(GetCode(11u)), Lookup(index, PcIn(11u)));
+
+  index.RemoveIf([this](const void* code_ptr) {
+    size_t offset = reinterpret_cast<const uint8_t*>(code_ptr) - &memory_[0];
+    return offset % (2u * kMethodSpacing) == 0u;
+  });
+  for (size_t i = 0; i != kNumMethods; ++i) {
+    // GetCode(i) is at (i + 1) * kMethodSpacing, so odd methods were removed.
+    OatQuickMethodHeader* expected =
+        (i % 2u == 0u && i != 10u) ? OatQuickMethodHeader::FromCodePointer(GetCode(i)) : nullptr;
+    EXPECT_EQ(expected, Lookup(index, PcIn(i))) << i;
+  }
+}
+
+}  // namespace jit
+}  // namespace art
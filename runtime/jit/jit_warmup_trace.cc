@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "jit_warmup_trace.h"
+
+#include <inttypes.h>
+
+#include <memory>
+
+#include "android-base/stringprintf.h"
+
+#include "art_method-inl.h"
+#include "base/os.h"
+#include "base/time_utils.h"
+#include "base/unix_file/fd_file.h"
+#include "thread-current-inl.h"
+
+namespace art {
+namespace jit {
+
+JitWarmupTrace::JitWarmupTrace() : lock_("JIT warmup trace lock") {}
+
+void JitWarmupTrace::Record(Event event, Tier tier, ArtMethod* method) {
+  uint64_t time_ns = NanoTime();
+  // The name is resolved now, as the method may be unloaded by the time the trace is written.
+  std::string name = method->PrettyMethod();
+  MutexLock mu(Thread::Current(), lock_);
+  entries_.push_back(Entry{time_ns, event, tier, std::move(name)});
+}
+
+std::vector<JitWarmupTrace::Entry> JitWarmupTrace::GetEntries() {
+  MutexLock mu(Thread::Current(), lock_);
+  return entries_;
+}
+
+const char* JitWarmupTrace::EventName(Event event) {
+  switch (event) {
+    case Event::kFirstSample: return "first_sample";
+    case Event::kHot: return "hot";
+    case Event::kEnqueued: return "enqueued";
+    case Event::kCompileStart: return "compile_start";
+    case Event::kCompileEnd: return "compile_end";
+    case Event::kCompileFailed: return "compile_failed";
+    case Event::kInstalled: return "installed";
+  }
+  UNREACHABLE();
+}
+
+const char* JitWarmupTrace::TierName(Tier tier) {
+  switch (tier) {
+    case Tier::kNone: return "-";
+    case Tier::kBaseline: return "baseline";
+    case Tier::kOptimized: return "optimized";
+    case Tier::kOsr: return "osr";
+  }
+  UNREACHABLE();
+}
+
+bool JitWarmupTrace::WriteToFile(const std::string& path, std::string* error_msg) {
+  std::string contents = "time_ns,event,tier,method\n";
+  {
+    MutexLock mu(Thread::Current(), lock_);
+    for (const Entry& entry : entries_) {
+      // Method names contain commas in their signature, so they are quoted.
+      contents += android::base::StringPrintf("%" PRIu64 ",%s,%s,\"%s\"\n",
+                                              entry.time_ns,
+                                              EventName(entry.event),
+                                              TierName(entry.tier),
+                                              entry.method.c_str());
+    }
+  }
+  std::unique_ptr<File> out(OS::CreateEmptyFileWriteOnly(path.c_str()));
+  if (out == nullptr) {
+    *error_msg = "Could not open " + path + " for writing";
+    return false;
+  }
+  if (!out->WriteFully(contents.c_str(), contents.size())) {
+    *error_msg = "Could not write JIT warmup trace to " + path;
+    out->Unlink();
+    return false;
+  }
+  if (out->FlushClose() != 0) {
+    *error_msg = "Could not flush and close " + path;
+    out->Unlink();
+    return false;
+  }
+  return true;
+}
+
+}  // namespace jit
+}  // namespace art
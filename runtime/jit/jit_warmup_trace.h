@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_JIT_JIT_WARMUP_TRACE_H_
+#define ART_RUNTIME_JIT_JIT_WARMUP_TRACE_H_
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "base/locks.h"
+#include "base/macros.h"
+#include "base/mutex.h"
+
+namespace art {
+
+class ArtMethod;
+
+namespace jit {
+
+// Timestamped log of the steps each method goes through on its way to JIT compiled code, from
+// its first sample to the installation of its code in the JitCodeCache. Enabled with
+// -Xjitwarmuptrace:<file>, and written to that file when the JIT shuts down. The time between
+// the steps gives the warmup curve of a workload and the latency of the compilation queue.
+class JitWarmupTrace {
+ public:
+  enum class Event : uint8_t {
+    kFirstSample,    // The method got its first hotness sample.
+    kHot,            // The hotness counter crossed the compile threshold.
+    kEnqueued,       // A compilation task was added to the JIT thread pool.
+    kCompileStart,   // A JIT thread started compiling the method.
+    kCompileEnd,     // The compilation finished successfully.
+    kCompileFailed,  // The compilation failed or was abandoned.
+    kInstalled,      // The code was committed to the JitCodeCache.
+  };
+
+  // Compilation tier of an event, kNone for the events which do not concern a compilation.
+  enum class Tier : uint8_t {
+    kNone,
+    kBaseline,
+    kOptimized,
+    kOsr,
+  };
+
+  struct Entry {
+    uint64_t time_ns;
+    Event event;
+    Tier tier;
+    std::string method;
+  };
+
+  JitWarmupTrace();
+
+  void Record(Event event, Tier tier, ArtMethod* method)
+      REQUIRES(!lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  std::vector<Entry> GetEntries() REQUIRES(!lock_);
+
+  // Writes one comma separated line per event, preceded by a header line.
+  bool WriteToFile(const std::string& path, std::string* error_msg) REQUIRES(!lock_);
+
+  static const char* EventName(Event event);
+  static const char* TierName(Tier tier);
+
+ private:
+  Mutex lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
+  std::vector<Entry> entries_ GUARDED_BY(lock_);
+
+  DISALLOW_COPY_AND_ASSIGN(JitWarmupTrace);
+};
+
+}  // namespace jit
+}  // namespace art
+
+#endif  // ART_RUNTIME_JIT_JIT_WARMUP_TRACE_H_
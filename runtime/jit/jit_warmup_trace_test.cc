@@ -0,0 +1,65 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "jit_warmup_trace.h"
+
+#include <string>
+
+#include "android-base/file.h"
+
+#include "art_method-inl.h"
+#include "class_linker-inl.h"
+#include "common_runtime_test.h"
+#include "mirror/class-inl.h"
+#include "scoped_thread_state_change-inl.h"
+
+namespace art {
+namespace jit {
+
+class JitWarmupTraceTest : public CommonRuntimeTest {};
+
+TEST_F(JitWarmupTraceTest, RecordAndWrite) {
+  ScopedObjectAccess soa(Thread::Current());
+  ObjPtr<mirror::Class> klass = class_linker_->FindSystemClass(soa.Self(), "Ljava/lang/Object;");
+  ASSERT_TRUE(klass != nullptr);
+  ArtMethod* method = klass->FindClassMethod("hashCode", "()I", kRuntimePointerSize);
+  ASSERT_TRUE(method != nullptr);
+
+  JitWarmupTrace trace;
+  trace.Record(JitWarmupTrace::Event::kHot, JitWarmupTrace::Tier::kNone, method);
+  trace.Record(JitWarmupTrace::Event::kCompileStart, JitWarmupTrace::Tier::kBaseline, method);
+  trace.Record(JitWarmupTrace::Event::kInstalled, JitWarmupTrace::Tier::kNone, method);
+
+  std::vector<JitWarmupTrace::Entry> entries = trace.GetEntries();
+  ASSERT_EQ(3u, entries.size());
+  EXPECT_EQ(JitWarmupTrace::Event::kHot, entries[0].event);
+  EXPECT_EQ(JitWarmupTrace::Tier::kBaseline, entries[1].tier);
+  EXPECT_EQ("int java.lang.Object.hashCode()", entries[2].method);
+  EXPECT_LE(entries[0].time_ns, entries[1].time_ns);
+  EXPECT_LE(entries[1].time_ns, entries[2].time_ns);
+
+  ScratchFile file;
+  std::string error_msg;
+  ASSERT_TRUE(trace.WriteToFile(file.GetFilename(), &error_msg)) << error_msg;
+  std::string contents;
+  ASSERT_TRUE(android::base::ReadFileToString(file.GetFilename(), &contents));
+  EXPECT_EQ(0u, contents.find("time_ns,event,tier,method\n"));
+  EXPECT_NE(std::string::npos,
+            contents.find(",compile_start,baseline,\"int java.lang.Object.hashCode()\"\n"));
+}
+
+}  // namespace jit
+}  // namespace art
@@ -26,6 +26,7 @@
 #include "art_method-inl.h"
 #include "base/enums.h"
 #include "base/logging.h"  // For VLOG.
+#include "base/os.h"
 #include "base/scoped_arena_containers.h"
 #include "base/stl_util.h"
 #include "base/systrace.h"
@@ -108,6 +109,9 @@ ProfileSaver::~ProfileSaver() {
   for (auto& it : profile_cache_) {
     delete it.second;
   }
+  for (auto& it : saved_profiles_) {
+    delete it.second;
+  }
 }
 
 void ProfileSaver::NotifyStartupCompleted() {
@@ -506,6 +510,128 @@ void ProfileSaver::FetchAndCacheResolvedClassesAndMethods(bool startup) {
                  << PrettyDuration(NanoTime() - start_time);
 }
 
+bool ProfileSaver::CompactProfile(const std::string& filename, ProfileCompilationInfo* info) {
+  uint64_t bytes_written;
+  // Write the profile before clearing the log. If we do not get to clear it, its records
+  // are merged again at the next load, which is harmless.
+  if (!info->Save(filename, &bytes_written)) {
+    LOG(WARNING) << "Could not save profiling info to " << filename;
+    total_number_of_failed_writes_++;
+    return false;
+  }
+  total_number_of_writes_++;
+  total_bytes_written_ += bytes_written;
+  if (!ProfileCompilationInfo::ClearDeltaLog(filename)) {
+    LOG(WARNING) << "Could not clear the profile delta log of " << filename;
+  }
+  return true;
+}
+
+bool ProfileSaver::SaveProfileDelta(const std::string& filename,
+                                    const std::vector<ProfileMethodInfo>& profile_methods,
+                                    bool force_save,
+                                    /*out*/uint16_t* number_of_new_methods) {
+  ArenaPool* arena_pool = Runtime::Current()->GetArenaPool();
+  bool profile_file_saved = false;
+  auto saved_it = saved_profiles_.find(filename);
+  if (saved_it == saved_profiles_.end()) {
+    // First save for this file: read what is on disk once. Whoever reads the profile next
+    // (e.g. profman during background dexopt) may only look at the profile itself, so fold
+    // any delta log left over by a previous run back into it.
+    std::unique_ptr<ProfileCompilationInfo> saved_info(new ProfileCompilationInfo(arena_pool));
+    if (!saved_info->Load(filename, /*clear_if_invalid=*/ true)) {
+      LOG(WARNING) << "Could not forcefully load profile " << filename;
+      return false;
+    }
+    std::string delta_log = ProfileCompilationInfo::GetDeltaLogFilename(filename);
+    int64_t delta_log_size = OS::GetFileSizeBytes(delta_log.c_str());
+    if (delta_log_size > 0) {
+      if (!saved_info->MergeWithDeltaLog(filename)) {
+        LOG(WARNING) << "Could not merge the profile delta log. Keeping the profile data only.";
+        saved_info->ClearData();
+        if (!saved_info->Load(filename, /*clear_if_invalid=*/ true)) {
+          return false;
+        }
+      }
+      if (!CompactProfile(filename, saved_info.get())) {
+        return false;
+      }
+      profile_file_saved = true;
+    }
+    saved_it = saved_profiles_.Put(filename, saved_info.release());
+  }
+  ProfileCompilationInfo* saved_info = saved_it->second;
+
+  ProfileCompilationInfo delta(arena_pool);
+  auto profile_cache_it = profile_cache_.find(filename);
+  if (!delta.AddMethods(profile_methods,
+                        ProfileCompilationInfo::MethodHotness::kFlagPostStartup) ||
+      (profile_cache_it != profile_cache_.end() && !delta.MergeWith(*profile_cache_it->second))) {
+    LOG(WARNING) << "Could not build the profile delta for " << filename;
+    return profile_file_saved;
+  }
+  // Everything we have collected so far is in the delta; only keep what is new.
+  delta.RemoveDataPresentIn(*saved_info);
+  uint32_t delta_number_of_methods = delta.GetNumberOfMethods();
+  uint32_t delta_number_of_classes = delta.GetNumberOfResolvedClasses();
+  if (!force_save &&
+      delta_number_of_methods < options_.GetMinMethodsToSave() &&
+      delta_number_of_classes < options_.GetMinClassesToSave()) {
+    VLOG(profiler) << "Not enough information to save to: " << filename
+                   << " Number of methods: " << delta_number_of_methods
+                   << " Number of classes: " << delta_number_of_classes;
+    total_number_of_skipped_writes_++;
+    return profile_file_saved;
+  }
+
+  if (!saved_info->MergeWith(delta)) {
+    // The profile on disk is for different dex files. Start over with the new data.
+    LOG(WARNING) << "Could not merge the profile. Clearing the profile data.";
+    saved_info->ClearData();
+    if (!saved_info->MergeWith(delta)) {
+      return profile_file_saved;
+    }
+    force_save = true;
+  }
+  if (number_of_new_methods != nullptr) {
+    *number_of_new_methods =
+        std::max(static_cast<uint16_t>(delta_number_of_methods), *number_of_new_methods);
+  }
+
+  std::string delta_log = ProfileCompilationInfo::GetDeltaLogFilename(filename);
+  int64_t delta_log_size = OS::GetFileSizeBytes(delta_log.c_str());
+  bool compact = force_save ||
+      (delta_log_size > 0 &&
+       static_cast<uint64_t>(delta_log_size) >= options_.GetMaxDeltaLogBytes());
+  bool saved;
+  if (compact) {
+    saved = CompactProfile(filename, saved_info);
+  } else {
+    uint64_t bytes_written = 0;
+    saved = delta.AppendToDeltaLog(filename, &bytes_written);
+    if (saved) {
+      total_number_of_writes_++;
+      total_bytes_written_ += bytes_written;
+    } else {
+      LOG(WARNING) << "Could not append profiling info to " << delta_log;
+      total_number_of_failed_writes_++;
+    }
+  }
+  if (!saved) {
+    // Do not remember data we failed to write; the next save will pick it up again.
+    saved_profiles_.erase(saved_it);
+    delete saved_info;
+    return profile_file_saved;
+  }
+  // We managed to save the profile. Clear the cache stored during startup.
+  if (profile_cache_it != profile_cache_.end()) {
+    ProfileCompilationInfo* cached_info = profile_cache_it->second;
+    profile_cache_.erase(profile_cache_it);
+    delete cached_info;
+  }
+  return true;
+}
+
 bool ProfileSaver::ProcessProfilingInfo(bool force_save, /*out*/uint16_t* number_of_new_methods) {
   ScopedTrace trace(__PRETTY_FUNCTION__);
 
@@ -547,6 +673,12 @@ bool ProfileSaver::ProcessProfilingInfo(bool force_save, /*out*/uint16_t* number
       jit_code_cache_->GetProfiledMethods(locations, profile_methods);
       total_number_of_code_cache_queries_++;
     }
+    if (options_.GetMaxDeltaLogBytes() != 0u) {
+      if (SaveProfileDelta(filename, profile_methods, force_save, number_of_new_methods)) {
+        profile_file_saved = true;
+      }
+      continue;
+    }
     {
       ProfileCompilationInfo info(Runtime::Current()->GetArenaPool());
       if (!info.Load(filename, /*clear_if_invalid=*/ true)) {
@@ -814,6 +946,22 @@ bool ProfileSaver::IsStarted() {
   return instance_ != nullptr;
 }
 
+std::vector<std::string> ProfileSaver::GetTrackedProfiles() {
+  MutexLock mu(Thread::Current(), *Locks::profiler_lock_);
+  std::vector<std::string> profiles;
+  if (instance_ != nullptr) {
+    std::set<std::string> filenames;
+    for (const auto& it : instance_->tracked_dex_base_locations_) {
+      filenames.insert(it.first);
+    }
+    for (const auto& it : instance_->tracked_dex_base_locations_to_be_resolved_) {
+      filenames.insert(it.first);
+    }
+    profiles.assign(filenames.begin(), filenames.end());
+  }
+  return profiles;
+}
+
 static void AddTrackedLocationsToMap(const std::string& output_filename,
                                      const std::vector<std::string>& code_paths,
                                      SafeMap<std::string, std::set<std::string>>* map) {
@@ -45,6 +45,9 @@ class ProfileSaver {
   // Returns true if the profile saver is started.
   static bool IsStarted() REQUIRES(!Locks::profiler_lock_);
 
+  // Returns the profile files the saver writes to, or an empty vector if it is not started.
+  static std::vector<std::string> GetTrackedProfiles() REQUIRES(!Locks::profiler_lock_);
+
   // If the profile saver is running, dumps statistics to the `os`. Otherwise it does nothing.
   static void DumpInstanceInfo(std::ostream& os);
 
@@ -87,6 +90,20 @@ class ProfileSaver {
     REQUIRES(!Locks::profiler_lock_)
     REQUIRES(!Locks::mutator_lock_);
 
+  // Save the profiling data of `filename` that is not yet on disk by appending it to the
+  // delta log of the profile. The profile is rewritten in full and the log cleared once the
+  // log grows past the configured size, on the first save and on forced saves.
+  // Returns true if any data was written.
+  bool SaveProfileDelta(const std::string& filename,
+                        const std::vector<ProfileMethodInfo>& profile_methods,
+                        bool force_save,
+                        /*out*/uint16_t* number_of_new_methods)
+    REQUIRES(!Locks::profiler_lock_)
+    REQUIRES(!Locks::mutator_lock_);
+
+  // Rewrite `filename` with `info` and clear its delta log.
+  bool CompactProfile(const std::string& filename, ProfileCompilationInfo* info);
+
   void NotifyJitActivityInternal() REQUIRES(!wait_lock_);
   void WakeUpSaver() REQUIRES(wait_lock_);
 
@@ -136,6 +153,10 @@ class ProfileSaver {
   // to just a few hundreds entries in the ProfileCompilationInfo objects.
   SafeMap<std::string, ProfileCompilationInfo*> profile_cache_;
 
+  // The data that is already on disk, in the profile or its delta log, for each tracked
+  // file. Only used when saving deltas, so that we do not need to read the files back.
+  SafeMap<std::string, ProfileCompilationInfo*> saved_profiles_;
+
   // Save period condition support.
   Mutex wait_lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
   ConditionVariable period_condition_ GUARDED_BY(wait_lock_);
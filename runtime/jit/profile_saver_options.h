@@ -30,6 +30,8 @@ struct ProfileSaverOptions {
   static constexpr uint32_t kMinNotificationBeforeWake = 10;
   static constexpr uint32_t kMaxNotificationBeforeWake = 50;
   static constexpr uint32_t kHotStartupMethodSamplesNotSet = std::numeric_limits<uint32_t>::max();
+  // By default profiles are rewritten in full at every save and no delta log is kept.
+  static constexpr uint32_t kMaxDeltaLogBytes = 0;
 
   ProfileSaverOptions() :
     enabled_(false),
@@ -43,7 +45,8 @@ struct ProfileSaverOptions {
     profile_path_(""),
     profile_boot_class_path_(false),
     profile_aot_code_(false),
-    wait_for_jit_notifications_to_save_(true) {}
+    wait_for_jit_notifications_to_save_(true),
+    max_delta_log_bytes_(kMaxDeltaLogBytes) {}
 
   ProfileSaverOptions(
       bool enabled,
@@ -57,7 +60,8 @@ struct ProfileSaverOptions {
       const std::string& profile_path,
       bool profile_boot_class_path,
       bool profile_aot_code = false,
-      bool wait_for_jit_notifications_to_save = true)
+      bool wait_for_jit_notifications_to_save = true,
+      uint32_t max_delta_log_bytes = kMaxDeltaLogBytes)
   : enabled_(enabled),
     min_save_period_ms_(min_save_period_ms),
     save_resolved_classes_delay_ms_(save_resolved_classes_delay_ms),
@@ -69,7 +73,8 @@ struct ProfileSaverOptions {
     profile_path_(profile_path),
     profile_boot_class_path_(profile_boot_class_path),
     profile_aot_code_(profile_aot_code),
-    wait_for_jit_notifications_to_save_(wait_for_jit_notifications_to_save) {}
+    wait_for_jit_notifications_to_save_(wait_for_jit_notifications_to_save),
+    max_delta_log_bytes_(max_delta_log_bytes) {}
 
   bool IsEnabled() const {
     return enabled_;
@@ -118,6 +123,11 @@ struct ProfileSaverOptions {
   void SetWaitForJitNotificationsToSave(bool value) {
     wait_for_jit_notifications_to_save_ = value;
   }
+  // If non-zero, saves append only the new profile data to a delta log next to the
+  // profile, and the profile is rewritten once the log grows past this size.
+  uint32_t GetMaxDeltaLogBytes() const {
+    return max_delta_log_bytes_;
+  }
 
   friend std::ostream & operator<<(std::ostream &os, const ProfileSaverOptions& pso) {
     os << "enabled_" << pso.enabled_
@@ -130,7 +140,8 @@ struct ProfileSaverOptions {
         << ", max_notification_before_wake_" << pso.max_notification_before_wake_
         << ", profile_boot_class_path_" << pso.profile_boot_class_path_
         << ", profile_aot_code_" << pso.profile_aot_code_
-        << ", wait_for_jit_notifications_to_save_" << pso.wait_for_jit_notifications_to_save_;
+        << ", wait_for_jit_notifications_to_save_" << pso.wait_for_jit_notifications_to_save_
+        << ", max_delta_log_bytes_" << pso.max_delta_log_bytes_;
     return os;
   }
 
@@ -148,6 +159,7 @@ struct ProfileSaverOptions {
   bool profile_boot_class_path_;
   bool profile_aot_code_;
   bool wait_for_jit_notifications_to_save_;
+  uint32_t max_delta_log_bytes_;
 };
 
 }  // namespace art
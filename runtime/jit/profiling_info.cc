@@ -31,7 +31,9 @@ ProfilingInfo::ProfilingInfo(ArtMethod* method, const std::vector<uint32_t>& ent
         number_of_inline_caches_(entries.size()),
         current_inline_uses_(0),
         is_method_being_compiled_(false),
-        is_osr_method_being_compiled_(false) {
+        is_osr_method_being_compiled_(false),
+        is_baseline_compiled_(false) {
+  memset(&deoptimization_counts_, 0, sizeof(deoptimization_counts_));
   memset(&cache_, 0, number_of_inline_caches_ * sizeof(InlineCache));
   for (size_t i = 0; i < number_of_inline_caches_; ++i) {
     cache_[i].dex_pc_ = entries[i];
@@ -79,13 +81,24 @@ InlineCache* ProfilingInfo::GetInlineCache(uint32_t dex_pc) {
   UNREACHABLE();
 }
 
+// Bump the receiver count of an inline cache entry. Concurrent updates may be lost,
+// which is fine as the counts are only used as a frequency estimate.
+static void IncrementReceiverCount(uint16_t* count) {
+  auto atomic_count = reinterpret_cast<Atomic<uint16_t>*>(count);
+  uint16_t value = atomic_count->load(std::memory_order_relaxed);
+  if (value != std::numeric_limits<uint16_t>::max()) {
+    atomic_count->store(value + 1u, std::memory_order_relaxed);
+  }
+}
+
 void ProfilingInfo::AddInvokeInfo(uint32_t dex_pc, mirror::Class* cls) {
   InlineCache* cache = GetInlineCache(dex_pc);
   for (size_t i = 0; i < InlineCache::kIndividualCacheSize; ++i) {
     mirror::Class* existing = cache->classes_[i].Read<kWithoutReadBarrier>();
     mirror::Class* marked = ReadBarrier::IsMarked(existing);
     if (marked == cls) {
-      // Receiver type is already in the cache, nothing else to do.
+      // Receiver type is already in the cache, just record that we saw it again.
+      IncrementReceiverCount(&cache->counts_[i]);
       return;
     } else if (marked == nullptr) {
       // Cache entry is empty, try to put `cls` in it.
@@ -100,7 +113,10 @@ void ProfilingInfo::AddInvokeInfo(uint32_t dex_pc, mirror::Class* cls) {
         // entry in case the entry contains `cls`.
         --i;
       } else {
-        // We successfully set `cls`, just return.
+        // We successfully set `cls`. The entry may have been cleared by the GC,
+        // so restart its count rather than inheriting the one of the old class.
+        reinterpret_cast<Atomic<uint16_t>*>(&cache->counts_[i])->store(
+            1u, std::memory_order_relaxed);
         return;
       }
     }
@@ -17,9 +17,11 @@
 #ifndef ART_RUNTIME_JIT_PROFILING_INFO_H_
 #define ART_RUNTIME_JIT_PROFILING_INFO_H_
 
+#include <limits>
 #include <vector>
 
 #include "base/macros.h"
+#include "deoptimization_kind.h"
 #include "gc_root.h"
 
 namespace art {
@@ -44,6 +46,10 @@ class InlineCache {
  private:
   uint32_t dex_pc_;
   GcRoot<mirror::Class> classes_[kIndividualCacheSize];
+  // Approximate number of times the corresponding entry of classes_ has been seen
+  // as the receiver. Updated without synchronization and saturating, so only
+  // meaningful relative to the other entries.
+  uint16_t counts_[kIndividualCacheSize];
 
   friend class jit::JitCodeCache;
   friend class ProfilingInfo;
@@ -91,6 +97,26 @@ class ProfilingInfo {
     }
   }
 
+  bool IsBaselineCompiled() const {
+    return is_baseline_compiled_;
+  }
+
+  void SetIsBaselineCompiled(bool value) {
+    is_baseline_compiled_ = value;
+  }
+
+  // Number of times compiled code of the method got invalidated by a deoptimization of `kind`.
+  uint8_t GetDeoptimizationCount(DeoptimizationKind kind) const {
+    return deoptimization_counts_[static_cast<size_t>(kind)];
+  }
+
+  void IncrementDeoptimizationCount(DeoptimizationKind kind) {
+    uint8_t* count = &deoptimization_counts_[static_cast<size_t>(kind)];
+    if (*count != std::numeric_limits<uint8_t>::max()) {
+      ++*count;
+    }
+  }
+
   void SetSavedEntryPoint(const void* entry_point) {
     saved_entry_point_ = entry_point;
   }
@@ -105,6 +131,7 @@ class ProfilingInfo {
       memset(&cache->classes_[0],
              0,
              InlineCache::kIndividualCacheSize * sizeof(GcRoot<mirror::Class>));
+      memset(&cache->counts_[0], 0, InlineCache::kIndividualCacheSize * sizeof(uint16_t));
     }
   }
 
@@ -154,6 +181,14 @@ class ProfilingInfo {
   bool is_method_being_compiled_;
   bool is_osr_method_being_compiled_;
 
+  // Whether the compiled code of the ArtMethod comes from the baseline compiler, and is to be
+  // replaced by optimized code once hot enough. Also guarded by the JIT code cache lock.
+  bool is_baseline_compiled_;
+
+  // Deoptimization counts, indexed by DeoptimizationKind. The compiler stops speculating with
+  // the kinds that failed too often. Also guarded by the JIT code cache lock.
+  uint8_t deoptimization_counts_[static_cast<size_t>(DeoptimizationKind::kLast) + 1];
+
   // Dynamically allocated array of size `number_of_inline_caches_`.
   InlineCache cache_[0];
 
@@ -35,6 +35,7 @@
 #include "gc/heap.h"
 #include "gc_root-inl.h"
 #include "indirect_reference_table-inl.h"
+#include "jni_env_ext.h"
 #include "jni_internal.h"
 #include "mirror/class-inl.h"
 #include "mirror/class_loader.h"
@@ -268,11 +269,13 @@ class Libraries {
   }
 
   // See section 11.3 "Linking Native Methods" of the JNI spec.
-  void* FindNativeMethod(Thread* self, ArtMethod* m, std::string& detail)
+  void* FindNativeMethod(Thread* self,
+                         ArtMethod* m,
+                         const std::string& jni_short_name,
+                         const std::string& jni_long_name,
+                         std::string& detail)
       REQUIRES(!Locks::jni_libraries_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_) {
-    std::string jni_short_name(m->JniShortName());
-    std::string jni_long_name(m->JniLongName());
     const ObjPtr<mirror::ClassLoader> declaring_class_loader =
         m->GetDeclaringClass()->GetClassLoader();
     ScopedObjectAccessUnchecked soa(Thread::Current());
@@ -511,6 +514,31 @@ JavaVMExt::JavaVMExt(Runtime* runtime,
 
 JavaVMExt::~JavaVMExt() {
   UnloadBootNativeLibraries();
+  for (Atomic<JNIEnvExt*>& cached_jni_env : cached_jni_envs_) {
+    delete cached_jni_env.exchange(nullptr, std::memory_order_acquire);
+  }
+}
+
+JNIEnvExt* JavaVMExt::TakeCachedJniEnv() {
+  for (Atomic<JNIEnvExt*>& cached_jni_env : cached_jni_envs_) {
+    if (cached_jni_env.load(std::memory_order_relaxed) != nullptr) {
+      JNIEnvExt* env = cached_jni_env.exchange(nullptr, std::memory_order_acquire);
+      if (env != nullptr) {
+        return env;
+      }
+    }
+  }
+  return nullptr;
+}
+
+bool JavaVMExt::CacheJniEnv(JNIEnvExt* env) {
+  DCHECK_EQ(env->GetVm(), this);
+  for (Atomic<JNIEnvExt*>& cached_jni_env : cached_jni_envs_) {
+    if (cached_jni_env.CompareAndSetStrongRelease(nullptr, env)) {
+      return true;
+    }
+  }
+  return false;
 }
 
 // Checking "globals" and "weak_globals" usually requires locks, but we
@@ -1101,9 +1129,10 @@ bool JavaVMExt::LoadNativeLibrary(JNIEnv* env,
   return was_successful;
 }
 
-static void* FindCodeForNativeMethodInAgents(ArtMethod* m) REQUIRES_SHARED(Locks::mutator_lock_) {
-  std::string jni_short_name(m->JniShortName());
-  std::string jni_long_name(m->JniLongName());
+static void* FindCodeForNativeMethodInAgents(ArtMethod* m,
+                                             const std::string& jni_short_name,
+                                             const std::string& jni_long_name)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
   for (const std::unique_ptr<ti::Agent>& agent : Runtime::Current()->GetAgents()) {
     void* fn = agent->FindSymbol(jni_short_name);
     if (fn != nullptr) {
@@ -1128,11 +1157,15 @@ void* JavaVMExt::FindCodeForNativeMethod(ArtMethod* m) {
   CHECK(c->IsInitializing()) << c->GetStatus() << " " << m->PrettyMethod();
   std::string detail;
   Thread* const self = Thread::Current();
-  void* native_method = libraries_->FindNativeMethod(self, m, detail);
+  // Mangle the names once, they are needed for every library and agent searched.
+  const std::string jni_short_name(m->JniShortName());
+  const std::string jni_long_name(m->JniLongName());
+  void* native_method =
+      libraries_->FindNativeMethod(self, m, jni_short_name, jni_long_name, detail);
   if (native_method == nullptr) {
     // Lookup JNI native methods from native TI Agent libraries. See runtime/ti/agent.h for more
     // information. Agent libraries are searched for native methods after all jni libraries.
-    native_method = FindCodeForNativeMethodInAgents(m);
+    native_method = FindCodeForNativeMethodInAgents(m, jni_short_name, jni_long_name);
   }
   // Throwing can cause libraries_lock to be reacquired.
   if (native_method == nullptr) {
@@ -33,6 +33,7 @@ class Array;
 
 class ArtMethod;
 class IsMarkedVisitor;
+class JNIEnvExt;
 class Libraries;
 class ParsedOptions;
 class Runtime;
@@ -203,6 +204,13 @@ class JavaVMExt : public JavaVM {
 
   void AddEnvironmentHook(GetEnvHook hook);
 
+  // Cache of the JNIEnvExts of detached threads, which saves mapping a new local reference table
+  // for threads that repeatedly attach and detach. Lock-free since envs are cached from the
+  // Thread destructor.
+  JNIEnvExt* TakeCachedJniEnv();
+  // Returns false if the cache is full, the caller keeps ownership of `env` then.
+  bool CacheJniEnv(JNIEnvExt* env);
+
   static bool IsBadJniVersion(int version);
 
   // Return the library search path for the given classloader, if the classloader is of a
@@ -223,6 +231,8 @@ class JavaVMExt : public JavaVM {
 
   void CheckGlobalRefAllocationTracking();
 
+  static constexpr size_t kNumCachedJniEnvs = 8;
+
   Runtime* const runtime_;
 
   // Used for testing. By default, we'll LOG(FATAL) the reason.
@@ -259,6 +269,8 @@ class JavaVMExt : public JavaVM {
   // TODO Maybe move this to Runtime.
   std::vector<GetEnvHook> env_hooks_;
 
+  Atomic<JNIEnvExt*> cached_jni_envs_[kNumCachedJniEnvs];
+
   size_t enable_allocation_tracking_delta_;
   std::atomic<bool> allocation_tracking_enabled_;
   std::atomic<bool> old_allocation_tracking_state_;
@@ -125,6 +125,41 @@ TEST_F(JavaVmExtTest, AttachCurrentThread_SmallStack) {
   EXPECT_EQ(ret_val, nullptr);
 }
 
+static void* attach_and_leak_local_callback(void* arg) {
+  JavaVM* vms_buf[1];
+  jsize num_vms;
+  JNIEnv* env;
+  jint ok = JNI_GetCreatedJavaVMs(vms_buf, arraysize(vms_buf), &num_vms);
+  EXPECT_EQ(JNI_OK, ok);
+  ok = vms_buf[0]->AttachCurrentThread(&env, nullptr);
+  EXPECT_EQ(JNI_OK, ok);
+  if (ok == JNI_OK) {
+    // Leave a local reference behind, a reused env must not keep it.
+    jclass klass = env->FindClass("java/lang/Object");
+    EXPECT_NE(klass, nullptr);
+    *reinterpret_cast<JNIEnv**>(arg) = env;
+    ok = vms_buf[0]->DetachCurrentThread();
+    EXPECT_EQ(JNI_OK, ok);
+  }
+  return nullptr;
+}
+
+TEST_F(JavaVmExtTest, AttachCurrentThread_ReusesJniEnv) {
+  const char* reason = __PRETTY_FUNCTION__;
+  JNIEnv* envs[2] = { nullptr, nullptr };
+  for (JNIEnv*& env : envs) {
+    pthread_t pthread;
+    CHECK_PTHREAD_CALL(pthread_create, (&pthread, nullptr, attach_and_leak_local_callback, &env),
+        reason);
+    void* ret_val;
+    CHECK_PTHREAD_CALL(pthread_join, (pthread, &ret_val), reason);
+    EXPECT_EQ(ret_val, nullptr);
+  }
+  ASSERT_NE(envs[0], nullptr);
+  // The second thread got the env cached when the first one detached.
+  EXPECT_EQ(envs[0], envs[1]);
+}
+
 TEST_F(JavaVmExtTest, DetachCurrentThread) {
   JNIEnv* env;
   jint ok = vm_->AttachCurrentThread(&env, nullptr);
@@ -65,6 +65,11 @@ jint JNIEnvExt::GetEnvHandler(JavaVMExt* vm, /*out*/void** env, jint version) {
 }
 
 JNIEnvExt* JNIEnvExt::Create(Thread* self_in, JavaVMExt* vm_in, std::string* error_msg) {
+  JNIEnvExt* cached = vm_in->TakeCachedJniEnv();
+  if (cached != nullptr) {
+    cached->Reinit(self_in);
+    return cached;
+  }
   std::unique_ptr<JNIEnvExt> ret(new JNIEnvExt(self_in, vm_in, error_msg));
   if (CheckLocalsValid(ret.get())) {
     return ret.release();
@@ -87,6 +92,31 @@ JNIEnvExt::JNIEnvExt(Thread* self_in, JavaVMExt* vm_in, std::string* error_msg)
   unchecked_functions_ = GetJniNativeInterface();
 }
 
+void JNIEnvExt::Destroy(JNIEnvExt* env) {
+  if (!env->CanBeReused() || !env->GetVm()->CacheJniEnv(env)) {
+    delete env;
+  }
+}
+
+bool JNIEnvExt::CanBeReused() const {
+  // Do not keep tables that grew, most threads never need more than the initial capacity.
+  return !runtime_deleted_ && locals_.MaxEntries() == kLocalsInitial;
+}
+
+void JNIEnvExt::Reinit(Thread* self_in) {
+  self_ = self_in;
+  local_ref_cookie_ = kIRTFirstSegment;
+  locals_.Reset();
+  stacked_local_ref_cookies_.clear();
+  monitors_.Clear();
+  locked_objects_.clear();
+  critical_ = 0;
+  critical_start_us_ = 0;
+  MutexLock mu(Thread::Current(), *Locks::jni_function_table_lock_);
+  check_jni_ = vm_->IsCheckJniEnabled();
+  functions = GetFunctionTable(check_jni_);
+}
+
 void JNIEnvExt::SetFunctionsToRuntimeShutdownFunctions() {
   functions = GetRuntimeShutdownNativeInterface();
   runtime_deleted_ = true;
@@ -41,7 +41,10 @@ class JNIEnvExt : public JNIEnv {
  public:
   // Creates a new JNIEnvExt. Returns null on error, in which case error_msg
   // will contain a description of the error.
+  // Reuses a JNIEnvExt of a detached thread if the JavaVMExt has one cached.
   static JNIEnvExt* Create(Thread* self, JavaVMExt* vm, std::string* error_msg);
+  // Deletes `env` or hands it to its JavaVMExt for reuse by the next thread.
+  static void Destroy(JNIEnvExt* env);
   static Offset SegmentStateOffset(size_t pointer_size);
   static Offset LocalRefCookieOffset(size_t pointer_size);
   static Offset SelfOffset(size_t pointer_size);
@@ -149,6 +152,11 @@ class JNIEnvExt : public JNIEnv {
   // the mutator lock, factored out and tagged with NO_THREAD_SAFETY_ANALYSIS.
   static bool CheckLocalsValid(JNIEnvExt* in) NO_THREAD_SAFETY_ANALYSIS;
 
+  // Whether the env can be reused for another thread, and resetting it for `self`. The thread
+  // that owned the env is gone, so nobody else can access the locals.
+  bool CanBeReused() const NO_THREAD_SAFETY_ANALYSIS;
+  void Reinit(Thread* self) NO_THREAD_SAFETY_ANALYSIS REQUIRES(!Locks::jni_function_table_lock_);
+
   // Override of function tables. This applies to both default as well as instrumented (CheckJNI)
   // function tables.
   static const JNINativeInterface* table_override_ GUARDED_BY(Locks::jni_function_table_lock_);
@@ -158,8 +166,8 @@ class JNIEnvExt : public JNIEnv {
   JNIEnvExt(Thread* self, JavaVMExt* vm, std::string* error_msg)
       REQUIRES(!Locks::jni_function_table_lock_);
 
-  // Link to Thread::Current().
-  Thread* const self_;
+  // Link to Thread::Current(). Only changes when the env is reused for a new thread.
+  Thread* self_;
 
   // The invocation interface JavaVM.
   JavaVMExt* const vm_;
@@ -2156,9 +2156,8 @@ class JNI {
     } else {
       CHECK_NON_NULL_MEMCPY_ARGUMENT(length, buf);
       if (s->IsCompressed()) {
-        for (int i = 0; i < length; ++i) {
-          buf[i] = s->CharAt(start+i);
-        }
+        // Compressed strings only hold one-byte modified UTF-8 characters.
+        memcpy(buf, s->GetValueCompressed() + start, length);
       } else {
         const jchar* chars = s->GetValue();
         size_t bytes = CountUtf8Bytes(chars + start, length);
@@ -2268,9 +2267,8 @@ class JNI {
     char* bytes = new char[byte_count + 1];
     CHECK(bytes != nullptr);  // bionic aborts anyway.
     if (s->IsCompressed()) {
-      for (size_t i = 0; i < byte_count; ++i) {
-        bytes[i] = s->CharAt(i);
-      }
+      // Compressed strings only hold one-byte modified UTF-8 characters.
+      memcpy(bytes, s->GetValueCompressed(), byte_count);
     } else {
       const uint16_t* chars = s->GetValue();
       ConvertUtf16ToModifiedUtf8(bytes, byte_count, chars, s->GetLength());
@@ -2407,13 +2405,17 @@ class JNI {
     if (heap->IsMovableObject(array)) {
       if (!kUseReadBarrier) {
         heap->IncrementDisableMovingGC(soa.Self());
-      } else {
+        // Re-decode in case the object moved since IncrementDisableGC waits for GC to complete.
+        array = soa.Decode<mirror::Array>(java_array);
+      } else if (!heap->PinObject(soa.Self(), array)) {
         // For the CC collector, we only need to wait for the thread flip rather than the whole GC
         // to occur thanks to the to-space invariant.
         heap->IncrementDisableThreadFlip(soa.Self());
+        // Re-decode in case the object moved since IncrementDisableThreadFlip waits for the flip.
+        array = soa.Decode<mirror::Array>(java_array);
       }
-      // Re-decode in case the object moved since IncrementDisableGC waits for GC to complete.
-      array = soa.Decode<mirror::Array>(java_array);
+      // A pinned array is a to-space reference and its region is not evacuated by later GCs, so
+      // the GC does not need to wait for the array to be released.
     }
     if (is_copy != nullptr) {
       *is_copy = JNI_FALSE;
@@ -2969,10 +2971,11 @@ class JNI {
       if (is_copy) {
         delete[] reinterpret_cast<uint64_t*>(elements);
       } else if (heap->IsMovableObject(array)) {
-        // Non copy to a movable object must means that we had disabled the moving GC.
+        // Non copy to a movable object must means that we had pinned the object or disabled the
+        // moving GC.
         if (!kUseReadBarrier) {
           heap->DecrementDisableMovingGC(soa.Self());
-        } else {
+        } else if (!heap->UnpinObject(soa.Self(), array)) {
           heap->DecrementDisableThreadFlip(soa.Self());
         }
       }
@@ -1270,6 +1270,34 @@ TEST_F(JniInternalTest, GetReleasePrimitiveArrayCriticalOfWrongType) {
   GetReleasePrimitiveArrayCriticalOfWrongType(true);
 }
 
+TEST_F(JniInternalTest, GetPrimitiveArrayCriticalDoesNotBlockGc) {
+  if (!kUseReadBarrier) {
+    // Only the concurrent copying collector pins regions, the others disable moving GC.
+    return;
+  }
+  // CheckJNI hands out guarded copies.
+  bool old_check_jni = vm_->SetCheckJniEnabled(false);
+  jintArray array = env_->NewIntArray(16);
+  ASSERT_NE(array, nullptr);
+  jint* elements = reinterpret_cast<jint*>(env_->GetPrimitiveArrayCritical(array, nullptr));
+  ASSERT_NE(elements, nullptr);
+  for (jint i = 0; i < 16; ++i) {
+    elements[i] = i;
+  }
+  // With the thread flip disabled by this thread, these collections would never finish.
+  Runtime::Current()->GetHeap()->CollectGarbage(/* clear_soft_references= */ false);
+  Runtime::Current()->GetHeap()->CollectGarbage(/* clear_soft_references= */ false);
+  // The pinned array was not moved.
+  void* elements_again = env_->GetPrimitiveArrayCritical(array, nullptr);
+  EXPECT_EQ(elements_again, elements);
+  env_->ReleasePrimitiveArrayCritical(array, elements_again, 0);
+  for (jint i = 0; i < 16; ++i) {
+    EXPECT_EQ(elements[i], i);
+  }
+  env_->ReleasePrimitiveArrayCritical(array, elements, 0);
+  EXPECT_FALSE(vm_->SetCheckJniEnabled(old_check_jni));
+}
+
 TEST_F(JniInternalTest, GetPrimitiveArrayRegionElementsOfWrongType) {
   GetPrimitiveArrayRegionElementsOfWrongType(false);
   GetPrimitiveArrayRegionElementsOfWrongType(true);
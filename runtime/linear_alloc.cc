@@ -16,11 +16,18 @@
 
 #include "linear_alloc.h"
 
+#include "base/atomic.h"
 #include "thread-current-inl.h"
 
 namespace art {
 
-LinearAlloc::LinearAlloc(ArenaPool* pool) : lock_("linear alloc"), allocator_(pool) {
+// Zero is the owner of threads without a chunk.
+static Atomic<uint64_t> gNextLinearAllocId(1u);
+
+LinearAlloc::LinearAlloc(ArenaPool* pool)
+    : id_(gNextLinearAllocId.fetch_add(1u, std::memory_order_relaxed)),
+      lock_("linear alloc"),
+      allocator_(pool) {
 }
 
 void* LinearAlloc::Realloc(Thread* self, void* ptr, size_t old_size, size_t new_size) {
@@ -29,10 +36,29 @@ void* LinearAlloc::Realloc(Thread* self, void* ptr, size_t old_size, size_t new_
 }
 
 void* LinearAlloc::Alloc(Thread* self, size_t size) {
+  if (self != nullptr && size <= kMaxThreadChunkAllocation) {
+    return AllocFromThreadChunk(self, size);
+  }
   MutexLock mu(self, lock_);
   return allocator_.Alloc(size);
 }
 
+void* LinearAlloc::AllocFromThreadChunk(Thread* self, size_t size) {
+  // The chunk is only accessed by its thread. Its memory is zeroed and belongs to `allocator_`,
+  // so it is released with the rest of this allocator.
+  Thread::LinearAllocChunk* chunk = self->GetLinearAllocChunk();
+  size_t aligned_size = RoundUp(size, ArenaAllocator::kAlignment);
+  if (chunk->owner_id != id_ || static_cast<size_t>(chunk->end - chunk->pos) < aligned_size) {
+    MutexLock mu(self, lock_);
+    chunk->pos = allocator_.AllocArray<uint8_t>(kThreadChunkSize);
+    chunk->end = chunk->pos + kThreadChunkSize;
+    chunk->owner_id = id_;
+  }
+  void* result = chunk->pos;
+  chunk->pos += aligned_size;
+  return result;
+}
+
 void* LinearAlloc::AllocAlign16(Thread* self, size_t size) {
   MutexLock mu(self, lock_);
   return allocator_.AllocAlign16(size);
@@ -18,6 +18,7 @@
 #define ART_RUNTIME_LINEAR_ALLOC_H_
 
 #include "base/arena_allocator.h"
+#include "base/globals.h"
 #include "base/mutex.h"
 
 namespace art {
@@ -41,7 +42,8 @@ class LinearAlloc {
     return reinterpret_cast<T*>(Alloc(self, elements * sizeof(T)));
   }
 
-  // Return the number of bytes used in the allocator.
+  // Return the number of bytes used in the allocator. This includes the unused ends of the
+  // thread chunks.
   size_t GetUsedMemory() const REQUIRES(!lock_);
 
   ArenaPool* GetArenaPool() REQUIRES(!lock_);
@@ -53,7 +55,19 @@ class LinearAlloc {
   // to be deleted.
   bool ContainsUnsafe(void* ptr) const NO_THREAD_SAFETY_ANALYSIS;
 
+  // Allocations of up to kMaxThreadChunkAllocation bytes are bump allocated from a chunk owned by
+  // the allocating thread, so that threads linking classes in parallel only take `lock_` once per
+  // chunk. The unused end of a chunk is wasted when the thread moves to a new chunk or to another
+  // LinearAlloc.
+  static constexpr size_t kThreadChunkSize = 4 * KB;
+  static constexpr size_t kMaxThreadChunkAllocation = kThreadChunkSize / 8;
+
  private:
+  void* AllocFromThreadChunk(Thread* self, size_t size) REQUIRES(!lock_);
+
+  // Identifies this allocator as the owner of thread chunks. Unlike the address of the allocator,
+  // it is not reused after the allocator is deleted when its class loader is unloaded.
+  const uint64_t id_;
   mutable Mutex lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
   ArenaAllocator allocator_ GUARDED_BY(lock_);
 
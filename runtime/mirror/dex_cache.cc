@@ -193,6 +193,34 @@ bool DexCache::AddPreResolvedStringsArray() {
   return true;
 }
 
+size_t DexCache::CopyPreResolvedStringsToStringCache() {
+  GcRoot<mirror::String>* const preresolved_strings = GetPreResolvedStrings();
+  const size_t num_preresolved_strings = NumPreResolvedStrings();
+  StringDexCacheType* const strings = GetStrings();
+  if (preresolved_strings == nullptr || strings == nullptr) {
+    return 0u;
+  }
+  size_t num_copied = 0u;
+  for (size_t i = 0; i != num_preresolved_strings; ++i) {
+    ObjPtr<mirror::String> string = preresolved_strings[i].Read();
+    if (string == nullptr) {
+      continue;
+    }
+    dex::StringIndex string_idx(i);
+    StringDexCacheType& slot = strings[StringSlotIndex(string_idx)];
+    // Do not evict strings resolved since startup, they are likely to be used again.
+    if (!slot.load(std::memory_order_relaxed).object.IsNull()) {
+      continue;
+    }
+    slot.store(StringDexCachePair(string, string_idx.index_), std::memory_order_relaxed);
+    ++num_copied;
+  }
+  if (num_copied != 0u) {
+    WriteBarrier::ForEveryFieldWrite(this);
+  }
+  return num_copied;
+}
+
 void DexCache::Init(const DexFile* dex_file,
                     ObjPtr<String> location,
                     StringDexCacheType* strings,
@@ -285,6 +285,10 @@ class MANAGED DexCache final : public Object {
   void ClearPreResolvedStrings()
       ALWAYS_INLINE REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Copy the preresolved strings to the empty slots of the string cache so that they stay
+  // resolved after ClearPreResolvedStrings. Returns the number of strings copied.
+  size_t CopyPreResolvedStringsToStringCache() REQUIRES_SHARED(Locks::mutator_lock_);
+
   // Clear a string for a string_idx, used to undo string intern transactions to make sure
   // the string isn't kept live.
   void ClearString(dex::StringIndex string_idx) REQUIRES_SHARED(Locks::mutator_lock_);
@@ -25,6 +25,7 @@
 #include "linear_alloc.h"
 #include "mirror/class_loader-inl.h"
 #include "mirror/dex_cache-inl.h"
+#include "mirror/string-alloc-inl.h"
 #include "scoped_thread_state_change-inl.h"
 
 namespace art {
@@ -116,6 +117,36 @@ TEST_F(DexCacheTest, TestResolvedFieldAccess) {
   }
 }
 
+TEST_F(DexCacheTest, CopyPreResolvedStringsToStringCache) {
+  ScopedObjectAccess soa(Thread::Current());
+  StackHandleScope<3> hs(soa.Self());
+  ASSERT_TRUE(java_lang_dex_file_ != nullptr);
+  ASSERT_GT(java_lang_dex_file_->NumStringIds(), DexCache::kDexCacheStringCacheSize + 1u);
+  Handle<DexCache> dex_cache(
+      hs.NewHandle(class_linker_->AllocAndInitializeDexCache(
+          soa.Self(),
+          *java_lang_dex_file_,
+          Runtime::Current()->GetLinearAlloc())));
+  ASSERT_TRUE(dex_cache != nullptr);
+  ASSERT_TRUE(dex_cache->AddPreResolvedStringsArray());
+  Handle<String> first(hs.NewHandle(String::AllocFromModifiedUtf8(soa.Self(), "first")));
+  Handle<String> second(hs.NewHandle(String::AllocFromModifiedUtf8(soa.Self(), "second")));
+  ASSERT_TRUE(first != nullptr);
+  ASSERT_TRUE(second != nullptr);
+
+  // Both strings map to the same slot of the string cache, only the first one fits.
+  const dex::StringIndex first_idx(1u);
+  const dex::StringIndex second_idx(DexCache::kDexCacheStringCacheSize + 1u);
+  dex_cache->GetPreResolvedStrings()[first_idx.index_] = GcRoot<String>(first.Get());
+  dex_cache->GetPreResolvedStrings()[second_idx.index_] = GcRoot<String>(second.Get());
+  EXPECT_EQ(1u, dex_cache->CopyPreResolvedStringsToStringCache());
+
+  dex_cache->ClearPreResolvedStrings();
+  EXPECT_EQ(0u, dex_cache->NumPreResolvedStrings());
+  EXPECT_OBJ_PTR_EQ(first.Get(), dex_cache->GetResolvedString(first_idx));
+  EXPECT_TRUE(dex_cache->GetResolvedString(second_idx) == nullptr);
+}
+
 TEST_F(DexCacheMethodHandlesTest, TestResolvedMethodTypes) {
   ScopedObjectAccess soa(Thread::Current());
   jobject jclass_loader(LoadDex("MethodTypes"));
@@ -229,7 +229,13 @@ bool String::Equals(ObjPtr<String> that) {
   } else {
     // Note: don't short circuit on hash code as we're presumably here as the
     // hash code was already equal
-    for (int32_t i = 0; i < that->GetLength(); ++i) {
+    const int32_t length = that->GetLength();
+    if (this->IsCompressed() && that->IsCompressed()) {
+      return memcmp(this->GetValueCompressed(), that->GetValueCompressed(), length) == 0;
+    } else if (!this->IsCompressed() && !that->IsCompressed()) {
+      return memcmp(this->GetValue(), that->GetValue(), length * sizeof(uint16_t)) == 0;
+    }
+    for (int32_t i = 0; i < length; ++i) {
       if (this->CharAt(i) != that->CharAt(i)) {
         return false;
       }
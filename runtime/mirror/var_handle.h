@@ -197,11 +197,11 @@ class MANAGED FieldVarHandle : public VarHandle {
 
   ArtField* GetField() REQUIRES_SHARED(Locks::mutator_lock_);
 
- private:
   static MemberOffset ArtFieldOffset() {
     return MemberOffset(OFFSETOF_MEMBER(FieldVarHandle, art_field_));
   }
 
+ private:
   // ArtField instance corresponding to variable for accessors.
   int64_t art_field_;
 
@@ -31,9 +31,11 @@
 #include "dex/dex_file-inl.h"
 #include "dex/dex_file_types.h"
 #include "dex/dex_instruction-inl.h"
+#include "flight_recorder.h"
 #include "lock_word-inl.h"
 #include "mirror/class-inl.h"
 #include "mirror/object-inl.h"
+#include "monitor_contention_profile.h"
 #include "object_callbacks.h"
 #include "scoped_thread_state_change-inl.h"
 #include "stack.h"
@@ -95,6 +97,7 @@ Monitor::Monitor(Thread* self, Thread* owner, ObjPtr<mirror::Object> obj, int32_
       num_waiters_(0),
       owner_(owner),
       lock_count_(0),
+      adaptive_spin_rounds_(kInitialAdaptiveSpinRounds),
       obj_(GcRoot<mirror::Object>(obj)),
       wait_set_(nullptr),
       wake_set_(nullptr),
@@ -122,6 +125,7 @@ Monitor::Monitor(Thread* self,
       num_waiters_(0),
       owner_(owner),
       lock_count_(0),
+      adaptive_spin_rounds_(kInitialAdaptiveSpinRounds),
       obj_(GcRoot<mirror::Object>(obj)),
       wait_set_(nullptr),
       wake_set_(nullptr),
@@ -391,6 +395,38 @@ bool Monitor::TryLockLocked(Thread* self) {
   return true;
 }
 
+bool Monitor::TryLockAdaptiveSpinLocked(Thread* self) {
+  for (uint32_t round = 0; round < adaptive_spin_rounds_; ++round) {
+    // Only spin while the owner is running, a suspended or blocked owner will not release the
+    // lock soon. Also give up if someone wants us to suspend or run a checkpoint. The owner
+    // cannot exit while it owns the monitor, so reading its state under monitor_lock_ is safe.
+    if (owner_ == nullptr || owner_->GetState() != kRunnable || self->TestAllFlags()) {
+      break;
+    }
+    monitor_lock_.Unlock(self);
+    volatile uint32_t x = 0;
+    for (uint32_t spin = 0; spin < kAdaptiveSpinIterationsPerRound; ++spin) {
+      ++x;  // Volatile; hence should not be optimized away.
+    }
+    monitor_lock_.Lock(self);
+    if (TryLockLocked(self)) {
+      adaptive_spin_rounds_ = 2u * adaptive_spin_rounds_;
+      if (adaptive_spin_rounds_ > kMaxAdaptiveSpinRounds) {
+        adaptive_spin_rounds_ = kMaxAdaptiveSpinRounds;
+      }
+      return true;
+    }
+  }
+  if (TryLockLocked(self)) {
+    return true;
+  }
+  // Keep at least one round so that the monitor can recover once the hold times shrink again.
+  if (adaptive_spin_rounds_ > 1u) {
+    adaptive_spin_rounds_ /= 2u;
+  }
+  return false;
+}
+
 bool Monitor::TryLock(Thread* self) {
   MutexLock mu(self, monitor_lock_);
   return TryLockLocked(self);
@@ -417,12 +453,17 @@ template <LockReason reason>
 void Monitor::Lock(Thread* self) {
   ScopedAssertNotHeld sanh(self, monitor_lock_);
   bool called_monitors_callback = false;
+  // When we first found the monitor contended, for the contention profile.
+  uint64_t contention_start_ns = 0u;
   monitor_lock_.Lock(self);
   while (true) {
-    if (TryLockLocked(self)) {
+    if (TryLockLocked(self) || TryLockAdaptiveSpinLocked(self)) {
       break;
     }
     // Contended.
+    if (contention_start_ns == 0u) {
+      contention_start_ns = NanoTime();
+    }
     const bool log_contention = (lock_profiling_threshold_ != 0);
     uint64_t wait_start_ms = log_contention ? MilliTime() : 0;
     ArtMethod* owners_method = locking_method_;
@@ -591,6 +632,22 @@ void Monitor::Lock(Thread* self) {
     --num_waiters_;
   }
   monitor_lock_.Unlock(self);
+  if (contention_start_ns != 0u) {
+    uint32_t dex_pc;
+    ArtMethod* m = self->GetCurrentMethod(&dex_pc);
+    uint64_t wait_ns = NanoTime() - contention_start_ns;
+    Runtime::Current()->GetMonitorContentionProfile()->RecordWait(m, dex_pc, wait_ns);
+    FlightRecorder* flight_recorder = Runtime::Current()->GetFlightRecorder();
+    if (flight_recorder != nullptr) {
+      std::string temp;
+      flight_recorder->Record(self,
+                              FlightRecorder::EventType::kMonitorContention,
+                              contention_start_ns,
+                              wait_ns,
+                              /* arg= */ 0u,
+                              GetObject()->GetClass()->GetDescriptor(&temp));
+    }
+  }
   // We need to pair this with a single contended locking call. NB we match the RI behavior and call
   // this even if MonitorEnter failed.
   if (called_monitors_callback) {
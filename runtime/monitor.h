@@ -60,6 +60,12 @@ class Monitor {
   // a lock word. See Runtime::max_spins_before_thin_lock_inflation_.
   constexpr static size_t kDefaultMaxSpinsBeforeThinLockInflation = 50;
 
+  // Bounds for the adaptive spinning on contended inflated monitors, see
+  // TryLockAdaptiveSpinLocked. A round is a short busy wait followed by a retry of the lock.
+  constexpr static uint32_t kInitialAdaptiveSpinRounds = 4;
+  constexpr static uint32_t kMaxAdaptiveSpinRounds = 64;
+  constexpr static uint32_t kAdaptiveSpinIterationsPerRound = 100;
+
   ~Monitor();
 
   static void Init(uint32_t lock_profiling_threshold, uint32_t stack_dump_lock_profiling_threshold);
@@ -223,6 +229,13 @@ class Monitor {
       REQUIRES(monitor_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Called when TryLockLocked failed. Retries for a while, dropping monitor_lock_ in between, as
+  // long as the owner is runnable and recent spins on this monitor paid off. Returns true if we
+  // acquired the lock, false if the caller should block.
+  bool TryLockAdaptiveSpinLocked(Thread* self)
+      REQUIRES(monitor_lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   template<LockReason reason = LockReason::kForLock>
   void Lock(Thread* self)
       REQUIRES(!monitor_lock_)
@@ -308,6 +321,11 @@ class Monitor {
   // Owner's recursive lock depth.
   int lock_count_ GUARDED_BY(monitor_lock_);
 
+  // Number of retry rounds TryLockAdaptiveSpinLocked may use. Doubled when spinning acquires the
+  // lock and halved when the spinning thread ends up blocking, so that monitors with short hold
+  // times are spun on and monitors with long hold times go straight to the condition variable.
+  uint32_t adaptive_spin_rounds_ GUARDED_BY(monitor_lock_);
+
   // What object are we part of. This is a weak root. Do not access
   // this directly, use GetObject() to read it so it will be guarded
   // by a read barrier.
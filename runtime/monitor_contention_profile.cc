@@ -0,0 +1,136 @@
+/*
+ * Copyright (C) 2019 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "monitor_contention_profile.h"
+
+#include <algorithm>
+#include <ostream>
+
+#include "art_method-inl.h"
+#include "base/bit_utils.h"
+#include "base/time_utils.h"
+#include "linear_alloc.h"
+
+namespace art {
+
+uint64_t MonitorContentionProfile::ComputeKey(ArtMethod* method, uint32_t dex_pc) {
+  // Mix the bits so that nearby methods and dex pcs spread over the table.
+  uint64_t key = reinterpret_cast<uintptr_t>(method) ^ (static_cast<uint64_t>(dex_pc) << 40);
+  key ^= key >> 33;
+  key *= UINT64_C(0xff51afd7ed558ccd);
+  key ^= key >> 33;
+  return key > kRemovedKey ? key : key + 2u;
+}
+
+void MonitorContentionProfile::RecordWait(ArtMethod* method, uint32_t dex_pc, uint64_t wait_ns) {
+  if (method == nullptr) {
+    return;  // Locked from native code without managed frames.
+  }
+  const uint64_t key = ComputeKey(method, dex_pc);
+  for (size_t probe = 0; probe < kNumSites; ++probe) {
+    Site& site = sites_[(key + probe) % kNumSites];
+    uint64_t site_key = site.key.load(std::memory_order_relaxed);
+    if (site_key == kUnusedKey) {
+      if (site.key.CompareAndSetStrongRelaxed(kUnusedKey, key)) {
+        site.method.store(method, std::memory_order_relaxed);
+        site.dex_pc.store(dex_pc, std::memory_order_release);
+        site_key = key;
+      } else {
+        site_key = site.key.load(std::memory_order_relaxed);
+      }
+    }
+    if (site_key != key) {
+      continue;
+    }
+    const uint64_t wait_us = wait_ns / 1000u;
+    const size_t bucket =
+        (wait_us == 0u) ? 0u : std::min<size_t>(MostSignificantBit(wait_us), kNumBuckets - 1u);
+    site.buckets[bucket].fetch_add(1u, std::memory_order_relaxed);
+    site.count.fetch_add(1u, std::memory_order_relaxed);
+    site.total_wait_ns.fetch_add(wait_ns, std::memory_order_relaxed);
+    uint64_t max_wait_ns = site.max_wait_ns.load(std::memory_order_relaxed);
+    while (wait_ns > max_wait_ns &&
+           !site.max_wait_ns.CompareAndSetWeakRelaxed(max_wait_ns, wait_ns)) {
+      max_wait_ns = site.max_wait_ns.load(std::memory_order_relaxed);
+    }
+    return;
+  }
+  num_dropped_.fetch_add(1u, std::memory_order_relaxed);
+}
+
+std::vector<MonitorContentionProfile::SiteInfo> MonitorContentionProfile::GetSites() const {
+  std::vector<SiteInfo> sites;
+  for (const Site& site : sites_) {
+    if (site.key.load(std::memory_order_relaxed) <= kRemovedKey) {
+      continue;
+    }
+    SiteInfo info;
+    info.dex_pc = site.dex_pc.load(std::memory_order_acquire);
+    info.method = site.method.load(std::memory_order_relaxed);
+    if (info.method == nullptr) {
+      continue;  // Claimed but not filled in yet.
+    }
+    info.count = site.count.load(std::memory_order_relaxed);
+    if (info.count == 0u) {
+      continue;
+    }
+    info.total_wait_ns = site.total_wait_ns.load(std::memory_order_relaxed);
+    info.max_wait_ns = site.max_wait_ns.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < kNumBuckets; ++i) {
+      info.buckets[i] = site.buckets[i].load(std::memory_order_relaxed);
+    }
+    sites.push_back(info);
+  }
+  std::sort(sites.begin(), sites.end(), [](const SiteInfo& lhs, const SiteInfo& rhs) {
+    return lhs.total_wait_ns > rhs.total_wait_ns;
+  });
+  return sites;
+}
+
+void MonitorContentionProfile::RemoveMethodsIn(const LinearAlloc& alloc) {
+  for (Site& site : sites_) {
+    ArtMethod* method = site.method.load(std::memory_order_relaxed);
+    if (method != nullptr && alloc.ContainsUnsafe(method)) {
+      site.key.store(kRemovedKey, std::memory_order_relaxed);
+      site.method.store(nullptr, std::memory_order_relaxed);
+    }
+  }
+}
+
+void MonitorContentionProfile::Dump(std::ostream& os) {
+  // Only print the most contended sites, the JVMTI extension returns all of them.
+  static constexpr size_t kMaxDumpedSites = 20;
+  std::vector<SiteInfo> sites = GetSites();
+  os << "Monitor contention: " << sites.size() << " sites";
+  if (GetNumDropped() != 0u) {
+    os << ", " << GetNumDropped() << " waits at untracked sites";
+  }
+  os << "\n";
+  for (size_t i = 0; i < std::min(sites.size(), kMaxDumpedSites); ++i) {
+    const SiteInfo& info = sites[i];
+    os << "  " << info.method->PrettyMethod() << " dex_pc=" << info.dex_pc
+       << " waits=" << info.count
+       << " total=" << PrettyDuration(info.total_wait_ns)
+       << " max=" << PrettyDuration(info.max_wait_ns)
+       << " histogram(us, log2)=";
+    for (size_t j = 0; j < kNumBuckets; ++j) {
+      os << (j != 0u ? "," : "") << info.buckets[j];
+    }
+    os << "\n";
+  }
+}
+
+}  // namespace art
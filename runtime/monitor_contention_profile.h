@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2019 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_MONITOR_CONTENTION_PROFILE_H_
+#define ART_RUNTIME_MONITOR_CONTENTION_PROFILE_H_
+
+#include <stdint.h>
+#include <iosfwd>
+#include <vector>
+
+#include "base/atomic.h"
+#include "base/locks.h"
+#include "base/macros.h"
+
+namespace art {
+
+class ArtMethod;
+class LinearAlloc;
+
+// Always-on profile of the time threads spend blocked on contended monitors, aggregated by the
+// call site that blocked. Unlike the lock_profiling_threshold_ logging, nothing is written out
+// while the process runs; the profile is dumped on SIGQUIT and can be read through the
+// com.android.art.monitor.get_contention_profile JVMTI extension. Recording is lock-free so
+// that it never adds contention of its own.
+class MonitorContentionProfile {
+ public:
+  // Number of call sites we keep, contention at further sites is only counted as dropped.
+  static constexpr size_t kNumSites = 256;
+  // Bucket i counts waits of [2^i, 2^(i+1)) microseconds, bucket 0 also counts shorter waits
+  // and the last bucket counts all longer waits.
+  static constexpr size_t kNumBuckets = 16;
+
+  struct SiteInfo {
+    ArtMethod* method;
+    uint32_t dex_pc;
+    uint64_t count;
+    uint64_t total_wait_ns;
+    uint64_t max_wait_ns;
+    uint64_t buckets[kNumBuckets];
+  };
+
+  MonitorContentionProfile() : num_dropped_(0u) {}
+
+  // Records that a thread blocked at `method`:`dex_pc` for `wait_ns` before it got the monitor.
+  void RecordWait(ArtMethod* method, uint32_t dex_pc, uint64_t wait_ns);
+
+  // Returns the sites with recorded contention, the most waited on first.
+  std::vector<SiteInfo> GetSites() const;
+
+  uint64_t GetNumDropped() const {
+    return num_dropped_.load(std::memory_order_relaxed);
+  }
+
+  // Forgets the methods allocated in `alloc`, which is about to be freed with its class loader.
+  // Their sites are no longer reported and are not reused.
+  void RemoveMethodsIn(const LinearAlloc& alloc);
+
+  void Dump(std::ostream& os) REQUIRES_SHARED(Locks::mutator_lock_);
+
+ private:
+  struct Site {
+    // Hash of method and dex pc, kUnusedKey or kRemovedKey otherwise. Claimed with a CAS,
+    // method and dex_pc are written by the claiming thread afterwards.
+    Atomic<uint64_t> key;
+    Atomic<ArtMethod*> method;
+    Atomic<uint32_t> dex_pc;
+    Atomic<uint64_t> count;
+    Atomic<uint64_t> total_wait_ns;
+    Atomic<uint64_t> max_wait_ns;
+    Atomic<uint64_t> buckets[kNumBuckets];
+  };
+
+  static constexpr uint64_t kUnusedKey = 0u;
+  static constexpr uint64_t kRemovedKey = 1u;
+
+  static uint64_t ComputeKey(ArtMethod* method, uint32_t dex_pc);
+
+  Site sites_[kNumSites];
+  Atomic<uint64_t> num_dropped_;
+
+  DISALLOW_COPY_AND_ASSIGN(MonitorContentionProfile);
+};
+
+}  // namespace art
+
+#endif  // ART_RUNTIME_MONITOR_CONTENTION_PROFILE_H_
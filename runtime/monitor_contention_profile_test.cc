@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2019 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "monitor_contention_profile.h"
+
+#include <memory>
+
+#include "gtest/gtest.h"
+
+namespace art {
+
+// The profile never dereferences the methods it records, so fake ones are good enough.
+static ArtMethod* FakeMethod(uintptr_t value) {
+  return reinterpret_cast<ArtMethod*>(value * 64u);
+}
+
+TEST(MonitorContentionProfileTest, RecordWait) {
+  std::unique_ptr<MonitorContentionProfile> profile(new MonitorContentionProfile);
+  EXPECT_TRUE(profile->GetSites().empty());
+
+  profile->RecordWait(FakeMethod(1u), 3u, 500u);          // Bucket 0.
+  profile->RecordWait(FakeMethod(1u), 3u, 5000u);         // 5us, bucket 2.
+  profile->RecordWait(FakeMethod(1u), 7u, 1000000u);      // Different dex pc, 1ms, bucket 9.
+  profile->RecordWait(FakeMethod(2u), 3u, 100000000000u);  // 100s, last bucket.
+  profile->RecordWait(nullptr, 0u, 1000u);                 // Ignored.
+
+  std::vector<MonitorContentionProfile::SiteInfo> sites = profile->GetSites();
+  ASSERT_EQ(sites.size(), 3u);
+  // Sorted by total wait time.
+  EXPECT_EQ(sites[0].method, FakeMethod(2u));
+  EXPECT_EQ(sites[0].count, 1u);
+  EXPECT_EQ(sites[0].buckets[MonitorContentionProfile::kNumBuckets - 1u], 1u);
+  EXPECT_EQ(sites[1].method, FakeMethod(1u));
+  EXPECT_EQ(sites[1].dex_pc, 7u);
+  EXPECT_EQ(sites[1].buckets[9], 1u);
+  EXPECT_EQ(sites[2].method, FakeMethod(1u));
+  EXPECT_EQ(sites[2].dex_pc, 3u);
+  EXPECT_EQ(sites[2].count, 2u);
+  EXPECT_EQ(sites[2].total_wait_ns, 5500u);
+  EXPECT_EQ(sites[2].max_wait_ns, 5000u);
+  EXPECT_EQ(sites[2].buckets[0], 1u);
+  EXPECT_EQ(sites[2].buckets[2], 1u);
+  EXPECT_EQ(profile->GetNumDropped(), 0u);
+}
+
+TEST(MonitorContentionProfileTest, Overflow) {
+  std::unique_ptr<MonitorContentionProfile> profile(new MonitorContentionProfile);
+  const size_t kNumSites = MonitorContentionProfile::kNumSites;
+  for (size_t i = 0; i < kNumSites + 10u; ++i) {
+    profile->RecordWait(FakeMethod(i + 1u), 0u, 1000u);
+  }
+  EXPECT_EQ(profile->GetSites().size(), kNumSites);
+  EXPECT_EQ(profile->GetNumDropped(), 10u);
+}
+
+}  // namespace art
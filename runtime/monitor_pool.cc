@@ -16,8 +16,12 @@
 
 #include "monitor_pool.h"
 
+#include <map>
+#include <set>
+
 #include "base/logging.h"  // For VLOG.
 #include "base/mutex-inl.h"
+#include "base/native_memory_tracker.h"
 #include "monitor.h"
 #include "thread-current-inl.h"
 
@@ -41,6 +45,22 @@ MonitorPool::MonitorPool()
 void MonitorPool::AllocateChunk() {
   DCHECK(first_free_ == nullptr);
 
+  // Refill the slot of a trimmed chunk if possible, this does not need another chunk list.
+  if (!trimmed_chunk_offsets_.empty()) {
+    size_t chunk_offset = trimmed_chunk_offsets_.back();
+    trimmed_chunk_offsets_.pop_back();
+    size_t index = chunk_offset / kChunkSize;
+    uintptr_t* slot = &monitor_chunks_[index / kMaxListSize][index % kMaxListSize];
+    DCHECK_EQ(*slot, 0U);
+    void* chunk = allocator_.allocate(kChunkSize);
+    NativeMemoryTracker::RegisterAllocation(NativeMemoryTag::kMonitors, kChunkSize);
+    CHECK_NE(reinterpret_cast<uintptr_t>(nullptr), reinterpret_cast<uintptr_t>(chunk));
+    CHECK_EQ(0U, reinterpret_cast<uintptr_t>(chunk) % kMonitorAlignment);
+    *slot = reinterpret_cast<uintptr_t>(chunk);
+    AddChunkToFreeList(reinterpret_cast<uintptr_t>(chunk), chunk_offset);
+    return;
+  }
+
   // Do we need to allocate another chunk list?
   if (num_chunks_ == current_chunk_list_capacity_) {
     if (current_chunk_list_capacity_ != 0U) {
@@ -58,6 +78,7 @@ void MonitorPool::AllocateChunk() {
 
   // Allocate the chunk.
   void* chunk = allocator_.allocate(kChunkSize);
+  NativeMemoryTracker::RegisterAllocation(NativeMemoryTag::kMonitors, kChunkSize);
   // Check we allocated memory.
   CHECK_NE(reinterpret_cast<uintptr_t>(nullptr), reinterpret_cast<uintptr_t>(chunk));
   // Check it is aligned as we need it.
@@ -67,13 +88,18 @@ void MonitorPool::AllocateChunk() {
   monitor_chunks_[current_chunk_list_index_][num_chunks_] = reinterpret_cast<uintptr_t>(chunk);
   num_chunks_++;
 
+  AddChunkToFreeList(reinterpret_cast<uintptr_t>(chunk),
+                     current_chunk_list_index_ * (kMaxListSize * kChunkSize) +
+                         (num_chunks_ - 1) * kChunkSize);
+}
+
+void MonitorPool::AddChunkToFreeList(uintptr_t chunk, size_t chunk_offset) {
+  DCHECK(first_free_ == nullptr);
   // Set up the free list
-  Monitor* last = reinterpret_cast<Monitor*>(reinterpret_cast<uintptr_t>(chunk) +
-                                             (kChunkCapacity - 1) * kAlignedMonitorSize);
+  Monitor* last = reinterpret_cast<Monitor*>(chunk + (kChunkCapacity - 1) * kAlignedMonitorSize);
   last->next_free_ = nullptr;
   // Eagerly compute id.
-  last->monitor_id_ = OffsetToMonitorId(current_chunk_list_index_* (kMaxListSize * kChunkSize)
-      + (num_chunks_ - 1) * kChunkSize + (kChunkCapacity - 1) * kAlignedMonitorSize);
+  last->monitor_id_ = OffsetToMonitorId(chunk_offset + (kChunkCapacity - 1) * kAlignedMonitorSize);
   for (size_t i = 0; i < kChunkCapacity - 1; ++i) {
     Monitor* before = reinterpret_cast<Monitor*>(reinterpret_cast<uintptr_t>(last) -
                                                  kAlignedMonitorSize);
@@ -88,6 +114,46 @@ void MonitorPool::AllocateChunk() {
   first_free_ = last;
 }
 
+size_t MonitorPool::TrimChunksInPool(Thread* self) {
+  MutexLock mu(self, *Locks::allocated_monitor_ids_lock_);
+  // Count the free monitors of each chunk, keyed by the chunk offset.
+  std::map<size_t, size_t> free_counts;
+  for (Monitor* mon = first_free_; mon != nullptr; mon = mon->next_free_) {
+    size_t chunk_offset = RoundDown(MonitorIdToOffset(mon->monitor_id_), kChunkSize);
+    ++free_counts[chunk_offset];
+  }
+  std::set<size_t> empty_chunks;
+  for (const auto& entry : free_counts) {
+    DCHECK_LE(entry.second, kChunkCapacity);
+    if (entry.second == kChunkCapacity) {
+      empty_chunks.insert(entry.first);
+    }
+  }
+  if (empty_chunks.empty()) {
+    return 0u;
+  }
+  // Unlink the monitors of the empty chunks, keeping the order of the others.
+  Monitor** link = &first_free_;
+  while (*link != nullptr) {
+    Monitor* mon = *link;
+    if (empty_chunks.count(RoundDown(MonitorIdToOffset(mon->monitor_id_), kChunkSize)) != 0u) {
+      *link = mon->next_free_;
+    } else {
+      link = &mon->next_free_;
+    }
+  }
+  for (size_t chunk_offset : empty_chunks) {
+    size_t index = chunk_offset / kChunkSize;
+    uintptr_t* slot = &monitor_chunks_[index / kMaxListSize][index % kMaxListSize];
+    allocator_.deallocate(reinterpret_cast<uint8_t*>(*slot), kChunkSize);
+    NativeMemoryTracker::RegisterFree(NativeMemoryTag::kMonitors, kChunkSize);
+    *slot = 0u;
+    trimmed_chunk_offsets_.push_back(chunk_offset);
+  }
+  VLOG(monitor) << "Trimmed " << empty_chunks.size() << " monitor chunks";
+  return empty_chunks.size();
+}
+
 void MonitorPool::FreeInternal() {
   // This is on shutdown with NO_THREAD_SAFETY_ANALYSIS, can't/don't need to lock.
   DCHECK_NE(current_chunk_list_capacity_, 0UL);
@@ -95,8 +161,11 @@ void MonitorPool::FreeInternal() {
     DCHECK_NE(monitor_chunks_[i], static_cast<uintptr_t*>(nullptr));
     for (size_t j = 0; j < ChunkListCapacity(i); ++j) {
       if (i < current_chunk_list_index_ || j < num_chunks_) {
-        DCHECK_NE(monitor_chunks_[i][j], 0U);
-        allocator_.deallocate(reinterpret_cast<uint8_t*>(monitor_chunks_[i][j]), kChunkSize);
+        // Trimmed chunks leave a 0 entry behind.
+        if (monitor_chunks_[i][j] != 0U) {
+          allocator_.deallocate(reinterpret_cast<uint8_t*>(monitor_chunks_[i][j]), kChunkSize);
+          NativeMemoryTracker::RegisterFree(NativeMemoryTag::kMonitors, kChunkSize);
+        }
       } else {
         DCHECK_EQ(monitor_chunks_[i][j], 0U);
       }
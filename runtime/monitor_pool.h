@@ -22,6 +22,7 @@
 #include "base/allocator.h"
 #ifdef __LP64__
 #include <stdint.h>
+#include <vector>
 #include "base/atomic.h"
 #include "runtime.h"
 #else
@@ -74,6 +75,19 @@ class MonitorPool {
 #endif
   }
 
+  // Returns the memory of chunks that contain only released monitors, e.g. after the monitors were
+  // deflated. The ids of such monitors are not referenced by any lock word, so the chunk list
+  // slots stay valid and are refilled by later chunk allocations. Returns the number of chunks
+  // released.
+  static size_t TrimChunks(Thread* self) REQUIRES(!Locks::allocated_monitor_ids_lock_) {
+#ifndef __LP64__
+    UNUSED(self);
+    return 0u;
+#else
+    return GetMonitorPool()->TrimChunksInPool(self);
+#endif
+  }
+
   static Monitor* MonitorFromMonitorId(MonitorId mon_id) {
 #ifndef __LP64__
     return reinterpret_cast<Monitor*>(mon_id << LockWord::kMonitorIdAlignmentShift);
@@ -121,6 +135,13 @@ class MonitorPool {
 
   void AllocateChunk() REQUIRES(Locks::allocated_monitor_ids_lock_);
 
+  // Links the monitors of the chunk at `chunk` into the free list, `chunk_offset` is the offset
+  // that the first monitor id of the chunk encodes.
+  void AddChunkToFreeList(uintptr_t chunk, size_t chunk_offset)
+      REQUIRES(Locks::allocated_monitor_ids_lock_);
+
+  size_t TrimChunksInPool(Thread* self) REQUIRES(!Locks::allocated_monitor_ids_lock_);
+
   // Release all chunks and metadata. This is done on shutdown, where threads have been destroyed,
   // so ignore thead-safety analysis.
   void FreeInternal() NO_THREAD_SAFETY_ANALYSIS;
@@ -161,7 +182,7 @@ class MonitorPool {
           break;
         }
         uintptr_t chunk_addr = monitor_chunks_[i][j];
-        if (IsInChunk(chunk_addr, mon)) {
+        if (chunk_addr != 0u && IsInChunk(chunk_addr, mon)) {
           return OffsetToMonitorId(
               reinterpret_cast<uintptr_t>(mon) - chunk_addr
               + i * (kMaxListSize * kChunkSize) + j * kChunkSize);
@@ -242,6 +263,10 @@ class MonitorPool {
   // Start of free list of monitors.
   // Note: these point to the right memory regions, but do *not* denote initialized objects.
   Monitor* first_free_ GUARDED_BY(Locks::allocated_monitor_ids_lock_);
+
+  // Offsets of the chunks released by TrimChunks. Their monitor_chunks_ entries are 0 until
+  // AllocateChunk reuses them, which it does before growing the chunk lists.
+  std::vector<size_t> trimmed_chunk_offsets_ GUARDED_BY(Locks::allocated_monitor_ids_lock_);
 #endif
 };
 
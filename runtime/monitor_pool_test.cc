@@ -124,4 +124,58 @@ TEST_F(MonitorPoolTest, MonitorPoolTest) {
   }
 }
 
+TEST_F(MonitorPoolTest, TrimChunks) {
+  // Enough monitors to need several chunks.
+  const size_t kNumMonitors = 1000;
+
+  Thread* self = Thread::Current();
+  ScopedObjectAccess soa(self);
+
+  std::vector<Monitor*> monitors;
+  for (size_t i = 0; i < kNumMonitors; ++i) {
+    monitors.push_back(MonitorPool::CreateMonitor(self, self, nullptr, static_cast<int32_t>(i)));
+  }
+  // Nothing to trim while all the new chunks are in use.
+  MonitorPool::TrimChunks(self);
+  for (Monitor* mon : monitors) {
+    VerifyMonitor(mon, self);
+  }
+
+  // Keep every other monitor of the first half alive, the chunks of the second half are empty.
+  std::vector<Monitor*> kept;
+  for (size_t i = 0; i < kNumMonitors; ++i) {
+    if (i < kNumMonitors / 2 && i % 2 == 0) {
+      kept.push_back(monitors[i]);
+    } else {
+      MonitorPool::ReleaseMonitor(self, monitors[i]);
+    }
+  }
+  monitors.clear();
+  size_t trimmed = MonitorPool::TrimChunks(self);
+#ifdef __LP64__
+  EXPECT_GT(trimmed, 0u);
+#else
+  EXPECT_EQ(trimmed, 0u);
+#endif
+  EXPECT_EQ(MonitorPool::TrimChunks(self), 0u);
+  for (Monitor* mon : kept) {
+    VerifyMonitor(mon, self);
+  }
+
+  // The trimmed chunks are refilled by new allocations.
+  for (size_t i = 0; i < kNumMonitors; ++i) {
+    Monitor* mon = MonitorPool::CreateMonitor(self, self, nullptr, static_cast<int32_t>(i));
+    VerifyMonitor(mon, self);
+    monitors.push_back(mon);
+  }
+  for (Monitor* mon : kept) {
+    VerifyMonitor(mon, self);
+    MonitorPool::ReleaseMonitor(self, mon);
+  }
+  for (Monitor* mon : monitors) {
+    VerifyMonitor(mon, self);
+    MonitorPool::ReleaseMonitor(self, mon);
+  }
+}
+
 }  // namespace art
@@ -2132,11 +2132,12 @@ const dex::ClassDef* OatDexFile::FindClassDef(const DexFile& dex_file,
 void OatDexFile::MadviseDexFile(const DexFile& dex_file, MadviseState state) {
   Runtime* const runtime = Runtime::Current();
   const bool low_ram = runtime->GetHeap()->IsLowMemoryMode();
-  // TODO: Also do madvise hints for non low ram devices.
-  if (!low_ram) {
+  // Other devices have enough page cache to keep what we would release, but they still benefit
+  // from prefetching the startup and hot sections of the profile guided layout at load.
+  if (!low_ram && state != MadviseState::kMadviseStateAtLoad) {
     return;
   }
-  if (state == MadviseState::kMadviseStateAtLoad && runtime->MAdviseRandomAccess()) {
+  if (low_ram && state == MadviseState::kMadviseStateAtLoad && runtime->MAdviseRandomAccess()) {
     // Default every dex file to MADV_RANDOM when its loaded by default for low ram devices.
     // Other devices have enough page cache to get performance benefits from loading more pages
     // into the page cache.
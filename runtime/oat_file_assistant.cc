@@ -16,6 +16,8 @@
 
 #include "oat_file_assistant.h"
 
+#include <map>
+#include <mutex>
 #include <sstream>
 
 #include <sys/stat.h>
@@ -599,6 +601,39 @@ const std::vector<uint32_t>* OatFileAssistant::GetRequiredDexChecksums() {
   return required_dex_checksums_found_ ? &cached_required_dex_checksums_ : nullptr;
 }
 
+// Returns the checksums of the first `component_count` boot class path components for `isa`.
+// The boot class path and image location do not change for the lifetime of the process, so the
+// checksums are shared by all OatFileAssistant instances instead of reading the image header and
+// opening the extra boot class path dex files again for each dex location. Failures are not
+// cached.
+static std::string GetSharedBootClassPathChecksums(size_t component_count,
+                                                   InstructionSet isa,
+                                                   /*out*/ std::string* error_msg) {
+  static std::mutex lock;
+  static std::map<std::pair<InstructionSet, size_t>, std::string> checksums_cache;
+  const std::pair<InstructionSet, size_t> key(isa, component_count);
+  {
+    std::lock_guard<std::mutex> mu(lock);
+    auto it = checksums_cache.find(key);
+    if (it != checksums_cache.end()) {
+      return it->second;
+    }
+  }
+  Runtime* runtime = Runtime::Current();
+  ArrayRef<const std::string> boot_class_path(runtime->GetBootClassPath());
+  std::string checksums = gc::space::ImageSpace::GetBootClassPathChecksums(
+      boot_class_path.SubArray(/* pos= */ 0u, component_count),
+      runtime->GetImageLocation(),
+      isa,
+      runtime->GetImageSpaceLoadingOrder(),
+      error_msg);
+  if (!checksums.empty()) {
+    std::lock_guard<std::mutex> mu(lock);
+    checksums_cache.emplace(key, checksums);
+  }
+  return checksums;
+}
+
 bool OatFileAssistant::ValidateBootClassPathChecksums(const OatFile& oat_file) {
   // Get the BCP from the oat file.
   const char* oat_boot_class_path =
@@ -640,14 +675,9 @@ bool OatFileAssistant::ValidateBootClassPathChecksums(const OatFile& oat_file) {
 
   // Retrieve checksums for this portion of the BCP if we do not have them cached.
   if (cached_boot_class_path_checksum_component_count_ != component_count) {
-    ArrayRef<const std::string> boot_class_path(runtime->GetBootClassPath());
     std::string error_msg;
-    std::string boot_class_path_checksums = gc::space::ImageSpace::GetBootClassPathChecksums(
-        boot_class_path.SubArray(/* pos= */ 0u, component_count),
-        runtime->GetImageLocation(),
-        isa_,
-        runtime->GetImageSpaceLoadingOrder(),
-        &error_msg);
+    std::string boot_class_path_checksums =
+        GetSharedBootClassPathChecksums(component_count, isa_, &error_msg);
     if (boot_class_path_checksums.empty()) {
       VLOG(oat) << "No image for oat image checksum to match against.";
 
@@ -16,6 +16,7 @@
 
 #include "oat_file_manager.h"
 
+#include <atomic>
 #include <memory>
 #include <queue>
 #include <vector>
@@ -35,6 +36,7 @@
 #include "class_linker.h"
 #include "class_loader_context.h"
 #include "dex/art_dex_file_loader.h"
+#include "dex/class_reference.h"
 #include "dex/dex_file-inl.h"
 #include "dex/dex_file_loader.h"
 #include "dex/dex_file_tracking_registrar.h"
@@ -42,6 +44,7 @@
 #include "gc/space/image_space.h"
 #include "handle_scope-inl.h"
 #include "jit/jit.h"
+#include "jit/profile_saver.h"
 #include "jni/java_vm_ext.h"
 #include "jni/jni_internal.h"
 #include "mirror/class_loader.h"
@@ -869,15 +872,19 @@ static bool UnlinkLeastRecentlyUsedVdexIfNeeded(const std::string& vdex_path_to_
   return true;
 }
 
-class BackgroundVerificationTask final : public Task {
+// State shared by the tasks which verify one set of dex files in the background.
+class BackgroundVerificationState {
  public:
-  BackgroundVerificationTask(const std::vector<const DexFile*>& dex_files,
-                             jobject class_loader,
-                             const char* class_loader_context,
-                             const std::string& vdex_path)
+  BackgroundVerificationState(const std::vector<const DexFile*>& dex_files,
+                              jobject class_loader,
+                              const char* class_loader_context,
+                              const std::string& vdex_path,
+                              size_t num_tasks)
       : dex_files_(dex_files),
         class_loader_context_(class_loader_context),
-        vdex_path_(vdex_path) {
+        vdex_path_(vdex_path),
+        next_class_(0u),
+        active_tasks_(num_tasks) {
     Thread* const self = Thread::Current();
     ScopedObjectAccess soa(self);
     // Create a global ref for `class_loader` because it will be accessed from a different thread.
@@ -885,59 +892,115 @@ class BackgroundVerificationTask final : public Task {
     CHECK(class_loader_ != nullptr);
   }
 
-  ~BackgroundVerificationTask() {
+  ~BackgroundVerificationState() {
     Thread* const self = Thread::Current();
     ScopedObjectAccess soa(self);
     soa.Vm()->DeleteGlobalRef(self, class_loader_);
   }
 
-  void Run(Thread* self) override {
-    std::string error_msg;
-    ClassLinker* const class_linker = Runtime::Current()->GetClassLinker();
-    verifier::VerifierDeps verifier_deps(dex_files_);
+  // Collect the classes to verify. Classes which appear in the app's profile, or which
+  // declare methods that do, come first so that they are likely to be verified before
+  // their first use.
+  void CollectClasses() {
+    ProfileCompilationInfo profile;
+    bool has_profile = false;
+    for (const std::string& filename : ProfileSaver::GetTrackedProfiles()) {
+      has_profile |= profile.MergeWith(filename);
+    }
 
-    // Iterate over all classes and verify them.
+    std::vector<ClassReference> cold_classes;
     for (const DexFile* dex_file : dex_files_) {
+      std::set<dex::TypeIndex> hot_types;
+      std::set<uint16_t> hot_methods;
+      std::set<uint16_t> startup_methods;
+      std::set<uint16_t> post_startup_methods;
+      if (has_profile &&
+          profile.GetClassesAndMethods(*dex_file,
+                                       &hot_types,
+                                       &hot_methods,
+                                       &startup_methods,
+                                       &post_startup_methods)) {
+        for (const std::set<uint16_t>* methods : {&hot_methods, &startup_methods}) {
+          for (uint16_t method_idx : *methods) {
+            hot_types.insert(dex_file->GetMethodId(method_idx).class_idx_);
+          }
+        }
+      }
       for (uint32_t cdef_idx = 0; cdef_idx < dex_file->NumClassDefs(); cdef_idx++) {
         const dex::ClassDef& class_def = dex_file->GetClassDef(cdef_idx);
-
-        // Take handles inside the loop. The background verification is low priority
-        // and we want to minimize the risk of blocking anyone else.
-        ScopedObjectAccess soa(self);
-        StackHandleScope<2> hs(self);
-        Handle<mirror::ClassLoader> h_loader(hs.NewHandle(
-            soa.Decode<mirror::ClassLoader>(class_loader_)));
-        Handle<mirror::Class> h_class(hs.NewHandle<mirror::Class>(class_linker->FindClass(
-            self,
-            dex_file->GetClassDescriptor(class_def),
-            h_loader)));
-
-        if (h_class == nullptr) {
-          CHECK(self->IsExceptionPending());
-          self->ClearException();
-          continue;
+        if (hot_types.find(class_def.class_idx_) != hot_types.end()) {
+          classes_.emplace_back(dex_file, cdef_idx);
+        } else {
+          cold_classes.emplace_back(dex_file, cdef_idx);
         }
+      }
+    }
+    classes_.insert(classes_.end(), cold_classes.begin(), cold_classes.end());
+  }
 
-        if (&h_class->GetDexFile() != dex_file) {
-          // There is a different class in the class path or a parent class loader
-          // with the same descriptor. This `h_class` is not resolvable, skip it.
-          continue;
-        }
+  // Verify classes until all of them have been handed out. Return whether the caller
+  // was the last task to finish.
+  bool VerifyClasses(Thread* self) {
+    ClassLinker* const class_linker = Runtime::Current()->GetClassLinker();
+    for (size_t i = next_class_.fetch_add(1u, std::memory_order_relaxed);
+         i < classes_.size();
+         i = next_class_.fetch_add(1u, std::memory_order_relaxed)) {
+      const DexFile* dex_file = classes_[i].dex_file;
+      const dex::ClassDef& class_def = dex_file->GetClassDef(classes_[i].ClassDefIdx());
+
+      // Take handles inside the loop. The background verification is low priority
+      // and we want to minimize the risk of blocking anyone else.
+      ScopedObjectAccess soa(self);
+      StackHandleScope<2> hs(self);
+      Handle<mirror::ClassLoader> h_loader(hs.NewHandle(
+          soa.Decode<mirror::ClassLoader>(class_loader_)));
+      Handle<mirror::Class> h_class(hs.NewHandle<mirror::Class>(class_linker->FindClass(
+          self,
+          dex_file->GetClassDescriptor(class_def),
+          h_loader)));
+
+      if (h_class == nullptr) {
+        CHECK(self->IsExceptionPending());
+        self->ClearException();
+        continue;
+      }
 
-        CHECK(h_class->IsResolved()) << h_class->PrettyDescriptor();
-        class_linker->VerifyClass(self, h_class);
-        if (h_class->IsErroneous()) {
-          // ClassLinker::VerifyClass throws, which isn't useful here.
-          CHECK(soa.Self()->IsExceptionPending());
-          soa.Self()->ClearException();
-        }
+      if (&h_class->GetDexFile() != dex_file) {
+        // There is a different class in the class path or a parent class loader
+        // with the same descriptor. This `h_class` is not resolvable, skip it.
+        continue;
+      }
 
-        CHECK(h_class->IsVerified() || h_class->IsErroneous())
-            << h_class->PrettyDescriptor() << ": state=" << h_class->GetStatus();
+      CHECK(h_class->IsResolved()) << h_class->PrettyDescriptor();
+      class_linker->VerifyClass(self, h_class);
+      if (h_class->IsErroneous()) {
+        // ClassLinker::VerifyClass throws, which isn't useful here.
+        CHECK(soa.Self()->IsExceptionPending());
+        soa.Self()->ClearException();
+      }
 
-        if (h_class->IsVerified()) {
-          verifier_deps.RecordClassVerified(*dex_file, class_def);
-        }
+      CHECK(h_class->IsVerified() || h_class->IsErroneous())
+          << h_class->PrettyDescriptor() << ": state=" << h_class->GetStatus();
+    }
+    return active_tasks_.fetch_sub(1u, std::memory_order_acq_rel) == 1u;
+  }
+
+  // Record the verified classes and write them to the vdex file. Must only be called
+  // once all classes have been verified.
+  void WriteVdex(Thread* self) {
+    std::string error_msg;
+    ClassLinker* const class_linker = Runtime::Current()->GetClassLinker();
+    verifier::VerifierDeps verifier_deps(dex_files_);
+
+    for (const ClassReference& ref : classes_) {
+      const dex::ClassDef& class_def = ref.dex_file->GetClassDef(ref.ClassDefIdx());
+      ScopedObjectAccess soa(self);
+      ObjPtr<mirror::Class> klass = class_linker->LookupClass(
+          self,
+          ref.dex_file->GetClassDescriptor(class_def),
+          soa.Decode<mirror::ClassLoader>(class_loader_));
+      if (klass != nullptr && &klass->GetDexFile() == ref.dex_file && klass->IsVerified()) {
+        verifier_deps.RecordClassVerified(*ref.dex_file, class_def);
       }
     }
 
@@ -958,16 +1021,56 @@ class BackgroundVerificationTask final : public Task {
     }
   }
 
-  void Finalize() override {
-    delete this;
-  }
-
  private:
   const std::vector<const DexFile*> dex_files_;
   jobject class_loader_;
   const std::string class_loader_context_;
   const std::string vdex_path_;
 
+  // Classes to verify, in verification order. Only written before the tasks sharing
+  // this state start verifying.
+  std::vector<ClassReference> classes_;
+  // Index in `classes_` of the next class to verify.
+  std::atomic<size_t> next_class_;
+  // Number of tasks which have not finished verifying.
+  std::atomic<size_t> active_tasks_;
+
+  DISALLOW_COPY_AND_ASSIGN(BackgroundVerificationState);
+};
+
+class BackgroundVerificationTask final : public Task {
+ public:
+  // The first task collects the classes to verify and then adds `num_helpers` tasks
+  // to `thread_pool` to verify them in parallel.
+  BackgroundVerificationTask(std::shared_ptr<BackgroundVerificationState> state,
+                             ThreadPool* thread_pool,
+                             size_t num_helpers)
+      : state_(std::move(state)),
+        thread_pool_(thread_pool),
+        num_helpers_(num_helpers) {}
+
+  void Run(Thread* self) override {
+    if (thread_pool_ != nullptr) {
+      state_->CollectClasses();
+      for (size_t i = 0; i < num_helpers_; ++i) {
+        thread_pool_->AddTask(self, new BackgroundVerificationTask(
+            state_, /* thread_pool= */ nullptr, /* num_helpers= */ 0u));
+      }
+    }
+    if (state_->VerifyClasses(self)) {
+      state_->WriteVdex(self);
+    }
+  }
+
+  void Finalize() override {
+    delete this;
+  }
+
+ private:
+  std::shared_ptr<BackgroundVerificationState> state_;
+  ThreadPool* const thread_pool_;
+  const size_t num_helpers_;
+
   DISALLOW_COPY_AND_ASSIGN(BackgroundVerificationTask);
 };
 
@@ -1002,16 +1105,22 @@ void OatFileManager::RunBackgroundVerification(const std::vector<const DexFile*>
                                                  &location_checksum,
                                                  &dex_location,
                                                  &vdex_path)) {
+    size_t num_threads = std::max(runtime->GetBackgroundVerificationThreadCount(), 1u);
     if (verification_thread_pool_ == nullptr) {
       verification_thread_pool_.reset(
-          new ThreadPool("Verification thread pool", /* num_threads= */ 1));
+          new ThreadPool("Verification thread pool", num_threads));
       verification_thread_pool_->StartWorkers(self);
     }
+    std::shared_ptr<BackgroundVerificationState> state =
+        std::make_shared<BackgroundVerificationState>(dex_files,
+                                                      class_loader,
+                                                      class_loader_context,
+                                                      vdex_path,
+                                                      num_threads);
     verification_thread_pool_->AddTask(self, new BackgroundVerificationTask(
-        dex_files,
-        class_loader,
-        class_loader_context,
-        vdex_path));
+        std::move(state),
+        verification_thread_pool_.get(),
+        num_threads - 1u));
   }
 }
 
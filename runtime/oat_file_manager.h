@@ -122,7 +122,9 @@ class OatFileManager {
 
   void SetOnlyUseSystemOatFiles(bool enforce, bool assert_no_files_loaded);
 
-  // Spawn a background thread which verifies all classes in the given dex files.
+  // Verify all classes in the given dex files on background threads, starting with the
+  // classes of the app's profile. The number of threads is set with
+  // -XX:BackgroundVerificationThreadCount.
   void RunBackgroundVerification(const std::vector<const DexFile*>& dex_files,
                                  jobject class_loader,
                                  const char* class_loader_context);
@@ -188,7 +190,7 @@ class OatFileManager {
   // is not on /system, don't load it "executable".
   bool only_use_system_oat_files_;
 
-  // Single-thread pool used to run the verifier in the background.
+  // Thread pool used to run the verifier in the background.
   std::unique_ptr<ThreadPool> verification_thread_pool_;
 
   DISALLOW_COPY_AND_ASSIGN(OatFileManager);
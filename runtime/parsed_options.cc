@@ -144,6 +144,9 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
       .Define("-XX:ForegroundHeapGrowthMultiplier=_")
           .WithType<double>().WithRange(0.1, 5.0)
           .IntoKey(M::ForegroundHeapGrowthMultiplier)
+      .Define("-XX:GcCpuFractionTarget=_")
+          .WithType<double>().WithRange(0.0, 0.5)
+          .IntoKey(M::GcCpuFractionTarget)
       .Define("-XX:ParallelGCThreads=_")
           .WithType<unsigned int>()
           .IntoKey(M::ParallelGCThreads)
@@ -167,6 +170,10 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
           .IntoKey(M::LongGCLogThreshold)
       .Define("-XX:DumpGCPerformanceOnShutdown")
           .IntoKey(M::DumpGCPerformanceOnShutdown)
+      .Define("-XX:PerfCounters")
+          .IntoKey(M::PerfCounters)
+      .Define("-XX:FlightRecorder")
+          .IntoKey(M::FlightRecorder)
       .Define("-XX:DumpRegionInfoBeforeGC")
           .IntoKey(M::DumpRegionInfoBeforeGC)
       .Define("-XX:DumpRegionInfoAfterGC")
@@ -187,10 +194,28 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
           .WithType<bool>()
           .WithValueMap({{"false", false}, {"true", true}})
           .IntoKey(M::DumpNativeStackOnSigQuit)
+      .Define("-XX:MaxJavaStackTraceDepth=_")
+          .WithType<unsigned int>()
+          .IntoKey(M::MaxJavaStackTraceDepth)
       .Define("-XX:MadviseRandomAccess:_")
           .WithType<bool>()
           .WithValueMap({{"false", false}, {"true", true}})
           .IntoKey(M::MadviseRandomAccess)
+      .Define("-XX:UseHugePages:_")
+          .WithType<bool>()
+          .WithValueMap({{"false", false}, {"true", true}})
+          .IntoKey(M::UseHugePages)
+      .Define("-XX:AsyncLogging:_")
+          .WithType<bool>()
+          .WithValueMap({{"false", false}, {"true", true}})
+          .IntoKey(M::AsyncLogging)
+      .Define("-XX:HprofDumpFromChild:_")
+          .WithType<bool>()
+          .WithValueMap({{"false", false}, {"true", true}})
+          .IntoKey(M::HprofDumpFromChild)
+      .Define("-XX:BackgroundVerificationThreadCount=_")
+          .WithType<unsigned int>()
+          .IntoKey(M::BackgroundVerificationThreadCount)
       .Define("-Xusejit:_")
           .WithType<bool>()
           .WithValueMap({{"false", false}, {"true", true}})
@@ -210,6 +235,17 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
       .Define("-Xjitosrthreshold:_")
           .WithType<unsigned int>()
           .IntoKey(M::JITOsrThreshold)
+      .Define("-Xjittiered:_")
+          .WithType<bool>()
+          .WithValueMap({{"false", false}, {"true", true}})
+          .IntoKey(M::JITUseTieredCompilation)
+      .Define("-Xjitprecompilehotmethods:_")
+          .WithType<bool>()
+          .WithValueMap({{"false", false}, {"true", true}})
+          .IntoKey(M::JITPrecompileHotMethods)
+      .Define("-Xjitoptimizethreshold:_")
+          .WithType<unsigned int>()
+          .IntoKey(M::JITOptimizeThreshold)
       .Define("-Xjitprithreadweight:_")
           .WithType<unsigned int>()
           .IntoKey(M::JITPriorityThreadWeight)
@@ -219,6 +255,14 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
       .Define("-Xjitpthreadpriority:_")
           .WithType<int>()
           .IntoKey(M::JITPoolThreadPthreadPriority)
+      .Define("-Xjitthreadcount:_")
+          .WithType<unsigned int>()
+          .IntoKey(M::JITPoolThreadCount)
+      .Define("-Xjitwarmuptrace:_")
+          .WithType<std::string>()
+          .IntoKey(M::JITWarmupTraceFile)
+      .Define("-Xjitperfprofiling")
+          .IntoKey(M::JITPerfProfiling)
       .Define("-Xjitsaveprofilinginfo")
           .WithType<ProfileSaverOptions>()
           .AppendValues()
@@ -257,6 +301,9 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
       .Define("-XX:LargeObjectThreshold=_")
           .WithType<Memory<1>>()
           .IntoKey(M::LargeObjectThreshold)
+      .Define("-XX:AllocationSamplingInterval=_")  // Mean bytes between allocation samples.
+          .WithType<Memory<1>>()
+          .IntoKey(M::AllocationSamplingInterval)
       .Define("-XX:BackgroundGC=_")
           .WithType<BackgroundGcOption>()
           .IntoKey(M::BackgroundGc)
@@ -276,6 +323,9 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
       .Define("-Xmethod-trace-file:_")
           .WithType<std::string>()
           .IntoKey(M::MethodTraceFile)
+      .Define("-Xstartup-timeline-file:_")
+          .WithType<std::string>()
+          .IntoKey(M::StartupTimelineFile)
       .Define("-Xmethod-trace-file-size:_")
           .WithType<unsigned int>()
           .IntoKey(M::MethodTraceFileSize)
@@ -715,6 +765,7 @@ void ParsedOptions::Usage(const char* fmt, ...) {
   UsageMessage(stream, "  -XX:NonMovingSpaceCapacity=N\n");
   UsageMessage(stream, "  -XX:HeapTargetUtilization=doublevalue\n");
   UsageMessage(stream, "  -XX:ForegroundHeapGrowthMultiplier=doublevalue\n");
+  UsageMessage(stream, "  -XX:GcCpuFractionTarget=doublevalue\n");
   UsageMessage(stream, "  -XX:LowMemoryMode\n");
   UsageMessage(stream, "  -Xprofile:{threadcpuclock,wallclock,dualclock}\n");
   UsageMessage(stream, "  -Xjitthreshold:integervalue\n");
@@ -739,17 +790,26 @@ void ParsedOptions::Usage(const char* fmt, ...) {
   UsageMessage(stream, "  -XX:ThreadSuspendTimeout=integervalue\n");
   UsageMessage(stream, "  -XX:DumpGCPerformanceOnShutdown\n");
   UsageMessage(stream, "  -XX:DumpJITInfoOnShutdown\n");
+  UsageMessage(stream, "  -XX:PerfCounters\n");
+  UsageMessage(stream, "  -XX:FlightRecorder\n");
   UsageMessage(stream, "  -XX:IgnoreMaxFootprint\n");
   UsageMessage(stream, "  -XX:UseTLAB\n");
   UsageMessage(stream, "  -XX:BackgroundGC=none\n");
   UsageMessage(stream, "  -XX:LargeObjectSpace={disabled,map,freelist}\n");
   UsageMessage(stream, "  -XX:LargeObjectThreshold=N\n");
+  UsageMessage(stream, "  -XX:AllocationSamplingInterval=N\n");
   UsageMessage(stream, "  -XX:DumpNativeStackOnSigQuit=booleanvalue\n");
+  UsageMessage(stream, "  -XX:MaxJavaStackTraceDepth=N\n");
   UsageMessage(stream, "  -XX:MadviseRandomAccess:booleanvalue\n");
+  UsageMessage(stream, "  -XX:UseHugePages:booleanvalue\n");
+  UsageMessage(stream, "  -XX:AsyncLogging:booleanvalue\n");
+  UsageMessage(stream, "  -XX:HprofDumpFromChild:booleanvalue\n");
+  UsageMessage(stream, "  -XX:BackgroundVerificationThreadCount=N\n");
   UsageMessage(stream, "  -XX:SlowDebug={false,true}\n");
   UsageMessage(stream, "  -Xmethod-trace\n");
   UsageMessage(stream, "  -Xmethod-trace-file:filename");
   UsageMessage(stream, "  -Xmethod-trace-file-size:integervalue\n");
+  UsageMessage(stream, "  -Xstartup-timeline-file:filename\n");
   UsageMessage(stream, "  -Xps-min-save-period-ms:integervalue\n");
   UsageMessage(stream, "  -Xps-save-resolved-classes-delay-ms:integervalue\n");
   UsageMessage(stream, "  -Xps-hot-startup-method-samples:integervalue\n");
@@ -758,6 +818,7 @@ void ParsedOptions::Usage(const char* fmt, ...) {
   UsageMessage(stream, "  -Xps-min-notification-before-wake:integervalue\n");
   UsageMessage(stream, "  -Xps-max-notification-before-wake:integervalue\n");
   UsageMessage(stream, "  -Xps-profile-path:file-path\n");
+  UsageMessage(stream, "  -Xps-max-delta-log-bytes:integervalue\n");
   UsageMessage(stream, "  -Xcompiler:filename\n");
   UsageMessage(stream, "  -Xcompiler-option dex2oat-option\n");
   UsageMessage(stream, "  -Ximage-compiler-option dex2oat-option\n");
@@ -766,7 +827,13 @@ void ParsedOptions::Usage(const char* fmt, ...) {
   UsageMessage(stream, "  -Xjitmaxsize:N\n");
   UsageMessage(stream, "  -Xjitwarmupthreshold:integervalue\n");
   UsageMessage(stream, "  -Xjitosrthreshold:integervalue\n");
+  UsageMessage(stream, "  -Xjittiered:booleanvalue\n");
+  UsageMessage(stream, "  -Xjitprecompilehotmethods:booleanvalue\n");
+  UsageMessage(stream, "  -Xjitoptimizethreshold:integervalue\n");
   UsageMessage(stream, "  -Xjitprithreadweight:integervalue\n");
+  UsageMessage(stream, "  -Xjitthreadcount:integervalue\n");
+  UsageMessage(stream, "  -Xjitwarmuptrace:filename\n");
+  UsageMessage(stream, "  -Xjitperfprofiling\n");
   UsageMessage(stream, "  -X[no]relocate\n");
   UsageMessage(stream, "  -X[no]dex2oat (Whether to invoke dex2oat on the application)\n");
   UsageMessage(stream, "  -X[no]image-dex2oat (Whether to create and use a boot image)\n");
@@ -56,7 +56,8 @@ QuickExceptionHandler::QuickExceptionHandler(Thread* self, bool is_deoptimizatio
       handler_dex_pc_(0),
       clear_exception_(false),
       handler_frame_depth_(kInvalidFrameDepth),
-      full_fragment_done_(false) {}
+      full_fragment_done_(false),
+      keep_instrumentation_frame_(false) {}
 
 // Finds catch handler.
 class CatchBlockStackVisitor final : public StackVisitor {
@@ -389,6 +390,8 @@ class DeoptimizeStackVisitor final : public StackVisitor {
     }
     if (GetMethod() == nullptr) {
       exception_handler_->SetFullFragmentDone(true);
+      // Returning to the upcall does not go through the exit stub, pop the frames as usual.
+      exception_handler_->SetKeepInstrumentationFrame(false);
     } else {
       CHECK(callee_method_ != nullptr) << GetMethod()->PrettyMethod(false);
       exception_handler_->SetHandlerQuickArg0(reinterpret_cast<uintptr_t>(callee_method_));
@@ -459,6 +462,15 @@ class DeoptimizeStackVisitor final : public StackVisitor {
         single_frame_done_ = true;
         single_frame_deopt_method_ = method;
         single_frame_deopt_quick_method_header_ = GetCurrentOatQuickMethodHeader();
+      } else if (!single_frame_deopt_ &&
+                 !IsInInlinedFrame() &&
+                 GetReturnPc() == reinterpret_cast<uintptr_t>(GetQuickInstrumentationExitPc())) {
+        // The caller will go through the instrumentation exit stub, which deoptimizes it on
+        // return if it still needs to. Leave it and the frames above it compiled for now.
+        VLOG(deopt) << "Deferring the deoptimization of the callers of "
+                    << method->PrettyMethod();
+        single_frame_done_ = true;
+        exception_handler_->SetKeepInstrumentationFrame(true);
       }
       callee_method_ = method;
       return true;
@@ -609,8 +621,14 @@ void QuickExceptionHandler::DeoptimizeSingleFrame(DeoptimizationKind kind) {
               << GetDeoptimizationKindName(kind);
     DumpFramesWithType(self_, /* details= */ true);
   }
-  if (Runtime::Current()->UseJitCompilation()) {
-    Runtime::Current()->GetJit()->GetCodeCache()->InvalidateCompiledCodeFor(
+  if (kind == DeoptimizationKind::kJitOsr) {
+    // The compiled code stays valid. Only this frame moves to the interpreter, which then
+    // enters the OSR compiled code of the method.
+  } else if (Runtime::Current()->UseJitCompilation()) {
+    jit::JitCodeCache* code_cache = Runtime::Current()->GetJit()->GetCodeCache();
+    code_cache->NotifyDeoptimization(
+        deopt_method, visitor.GetSingleFrameDeoptQuickMethodHeader(), kind);
+    code_cache->InvalidateCompiledCodeFor(
         deopt_method, visitor.GetSingleFrameDeoptQuickMethodHeader());
   } else {
     // Transfer the code to interpreter.
@@ -647,8 +665,16 @@ uintptr_t QuickExceptionHandler::UpdateInstrumentationStack() {
   if (method_tracing_active_) {
     size_t instrumentation_frames_to_pop =
         GetInstrumentationFramesToPop(self_, handler_frame_depth_);
-    instrumentation::Instrumentation* instrumentation = Runtime::Current()->GetInstrumentation();
-    return_pc = instrumentation->PopFramesForDeoptimization(self_, instrumentation_frames_to_pop);
+    if (keep_instrumentation_frame_) {
+      // The only instrumentation frame is the one of the deoptimized frame. The interpreter
+      // bridge returns to the exit stub, which pops it. The interpreter reports the method
+      // exit itself, so the stub must not report it again.
+      DCHECK_EQ(instrumentation_frames_to_pop, 1u);
+      self_->GetInstrumentationStack()->front().interpreter_entry_ = true;
+    } else {
+      instrumentation::Instrumentation* instrumentation = Runtime::Current()->GetInstrumentation();
+      return_pc = instrumentation->PopFramesForDeoptimization(self_, instrumentation_frames_to_pop);
+    }
   }
   return return_pc;
 }
@@ -53,7 +53,10 @@ class QuickExceptionHandler {
 
   // Deoptimize the stack to the upcall/some code that's not deoptimizeable. For
   // every compiled frame, we create a "copy" shadow frame that will be executed
-  // with the interpreter.
+  // with the interpreter. The walk stops early after a compiled frame that returns
+  // through the instrumentation exit stub: the stub checks again whether its caller
+  // needs to be deoptimized when the interpreter returns to it, so the remaining
+  // frames are only deoptimized if and when control gets back to them.
   void DeoptimizeStack() REQUIRES_SHARED(Locks::mutator_lock_);
 
   // Deoptimize a single frame. It's directly triggered from compiled code. It
@@ -134,6 +137,10 @@ class QuickExceptionHandler {
     full_fragment_done_ = full_fragment_done;
   }
 
+  void SetKeepInstrumentationFrame(bool keep_instrumentation_frame) {
+    keep_instrumentation_frame_ = keep_instrumentation_frame;
+  }
+
   // Walk the stack frames of the given thread, printing out non-runtime methods with their types
   // of frames. Helps to verify that partial-fragment deopt really works as expected.
   static void DumpFramesWithType(Thread* self, bool details = false)
@@ -166,6 +173,9 @@ class QuickExceptionHandler {
   // by some code that's not deoptimizeable)? Even single-frame deoptimization
   // can set this to true if the fragment contains only one quick frame.
   bool full_fragment_done_;
+  // Did the deoptimization stop after a frame returning through the instrumentation exit
+  // stub? Its instrumentation frame then stays so that the stub still runs on return.
+  bool keep_instrumentation_frame_;
 
   void PrepareForLongJumpToInvokeStubOrInterpreterBridge()
       REQUIRES_SHARED(Locks::mutator_lock_);
@@ -47,6 +47,10 @@ class ReferenceTable {
 
   size_t Size() const;
 
+  void Clear() {
+    entries_.clear();
+  }
+
   void Dump(std::ostream& os)
       REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(!Locks::alloc_tracker_lock_);
@@ -41,6 +41,33 @@ namespace {
 
 using android::base::StringPrintf;
 
+// Whether `klass` is the box class of the primitive `type`. The box classes are the declaring
+// classes of the valueOf methods used for boxing, comparing them is much cheaper than comparing
+// descriptors for each argument of each reflective call.
+ALWAYS_INLINE bool IsBoxClass(ObjPtr<mirror::Class> klass, Primitive::Type type)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  jmethodID value_of = nullptr;
+  switch (type) {
+    case Primitive::kPrimBoolean: value_of = WellKnownClasses::java_lang_Boolean_valueOf; break;
+    case Primitive::kPrimByte: value_of = WellKnownClasses::java_lang_Byte_valueOf; break;
+    case Primitive::kPrimChar: value_of = WellKnownClasses::java_lang_Character_valueOf; break;
+    case Primitive::kPrimShort: value_of = WellKnownClasses::java_lang_Short_valueOf; break;
+    case Primitive::kPrimInt: value_of = WellKnownClasses::java_lang_Integer_valueOf; break;
+    case Primitive::kPrimLong: value_of = WellKnownClasses::java_lang_Long_valueOf; break;
+    case Primitive::kPrimFloat: value_of = WellKnownClasses::java_lang_Float_valueOf; break;
+    case Primitive::kPrimDouble: value_of = WellKnownClasses::java_lang_Double_valueOf; break;
+    case Primitive::kPrimNot:
+    case Primitive::kPrimVoid:
+      LOG(FATAL) << "Not a boxable type: " << type;
+      UNREACHABLE();
+  }
+  if (UNLIKELY(value_of == nullptr)) {
+    // WellKnownClasses are not initialized yet.
+    return klass->DescriptorEquals(Primitive::BoxedDescriptor(type));
+  }
+  return jni::DecodeArtMethod(value_of)->GetDeclaringClass() == klass;
+}
+
 class ArgArray {
  public:
   ArgArray(const char* shorty, uint32_t shorty_len)
@@ -259,15 +286,13 @@ class ArgArray {
         }
       }
 
-#define DO_FIRST_ARG(match_descriptor, get_fn, append) { \
-          if (LIKELY(arg != nullptr && \
-              arg->GetClass()->DescriptorEquals(match_descriptor))) { \
+#define DO_FIRST_ARG(match_type, get_fn, append) { \
+          if (LIKELY(arg != nullptr && IsBoxClass(arg->GetClass(), match_type))) { \
             ArtField* primitive_field = arg->GetClass()->GetInstanceField(0); \
             append(primitive_field-> get_fn(arg.Get()));
 
-#define DO_ARG(match_descriptor, get_fn, append) \
-          } else if (LIKELY(arg != nullptr && \
-                            arg->GetClass<>()->DescriptorEquals(match_descriptor))) { \
+#define DO_ARG(match_type, get_fn, append) \
+          } else if (LIKELY(arg != nullptr && IsBoxClass(arg->GetClass(), match_type))) { \
             ArtField* primitive_field = arg->GetClass()->GetInstanceField(0); \
             append(primitive_field-> get_fn(arg.Get()));
 
@@ -293,54 +318,54 @@ class ArgArray {
           Append(arg.Get());
           break;
         case 'Z':
-          DO_FIRST_ARG("Ljava/lang/Boolean;", GetBoolean, Append)
+          DO_FIRST_ARG(Primitive::kPrimBoolean, GetBoolean, Append)
           DO_FAIL("boolean")
           break;
         case 'B':
-          DO_FIRST_ARG("Ljava/lang/Byte;", GetByte, Append)
+          DO_FIRST_ARG(Primitive::kPrimByte, GetByte, Append)
           DO_FAIL("byte")
           break;
         case 'C':
-          DO_FIRST_ARG("Ljava/lang/Character;", GetChar, Append)
+          DO_FIRST_ARG(Primitive::kPrimChar, GetChar, Append)
           DO_FAIL("char")
           break;
         case 'S':
-          DO_FIRST_ARG("Ljava/lang/Short;", GetShort, Append)
-          DO_ARG("Ljava/lang/Byte;", GetByte, Append)
+          DO_FIRST_ARG(Primitive::kPrimShort, GetShort, Append)
+          DO_ARG(Primitive::kPrimByte, GetByte, Append)
           DO_FAIL("short")
           break;
         case 'I':
-          DO_FIRST_ARG("Ljava/lang/Integer;", GetInt, Append)
-          DO_ARG("Ljava/lang/Character;", GetChar, Append)
-          DO_ARG("Ljava/lang/Short;", GetShort, Append)
-          DO_ARG("Ljava/lang/Byte;", GetByte, Append)
+          DO_FIRST_ARG(Primitive::kPrimInt, GetInt, Append)
+          DO_ARG(Primitive::kPrimChar, GetChar, Append)
+          DO_ARG(Primitive::kPrimShort, GetShort, Append)
+          DO_ARG(Primitive::kPrimByte, GetByte, Append)
           DO_FAIL("int")
           break;
         case 'J':
-          DO_FIRST_ARG("Ljava/lang/Long;", GetLong, AppendWide)
-          DO_ARG("Ljava/lang/Integer;", GetInt, AppendWide)
-          DO_ARG("Ljava/lang/Character;", GetChar, AppendWide)
-          DO_ARG("Ljava/lang/Short;", GetShort, AppendWide)
-          DO_ARG("Ljava/lang/Byte;", GetByte, AppendWide)
+          DO_FIRST_ARG(Primitive::kPrimLong, GetLong, AppendWide)
+          DO_ARG(Primitive::kPrimInt, GetInt, AppendWide)
+          DO_ARG(Primitive::kPrimChar, GetChar, AppendWide)
+          DO_ARG(Primitive::kPrimShort, GetShort, AppendWide)
+          DO_ARG(Primitive::kPrimByte, GetByte, AppendWide)
           DO_FAIL("long")
           break;
         case 'F':
-          DO_FIRST_ARG("Ljava/lang/Float;", GetFloat, AppendFloat)
-          DO_ARG("Ljava/lang/Long;", GetLong, AppendFloat)
-          DO_ARG("Ljava/lang/Integer;", GetInt, AppendFloat)
-          DO_ARG("Ljava/lang/Character;", GetChar, AppendFloat)
-          DO_ARG("Ljava/lang/Short;", GetShort, AppendFloat)
-          DO_ARG("Ljava/lang/Byte;", GetByte, AppendFloat)
+          DO_FIRST_ARG(Primitive::kPrimFloat, GetFloat, AppendFloat)
+          DO_ARG(Primitive::kPrimLong, GetLong, AppendFloat)
+          DO_ARG(Primitive::kPrimInt, GetInt, AppendFloat)
+          DO_ARG(Primitive::kPrimChar, GetChar, AppendFloat)
+          DO_ARG(Primitive::kPrimShort, GetShort, AppendFloat)
+          DO_ARG(Primitive::kPrimByte, GetByte, AppendFloat)
           DO_FAIL("float")
           break;
         case 'D':
-          DO_FIRST_ARG("Ljava/lang/Double;", GetDouble, AppendDouble)
-          DO_ARG("Ljava/lang/Float;", GetFloat, AppendDouble)
-          DO_ARG("Ljava/lang/Long;", GetLong, AppendDouble)
-          DO_ARG("Ljava/lang/Integer;", GetInt, AppendDouble)
-          DO_ARG("Ljava/lang/Character;", GetChar, AppendDouble)
-          DO_ARG("Ljava/lang/Short;", GetShort, AppendDouble)
-          DO_ARG("Ljava/lang/Byte;", GetByte, AppendDouble)
+          DO_FIRST_ARG(Primitive::kPrimDouble, GetDouble, AppendDouble)
+          DO_ARG(Primitive::kPrimFloat, GetFloat, AppendDouble)
+          DO_ARG(Primitive::kPrimLong, GetLong, AppendDouble)
+          DO_ARG(Primitive::kPrimInt, GetInt, AppendDouble)
+          DO_ARG(Primitive::kPrimChar, GetChar, AppendDouble)
+          DO_ARG(Primitive::kPrimShort, GetShort, AppendDouble)
+          DO_ARG(Primitive::kPrimByte, GetByte, AppendDouble)
           DO_FAIL("double")
           break;
 #ifndef NDEBUG
@@ -893,28 +918,28 @@ static bool UnboxPrimitive(ObjPtr<mirror::Object> o,
   ObjPtr<mirror::Class> klass = o->GetClass();
   Primitive::Type primitive_type;
   ArtField* primitive_field = &klass->GetIFieldsPtr()->At(0);
-  if (klass->DescriptorEquals("Ljava/lang/Boolean;")) {
+  if (IsBoxClass(klass, Primitive::kPrimBoolean)) {
     primitive_type = Primitive::kPrimBoolean;
     boxed_value.SetZ(primitive_field->GetBoolean(o));
-  } else if (klass->DescriptorEquals("Ljava/lang/Byte;")) {
+  } else if (IsBoxClass(klass, Primitive::kPrimByte)) {
     primitive_type = Primitive::kPrimByte;
     boxed_value.SetB(primitive_field->GetByte(o));
-  } else if (klass->DescriptorEquals("Ljava/lang/Character;")) {
+  } else if (IsBoxClass(klass, Primitive::kPrimChar)) {
     primitive_type = Primitive::kPrimChar;
     boxed_value.SetC(primitive_field->GetChar(o));
-  } else if (klass->DescriptorEquals("Ljava/lang/Float;")) {
+  } else if (IsBoxClass(klass, Primitive::kPrimFloat)) {
     primitive_type = Primitive::kPrimFloat;
     boxed_value.SetF(primitive_field->GetFloat(o));
-  } else if (klass->DescriptorEquals("Ljava/lang/Double;")) {
+  } else if (IsBoxClass(klass, Primitive::kPrimDouble)) {
     primitive_type = Primitive::kPrimDouble;
     boxed_value.SetD(primitive_field->GetDouble(o));
-  } else if (klass->DescriptorEquals("Ljava/lang/Integer;")) {
+  } else if (IsBoxClass(klass, Primitive::kPrimInt)) {
     primitive_type = Primitive::kPrimInt;
     boxed_value.SetI(primitive_field->GetInt(o));
-  } else if (klass->DescriptorEquals("Ljava/lang/Long;")) {
+  } else if (IsBoxClass(klass, Primitive::kPrimLong)) {
     primitive_type = Primitive::kPrimLong;
     boxed_value.SetJ(primitive_field->GetLong(o));
-  } else if (klass->DescriptorEquals("Ljava/lang/Short;")) {
+  } else if (IsBoxClass(klass, Primitive::kPrimShort)) {
     primitive_type = Primitive::kPrimShort;
     boxed_value.SetS(primitive_field->GetShort(o));
   } else {
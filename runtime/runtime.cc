@@ -25,6 +25,7 @@
 
 #include <fcntl.h>
 #include <signal.h>
+#include <sys/resource.h>
 #include <sys/syscall.h>
 
 #if defined(__APPLE__)
@@ -61,6 +62,7 @@
 #include "base/mem_map_arena_pool.h"
 #include "base/memory_tool.h"
 #include "base/mutex.h"
+#include "base/native_memory_tracker.h"
 #include "base/os.h"
 #include "base/quasi_atomic.h"
 #include "base/sdk_version.h"
@@ -78,6 +80,7 @@
 #include "entrypoints/runtime_asm_entrypoints.h"
 #include "experimental_flags.h"
 #include "fault_handler.h"
+#include "flight_recorder.h"
 #include "gc/accounting/card_table-inl.h"
 #include "gc/heap.h"
 #include "gc/scoped_gc_critical_section.h"
@@ -112,6 +115,7 @@
 #include "mirror/throwable.h"
 #include "mirror/var_handle.h"
 #include "monitor.h"
+#include "monitor_contention_profile.h"
 #include "native/dalvik_system_DexFile.h"
 #include "native/dalvik_system_VMDebug.h"
 #include "native/dalvik_system_VMRuntime.h"
@@ -239,6 +243,7 @@ Runtime::Runtime()
       max_spins_before_thin_lock_inflation_(Monitor::kDefaultMaxSpinsBeforeThinLockInflation),
       monitor_list_(nullptr),
       monitor_pool_(nullptr),
+      monitor_contention_profile_(nullptr),
       thread_list_(nullptr),
       intern_table_(nullptr),
       class_linker_(nullptr),
@@ -262,6 +267,7 @@ Runtime::Runtime()
       system_thread_group_(nullptr),
       system_class_loader_(nullptr),
       dump_gc_performance_on_shutdown_(false),
+      use_perf_counters_(false),
       preinitialization_transactions_(),
       verify_(verifier::VerifyMode::kNone),
       allow_dex_file_fallback_(true),
@@ -286,6 +292,9 @@ Runtime::Runtime()
       dedupe_hidden_api_warnings_(true),
       hidden_api_access_event_log_rate_(0),
       dump_native_stack_on_sig_quit_(true),
+      max_java_stack_trace_depth_(0u),
+      hprof_dump_from_child_(false),
+      background_verification_thread_count_(1u),
       pruned_dalvik_cache_(false),
       // Initially assume we perceive jank in case the process state is never updated.
       process_state_(kProcessStateJankPerceptible),
@@ -461,6 +470,9 @@ Runtime::~Runtime() {
     jit_code_cache_.reset(nullptr);
   }
 
+  // After the thread list and the JIT, so that no thread records events any more.
+  flight_recorder_.reset();
+
   // Shutdown the fault manager if it was initialized.
   fault_manager.Shutdown();
 
@@ -468,6 +480,8 @@ Runtime::~Runtime() {
   delete monitor_list_;
   delete monitor_pool_;
   delete class_linker_;
+  // After the class linker, which forgets the methods of the deleted class loaders.
+  delete monitor_contention_profile_;
   delete heap_;
   delete intern_table_;
   delete oat_file_manager_;
@@ -484,6 +498,9 @@ Runtime::~Runtime() {
   protected_fault_page_.Reset();
   MemMap::Shutdown();
 
+  // Write out messages still queued by the asynchronous logger, if it was used.
+  StopAsyncLogging();
+
   // TODO: acquire a static mutex on Runtime to avoid racing.
   CHECK(instance_ == nullptr || instance_ == this);
   instance_ = nullptr;
@@ -814,6 +831,7 @@ void Runtime::RunRootClinits(Thread* self) {
 
 bool Runtime::Start() {
   VLOG(startup) << "Runtime::Start entering";
+  startup_timeline_.StartPhase("Start");
 
   CHECK(!no_sig_chain_) << "A started runtime should have sig chain enabled";
 
@@ -851,12 +869,14 @@ bool Runtime::Start() {
   // it touches will have methods linked to the oat file if necessary.
   {
     ScopedTrace trace2("InitNativeMethods");
+    startup_timeline_.StartPhase("InitNativeMethods");
     InitNativeMethods();
   }
 
   // IntializeIntrinsics needs to be called after the WellKnownClasses::Init in InitNativeMethods
   // because in checking the invocation types of intrinsic methods ArtMethod::GetInvokeType()
   // needs the SignaturePolymorphic annotation class which is initialized in WellKnownClasses::Init.
+  startup_timeline_.StartPhase("InitializeIntrinsics");
   InitializeIntrinsics();
 
   // Initialize well known thread group values that may be accessed threads while attaching.
@@ -871,6 +891,7 @@ bool Runtime::Start() {
   // TODO(calin): We use the JIT class as a proxy for JIT compilation and for
   // recoding profiles. Maybe we should consider changing the name to be more clear it's
   // not only about compiling. b/28295073.
+  startup_timeline_.StartPhase("CreateJit");
   if (jit_options_->UseJitCompilation() || jit_options_->GetSaveProfilingInfo()) {
     // Try to load compiler pre zygote to reduce PSS. b/27744947
     std::string error_msg;
@@ -888,6 +909,7 @@ bool Runtime::Start() {
     callbacks_->NextRuntimePhase(RuntimePhaseCallback::RuntimePhase::kStart);
   }
 
+  startup_timeline_.StartPhase("CreateSystemClassLoader");
   system_class_loader_ = CreateSystemClassLoader(this);
 
   if (!is_zygote_) {
@@ -903,6 +925,7 @@ bool Runtime::Start() {
                             GetInstructionSetString(kRuntimeISA));
   }
 
+  startup_timeline_.StartPhase("StartDaemonThreads");
   StartDaemonThreads();
 
   // Make sure the environment is still clean (no lingering local refs from starting daemon
@@ -926,6 +949,16 @@ bool Runtime::Start() {
 
   VLOG(startup) << "Runtime::Start exiting";
   finished_starting_ = true;
+  startup_timeline_.Finish();
+  if (VLOG_IS_ON(startup)) {
+    startup_timeline_.Dump(LOG_STREAM(INFO));
+  }
+  if (!startup_timeline_file_.empty()) {
+    std::string error_msg;
+    if (!startup_timeline_.WriteToFile(startup_timeline_file_, &error_msg)) {
+      LOG(WARNING) << "Failed to write startup timeline: " << error_msg;
+    }
+  }
 
   if (trace_config_.get() != nullptr && trace_config_->trace_file != "") {
     ScopedThreadStateChange tsc(self, kWaitingForMethodTracingStart);
@@ -1128,14 +1161,19 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
   using Opt = RuntimeArgumentMap;
   Opt runtime_options(std::move(runtime_options_in));
   ScopedTrace trace(__FUNCTION__);
+  startup_timeline_.StartPhase("Init");
   CHECK_EQ(sysconf(_SC_PAGE_SIZE), kPageSize);
 
   // Early override for logging output.
   if (runtime_options.Exists(Opt::UseStderrLogger)) {
     android::base::SetLogger(android::base::StderrLogger);
+  } else if (runtime_options.GetOrDefault(Opt::AsyncLogging)) {
+    StartAsyncLogging();
   }
 
   MemMap::Init();
+  // Must be set before creating the heap and JIT code cache mappings.
+  MemMap::SetUseHugePages(runtime_options.GetOrDefault(Opt::UseHugePages));
 
   // Try to reserve a dedicated fault page. This is allocated for clobbered registers and sentinels.
   // If we cannot reserve it, log a warning.
@@ -1225,6 +1263,10 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
   is_explicit_gc_disabled_ = runtime_options.Exists(Opt::DisableExplicitGC);
   image_dex2oat_enabled_ = runtime_options.GetOrDefault(Opt::ImageDex2Oat);
   dump_native_stack_on_sig_quit_ = runtime_options.GetOrDefault(Opt::DumpNativeStackOnSigQuit);
+  max_java_stack_trace_depth_ = runtime_options.GetOrDefault(Opt::MaxJavaStackTraceDepth);
+  hprof_dump_from_child_ = runtime_options.GetOrDefault(Opt::HprofDumpFromChild);
+  background_verification_thread_count_ =
+      runtime_options.GetOrDefault(Opt::BackgroundVerificationThreadCount);
 
   vfprintf_ = runtime_options.GetOrDefault(Opt::HookVfprintf);
   exit_ = runtime_options.GetOrDefault(Opt::HookExit);
@@ -1248,6 +1290,7 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
 
   monitor_list_ = new MonitorList;
   monitor_pool_ = MonitorPool::Create();
+  monitor_contention_profile_ = new MonitorContentionProfile;
   thread_list_ = new ThreadList(runtime_options.GetOrDefault(Opt::ThreadSuspendTimeout));
   intern_table_ = new InternTable;
 
@@ -1311,6 +1354,7 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
 
   image_space_loading_order_ = runtime_options.GetOrDefault(Opt::ImageSpaceLoadingOrder);
 
+  startup_timeline_.StartPhase("CreateHeap");
   heap_ = new gc::Heap(runtime_options.GetOrDefault(Opt::MemoryInitialSize),
                        runtime_options.GetOrDefault(Opt::HeapGrowthLimit),
                        runtime_options.GetOrDefault(Opt::HeapMinFree),
@@ -1356,7 +1400,16 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
     return false;
   }
 
+  heap_->SetAllocationSamplingInterval(
+      runtime_options.GetOrDefault(Opt::AllocationSamplingInterval));
+  heap_->SetGcCpuFractionTarget(runtime_options.GetOrDefault(Opt::GcCpuFractionTarget));
+
   dump_gc_performance_on_shutdown_ = runtime_options.Exists(Opt::DumpGCPerformanceOnShutdown);
+  use_perf_counters_ = runtime_options.Exists(Opt::PerfCounters);
+  if (runtime_options.Exists(Opt::FlightRecorder)) {
+    flight_recorder_.reset(new FlightRecorder());
+  }
+  startup_timeline_file_ = runtime_options.ReleaseOrDefault(Opt::StartupTimelineFile);
 
   jdwp_options_ = runtime_options.GetOrDefault(Opt::JdwpOptions);
   jdwp_provider_ = CanonicalizeJdwpProvider(runtime_options.GetOrDefault(Opt::JdwpProvider),
@@ -1422,10 +1475,13 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
     arena_pool_.reset(new MemMapArenaPool(/* low_4gb= */ false));
     jit_arena_pool_.reset(new MemMapArenaPool(/* low_4gb= */ false, "CompilerMetadata"));
   }
+  arena_pool_->SetNativeMemoryTag(NativeMemoryTag::kRuntimeArenas);
+  jit_arena_pool_->SetNativeMemoryTag(NativeMemoryTag::kCompilerArenas);
 
   if (IsAotCompiler() && Is64BitInstructionSet(kRuntimeISA)) {
     // 4gb, no malloc. Explanation in header.
     low_4gb_arena_pool_.reset(new MemMapArenaPool(/* low_4gb= */ true));
+    low_4gb_arena_pool_->SetNativeMemoryTag(NativeMemoryTag::kRuntimeArenas);
   }
   linear_alloc_.reset(CreateLinearAlloc());
 
@@ -1480,6 +1536,7 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
 
   verifier_logging_threshold_ms_ = runtime_options.GetOrDefault(Opt::VerifierLoggingThreshold);
 
+  startup_timeline_.StartPhase("CreateJavaVM");
   std::string error_msg;
   java_vm_ = JavaVMExt::Create(this, runtime_options, &error_msg);
   if (java_vm_.get() == nullptr) {
@@ -1510,6 +1567,7 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
 
   CHECK_GE(GetHeap()->GetContinuousSpaces().size(), 1U);
 
+  startup_timeline_.StartPhase("InitClassLinker");
   if (UNLIKELY(IsAotCompiler())) {
     class_linker_ = new AotClassLinker(intern_table_);
   } else {
@@ -1653,6 +1711,7 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
   // Runtime initialization is largely done now.
   // We load plugins first since that can modify the runtime state slightly.
   // Load all plugins
+  startup_timeline_.StartPhase("LoadPlugins");
   {
     // The init method of plugins expect the state of the thread to be non runnable.
     ScopedThreadSuspension sts(self, ThreadState::kNative);
@@ -1698,6 +1757,7 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
 
   // Startup agents
   // TODO Maybe we should start a new thread to run these on. Investigate RI behavior more.
+  startup_timeline_.StartPhase("LoadAgents");
   for (auto& agent_spec : agent_specs_) {
     // TODO Check err
     int res = 0;
@@ -1731,6 +1791,8 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
   }
 
   VLOG(startup) << "Runtime::Init exiting";
+  // Covers the time until Start, spent in the embedder.
+  startup_timeline_.StartPhase("InitToStart");
 
   // Set OnlyUseSystemOatFiles only after boot classpath has been set up.
   if (is_zygote_ || runtime_options.Exists(Opt::OnlyUseSystemOatFiles)) {
@@ -1943,7 +2005,18 @@ void Runtime::DumpForSigQuit(std::ostream& os) {
     os << "Running non JIT\n";
   }
   DumpDeoptimizations(os);
+  InterpreterCache::DumpForSigQuit(os);
+  hiddenapi::DumpForSigQuit(os);
   TrackedAllocators::Dump(os);
+  NativeMemoryTracker::Dump(os);
+  MemMap::DumpForSigQuit(os);
+  {
+    ScopedObjectAccess soa(Thread::Current());
+    monitor_contention_profile_->Dump(os);
+  }
+  if (flight_recorder_ != nullptr) {
+    flight_recorder_->Dump(os);
+  }
   os << "\n";
 
   thread_list_->DumpForSigQuit(os);
@@ -2833,7 +2906,17 @@ void Runtime::NotifyStartupCompleted() {
     // once externally. For this reason there are no asserts.
     return;
   }
-  VLOG(startup) << "Startup completed notified";
+  if (VLOG_IS_ON(startup)) {
+    // Major faults are the main cost of a cold startup, log them to tune the prefetching of the
+    // startup parts of the dex files.
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+      VLOG(startup) << "Startup completed notified, major page faults: " << usage.ru_majflt
+                    << ", minor page faults: " << usage.ru_minflt;
+    } else {
+      VLOG(startup) << "Startup completed notified";
+    }
+  }
 
   {
     ScopedTrace trace("Releasing app image spaces metadata");
@@ -2881,6 +2964,14 @@ void Runtime::NotifyStartupCompleted() {
     }
   }
 
+  {
+    // The startup only parts of the app dex files are unlikely to be used again, drop them from
+    // the page cache.
+    ScopedTrace trace("Madvise app dex files");
+    GetClassLinker()->MadviseAppDexFiles(Thread::Current(),
+                                         MadviseState::kMadviseStateFinishedLaunch);
+  }
+
   // Notify the profiler saver that startup is now completed.
   ProfileSaver::NotifyStartupCompleted();
 
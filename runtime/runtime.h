@@ -43,6 +43,7 @@
 #include "process_state.h"
 #include "quick/quick_method_frame_info.h"
 #include "runtime_stats.h"
+#include "startup_timeline.h"
 
 namespace art {
 
@@ -85,11 +86,13 @@ enum class CalleeSaveType: uint32_t;
 class ClassLinker;
 class CompilerCallbacks;
 class DexFile;
+class FlightRecorder;
 enum class InstructionSet;
 class InternTable;
 class IsMarkedVisitor;
 class JavaVMExt;
 class LinearAlloc;
+class MonitorContentionProfile;
 class MonitorList;
 class MonitorPool;
 class NullPointerHandler;
@@ -309,6 +312,10 @@ class Runtime {
     return monitor_pool_;
   }
 
+  MonitorContentionProfile* GetMonitorContentionProfile() const {
+    return monitor_contention_profile_;
+  }
+
   // Is the given object the special object used to mark a cleared JNI weak global?
   bool IsClearedJniWeakGlobal(ObjPtr<mirror::Object> obj) REQUIRES_SHARED(Locks::mutator_lock_);
 
@@ -744,6 +751,19 @@ class Runtime {
     return dump_native_stack_on_sig_quit_;
   }
 
+  // The maximum number of frames recorded in the stack trace of a Throwable, 0 if unlimited.
+  uint32_t GetMaxJavaStackTraceDepth() const {
+    return max_java_stack_trace_depth_;
+  }
+
+  bool GetHprofDumpFromChild() const {
+    return hprof_dump_from_child_;
+  }
+
+  unsigned int GetBackgroundVerificationThreadCount() const {
+    return background_verification_thread_count_;
+  }
+
   bool GetPrunedDalvikCache() const {
     return pruned_dalvik_cache_;
   }
@@ -804,6 +824,20 @@ class Runtime {
     return dump_gc_performance_on_shutdown_;
   }
 
+  // Whether GC iterations and JIT compilations count hardware events with PerfCounters.
+  bool UsePerfCounters() const {
+    return use_perf_counters_;
+  }
+
+  // Null unless the runtime was started with -XX:FlightRecorder.
+  FlightRecorder* GetFlightRecorder() const {
+    return flight_recorder_.get();
+  }
+
+  const StartupTimeline& GetStartupTimeline() const {
+    return startup_timeline_;
+  }
+
   void IncrementDeoptimizationCount(DeoptimizationKind kind) {
     DCHECK_LE(kind, DeoptimizationKind::kLast);
     deoptimization_counts_[static_cast<size_t>(kind)]++;
@@ -988,6 +1022,7 @@ class Runtime {
   size_t max_spins_before_thin_lock_inflation_;
   MonitorList* monitor_list_;
   MonitorPool* monitor_pool_;
+  MonitorContentionProfile* monitor_contention_profile_;
 
   ThreadList* thread_list_;
 
@@ -1054,6 +1089,17 @@ class Runtime {
   // If true, then we dump the GC cumulative timings on shutdown.
   bool dump_gc_performance_on_shutdown_;
 
+  // If true, then GC iterations and JIT compilations read the hardware performance counters.
+  bool use_perf_counters_;
+
+  // Recent GC, JIT, deoptimization, contention, class preparation and suspension events.
+  std::unique_ptr<FlightRecorder> flight_recorder_;
+
+  // Durations of the phases of Init and Start. Written to `startup_timeline_file_`, if set, and
+  // logged with -verbose:startup once Start finishes.
+  StartupTimeline startup_timeline_;
+  std::string startup_timeline_file_;
+
   // Transactions used for pre-initializing classes at compilation time.
   // Support nested transactions, maintain a list containing all transactions. Transactions are
   // handled under a stack discipline. Because GC needs to go over all transactions, we choose list
@@ -1165,6 +1211,16 @@ class Runtime {
   // Whether threads should dump their native stack on SIGQUIT.
   bool dump_native_stack_on_sig_quit_;
 
+  // Set with -XX:MaxJavaStackTraceDepth. The frames past it are not even walked.
+  uint32_t max_java_stack_trace_depth_;
+
+  // Whether hprof heap dumps to a file are written by a forked child process, so that the
+  // application is only paused for the fork.
+  bool hprof_dump_from_child_;
+
+  // Number of threads verifying the classes of in-memory dex files in the background.
+  unsigned int background_verification_thread_count_;
+
   // Whether the dalvik cache was pruned when initializing the runtime.
   bool pruned_dalvik_cache_;
 
@@ -0,0 +1,121 @@
+/*
+ * Copyright (C) 2019 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "startup_timeline.h"
+
+#include <inttypes.h>
+#include <sys/resource.h>
+
+#include <memory>
+#include <ostream>
+
+#include "android-base/stringprintf.h"
+
+#include "base/os.h"
+#include "base/time_utils.h"
+#include "base/unix_file/fd_file.h"
+#include "gc/heap.h"
+#include "runtime.h"
+
+namespace art {
+
+StartupTimeline::Counters StartupTimeline::ReadCounters() {
+  Counters counters;
+  counters.time_ns = NanoTime();
+  rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) == 0) {
+    counters.major_faults = usage.ru_majflt;
+    counters.minor_faults = usage.ru_minflt;
+  } else {
+    counters.major_faults = 0u;
+    counters.minor_faults = 0u;
+  }
+  // The first phases run before the heap is created.
+  Runtime* const runtime = Runtime::Current();
+  gc::Heap* const heap = (runtime != nullptr) ? runtime->GetHeap() : nullptr;
+  counters.allocated_bytes = (heap != nullptr) ? heap->GetBytesAllocatedEver() : 0u;
+  return counters;
+}
+
+void StartupTimeline::EndCurrentPhase(const Counters& counters) {
+  if (phases_.empty() || finished_) {
+    return;
+  }
+  Phase& phase = phases_.back();
+  phase.duration_ns = counters.time_ns - current_phase_start_.time_ns;
+  phase.major_faults = counters.major_faults - current_phase_start_.major_faults;
+  phase.minor_faults = counters.minor_faults - current_phase_start_.minor_faults;
+  phase.allocated_bytes = counters.allocated_bytes - current_phase_start_.allocated_bytes;
+}
+
+void StartupTimeline::StartPhase(const char* name) {
+  if (finished_) {
+    return;
+  }
+  Counters counters = ReadCounters();
+  EndCurrentPhase(counters);
+  phases_.push_back(Phase{name, counters.time_ns, 0u, 0u, 0u, 0u});
+  current_phase_start_ = counters;
+}
+
+void StartupTimeline::Finish() {
+  EndCurrentPhase(ReadCounters());
+  finished_ = true;
+}
+
+void StartupTimeline::Dump(std::ostream& os) const {
+  uint64_t total_ns = 0u;
+  for (const Phase& phase : phases_) {
+    os << phase.name << ": " << PrettyDuration(phase.duration_ns)
+       << " major faults=" << phase.major_faults
+       << " minor faults=" << phase.minor_faults
+       << " allocated=" << PrettySize(phase.allocated_bytes) << "\n";
+    total_ns += phase.duration_ns;
+  }
+  os << "Total startup time: " << PrettyDuration(total_ns) << "\n";
+}
+
+bool StartupTimeline::WriteToFile(const std::string& path, std::string* error_msg) const {
+  std::string contents = "phase,start_ns,duration_ns,major_faults,minor_faults,allocated_bytes\n";
+  for (const Phase& phase : phases_) {
+    contents += android::base::StringPrintf("%s,%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64
+                                                ",%" PRIu64 "\n",
+                                            phase.name,
+                                            phase.start_ns,
+                                            phase.duration_ns,
+                                            phase.major_faults,
+                                            phase.minor_faults,
+                                            phase.allocated_bytes);
+  }
+  std::unique_ptr<File> out(OS::CreateEmptyFileWriteOnly(path.c_str()));
+  if (out == nullptr) {
+    *error_msg = "Could not open " + path + " for writing";
+    return false;
+  }
+  if (!out->WriteFully(contents.c_str(), contents.size())) {
+    *error_msg = "Could not write startup timeline to " + path;
+    out->Unlink();
+    return false;
+  }
+  if (out->FlushClose() != 0) {
+    *error_msg = "Could not flush and close " + path;
+    out->Unlink();
+    return false;
+  }
+  return true;
+}
+
+}  // namespace art
@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2019 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_STARTUP_TIMELINE_H_
+#define ART_RUNTIME_STARTUP_TIMELINE_H_
+
+#include <stdint.h>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include "base/macros.h"
+
+namespace art {
+
+// Sequence of the phases of Runtime::Init and Runtime::Start with their duration, the page faults
+// of the process and the bytes allocated on the heap during each of them. Only used by the thread
+// that creates the runtime, before any other thread can look at it.
+class StartupTimeline {
+ public:
+  struct Phase {
+    const char* name;
+    uint64_t start_ns;
+    uint64_t duration_ns;
+    uint64_t major_faults;
+    uint64_t minor_faults;
+    uint64_t allocated_bytes;
+  };
+
+  StartupTimeline() : finished_(false) {}
+
+  // Ends the current phase, if any, and starts the phase `name`, which must be a literal.
+  void StartPhase(const char* name);
+
+  // Ends the current phase. Further calls to StartPhase are ignored.
+  void Finish();
+
+  const std::vector<Phase>& GetPhases() const {
+    return phases_;
+  }
+
+  void Dump(std::ostream& os) const;
+
+  // Writes one comma separated line per phase, preceded by a header line.
+  bool WriteToFile(const std::string& path, std::string* error_msg) const;
+
+ private:
+  struct Counters {
+    uint64_t time_ns;
+    uint64_t major_faults;
+    uint64_t minor_faults;
+    uint64_t allocated_bytes;
+  };
+
+  static Counters ReadCounters();
+
+  void EndCurrentPhase(const Counters& counters);
+
+  std::vector<Phase> phases_;
+  Counters current_phase_start_;
+  bool finished_;
+
+  DISALLOW_COPY_AND_ASSIGN(StartupTimeline);
+};
+
+}  // namespace art
+
+#endif  // ART_RUNTIME_STARTUP_TIMELINE_H_
@@ -0,0 +1,57 @@
+/*
+ * Copyright (C) 2019 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "startup_timeline.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+#include "common_runtime_test.h"
+#include "runtime.h"
+
+namespace art {
+
+class StartupTimelineTest : public CommonRuntimeTest {};
+
+TEST_F(StartupTimelineTest, Phases) {
+  StartupTimeline timeline;
+  timeline.StartPhase("First");
+  timeline.StartPhase("Second");
+  timeline.Finish();
+  // Phases started after Finish are not recorded.
+  timeline.StartPhase("Third");
+
+  const std::vector<StartupTimeline::Phase>& phases = timeline.GetPhases();
+  ASSERT_EQ(2u, phases.size());
+  EXPECT_STREQ("First", phases[0].name);
+  EXPECT_STREQ("Second", phases[1].name);
+  EXPECT_LE(phases[0].start_ns + phases[0].duration_ns, phases[1].start_ns);
+}
+
+TEST_F(StartupTimelineTest, RuntimeInit) {
+  const std::vector<StartupTimeline::Phase>& phases =
+      Runtime::Current()->GetStartupTimeline().GetPhases();
+  auto has_phase = [&](const char* name) {
+    return std::any_of(phases.begin(), phases.end(), [&](const StartupTimeline::Phase& phase) {
+      return strcmp(phase.name, name) == 0;
+    });
+  };
+  EXPECT_TRUE(has_phase("CreateHeap"));
+  EXPECT_TRUE(has_phase("InitClassLinker"));
+}
+
+}  // namespace art
@@ -22,7 +22,10 @@
 #include "gc/heap.h"
 #include "mirror/string-alloc-inl.h"
 #include "obj_ptr-inl.h"
+#include "reflection.h"
 #include "runtime.h"
+#include "scoped_thread_state_change-inl.h"
+#include "well_known_classes.h"
 
 namespace art {
 
@@ -60,6 +63,12 @@ class StringBuilderAppend::Builder {
     return new_string->GetLength() - (data - new_string->GetValue());
   }
 
+  // Convert float and double arguments to strings by calling the managed Float.toString()
+  // and Double.toString(), storing the results in their reserved handles and adding their
+  // lengths to `*length`. Returns false if the conversion threw an exception.
+  bool ConvertFloatingPointArgs(uint64_t* length, bool* compressible)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   template <typename CharType, size_t size>
   static CharType* AppendLiteral(ObjPtr<mirror::String> new_string,
                                  CharType* data,
@@ -168,14 +177,15 @@ inline CharType* StringBuilderAppend::Builder::AppendString(ObjPtr<mirror::Strin
   if (sizeof(CharType) == sizeof(uint8_t) || str->IsCompressed()) {
     DCHECK(str->IsCompressed());
     const uint8_t* value = str->GetValueCompressed();
-    for (size_t i = 0; i != length; ++i) {
-      data[i] = value[i];
+    if (sizeof(CharType) == sizeof(uint8_t)) {
+      memcpy(data, value, length * sizeof(uint8_t));
+    } else {
+      for (size_t i = 0; i != length; ++i) {
+        data[i] = value[i];
+      }
     }
   } else {
-    const uint16_t* value = str->GetValue();
-    for (size_t i = 0; i != length; ++i) {
-      data[i] = dchecked_integral_cast<CharType>(value[i]);
-    }
+    memcpy(data, str->GetValue(), length * sizeof(CharType));
   }
   return data + length;
 }
@@ -208,6 +218,7 @@ inline int32_t StringBuilderAppend::Builder::CalculateLengthWithFlag() {
   static_assert(static_cast<size_t>(Argument::kEnd) == 0u, "kEnd must be 0.");
   bool compressible = mirror::kUseStringCompression;
   uint64_t length = 0u;
+  bool has_floating_point_args = false;
   const uint32_t* current_arg = args_;
   for (uint32_t f = format_; f != 0u; f >>= kBitsPerArg) {
     DCHECK_LE(f & kArgMask, static_cast<uint32_t>(Argument::kLast));
@@ -243,12 +254,23 @@ inline int32_t StringBuilderAppend::Builder::CalculateLengthWithFlag() {
         ++current_arg;  // Skip the low word, let the common code skip the high word.
         break;
       }
+      case Argument::kFloat: {
+        // Reserve a handle for the converted string, see ConvertFloatingPointArgs().
+        hs_.NewHandle<mirror::String>(nullptr);
+        has_floating_point_args = true;
+        break;
+      }
+      case Argument::kDouble: {
+        hs_.NewHandle<mirror::String>(nullptr);
+        has_floating_point_args = true;
+        current_arg = AlignUp(current_arg, sizeof(int64_t));
+        ++current_arg;  // Skip the low word, let the common code skip the high word.
+        break;
+      }
 
       case Argument::kStringBuilder:
       case Argument::kCharArray:
       case Argument::kObject:
-      case Argument::kFloat:
-      case Argument::kDouble:
         LOG(FATAL) << "Unimplemented arg format: 0x" << std::hex
             << (f & kArgMask) << " full format: 0x" << std::hex << format_;
         UNREACHABLE();
@@ -261,6 +283,13 @@ inline int32_t StringBuilderAppend::Builder::CalculateLengthWithFlag() {
     DCHECK_LE(hs_.NumberOfReferences(), kMaxArgs);
   }
 
+  // Converting floating point values calls managed code which can suspend and move objects,
+  // so do that only after all references from `args_` have been moved to the handle scope.
+  if (has_floating_point_args && !ConvertFloatingPointArgs(&length, &compressible)) {
+    DCHECK(hs_.Self()->IsExceptionPending());
+    return -1;
+  }
+
   if (length > std::numeric_limits<int32_t>::max()) {
     // We cannot allocate memory for the entire result.
     hs_.Self()->ThrowNewException("Ljava/lang/OutOfMemoryError;",
@@ -272,6 +301,52 @@ inline int32_t StringBuilderAppend::Builder::CalculateLengthWithFlag() {
   return length_with_flag_;
 }
 
+inline bool StringBuilderAppend::Builder::ConvertFloatingPointArgs(uint64_t* length,
+                                                                  bool* compressible) {
+  ScopedObjectAccessUnchecked soa(hs_.Self());
+  size_t handle_index = 0u;
+  const uint32_t* current_arg = args_;
+  for (uint32_t f = format_; f != 0u; f >>= kBitsPerArg) {
+    jvalue value;
+    jmethodID to_string;
+    switch (static_cast<Argument>(f & kArgMask)) {
+      case Argument::kString:
+        ++handle_index;
+        ++current_arg;
+        continue;
+      case Argument::kLong:
+        current_arg = AlignUp(current_arg, sizeof(int64_t)) + 2u;
+        continue;
+      case Argument::kFloat:
+        value.f = bit_cast<float>(*current_arg);
+        to_string = WellKnownClasses::java_lang_Float_toString;
+        ++current_arg;
+        break;
+      case Argument::kDouble:
+        current_arg = AlignUp(current_arg, sizeof(int64_t));
+        value.d = bit_cast<double>(*reinterpret_cast<const uint64_t*>(current_arg));
+        to_string = WellKnownClasses::java_lang_Double_toString;
+        current_arg += 2u;
+        break;
+      default:
+        ++current_arg;
+        continue;
+    }
+    JValue result = InvokeWithJValues(soa, nullptr, to_string, &value);
+    if (soa.Self()->IsExceptionPending()) {
+      return false;
+    }
+    ObjPtr<mirror::String> str = ObjPtr<mirror::String>::DownCast(result.GetL());
+    DCHECK(str != nullptr);
+    hs_.SetReference(handle_index, str);
+    ++handle_index;
+    *length += str->GetLength();
+    *compressible = *compressible && str->IsCompressed();
+  }
+  DCHECK_EQ(handle_index, hs_.NumberOfReferences());
+  return true;
+}
+
 template <typename CharType>
 inline void StringBuilderAppend::Builder::StoreData(ObjPtr<mirror::String> new_string,
                                                     CharType* data) const {
@@ -280,7 +355,8 @@ inline void StringBuilderAppend::Builder::StoreData(ObjPtr<mirror::String> new_s
   for (uint32_t f = format_; f != 0u; f >>= kBitsPerArg) {
     DCHECK_LE(f & kArgMask, static_cast<uint32_t>(Argument::kLast));
     switch (static_cast<Argument>(f & kArgMask)) {
-      case Argument::kString: {
+      case Argument::kString:
+      case Argument::kFloat: {
         ObjPtr<mirror::String> str =
             ObjPtr<mirror::String>::DownCast(hs_.GetReference(handle_index));
         ++handle_index;
@@ -315,11 +391,19 @@ inline void StringBuilderAppend::Builder::StoreData(ObjPtr<mirror::String> new_s
         ++current_arg;  // Skip the low word, let the common code skip the high word.
         break;
       }
+      case Argument::kDouble: {
+        ObjPtr<mirror::String> str =
+            ObjPtr<mirror::String>::DownCast(hs_.GetReference(handle_index));
+        ++handle_index;
+        DCHECK(str != nullptr);
+        data = AppendString(new_string, data, str);
+        current_arg = AlignUp(current_arg, sizeof(int64_t));
+        ++current_arg;  // Skip the low word, let the common code skip the high word.
+        break;
+      }
 
       case Argument::kStringBuilder:
       case Argument::kCharArray:
-      case Argument::kFloat:
-      case Argument::kDouble:
         LOG(FATAL) << "Unimplemented arg format: 0x" << std::hex
             << (f & kArgMask) << " full format: 0x" << std::hex << format_;
         UNREACHABLE();
@@ -29,6 +29,7 @@
 #endif
 
 #include <algorithm>
+#include <array>
 #include <bitset>
 #include <cerrno>
 #include <iostream>
@@ -51,6 +52,7 @@
 #include "base/mutex.h"
 #include "base/stl_util.h"
 #include "base/systrace.h"
+#include "base/time_utils.h"
 #include "base/timing_logger.h"
 #include "base/to_str.h"
 #include "base/utils.h"
@@ -63,6 +65,7 @@
 #include "dex/dex_file_types.h"
 #include "entrypoints/entrypoint_utils.h"
 #include "entrypoints/quick/quick_alloc_entrypoints.h"
+#include "flight_recorder.h"
 #include "gc/accounting/card_table-inl.h"
 #include "gc/accounting/heap_bitmap-inl.h"
 #include "gc/allocator/rosalloc.h"
@@ -963,6 +966,7 @@ template <typename PeerAction>
 Thread* Thread::Attach(const char* thread_name, bool as_daemon, PeerAction peer_action) {
   Runtime* runtime = Runtime::Current();
   ScopedTrace trace("Thread::Attach");
+  const uint64_t attach_start_time = NanoTime();
   if (runtime == nullptr) {
     LOG(ERROR) << "Thread attaching to non-existent runtime: " <<
         ((thread_name != nullptr) ? thread_name : "(Unnamed)");
@@ -1015,6 +1019,7 @@ Thread* Thread::Attach(const char* thread_name, bool as_daemon, PeerAction peer_
     runtime->GetRuntimeCallbacks()->ThreadStart(self);
   }
 
+  runtime->GetThreadList()->RecordAttachTime(self, NanoTime() - attach_start_time);
   return self;
 }
 
@@ -1493,6 +1498,7 @@ bool Thread::PassActiveSuspendBarriers(Thread* self) {
     AtomicClearFlag(kActiveSuspendBarrier);
   }
 
+  suspend_barrier_pass_ns_.store(NanoTime(), std::memory_order_relaxed);
   uint32_t barrier_count = 0;
   for (uint32_t i = 0; i < kMaxSuspendBarriers; i++) {
     AtomicInteger* pending_threads = pass_barriers[i];
@@ -2445,6 +2451,11 @@ void Thread::Destroy() {
       Runtime::Current()->GetHeap()->ConcurrentCopyingCollector()->RevokeThreadLocalMarkStack(this);
     }
   }
+
+  FlightRecorder* flight_recorder = Runtime::Current()->GetFlightRecorder();
+  if (flight_recorder != nullptr) {
+    flight_recorder->ReleaseRing(this);
+  }
 }
 
 Thread::~Thread() {
@@ -2453,7 +2464,7 @@ Thread::~Thread() {
   CHECK(tlsPtr_.opeer == nullptr);
   bool initialized = (tlsPtr_.jni_env != nullptr);  // Did Thread::Init run?
   if (initialized) {
-    delete tlsPtr_.jni_env;
+    JNIEnvExt::Destroy(tlsPtr_.jni_env);
     tlsPtr_.jni_env = nullptr;
   }
   CHECK_NE(GetState(), kRunnable);
@@ -2651,16 +2662,19 @@ void Thread::SetClassLoaderOverride(jobject class_loader_override) {
 
 using ArtMethodDexPcPair = std::pair<ArtMethod*, uint32_t>;
 
-// Counts the stack trace depth and also fetches the first max_saved_frames frames.
+// Counts the stack trace depth and also fetches the first max_saved_frames frames. Stops after
+// max_depth frames if it is not 0.
 class FetchStackTraceVisitor : public StackVisitor {
  public:
   explicit FetchStackTraceVisitor(Thread* thread,
                                   ArtMethodDexPcPair* saved_frames = nullptr,
-                                  size_t max_saved_frames = 0)
+                                  size_t max_saved_frames = 0,
+                                  uint32_t max_depth = 0)
       REQUIRES_SHARED(Locks::mutator_lock_)
       : StackVisitor(thread, nullptr, StackVisitor::StackWalkKind::kIncludeInlinedFrames),
         saved_frames_(saved_frames),
-        max_saved_frames_(max_saved_frames) {}
+        max_saved_frames_(max_saved_frames),
+        max_depth_(max_depth) {}
 
   bool VisitFrame() override REQUIRES_SHARED(Locks::mutator_lock_) {
     // We want to skip frames up to and including the exception's constructor.
@@ -2678,6 +2692,9 @@ class FetchStackTraceVisitor : public StackVisitor {
           saved_frames_[depth_].second = m->IsProxyMethod() ? dex::kDexNoIndex : GetDexPc();
         }
         ++depth_;
+        if (depth_ == max_depth_) {
+          return false;
+        }
       }
     } else {
       ++skip_depth_;
@@ -2699,6 +2716,7 @@ class FetchStackTraceVisitor : public StackVisitor {
   bool skipping_ = true;
   ArtMethodDexPcPair* saved_frames_;
   const size_t max_saved_frames_;
+  const uint32_t max_depth_;
 
   DISALLOW_COPY_AND_ASSIGN(FetchStackTraceVisitor);
 };
@@ -2763,7 +2781,8 @@ class BuildInternalStackTraceVisitor : public StackVisitor {
       return true;  // Ignore runtime frames (in particular callee save).
     }
     AddFrame(m, m->IsProxyMethod() ? dex::kDexNoIndex : GetDexPc());
-    return true;
+    // Stop once the trace is full, it is shorter than the stack with -XX:MaxJavaStackTraceDepth.
+    return count_ != static_cast<uint32_t>(GetTraceMethodsAndPCs()->GetLength() / 2);
   }
 
   void AddFrame(ArtMethod* method, uint32_t dex_pc) REQUIRES_SHARED(Locks::mutator_lock_) {
@@ -2808,10 +2827,14 @@ template<bool kTransactionActive>
 jobject Thread::CreateInternalStackTrace(const ScopedObjectAccessAlreadyRunnable& soa) const {
   // Compute depth of stack, save frames if possible to avoid needing to recompute many.
   constexpr size_t kMaxSavedFrames = 256;
-  std::unique_ptr<ArtMethodDexPcPair[]> saved_frames(new ArtMethodDexPcPair[kMaxSavedFrames]);
+  std::unique_ptr<ArtMethodDexPcPair[]> saved_frames = soa.Self()->TakeStackTraceFrames();
+  if (saved_frames == nullptr) {
+    saved_frames.reset(new ArtMethodDexPcPair[kMaxSavedFrames]);
+  }
   FetchStackTraceVisitor count_visitor(const_cast<Thread*>(this),
                                        &saved_frames[0],
-                                       kMaxSavedFrames);
+                                       kMaxSavedFrames,
+                                       Runtime::Current()->GetMaxJavaStackTraceDepth());
   count_visitor.WalkStack();
   const uint32_t depth = count_visitor.GetDepth();
   const uint32_t skip_depth = count_visitor.GetSkipDepth();
@@ -2825,13 +2848,14 @@ jobject Thread::CreateInternalStackTrace(const ScopedObjectAccessAlreadyRunnable
   }
   // If we saved all of the frames we don't even need to do the actual stack walk. This is faster
   // than doing the stack walk twice.
-  if (depth < kMaxSavedFrames) {
+  if (depth <= kMaxSavedFrames) {
     for (size_t i = 0; i < depth; ++i) {
       build_trace_visitor.AddFrame(saved_frames[i].first, saved_frames[i].second);
     }
   } else {
     build_trace_visitor.WalkStack();
   }
+  soa.Self()->SetStackTraceFrames(std::move(saved_frames));
 
   mirror::ObjectArray<mirror::Object>* trace = build_trace_visitor.GetInternalStackTrace();
   if (kIsDebugBuild) {
@@ -3782,9 +3806,7 @@ class ReferenceMapVisitor : public StackVisitor {
       StackReference<mirror::Object>* vreg_base =
           reinterpret_cast<StackReference<mirror::Object>*>(cur_quick_frame);
       uintptr_t native_pc_offset = method_header->NativeQuickPcOffset(GetCurrentQuickFramePc());
-      CodeInfo code_info = kPrecise
-          ? CodeInfo(method_header)  // We will need dex register maps.
-          : CodeInfo::DecodeGcMasksOnly(method_header);
+      const CodeInfo& code_info = GetCodeInfo(method_header);
       StackMap map = code_info.GetStackMapForNativePcOffset(native_pc_offset);
       DCHECK(map.IsValid());
 
@@ -3942,8 +3964,31 @@ class ReferenceMapVisitor : public StackVisitor {
     VisitQuickFrameWithVregCallback<StackMapVRegInfo>();
   }
 
+  // Return the decoded CodeInfo of the method header. Deep stacks tend to contain the same
+  // methods many times (recursion, framework dispatch loops), so remember the last few decoded
+  // headers instead of decoding the bit table headers again for every frame.
+  const CodeInfo& GetCodeInfo(const OatQuickMethodHeader* method_header)
+      REQUIRES_SHARED(Locks::mutator_lock_) {
+    // Skip the low bits of the address, they are mostly zero because of code alignment.
+    size_t index = (reinterpret_cast<uintptr_t>(method_header) >> 4) % kCodeInfoCacheSize;
+    std::pair<const OatQuickMethodHeader*, CodeInfo>& entry = code_info_cache_[index];
+    if (entry.first != method_header) {
+      entry.first = method_header;
+      entry.second = kPrecise
+          ? CodeInfo(method_header)  // We will need dex register maps.
+          : CodeInfo::DecodeGcMasksOnly(method_header);
+    }
+    return entry.second;
+  }
+
   // Visitor for when we visit a root.
   RootVisitor& visitor_;
+
+  // Small direct-mapped cache of decoded CodeInfos, keyed by method header. Compiled code
+  // cannot be freed while we walk the stack, so the headers remain valid.
+  static constexpr size_t kCodeInfoCacheSize = 8;
+  std::array<std::pair<const OatQuickMethodHeader*, CodeInfo>, kCodeInfoCacheSize>
+      code_info_cache_;
 };
 
 class RootCallbackVisitor {
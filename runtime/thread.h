@@ -87,6 +87,7 @@ class Context;
 struct DebugInvokeReq;
 class DeoptimizationContextRecord;
 class DexFile;
+class FlightRecorderRing;
 class FrameIdToShadowFrame;
 class JavaVMExt;
 class JNIEnvExt;
@@ -679,6 +680,13 @@ class Thread {
         OFFSETOF_MEMBER(tls_32bit_sized_values, is_gc_marking));
   }
 
+  template<PointerSize pointer_size>
+  static constexpr ThreadOffset<pointer_size> WeakRefAccessEnabledOffset() {
+    return ThreadOffset<pointer_size>(
+        OFFSETOF_MEMBER(Thread, tls32_) +
+        OFFSETOF_MEMBER(tls_32bit_sized_values, weak_ref_access_enabled));
+  }
+
   static constexpr size_t IsGcMarkingSize() {
     return sizeof(tls32_.is_gc_marking);
   }
@@ -1123,6 +1131,67 @@ class Thread {
   // Doesn't check that there is room.
   mirror::Object* AllocTlab(size_t bytes);
   void SetTlab(uint8_t* start, uint8_t* end, uint8_t* limit);
+
+  // State of the adaptive TLAB sizing, maintained by the heap when the thread refills its TLAB.
+  struct TlabSizingInfo {
+    // Size of the last TLAB handed out, not including the allocation that caused the refill.
+    size_t size = 0;
+    // Number of TLAB refills so far.
+    uint64_t refill_count = 0;
+    // Time of the last refill.
+    uint64_t last_refill_time_ns = 0;
+    // Number of completed GCs at the last refill.
+    uint32_t gc_count_at_last_refill = 0;
+  };
+  TlabSizingInfo* GetTlabSizingInfo() {
+    return &tlab_sizing_info_;
+  }
+  // Bytes still to be handed out in TLAB refills before the next allocation sample is taken,
+  // 0 if no sampling interval has been drawn yet. See gc::AllocationSampler.
+  size_t* GetBytesUntilAllocationSample() {
+    return &bytes_until_allocation_sample_;
+  }
+
+  // The ring this thread records its FlightRecorder events in, null until its first event.
+  FlightRecorderRing* GetFlightRecorderRing() const {
+    return flight_recorder_ring_;
+  }
+  void SetFlightRecorderRing(FlightRecorderRing* ring) {
+    flight_recorder_ring_ = ring;
+  }
+
+  // The buffer CreateInternalStackTrace fetches frames into, kept between calls so that throwing
+  // does not allocate it every time. Ownership is taken during the call, so that nested calls
+  // get a buffer of their own.
+  std::unique_ptr<std::pair<ArtMethod*, uint32_t>[]> TakeStackTraceFrames() {
+    return std::move(stack_trace_frames_);
+  }
+  void SetStackTraceFrames(std::unique_ptr<std::pair<ArtMethod*, uint32_t>[]> frames) {
+    stack_trace_frames_ = std::move(frames);
+  }
+
+  // Nesting depth of ScopedCHABatch on this thread.
+  uint32_t GetCHABatchDepth() const {
+    return cha_batch_depth_;
+  }
+  void SetCHABatchDepth(uint32_t depth) {
+    cha_batch_depth_ = depth;
+  }
+
+  // The LinearAlloc chunk this thread bump allocates from, see LinearAlloc::Alloc.
+  struct LinearAllocChunk {
+    uint64_t owner_id = 0u;
+    uint8_t* pos = nullptr;
+    uint8_t* end = nullptr;
+  };
+  LinearAllocChunk* GetLinearAllocChunk() {
+    return &linear_alloc_chunk_;
+  }
+
+  // When this thread last passed a suspend barrier, read by ThreadList::SuspendAll.
+  uint64_t GetSuspendBarrierPassTime() const {
+    return suspend_barrier_pass_ns_.load(std::memory_order_relaxed);
+  }
   bool HasTlab() const;
   uint8_t* GetTlabStart() {
     return tlsPtr_.thread_local_start;
@@ -1824,6 +1893,27 @@ class Thread {
   // True if the thread is some form of runtime thread (ex, GC or JIT).
   bool is_runtime_thread_;
 
+  // Only updated by this thread itself, read racily when dumping the heap statistics.
+  TlabSizingInfo tlab_sizing_info_;
+
+  // Only accessed by this thread itself, on the TLAB refill slow path.
+  size_t bytes_until_allocation_sample_ = 0;
+
+  // Only accessed by this thread itself, owned by the FlightRecorder.
+  FlightRecorderRing* flight_recorder_ring_ = nullptr;
+
+  // Written by this thread in PassActiveSuspendBarriers.
+  Atomic<uint64_t> suspend_barrier_pass_ns_{0u};
+
+  // Only accessed by this thread itself, see TakeStackTraceFrames.
+  std::unique_ptr<std::pair<ArtMethod*, uint32_t>[]> stack_trace_frames_;
+
+  // Only accessed by this thread itself, see ScopedCHABatch.
+  uint32_t cha_batch_depth_ = 0u;
+
+  // Only accessed by this thread itself, see LinearAlloc::AllocFromThreadChunk.
+  LinearAllocChunk linear_alloc_chunk_;
+
   friend class Dbg;  // For SetStateUnsafe.
   friend class gc::collector::SemiSpace;  // For getting stack traces.
   friend class Runtime;  // For CreatePeer.
@@ -20,6 +20,7 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <sstream>
 #include <vector>
 
@@ -28,6 +29,7 @@
 #include "nativehelper/scoped_local_ref.h"
 #include "nativehelper/scoped_utf_chars.h"
 
+#include "art_method.h"
 #include "base/aborting.h"
 #include "base/histogram-inl.h"
 #include "base/mutex-inl.h"
@@ -35,6 +37,7 @@
 #include "base/time_utils.h"
 #include "base/timing_logger.h"
 #include "debugger.h"
+#include "flight_recorder.h"
 #include "gc/collector/concurrent_copying.h"
 #include "gc/gc_pause_listener.h"
 #include "gc/heap.h"
@@ -46,6 +49,7 @@
 #include "native_stack_dump.h"
 #include "scoped_thread_state_change-inl.h"
 #include "thread.h"
+#include "thread_pool.h"
 #include "trace.h"
 #include "well_known_classes.h"
 
@@ -62,6 +66,11 @@ namespace art {
 using android::base::StringPrintf;
 
 static constexpr uint64_t kLongThreadSuspendThreshold = MsToNs(5);
+// Look up where the last thread to suspend was only for suspensions at least this long.
+static constexpr uint64_t kSafepointCulpritThreshold = MsToNs(1);
+// Number of safepoint culprits printed on SIGQUIT, and kept.
+static constexpr size_t kNumSafepointCulpritsToDump = 10;
+static constexpr size_t kMaxSafepointCulprits = 256;
 // Use 0 since we want to yield to prevent blocking for an unpredictable amount of time.
 static constexpr useconds_t kThreadSuspendInitialSleepUs = 0;
 static constexpr useconds_t kThreadSuspendMaxYieldUs = 3000;
@@ -71,11 +80,18 @@ static constexpr useconds_t kThreadSuspendMaxSleepUs = 5000;
 // some history.
 static constexpr bool kDumpUnattachedThreadNativeStackForSigQuit = true;
 
+// Minimum number of suspended threads for flipping their roots with the heap thread pool. Below
+// this, starting the workers costs more than it saves.
+static constexpr size_t kMinThreadsForParallelFlip = 16;
+
 ThreadList::ThreadList(uint64_t thread_suspend_timeout_ns)
     : suspend_all_count_(0),
       debug_suspend_all_count_(0),
       unregistering_count_(0),
       suspend_all_historam_("suspend all histogram", 16, 64),
+      time_to_safepoint_histogram_("time to safepoint histogram", 16, 64),
+      flip_thread_histogram_("thread flip histogram", 16, 64),
+      attach_thread_histogram_("thread attach histogram", 16, 64),
       long_suspend_(false),
       shut_down_(false),
       thread_suspend_timeout_ns_(thread_suspend_timeout_ns),
@@ -151,6 +167,37 @@ void ThreadList::DumpForSigQuit(std::ostream& os) {
       suspend_all_historam_.CreateHistogram(&data);
       suspend_all_historam_.PrintConfidenceIntervals(os, 0.99, data);  // Dump time to suspend.
     }
+    if (time_to_safepoint_histogram_.SampleSize() > 0) {
+      Histogram<uint64_t>::CumulativeData data;
+      time_to_safepoint_histogram_.CreateHistogram(&data);
+      time_to_safepoint_histogram_.PrintConfidenceIntervals(os, 0.99, data);
+    }
+    if (!safepoint_culprits_.empty()) {
+      std::vector<std::pair<std::string, SafepointCulprit>> culprits(safepoint_culprits_.begin(),
+                                                                      safepoint_culprits_.end());
+      std::sort(culprits.begin(), culprits.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs.second.total_ns > rhs.second.total_ns;
+      });
+      os << "Threads holding up suspend all for over " << PrettyDuration(kSafepointCulpritThreshold)
+         << ", most total time first:\n";
+      for (size_t i = 0; i != std::min(culprits.size(), kNumSafepointCulpritsToDump); ++i) {
+        const SafepointCulprit& culprit = culprits[i].second;
+        os << "  " << culprits[i].first << ": count=" << culprit.count
+           << " total=" << PrettyDuration(culprit.total_ns)
+           << " max=" << PrettyDuration(culprit.max_ns) << "\n";
+      }
+    }
+    MutexLock mu(soa.Self(), *Locks::thread_list_lock_);
+    if (flip_thread_histogram_.SampleSize() > 0) {
+      Histogram<uint64_t>::CumulativeData data;
+      flip_thread_histogram_.CreateHistogram(&data);
+      flip_thread_histogram_.PrintConfidenceIntervals(os, 0.99, data);  // Dump time to flip.
+    }
+    if (attach_thread_histogram_.SampleSize() > 0) {
+      Histogram<uint64_t>::CumulativeData data;
+      attach_thread_histogram_.CreateHistogram(&data);
+      attach_thread_histogram_.PrintConfidenceIntervals(os, 0.99, data);  // Dump time to attach.
+    }
   }
   bool dump_native_stack = Runtime::Current()->GetDumpNativeStackOnSigQuit();
   Dump(os, dump_native_stack);
@@ -320,6 +367,12 @@ static void ThreadSuspendSleep(useconds_t delay_us) {
 }
 
 size_t ThreadList::RunCheckpoint(Closure* checkpoint_function, Closure* callback) {
+  return RunCheckpointOnThreads(checkpoint_function, [](Thread*) { return true; }, callback);
+}
+
+size_t ThreadList::RunCheckpointOnThreads(Closure* checkpoint_function,
+                                          const std::function<bool(Thread*)>& filter,
+                                          Closure* callback) {
   Thread* self = Thread::Current();
   Locks::mutator_lock_->AssertNotExclusiveHeld(self);
   Locks::thread_list_lock_->AssertNotHeld(self);
@@ -327,14 +380,20 @@ size_t ThreadList::RunCheckpoint(Closure* checkpoint_function, Closure* callback
 
   std::vector<Thread*> suspended_count_modified_threads;
   size_t count = 0;
+  bool run_on_self = false;
   {
     // Call a checkpoint function for each thread, threads which are suspend get their checkpoint
     // manually called.
     MutexLock mu(self, *Locks::thread_list_lock_);
     MutexLock mu2(self, *Locks::thread_suspend_count_lock_);
-    count = list_.size();
     for (const auto& thread : list_) {
-      if (thread != self) {
+      if (!filter(thread)) {
+        continue;
+      }
+      ++count;
+      if (thread == self) {
+        run_on_self = true;
+      } else {
         while (true) {
           if (thread->RequestCheckpoint(checkpoint_function)) {
             // This thread will run its checkpoint some time in the near future.
@@ -361,7 +420,9 @@ size_t ThreadList::RunCheckpoint(Closure* checkpoint_function, Closure* callback
   }
 
   // Run the checkpoint on ourself while we wait for threads to suspend.
-  checkpoint_function->Run(self);
+  if (run_on_self) {
+    checkpoint_function->Run(self);
+  }
 
   // Run the checkpoint on the suspended threads.
   for (const auto& thread : suspended_count_modified_threads) {
@@ -513,6 +574,49 @@ void ThreadList::RunEmptyCheckpoint() {
 // from-space to to-space refs. Used to synchronize threads at a point
 // to mark the initiation of marking while maintaining the to-space
 // invariant.
+void ThreadList::RecordAttachTime(Thread* self, uint64_t attach_time_ns) {
+  MutexLock mu(self, *Locks::thread_list_lock_);
+  attach_thread_histogram_.AdjustAndAddValue(attach_time_ns);
+}
+
+// Runs the flip function of `thread` unless somebody else already did, returns the time it took
+// or 0 if it did not run it.
+static uint64_t RunFlipFunction(Thread* thread) REQUIRES_SHARED(Locks::mutator_lock_) {
+  Closure* flip_func = thread->GetFlipFunction();
+  if (flip_func == nullptr) {
+    return 0u;
+  }
+  const uint64_t start_time = NanoTime();
+  flip_func->Run(thread);
+  return std::max<uint64_t>(NanoTime() - start_time, 1u);
+}
+
+// Flips a share of the suspended threads. Workers claim one thread at a time so that threads with
+// deep stacks do not hold back the others.
+class FlipThreadsTask : public Task {
+ public:
+  FlipThreadsTask(const std::vector<Thread*>* threads,
+                  Atomic<size_t>* next_thread,
+                  std::vector<uint64_t>* flip_times)
+      : threads_(threads), next_thread_(next_thread), flip_times_(flip_times) {}
+
+  void Run(Thread* self ATTRIBUTE_UNUSED) override REQUIRES_SHARED(Locks::mutator_lock_) {
+    size_t index;
+    while ((index = next_thread_->fetch_add(1, std::memory_order_relaxed)) < threads_->size()) {
+      (*flip_times_)[index] = RunFlipFunction((*threads_)[index]);
+    }
+  }
+
+  void Finalize() override {
+    delete this;
+  }
+
+ private:
+  const std::vector<Thread*>* const threads_;
+  Atomic<size_t>* const next_thread_;
+  std::vector<uint64_t>* const flip_times_;
+};
+
 size_t ThreadList::FlipThreadRoots(Closure* thread_flip_visitor,
                                    Closure* flip_callback,
                                    gc::collector::GarbageCollector* collector,
@@ -584,16 +688,41 @@ size_t ThreadList::FlipThreadRoots(Closure* thread_flip_visitor,
   {
     TimingLogger::ScopedTiming split3("FlipOtherThreads", collector->GetTimings());
     ReaderMutexLock mu(self, *Locks::mutator_lock_);
-    for (const auto& thread : other_threads) {
-      Closure* flip_func = thread->GetFlipFunction();
-      if (flip_func != nullptr) {
-        flip_func->Run(thread);
+    std::vector<uint64_t> flip_times(other_threads.size(), 0u);
+    ThreadPool* const thread_pool = collector->GetHeap()->GetThreadPool();
+    size_t thread_count = 1;
+    if (thread_pool != nullptr &&
+        other_threads.size() >= kMinThreadsForParallelFlip &&
+        Runtime::Current()->InJankPerceptibleProcessState()) {
+      thread_count = std::min(collector->GetHeap()->GetParallelGCThreadCount(),
+                              thread_pool->GetThreadCount()) + 1;
+    }
+    if (thread_count > 1) {
+      // The idle workers are suspended for the flip too. Flip them first so that their roots are
+      // not visited while they run the flip tasks.
+      for (ThreadPoolWorker* worker : thread_pool->GetWorkers()) {
+        RunFlipFunction(worker->GetThread());
+      }
+      Atomic<size_t> next_thread(0);
+      for (size_t i = 0; i < thread_count; ++i) {
+        thread_pool->AddTask(self, new FlipThreadsTask(&other_threads, &next_thread, &flip_times));
+      }
+      thread_pool->SetMaxActiveWorkers(thread_count - 1);
+      thread_pool->StartWorkers(self);
+      thread_pool->Wait(self, /* do_work= */ true, /* may_hold_locks= */ true);
+      thread_pool->StopWorkers(self);
+    } else {
+      for (size_t i = 0; i < other_threads.size(); ++i) {
+        flip_times[i] = RunFlipFunction(other_threads[i]);
       }
     }
     // Run it for self.
-    Closure* flip_func = self->GetFlipFunction();
-    if (flip_func != nullptr) {
-      flip_func->Run(self);
+    RunFlipFunction(self);
+    MutexLock mu2(self, *Locks::thread_list_lock_);
+    for (uint64_t flip_time : flip_times) {
+      if (flip_time != 0u) {
+        flip_thread_histogram_.AdjustAndAddValue(flip_time);
+      }
     }
   }
 
@@ -648,8 +777,25 @@ void ThreadList::SuspendAll(const char* cause, bool long_suspend) {
     const uint64_t end_time = NanoTime();
     const uint64_t suspend_time = end_time - start_time;
     suspend_all_historam_.AdjustAndAddValue(suspend_time);
+    Thread* slowest = RecordTimeToSafepoint(self, start_time);
     if (suspend_time > kLongThreadSuspendThreshold) {
-      LOG(WARNING) << "Suspending all threads took: " << PrettyDuration(suspend_time);
+      if (slowest != nullptr) {
+        LOG(WARNING) << "Suspending all threads took: " << PrettyDuration(suspend_time)
+                     << ", last to suspend after "
+                     << PrettyDuration(slowest->GetSuspendBarrierPassTime() - start_time)
+                     << ": " << *slowest;
+      } else {
+        LOG(WARNING) << "Suspending all threads took: " << PrettyDuration(suspend_time);
+      }
+    }
+    FlightRecorder* flight_recorder = Runtime::Current()->GetFlightRecorder();
+    if (flight_recorder != nullptr) {
+      flight_recorder->Record(self,
+                              FlightRecorder::EventType::kSuspendAll,
+                              start_time,
+                              suspend_time,
+                              /* arg= */ 0u,
+                              cause);
     }
 
     if (kDebugLocking) {
@@ -666,6 +812,53 @@ void ThreadList::SuspendAll(const char* cause, bool long_suspend) {
   }
 }
 
+Thread* ThreadList::RecordTimeToSafepoint(Thread* self, uint64_t request_time) {
+  Thread* slowest = nullptr;
+  uint64_t slowest_time = 0u;
+  {
+    MutexLock mu(self, *Locks::thread_list_lock_);
+    for (Thread* thread : list_) {
+      // Threads which were already suspended at the request did not pass the barrier.
+      uint64_t pass_time = thread->GetSuspendBarrierPassTime();
+      if (thread == self || pass_time < request_time) {
+        continue;
+      }
+      time_to_safepoint_histogram_.AdjustAndAddValue(pass_time - request_time);
+      if (pass_time - request_time >= slowest_time) {
+        slowest = thread;
+        slowest_time = pass_time - request_time;
+      }
+    }
+  }
+  if (slowest == nullptr || slowest_time < kSafepointCulpritThreshold) {
+    return slowest;
+  }
+  // The thread stopped where it first checked for suspension: a suspend check if it is now
+  // suspended, or its transition out of runnable, such as a JNI call, if it is now native.
+  uint32_t dex_pc = 0u;
+  ArtMethod* method = slowest->GetCurrentMethod(&dex_pc,
+                                                /* check_suspended= */ false,
+                                                /* abort_on_error= */ false);
+  std::ostringstream key;
+  key << slowest->GetState() << " ";
+  if (method != nullptr) {
+    key << method->PrettyMethod() << " dex_pc=" << dex_pc;
+  } else {
+    key << "<no managed frame>";
+  }
+  auto it = safepoint_culprits_.find(key.str());
+  if (it == safepoint_culprits_.end()) {
+    if (safepoint_culprits_.size() == kMaxSafepointCulprits) {
+      return slowest;
+    }
+    it = safepoint_culprits_.emplace(key.str(), SafepointCulprit{0u, 0u, 0u}).first;
+  }
+  ++it->second.count;
+  it->second.total_ns += slowest_time;
+  it->second.max_ns = std::max(it->second.max_ns, slowest_time);
+  return slowest;
+}
+
 // Ensures all threads running Java suspend and that those not running Java don't start.
 // Debugger thread might be set to kRunnable for a short period of time after the
 // SuspendAllInternal. This is safe because it will be set back to suspended state before
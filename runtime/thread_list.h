@@ -26,7 +26,10 @@
 #include "suspend_reason.h"
 
 #include <bitset>
+#include <functional>
 #include <list>
+#include <map>
+#include <string>
 #include <vector>
 
 namespace art {
@@ -110,6 +113,15 @@ class ThreadList {
   size_t RunCheckpoint(Closure* checkpoint_function, Closure* callback = nullptr)
       REQUIRES(!Locks::thread_list_lock_, !Locks::thread_suspend_count_lock_);
 
+  // Like RunCheckpoint, but only runs the checkpoint on the threads (including self) for which
+  // `filter` returns true, the others are neither interrupted nor suspended. The filter is called
+  // with the thread_list_lock_ and thread_suspend_count_lock_ held and must not take other locks.
+  // Returns how many checkpoints are expected to run.
+  size_t RunCheckpointOnThreads(Closure* checkpoint_function,
+                                const std::function<bool(Thread*)>& filter,
+                                Closure* callback = nullptr)
+      REQUIRES(!Locks::thread_list_lock_, !Locks::thread_suspend_count_lock_);
+
   // Run an empty checkpoint on threads. Wait until threads pass the next suspend point or are
   // suspended. This is used to ensure that the threads finish or aren't in the middle of an
   // in-flight mutator heap access (eg. a read barrier.) Runnable threads will respond by
@@ -118,6 +130,9 @@ class ThreadList {
   void RunEmptyCheckpoint()
       REQUIRES(!Locks::thread_list_lock_, !Locks::thread_suspend_count_lock_);
 
+  // Record the time Thread::Attach() took for `self`, dumped on SIGQUIT.
+  void RecordAttachTime(Thread* self, uint64_t attach_time_ns) REQUIRES(!Locks::thread_list_lock_);
+
   // Flip thread roots from from-space refs to to-space refs. Used by
   // the concurrent copying collector.
   size_t FlipThreadRoots(Closure* thread_flip_visitor,
@@ -201,6 +216,11 @@ class ThreadList {
                           SuspendReason reason = SuspendReason::kInternal)
       REQUIRES(!Locks::thread_list_lock_, !Locks::thread_suspend_count_lock_);
 
+  // Records how long each thread took to pass its suspend barrier since `request_time`, and
+  // where the slowest one was if it held up the suspension for long. Returns the slowest thread.
+  Thread* RecordTimeToSafepoint(Thread* self, uint64_t request_time)
+      REQUIRES(Locks::mutator_lock_, !Locks::thread_list_lock_);
+
   void AssertThreadsAreSuspended(Thread* self, Thread* ignore1, Thread* ignore2 = nullptr)
       REQUIRES(!Locks::thread_list_lock_, !Locks::thread_suspend_count_lock_);
 
@@ -220,6 +240,25 @@ class ThreadList {
   // by mutator lock ensures no thread can read when another thread is modifying it.
   Histogram<uint64_t> suspend_all_historam_ GUARDED_BY(Locks::mutator_lock_);
 
+  // Time from the SuspendAll request until each thread that was not already suspended passed its
+  // suspend barrier.
+  Histogram<uint64_t> time_to_safepoint_histogram_ GUARDED_BY(Locks::mutator_lock_);
+
+  // Where the last thread to reach the safepoint was, for the SuspendAll calls that took longer
+  // than kSafepointCulpritThreshold, keyed by its state, method and dex pc.
+  struct SafepointCulprit {
+    uint64_t count;
+    uint64_t total_ns;
+    uint64_t max_ns;
+  };
+  std::map<std::string, SafepointCulprit> safepoint_culprits_ GUARDED_BY(Locks::mutator_lock_);
+
+  // Time to flip the roots of each thread that was suspended during a thread flip.
+  Histogram<uint64_t> flip_thread_histogram_ GUARDED_BY(Locks::thread_list_lock_);
+
+  // Time to attach each thread that called Thread::Attach().
+  Histogram<uint64_t> attach_thread_histogram_ GUARDED_BY(Locks::thread_list_lock_);
+
   // Whether or not the current thread suspension is long.
   bool long_suspend_;
 
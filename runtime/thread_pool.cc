@@ -49,7 +49,8 @@ static constexpr bool kUseCustomThreadPoolStack = true;
 ThreadPoolWorker::ThreadPoolWorker(ThreadPool* thread_pool, const std::string& name,
                                    size_t stack_size)
     : thread_pool_(thread_pool),
-      name_(name) {
+      name_(name),
+      thread_(nullptr) {
   std::string error_msg;
   // On Bionic, we know pthreads will give us a big-enough stack with
   // a guard page, so don't do anything special on Bionic libc.
@@ -114,6 +115,86 @@ void ThreadPoolWorker::Run() {
   }
 }
 
+WorkStealingDeque::WorkStealingDeque(size_t capacity)
+    : top_(0),
+      bottom_(0),
+      mask_(static_cast<int64_t>(capacity) - 1),
+      buffer_(new Atomic<Task*>[capacity]) {
+  CHECK(IsPowerOfTwo(capacity)) << capacity;
+}
+
+bool WorkStealingDeque::Push(Task* task) {
+  const int64_t bottom = bottom_.load(std::memory_order_relaxed);
+  const int64_t top = top_.load(std::memory_order_acquire);
+  if (bottom - top > mask_) {
+    return false;
+  }
+  buffer_[bottom & mask_].store(task, std::memory_order_relaxed);
+  // Publish the task before the new bottom becomes visible to thieves.
+  bottom_.store(bottom + 1, std::memory_order_release);
+  return true;
+}
+
+Task* WorkStealingDeque::Pop() {
+  const int64_t bottom = bottom_.load(std::memory_order_relaxed) - 1;
+  bottom_.store(bottom, std::memory_order_relaxed);
+  // Order the bottom update before reading top, thieves do the reverse in Steal.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  int64_t top = top_.load(std::memory_order_relaxed);
+  if (top > bottom) {
+    // Empty.
+    bottom_.store(bottom + 1, std::memory_order_relaxed);
+    return nullptr;
+  }
+  Task* task = buffer_[bottom & mask_].load(std::memory_order_relaxed);
+  if (top == bottom) {
+    // Last task, race against thieves for it.
+    if (!top_.compare_exchange_strong(top,
+                                      top + 1,
+                                      std::memory_order_seq_cst,
+                                      std::memory_order_relaxed)) {
+      task = nullptr;
+    }
+    bottom_.store(bottom + 1, std::memory_order_relaxed);
+  }
+  return task;
+}
+
+Task* WorkStealingDeque::Steal() {
+  int64_t top = top_.load(std::memory_order_acquire);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  const int64_t bottom = bottom_.load(std::memory_order_acquire);
+  if (top >= bottom) {
+    return nullptr;
+  }
+  Task* task = buffer_[top & mask_].load(std::memory_order_relaxed);
+  if (!top_.compare_exchange_strong(top,
+                                    top + 1,
+                                    std::memory_order_seq_cst,
+                                    std::memory_order_relaxed)) {
+    return nullptr;
+  }
+  return task;
+}
+
+WorkStealingWorker::WorkStealingWorker(ThreadPool* thread_pool,
+                                       const std::string& name,
+                                       size_t stack_size,
+                                       size_t index)
+    : ThreadPoolWorker(thread_pool, name, stack_size),
+      index_(index),
+      deque_(kDequeCapacity) {}
+
+void WorkStealingWorker::Run() {
+  Thread* self = Thread::Current();
+  Task* task = nullptr;
+  thread_pool_->creation_barier_.Pass(self);
+  while ((task = thread_pool_->GetWorkStealingTask(self, this)) != nullptr) {
+    task->Run(self);
+    task->Finalize();
+  }
+}
+
 void* ThreadPoolWorker::Callback(void* arg) {
   ThreadPoolWorker* worker = reinterpret_cast<ThreadPoolWorker*>(arg);
   Runtime* runtime = Runtime::Current();
@@ -131,6 +212,22 @@ void* ThreadPoolWorker::Callback(void* arg) {
 }
 
 void ThreadPool::AddTask(Thread* self, Task* task) {
+  if (work_stealing_) {
+    WorkStealingWorker* worker = FindWorkStealingWorker(self);
+    if (worker != nullptr && worker->deque_.Push(task)) {
+      // Pairs with the fence in GetWorkStealingTask: either a worker going idle sees the new task,
+      // or we see that worker and wake it up.
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if (idle_workers_.load(std::memory_order_relaxed) != 0) {
+        MutexLock mu(self, task_queue_lock_);
+        if (started_) {
+          task_queue_condition_.Signal(self);
+        }
+      }
+      return;
+    }
+    // Not a worker of this pool, or its deque is full. Use the shared queue.
+  }
   MutexLock mu(self, task_queue_lock_);
   tasks_.push_back(task);
   // If we have any waiters, signal one.
@@ -140,6 +237,12 @@ void ThreadPool::AddTask(Thread* self, Task* task) {
 }
 
 void ThreadPool::RemoveAllTasks(Thread* self) {
+  if (work_stealing_) {
+    for (ThreadPoolWorker* worker : threads_) {
+      WorkStealingDeque* deque = &down_cast<WorkStealingWorker*>(worker)->deque_;
+      while (deque->Steal() != nullptr) {}
+    }
+  }
   MutexLock mu(self, task_queue_lock_);
   tasks_.clear();
 }
@@ -147,7 +250,8 @@ void ThreadPool::RemoveAllTasks(Thread* self) {
 ThreadPool::ThreadPool(const char* name,
                        size_t num_threads,
                        bool create_peers,
-                       size_t worker_stack_size)
+                       size_t worker_stack_size,
+                       bool work_stealing)
   : name_(name),
     task_queue_lock_("task queue lock"),
     task_queue_condition_("task queue condition", task_queue_lock_),
@@ -160,7 +264,9 @@ ThreadPool::ThreadPool(const char* name,
     creation_barier_(0),
     max_active_workers_(num_threads),
     create_peers_(create_peers),
-    worker_stack_size_(worker_stack_size) {
+    worker_stack_size_(worker_stack_size),
+    work_stealing_(work_stealing),
+    idle_workers_(0u) {
   CreateThreads();
 }
 
@@ -175,8 +281,13 @@ void ThreadPool::CreateThreads() {
     while (GetThreadCount() < max_active_workers_) {
       const std::string worker_name = StringPrintf("%s worker thread %zu", name_.c_str(),
                                                    GetThreadCount());
-      threads_.push_back(
-          new ThreadPoolWorker(this, worker_name, worker_stack_size_));
+      if (work_stealing_) {
+        threads_.push_back(
+            new WorkStealingWorker(this, worker_name, worker_stack_size_, GetThreadCount()));
+      } else {
+        threads_.push_back(
+            new ThreadPoolWorker(this, worker_name, worker_stack_size_));
+      }
     }
   }
 }
@@ -262,6 +373,83 @@ Task* ThreadPool::GetTask(Thread* self) {
   return nullptr;
 }
 
+Task* ThreadPool::GetWorkStealingTask(Thread* self, WorkStealingWorker* worker) {
+  DCHECK(work_stealing_);
+  // Tasks added by this worker come first, they are the most likely to be cache-hot.
+  Task* task = worker->deque_.Pop();
+  if (task != nullptr) {
+    return task;
+  }
+  MutexLock mu(self, task_queue_lock_);
+  while (!IsShuttingDown()) {
+    const size_t thread_count = GetThreadCount();
+    // Ensure that we don't use more threads than the maximum active workers.
+    const size_t active_threads = thread_count - waiting_count_;
+    // <= since self is considered an active worker.
+    if (active_threads <= max_active_workers_) {
+      task = TryGetTaskLocked();
+      if (task == nullptr && started_) {
+        task = StealTask(worker);
+      }
+      if (task != nullptr) {
+        return task;
+      }
+    }
+
+    ++waiting_count_;
+    idle_workers_.fetch_add(1u, std::memory_order_relaxed);
+    // Pairs with the fence in AddTask, see there.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    task = (started_ && active_threads <= max_active_workers_) ? StealTask(worker) : nullptr;
+    if (task != nullptr) {
+      idle_workers_.fetch_sub(1u, std::memory_order_relaxed);
+      --waiting_count_;
+      return task;
+    }
+    // Our own deque is empty, so if everybody is waiting there is no task left in any deque.
+    if (waiting_count_ == GetThreadCount() && !HasOutstandingTasks()) {
+      // We may be done, lets broadcast to the completion condition.
+      completion_condition_.Broadcast(self);
+    }
+    const uint64_t wait_start = kMeasureWaitTime ? NanoTime() : 0;
+    task_queue_condition_.Wait(self);
+    if (kMeasureWaitTime) {
+      const uint64_t wait_end = NanoTime();
+      total_wait_time_ += wait_end - std::max(wait_start, start_time_);
+    }
+    idle_workers_.fetch_sub(1u, std::memory_order_relaxed);
+    --waiting_count_;
+  }
+
+  // We are shutting down, return null to tell the worker thread to stop looping.
+  return nullptr;
+}
+
+Task* ThreadPool::StealTask(WorkStealingWorker* thief) {
+  const size_t thread_count = GetThreadCount();
+  // Start with the next worker so that thieves spread out over the victims.
+  for (size_t i = 1; i < thread_count; ++i) {
+    ThreadPoolWorker* victim = threads_[(thief->index_ + i) % thread_count];
+    Task* task = down_cast<WorkStealingWorker*>(victim)->deque_.Steal();
+    if (task != nullptr) {
+      return task;
+    }
+  }
+  return nullptr;
+}
+
+WorkStealingWorker* ThreadPool::FindWorkStealingWorker(Thread* self) {
+  DCHECK(work_stealing_);
+  // This is only used to find out whether `self` is one of our workers, and a worker publishes its
+  // thread before running any task.
+  for (ThreadPoolWorker* worker : threads_) {
+    if (worker->thread_ == self) {
+      return down_cast<WorkStealingWorker*>(worker);
+    }
+  }
+  return nullptr;
+}
+
 Task* ThreadPool::TryGetTask(Thread* self) {
   MutexLock mu(self, task_queue_lock_);
   return TryGetTaskLocked();
@@ -19,9 +19,11 @@
 
 #include <deque>
 #include <functional>
+#include <memory>
 #include <vector>
 
 #include "barrier.h"
+#include "base/atomic.h"
 #include "base/mem_map.h"
 #include "base/mutex.h"
 
@@ -107,6 +109,54 @@ class ThreadPoolWorker {
   DISALLOW_COPY_AND_ASSIGN(ThreadPoolWorker);
 };
 
+// A fixed-capacity Chase-Lev deque. The owning worker pushes and pops tasks at the bottom without
+// taking a lock, other workers steal tasks from the top with a CAS.
+class WorkStealingDeque {
+ public:
+  // `capacity` must be a power of two.
+  explicit WorkStealingDeque(size_t capacity);
+
+  // Owner only. Returns false if the deque is full.
+  bool Push(Task* task);
+
+  // Owner only. Returns null if the deque is empty.
+  Task* Pop();
+
+  // Any thread. Returns null if the deque is empty or if another thread won the race for the top
+  // task.
+  Task* Steal();
+
+ private:
+  Atomic<int64_t> top_;
+  Atomic<int64_t> bottom_;
+  const int64_t mask_;
+  std::unique_ptr<Atomic<Task*>[]> buffer_;
+
+  DISALLOW_COPY_AND_ASSIGN(WorkStealingDeque);
+};
+
+// A worker of a work-stealing thread pool. Tasks added from a task running on this worker go to
+// its own deque, and the worker steals from the other workers when it runs out of tasks.
+class WorkStealingWorker : public ThreadPoolWorker {
+ public:
+  static constexpr size_t kDequeCapacity = 1024;
+
+ protected:
+  WorkStealingWorker(ThreadPool* thread_pool,
+                     const std::string& name,
+                     size_t stack_size,
+                     size_t index);
+  void Run() override;
+
+ private:
+  // Index of the worker in the pool, used to spread the steal attempts over the other workers.
+  const size_t index_;
+  WorkStealingDeque deque_;
+
+  friend class ThreadPool;
+  DISALLOW_COPY_AND_ASSIGN(WorkStealingWorker);
+};
+
 // Note that thread pool workers will set Thread#setCanCallIntoJava to false.
 class ThreadPool {
  public:
@@ -124,7 +174,8 @@ class ThreadPool {
   void StopWorkers(Thread* self) REQUIRES(!task_queue_lock_);
 
   // Add a new task, the first available started worker will process it. Does not delete the task
-  // after running it, it is the caller's responsibility.
+  // after running it, it is the caller's responsibility. In a work-stealing pool, a task added by
+  // a worker of the pool goes to that worker's deque without taking `task_queue_lock_`.
   void AddTask(Thread* self, Task* task) REQUIRES(!task_queue_lock_);
 
   // Remove all tasks in the queue.
@@ -135,10 +186,14 @@ class ThreadPool {
   // If create_peers is true, all worker threads will have a Java peer object. Note that if the
   // pool is asked to do work on the current thread (see Wait), a peer may not be available. Wait
   // will conservatively abort if create_peers and do_work are true.
+  //
+  // If work_stealing is true, the workers are WorkStealingWorkers. This helps pools whose tasks
+  // add many fine-grained tasks themselves, as these no longer go through the shared queue.
   ThreadPool(const char* name,
              size_t num_threads,
              bool create_peers = false,
-             size_t worker_stack_size = ThreadPoolWorker::kDefaultStackSize);
+             size_t worker_stack_size = ThreadPoolWorker::kDefaultStackSize,
+             bool work_stealing = false);
   virtual ~ThreadPool();
 
   // Create the threads of this pool.
@@ -179,7 +234,18 @@ class ThreadPool {
 
   // Try to get a task, returning null if there is none available.
   Task* TryGetTask(Thread* self) REQUIRES(!task_queue_lock_);
-  Task* TryGetTaskLocked() REQUIRES(task_queue_lock_);
+  virtual Task* TryGetTaskLocked() REQUIRES(task_queue_lock_);
+
+  // Get a task for `worker` of a work-stealing pool: from its own deque first, then from the
+  // shared queue or the other workers' deques. Blocks if there are no tasks left.
+  Task* GetWorkStealingTask(Thread* self, WorkStealingWorker* worker)
+      REQUIRES(!task_queue_lock_);
+
+  // Try to steal a task from the deque of a worker other than `thief`.
+  Task* StealTask(WorkStealingWorker* thief);
+
+  // Returns the worker of this work-stealing pool running on `self`, or null.
+  WorkStealingWorker* FindWorkStealingWorker(Thread* self);
 
   // Are we shutting down?
   bool IsShuttingDown() const REQUIRES(task_queue_lock_) {
@@ -207,6 +273,10 @@ class ThreadPool {
   size_t max_active_workers_ GUARDED_BY(task_queue_lock_);
   const bool create_peers_;
   const size_t worker_stack_size_;
+  const bool work_stealing_;
+  // Number of work-stealing workers about to, or already, waiting on `task_queue_condition_`.
+  // Lets AddTask skip the lock when there is nobody to wake up.
+  Atomic<size_t> idle_workers_;
 
  private:
   friend class ThreadPoolWorker;
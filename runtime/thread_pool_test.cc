@@ -16,7 +16,9 @@
 
 #include "thread_pool.h"
 
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "base/atomic.h"
 #include "common_runtime_test.h"
@@ -160,6 +162,46 @@ TEST_F(ThreadPoolTest, RecursiveTest) {
   EXPECT_EQ((1 << depth) - 1, count.load(std::memory_order_seq_cst));
 }
 
+// Test that a work-stealing pool runs all tasks added from within tasks, which go to the
+// adding worker's deque rather than to the shared queue.
+TEST_F(ThreadPoolTest, WorkStealingRecursiveTest) {
+  Thread* self = Thread::Current();
+  ThreadPool thread_pool("Thread pool test thread pool",
+                         num_threads,
+                         /* create_peers= */ false,
+                         ThreadPoolWorker::kDefaultStackSize,
+                         /* work_stealing= */ true);
+  AtomicInteger count(0);
+  static const int depth = 12;
+  thread_pool.AddTask(self, new TreeTask(&thread_pool, &count, depth));
+  thread_pool.StartWorkers(self);
+  thread_pool.Wait(self, true, false);
+  EXPECT_EQ((1 << depth) - 1, count.load(std::memory_order_seq_cst));
+}
+
+TEST_F(ThreadPoolTest, WorkStealingDeque) {
+  WorkStealingDeque deque(4);
+  std::vector<std::unique_ptr<CountTask>> tasks;
+  AtomicInteger count(0);
+  for (size_t i = 0; i < 5; ++i) {
+    tasks.emplace_back(new CountTask(&count));
+  }
+  EXPECT_EQ(nullptr, deque.Pop());
+  EXPECT_EQ(nullptr, deque.Steal());
+  for (size_t i = 0; i < 4; ++i) {
+    EXPECT_TRUE(deque.Push(tasks[i].get()));
+  }
+  // Full.
+  EXPECT_FALSE(deque.Push(tasks[4].get()));
+  // The owner pops the most recently pushed task, thieves take the oldest one.
+  EXPECT_EQ(tasks[3].get(), deque.Pop());
+  EXPECT_EQ(tasks[0].get(), deque.Steal());
+  EXPECT_EQ(tasks[1].get(), deque.Steal());
+  EXPECT_EQ(tasks[2].get(), deque.Pop());
+  EXPECT_EQ(nullptr, deque.Pop());
+  EXPECT_EQ(nullptr, deque.Steal());
+}
+
 class PeerTask : public Task {
  public:
   PeerTask() {}
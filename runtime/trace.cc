@@ -22,6 +22,7 @@
 #include "android-base/stringprintf.h"
 
 #include "art_method-inl.h"
+#include "barrier.h"
 #include "base/casts.h"
 #include "base/enums.h"
 #include "base/os.h"
@@ -72,7 +73,7 @@ TraceClockSource Trace::default_clock_source_ = kDefaultTraceClockSource;
 
 Trace* volatile Trace::the_trace_ = nullptr;
 pthread_t Trace::sampling_pthread_ = 0U;
-std::unique_ptr<std::vector<ArtMethod*>> Trace::temp_stack_trace_;
+Atomic<std::vector<ArtMethod*>*> Trace::temp_stack_trace_(nullptr);
 
 // The key identifying the tracer to update instrumentation.
 static constexpr const char* kTracerInstrumentationKey = "Tracer";
@@ -109,13 +110,13 @@ uint32_t Trace::EncodeTraceMethodAndAction(ArtMethod* method, TraceAction action
 }
 
 std::vector<ArtMethod*>* Trace::AllocStackTrace() {
-  return (temp_stack_trace_.get() != nullptr)  ? temp_stack_trace_.release() :
-      new std::vector<ArtMethod*>();
+  std::vector<ArtMethod*>* stack_trace = temp_stack_trace_.exchange(nullptr);
+  return (stack_trace != nullptr) ? stack_trace : new std::vector<ArtMethod*>();
 }
 
 void Trace::FreeStackTrace(std::vector<ArtMethod*>* stack_trace) {
   stack_trace->clear();
-  temp_stack_trace_.reset(stack_trace);
+  delete temp_stack_trace_.exchange(stack_trace);
 }
 
 void Trace::SetDefaultClockSource(TraceClockSource clock_source) {
@@ -203,7 +204,7 @@ static void Append8LE(uint8_t* buf, uint64_t val) {
   *buf++ = static_cast<uint8_t>(val >> 56);
 }
 
-static void GetSample(Thread* thread, void* arg) REQUIRES_SHARED(Locks::mutator_lock_) {
+static void GetSample(Thread* thread, Trace* the_trace) REQUIRES_SHARED(Locks::mutator_lock_) {
   std::vector<ArtMethod*>* const stack_trace = Trace::AllocStackTrace();
   StackVisitor::WalkStack(
       [&](const art::StackVisitor* stack_visitor) REQUIRES_SHARED(Locks::mutator_lock_) {
@@ -217,10 +218,31 @@ static void GetSample(Thread* thread, void* arg) REQUIRES_SHARED(Locks::mutator_
       thread,
       /* context= */ nullptr,
       art::StackVisitor::StackWalkKind::kIncludeInlinedFrames);
-  Trace* the_trace = reinterpret_cast<Trace*>(arg);
   the_trace->CompareAndUpdateStackTrace(thread, stack_trace);
 }
 
+// Samples the stack of each thread as it passes its next suspend point, so that taking a sample
+// does not stop the world. Threads that are already suspended are sampled by the sampling thread.
+class SampleCheckpoint final : public Closure {
+ public:
+  SampleCheckpoint(Trace* the_trace, Barrier* barrier) : the_trace_(the_trace), barrier_(barrier) {}
+
+  void Run(Thread* thread) override {
+    // Note thread and self may not be equal if thread was already suspended at the point of the
+    // request.
+    Thread* self = Thread::Current();
+    {
+      ScopedObjectAccess soa(self);
+      GetSample(thread, the_trace_);
+    }
+    barrier_->Pass(self);
+  }
+
+ private:
+  Trace* const the_trace_;
+  Barrier* const barrier_;
+};
+
 static void ClearThreadStackTraceAndClockBase(Thread* thread, void* arg ATTRIBUTE_UNUSED) {
   thread->SetTraceClockBase(0);
   std::vector<ArtMethod*>* stack_trace = thread->GetStackTraceSample();
@@ -230,7 +252,7 @@ static void ClearThreadStackTraceAndClockBase(Thread* thread, void* arg ATTRIBUT
 
 void Trace::CompareAndUpdateStackTrace(Thread* thread,
                                        std::vector<ArtMethod*>* stack_trace) {
-  CHECK_EQ(pthread_self(), sampling_pthread_);
+  DCHECK(thread == Thread::Current() || thread->IsSuspended());
   std::vector<ArtMethod*>* old_stack_trace = thread->GetStackTraceSample();
   // Update the thread's stack trace sample.
   thread->SetStackTraceSample(stack_trace);
@@ -295,9 +317,17 @@ void* Trace::RunSamplingThread(void* arg) {
       gc::ScopedGCCriticalSection gcs(self,
                                       art::gc::kGcCauseInstrumentation,
                                       art::gc::kCollectorTypeInstrumentation);
-      ScopedSuspendAll ssa(__FUNCTION__);
-      MutexLock mu(self, *Locks::thread_list_lock_);
-      runtime->GetThreadList()->ForEach(GetSample, the_trace);
+      Barrier barrier(0);
+      SampleCheckpoint closure(the_trace, &barrier);
+      // The sampling thread has no managed frames worth sampling.
+      size_t threads_running_checkpoint = runtime->GetThreadList()->RunCheckpointOnThreads(
+          &closure, [self](Thread* thread) { return thread != self; });
+      // Wait for the runnable threads to take their samples; `the_trace` must stay valid until
+      // they have. StopTracing() joins this thread before deleting it.
+      ScopedThreadStateChange tsc(self, kWaitingForCheckPointsToRun);
+      if (threads_running_checkpoint != 0) {
+        barrier.Increment(self, threads_running_checkpoint);
+      }
     }
   }
 
@@ -876,9 +906,9 @@ void Trace::LogMethodTraceEvent(Thread* thread, ArtMethod* method,
                                 instrumentation::Instrumentation::InstrumentationEvent event,
                                 uint32_t thread_clock_diff, uint32_t wall_clock_diff) {
   // This method is called in both tracing modes (method and
-  // sampling). In sampling mode, this method is only called by the
-  // sampling thread. In method tracing mode, it can be called
-  // concurrently.
+  // sampling). In both modes it can be called concurrently: in
+  // sampling mode each thread logs the events of its own samples
+  // from a checkpoint.
 
   // Ensure we always use the non-obsolete version of the method so that entry/exit events have the
   // same pointer value.
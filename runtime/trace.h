@@ -171,6 +171,7 @@ class Trace final : public instrumentation::InstrumentationListener {
   void MeasureClockOverhead();
   uint32_t GetClockOverheadNanoSeconds();
 
+  // Called either by `thread` itself or, if `thread` is suspended, by the sampling thread.
   void CompareAndUpdateStackTrace(Thread* thread, std::vector<ArtMethod*>* stack_trace)
       REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!unique_methods_lock_, !streaming_lock_);
 
@@ -307,8 +308,9 @@ class Trace final : public instrumentation::InstrumentationListener {
   // Sampling thread, non-zero when sampling.
   static pthread_t sampling_pthread_;
 
-  // Used to remember an unused stack trace to avoid re-allocation during sampling.
-  static std::unique_ptr<std::vector<ArtMethod*>> temp_stack_trace_;
+  // Used to remember an unused stack trace to avoid re-allocation during sampling. Samples are
+  // taken concurrently by the sampled threads, so this is only accessed with atomic exchanges.
+  static Atomic<std::vector<ArtMethod*>*> temp_stack_trace_;
 
   // File to write trace data out to, null if direct to ddms.
   std::unique_ptr<File> trace_file_;
@@ -37,6 +37,9 @@ static constexpr bool kEnableTransactionStats = false;
 
 Transaction::Transaction()
   : log_lock_("transaction log lock", kTransactionLogLock),
+    allocator_(Runtime::Current()->GetArenaPool()),
+    object_logs_(allocator_.Adapter(kArenaAllocTransaction)),
+    array_logs_(allocator_.Adapter(kArenaAllocTransaction)),
     aborted_(false),
     rolling_back_(false),
     strict_(false) {
@@ -51,23 +54,14 @@ Transaction::Transaction(bool strict, mirror::Class* root) : Transaction() {
 Transaction::~Transaction() {
   if (kEnableTransactionStats) {
     MutexLock mu(Thread::Current(), log_lock_);
-    size_t objects_count = object_logs_.size();
-    size_t field_values_count = 0;
-    for (const auto& it : object_logs_) {
-      field_values_count += it.second.Size();
-    }
-    size_t array_count = array_logs_.size();
-    size_t array_values_count = 0;
-    for (const auto& it : array_logs_) {
-      array_values_count += it.second.Size();
-    }
+    size_t field_values_count = object_logs_.size();
+    size_t array_values_count = array_logs_.size();
     size_t intern_string_count = intern_string_logs_.size();
     size_t resolve_string_count = resolve_string_logs_.size();
     LOG(INFO) << "Transaction::~Transaction"
-              << ": objects_count=" << objects_count
-              << ", field_values_count=" << field_values_count
-              << ", array_count=" << array_count
+              << ": field_values_count=" << field_values_count
               << ", array_values_count=" << array_values_count
+              << ", log_bytes=" << allocator_.BytesUsed()
               << ", intern_string_count=" << intern_string_count
               << ", resolve_string_count=" << resolve_string_count;
   }
@@ -146,30 +140,21 @@ void Transaction::RecordWriteFieldBoolean(mirror::Object* obj,
                                           MemberOffset field_offset,
                                           uint8_t value,
                                           bool is_volatile) {
-  DCHECK(obj != nullptr);
-  MutexLock mu(Thread::Current(), log_lock_);
-  ObjectLog& object_log = object_logs_[obj];
-  object_log.LogBooleanValue(field_offset, value, is_volatile);
+  LogFieldValue(kBoolean, obj, field_offset, value, is_volatile);
 }
 
 void Transaction::RecordWriteFieldByte(mirror::Object* obj,
                                        MemberOffset field_offset,
                                        int8_t value,
                                        bool is_volatile) {
-  DCHECK(obj != nullptr);
-  MutexLock mu(Thread::Current(), log_lock_);
-  ObjectLog& object_log = object_logs_[obj];
-  object_log.LogByteValue(field_offset, value, is_volatile);
+  LogFieldValue(kByte, obj, field_offset, value, is_volatile);
 }
 
 void Transaction::RecordWriteFieldChar(mirror::Object* obj,
                                        MemberOffset field_offset,
                                        uint16_t value,
                                        bool is_volatile) {
-  DCHECK(obj != nullptr);
-  MutexLock mu(Thread::Current(), log_lock_);
-  ObjectLog& object_log = object_logs_[obj];
-  object_log.LogCharValue(field_offset, value, is_volatile);
+  LogFieldValue(kChar, obj, field_offset, value, is_volatile);
 }
 
 
@@ -177,10 +162,7 @@ void Transaction::RecordWriteFieldShort(mirror::Object* obj,
                                         MemberOffset field_offset,
                                         int16_t value,
                                         bool is_volatile) {
-  DCHECK(obj != nullptr);
-  MutexLock mu(Thread::Current(), log_lock_);
-  ObjectLog& object_log = object_logs_[obj];
-  object_log.LogShortValue(field_offset, value, is_volatile);
+  LogFieldValue(kShort, obj, field_offset, value, is_volatile);
 }
 
 
@@ -188,30 +170,31 @@ void Transaction::RecordWriteField32(mirror::Object* obj,
                                      MemberOffset field_offset,
                                      uint32_t value,
                                      bool is_volatile) {
-  DCHECK(obj != nullptr);
-  MutexLock mu(Thread::Current(), log_lock_);
-  ObjectLog& object_log = object_logs_[obj];
-  object_log.Log32BitsValue(field_offset, value, is_volatile);
+  LogFieldValue(k32Bits, obj, field_offset, value, is_volatile);
 }
 
 void Transaction::RecordWriteField64(mirror::Object* obj,
                                      MemberOffset field_offset,
                                      uint64_t value,
                                      bool is_volatile) {
-  DCHECK(obj != nullptr);
-  MutexLock mu(Thread::Current(), log_lock_);
-  ObjectLog& object_log = object_logs_[obj];
-  object_log.Log64BitsValue(field_offset, value, is_volatile);
+  LogFieldValue(k64Bits, obj, field_offset, value, is_volatile);
 }
 
 void Transaction::RecordWriteFieldReference(mirror::Object* obj,
                                             MemberOffset field_offset,
                                             mirror::Object* value,
                                             bool is_volatile) {
+  LogFieldValue(kReference, obj, field_offset, reinterpret_cast<uintptr_t>(value), is_volatile);
+}
+
+void Transaction::LogFieldValue(FieldValueKind kind,
+                                mirror::Object* obj,
+                                MemberOffset field_offset,
+                                uint64_t value,
+                                bool is_volatile) {
   DCHECK(obj != nullptr);
   MutexLock mu(Thread::Current(), log_lock_);
-  ObjectLog& object_log = object_logs_[obj];
-  object_log.LogReferenceValue(field_offset, value, is_volatile);
+  object_logs_.push_back({obj, value, field_offset.Uint32Value(), kind, is_volatile});
 }
 
 void Transaction::RecordWriteArray(mirror::Array* array, size_t index, uint64_t value) {
@@ -219,12 +202,7 @@ void Transaction::RecordWriteArray(mirror::Array* array, size_t index, uint64_t
   DCHECK(array->IsArrayInstance());
   DCHECK(!array->IsObjectArray());
   MutexLock mu(Thread::Current(), log_lock_);
-  auto it = array_logs_.find(array);
-  if (it == array_logs_.end()) {
-    ArrayLog log;
-    it = array_logs_.emplace(array, std::move(log)).first;
-  }
-  it->second.LogValue(index, value);
+  array_logs_.push_back({array, index, value});
 }
 
 void Transaction::RecordResolveString(ObjPtr<mirror::DexCache> dex_cache,
@@ -278,8 +256,9 @@ void Transaction::Rollback() {
 void Transaction::UndoObjectModifications() {
   // TODO we may not need to restore objects allocated during this transaction. Or we could directly
   // remove them from the heap.
-  for (const auto& it : object_logs_) {
-    it.second.Undo(it.first);
+  // Undo from the most recent write to the oldest so that the oldest value of a field wins.
+  for (auto it = object_logs_.rbegin(); it != object_logs_.rend(); ++it) {
+    it->Undo();
   }
   object_logs_.clear();
 }
@@ -287,8 +266,8 @@ void Transaction::UndoObjectModifications() {
 void Transaction::UndoArrayModifications() {
   // TODO we may not need to restore array allocated during this transaction. Or we could directly
   // remove them from the heap.
-  for (const auto& it : array_logs_) {
-    it.second.Undo(it.first);
+  for (auto it = array_logs_.rbegin(); it != array_logs_.rend(); ++it) {
+    it->Undo();
   }
   array_logs_.clear();
 }
@@ -320,57 +299,15 @@ void Transaction::VisitRoots(RootVisitor* visitor) {
 }
 
 void Transaction::VisitObjectLogs(RootVisitor* visitor) {
-  // List of moving roots.
-  using ObjectPair = std::pair<mirror::Object*, mirror::Object*>;
-  std::list<ObjectPair> moving_roots;
-
-  // Visit roots.
-  for (auto& it : object_logs_) {
-    it.second.VisitRoots(visitor);
-    mirror::Object* old_root = it.first;
-    mirror::Object* new_root = old_root;
-    visitor->VisitRoot(&new_root, RootInfo(kRootUnknown));
-    if (new_root != old_root) {
-      moving_roots.push_back(std::make_pair(old_root, new_root));
-    }
-  }
-
-  // Update object logs with moving roots.
-  for (const ObjectPair& pair : moving_roots) {
-    mirror::Object* old_root = pair.first;
-    mirror::Object* new_root = pair.second;
-    auto old_root_it = object_logs_.find(old_root);
-    CHECK(old_root_it != object_logs_.end());
-    CHECK(object_logs_.find(new_root) == object_logs_.end());
-    object_logs_.emplace(new_root, std::move(old_root_it->second));
-    object_logs_.erase(old_root_it);
+  for (FieldLog& log : object_logs_) {
+    log.VisitRoots(visitor);
   }
 }
 
 void Transaction::VisitArrayLogs(RootVisitor* visitor) {
-  // List of moving roots.
-  using ArrayPair = std::pair<mirror::Array*, mirror::Array*>;
-  std::list<ArrayPair> moving_roots;
-
-  for (auto& it : array_logs_) {
-    mirror::Array* old_root = it.first;
-    CHECK(!old_root->IsObjectArray());
-    mirror::Array* new_root = old_root;
-    visitor->VisitRoot(reinterpret_cast<mirror::Object**>(&new_root), RootInfo(kRootUnknown));
-    if (new_root != old_root) {
-      moving_roots.push_back(std::make_pair(old_root, new_root));
-    }
-  }
-
-  // Update array logs with moving roots.
-  for (const ArrayPair& pair : moving_roots) {
-    mirror::Array* old_root = pair.first;
-    mirror::Array* new_root = pair.second;
-    auto old_root_it = array_logs_.find(old_root);
-    CHECK(old_root_it != array_logs_.end());
-    CHECK(array_logs_.find(new_root) == array_logs_.end());
-    array_logs_.emplace(new_root, std::move(old_root_it->second));
-    array_logs_.erase(old_root_it);
+  for (ArrayLog& log : array_logs_) {
+    DCHECK(!log.array->IsObjectArray());
+    visitor->VisitRoot(reinterpret_cast<mirror::Object**>(&log.array), RootInfo(kRootUnknown));
   }
 }
 
@@ -386,162 +323,106 @@ void Transaction::VisitResolveStringLogs(RootVisitor* visitor) {
   }
 }
 
-void Transaction::ObjectLog::LogBooleanValue(MemberOffset offset, uint8_t value, bool is_volatile) {
-  LogValue(ObjectLog::kBoolean, offset, value, is_volatile);
-}
-
-void Transaction::ObjectLog::LogByteValue(MemberOffset offset, int8_t value, bool is_volatile) {
-  LogValue(ObjectLog::kByte, offset, value, is_volatile);
-}
-
-void Transaction::ObjectLog::LogCharValue(MemberOffset offset, uint16_t value, bool is_volatile) {
-  LogValue(ObjectLog::kChar, offset, value, is_volatile);
-}
-
-void Transaction::ObjectLog::LogShortValue(MemberOffset offset, int16_t value, bool is_volatile) {
-  LogValue(ObjectLog::kShort, offset, value, is_volatile);
-}
-
-void Transaction::ObjectLog::Log32BitsValue(MemberOffset offset, uint32_t value, bool is_volatile) {
-  LogValue(ObjectLog::k32Bits, offset, value, is_volatile);
-}
-
-void Transaction::ObjectLog::Log64BitsValue(MemberOffset offset, uint64_t value, bool is_volatile) {
-  LogValue(ObjectLog::k64Bits, offset, value, is_volatile);
-}
-
-void Transaction::ObjectLog::LogReferenceValue(MemberOffset offset,
-                                               mirror::Object* obj,
-                                               bool is_volatile) {
-  LogValue(ObjectLog::kReference, offset, reinterpret_cast<uintptr_t>(obj), is_volatile);
-}
-
-void Transaction::ObjectLog::LogValue(ObjectLog::FieldValueKind kind,
-                                      MemberOffset offset,
-                                      uint64_t value,
-                                      bool is_volatile) {
-  auto it = field_values_.find(offset.Uint32Value());
-  if (it == field_values_.end()) {
-    ObjectLog::FieldValue field_value;
-    field_value.value = value;
-    field_value.is_volatile = is_volatile;
-    field_value.kind = kind;
-    field_values_.emplace(offset.Uint32Value(), std::move(field_value));
+void Transaction::FieldLog::Undo() const {
+  // Garbage collector needs to access object's class and array's length. So we don't rollback
+  // these values.
+  MemberOffset field_offset(offset);
+  if (offset == mirror::Class::ClassOffset().Uint32Value()) {
+    // Skip Object::class field.
+    return;
   }
-}
-
-void Transaction::ObjectLog::Undo(mirror::Object* obj) const {
-  for (auto& it : field_values_) {
-    // Garbage collector needs to access object's class and array's length. So we don't rollback
-    // these values.
-    MemberOffset field_offset(it.first);
-    if (field_offset.Uint32Value() == mirror::Class::ClassOffset().Uint32Value()) {
-      // Skip Object::class field.
-      continue;
-    }
-    if (obj->IsArrayInstance() &&
-        field_offset.Uint32Value() == mirror::Array::LengthOffset().Uint32Value()) {
-      // Skip Array::length field.
-      continue;
-    }
-    const FieldValue& field_value = it.second;
-    UndoFieldWrite(obj, field_offset, field_value);
+  if (obj->IsArrayInstance() && offset == mirror::Array::LengthOffset().Uint32Value()) {
+    // Skip Array::length field.
+    return;
   }
-}
-
-void Transaction::ObjectLog::UndoFieldWrite(mirror::Object* obj,
-                                            MemberOffset field_offset,
-                                            const FieldValue& field_value) const {
   // TODO We may want to abort a transaction while still being in transaction mode. In this case,
   // we'd need to disable the check.
   constexpr bool kCheckTransaction = false;
-  switch (field_value.kind) {
+  switch (kind) {
     case kBoolean:
-      if (UNLIKELY(field_value.is_volatile)) {
+      if (UNLIKELY(is_volatile)) {
         obj->SetFieldBooleanVolatile<false, kCheckTransaction>(
             field_offset,
-            field_value.value);
+            value);
       } else {
         obj->SetFieldBoolean<false, kCheckTransaction>(
             field_offset,
-            field_value.value);
+            value);
       }
       break;
     case kByte:
-      if (UNLIKELY(field_value.is_volatile)) {
+      if (UNLIKELY(is_volatile)) {
         obj->SetFieldByteVolatile<false, kCheckTransaction>(
             field_offset,
-            static_cast<int8_t>(field_value.value));
+            static_cast<int8_t>(value));
       } else {
         obj->SetFieldByte<false, kCheckTransaction>(
             field_offset,
-            static_cast<int8_t>(field_value.value));
+            static_cast<int8_t>(value));
       }
       break;
     case kChar:
-      if (UNLIKELY(field_value.is_volatile)) {
+      if (UNLIKELY(is_volatile)) {
         obj->SetFieldCharVolatile<false, kCheckTransaction>(
             field_offset,
-            static_cast<uint16_t>(field_value.value));
+            static_cast<uint16_t>(value));
       } else {
         obj->SetFieldChar<false, kCheckTransaction>(
             field_offset,
-            static_cast<uint16_t>(field_value.value));
+            static_cast<uint16_t>(value));
       }
       break;
     case kShort:
-      if (UNLIKELY(field_value.is_volatile)) {
+      if (UNLIKELY(is_volatile)) {
         obj->SetFieldShortVolatile<false, kCheckTransaction>(
             field_offset,
-            static_cast<int16_t>(field_value.value));
+            static_cast<int16_t>(value));
       } else {
         obj->SetFieldShort<false, kCheckTransaction>(
             field_offset,
-            static_cast<int16_t>(field_value.value));
+            static_cast<int16_t>(value));
       }
       break;
     case k32Bits:
-      if (UNLIKELY(field_value.is_volatile)) {
+      if (UNLIKELY(is_volatile)) {
         obj->SetField32Volatile<false, kCheckTransaction>(
             field_offset,
-            static_cast<uint32_t>(field_value.value));
+            static_cast<uint32_t>(value));
       } else {
         obj->SetField32<false, kCheckTransaction>(
             field_offset,
-            static_cast<uint32_t>(field_value.value));
+            static_cast<uint32_t>(value));
       }
       break;
     case k64Bits:
-      if (UNLIKELY(field_value.is_volatile)) {
-        obj->SetField64Volatile<false, kCheckTransaction>(field_offset, field_value.value);
+      if (UNLIKELY(is_volatile)) {
+        obj->SetField64Volatile<false, kCheckTransaction>(field_offset, value);
       } else {
-        obj->SetField64<false, kCheckTransaction>(field_offset, field_value.value);
+        obj->SetField64<false, kCheckTransaction>(field_offset, value);
       }
       break;
     case kReference:
-      if (UNLIKELY(field_value.is_volatile)) {
+      if (UNLIKELY(is_volatile)) {
         obj->SetFieldObjectVolatile<false, kCheckTransaction>(
             field_offset,
-            reinterpret_cast<mirror::Object*>(field_value.value));
+            reinterpret_cast<mirror::Object*>(value));
       } else {
         obj->SetFieldObject<false, kCheckTransaction>(
             field_offset,
-            reinterpret_cast<mirror::Object*>(field_value.value));
+            reinterpret_cast<mirror::Object*>(value));
       }
       break;
     default:
-      LOG(FATAL) << "Unknown value kind " << static_cast<int>(field_value.kind);
+      LOG(FATAL) << "Unknown value kind " << static_cast<int>(kind);
       UNREACHABLE();
   }
 }
 
-void Transaction::ObjectLog::VisitRoots(RootVisitor* visitor) {
-  for (auto& it : field_values_) {
-    FieldValue& field_value = it.second;
-    if (field_value.kind == ObjectLog::kReference) {
-      visitor->VisitRootIfNonNull(reinterpret_cast<mirror::Object**>(&field_value.value),
-                                  RootInfo(kRootUnknown));
-    }
+void Transaction::FieldLog::VisitRoots(RootVisitor* visitor) {
+  visitor->VisitRoot(&obj, RootInfo(kRootUnknown));
+  if (kind == kReference) {
+    visitor->VisitRootIfNonNull(reinterpret_cast<mirror::Object**>(&value),
+                                RootInfo(kRootUnknown));
   }
 }
 
@@ -611,26 +492,10 @@ Transaction::InternStringLog::InternStringLog(ObjPtr<mirror::String> s,
   DCHECK(s != nullptr);
 }
 
-void Transaction::ArrayLog::LogValue(size_t index, uint64_t value) {
-  auto it = array_values_.find(index);
-  if (it == array_values_.end()) {
-    array_values_.insert(std::make_pair(index, value));
-  }
-}
-
-void Transaction::ArrayLog::Undo(mirror::Array* array) const {
+void Transaction::ArrayLog::Undo() const {
   DCHECK(array != nullptr);
   DCHECK(array->IsArrayInstance());
-  Primitive::Type type = array->GetClass()->GetComponentType()->GetPrimitiveType();
-  for (auto it : array_values_) {
-    UndoArrayWrite(array, type, it.first, it.second);
-  }
-}
-
-void Transaction::ArrayLog::UndoArrayWrite(mirror::Array* array,
-                                           Primitive::Type array_type,
-                                           size_t index,
-                                           uint64_t value) const {
+  Primitive::Type array_type = array->GetClass()->GetComponentType()->GetPrimitiveType();
   // TODO We may want to abort a transaction while still being in transaction mode. In this case,
   // we'd need to disable the check.
   constexpr bool kCheckTransaction = false;
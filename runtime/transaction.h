@@ -17,6 +17,8 @@
 #ifndef ART_RUNTIME_TRANSACTION_H_
 #define ART_RUNTIME_TRANSACTION_H_
 
+#include "base/arena_allocator.h"
+#include "base/arena_containers.h"
 #include "base/macros.h"
 #include "base/mutex.h"
 #include "base/safe_map.h"
@@ -27,7 +29,6 @@
 #include "offsets.h"
 
 #include <list>
-#include <map>
 
 namespace art {
 namespace mirror {
@@ -144,84 +145,39 @@ class Transaction final {
       REQUIRES_SHARED(Locks::mutator_lock_);
 
  private:
-  class ObjectLog : public ValueObject {
-   public:
-    void LogBooleanValue(MemberOffset offset, uint8_t value, bool is_volatile);
-    void LogByteValue(MemberOffset offset, int8_t value, bool is_volatile);
-    void LogCharValue(MemberOffset offset, uint16_t value, bool is_volatile);
-    void LogShortValue(MemberOffset offset, int16_t value, bool is_volatile);
-    void Log32BitsValue(MemberOffset offset, uint32_t value, bool is_volatile);
-    void Log64BitsValue(MemberOffset offset, uint64_t value, bool is_volatile);
-    void LogReferenceValue(MemberOffset offset, mirror::Object* obj, bool is_volatile);
-
-    void Undo(mirror::Object* obj) const REQUIRES_SHARED(Locks::mutator_lock_);
-    void VisitRoots(RootVisitor* visitor) REQUIRES_SHARED(Locks::mutator_lock_);
-
-    size_t Size() const {
-      return field_values_.size();
-    }
-
-    ObjectLog() = default;
-    ObjectLog(ObjectLog&& log) = default;
-
-   private:
-    enum FieldValueKind {
-      kBoolean,
-      kByte,
-      kChar,
-      kShort,
-      k32Bits,
-      k64Bits,
-      kReference
-    };
-    struct FieldValue : public ValueObject {
-      // TODO use JValue instead ?
-      uint64_t value;
-      FieldValueKind kind;
-      bool is_volatile;
-
-      FieldValue() : value(0), kind(FieldValueKind::kBoolean), is_volatile(false) {}
-      FieldValue(FieldValue&& log) = default;
-
-     private:
-      DISALLOW_COPY_AND_ASSIGN(FieldValue);
-    };
-
-    void LogValue(FieldValueKind kind, MemberOffset offset, uint64_t value, bool is_volatile);
-    void UndoFieldWrite(mirror::Object* obj,
-                        MemberOffset field_offset,
-                        const FieldValue& field_value) const REQUIRES_SHARED(Locks::mutator_lock_);
-
-    // Maps field's offset to its value.
-    std::map<uint32_t, FieldValue> field_values_;
-
-    DISALLOW_COPY_AND_ASSIGN(ObjectLog);
+  enum FieldValueKind : uint8_t {
+    kBoolean,
+    kByte,
+    kChar,
+    kShort,
+    k32Bits,
+    k64Bits,
+    kReference
   };
 
-  class ArrayLog : public ValueObject {
-   public:
-    void LogValue(size_t index, uint64_t value);
-
-    void Undo(mirror::Array* obj) const REQUIRES_SHARED(Locks::mutator_lock_);
-
-    size_t Size() const {
-      return array_values_.size();
-    }
-
-    ArrayLog() = default;
-    ArrayLog(ArrayLog&& log) = default;
+  // Undo log entry for a write to an object field. The field logs are append-only and undone
+  // from the most recent to the oldest, which restores the value each field had before the
+  // transaction without having to look up earlier writes to the same field.
+  struct FieldLog {
+    mirror::Object* obj;
+    // TODO use JValue instead ?
+    uint64_t value;
+    uint32_t offset;
+    FieldValueKind kind;
+    bool is_volatile;
 
-   private:
-    void UndoArrayWrite(mirror::Array* array,
-                        Primitive::Type array_type,
-                        size_t index,
-                        uint64_t value) const REQUIRES_SHARED(Locks::mutator_lock_);
+    void Undo() const REQUIRES_SHARED(Locks::mutator_lock_);
+    void VisitRoots(RootVisitor* visitor) REQUIRES_SHARED(Locks::mutator_lock_);
+  };
 
-    // Maps index to value.
+  // Undo log entry for a write to an element of a primitive array.
+  struct ArrayLog {
+    mirror::Array* array;
+    size_t index;
     // TODO use JValue instead ?
-    std::map<size_t, uint64_t> array_values_;
+    uint64_t value;
 
-    DISALLOW_COPY_AND_ASSIGN(ArrayLog);
+    void Undo() const REQUIRES_SHARED(Locks::mutator_lock_);
   };
 
   class InternStringLog : public ValueObject {
@@ -267,6 +223,13 @@ class Transaction final {
     DISALLOW_COPY_AND_ASSIGN(ResolveStringLog);
   };
 
+  void LogFieldValue(FieldValueKind kind,
+                     mirror::Object* obj,
+                     MemberOffset field_offset,
+                     uint64_t value,
+                     bool is_volatile)
+      REQUIRES(!log_lock_);
+
   void LogInternedString(InternStringLog&& log)
       REQUIRES(Locks::intern_table_lock_)
       REQUIRES(!log_lock_);
@@ -301,8 +264,10 @@ class Transaction final {
   const std::string& GetAbortMessage() REQUIRES(!log_lock_);
 
   Mutex log_lock_ ACQUIRED_AFTER(Locks::intern_table_lock_);
-  std::map<mirror::Object*, ObjectLog> object_logs_ GUARDED_BY(log_lock_);
-  std::map<mirror::Array*, ArrayLog> array_logs_  GUARDED_BY(log_lock_);
+  // Backing storage for the field and array logs, released with the transaction.
+  ArenaAllocator allocator_ GUARDED_BY(log_lock_);
+  ArenaDeque<FieldLog> object_logs_ GUARDED_BY(log_lock_);
+  ArenaDeque<ArrayLog> array_logs_ GUARDED_BY(log_lock_);
   std::list<InternStringLog> intern_string_logs_ GUARDED_BY(log_lock_);
   std::list<ResolveStringLog> resolve_string_logs_ GUARDED_BY(log_lock_);
   bool aborted_ GUARDED_BY(log_lock_);
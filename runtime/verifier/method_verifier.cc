@@ -3714,32 +3714,49 @@ bool MethodVerifier<kVerifierDebug>::CodeFlowVerifyInstruction(uint32_t* start_g
 template <bool kVerifierDebug>
 template <CheckAccess C>
 const RegType& MethodVerifier<kVerifierDebug>::ResolveClass(dex::TypeIndex class_idx) {
-  ClassLinker* linker = Runtime::Current()->GetClassLinker();
-  ObjPtr<mirror::Class> klass = can_load_classes_
-      ? linker->ResolveType(class_idx, dex_cache_, class_loader_)
-      : linker->LookupResolvedType(class_idx, dex_cache_.Get(), class_loader_.Get());
-  if (can_load_classes_ && klass == nullptr) {
-    DCHECK(self_->IsExceptionPending());
-    self_->ClearException();
-  }
   const RegType* result = nullptr;
-  if (klass != nullptr) {
-    bool precise = klass->CannotBeAssignedFromOtherTypes();
-    if (precise && !IsInstantiableOrPrimitive(klass)) {
-      const char* descriptor = dex_file_->StringByTypeIdx(class_idx);
-      UninstantiableError(descriptor);
-      precise = false;
+  auto it = resolved_types_.find(class_idx.index_);
+  if (it != resolved_types_.end()) {
+    // The class resolution was recorded when the type was first resolved.
+    result = it->second;
+  } else {
+    ClassLinker* linker = Runtime::Current()->GetClassLinker();
+    ObjPtr<mirror::Class> klass = can_load_classes_
+        ? linker->ResolveType(class_idx, dex_cache_, class_loader_)
+        : linker->LookupResolvedType(class_idx, dex_cache_.Get(), class_loader_.Get());
+    if (can_load_classes_ && klass == nullptr) {
+      DCHECK(self_->IsExceptionPending());
+      self_->ClearException();
     }
-    result = reg_types_.FindClass(klass, precise);
-    if (result == nullptr) {
+    // Types which fail the instantiability check are not cached, so that the failure is
+    // reported for every instruction using them.
+    bool cacheable = true;
+    if (klass != nullptr) {
+      bool precise = klass->CannotBeAssignedFromOtherTypes();
+      if (precise && !IsInstantiableOrPrimitive(klass)) {
+        const char* descriptor = dex_file_->StringByTypeIdx(class_idx);
+        UninstantiableError(descriptor);
+        precise = false;
+        cacheable = false;
+      }
+      result = reg_types_.FindClass(klass, precise);
+      if (result == nullptr) {
+        const char* descriptor = dex_file_->StringByTypeIdx(class_idx);
+        result = reg_types_.InsertClass(descriptor, klass, precise);
+      }
+    } else {
       const char* descriptor = dex_file_->StringByTypeIdx(class_idx);
-      result = reg_types_.InsertClass(descriptor, klass, precise);
+      result = &reg_types_.FromDescriptor(class_loader_.Get(), descriptor, false);
+    }
+    DCHECK(result != nullptr);
+    if (!result->IsConflict()) {
+      // Record result of class resolution attempt.
+      VerifierDeps::MaybeRecordClassResolution(*dex_file_, class_idx, klass);
+    }
+    if (cacheable) {
+      resolved_types_.emplace(class_idx.index_, result);
     }
-  } else {
-    const char* descriptor = dex_file_->StringByTypeIdx(class_idx);
-    result = &reg_types_.FromDescriptor(class_loader_.Get(), descriptor, false);
   }
-  DCHECK(result != nullptr);
   if (result->IsConflict()) {
     const char* descriptor = dex_file_->StringByTypeIdx(class_idx);
     Fail(VERIFY_ERROR_BAD_CLASS_SOFT) << "accessing broken descriptor '" << descriptor
@@ -3747,9 +3764,6 @@ const RegType& MethodVerifier<kVerifierDebug>::ResolveClass(dex::TypeIndex class
     return *result;
   }
 
-  // Record result of class resolution attempt.
-  VerifierDeps::MaybeRecordClassResolution(*dex_file_, class_idx, klass);
-
   // If requested, check if access is allowed. Unresolved types are included in this check, as the
   // interpreter only tests whether access is allowed when a class is not pre-verified and runs in
   // the access-checks interpreter. If result is primitive, skip the access check.
@@ -5094,6 +5108,7 @@ MethodVerifier::MethodVerifier(Thread* self,
       arena_stack_(Runtime::Current()->GetArenaPool()),
       allocator_(&arena_stack_),
       reg_types_(can_load_classes, allocator_, allow_thread_suspension),
+      resolved_types_(allocator_.Adapter(kArenaAllocVerifier)),
       reg_table_(allocator_),
       work_insn_idx_(dex::kDexNoIndex),
       dex_method_idx_(dex_method_idx),
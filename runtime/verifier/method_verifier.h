@@ -281,6 +281,10 @@ class MethodVerifier {
 
   RegTypeCache reg_types_;
 
+  // Types returned by ResolveClass(), by type index, so that each type is only looked up once in
+  // reg_types_, whose lookups are linear.
+  ScopedArenaUnorderedMap<uint16_t, const RegType*> resolved_types_;
+
   PcToRegisterLineTable reg_table_;
 
   // Storage for the register status we're currently working on.
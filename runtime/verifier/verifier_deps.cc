@@ -978,6 +978,25 @@ bool VerifierDeps::ValidateDependencies(Thread* self,
   return true;
 }
 
+bool VerifierDeps::ValidateDependencies(Thread* self,
+                                        Handle<mirror::ClassLoader> class_loader,
+                                        const std::vector<const DexFile*>& classpath,
+                                        const DexFile& dex_file,
+                                        /* out */ std::string* error_msg) const {
+  const DexFileDeps* deps = GetDexFileDeps(dex_file);
+  if (deps == nullptr) {
+    *error_msg = "No dependencies recorded for " + dex_file.GetLocation();
+    return false;
+  }
+  return VerifyDexFile(class_loader, dex_file, *deps, classpath, self, error_msg);
+}
+
+void VerifierDeps::ClearDependencies(const DexFile& dex_file) {
+  auto it = dex_deps_.find(&dex_file);
+  DCHECK(it != dex_deps_.end());
+  it->second.reset(new DexFileDeps(dex_file.NumClassDefs()));
+}
+
 // TODO: share that helper with other parts of the compiler that have
 // the same lookup pattern.
 static ObjPtr<mirror::Class> FindClassAndClearException(ClassLinker* class_linker,
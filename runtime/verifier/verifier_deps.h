@@ -133,6 +133,20 @@ class VerifierDeps {
                             /* out */ std::string* error_msg) const
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Verify the encoded dependencies of `dex_file` only. Dependencies are recorded per dex file,
+  // so the verification results of `dex_file` remain usable if only the dependencies of other
+  // dex files are no longer valid.
+  bool ValidateDependencies(Thread* self,
+                            Handle<mirror::ClassLoader> class_loader,
+                            const std::vector<const DexFile*>& classpath,
+                            const DexFile& dex_file,
+                            /* out */ std::string* error_msg) const
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Discard the dependencies and verification results recorded for `dex_file`, so that they can
+  // be recorded again when its classes are verified.
+  void ClearDependencies(const DexFile& dex_file);
+
   const std::vector<bool>& GetVerifiedClasses(const DexFile& dex_file) const {
     return GetDexFileDeps(dex_file)->verified_classes_;
   }
@@ -62,6 +62,44 @@ public class Main {
     }
   }
 
+  /// CHECK-START-{ARM,ARM64,MIPS64}: void Main.$noinline$testTwoRuntimeTests(int[], int[], int[]) loop_optimization (after)
+  /// CHECK-DAG: NotEqual
+  /// CHECK-DAG: NotEqual
+  /// CHECK-DAG: VecLoad  loop:<<Loop:B\d+>> outer_loop:none
+  /// CHECK-DAG: VecAdd   loop:<<Loop>>      outer_loop:none
+  /// CHECK-DAG: VecStore loop:<<Loop>>      outer_loop:none
+  public static void $noinline$testTwoRuntimeTests(int[] a, int[] b, int[] c) {
+    // Needs both a != b and a != c to run the vector loop.
+    for (int i = 0; i < 100; i++) {
+      a[i + 1] = b[i] + c[i];
+    }
+  }
+
+  public static void testRuntimeTests() {
+    int[] a = new int[101];
+    int[] c = new int[101];
+    for (int i = 0; i < 101; i++) {
+      a[i] = i;
+      c[i] = 2 * i;
+    }
+    // Aliased references must fail the runtime test and run the scalar loop.
+    $noinline$testTwoRuntimeTests(a, a, c);
+    int expected = 0;
+    for (int i = 0; i < 100; i++) {
+      expected += 2 * i;
+      if (a[i + 1] != expected) {
+        throw new Error("Expected: " + expected + ", found: " + a[i + 1]);
+      }
+    }
+    int[] b = new int[101];
+    $noinline$testTwoRuntimeTests(b, c, c);
+    for (int i = 0; i < 100; i++) {
+      if (b[i + 1] != 4 * i) {
+        throw new Error("Expected: " + (4 * i) + ", found: " + b[i + 1]);
+      }
+    }
+  }
+
   public static void main(String[] args) {
     // We must not optimize any of the exceptions away.
     try {
@@ -79,5 +117,6 @@ public class Main {
     } catch (java.lang.ArrayIndexOutOfBoundsException e) {
       System.out.println("BoundsCheck");
     }
+    testRuntimeTests();
   }
 }
@@ -0,0 +1,220 @@
+#!/usr/bin/python3
+#
+# Copyright 2020, The Android Open Source Project
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+#
+# Compile-throughput benchmark for dex2oat.
+#
+# 'run' compiles the same inputs repeatedly with --dump-timings, --dump-pass-timings and
+# --dump-stats, and records per run: wall time, methods per second, peak RSS, thread
+# utilization, the time of each dex2oat phase and of each optimizing compiler pass.
+# 'compare' reports the difference of two such recordings (e.g. from two builds) with
+# Welch's t-test, so that only statistically significant changes are flagged.
+#
+# Example:
+#   dex2oat_benchmark.py run --runs 10 --out before.json -- \
+#       dex2oat --dex-file=app.apk --oat-file=/tmp/app.odex --boot-image=... -j4
+#   (rebuild)
+#   dex2oat_benchmark.py run --runs 10 --out after.json -- dex2oat ...
+#   dex2oat_benchmark.py compare before.json after.json
+#
+
+import argparse
+import json
+import math
+import re
+import statistics
+import subprocess
+import sys
+import time
+
+BENCHMARK_FLAGS = ['--dump-timings', '--dump-pass-timings', '--dump-stats']
+
+UNITS_NS = {'ns': 1, 'us': 1e3, 'ms': 1e6, 's': 1e9}
+SIZES = {'B': 1, 'KB': 1 << 10, 'MB': 1 << 20, 'GB': 1 << 30}
+
+DURATION = r'([0-9.]+)(ns|us|ms|s)'
+# TimingLogger line: "<exclusive>[/<total>] <phase name>".
+PHASE_RE = re.compile(r'^\s*' + DURATION + r'(?:/' + DURATION + r')? (.+)$')
+# CumulativeLogger histogram line: "<pass name>:\tSum: <duration> ...".
+PASS_RE = re.compile(r'^(.+):\tSum: ' + DURATION + r' ')
+METHODS_RE = re.compile(r'Attempted compilation of (\d+) methods')
+RSS_RE = re.compile(r'Peak RSS: ([0-9.]+)(B|KB|MB|GB)')
+CPU_RE = re.compile(r'CPU time: user ' + DURATION + r', system ' + DURATION + r', threads (\d+)')
+# Strip the log prefix, e.g. "dex2oat I 01-01 00:00:00  1234  1234 dex2oat.cc:42] ".
+LOG_PREFIX_RE = re.compile(r'^.*?\] ')
+
+
+def to_ns(value, unit):
+  return float(value) * UNITS_NS[unit]
+
+
+def parse_output(output):
+  """Extracts the metrics of one dex2oat run from its log output."""
+  result = {'phases_ns': {}, 'passes_ns': {}}
+  in_pass_timings = False
+  for line in output.splitlines():
+    line = LOG_PREFIX_RE.sub('', line, count=1)
+    if line.startswith('Start Dumping histograms') and 'Optimizing pass timings' in line:
+      in_pass_timings = True
+      continue
+    if line.startswith('Done Dumping histograms'):
+      in_pass_timings = False
+      continue
+    match = PASS_RE.match(line)
+    if in_pass_timings and match:
+      result['passes_ns'][match.group(1)] = to_ns(match.group(2), match.group(3))
+      continue
+    match = METHODS_RE.search(line)
+    if match:
+      result['methods'] = int(match.group(1))
+      continue
+    match = RSS_RE.search(line)
+    if match:
+      result['peak_rss_bytes'] = float(match.group(1)) * SIZES[match.group(2)]
+      continue
+    match = CPU_RE.search(line)
+    if match:
+      result['cpu_ns'] = to_ns(match.group(1), match.group(2)) + to_ns(match.group(3),
+                                                                      match.group(4))
+      result['threads'] = int(match.group(5))
+      continue
+    match = PHASE_RE.match(line)
+    if match and not in_pass_timings:
+      # Prefer the total time, which includes nested phases.
+      if match.group(3) is not None:
+        value = to_ns(match.group(3), match.group(4))
+      else:
+        value = to_ns(match.group(1), match.group(2))
+      result['phases_ns'][match.group(5).strip()] = value
+  return result
+
+
+def run_once(command):
+  start = time.monotonic()
+  process = subprocess.run(command + BENCHMARK_FLAGS,
+                           stdout=subprocess.PIPE,
+                           stderr=subprocess.STDOUT,
+                           universal_newlines=True)
+  wall_ns = (time.monotonic() - start) * 1e9
+  if process.returncode != 0:
+    sys.stderr.write(process.stdout)
+    raise RuntimeError('dex2oat failed with exit code %d' % process.returncode)
+  result = parse_output(process.stdout)
+  result['wall_ns'] = wall_ns
+  if result.get('methods'):
+    result['methods_per_second'] = result['methods'] / (wall_ns / 1e9)
+  if result.get('cpu_ns') and result.get('threads'):
+    result['thread_utilization'] = result['cpu_ns'] / (wall_ns * result['threads'])
+  return result
+
+
+def flatten(run):
+  """Maps a run to a flat dictionary of metric name to value."""
+  metrics = {}
+  for key, value in run.items():
+    if isinstance(value, dict):
+      for name, sub_value in value.items():
+        metrics['%s/%s' % (key, name)] = sub_value
+    else:
+      metrics[key] = value
+  return metrics
+
+
+def welch_t(a, b):
+  """Returns Welch's t statistic and degrees of freedom for two samples."""
+  var_a = statistics.variance(a) / len(a)
+  var_b = statistics.variance(b) / len(b)
+  if var_a + var_b == 0:
+    return 0.0, 1.0
+  t = (statistics.mean(b) - statistics.mean(a)) / math.sqrt(var_a + var_b)
+  df = (var_a + var_b) ** 2 / ((var_a ** 2) / (len(a) - 1) + (var_b ** 2) / (len(b) - 1))
+  return t, df
+
+
+def t_critical(df):
+  """Two-sided 95% critical value of Student's t distribution."""
+  table = [(1, 12.71), (2, 4.30), (3, 3.18), (4, 2.78), (5, 2.57), (6, 2.45), (7, 2.36),
+           (8, 2.31), (9, 2.26), (10, 2.23), (15, 2.13), (20, 2.09), (30, 2.04), (60, 2.00)]
+  for limit, value in table:
+    if df <= limit:
+      return value
+  return 1.96
+
+
+def command_run(args):
+  runs = []
+  for i in range(args.warmup + args.runs):
+    result = run_once(args.command)
+    if i >= args.warmup:
+      runs.append(result)
+      print('run %d: %.2fs, %s methods/s' %
+            (len(runs), result['wall_ns'] / 1e9, int(result.get('methods_per_second', 0))))
+  with open(args.out, 'w') as out:
+    json.dump({'command': args.command, 'runs': runs}, out, indent=2)
+
+
+def command_compare(args):
+  with open(args.before) as f:
+    before = [flatten(run) for run in json.load(f)['runs']]
+  with open(args.after) as f:
+    after = [flatten(run) for run in json.load(f)['runs']]
+  names = sorted(set(before[0]) & set(after[0]))
+  print('%-60s %14s %14s %8s' % ('metric', 'before', 'after', 'delta'))
+  for name in names:
+    a = [run[name] for run in before if name in run]
+    b = [run[name] for run in after if name in run]
+    if len(a) < 2 or len(b) < 2 or statistics.mean(a) == 0:
+      continue
+    delta = (statistics.mean(b) - statistics.mean(a)) / statistics.mean(a) * 100
+    t, df = welch_t(a, b)
+    significant = abs(t) > t_critical(df)
+    if args.all or significant:
+      print('%-60s %14.4g %14.4g %+7.2f%%%s' %
+            (name[:60], statistics.mean(a), statistics.mean(b), delta,
+             ' *' if significant else ''))
+
+
+def main():
+  parser = argparse.ArgumentParser(description='dex2oat compile-throughput benchmark.')
+  subparsers = parser.add_subparsers(dest='mode')
+  subparsers.required = True
+
+  run_parser = subparsers.add_parser('run', help='compile repeatedly and record metrics')
+  run_parser.add_argument('--runs', type=int, default=10)
+  run_parser.add_argument('--warmup', type=int, default=1)
+  run_parser.add_argument('--out', required=True, help='JSON file for the recorded runs')
+  run_parser.add_argument('command', nargs=argparse.REMAINDER,
+                          help='dex2oat command line, after --')
+  run_parser.set_defaults(func=command_run)
+
+  compare_parser = subparsers.add_parser('compare', help='compare two recordings')
+  compare_parser.add_argument('before')
+  compare_parser.add_argument('after')
+  compare_parser.add_argument('--all', action='store_true',
+                              help='also show changes which are not significant')
+  compare_parser.set_defaults(func=command_compare)
+
+  args = parser.parse_args()
+  if args.mode == 'run':
+    if args.command and args.command[0] == '--':
+      args.command = args.command[1:]
+    if not args.command:
+      parser.error('missing dex2oat command line')
+  args.func(args)
+
+
+if __name__ == '__main__':
+  main()
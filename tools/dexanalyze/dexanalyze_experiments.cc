@@ -18,9 +18,11 @@
 
 #include <algorithm>
 #include <stdint.h>
+#include <string.h>
 #include <inttypes.h>
 #include <iostream>
 #include <map>
+#include <set>
 #include <vector>
 
 #include "android-base/stringprintf.h"
@@ -617,5 +619,84 @@ void CodeMetrics::Dump(std::ostream& os, uint64_t total_size) const {
   os << "Low arg savings: " << Percent(low_arg_total * 2, total_size) << "\n";
 }
 
+void AnalyzeSharedData::ProcessDexFile(const DexFile& dex_file) {
+  // String data: ULEB128 UTF-16 length, then the null terminated MUTF-8 data.
+  for (size_t i = 0; i < dex_file.NumStringIds(); ++i) {
+    const dex::StringId& string_id = dex_file.GetStringId(dex::StringIndex(i));
+    const uint8_t* const begin = dex_file.DataBegin() + string_id.string_data_off_;
+    const uint8_t* data = begin;
+    DecodeUnsignedLeb128(&data);
+    data += strlen(reinterpret_cast<const char*>(data)) + 1u;
+    string_datas_.AddItem(std::string(reinterpret_cast<const char*>(begin), data - begin));
+  }
+  // Type lists are referenced from protos and class defs, visit each list only once.
+  std::set<const dex::TypeList*> type_lists;
+  for (size_t i = 0; i < dex_file.NumProtoIds(); ++i) {
+    type_lists.insert(dex_file.GetProtoParameters(dex_file.GetProtoId(dex::ProtoIndex(i))));
+  }
+  for (ClassAccessor accessor : dex_file.GetClasses()) {
+    type_lists.insert(dex_file.GetInterfacesList(accessor.GetClassDef()));
+  }
+  type_lists.erase(nullptr);
+  for (const dex::TypeList* type_list : type_lists) {
+    type_lists_.AddItem(std::string(reinterpret_cast<const char*>(type_list),
+                                    dex::TypeList::GetListSize(type_list->Size())));
+  }
+  // Code items, possibly shared between methods.
+  std::set<const dex::CodeItem*> code_items;
+  for (ClassAccessor accessor : dex_file.GetClasses()) {
+    for (const ClassAccessor::Method& method : accessor.GetMethods()) {
+      if (method.GetCodeItem() != nullptr) {
+        code_items.insert(method.GetCodeItem());
+      }
+    }
+  }
+  for (const dex::CodeItem* code_item : code_items) {
+    std::string data(reinterpret_cast<const char*>(code_item),
+                     dex_file.GetCodeItemSize(*code_item));
+    if (dex_file.IsStandardDexFile()) {
+      // The debug info offset is relative to this dex file and is not part of compact dex code
+      // items. Clear it so that only the code is compared.
+      static constexpr size_t kDebugInfoOffOffset = 4u * sizeof(uint16_t);
+      std::fill_n(data.begin() + kDebugInfoOffOffset, sizeof(uint32_t), '\0');
+    }
+    code_items_.AddItem(std::move(data));
+  }
+  string_datas_.FinishDexFile();
+  type_lists_.FinishDexFile();
+  code_items_.FinishDexFile();
+}
+
+void AnalyzeSharedData::Dump(std::ostream& os, uint64_t total_size) const {
+  string_datas_.Dump(os, "String data", total_size);
+  type_lists_.Dump(os, "Type lists", total_size);
+  code_items_.Dump(os, "Code items", total_size);
+}
+
+void AnalyzeSharedData::ItemStats::AddItem(std::string&& data) {
+  const size_t size = data.size();
+  total_bytes_ += size;
+  if (previous_dex_items_.find(data) != previous_dex_items_.end()) {
+    cross_dex_duplicate_bytes_ += size;
+  } else if (!current_dex_items_.insert(std::move(data)).second) {
+    same_dex_duplicate_bytes_ += size;
+  }
+}
+
+void AnalyzeSharedData::ItemStats::FinishDexFile() {
+  previous_dex_items_.insert(current_dex_items_.begin(), current_dex_items_.end());
+  current_dex_items_.clear();
+}
+
+void AnalyzeSharedData::ItemStats::Dump(std::ostream& os,
+                                        const char* name,
+                                        uint64_t total_size) const {
+  os << name << " bytes: " << Percent(total_bytes_, total_size) << "\n";
+  os << name << " duplicate bytes in the same dex file: "
+     << Percent(same_dex_duplicate_bytes_, total_size) << "\n";
+  os << name << " bytes shared with other dex files: "
+     << Percent(cross_dex_duplicate_bytes_, total_size) << "\n";
+}
+
 }  // namespace dexanalyze
 }  // namespace art
@@ -21,7 +21,9 @@
 #include <iosfwd>
 #include <memory>
 #include <set>
+#include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "base/macros.h"
@@ -172,6 +174,38 @@ class CodeMetrics : public Experiment {
   uint64_t move_result_savings_ = 0u;
 };
 
+// Measure how much of the data of the dex files is identical between dex files, and could be
+// shared by deduplicating a compact dex container's shared data section.
+class AnalyzeSharedData : public Experiment {
+ public:
+  void ProcessDexFile(const DexFile& dex_file) override;
+
+  void Dump(std::ostream& os, uint64_t total_size) const override;
+
+ private:
+  class ItemStats {
+   public:
+    // Record the contents of an item of the current dex file.
+    void AddItem(std::string&& data);
+    // Make the items of the current dex file visible to the next dex files.
+    void FinishDexFile();
+    void Dump(std::ostream& os, const char* name, uint64_t total_size) const;
+
+   private:
+    uint64_t total_bytes_ = 0u;
+    // Bytes of items identical to an earlier item of the same dex file.
+    uint64_t same_dex_duplicate_bytes_ = 0u;
+    // Bytes of items identical to an item of an earlier dex file.
+    uint64_t cross_dex_duplicate_bytes_ = 0u;
+    std::unordered_set<std::string> current_dex_items_;
+    std::unordered_set<std::string> previous_dex_items_;
+  };
+
+  ItemStats string_datas_;
+  ItemStats type_lists_;
+  ItemStats code_items_;
+};
+
 }  // namespace dexanalyze
 }  // namespace art
 
@@ -0,0 +1,115 @@
+#!/usr/bin/python3
+#
+# Copyright 2020, The Android Open Source Project
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+#
+# Summarizes a JIT warmup trace, as written by a runtime started with
+# -Xjitwarmuptrace:<file>: the latency of each step of the JIT pipeline per compilation
+# tier, and the warmup curve, i.e. the number of methods with installed JIT code over time.
+#
+# Example:
+#   dalvikvm -Xjitwarmuptrace:/data/local/tmp/warmup.csv -cp app.jar Main
+#   jit_warmup_report.py warmup.csv --bucket-ms 100
+#
+
+import argparse
+import csv
+import statistics
+
+
+def percentile(values, p):
+  values = sorted(values)
+  index = min(len(values) - 1, max(0, int(round(p / 100.0 * len(values))) - 1))
+  return values[index]
+
+
+def read_trace(path):
+  with open(path) as f:
+    return [(int(row['time_ns']), row['event'], row['tier'], row['method'])
+            for row in csv.DictReader(f)]
+
+
+def latencies(events):
+  """Returns the list of latencies, in ns, of each step, keyed by (tier, step)."""
+  result = {}
+
+  def add(tier, step, value):
+    result.setdefault((tier, step), []).append(value)
+
+  hot = {}          # method -> time it got hot
+  enqueued = {}     # (method, tier) -> time of the pending enqueue
+  compiling = {}    # method -> (tier, start time) of the compilation in progress
+  for time_ns, event, tier, method in events:
+    if event == 'hot':
+      hot.setdefault(method, time_ns)
+    elif event == 'enqueued':
+      enqueued.setdefault((method, tier), time_ns)
+    elif event == 'compile_start':
+      compiling[method] = (tier, time_ns)
+      if (method, tier) in enqueued:
+        add(tier, 'queue wait', time_ns - enqueued.pop((method, tier)))
+    elif event in ('compile_end', 'compile_failed') and method in compiling:
+      # The code is installed before the compilation ends.
+      start_tier, start = compiling.pop(method)
+      add(start_tier, 'compile' if event == 'compile_end' else 'failed compile', time_ns - start)
+    elif event == 'installed' and method in compiling:
+      start_tier, start = compiling[method]
+      add(start_tier, 'start to install', time_ns - start)
+      if method in hot and start_tier != 'osr':
+        add(start_tier, 'hot to install', time_ns - hot[method])
+  return result
+
+
+def warmup_curve(events, bucket_ns):
+  """Returns the number of methods with installed code at the end of each bucket."""
+  if not events:
+    return []
+  begin = events[0][0]
+  installed = set()
+  curve = []
+  bucket_end = begin + bucket_ns
+  for time_ns, event, _, method in events:
+    while time_ns >= bucket_end:
+      curve.append(len(installed))
+      bucket_end += bucket_ns
+    if event == 'installed':
+      installed.add(method)
+  curve.append(len(installed))
+  return curve
+
+
+def main():
+  parser = argparse.ArgumentParser(description='Summarizes a JIT warmup trace.')
+  parser.add_argument('trace', help='file written with -Xjitwarmuptrace')
+  parser.add_argument('--bucket-ms', type=int, default=100,
+                      help='time resolution of the warmup curve')
+  args = parser.parse_args()
+
+  events = sorted(read_trace(args.trace))
+  print('%-10s %-18s %8s %12s %12s %12s' % ('tier', 'step', 'count', 'median us', 'p90 us',
+                                           'max us'))
+  for (tier, step), values in sorted(latencies(events).items()):
+    print('%-10s %-18s %8d %12.1f %12.1f %12.1f' %
+          (tier, step, len(values), statistics.median(values) / 1e3,
+           percentile(values, 90) / 1e3, max(values) / 1e3))
+
+  print()
+  print('Methods with JIT code, every %d ms:' % args.bucket_ms)
+  for i, count in enumerate(warmup_curve(events, args.bucket_ms * 1000000)):
+    print('%8d ms %8d' % ((i + 1) * args.bucket_ms, count))
+
+
+if __name__ == '__main__':
+  main()
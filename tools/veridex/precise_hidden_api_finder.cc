@@ -26,21 +26,47 @@
 #include "resolver.h"
 #include "veridex.h"
 
+#include <algorithm>
+#include <atomic>
 #include <iostream>
+#include <thread>
 
 namespace art {
 
-void PreciseHiddenApiFinder::RunInternal(
-    const std::vector<std::unique_ptr<VeridexResolver>>& resolvers,
-    const std::function<void(VeridexResolver*, const ClassAccessor::Method&)>& action) {
-  for (const std::unique_ptr<VeridexResolver>& resolver : resolvers) {
-    for (ClassAccessor accessor : resolver->GetDexFile().GetClasses()) {
-      for (const ClassAccessor::Method& method : accessor.GetMethods()) {
-        if (method.GetCodeItem() != nullptr) {
-          action(resolver.get(), method);
-        }
-      }
+bool PreciseHiddenApiFinder::InvokesAnyOf(
+    const MethodSummary& summary,
+    const std::map<MethodReference, std::vector<ReflectAccessInfo>>& uses) {
+  const DexFile& dex_file = summary.resolver->GetDexFile();
+  for (uint32_t method_index : summary.invoked_methods) {
+    if (uses.find(MethodReference(&dex_file, method_index)) != uses.end()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void PreciseHiddenApiFinder::ForEachIndex(size_t count,
+                                          const std::function<void(size_t)>& action) const {
+  size_t num_threads = std::min(num_threads_, count);
+  if (num_threads <= 1) {
+    for (size_t i = 0; i < count; ++i) {
+      action(i);
     }
+    return;
+  }
+  // Methods vary a lot in size, so hand them out one at a time rather than in fixed chunks.
+  std::atomic<size_t> next_index(0);
+  std::vector<std::thread> threads;
+  threads.reserve(num_threads);
+  for (size_t t = 0; t < num_threads; ++t) {
+    threads.emplace_back([&]() {
+      for (size_t i = next_index.fetch_add(1); i < count; i = next_index.fetch_add(1)) {
+        action(i);
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
   }
 }
 
@@ -56,12 +82,41 @@ void PreciseHiddenApiFinder::AddUsesAt(const std::vector<ReflectAccessInfo>& acc
 }
 
 void PreciseHiddenApiFinder::Run(const std::vector<std::unique_ptr<VeridexResolver>>& resolvers) {
-  // Collect reflection uses.
-  RunInternal(resolvers, [this] (VeridexResolver* resolver, const ClassAccessor::Method& method) {
-    FlowAnalysisCollector collector(resolver, method);
+  for (const std::unique_ptr<VeridexResolver>& resolver : resolvers) {
+    for (ClassAccessor accessor : resolver->GetDexFile().GetClasses()) {
+      for (const ClassAccessor::Method& method : accessor.GetMethods()) {
+        if (method.GetCodeItem() != nullptr) {
+          methods_.emplace_back(resolver.get(), method);
+        }
+      }
+    }
+  }
+
+  if (num_threads_ > 1) {
+    // The resolvers fill their caches lazily. Fill them upfront so that the analysis
+    // threads only ever read them.
+    for (const std::unique_ptr<VeridexResolver>& resolver : resolvers) {
+      resolver->ResolveAll(/* log_unresolved= */ false);
+    }
+  }
+
+  // Collect reflection uses. Results are kept per method and added in method order, so the
+  // report does not depend on the number of threads.
+  std::vector<std::vector<ReflectAccessInfo>> method_uses(methods_.size());
+  ForEachIndex(methods_.size(), [&](size_t i) {
+    MethodSummary& summary = methods_[i];
+    FlowAnalysisCollector collector(summary.resolver, summary.method);
     collector.Run();
-    AddUsesAt(collector.GetUses(), method.GetReference());
+    method_uses[i] = collector.GetUses();
+    for (const DexInstructionPcPair& inst : summary.method.GetInstructions()) {
+      if (inst->IsInvoke()) {
+        summary.invoked_methods.push_back(inst->VRegB());
+      }
+    }
   });
+  for (size_t i = 0; i < methods_.size(); ++i) {
+    AddUsesAt(method_uses[i], methods_[i].method.GetReference());
+  }
 
   // For non-final reflection uses, do a limited fixed point calculation over the code to try
   // substituting them with final reflection uses.
@@ -72,13 +127,23 @@ void PreciseHiddenApiFinder::Run(const std::vector<std::unique_ptr<VeridexResolv
     // Fetch and clear the worklist.
     std::map<MethodReference, std::vector<ReflectAccessInfo>> current_uses
         = std::move(abstract_uses_);
-    RunInternal(resolvers,
-                [this, current_uses] (VeridexResolver* resolver,
-                                      const ClassAccessor::Method& method) {
-      FlowAnalysisSubstitutor substitutor(resolver, method, current_uses);
+    // Only callers of methods in the worklist can find new uses.
+    std::vector<size_t> callers;
+    for (size_t j = 0; j < methods_.size(); ++j) {
+      if (InvokesAnyOf(methods_[j], current_uses)) {
+        callers.push_back(j);
+      }
+    }
+    std::vector<std::vector<ReflectAccessInfo>> caller_uses(callers.size());
+    ForEachIndex(callers.size(), [&](size_t j) {
+      const MethodSummary& summary = methods_[callers[j]];
+      FlowAnalysisSubstitutor substitutor(summary.resolver, summary.method, current_uses);
       substitutor.Run();
-      AddUsesAt(substitutor.GetUses(), method.GetReference());
+      caller_uses[j] = substitutor.GetUses();
     });
+    for (size_t j = 0; j < callers.size(); ++j) {
+      AddUsesAt(caller_uses[j], methods_[callers[j]].method.GetReference());
+    }
   }
 }
 
@@ -20,10 +20,12 @@
 #include "dex/method_reference.h"
 #include "flow_analysis.h"
 
+#include <functional>
 #include <iostream>
 #include <map>
 #include <set>
 #include <string>
+#include <vector>
 
 namespace art {
 
@@ -36,7 +38,8 @@ class VeridexResolver;
  */
 class PreciseHiddenApiFinder {
  public:
-  explicit PreciseHiddenApiFinder(const HiddenApi& hidden_api) : hidden_api_(hidden_api) {}
+  PreciseHiddenApiFinder(const HiddenApi& hidden_api, size_t num_threads)
+      : hidden_api_(hidden_api), num_threads_(num_threads) {}
 
   // Iterate over the dex files associated with the passed resolvers to report
   // hidden API uses.
@@ -45,15 +48,33 @@ class PreciseHiddenApiFinder {
   void Dump(std::ostream& os, HiddenApiStats* stats);
 
  private:
-  // Run over all methods of all dex files, and call `action` on each.
-  void RunInternal(
-      const std::vector<std::unique_ptr<VeridexResolver>>& resolvers,
-      const std::function<void(VeridexResolver*, const ClassAccessor::Method&)>& action);
+  // A method with code, and what the analysis has learned about it so far.
+  struct MethodSummary {
+    MethodSummary(VeridexResolver* r, const ClassAccessor::Method& m) : resolver(r), method(m) {}
+
+    VeridexResolver* resolver;
+    ClassAccessor::Method method;
+    // Indices, in the method's dex file, of the methods it invokes. Filled in when the
+    // method is first analyzed, and used to only revisit callers of methods with
+    // abstract uses in later iterations.
+    std::vector<uint32_t> invoked_methods;
+  };
+
+  // Return whether `summary` invokes one of the methods in `uses`.
+  static bool InvokesAnyOf(const MethodSummary& summary,
+                           const std::map<MethodReference, std::vector<ReflectAccessInfo>>& uses);
+
+  // Call `action` on each index in [0, count), spread over `num_threads_` threads.
+  // `action` must only write state owned by its index.
+  void ForEachIndex(size_t count, const std::function<void(size_t)>& action) const;
 
   // Add uses found in method `ref`.
   void AddUsesAt(const std::vector<ReflectAccessInfo>& accesses, MethodReference ref);
 
   const HiddenApi& hidden_api_;
+  const size_t num_threads_;
+
+  std::vector<MethodSummary> methods_;
 
   std::map<MethodReference, std::vector<ReflectAccessInfo>> concrete_uses_;
   std::map<MethodReference, std::vector<ReflectAccessInfo>> abstract_uses_;
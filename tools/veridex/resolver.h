@@ -71,8 +71,9 @@ class VeridexResolver {
                                     const char* method_name,
                                     const char* signature) const;
 
-  // Resolve all type_id/method_id/field_id.
-  void ResolveAll();
+  // Resolve all type_id/method_id/field_id. Once done, lookups only read the
+  // caches of this resolver.
+  void ResolveAll(bool log_unresolved = true);
 
   // The dex file this resolver is associated to.
   const DexFile& GetDexFile() const {
@@ -25,8 +25,10 @@
 #include "precise_hidden_api_finder.h"
 #include "resolver.h"
 
+#include <algorithm>
 #include <cstdlib>
 #include <sstream>
+#include <thread>
 
 namespace art {
 
@@ -71,6 +73,7 @@ static const char* kFlagsOption = "--api-flags=";
 static const char* kImprecise = "--imprecise";
 static const char* kTargetSdkVersion = "--target-sdk-version=";
 static const char* kOnlyReportSdkUses = "--only-report-sdk-uses";
+static const char* kThreads = "--threads=";
 
 struct VeridexOptions {
   const char* dex_file = nullptr;
@@ -79,6 +82,7 @@ struct VeridexOptions {
   bool precise = true;
   int target_sdk_version = 28; /* P */
   bool only_report_sdk_uses = false;
+  size_t num_threads = std::max(1u, std::thread::hardware_concurrency());
 };
 
 static const char* Substr(const char* str, int index) {
@@ -107,6 +111,8 @@ static void ParseArgs(VeridexOptions* options, int argc, char** argv) {
       options->target_sdk_version = atoi(Substr(argv[i], strlen(kTargetSdkVersion)));
     } else if (strcmp(argv[i], kOnlyReportSdkUses) == 0) {
       options->only_report_sdk_uses = true;
+    } else if (StartsWith(argv[i], kThreads)) {
+      options->num_threads = std::max(1, atoi(Substr(argv[i], strlen(kThreads))));
     }
   }
 }
@@ -227,7 +233,7 @@ class Veridex {
     api_finder.Dump(std::cout, &stats, !options.precise);
 
     if (options.precise) {
-      PreciseHiddenApiFinder precise_api_finder(hidden_api);
+      PreciseHiddenApiFinder precise_api_finder(hidden_api, options.num_threads);
       precise_api_finder.Run(app_resolvers);
       precise_api_finder.Dump(std::cout, &stats);
     }